@@ -0,0 +1,216 @@
+#include "CursorAtlas.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace PointerCore
+{
+    namespace
+    {
+        // Sheet versions are unique across atlases, so a backend can tell
+        // any two sheets apart
+        std::atomic<uint64_t> s_nextVersion{ 1 };
+
+        enum class LayerKind : uint8_t
+        {
+            Disc,
+            Ring,
+            Diamond,
+            DiamondOutline,
+        };
+
+        // Sizes are fractions of the radius, widths are in DIPs
+        struct Layer
+        {
+            LayerKind Kind;
+            float Size;
+            float HalfWidth;
+            float Alpha;
+        };
+
+        struct Shape
+        {
+            Layer const* Layers;
+            size_t Count;
+        };
+
+        constexpr Layer MouseHover[] = {
+            { LayerKind::Ring, 0.7f, 1.25f, 1.0f },
+            { LayerKind::Disc, 0.09f, 0.0f, 1.0f },
+        };
+        constexpr Layer MousePressed[] = {
+            { LayerKind::Disc, 0.7f, 0.0f, 0.35f },
+            { LayerKind::Ring, 0.7f, 1.25f, 1.0f },
+            { LayerKind::Disc, 0.3f, 0.0f, 1.0f },
+        };
+        constexpr Layer TouchHover[] = {
+            { LayerKind::Disc, 0.9f, 0.0f, 0.2f },
+            { LayerKind::Ring, 0.9f, 1.0f, 0.6f },
+        };
+        constexpr Layer TouchPressed[] = {
+            { LayerKind::Disc, 0.9f, 0.0f, 0.3f },
+            { LayerKind::Ring, 0.9f, 1.0f, 0.8f },
+            { LayerKind::Disc, 0.5f, 0.0f, 1.0f },
+        };
+        constexpr Layer PenHover[] = {
+            { LayerKind::DiamondOutline, 0.45f, 1.0f, 1.0f },
+            { LayerKind::Disc, 0.06f, 0.0f, 1.0f },
+        };
+        constexpr Layer PenPressed[] = {
+            { LayerKind::Diamond, 0.45f, 0.0f, 1.0f },
+        };
+
+        template <size_t N>
+        constexpr Shape MakeShape(Layer const (&layers)[N]) noexcept
+        {
+            return { layers, N };
+        }
+
+        // By PointerDeviceKind, then hover and pressed
+        constexpr Shape Shapes[3][2] = {
+            { MakeShape(TouchHover), MakeShape(TouchPressed) },
+            { MakeShape(PenHover), MakeShape(PenPressed) },
+            { MakeShape(MouseHover), MakeShape(MousePressed) },
+        };
+
+        // Signed distance in DIPs from the layer's edge, negative inside
+        float Distance(Layer const& layer, float radius, float x, float y) noexcept
+        {
+            float const size = layer.Size * radius;
+            switch (layer.Kind)
+            {
+            case LayerKind::Disc:
+                return std::hypot(x, y) - size;
+            case LayerKind::Ring:
+                return std::abs(std::hypot(x, y) - size) - layer.HalfWidth;
+            case LayerKind::Diamond:
+                return (std::abs(x) + std::abs(y) - size) * 0.70710678f;
+            case LayerKind::DiamondOutline:
+                return std::abs((std::abs(x) + std::abs(y) - size) * 0.70710678f) - layer.HalfWidth;
+            }
+
+            return INFINITY;
+        }
+
+        uint32_t ToByte(float value) noexcept
+        {
+            return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+    }
+
+    CursorAtlas::CursorAtlas()
+        : CursorAtlas(Options())
+    {
+    }
+
+    CursorAtlas::CursorAtlas(Options const& options)
+        : m_options(options)
+    {
+        m_options.Radius = std::max(m_options.Radius, 1.0f);
+    }
+
+    bool CursorAtlas::Build(float scale)
+    {
+        if (!std::isfinite(scale))
+        {
+            scale = 1.0f;
+        }
+        scale = std::clamp(scale, 0.25f, 8.0f);
+        if (IsBuilt() && (scale == m_scale))
+        {
+            return false;
+        }
+
+        m_scale = scale;
+        m_cellSize = static_cast<uint32_t>(std::ceil(2.0f * m_options.Radius * scale));
+        m_width = static_cast<uint32_t>(SpriteCount) * (m_cellSize + 1) - 1;
+        m_height = m_cellSize;
+        m_pixels.assign(static_cast<size_t>(m_width) * m_height, 0);
+
+        for (size_t device = 0; device < DeviceCount; ++device)
+        {
+            for (bool pressed : { false, true })
+            {
+                auto const kind = static_cast<PointerDeviceKind>(device);
+                Rasterize(SpriteIndex(kind, pressed), kind, pressed);
+            }
+        }
+
+        m_version = s_nextVersion.fetch_add(1, std::memory_order_relaxed);
+        ++m_buildCount;
+        return true;
+    }
+
+    SpriteSheet CursorAtlas::Sheet() const noexcept
+    {
+        return { m_pixels.data(), m_width, m_height, m_options.Format, m_scale, m_version };
+    }
+
+    CursorAtlas::Sprite const& CursorAtlas::SpriteFor(PointerDeviceKind device, bool pressed) const noexcept
+    {
+        return m_sprites[SpriteIndex(device, pressed)];
+    }
+
+    SpriteInstance CursorAtlas::Place(PointerDeviceKind device, bool pressed, Point position) const noexcept
+    {
+        Sprite const& sprite = SpriteFor(device, pressed);
+
+        // Whole pixels from the pointer, so the sprite is copied 1:1
+        float const left = std::round((position.X + sprite.Bounds.Left) * m_scale) / m_scale;
+        float const top = std::round((position.Y + sprite.Bounds.Top) * m_scale) / m_scale;
+        float const size = static_cast<float>(m_cellSize) / m_scale;
+        return { { left, top, left + size, top + size }, sprite.Source };
+    }
+
+    size_t CursorAtlas::SpriteIndex(PointerDeviceKind device, bool pressed) noexcept
+    {
+        size_t const deviceIndex = std::min(static_cast<size_t>(device), DeviceCount - 1);
+        return deviceIndex * 2 + (pressed ? 1 : 0);
+    }
+
+    void CursorAtlas::Rasterize(size_t index, PointerDeviceKind device, bool pressed)
+    {
+        Shape const& shape = Shapes[std::min(static_cast<size_t>(device), DeviceCount - 1)][pressed ? 1 : 0];
+        Color const& color = pressed ? m_options.PressedColor : m_options.HoverColor;
+
+        int32_t const cellLeft = static_cast<int32_t>(index * (m_cellSize + 1));
+        int32_t const cellSize = static_cast<int32_t>(m_cellSize);
+        float const halfSize = static_cast<float>(m_cellSize) / (2.0f * m_scale);
+        m_sprites[index] = { { cellLeft, 0, cellLeft + cellSize, cellSize }, { -halfSize, -halfSize, halfSize, halfSize } };
+
+        for (uint32_t y = 0; y < m_cellSize; ++y)
+        {
+            float const dipY = (static_cast<float>(y) + 0.5f) / m_scale - halfSize;
+            for (uint32_t x = 0; x < m_cellSize; ++x)
+            {
+                float const dipX = (static_cast<float>(x) + 0.5f) / m_scale - halfSize;
+
+                // Premultiplied source-over of each layer in turn
+                float r = 0.0f;
+                float g = 0.0f;
+                float b = 0.0f;
+                float a = 0.0f;
+                for (size_t i = 0; i < shape.Count; ++i)
+                {
+                    Layer const& layer = shape.Layers[i];
+                    float const coverage = std::clamp(0.5f - Distance(layer, m_options.Radius, dipX, dipY) * m_scale, 0.0f, 1.0f);
+                    float const alpha = coverage * layer.Alpha * std::clamp(color.A, 0.0f, 1.0f);
+                    r = color.R * alpha + r * (1.0f - alpha);
+                    g = color.G * alpha + g * (1.0f - alpha);
+                    b = color.B * alpha + b * (1.0f - alpha);
+                    a = alpha + a * (1.0f - alpha);
+                }
+
+                // Rounding each channel on its own could leave it above alpha
+                uint32_t const alphaByte = ToByte(a);
+                uint32_t const rByte = std::min(ToByte(r), alphaByte);
+                uint32_t const gByte = std::min(ToByte(g), alphaByte);
+                uint32_t const bByte = std::min(ToByte(b), alphaByte);
+                m_pixels[static_cast<size_t>(y) * m_width + static_cast<size_t>(cellLeft) + x] = (m_options.Format == PixelFormat::Bgra8)
+                    ? (bByte | (gByte << 8) | (rByte << 16) | (alphaByte << 24))
+                    : (rByte | (gByte << 8) | (bByte << 16) | (alphaByte << 24));
+            }
+        }
+    }
+}
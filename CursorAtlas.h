@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTypes.h"
+#include "RenderBackend.h"
+
+namespace PointerCore
+{
+    // Anti-aliased pointer indicator sprites, one per device kind and state,
+    // rasterized once into a sheet and then only blended per pointer.
+    //
+    // Every shape is a few layers (discs, rings and the diamond of a pen nib)
+    // described by signed distance functions. A pixel's coverage is its
+    // distance from the layer's edge in pixels, clamped to a one pixel ramp,
+    // so edges come out smooth at any scale without supersampling:
+    //
+    //   Mouse  a ring with a center dot when hovering, filled in when pressed
+    //   Touch  a faint halo, with a solid contact disc when pressed
+    //   Pen    a small nib outline, filled in when pressed
+    //
+    // Build() rasterizes the sheet for a number of pixels per DIP, and does
+    // nothing if it was already built for that scale, so it's cheap to call
+    // every frame and only does work when the DPI changes.
+    class CursorAtlas
+    {
+    public:
+        struct Options
+        {
+            // Shapes fit in a circle of this radius, in DIPs
+            float Radius = 20.0f;
+
+            Color HoverColor = Colors::Blue;
+            Color PressedColor = Colors::Red;
+
+            // Layout of the sheet's pixels, to match the target's
+            PixelFormat Format = PixelFormat::Bgra8;
+        };
+
+        // A sprite's pixels in the sheet, and its bounds in DIPs relative to
+        // the pointer position
+        struct Sprite
+        {
+            PixelRect Source;
+            Rect Bounds;
+        };
+
+        CursorAtlas();
+        explicit CursorAtlas(Options const& options);
+
+        // Rasterizes every sprite for the given pixels per DIP unless the
+        // sheet is already at that scale. Returns true if it was rebuilt.
+        bool Build(float scale);
+
+        bool IsBuilt() const noexcept { return m_version != 0; }
+        float Scale() const noexcept { return m_scale; }
+
+        // Rebuilds so far, to check that only DPI changes cause them
+        uint64_t BuildCount() const noexcept { return m_buildCount; }
+
+        // Only valid once built. Place() puts the sprite for a pointer on
+        // the pixel grid around its position.
+        SpriteSheet Sheet() const noexcept;
+        Sprite const& SpriteFor(PointerDeviceKind device, bool pressed) const noexcept;
+        SpriteInstance Place(PointerDeviceKind device, bool pressed, Point position) const noexcept;
+
+    private:
+        static constexpr size_t DeviceCount = 3;
+        static constexpr size_t SpriteCount = DeviceCount * 2;
+
+        static size_t SpriteIndex(PointerDeviceKind device, bool pressed) noexcept;
+        void Rasterize(size_t index, PointerDeviceKind device, bool pressed);
+
+        Options m_options;
+        float m_scale{ 0.0f };
+        uint64_t m_version{ 0 };
+        uint64_t m_buildCount{ 0 };
+
+        // Cells are square and side by side, a pixel apart
+        uint32_t m_cellSize{ 0 };
+        uint32_t m_width{ 0 };
+        uint32_t m_height{ 0 };
+        std::vector<uint32_t> m_pixels;
+        Sprite m_sprites[SpriteCount]{};
+    };
+}
@@ -0,0 +1,260 @@
+#include "pch.h"
+#include "D2DRenderBackend.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    static inline D2D1_COLOR_F ToD2DColor(PointerCore::Color const& color) noexcept
+    {
+        return D2D1::ColorF(color.R, color.G, color.B, color.A);
+    }
+
+    D2DRenderBackend::D2DRenderBackend(com_ptr<ID2D1DeviceContext> const& deviceContext, PointerCore::FrameTimeline& timeline)
+        : m_deviceContext{ deviceContext }
+        , m_timeline{ timeline }
+    {
+        check_hresult(m_deviceContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Black), m_brush.put()));
+
+        m_deviceContext3 = m_deviceContext.try_as<ID2D1DeviceContext3>();
+        if (m_deviceContext3)
+        {
+            check_hresult(m_deviceContext3->CreateSpriteBatch(m_spriteBatch.put()));
+
+            uint32_t const white = 0xffffffff;
+            check_hresult(m_deviceContext->CreateBitmap(
+                D2D1::SizeU(1, 1),
+                &white,
+                sizeof(white),
+                D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+                m_whiteBitmap.put()));
+        }
+    }
+
+    void D2DRenderBackend::BeginDraw()
+    {
+        PointerCore::TimelineSpan span{ m_timeline, "BeginDraw" };
+        m_deviceContext->BeginDraw();
+        ++m_frame;
+        m_clippedFrame = false;
+    }
+
+    void D2DRenderBackend::Clear(PointerCore::Color const& color)
+    {
+        m_deviceContext->Clear(ToD2DColor(color));
+    }
+
+    void D2DRenderBackend::FillRectangle(PointerCore::Rect const& rect, PointerCore::Color const& color)
+    {
+        m_brush->SetColor(ToD2DColor(color));
+        m_deviceContext->FillRectangle(D2D1::RectF(rect.Left, rect.Top, rect.Right, rect.Bottom), m_brush.get());
+    }
+
+    void D2DRenderBackend::FillRectangles(PointerCore::Rect const* rects, PointerCore::Color const* colors, size_t count)
+    {
+        if (!m_spriteBatch)
+        {
+            RenderBackend::FillRectangles(rects, colors, count);
+            return;
+        }
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Rect and Color share their layout with D2D1_RECT_F and D2D1_COLOR_F
+        static_assert(sizeof(PointerCore::Rect) == sizeof(D2D1_RECT_F), "Rect must match D2D1_RECT_F");
+        static_assert(sizeof(PointerCore::Color) == sizeof(D2D1_COLOR_F), "Color must match D2D1_COLOR_F");
+
+        m_spriteBatch->Clear();
+        check_hresult(m_spriteBatch->AddSprites(
+            static_cast<UINT32>(count),
+            reinterpret_cast<D2D1_RECT_F const*>(rects),
+            nullptr,
+            reinterpret_cast<D2D1_COLOR_F const*>(colors),
+            nullptr,
+            sizeof(D2D1_RECT_F),
+            0,
+            sizeof(D2D1_COLOR_F),
+            0));
+
+        // Sprite batches can only be drawn aliased
+        auto const antialiasMode = m_deviceContext->GetAntialiasMode();
+        m_deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+        m_deviceContext3->DrawSpriteBatch(m_spriteBatch.get(), m_whiteBitmap.get(), D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_SPRITE_OPTIONS_NONE);
+        m_deviceContext->SetAntialiasMode(antialiasMode);
+    }
+
+    com_ptr<ID2D1Mesh> D2DRenderBackend::CreateStripMesh(PointerCore::Point const* vertices, size_t count)
+    {
+        m_triangles.clear();
+        for (size_t i = 0; i + 2 < count; ++i)
+        {
+            m_triangles.push_back({
+                D2D1::Point2F(vertices[i].X, vertices[i].Y),
+                D2D1::Point2F(vertices[i + 1].X, vertices[i + 1].Y),
+                D2D1::Point2F(vertices[i + 2].X, vertices[i + 2].Y) });
+        }
+
+        com_ptr<ID2D1Mesh> mesh;
+        check_hresult(m_deviceContext->CreateMesh(mesh.put()));
+
+        com_ptr<ID2D1TessellationSink> sink;
+        check_hresult(mesh->Open(sink.put()));
+        sink->AddTriangles(m_triangles.data(), static_cast<UINT32>(m_triangles.size()));
+        check_hresult(sink->Close());
+        return mesh;
+    }
+
+    void D2DRenderBackend::FillMesh(ID2D1Mesh* mesh, PointerCore::Color const& color)
+    {
+        // Meshes can only be filled aliased
+        auto const antialiasMode = m_deviceContext->GetAntialiasMode();
+        m_deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+        m_brush->SetColor(ToD2DColor(color));
+        m_deviceContext->FillMesh(mesh, m_brush.get());
+        m_deviceContext->SetAntialiasMode(antialiasMode);
+    }
+
+    void D2DRenderBackend::FillTriangleStrip(PointerCore::Point const* vertices, size_t count, PointerCore::Color const& color)
+    {
+        if (count < 3)
+        {
+            return;
+        }
+
+        FillMesh(CreateStripMesh(vertices, count).get(), color);
+    }
+
+    void D2DRenderBackend::FillKeyedTriangleStrip(uint64_t key, PointerCore::Point const* vertices, size_t count, size_t stableCount, PointerCore::Color const& color)
+    {
+        stableCount = std::min(stableCount, count);
+        auto const samePoint = [](PointerCore::Point const& a, PointerCore::Point const& b) { return (a.X == b.X) && (a.Y == b.Y); };
+
+        auto& strip = m_strips[key];
+        strip.LastFrame = m_frame;
+        if (strip.Mesh && ((strip.VertexCount > stableCount) || !samePoint(strip.First, vertices[0]) || !samePoint(strip.Last, vertices[strip.VertexCount - 1])))
+        {
+            strip.Mesh = nullptr;
+            strip.VertexCount = 0;
+        }
+
+        // Finished strips are cached whole, growing ones in steps
+        bool const complete = (stableCount == count) && (count > strip.VertexCount);
+        if ((stableCount >= 3) && (complete || (stableCount >= strip.VertexCount + MinCachedGrowth)))
+        {
+            strip.Mesh = CreateStripMesh(vertices, stableCount);
+            strip.VertexCount = stableCount;
+            strip.First = vertices[0];
+            strip.Last = vertices[stableCount - 1];
+        }
+
+        if (strip.Mesh)
+        {
+            FillMesh(strip.Mesh.get(), color);
+        }
+
+        // The rest starts on the cached mesh's last edge, so every triangle is drawn once
+        size_t const tail = strip.Mesh ? strip.VertexCount - 2 : 0;
+        if (count - tail >= 3)
+        {
+            FillMesh(CreateStripMesh(vertices + tail, count - tail).get(), color);
+        }
+    }
+
+    void D2DRenderBackend::DrawSprites(PointerCore::SpriteSheet const& sheet, PointerCore::SpriteInstance const* sprites, size_t count)
+    {
+        if ((count == 0) || (sheet.Width == 0) || (sheet.Height == 0))
+        {
+            return;
+        }
+
+        if (!m_spriteSheet || (m_spriteSheetVersion != sheet.Version))
+        {
+            // At the sheet's DPI, one sheet pixel covers one DIP divided by its scale
+            float const dpi = USER_DEFAULT_SCREEN_DPI * sheet.Scale;
+            auto const format = (sheet.Format == PointerCore::PixelFormat::Bgra8) ? DXGI_FORMAT_B8G8R8A8_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            m_spriteSheet = nullptr;
+            check_hresult(m_deviceContext->CreateBitmap(
+                D2D1::SizeU(sheet.Width, sheet.Height),
+                sheet.Pixels,
+                sheet.Width * sizeof(uint32_t),
+                D2D1::BitmapProperties(D2D1::PixelFormat(format, D2D1_ALPHA_MODE_PREMULTIPLIED), dpi, dpi),
+                m_spriteSheet.put()));
+            m_spriteSheetVersion = sheet.Version;
+        }
+
+        if (!m_spriteBatch)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto const& destination = sprites[i].Destination;
+                auto const& source = sprites[i].Source;
+                m_deviceContext->DrawBitmap(
+                    m_spriteSheet.get(),
+                    D2D1::RectF(destination.Left, destination.Top, destination.Right, destination.Bottom),
+                    1.0f,
+                    D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+                    D2D1::RectF(source.Left / sheet.Scale, source.Top / sheet.Scale, source.Right / sheet.Scale, source.Bottom / sheet.Scale));
+            }
+            return;
+        }
+
+        // Sprite batch sources are in bitmap pixels, unlike DrawBitmap()
+        m_spriteSources.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto const& source = sprites[i].Source;
+            m_spriteSources.push_back(D2D1::RectU(
+                static_cast<UINT32>(source.Left),
+                static_cast<UINT32>(source.Top),
+                static_cast<UINT32>(source.Right),
+                static_cast<UINT32>(source.Bottom)));
+        }
+
+        m_spriteBatch->Clear();
+        check_hresult(m_spriteBatch->AddSprites(
+            static_cast<UINT32>(count),
+            reinterpret_cast<D2D1_RECT_F const*>(&sprites->Destination),
+            m_spriteSources.data(),
+            nullptr,
+            nullptr,
+            sizeof(PointerCore::SpriteInstance),
+            sizeof(D2D1_RECT_U),
+            0,
+            0));
+
+        auto const antialiasMode = m_deviceContext->GetAntialiasMode();
+        m_deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+        m_deviceContext3->DrawSpriteBatch(m_spriteBatch.get(), m_spriteSheet.get(), D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_SPRITE_OPTIONS_NONE);
+        m_deviceContext->SetAntialiasMode(antialiasMode);
+    }
+
+    void D2DRenderBackend::EndDraw()
+    {
+        PointerCore::TimelineSpan span{ m_timeline, "EndDraw" };
+
+        // Strips that weren't drawn are gone, or at least off the screen
+        if (!m_clippedFrame || (m_strips.size() > MaxCachedStrips))
+        {
+            for (auto strip = m_strips.begin(); strip != m_strips.end();)
+            {
+                strip = (strip->second.LastFrame != m_frame) ? m_strips.erase(strip) : std::next(strip);
+            }
+        }
+
+        check_hresult(m_deviceContext->EndDraw());
+    }
+
+    void D2DRenderBackend::PushClip(PointerCore::PixelRect const& rect)
+    {
+        m_clippedFrame = true;
+        auto const bounds = rect.ToRect();
+        m_deviceContext->PushAxisAlignedClip(D2D1::RectF(bounds.Left, bounds.Top, bounds.Right, bounds.Bottom), D2D1_ANTIALIAS_MODE_ALIASED);
+    }
+
+    void D2DRenderBackend::PopClip()
+    {
+        m_deviceContext->PopAxisAlignedClip();
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "FrameTimeline.h"
+#include "RenderBackend.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    // RenderBackend drawing with a Direct2D device context. The caller owns the
+    // context and is responsible for setting its target before BeginDraw().
+    // BeginDraw() and EndDraw() are recorded as spans on the timeline.
+    class D2DRenderBackend : public PointerCore::RenderBackend
+    {
+    public:
+        D2DRenderBackend(com_ptr<ID2D1DeviceContext> const& deviceContext, PointerCore::FrameTimeline& timeline);
+
+        // RenderBackend
+        void BeginDraw() override;
+        void Clear(PointerCore::Color const& color) override;
+        void FillRectangle(PointerCore::Rect const& rect, PointerCore::Color const& color) override;
+        void FillRectangles(PointerCore::Rect const* rects, PointerCore::Color const* colors, size_t count) override;
+        void FillTriangleStrip(PointerCore::Point const* vertices, size_t count, PointerCore::Color const& color) override;
+        void FillKeyedTriangleStrip(uint64_t key, PointerCore::Point const* vertices, size_t count, size_t stableCount, PointerCore::Color const& color) override;
+        void DrawSprites(PointerCore::SpriteSheet const& sheet, PointerCore::SpriteInstance const* sprites, size_t count) override;
+        void EndDraw() override;
+        void PushClip(PointerCore::PixelRect const& rect) override;
+        void PopClip() override;
+
+    private:
+        // Keyed strips keep a mesh of their first VertexCount (stable)
+        // vertices, so a finished ink stroke is tessellated by Direct2D once.
+        // Active strokes rebuild it only once MinCachedGrowth more vertices
+        // have become stable, and draw the vertices after it as a fresh mesh.
+        struct CachedStrip
+        {
+            com_ptr<ID2D1Mesh> Mesh;
+            size_t VertexCount;
+
+            // Checked on every draw, in case the key now names other vertices
+            PointerCore::Point First;
+            PointerCore::Point Last;
+
+            uint64_t LastFrame;
+        };
+
+        static constexpr size_t MinCachedGrowth = 256;
+
+        // Strips not drawn in a frame without clips, which draws all of them,
+        // are dropped at its end. Past this many, so are those not drawn in
+        // the current frame, whatever its clips.
+        static constexpr size_t MaxCachedStrips = 4096;
+
+        com_ptr<ID2D1Mesh> CreateStripMesh(PointerCore::Point const* vertices, size_t count);
+        void FillMesh(ID2D1Mesh* mesh, PointerCore::Color const& color);
+
+        com_ptr<ID2D1DeviceContext> m_deviceContext;
+        PointerCore::FrameTimeline& m_timeline;
+
+        // One brush recolored per fill is cheaper than keeping a brush per color
+        com_ptr<ID2D1SolidColorBrush> m_brush;
+
+        // Batched fills draw a tinted 1x1 white bitmap per rectangle through a
+        // sprite batch. Null if the device context doesn't support sprite batches.
+        com_ptr<ID2D1DeviceContext3> m_deviceContext3;
+        com_ptr<ID2D1SpriteBatch> m_spriteBatch;
+        com_ptr<ID2D1Bitmap> m_whiteBitmap;
+
+        // Last sprite sheet drawn, uploaded again only when its version changes
+        com_ptr<ID2D1Bitmap> m_spriteSheet;
+        uint64_t m_spriteSheetVersion{ 0 };
+        std::vector<D2D1_RECT_U> m_spriteSources;
+
+        // Triangle strips are unrolled into this and drawn as a mesh
+        std::vector<D2D1_TRIANGLE> m_triangles;
+
+        std::unordered_map<uint64_t, CachedStrip> m_strips;
+        uint64_t m_frame{ 0 };
+        bool m_clippedFrame{ false };
+    };
+}
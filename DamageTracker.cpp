@@ -0,0 +1,325 @@
+#include "DamageTracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "PointerScene.h"
+
+namespace PointerCore
+{
+    static inline bool IsWithin(PixelRect const& a, PixelRect const& b, int32_t distance) noexcept
+    {
+        return (a.Left - distance < b.Right) && (b.Left - distance < a.Right) &&
+               (a.Top - distance < b.Bottom) && (b.Top - distance < a.Bottom);
+    }
+
+    // Area a merge of the two adds beyond what they already cover
+    static inline int64_t MergeCost(PixelRect const& a, PixelRect const& b) noexcept
+    {
+        return Union(a, b).Area() - a.Area() - b.Area();
+    }
+
+    DamageTracker::DamageTracker()
+        : DamageTracker(Options{})
+    {
+    }
+
+    DamageTracker::DamageTracker(Options const& options)
+        : m_options{ options }
+        , m_history(std::max<size_t>(1, options.BufferCount))
+    {
+    }
+
+    void DamageTracker::Resize(int32_t width, int32_t height)
+    {
+        m_width = width;
+        m_height = height;
+        InvalidateAll();
+    }
+
+    void DamageTracker::InvalidateAll()
+    {
+        // The next frame's damage is the whole surface, which keeps every
+        // buffer repainting in full until each of them has been drawn once
+        m_invalidated = true;
+        m_previous.clear();
+    }
+
+    void DamageTracker::SetBufferCount(size_t bufferCount)
+    {
+        m_options.BufferCount = std::max<size_t>(1, bufferCount);
+        m_history.assign(m_options.BufferCount, DamageRegion{});
+        m_historyIndex = 0;
+        InvalidateAll();
+    }
+
+    PixelRect DamageTracker::ToPixelRect(Rect const& bounds) const noexcept
+    {
+        // Clamp to just outside the surface first, so far off-screen content
+        // can't overflow the conversion but still ends up empty
+        float const right = static_cast<float>(m_width) + 1.0f;
+        float const bottom = static_cast<float>(m_height) + 1.0f;
+        PixelRect const pixels{
+            static_cast<int32_t>(std::floor(std::clamp(bounds.Left, -1.0f, right))) - m_options.Padding,
+            static_cast<int32_t>(std::floor(std::clamp(bounds.Top, -1.0f, bottom))) - m_options.Padding,
+            static_cast<int32_t>(std::ceil(std::clamp(bounds.Right, -1.0f, right))) + m_options.Padding,
+            static_cast<int32_t>(std::ceil(std::clamp(bounds.Bottom, -1.0f, bottom))) + m_options.Padding };
+
+        return Intersection(pixels, { 0, 0, m_width, m_height });
+    }
+
+    PixelRect DamageTracker::IndicatorPixelRect(float x, float y) const noexcept
+    {
+        return ToPixelRect(PointerScene::IndicatorRect(x, y));
+    }
+
+    void DamageTracker::AddDamage(Rect const& bounds)
+    {
+        if (!(bounds.Left < bounds.Right) || !(bounds.Top < bounds.Bottom))
+        {
+            return;
+        }
+
+        PixelRect const pixels = ToPixelRect(bounds);
+        if (!pixels.IsEmpty())
+        {
+            m_pendingDamage.push_back(pixels);
+        }
+    }
+
+    DamageRegion const& DamageTracker::Update(PointerTable const& pointers)
+    {
+        // Snapshot this frame's indicators, sorted by ID so the diff is a merge join
+        m_current.clear();
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            Point const position = pointers.Position(i);
+            m_current.push_back({ pointers.Id(i), static_cast<uint32_t>(i), pointers.IsPressed(i), position, IndicatorPixelRect(position.X, position.Y) });
+        }
+
+        std::sort(m_current.begin(), m_current.end(), [](Entry const& a, Entry const& b) { return a.Id < b.Id; });
+
+        // Advance to this frame's slot; it still holds the damage from
+        // BufferCount frames ago, which the buffer being drawn already has
+        m_historyIndex = (m_historyIndex + 1) % m_history.size();
+        DamageRegion& frame = m_history[m_historyIndex];
+        frame.Clear();
+        frame.Full = m_invalidated;
+        m_invalidated = false;
+
+        auto damage = [&frame](PixelRect const& rect)
+        {
+            if (!rect.IsEmpty())
+            {
+                frame.Rects.push_back(rect);
+            }
+        };
+
+        for (auto const& rect : m_pendingDamage)
+        {
+            damage(rect);
+        }
+        m_pendingDamage.clear();
+
+        auto previous = m_previous.begin();
+        auto current = m_current.begin();
+        while ((previous != m_previous.end()) || (current != m_current.end()))
+        {
+            if ((current == m_current.end()) || ((previous != m_previous.end()) && (previous->Id < current->Id)))
+            {
+                // Pointer went away
+                damage(previous->Bounds);
+                ++previous;
+            }
+            else if ((previous == m_previous.end()) || (current->Id < previous->Id))
+            {
+                // New pointer
+                damage(current->Bounds);
+                ++current;
+            }
+            else
+            {
+                // Compare exact positions, sub-pixel moves can still change coverage
+                bool const moved = (previous->Position.X != current->Position.X) || (previous->Position.Y != current->Position.Y);
+                if (moved || (previous->Pressed != current->Pressed) || (previous->Order != current->Order))
+                {
+                    damage(previous->Bounds);
+                    damage(current->Bounds);
+                }
+
+                ++previous;
+                ++current;
+            }
+        }
+
+        std::swap(m_previous, m_current);
+        Simplify(frame);
+
+        // Repaint everything that changed since this buffer was last drawn
+        m_repaint.Clear();
+        for (auto const& region : m_history)
+        {
+            m_repaint.Full |= region.Full;
+            m_repaint.Rects.insert(m_repaint.Rects.end(), region.Rects.begin(), region.Rects.end());
+        }
+
+        Simplify(m_repaint);
+        return m_repaint;
+    }
+
+    void DamageTracker::Simplify(DamageRegion& region) const
+    {
+        auto& rects = region.Rects;
+        if (region.Full)
+        {
+            rects.assign(1, { 0, 0, m_width, m_height });
+            return;
+        }
+
+        // With this many separate changes the pairwise merge isn't worth it
+        constexpr size_t MaxInputRects = 256;
+        if (rects.size() > MaxInputRects)
+        {
+            region.Full = true;
+            rects.assign(1, { 0, 0, m_width, m_height });
+            return;
+        }
+
+        // Merge rectangles that overlap or are close, until nothing changes
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (size_t i = 0; i < rects.size(); ++i)
+            {
+                for (size_t j = i + 1; j < rects.size(); ++j)
+                {
+                    if (IsWithin(rects[i], rects[j], m_options.MergeDistance))
+                    {
+                        rects[i] = Union(rects[i], rects[j]);
+                        rects[j] = rects.back();
+                        rects.pop_back();
+                        merged = true;
+                        --j;
+                    }
+                }
+            }
+        }
+
+        // The rectangles are disjoint now, so their summed area is what they
+        // cover, and capping the count below only adds to it. Past a certain
+        // coverage a full repaint is cheaper than clipping.
+        if (ExceedsFullCoverage(rects))
+        {
+            region.Full = true;
+            rects.assign(1, { 0, 0, m_width, m_height });
+            return;
+        }
+
+        // Cap the count by merging the pairs that add the least area. Each
+        // rectangle keeps its cheapest partner among the ones after it, so a
+        // merge only rescans the rows it invalidated instead of every pair.
+        size_t const maxRects = std::max<size_t>(1, m_options.MaxRects);
+        if (rects.size() > maxRects)
+        {
+            std::vector<size_t> partners(rects.size());
+            std::vector<int64_t> costs(rects.size());
+            auto const rescan = [&rects, &partners, &costs](size_t row)
+            {
+                costs[row] = INT64_MAX;
+                for (size_t j = row + 1; j < rects.size(); ++j)
+                {
+                    int64_t const cost = MergeCost(rects[row], rects[j]);
+                    if (cost < costs[row])
+                    {
+                        costs[row] = cost;
+                        partners[row] = j;
+                    }
+                }
+            };
+            for (size_t i = 0; i < rects.size(); ++i)
+            {
+                rescan(i);
+            }
+
+            while (rects.size() > maxRects)
+            {
+                // The cheapest pair, the first one in row order on ties
+                size_t bestI = 0;
+                for (size_t i = 1; i + 1 < rects.size(); ++i)
+                {
+                    if (costs[i] < costs[bestI])
+                    {
+                        bestI = i;
+                    }
+                }
+
+                size_t const bestJ = partners[bestI];
+                size_t const last = rects.size() - 1;
+                rects[bestI] = Union(rects[bestI], rects[bestJ]);
+                rects[bestJ] = rects.back();
+                rects.pop_back();
+
+                // The two changed rows start over. The others only have to weigh
+                // the two changed rectangles, unless their partner got more
+                // expensive (every other candidate could now be cheaper) or
+                // moved out of reach.
+                for (size_t row = 0; row + 1 < rects.size(); ++row)
+                {
+                    if (partners[row] == last)
+                    {
+                        partners[row] = bestJ;
+                    }
+
+                    if ((row == bestI) || (row == bestJ) || (partners[row] <= row) || (partners[row] >= rects.size()))
+                    {
+                        rescan(row);
+                        continue;
+                    }
+
+                    if ((partners[row] == bestI) || (partners[row] == bestJ))
+                    {
+                        int64_t const cost = MergeCost(rects[row], rects[partners[row]]);
+                        if (cost > costs[row])
+                        {
+                            rescan(row);
+                            continue;
+                        }
+                        costs[row] = cost;
+                    }
+
+                    for (size_t changed : { bestI, bestJ })
+                    {
+                        if ((changed > row) && (changed < rects.size()))
+                        {
+                            int64_t const cost = MergeCost(rects[row], rects[changed]);
+                            if ((cost < costs[row]) || ((cost == costs[row]) && (changed < partners[row])))
+                            {
+                                costs[row] = cost;
+                                partners[row] = changed;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        if (ExceedsFullCoverage(rects))
+        {
+            region.Full = true;
+            rects.assign(1, { 0, 0, m_width, m_height });
+        }
+    }
+
+    bool DamageTracker::ExceedsFullCoverage(std::vector<PixelRect> const& rects) const noexcept
+    {
+        int64_t area = 0;
+        for (auto const& rect : rects)
+        {
+            area += rect.Area();
+        }
+
+        int64_t const surfaceArea = static_cast<int64_t>(m_width) * m_height;
+        return (surfaceArea > 0) && (static_cast<double>(area) > m_options.FullDamageCoverage * static_cast<double>(surfaceArea));
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "RenderBackend.h"
+
+namespace PointerCore
+{
+    // A set of pixel rectangles, or the whole surface
+    struct DamageRegion
+    {
+        std::vector<PixelRect> Rects;
+        bool Full{ false };
+
+        bool IsEmpty() const noexcept { return !Full && Rects.empty(); }
+        void Clear() noexcept
+        {
+            Rects.clear();
+            Full = false;
+        }
+    };
+
+    // Computes which parts of the surface change from frame to frame.
+    //
+    // Each Update() diffs the indicator rectangles of the current pointer table
+    // against the previous frame's. Rectangles of pointers that appeared,
+    // disappeared, moved, changed state or changed draw order are damaged. Rectangles that overlap
+    // or sit within MergeDistance of each other are merged, and the region
+    // falls back to the full surface once it stops paying off.
+    //
+    // Flip-model swap chains hand back a buffer that was last drawn
+    // BufferCount frames ago, so the region that has to be repainted is the
+    // union of the last BufferCount frames' damage, while only this frame's
+    // damage has to be reported to the compositor.
+    class DamageTracker
+    {
+    public:
+        struct Options
+        {
+            size_t BufferCount = 2;
+
+            // Rectangles closer than this many pixels are merged
+            int32_t MergeDistance = 8;
+
+            // More rectangles than this are merged down to this many
+            size_t MaxRects = 8;
+
+            // Regions covering more than this fraction of the surface become full damage
+            float FullDamageCoverage = 0.5f;
+
+            // Extra pixels around each indicator, for antialiased edges
+            int32_t Padding = 1;
+        };
+
+        DamageTracker();
+        explicit DamageTracker(Options const& options);
+
+        // Invalidates everything. The first frame after construction is always full.
+        void Resize(int32_t width, int32_t height);
+        void InvalidateAll();
+
+        // The swap chain now cycles through a different number of buffers.
+        // Invalidates everything.
+        void SetBufferCount(size_t bufferCount);
+
+        // Damages an area for the next Update(), for content other than the
+        // indicators (e.g. ink) that changed this frame
+        void AddDamage(Rect const& bounds);
+
+        // Diffs the pointer table against the previous frame and returns the
+        // region of the back buffer that has to be repainted
+        DamageRegion const& Update(PointerTable const& pointers);
+
+        // What changed on screen this frame (to report to the compositor)
+        DamageRegion const& FrameDamage() const noexcept { return m_history[m_historyIndex]; }
+
+        // What has to be redrawn in the buffer being rendered this frame
+        DamageRegion const& RepaintRegion() const noexcept { return m_repaint; }
+
+        int32_t Width() const noexcept { return m_width; }
+        int32_t Height() const noexcept { return m_height; }
+
+        // Pixels covered by the indicator of a pointer at the given position, clipped to the surface
+        PixelRect IndicatorPixelRect(float x, float y) const noexcept;
+
+    private:
+        struct Entry
+        {
+            uint32_t Id;
+
+            // Position in the table, i.e. the draw order, which decides which
+            // of two overlapping indicators ends up on top
+            uint32_t Order;
+            bool Pressed;
+            Point Position;
+            PixelRect Bounds;
+        };
+
+        PixelRect ToPixelRect(Rect const& bounds) const noexcept;
+        void Simplify(DamageRegion& region) const;
+        bool ExceedsFullCoverage(std::vector<PixelRect> const& rects) const noexcept;
+
+        Options m_options;
+        int32_t m_width{ 0 };
+        int32_t m_height{ 0 };
+
+        // Indicators drawn last frame, sorted by ID
+        std::vector<Entry> m_previous;
+        std::vector<Entry> m_current;
+
+        // Per-frame damage for the last BufferCount frames
+        std::vector<DamageRegion> m_history;
+        size_t m_historyIndex{ 0 };
+        bool m_invalidated{ true };
+        std::vector<PixelRect> m_pendingDamage;
+        DamageRegion m_repaint;
+    };
+}
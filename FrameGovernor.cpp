@@ -0,0 +1,133 @@
+#include "FrameGovernor.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace PointerCore
+{
+    FrameGovernor::FrameGovernor()
+        : FrameGovernor(Options())
+    {
+    }
+
+    FrameGovernor::FrameGovernor(Options const& options)
+    {
+        SetOptions(options);
+    }
+
+    void FrameGovernor::SetOptions(Options const& options)
+    {
+        m_options = options;
+        m_options.MaxFrameLatency = std::max(m_options.MaxFrameLatency, m_options.MinFrameLatency);
+        m_options.MaxPresentInterval = std::max(m_options.MaxPresentInterval, m_options.MinPresentInterval);
+        m_options.Window = std::clamp(m_options.Window, 1u, 64u);
+        m_options.SlowFrames = std::clamp(m_options.SlowFrames, 1u, m_options.Window);
+
+        Settings const current = m_ladder.empty() ? Settings{} : CurrentSettings();
+
+        // Effects first, then latency, then interval
+        Settings rung{ m_options.MinFrameLatency, m_options.MinPresentInterval, EffectsLevel::Full };
+        m_ladder.clear();
+        m_ladder.push_back(rung);
+        while (rung.Effects != EffectsLevel::Minimal)
+        {
+            rung.Effects = static_cast<EffectsLevel>(static_cast<uint32_t>(rung.Effects) - 1);
+            m_ladder.push_back(rung);
+        }
+        while (rung.MaxFrameLatency < m_options.MaxFrameLatency)
+        {
+            ++rung.MaxFrameLatency;
+            m_ladder.push_back(rung);
+        }
+        while (rung.PresentInterval < m_options.MaxPresentInterval)
+        {
+            ++rung.PresentInterval;
+            m_ladder.push_back(rung);
+        }
+
+        m_improveFrames.assign(m_ladder.size(), m_options.ImproveFrames);
+
+        auto const found = std::find(m_ladder.begin(), m_ladder.end(), current);
+        m_rung = (found != m_ladder.end()) ? static_cast<size_t>(found - m_ladder.begin()) : 0;
+        m_slowHistory = 0;
+        m_fastFrames = 0;
+        m_onProbation = false;
+    }
+
+    void FrameGovernor::Reset() noexcept
+    {
+        std::fill(m_improveFrames.begin(), m_improveFrames.end(), m_options.ImproveFrames);
+        m_rung = 0;
+        m_slowHistory = 0;
+        m_fastFrames = 0;
+        m_settleFrames = 0;
+        m_onProbation = false;
+    }
+
+    bool FrameGovernor::OnFrame(Duration cost) noexcept
+    {
+        ++m_frame;
+        if (m_settleFrames > 0)
+        {
+            --m_settleFrames;
+            return false;
+        }
+
+        // A rung that lasted through probation is trusted again
+        if (m_onProbation && (m_frame - m_steppedUpFrame > m_options.ProbationFrames))
+        {
+            m_onProbation = false;
+            m_improveFrames[m_rung] = m_options.ImproveFrames;
+        }
+
+        double const frameCost = static_cast<double>(cost.count());
+        bool const slow = frameCost > static_cast<double>(Budget(m_rung).count()) * m_options.SlowThreshold;
+        uint64_t const windowMask = (m_options.Window == 64) ? ~uint64_t{ 0 } : (uint64_t{ 1 } << m_options.Window) - 1;
+        m_slowHistory = ((m_slowHistory << 1) | (slow ? 1 : 0)) & windowMask;
+
+        if ((std::bitset<64>(m_slowHistory).count() >= m_options.SlowFrames) && (m_rung + 1 < m_ladder.size()))
+        {
+            // Stepping down right after stepping up means the better rung
+            // isn't sustainable yet, so wait longer before trying it again
+            if (m_onProbation)
+            {
+                m_improveFrames[m_rung] = std::min(std::max(m_improveFrames[m_rung], 1u) * 2, std::max(m_options.MaxImproveFrames, m_options.ImproveFrames));
+                m_onProbation = false;
+            }
+
+            StepTo(m_rung + 1);
+            return true;
+        }
+
+        if (m_rung == 0)
+        {
+            return false;
+        }
+
+        bool const fast = frameCost <= static_cast<double>(Budget(m_rung - 1).count()) * m_options.FastThreshold;
+        m_fastFrames = fast ? m_fastFrames + 1 : 0;
+        if (m_fastFrames >= m_improveFrames[m_rung - 1])
+        {
+            StepTo(m_rung - 1);
+            m_onProbation = true;
+            m_steppedUpFrame = m_frame;
+            return true;
+        }
+
+        return false;
+    }
+
+    FrameGovernor::Duration FrameGovernor::Budget(size_t rung) const noexcept
+    {
+        return m_options.TargetFrameTime * std::max(m_ladder[rung].PresentInterval, 1u);
+    }
+
+    void FrameGovernor::StepTo(size_t rung) noexcept
+    {
+        m_rung = rung;
+        m_slowHistory = 0;
+        m_fastFrames = 0;
+        m_settleFrames = m_options.SettleFrames;
+        ++m_changes;
+    }
+}
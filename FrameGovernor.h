@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderScheduler.h"
+
+namespace PointerCore
+{
+    // Trades quality and latency for frame time when rendering gets too
+    // expensive, and takes it back once frames are cheap again.
+    //
+    // The governor walks a ladder of settings, from the best (full effects,
+    // lowest frame latency and present interval) to the cheapest. Going down
+    // a rung first lowers the effects level, then raises the maximum frame
+    // latency so the CPU and GPU can overlap, then raises the present
+    // interval, which gives each frame more time by showing fewer of them.
+    //
+    // Every frame reports what it cost to render and present. A frame is
+    // slow when it took more than SlowThreshold of the current rung's budget
+    // (the target frame time times the present interval), and the governor
+    // steps down once SlowFrames of the last Window frames were slow, so a
+    // lone hitch doesn't count. It steps back up only after ImproveFrames
+    // frames in a row fit in FastThreshold of the better rung's budget. If
+    // that rung turns out too slow again within ProbationFrames, the wait to
+    // try it next time doubles (up to MaxImproveFrames), which keeps a cost
+    // that sits right at a boundary from flipping back and forth.
+    //
+    // Like RenderScheduler it never reads a clock and isn't thread-safe.
+    class FrameGovernor
+    {
+    public:
+        using Duration = RenderScheduler::Duration;
+
+        enum class EffectsLevel : uint32_t
+        {
+            Minimal,
+            Reduced,
+            Full,
+        };
+
+        struct Settings
+        {
+            uint32_t MaxFrameLatency;
+            uint32_t PresentInterval;
+            EffectsLevel Effects;
+
+            bool operator==(Settings const& other) const noexcept
+            {
+                return (MaxFrameLatency == other.MaxFrameLatency) && (PresentInterval == other.PresentInterval) && (Effects == other.Effects);
+            }
+            bool operator!=(Settings const& other) const noexcept { return !(*this == other); }
+        };
+
+        struct Options
+        {
+            Duration TargetFrameTime = std::chrono::microseconds(16667);
+
+            // Ranges the frame latency and present interval are kept in
+            uint32_t MinFrameLatency = 1;
+            uint32_t MaxFrameLatency = 2;
+            uint32_t MinPresentInterval = 1;
+            uint32_t MaxPresentInterval = 2;
+
+            // Fractions of a rung's budget a frame must exceed to be slow, and
+            // fit in to be fast enough for the rung above
+            double SlowThreshold = 0.9;
+            double FastThreshold = 0.6;
+
+            // Slow frames among the last Window (at most 64) to step down
+            uint32_t Window = 30;
+            uint32_t SlowFrames = 5;
+
+            // Fast frames in a row to step up, and the limit that doubles to
+            uint32_t ImproveFrames = 90;
+            uint32_t MaxImproveFrames = 1440;
+
+            // Frames after stepping up during which stepping back down
+            // doubles the wait for that rung
+            uint32_t ProbationFrames = 120;
+
+            // Frames ignored after a change, while the swap chain adjusts
+            uint32_t SettleFrames = 2;
+        };
+
+        FrameGovernor();
+        explicit FrameGovernor(Options const& options);
+
+        Options const& GetOptions() const noexcept { return m_options; }
+
+        // Rebuilds the ladder. Keeps the current rung where it still exists.
+        void SetOptions(Options const& options);
+
+        // Back to the best rung, forgetting the frames seen so far
+        void Reset() noexcept;
+
+        // Once per presented frame, with the time spent rendering and
+        // presenting it. Returns true if the settings changed.
+        bool OnFrame(Duration cost) noexcept;
+
+        Settings const& CurrentSettings() const noexcept { return m_ladder[m_rung]; }
+
+        // 0 is the best rung
+        size_t Rung() const noexcept { return m_rung; }
+        size_t RungCount() const noexcept { return m_ladder.size(); }
+        Settings const& RungSettings(size_t rung) const noexcept { return m_ladder[rung]; }
+        Duration Budget(size_t rung) const noexcept;
+
+        uint64_t Changes() const noexcept { return m_changes; }
+
+    private:
+        void StepTo(size_t rung) noexcept;
+
+        Options m_options;
+        std::vector<Settings> m_ladder;
+
+        // Frames to wait before trying each rung again
+        std::vector<uint32_t> m_improveFrames;
+
+        size_t m_rung{ 0 };
+        uint64_t m_frame{ 0 };
+        uint64_t m_changes{ 0 };
+
+        // Bit i is set if the frame i frames ago was slow
+        uint64_t m_slowHistory{ 0 };
+        uint32_t m_fastFrames{ 0 };
+        uint32_t m_settleFrames{ 0 };
+
+        // Frame the current rung was stepped up to, if it's on probation
+        bool m_onProbation{ false };
+        uint64_t m_steppedUpFrame{ 0 };
+    };
+}
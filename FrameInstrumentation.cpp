@@ -0,0 +1,113 @@
+#include "FrameInstrumentation.h"
+
+#include <cstring>
+
+namespace PointerCore
+{
+    char const* FrameInstrumentation::MetricName(Metric metric) noexcept
+    {
+        switch (metric)
+        {
+        case Metric::InputToPresent:
+            return "inputToPresent";
+        case Metric::Render:
+            return "render";
+        case Metric::Present:
+            return "present";
+        case Metric::FrameInterval:
+            return "frameInterval";
+        default:
+            return "unknown";
+        }
+    }
+
+    void FrameInstrumentation::Reset()
+    {
+        for (auto& histogram : m_histograms)
+        {
+            histogram.Reset();
+        }
+
+        std::lock_guard lock{ m_queueLock };
+        m_queues.clear();
+    }
+
+    void FrameInstrumentation::SetQueueCounters(char const* name, QueueCounters const& counters)
+    {
+        std::lock_guard lock{ m_queueLock };
+        for (auto& queue : m_queues)
+        {
+            if (std::strcmp(queue.first, name) == 0)
+            {
+                queue.second = counters;
+                return;
+            }
+        }
+
+        m_queues.emplace_back(name, counters);
+    }
+
+    FrameInstrumentation::QueueCounters FrameInstrumentation::QueueCountersFor(char const* name) const
+    {
+        std::lock_guard lock{ m_queueLock };
+        for (auto const& queue : m_queues)
+        {
+            if (std::strcmp(queue.first, name) == 0)
+            {
+                return queue.second;
+            }
+        }
+
+        return {};
+    }
+
+    void FrameInstrumentation::WriteJson(std::ostream& out) const
+    {
+        out << "{\n  \"unit\": \"ns\",\n  \"metrics\": {";
+
+        for (size_t i = 0; i < static_cast<size_t>(Metric::Count); ++i)
+        {
+            auto const metric = static_cast<Metric>(i);
+            auto const& histogram = Histogram(metric);
+
+            out << ((i == 0) ? "\n" : ",\n");
+            out << "    \"" << MetricName(metric) << "\": {\n";
+            out << "      \"count\": " << histogram.Count() << ",\n";
+            out << "      \"min\": " << histogram.Min() << ",\n";
+            out << "      \"max\": " << histogram.Max() << ",\n";
+            out << "      \"mean\": " << histogram.Mean() << ",\n";
+            out << "      \"p50\": " << histogram.ValueAtPercentile(50.0) << ",\n";
+            out << "      \"p90\": " << histogram.ValueAtPercentile(90.0) << ",\n";
+            out << "      \"p99\": " << histogram.ValueAtPercentile(99.0) << ",\n";
+            out << "      \"p99.9\": " << histogram.ValueAtPercentile(99.9) << ",\n";
+
+            // [lower bound, upper bound, count] for every non-empty bucket
+            out << "      \"buckets\": [";
+            bool first = true;
+            for (size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket)
+            {
+                uint64_t const count = histogram.BucketValueCount(bucket);
+                if (count == 0)
+                {
+                    continue;
+                }
+
+                out << (first ? "" : ", ") << '[' << LatencyHistogram::BucketLowerBound(bucket) << ", " << LatencyHistogram::BucketUpperBound(bucket) << ", " << count << ']';
+                first = false;
+            }
+            out << "]\n    }";
+        }
+
+        out << "\n  },\n  \"queues\": {";
+
+        std::lock_guard lock{ m_queueLock };
+        for (size_t i = 0; i < m_queues.size(); ++i)
+        {
+            auto const& [name, counters] = m_queues[i];
+            out << ((i == 0) ? "\n" : ",\n");
+            out << "    \"" << name << "\": { \"overflows\": " << counters.Overflows << ", \"highWaterMark\": " << counters.HighWaterMark << ", \"capacity\": " << counters.Capacity << " }";
+        }
+
+        out << (m_queues.empty() ? "}\n}\n" : "\n  }\n}\n");
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+namespace PointerCore
+{
+    // Latency statistics for the hot paths of the renderer.
+    //
+    // Every metric is a LatencyHistogram of nanoseconds. While disabled,
+    // Record() is a single relaxed load and callers can skip taking timestamps
+    // altogether by checking IsEnabled() first.
+    class FrameInstrumentation
+    {
+    public:
+        enum class Metric : size_t
+        {
+            // From an input handler seeing an event to the Present() that first shows it
+            InputToPresent,
+
+            // Drawing the scene
+            Render,
+
+            // The swap chain Present() call
+            Present,
+
+            // From the start of one rendered frame to the start of the next
+            FrameInterval,
+
+            Count,
+        };
+
+        // Monotonic timestamp in nanoseconds, never zero
+        static uint64_t Now() noexcept
+        {
+            auto const now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+            return static_cast<uint64_t>(now.count()) | 1;
+        }
+
+        static char const* MetricName(Metric metric) noexcept;
+
+        bool IsEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+        void SetEnabled(bool enabled) noexcept { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        void Record(Metric metric, uint64_t nanoseconds) noexcept
+        {
+            if (IsEnabled())
+            {
+                m_histograms[static_cast<size_t>(metric)].Record(nanoseconds);
+            }
+        }
+
+        // Records end - start if both timestamps were taken
+        void RecordInterval(Metric metric, uint64_t start, uint64_t end) noexcept
+        {
+            if ((start != 0) && (end >= start))
+            {
+                Record(metric, end - start);
+            }
+        }
+
+        // Counters of a bounded queue that drops on overflow, such as SpscRing's
+        struct QueueCounters
+        {
+            uint64_t Overflows{};
+            size_t HighWaterMark{};
+            size_t Capacity{};
+        };
+
+        LatencyHistogram const& Histogram(Metric metric) const noexcept { return m_histograms[static_cast<size_t>(metric)]; }
+        void Reset();
+
+        // Adds or replaces the counters reported for a queue. The name must
+        // outlive the instrumentation, a string literal in practice.
+        void SetQueueCounters(char const* name, QueueCounters const& counters);
+        QueueCounters QueueCountersFor(char const* name) const;
+
+        // Writes every metric's summary statistics and non-empty buckets, and
+        // every queue's counters, as a JSON object
+        void WriteJson(std::ostream& out) const;
+
+    private:
+        std::atomic_bool m_enabled{ false };
+        LatencyHistogram m_histograms[static_cast<size_t>(Metric::Count)];
+
+        // Set when a measurement ends, possibly while the last one is still being written
+        mutable std::mutex m_queueLock;
+        std::vector<std::pair<char const*, QueueCounters>> m_queues;
+    };
+}
@@ -0,0 +1,236 @@
+#include "FrameTimeline.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace PointerCore
+{
+    namespace
+    {
+        std::atomic<uint64_t> s_nextInstanceId{ 1 };
+
+        // The ring a thread last recorded into, so recording only looks a
+        // ring up when a thread switches timelines
+        struct ThreadRingCache
+        {
+            uint64_t InstanceId{ 0 };
+            void* Ring{ nullptr };
+        };
+
+        thread_local ThreadRingCache t_ringCache;
+
+        size_t RoundUpToPowerOfTwo(size_t value) noexcept
+        {
+            size_t result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+
+            return result;
+        }
+
+        void WriteJsonString(std::ostream& out, char const* text)
+        {
+            out << '"';
+            for (char const* c = text; *c != '\0'; ++c)
+            {
+                if ((*c == '"') || (*c == '\\'))
+                {
+                    out << '\\' << *c;
+                }
+                else if (static_cast<unsigned char>(*c) >= 0x20)
+                {
+                    out << *c;
+                }
+            }
+            out << '"';
+        }
+
+        // Microseconds with nanosecond precision, as trace viewers expect
+        void WriteMicroseconds(std::ostream& out, uint64_t nanoseconds)
+        {
+            uint64_t const fraction = nanoseconds % 1000;
+            out << nanoseconds / 1000 << '.' << static_cast<char>('0' + fraction / 100)
+                << static_cast<char>('0' + fraction / 10 % 10) << static_cast<char>('0' + fraction % 10);
+        }
+    }
+
+    FrameTimeline::FrameTimeline(size_t ringCapacity)
+        : m_ringCapacity{ RoundUpToPowerOfTwo(std::max<size_t>(ringCapacity, 1)) }
+        , m_instanceId{ s_nextInstanceId.fetch_add(1, std::memory_order_relaxed) }
+    {
+    }
+
+    void FrameTimeline::Record(char const* name, uint64_t start, uint64_t end) noexcept
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        // Without a ring (out of memory) the span is dropped
+        Ring* ring;
+        try
+        {
+            ring = &ThreadRing();
+        }
+        catch (...)
+        {
+            return;
+        }
+
+        uint64_t const head = ring->Head.load(std::memory_order_relaxed);
+        Slot& slot = ring->Slots[head & (m_ringCapacity - 1)];
+
+        // A reader that sees any of the stores below also sees the head from
+        // before them, and so knows the slot may be mid-overwrite
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.Name.store(name, std::memory_order_relaxed);
+        slot.Start.store(start, std::memory_order_relaxed);
+        slot.End.store(end, std::memory_order_relaxed);
+        ring->Head.store(head + 1, std::memory_order_release);
+    }
+
+    void FrameTimeline::NameThread(char const* name)
+    {
+        auto const self = std::this_thread::get_id();
+
+        // Naming a thread doesn't give it a ring, it may never record anything
+        std::lock_guard lock{ m_ringsLock };
+        auto const ring = std::find_if(m_rings.begin(), m_rings.end(), [self](auto const& candidate) { return candidate->Owner == self; });
+        if (ring != m_rings.end())
+        {
+            (*ring)->Name = name;
+        }
+        else
+        {
+            m_threadNames[self] = name;
+        }
+    }
+
+    void FrameTimeline::Collect(std::vector<TimelineEvent>& out) const
+    {
+        std::lock_guard lock{ m_ringsLock };
+        for (auto const& ring : m_rings)
+        {
+            uint64_t const end = ring->Head.load(std::memory_order_acquire);
+            uint64_t const oldest = (end > m_ringCapacity) ? end - m_ringCapacity : 0;
+            uint64_t const begin = std::max(oldest, ring->ClearedBefore);
+
+            size_t const first = out.size();
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                Slot const& slot = ring->Slots[i & (m_ringCapacity - 1)];
+                out.push_back({
+                    slot.Name.load(std::memory_order_relaxed),
+                    slot.Start.load(std::memory_order_relaxed),
+                    slot.End.load(std::memory_order_relaxed),
+                    ring->ThreadId });
+            }
+
+            // Spans the owner may have started overwriting while we copied.
+            // The slot of span i is reused by span i + capacity, which is
+            // written while the head is at i + capacity.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t const head = ring->Head.load(std::memory_order_relaxed);
+            uint64_t const valid = (head + 1 > m_ringCapacity) ? head + 1 - m_ringCapacity : 0;
+            if (valid > begin)
+            {
+                size_t const torn = static_cast<size_t>(std::min(valid, end) - begin);
+                out.erase(out.begin() + first, out.begin() + first + torn);
+            }
+        }
+    }
+
+    void FrameTimeline::Clear() noexcept
+    {
+        std::lock_guard lock{ m_ringsLock };
+        for (auto const& ring : m_rings)
+        {
+            ring->ClearedBefore = ring->Head.load(std::memory_order_acquire);
+        }
+    }
+
+    void FrameTimeline::WriteChromeTrace(std::ostream& out) const
+    {
+        std::vector<TimelineEvent> events;
+        Collect(events);
+
+        // Times relative to the earliest span keep the numbers readable
+        uint64_t origin = UINT64_MAX;
+        for (auto const& event : events)
+        {
+            origin = std::min(origin, event.Start);
+        }
+
+        out << "{\n  \"displayTimeUnit\": \"ns\",\n  \"traceEvents\": [";
+
+        bool first = true;
+        {
+            std::lock_guard lock{ m_ringsLock };
+            for (auto const& ring : m_rings)
+            {
+                if (ring->Name.empty())
+                {
+                    continue;
+                }
+
+                out << (first ? "\n" : ",\n");
+                out << "    { \"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": " << ring->ThreadId << ", \"args\": { \"name\": ";
+                WriteJsonString(out, ring->Name.c_str());
+                out << " } }";
+                first = false;
+            }
+        }
+
+        for (auto const& event : events)
+        {
+            out << (first ? "\n" : ",\n");
+            out << "    { \"ph\": \"X\", \"name\": ";
+            WriteJsonString(out, event.Name);
+            out << ", \"pid\": 1, \"tid\": " << event.ThreadId << ", \"ts\": ";
+            WriteMicroseconds(out, event.Start - origin);
+            out << ", \"dur\": ";
+            WriteMicroseconds(out, (event.End > event.Start) ? event.End - event.Start : 0);
+            out << " }";
+            first = false;
+        }
+
+        out << "\n  ]\n}\n";
+    }
+
+    size_t FrameTimeline::ThreadCount() const
+    {
+        std::lock_guard lock{ m_ringsLock };
+        return m_rings.size();
+    }
+
+    FrameTimeline::Ring& FrameTimeline::ThreadRing()
+    {
+        if (t_ringCache.InstanceId == m_instanceId)
+        {
+            return *static_cast<Ring*>(t_ringCache.Ring);
+        }
+
+        auto const self = std::this_thread::get_id();
+
+        std::lock_guard lock{ m_ringsLock };
+        auto found = std::find_if(m_rings.begin(), m_rings.end(), [self](auto const& candidate) { return candidate->Owner == self; });
+        if (found == m_rings.end())
+        {
+            m_rings.push_back(std::make_unique<Ring>(self, static_cast<uint32_t>(m_rings.size() + 1), m_ringCapacity));
+            found = m_rings.end() - 1;
+
+            auto const name = m_threadNames.find(self);
+            if (name != m_threadNames.end())
+            {
+                (*found)->Name = std::move(name->second);
+                m_threadNames.erase(name);
+            }
+        }
+
+        t_ringCache = { m_instanceId, found->get() };
+        return **found;
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace PointerCore
+{
+    struct TimelineEvent
+    {
+        char const* Name;
+
+        // Nanoseconds, see FrameTimeline::Now()
+        uint64_t Start;
+        uint64_t End;
+
+        // Small ID of the thread that recorded it, in order of first use
+        uint32_t ThreadId;
+    };
+
+    // Records timed spans from any number of threads for viewing on a timeline.
+    //
+    // Every thread records into its own ring buffer, so recording never takes
+    // a lock or contends with other threads: a span is three relaxed stores
+    // and a release store of the ring's head. While disabled, recording is a
+    // single relaxed load. Rings keep the most recent spans and overwrite the
+    // oldest; Collect() copies them out while recording goes on, and drops
+    // any span it may have seen half overwritten.
+    //
+    // Span names aren't copied, they must outlive the timeline (string
+    // literals, typically). A thread gets a ring the first time it records
+    // and the ring is kept, spans and all, until the timeline is destroyed.
+    class FrameTimeline
+    {
+    public:
+        static constexpr size_t DefaultRingCapacity = 8192;
+
+        // Monotonic timestamp in nanoseconds
+        static uint64_t Now() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Rounds the capacity of each thread's ring up to a power of two
+        explicit FrameTimeline(size_t ringCapacity = DefaultRingCapacity);
+
+        FrameTimeline(FrameTimeline const&) = delete;
+        FrameTimeline& operator=(FrameTimeline const&) = delete;
+
+        bool IsEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+        void SetEnabled(bool enabled) noexcept { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        void Record(char const* name, uint64_t start, uint64_t end) noexcept;
+
+        // Labels the calling thread's track in exported traces. Cheap to call
+        // up front, the thread only gets a ring once it records.
+        void NameThread(char const* name);
+
+        // Appends the spans still in the rings, oldest first per thread.
+        // Safe to call while other threads record.
+        void Collect(std::vector<TimelineEvent>& out) const;
+
+        // Forgets the spans recorded so far
+        void Clear() noexcept;
+
+        // Chrome trace-event JSON ("X" complete events plus thread names),
+        // which chrome://tracing and the Perfetto UI both open
+        void WriteChromeTrace(std::ostream& out) const;
+
+        size_t RingCapacity() const noexcept { return m_ringCapacity; }
+        size_t ThreadCount() const;
+
+    private:
+        struct Slot
+        {
+            std::atomic<char const*> Name{ nullptr };
+            std::atomic<uint64_t> Start{ 0 };
+            std::atomic<uint64_t> End{ 0 };
+        };
+
+        struct Ring
+        {
+            Ring(std::thread::id owner, uint32_t threadId, size_t capacity)
+                : Owner{ owner }
+                , ThreadId{ threadId }
+                , Slots{ new Slot[capacity] }
+            {
+            }
+
+            std::thread::id const Owner;
+            uint32_t const ThreadId;
+            std::unique_ptr<Slot[]> const Slots;
+
+            // Spans ever recorded, only written by the owning thread
+            std::atomic<uint64_t> Head{ 0 };
+
+            // Spans before this were cleared (under m_ringsLock)
+            uint64_t ClearedBefore{ 0 };
+            std::string Name;
+        };
+
+        // The calling thread's ring, created on first use
+        Ring& ThreadRing();
+
+        std::atomic_bool m_enabled{ false };
+        size_t const m_ringCapacity;
+        uint64_t const m_instanceId;
+
+        mutable std::mutex m_ringsLock;
+        std::vector<std::unique_ptr<Ring>> m_rings;
+
+        // Names of threads that don't have a ring yet
+        std::unordered_map<std::thread::id, std::string> m_threadNames;
+    };
+
+    // Records the time from its construction to End() or its destruction as a span
+    class TimelineSpan
+    {
+    public:
+        TimelineSpan(FrameTimeline& timeline, char const* name) noexcept
+            : m_timeline{ timeline }
+            , m_name{ name }
+            , m_start{ timeline.IsEnabled() ? FrameTimeline::Now() : 0 }
+        {
+        }
+
+        ~TimelineSpan() { End(); }
+
+        TimelineSpan(TimelineSpan const&) = delete;
+        TimelineSpan& operator=(TimelineSpan const&) = delete;
+
+        void End() noexcept
+        {
+            if (m_start != 0)
+            {
+                m_timeline.Record(m_name, m_start, FrameTimeline::Now());
+                m_start = 0;
+            }
+        }
+
+    private:
+        FrameTimeline& m_timeline;
+        char const* m_name;
+        uint64_t m_start;
+    };
+}
@@ -0,0 +1,3 @@
+#include "pch.h"
+#include "GestureEventArgs.h"
+#include "GestureEventArgs.g.cpp"
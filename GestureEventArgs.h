@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GestureEventArgs.g.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    // Position is the tap position, or the point the manipulation delta scales
+    // and rotates about. Rotation is in degrees, clockwise, like XAML's
+    // ManipulationDelta.
+    struct GestureEventArgs : GestureEventArgsT<GestureEventArgs>
+    {
+        GestureEventArgs(PointerDemo::GestureKind kind, uint32_t contactCount, Windows::Foundation::Point position,
+            Windows::Foundation::Point translation, float scale, float rotation) noexcept
+            : m_kind{ kind }
+            , m_contactCount{ contactCount }
+            , m_position{ position }
+            , m_translation{ translation }
+            , m_scale{ scale }
+            , m_rotation{ rotation }
+        {
+        }
+
+        PointerDemo::GestureKind Kind() const noexcept { return m_kind; }
+        uint32_t ContactCount() const noexcept { return m_contactCount; }
+        Windows::Foundation::Point Position() const noexcept { return m_position; }
+        Windows::Foundation::Point Translation() const noexcept { return m_translation; }
+        float Scale() const noexcept { return m_scale; }
+        float Rotation() const noexcept { return m_rotation; }
+
+    private:
+        PointerDemo::GestureKind m_kind;
+        uint32_t m_contactCount;
+        Windows::Foundation::Point m_position;
+        Windows::Foundation::Point m_translation;
+        float m_scale;
+        float m_rotation;
+    };
+}
\ No newline at end of file
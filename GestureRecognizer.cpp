@@ -0,0 +1,308 @@
+#include "GestureRecognizer.h"
+
+#include <cmath>
+#include <utility>
+
+namespace PointerCore
+{
+    GestureRecognizer::GestureRecognizer()
+        : GestureRecognizer(Options())
+    {
+    }
+
+    GestureRecognizer::GestureRecognizer(Options const& options)
+        : m_options(options)
+    {
+    }
+
+    void GestureRecognizer::Process(PointerEvent const& event)
+    {
+        auto const found = m_indices.find(event.Id);
+        if (found == m_indices.end())
+        {
+            if (event.Kind == PointerEventKind::Pressed)
+            {
+                AddContact(event);
+            }
+
+            return;
+        }
+
+        size_t const index = found->second;
+        MoveContact(m_contacts[index], event.X, event.Y);
+
+        bool const lifted = (event.Kind == PointerEventKind::Released) || (event.Kind == PointerEventKind::Exited) ||
+            ((event.Kind == PointerEventKind::Moved) && !event.InContact);
+        if (lifted)
+        {
+            RemoveContact(index, event.Timestamp);
+        }
+    }
+
+    void GestureRecognizer::Flush(GestureFrame& out)
+    {
+        CommitFit();
+
+        // A new session's motion belongs to this frame only once it's a
+        // manipulation; until then it stays with that session
+        bool const pending = !m_manipulating && !m_contacts.empty();
+        Transform transform = m_frameTransform;
+        Point origin = m_frameOrigin;
+        if (m_hasEndedTransform)
+        {
+            transform = pending ? m_endedTransform : Compose(m_endedTransform, m_frameTransform);
+            origin = m_endedOrigin;
+        }
+
+        out.Active = m_manipulating || m_started || m_ended;
+        out.Started = m_started;
+        out.Ended = m_ended;
+        out.ContactCount = static_cast<uint32_t>(m_contacts.size());
+        out.Origin = origin;
+        if (out.Active)
+        {
+            // Express the transform as translation, scale and rotation about the origin
+            Transform const& t = transform;
+            double const originX = origin.X;
+            double const originY = origin.Y;
+            out.Translation = {
+                static_cast<float>(t.A * originX - t.B * originY + t.X - originX),
+                static_cast<float>(t.B * originX + t.A * originY + t.Y - originY) };
+            out.Scale = static_cast<float>(std::sqrt(t.A * t.A + t.B * t.B));
+            out.Rotation = static_cast<float>(std::atan2(t.B, t.A));
+        }
+        else
+        {
+            out.Translation = { 0.0f, 0.0f };
+            out.Scale = 1.0f;
+            out.Rotation = 0.0f;
+        }
+
+        out.Taps.clear();
+        std::swap(out.Taps, m_taps);
+
+        // The next frame starts from here. Until a session turns into a
+        // manipulation its motion keeps adding up, so the frame it starts in
+        // covers everything since the first press and content doesn't lag
+        // behind the contacts by the slop.
+        if (!pending)
+        {
+            m_frameTransform = { 1.0, 0.0, 0.0, 0.0 };
+            m_frameHasOrigin = !m_contacts.empty();
+            if (m_frameHasOrigin)
+            {
+                double const count = static_cast<double>(m_contacts.size());
+                m_frameOrigin = { static_cast<float>(m_sumQX / count), static_cast<float>(m_sumQY / count) };
+            }
+        }
+        m_started = false;
+        m_ended = false;
+        m_hasEndedTransform = false;
+    }
+
+    void GestureRecognizer::Clear() noexcept
+    {
+        m_contacts.clear();
+        m_indices.clear();
+        m_sumPX = m_sumPY = m_sumQX = m_sumQY = 0.0;
+        m_sumPP = m_sumQQ = m_sumPDotQ = m_sumPCrossQ = 0.0;
+        m_frameTransform = { 1.0, 0.0, 0.0, 0.0 };
+        m_frameHasOrigin = false;
+        m_started = false;
+        m_ended = false;
+        m_taps.clear();
+        m_hasEndedTransform = false;
+        m_manipulating = false;
+    }
+
+    void GestureRecognizer::AddContact(PointerEvent const& event)
+    {
+        CommitFit();
+
+        if (m_contacts.empty())
+        {
+            // Drop what a previous session that wasn't a manipulation left
+            // in this frame. One that was and ended is set aside for Flush()
+            // to report, so this session starts from nothing either way.
+            if (m_ended)
+            {
+                m_endedTransform = m_hasEndedTransform ? Compose(m_endedTransform, m_frameTransform) : m_frameTransform;
+                if (!m_hasEndedTransform)
+                {
+                    m_endedOrigin = m_frameOrigin;
+                }
+                m_hasEndedTransform = true;
+            }
+
+            m_frameTransform = { 1.0, 0.0, 0.0, 0.0 };
+            m_frameHasOrigin = false;
+
+            m_manipulating = false;
+            m_sessionStart = event.Timestamp;
+            m_sessionContacts = 0;
+            m_sessionPressX = 0.0;
+            m_sessionPressY = 0.0;
+        }
+
+        if (!m_frameHasOrigin)
+        {
+            m_frameOrigin = { event.X, event.Y };
+            m_frameHasOrigin = true;
+        }
+
+        double const x = event.X;
+        double const y = event.Y;
+        m_indices.emplace(event.Id, m_contacts.size());
+        m_contacts.push_back({ event.Id, m_epoch, x, y, x, y, x, y });
+        AddTerms(m_contacts.back(), 1.0);
+
+        ++m_sessionContacts;
+        m_sessionPressX += x;
+        m_sessionPressY += y;
+    }
+
+    void GestureRecognizer::MoveContact(Contact& contact, double x, double y) noexcept
+    {
+        if ((x == contact.X) && (y == contact.Y))
+        {
+            return;
+        }
+
+        // A stale anchor is where the contact was when anchors were last reset,
+        // i.e. where it still is
+        if (contact.Epoch != m_epoch)
+        {
+            contact.Epoch = m_epoch;
+            contact.AnchorX = contact.X;
+            contact.AnchorY = contact.Y;
+        }
+
+        AddTerms(contact, -1.0);
+        contact.X = x;
+        contact.Y = y;
+        AddTerms(contact, 1.0);
+
+        if (!m_manipulating)
+        {
+            double const dx = x - contact.PressX;
+            double const dy = y - contact.PressY;
+            double const slop = m_options.TapSlop;
+            if (dx * dx + dy * dy > slop * slop)
+            {
+                m_manipulating = true;
+                m_started = true;
+            }
+        }
+    }
+
+    void GestureRecognizer::RemoveContact(size_t index, uint64_t timestamp)
+    {
+        CommitFit();
+
+        // Anchors were just reset, so the contact's terms are its current position
+        Contact& contact = m_contacts[index];
+        contact.Epoch = m_epoch;
+        contact.AnchorX = contact.X;
+        contact.AnchorY = contact.Y;
+        AddTerms(contact, -1.0);
+
+        m_indices.erase(contact.Id);
+        if (index + 1 != m_contacts.size())
+        {
+            contact = m_contacts.back();
+            m_indices[contact.Id] = index;
+        }
+        m_contacts.pop_back();
+
+        if (!m_contacts.empty())
+        {
+            return;
+        }
+
+        // End of the session. Start the sums over from exact zeros so rounding
+        // doesn't build up across sessions.
+        m_sumPX = m_sumPY = m_sumQX = m_sumQY = 0.0;
+        m_sumPP = m_sumQQ = m_sumPDotQ = m_sumPCrossQ = 0.0;
+
+        if (m_manipulating)
+        {
+            m_manipulating = false;
+            m_ended = true;
+        }
+        else if (timestamp - m_sessionStart <= m_options.TapMaxDuration)
+        {
+            double const count = m_sessionContacts;
+            m_taps.push_back({
+                { static_cast<float>(m_sessionPressX / count), static_cast<float>(m_sessionPressY / count) },
+                m_sessionContacts,
+                timestamp });
+        }
+    }
+
+    void GestureRecognizer::AddTerms(Contact const& contact, double sign) noexcept
+    {
+        double const px = contact.AnchorX;
+        double const py = contact.AnchorY;
+        double const qx = contact.X;
+        double const qy = contact.Y;
+        m_sumPX += sign * px;
+        m_sumPY += sign * py;
+        m_sumQX += sign * qx;
+        m_sumQY += sign * qy;
+        m_sumPP += sign * (px * px + py * py);
+        m_sumQQ += sign * (qx * qx + qy * qy);
+        m_sumPDotQ += sign * (px * qx + py * qy);
+        m_sumPCrossQ += sign * (px * qy - py * qx);
+    }
+
+    GestureRecognizer::Transform GestureRecognizer::Fit() const noexcept
+    {
+        if (m_contacts.empty())
+        {
+            return { 1.0, 0.0, 0.0, 0.0 };
+        }
+
+        double const count = static_cast<double>(m_contacts.size());
+        double const px = m_sumPX / count;
+        double const py = m_sumPY / count;
+        double const qx = m_sumQX / count;
+        double const qy = m_sumQY / count;
+
+        // Scale and rotation from the sums about the centroids, unless the
+        // contacts are too close together for them to mean anything
+        double a = 1.0;
+        double b = 0.0;
+        double const spreadP = m_sumPP - count * (px * px + py * py);
+        double const minSpread = m_options.MinSpread;
+        if ((m_contacts.size() > 1) && (spreadP > count * minSpread * minSpread))
+        {
+            a = (m_sumPDotQ - count * (px * qx + py * qy)) / spreadP;
+            b = (m_sumPCrossQ - count * (px * qy - py * qx)) / spreadP;
+        }
+
+        return { a, b, qx - (a * px - b * py), qy - (b * px + a * py) };
+    }
+
+    void GestureRecognizer::CommitFit() noexcept
+    {
+        // Apply this segment's fit after the frame's transform so far
+        m_frameTransform = Compose(m_frameTransform, Fit());
+
+        // Move every anchor to its contact's current position
+        m_sumPX = m_sumQX;
+        m_sumPY = m_sumQY;
+        m_sumPP = m_sumQQ;
+        m_sumPDotQ = m_sumQQ;
+        m_sumPCrossQ = 0.0;
+        ++m_epoch;
+    }
+
+    GestureRecognizer::Transform GestureRecognizer::Compose(Transform const& first, Transform const& then) noexcept
+    {
+        return {
+            then.A * first.A - then.B * first.B,
+            then.A * first.B + then.B * first.A,
+            then.A * first.X - then.B * first.Y + then.X,
+            then.B * first.X + then.A * first.Y + then.Y };
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    struct GestureTap
+    {
+        // Average press position of the contacts that took part
+        Point Position;
+        uint32_t ContactCount;
+        uint64_t Timestamp;
+    };
+
+    // What the contacts did since the previous GestureRecognizer::Flush().
+    //
+    // Points under the contacts moved by x' = Origin + Translation +
+    // Scale * Rotate(Rotation) * (x - Origin), so a content transform can
+    // apply the frame directly.
+    struct GestureFrame
+    {
+        // A manipulation (pan, pinch or rotate) is in progress, began this
+        // frame, or ended this frame when the last contact lifted
+        bool Active{ false };
+        bool Started{ false };
+        bool Ended{ false };
+
+        // Contacts down at the end of the frame
+        uint32_t ContactCount{ 0 };
+
+        // Centroid of the contacts at the start of the frame (of the
+        // session, for the frame a manipulation starts in), in DIPs
+        Point Origin{ 0.0f, 0.0f };
+        Point Translation{ 0.0f, 0.0f };
+        float Scale{ 1.0f };
+
+        // Radians, clockwise on screen
+        float Rotation{ 0.0f };
+
+        std::vector<GestureTap> Taps;
+    };
+
+    // Incremental pan/pinch/rotate and tap recognizer fed with pointer events.
+    //
+    // The transform is the least-squares similarity fit mapping each
+    // contact's position at the start of the frame (its anchor) to where it
+    // is now. The fit only needs sums over the contacts (of anchor and
+    // current positions, their squares, dot and cross products), so a move
+    // replaces one contact's terms in the sums and costs O(1) however many
+    // contacts are down. Whenever a contact is added or removed, the fit so
+    // far is folded into the frame's transform and all anchors are reset;
+    // the reset is O(1) too, since the sums for "anchor = current" follow
+    // from the current ones and each contact only picks up its new anchor
+    // when it next moves.
+    //
+    // A session runs from the first contact down to the last one up. It
+    // becomes a manipulation once any contact moves further than TapSlop
+    // from where it was pressed; a session that never does and is over
+    // within TapMaxDuration is a tap.
+    class GestureRecognizer
+    {
+    public:
+        struct Options
+        {
+            // DIPs a contact may move before the session stops being a tap
+            float TapSlop = 10.0f;
+
+            // Microseconds from the first press to the last release of a tap
+            uint64_t TapMaxDuration = 300000;
+
+            // Below this RMS distance of the contacts from their centroid, in
+            // DIPs, scale and rotation are too noisy and only translation is fitted
+            float MinSpread = 8.0f;
+        };
+
+        GestureRecognizer();
+        explicit GestureRecognizer(Options const& options);
+
+        // Expects a valid order per pointer (see PointerLifecycle). Pressed
+        // adds a contact, moves update it, Released and Exited remove it.
+        void Process(PointerEvent const& event);
+
+        // Once per frame. Writes what happened since the previous flush and
+        // starts a new frame.
+        void Flush(GestureFrame& out);
+
+        // Drops all contacts without reporting a tap or the end of a manipulation
+        void Clear() noexcept;
+
+        size_t ContactCount() const noexcept { return m_contacts.size(); }
+        bool IsManipulating() const noexcept { return m_manipulating; }
+
+    private:
+        struct Contact
+        {
+            uint32_t Id;
+            uint64_t Epoch;
+            double AnchorX;
+            double AnchorY;
+            double X;
+            double Y;
+            double PressX;
+            double PressY;
+        };
+
+        // 2x2 similarity (A, B; -B, A) plus translation
+        struct Transform
+        {
+            double A;
+            double B;
+            double X;
+            double Y;
+        };
+
+        void AddContact(PointerEvent const& event);
+        void MoveContact(Contact& contact, double x, double y) noexcept;
+        void RemoveContact(size_t index, uint64_t timestamp);
+
+        void AddTerms(Contact const& contact, double sign) noexcept;
+        Transform Fit() const noexcept;
+        static Transform Compose(Transform const& first, Transform const& then) noexcept;
+        void CommitFit() noexcept;
+
+        Options m_options;
+
+        std::vector<Contact> m_contacts;
+        std::unordered_map<uint32_t, size_t> m_indices;
+
+        // Sums over the contacts of anchor (P) and current (Q) positions.
+        // Anchors are stale for contacts whose Epoch isn't m_epoch; theirs
+        // equal their current position.
+        uint64_t m_epoch{ 0 };
+        double m_sumPX{ 0.0 };
+        double m_sumPY{ 0.0 };
+        double m_sumQX{ 0.0 };
+        double m_sumQY{ 0.0 };
+        double m_sumPP{ 0.0 };
+        double m_sumQQ{ 0.0 };
+        double m_sumPDotQ{ 0.0 };
+        double m_sumPCrossQ{ 0.0 };
+
+        // Frame state
+        Transform m_frameTransform{ 1.0, 0.0, 0.0, 0.0 };
+        Point m_frameOrigin{ 0.0f, 0.0f };
+        bool m_frameHasOrigin{ false };
+        bool m_started{ false };
+        bool m_ended{ false };
+        std::vector<GestureTap> m_taps;
+
+        // A manipulation that ended this frame, set aside when another
+        // session starts in the same frame
+        Transform m_endedTransform{ 1.0, 0.0, 0.0, 0.0 };
+        Point m_endedOrigin{ 0.0f, 0.0f };
+        bool m_hasEndedTransform{ false };
+
+        // Session state
+        bool m_manipulating{ false };
+        uint64_t m_sessionStart{ 0 };
+        uint32_t m_sessionContacts{ 0 };
+        double m_sessionPressX{ 0.0 };
+        double m_sessionPressY{ 0.0 };
+    };
+}
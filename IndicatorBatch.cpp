@@ -0,0 +1,125 @@
+#include "IndicatorBatch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define POINTERCORE_INDICATORBATCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace PointerCore
+{
+    static inline bool Intersects(Rect const& a, Rect const& b) noexcept
+    {
+        return (a.Right > b.Left) && (a.Left < b.Right) && (a.Bottom > b.Top) && (a.Top < b.Bottom);
+    }
+
+    void IndicatorBatch::Build(PointerTable const& pointers, IndicatorStyle const& style)
+    {
+        Build(pointers, style, nullptr);
+    }
+
+    void IndicatorBatch::Build(PointerTable const& pointers, IndicatorStyle const& style, Rect const& bounds)
+    {
+        Build(pointers, style, &bounds);
+    }
+
+    void IndicatorBatch::Build(PointerTable const& pointers, IndicatorStyle const& style, Rect const* bounds)
+    {
+        size_t const count = pointers.Size();
+        if (m_rects.size() < count)
+        {
+            m_rects.resize(pointers.Capacity());
+            m_colors.resize(pointers.Capacity());
+        }
+
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        uint64_t const* pressedBits = pointers.PressedBits();
+        float const halfSize = style.HalfSize;
+
+        Rect* rects = m_rects.data();
+        Color* colors = m_colors.data();
+        size_t size = 0;
+        size_t i = 0;
+
+#if defined(POINTERCORE_INDICATORBATCH_SSE2)
+        __m128 const half = _mm_set1_ps(halfSize);
+        __m128 const hover = _mm_loadu_ps(&style.HoverColor.R);
+        __m128 const pressed = _mm_loadu_ps(&style.PressedColor.R);
+
+        __m128 boundsLeft = _mm_setzero_ps();
+        __m128 boundsTop = _mm_setzero_ps();
+        __m128 boundsRight = _mm_setzero_ps();
+        __m128 boundsBottom = _mm_setzero_ps();
+        if (bounds != nullptr)
+        {
+            boundsLeft = _mm_set1_ps(bounds->Left);
+            boundsTop = _mm_set1_ps(bounds->Top);
+            boundsRight = _mm_set1_ps(bounds->Right);
+            boundsBottom = _mm_set1_ps(bounds->Bottom);
+        }
+
+        // Four pointers at a time: compute the edges as columns, then transpose
+        // them into one Rect per lane
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 const x = _mm_loadu_ps(xs + i);
+            __m128 const y = _mm_loadu_ps(ys + i);
+            __m128 left = _mm_sub_ps(x, half);
+            __m128 top = _mm_sub_ps(y, half);
+            __m128 right = _mm_add_ps(x, half);
+            __m128 bottom = _mm_add_ps(y, half);
+
+            int visible = 0xf;
+            if (bounds != nullptr)
+            {
+                __m128 const horizontal = _mm_and_ps(_mm_cmpgt_ps(right, boundsLeft), _mm_cmplt_ps(left, boundsRight));
+                __m128 const vertical = _mm_and_ps(_mm_cmpgt_ps(bottom, boundsTop), _mm_cmplt_ps(top, boundsBottom));
+                visible = _mm_movemask_ps(_mm_and_ps(horizontal, vertical));
+                if (visible == 0)
+                {
+                    continue;
+                }
+            }
+
+            _MM_TRANSPOSE4_PS(left, top, right, bottom);
+            __m128 const lanes[4] = { left, top, right, bottom };
+
+            // i is a multiple of 4, so the four bits never straddle two words
+            auto const pressedLanes = static_cast<unsigned>((pressedBits[i / 64] >> (i % 64)) & 0xf);
+            for (unsigned lane = 0; lane < 4; ++lane)
+            {
+                if ((visible >> lane) & 1)
+                {
+                    _mm_storeu_ps(&rects[size].Left, lanes[lane]);
+                    _mm_storeu_ps(&colors[size].R, ((pressedLanes >> lane) & 1) ? pressed : hover);
+                    ++size;
+                }
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            Rect const rect{ xs[i] - halfSize, ys[i] - halfSize, xs[i] + halfSize, ys[i] + halfSize };
+            if ((bounds != nullptr) && !Intersects(rect, *bounds))
+            {
+                continue;
+            }
+
+            rects[size] = rect;
+            colors[size] = pointers.IsPressed(i) ? style.PressedColor : style.HoverColor;
+            ++size;
+        }
+
+        m_size = size;
+    }
+
+    char const* IndicatorBatch::BuildPathName() noexcept
+    {
+#if defined(POINTERCORE_INDICATORBATCH_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+}
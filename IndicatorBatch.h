@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "PointerTable.h"
+#include "RenderBackend.h"
+
+namespace PointerCore
+{
+    // How a pointer indicator looks: a square centered on the pointer
+    struct IndicatorStyle
+    {
+        float HalfSize;
+        Color HoverColor;
+        Color PressedColor;
+    };
+
+    // Per-frame instance buffer with one rectangle and color per pointer
+    // indicator, so a whole table can be drawn with a single
+    // RenderBackend::FillRectangles() call.
+    //
+    // Instances keep table order (later ones draw on top). The rect and color
+    // columns match the Direct2D/Direct3D rect and float4 color layouts, so
+    // backends can hand them to the GPU without repacking. Building is SSE2 on
+    // x86/x64 and a scalar loop everywhere else.
+    class IndicatorBatch
+    {
+    public:
+        // Replaces the contents with an instance for every pointer in the table
+        void Build(PointerTable const& pointers, IndicatorStyle const& style);
+
+        // Same, but skips indicators that don't reach into bounds
+        void Build(PointerTable const& pointers, IndicatorStyle const& style, Rect const& bounds);
+
+        void Clear() noexcept { m_size = 0; }
+
+        size_t Size() const noexcept { return m_size; }
+        bool Empty() const noexcept { return m_size == 0; }
+        Rect const* Rects() const noexcept { return m_rects.data(); }
+        Color const* Colors() const noexcept { return m_colors.data(); }
+
+        // Name of the compiled-in build path, for logging and benchmarks
+        static char const* BuildPathName() noexcept;
+
+    private:
+        void Build(PointerTable const& pointers, IndicatorStyle const& style, Rect const* bounds);
+
+        size_t m_size{ 0 };
+        std::vector<Rect> m_rects;
+        std::vector<Color> m_colors;
+    };
+}
@@ -0,0 +1,136 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace PointerCore
+{
+    // Index of the highest set bit; value must be non-zero
+    static inline unsigned HighestBit(uint64_t value) noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long bit;
+        _BitScanReverse64(&bit, value);
+        return static_cast<unsigned>(bit);
+#elif defined(_MSC_VER)
+        // 32-bit targets only scan 32 bits at a time
+        unsigned long bit;
+        if (_BitScanReverse(&bit, static_cast<unsigned long>(value >> 32)))
+        {
+            return static_cast<unsigned>(bit) + 32;
+        }
+
+        _BitScanReverse(&bit, static_cast<unsigned long>(value));
+        return static_cast<unsigned>(bit);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+
+    LatencyHistogram::LatencyHistogram()
+        : m_counts{ std::make_unique<std::atomic<uint64_t>[]>(BucketCount) }
+    {
+        Reset();
+    }
+
+    size_t LatencyHistogram::BucketIndex(uint64_t value) noexcept
+    {
+        if (value < SubBucketCount)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        // Split [2^k, 2^(k+1)) into HalfSubBucketCount buckets
+        unsigned const shift = HighestBit(value) - (SubBucketBits - 1);
+        auto const mantissa = static_cast<size_t>(value >> shift);
+        return SubBucketCount + (shift - 1) * HalfSubBucketCount + (mantissa - HalfSubBucketCount);
+    }
+
+    uint64_t LatencyHistogram::BucketLowerBound(size_t bucket) noexcept
+    {
+        if (bucket < SubBucketCount)
+        {
+            return bucket;
+        }
+
+        size_t const shift = (bucket - SubBucketCount) / HalfSubBucketCount + 1;
+        size_t const mantissa = (bucket - SubBucketCount) % HalfSubBucketCount + HalfSubBucketCount;
+        return static_cast<uint64_t>(mantissa) << shift;
+    }
+
+    uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) noexcept
+    {
+        return (bucket + 1 < BucketCount) ? BucketLowerBound(bucket + 1) - 1 : UINT64_MAX;
+    }
+
+    void LatencyHistogram::Record(uint64_t value) noexcept
+    {
+        m_counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = m_min.load(std::memory_order_relaxed);
+        while ((value < current) && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+
+        current = m_max.load(std::memory_order_relaxed);
+        while ((value > current) && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void LatencyHistogram::Reset() noexcept
+    {
+        for (size_t i = 0; i < BucketCount; ++i)
+        {
+            m_counts[i].store(0, std::memory_order_relaxed);
+        }
+
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_min.store(UINT64_MAX, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::Min() const noexcept
+    {
+        uint64_t const min = m_min.load(std::memory_order_relaxed);
+        return (min == UINT64_MAX) ? 0 : min;
+    }
+
+    double LatencyHistogram::Mean() const noexcept
+    {
+        uint64_t const count = Count();
+        return (count == 0) ? 0.0 : static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count);
+    }
+
+    uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const noexcept
+    {
+        uint64_t const count = Count();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        double const fraction = std::fmin(std::fmax(percentile, 0.0), 100.0) / 100.0;
+        auto const target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BucketCount; ++i)
+        {
+            seen += BucketValueCount(i);
+            if (seen >= target)
+            {
+                // Report the bucket's upper edge, but never beyond the largest value seen
+                return std::min(BucketUpperBound(i), Max());
+            }
+        }
+
+        return Max();
+    }
+}
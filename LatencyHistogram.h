@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace PointerCore
+{
+    // Lock-free, fixed-size histogram with HDR-style log-linear buckets.
+    //
+    // Values below 2^SubBucketBits get a bucket each; above that every power of
+    // two range is split into 2^(SubBucketBits - 1) equal buckets, which bounds
+    // the relative error of any reported value to under 2%. The full uint64_t
+    // range is covered, so no value is ever dropped.
+    //
+    // Record() may be called from any number of threads concurrently. Readers
+    // see a consistent-enough view for statistics, but not an atomic snapshot.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr unsigned SubBucketBits = 7;
+        static constexpr size_t SubBucketCount = size_t{ 1 } << SubBucketBits;
+        static constexpr size_t HalfSubBucketCount = SubBucketCount / 2;
+        static constexpr size_t BucketCount = SubBucketCount + (64 - SubBucketBits) * HalfSubBucketCount;
+
+        LatencyHistogram();
+
+        LatencyHistogram(LatencyHistogram const&) = delete;
+        LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+        void Record(uint64_t value) noexcept;
+
+        // Not synchronized with concurrent Record() calls
+        void Reset() noexcept;
+
+        uint64_t Count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+        uint64_t Min() const noexcept;
+        uint64_t Max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+        double Mean() const noexcept;
+
+        // Smallest recorded bucket value that at least percentile% of the
+        // values are less than or equal to (e.g. 99.9). Zero when empty.
+        uint64_t ValueAtPercentile(double percentile) const noexcept;
+
+        // Raw bucket access, for exporting
+        uint64_t BucketValueCount(size_t bucket) const noexcept { return m_counts[bucket].load(std::memory_order_relaxed); }
+        static uint64_t BucketLowerBound(size_t bucket) noexcept;
+        static uint64_t BucketUpperBound(size_t bucket) noexcept;
+        static size_t BucketIndex(uint64_t value) noexcept;
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> m_counts;
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<uint64_t> m_sum{ 0 };
+        std::atomic<uint64_t> m_min{ UINT64_MAX };
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+}
@@ -0,0 +1,122 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PointerCore
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(std::filesystem::path const& path)
+    {
+        Close();
+
+        HANDLE file = ::CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!::GetFileSizeEx(file, &fileSize) || static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX)
+        {
+            ::CloseHandle(file);
+            return false;
+        }
+
+        if (fileSize.QuadPart > 0)
+        {
+            // The view keeps the mapping alive, so both handles can be closed once it's created
+            HANDLE mapping = ::CreateFileMappingFromApp(file, nullptr, PAGE_READONLY, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                m_data = static_cast<uint8_t const*>(::MapViewOfFileFromApp(mapping, FILE_MAP_READ, 0, 0));
+                ::CloseHandle(mapping);
+            }
+
+            if (m_data == nullptr)
+            {
+                ::CloseHandle(file);
+                return false;
+            }
+        }
+
+        ::CloseHandle(file);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        m_isOpen = true;
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            ::UnmapViewOfFile(m_data);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_isOpen = false;
+    }
+#else
+    bool MappedFile::Open(std::filesystem::path const& path)
+    {
+        Close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileInfo{};
+        if (::fstat(fd, &fileInfo) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        if (fileInfo.st_size > 0)
+        {
+            void* view = ::mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            m_data = static_cast<uint8_t const*>(view);
+        }
+
+        ::close(fd);
+        m_size = static_cast<size_t>(fileInfo.st_size);
+        m_isOpen = true;
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_isOpen = false;
+    }
+#endif
+}
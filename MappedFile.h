@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace PointerCore
+{
+    // Read-only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        // Returns false if the file couldn't be opened or mapped. Empty files
+        // open successfully but have no data.
+        bool Open(std::filesystem::path const& path);
+        void Close() noexcept;
+
+        bool IsOpen() const noexcept { return m_isOpen; }
+        uint8_t const* Data() const noexcept { return m_data; }
+        size_t Size() const noexcept { return m_size; }
+
+    private:
+        uint8_t const* m_data{ nullptr };
+        size_t m_size{ 0 };
+        bool m_isOpen{ false };
+    };
+}
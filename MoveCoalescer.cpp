@@ -0,0 +1,215 @@
+#include "MoveCoalescer.h"
+
+#include <algorithm>
+
+namespace PointerCore
+{
+    static inline uint32_t BucketBits(size_t capacity) noexcept
+    {
+        uint32_t bits = 1;
+        while ((size_t{ 1 } << bits) < 2 * capacity)
+        {
+            ++bits;
+        }
+
+        return bits;
+    }
+
+    MoveCoalescer::MoveCoalescer(size_t capacity, size_t historyLength)
+        : m_historyLength{ std::max<size_t>(1, historyLength) }
+        , m_buckets(size_t{ 1 } << BucketBits(capacity))
+        , m_bucketMask{ (size_t{ 1 } << BucketBits(capacity)) - 1 }
+        , m_bucketShift{ 32 - BucketBits(capacity) }
+        , m_ids(capacity)
+        , m_historyHead(capacity)
+        , m_historyCount(capacity)
+        , m_pendingCount(capacity)
+        , m_lastFrameCount(capacity)
+        , m_history(capacity * m_historyLength)
+    {
+    }
+
+    size_t MoveCoalescer::FindSlot(uint32_t id) const noexcept
+    {
+        for (size_t bucket = HomeBucket(id);; bucket = (bucket + 1) & m_bucketMask)
+        {
+            uint32_t const entry = m_buckets[bucket];
+            if (entry == 0)
+            {
+                return PointerTable::npos;
+            }
+
+            if (m_ids[entry - 1] == id)
+            {
+                return entry - 1;
+            }
+        }
+    }
+
+    size_t MoveCoalescer::BucketOf(size_t slot) const noexcept
+    {
+        size_t bucket = HomeBucket(m_ids[slot]);
+        while (m_buckets[bucket] != slot + 1)
+        {
+            bucket = (bucket + 1) & m_bucketMask;
+        }
+
+        return bucket;
+    }
+
+    bool MoveCoalescer::AddMove(uint32_t id, PointerSample const& sample) noexcept
+    {
+        // One probe finds the pointer, or the empty bucket to insert it at
+        size_t bucket = HomeBucket(id);
+        while ((m_buckets[bucket] != 0) && (m_ids[m_buckets[bucket] - 1] != id))
+        {
+            bucket = (bucket + 1) & m_bucketMask;
+        }
+
+        size_t slot = m_buckets[bucket];
+        if (slot != 0)
+        {
+            --slot;
+        }
+        else
+        {
+            if (m_size == m_ids.size())
+            {
+                return false;
+            }
+
+            slot = m_size++;
+            m_buckets[bucket] = static_cast<uint32_t>(slot + 1);
+            m_ids[slot] = id;
+            m_historyHead[slot] = 0;
+            m_historyCount[slot] = 0;
+            m_pendingCount[slot] = 0;
+            m_lastFrameCount[slot] = 0;
+        }
+
+        // Append to the history ring, overwriting the oldest sample once full
+        auto const length = static_cast<uint32_t>(m_historyLength);
+        uint32_t& head = m_historyHead[slot];
+        uint32_t& count = m_historyCount[slot];
+        if (count < length)
+        {
+            SlotHistory(slot)[(head + count) % length] = sample;
+            ++count;
+        }
+        else
+        {
+            SlotHistory(slot)[head] = sample;
+            head = (head + 1) % length;
+        }
+
+        ++m_pendingCount[slot];
+        ++m_totalMoves;
+        return true;
+    }
+
+    void MoveCoalescer::DiscardPending(uint32_t id) noexcept
+    {
+        size_t const slot = FindSlot(id);
+        if (slot != PointerTable::npos)
+        {
+            m_pendingCount[slot] = 0;
+        }
+    }
+
+    void MoveCoalescer::Remove(uint32_t id) noexcept
+    {
+        size_t const slot = FindSlot(id);
+        if (slot == PointerTable::npos)
+        {
+            return;
+        }
+
+        // Take the pointer out of the index, shifting back later entries of the
+        // probe run that would otherwise become unreachable
+        size_t hole = BucketOf(slot);
+        for (size_t next = (hole + 1) & m_bucketMask; m_buckets[next] != 0; next = (next + 1) & m_bucketMask)
+        {
+            size_t const home = HomeBucket(m_ids[m_buckets[next] - 1]);
+            if (((next - home) & m_bucketMask) >= ((next - hole) & m_bucketMask))
+            {
+                m_buckets[hole] = m_buckets[next];
+                hole = next;
+            }
+        }
+        m_buckets[hole] = 0;
+
+        // Keep the slots dense by moving the last one into the hole
+        size_t const last = --m_size;
+        if (slot != last)
+        {
+            m_buckets[BucketOf(last)] = static_cast<uint32_t>(slot + 1);
+            m_ids[slot] = m_ids[last];
+            m_historyHead[slot] = m_historyHead[last];
+            m_historyCount[slot] = m_historyCount[last];
+            m_pendingCount[slot] = m_pendingCount[last];
+            m_lastFrameCount[slot] = m_lastFrameCount[last];
+            std::copy_n(SlotHistory(last), m_historyLength, SlotHistory(slot));
+        }
+    }
+
+    void MoveCoalescer::Clear() noexcept
+    {
+        m_size = 0;
+        std::fill(m_buckets.begin(), m_buckets.end(), 0u);
+    }
+
+    size_t MoveCoalescer::Flush(PointerTable& table) noexcept
+    {
+        auto const length = static_cast<uint32_t>(m_historyLength);
+
+        size_t updated = 0;
+        for (size_t slot = 0; slot < m_size; ++slot)
+        {
+            m_lastFrameCount[slot] = m_pendingCount[slot];
+            if (m_pendingCount[slot] == 0)
+            {
+                continue;
+            }
+
+            m_pendingCount[slot] = 0;
+
+            size_t const index = table.Find(m_ids[slot]);
+            if (index != PointerTable::npos)
+            {
+                auto const& latest = SlotHistory(slot)[(m_historyHead[slot] + m_historyCount[slot] - 1) % length];
+                table.SetPosition(index, { latest.X, latest.Y });
+                table.SetPressure(index, latest.Pressure);
+                table.SetTimestamp(index, latest.Timestamp);
+                ++updated;
+            }
+        }
+
+        m_totalUpdates += updated;
+        return updated;
+    }
+
+    size_t MoveCoalescer::LastFrameSampleCount(uint32_t id) const noexcept
+    {
+        size_t const slot = FindSlot(id);
+        return (slot == PointerTable::npos) ? 0 : m_lastFrameCount[slot];
+    }
+
+    size_t MoveCoalescer::CopyHistory(uint32_t id, PointerSample* out, size_t maxCount) const noexcept
+    {
+        size_t const slot = FindSlot(id);
+        if (slot == PointerTable::npos)
+        {
+            return 0;
+        }
+
+        size_t const count = std::min<size_t>(maxCount, m_historyCount[slot]);
+        size_t const skip = m_historyCount[slot] - count;
+        PointerSample const* history = SlotHistory(slot);
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = history[(m_historyHead[slot] + skip + i) % m_historyLength];
+        }
+
+        return count;
+    }
+}
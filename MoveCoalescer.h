@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Folds the move events received for each pointer between two frames into a
+    // single state update.
+    //
+    // AddMove() is cheap and never touches the pointer table; Flush() (once per
+    // frame, before rendering) writes only the latest position of each pointer
+    // that moved. Every sample is also kept in a bounded per-pointer history
+    // ring so consumers that care about the intermediate points (inking,
+    // prediction, ...) still see them.
+    class MoveCoalescer
+    {
+    public:
+        static constexpr size_t DefaultHistoryLength = 64;
+
+        explicit MoveCoalescer(size_t capacity = PointerTable::DefaultCapacity, size_t historyLength = DefaultHistoryLength);
+
+        // Returns false if the pointer isn't tracked yet and all slots are in use
+        bool AddMove(uint32_t id, PointerSample const& sample) noexcept;
+
+        // Drops the pointer's pending move, if any, so the next Flush() leaves
+        // its position alone. For events that supersede the moves before them
+        // (press, release); the samples stay in the history.
+        void DiscardPending(uint32_t id) noexcept;
+
+        // Forgets the pointer, including any pending move and its history
+        void Remove(uint32_t id) noexcept;
+        void Clear() noexcept;
+
+        // Applies the latest pending position of every pointer that moved since
+        // the previous flush to the table. Returns the number of pointers updated.
+        size_t Flush(PointerTable& table) noexcept;
+
+        // Number of samples that were folded into the pointer's last flushed update
+        size_t LastFrameSampleCount(uint32_t id) const noexcept;
+
+        // Copies up to maxCount of the pointer's most recent samples, oldest
+        // first. Returns the number of samples written.
+        size_t CopyHistory(uint32_t id, PointerSample* out, size_t maxCount) const noexcept;
+
+        size_t HistoryLength() const noexcept { return m_historyLength; }
+        size_t TrackedCount() const noexcept { return m_size; }
+
+        // Lifetime counters
+        uint64_t TotalMoves() const noexcept { return m_totalMoves; }
+        uint64_t TotalUpdates() const noexcept { return m_totalUpdates; }
+
+    private:
+        size_t FindSlot(uint32_t id) const noexcept;
+        size_t HomeBucket(uint32_t id) const noexcept { return static_cast<uint32_t>(id * 2654435769u) >> m_bucketShift; }
+        size_t BucketOf(size_t slot) const noexcept;
+        PointerSample const* SlotHistory(size_t slot) const noexcept { return m_history.data() + slot * m_historyLength; }
+        PointerSample* SlotHistory(size_t slot) noexcept { return m_history.data() + slot * m_historyLength; }
+
+        size_t m_historyLength;
+        size_t m_size{ 0 };
+
+        // ID index: slot + 1 per bucket, zero when empty, linear probing with
+        // at least twice as many buckets as slots, like PointerTable's index
+        std::vector<uint32_t> m_buckets;
+        size_t m_bucketMask;
+        uint32_t m_bucketShift;
+
+        // Per-slot state, dense over [0, m_size)
+        std::vector<uint32_t> m_ids;
+        std::vector<uint32_t> m_historyHead;        // Index of the oldest sample
+        std::vector<uint32_t> m_historyCount;
+        std::vector<uint32_t> m_pendingCount;       // Samples received since the last flush
+        std::vector<uint32_t> m_lastFrameCount;     // Samples folded into the last flush
+
+        // Slot-major ring storage, m_historyLength samples per slot
+        std::vector<PointerSample> m_history;
+
+        uint64_t m_totalMoves{ 0 };
+        uint64_t m_totalUpdates{ 0 };
+    };
+}
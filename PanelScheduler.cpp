@@ -0,0 +1,147 @@
+#include "PanelScheduler.h"
+
+namespace PointerCore
+{
+    bool PanelScheduler::FallsDueBefore(Panel const& a, Panel const& b) noexcept
+    {
+        return (a.RequestTime < b.RequestTime) || ((a.RequestTime == b.RequestTime) && (a.RequestOrder < b.RequestOrder));
+    }
+
+    PanelScheduler::PanelId PanelScheduler::Register(int32_t priority)
+    {
+        PanelId id;
+        if (!m_freeIds.empty())
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<PanelId>(m_panels.size());
+            m_panels.emplace_back();
+        }
+
+        m_panels[id] = { priority, true, false, false, false, TimePoint{}, 0, 0 };
+        ++m_panelCount;
+        return id;
+    }
+
+    bool PanelScheduler::Unregister(PanelId panel) noexcept
+    {
+        if (!IsRegistered(panel))
+        {
+            return false;
+        }
+
+        m_panels[panel].Registered = false;
+        m_freeIds.push_back(panel);
+        --m_panelCount;
+        return true;
+    }
+
+    void PanelScheduler::SetPriority(PanelId panel, int32_t priority) noexcept
+    {
+        if (IsRegistered(panel))
+        {
+            m_panels[panel].Priority = priority;
+        }
+    }
+
+    void PanelScheduler::RequestFrame(PanelId panel, TimePoint at) noexcept
+    {
+        if (!IsRegistered(panel))
+        {
+            return;
+        }
+
+        auto& entry = m_panels[panel];
+        if (!entry.Requested)
+        {
+            entry.Requested = true;
+            entry.Aging = false;
+            entry.RequestTime = at;
+            entry.RequestOrder = m_requestCount++;
+        }
+        else if (at < entry.RequestTime)
+        {
+            entry.RequestTime = at;
+        }
+    }
+
+    PanelScheduler::Decision PanelScheduler::Next(TimePoint now) noexcept
+    {
+        PanelId best = NoPanel;
+        int64_t bestPriority = 0;
+        bool waiting = false;
+        TimePoint wakeTime{};
+
+        for (PanelId id = 0; id < m_panels.size(); ++id)
+        {
+            auto& entry = m_panels[id];
+            if (!entry.Registered || !entry.Requested || entry.Rendering)
+            {
+                continue;
+            }
+
+            if (entry.RequestTime > now)
+            {
+                if (!waiting || (entry.RequestTime < wakeTime))
+                {
+                    wakeTime = entry.RequestTime;
+                }
+                waiting = true;
+                continue;
+            }
+
+            if (!entry.Aging)
+            {
+                entry.Aging = true;
+                entry.RequestFrameStamp = m_framesStarted;
+            }
+
+            int64_t priority = entry.Priority;
+            if (m_options.AgingFrames > 0)
+            {
+                priority += static_cast<int64_t>((m_framesStarted - entry.RequestFrameStamp) / m_options.AgingFrames);
+            }
+
+            if ((best == NoPanel) || (priority > bestPriority) || ((priority == bestPriority) && FallsDueBefore(entry, m_panels[best])))
+            {
+                best = id;
+                bestPriority = priority;
+            }
+        }
+
+        if (best != NoPanel)
+        {
+            return { FrameAction::Render, best, now };
+        }
+
+        if (waiting)
+        {
+            return { FrameAction::WaitUntil, NoPanel, wakeTime };
+        }
+
+        return { FrameAction::Idle, NoPanel, now };
+    }
+
+    void PanelScheduler::OnFrameStarted(PanelId panel) noexcept
+    {
+        if (!IsRegistered(panel))
+        {
+            return;
+        }
+
+        m_panels[panel].Requested = false;
+        m_panels[panel].Rendering = true;
+        ++m_framesStarted;
+    }
+
+    void PanelScheduler::OnFrameFinished(PanelId panel) noexcept
+    {
+        if (IsRegistered(panel))
+        {
+            m_panels[panel].Rendering = false;
+        }
+    }
+}
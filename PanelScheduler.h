@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderScheduler.h"
+
+namespace PointerCore
+{
+    // Orders the frames of many panels that share a render thread (or a
+    // small pool of them).
+    //
+    // Each panel still decides when it wants a frame with its own
+    // RenderScheduler; this only picks which of the panels that are due gets
+    // rendered next. The highest priority wins, ties go to whoever fell due
+    // first, and a panel that keeps getting passed over slowly gains priority
+    // so nothing starves. A panel is never handed to two workers at once.
+    //
+    // Like RenderScheduler it never reads a clock and isn't thread-safe; the
+    // render service calls it under its own lock.
+    class PanelScheduler
+    {
+    public:
+        using PanelId = uint32_t;
+        using Duration = RenderScheduler::Duration;
+        using TimePoint = RenderScheduler::TimePoint;
+        using FrameAction = RenderScheduler::FrameAction;
+
+        static constexpr PanelId NoPanel = UINT32_MAX;
+
+        struct Options
+        {
+            // A waiting panel gains one priority level for every this many
+            // frames started ahead of it (0 for strict priorities)
+            uint32_t AgingFrames = 8;
+        };
+
+        struct Decision
+        {
+            FrameAction Action;
+
+            // The panel to render, for FrameAction::Render
+            PanelId Panel;
+
+            // When the next request falls due, for FrameAction::WaitUntil
+            TimePoint WakeTime;
+        };
+
+        PanelScheduler() = default;
+        explicit PanelScheduler(Options const& options) : m_options{ options } {}
+
+        Options const& GetOptions() const noexcept { return m_options; }
+        void SetOptions(Options const& options) noexcept { m_options = options; }
+
+        // IDs of unregistered panels get reused
+        PanelId Register(int32_t priority);
+        bool Unregister(PanelId panel) noexcept;
+        void SetPriority(PanelId panel, int32_t priority) noexcept;
+
+        // The panel wants a frame at or after the given time. Of several
+        // requests before the next frame starts, the earliest wins.
+        void RequestFrame(PanelId panel, TimePoint at = TimePoint{}) noexcept;
+
+        // Requests start aging the first time Next() sees them due, so a
+        // frame asked for ahead of time doesn't jump the queue when it falls due
+        Decision Next(TimePoint now) noexcept;
+
+        // The panel's frame is being rendered. Requests made from now on are
+        // for its next frame, and Next() skips it until OnFrameFinished().
+        void OnFrameStarted(PanelId panel) noexcept;
+        void OnFrameFinished(PanelId panel) noexcept;
+
+        bool IsRegistered(PanelId panel) const noexcept { return (panel < m_panels.size()) && m_panels[panel].Registered; }
+        bool IsRendering(PanelId panel) const noexcept { return IsRegistered(panel) && m_panels[panel].Rendering; }
+        size_t PanelCount() const noexcept { return m_panelCount; }
+        uint64_t FramesStarted() const noexcept { return m_framesStarted; }
+
+    private:
+        struct Panel
+        {
+            int32_t Priority;
+            bool Registered;
+            bool Requested;
+            bool Rendering;
+            bool Aging;
+            TimePoint RequestTime;
+
+            // Frame counter when the pending request fell due, for aging, and
+            // request counter when it was made, for first-come ordering
+            uint64_t RequestFrameStamp;
+            uint64_t RequestOrder;
+        };
+
+        static bool FallsDueBefore(Panel const& a, Panel const& b) noexcept;
+
+        Options m_options{};
+        std::vector<Panel> m_panels;
+        std::vector<PanelId> m_freeIds;
+        size_t m_panelCount{ 0 };
+        uint64_t m_framesStarted{ 0 };
+        uint64_t m_requestCount{ 0 };
+    };
+}
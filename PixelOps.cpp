@@ -0,0 +1,140 @@
+#include "PixelOps.h"
+
+#if defined(__AVX2__)
+#define POINTERCORE_PIXELOPS_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define POINTERCORE_PIXELOPS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Blending only has an SSE2 path, used whenever either fill path is
+#if defined(POINTERCORE_PIXELOPS_AVX2) || defined(POINTERCORE_PIXELOPS_SSE2)
+#define POINTERCORE_PIXELOPS_BLEND_SSE2 1
+#endif
+
+namespace PointerCore::PixelOps
+{
+    void FillSpan(uint32_t* dst, size_t count, uint32_t value) noexcept
+    {
+        size_t i = 0;
+
+#if defined(POINTERCORE_PIXELOPS_AVX2)
+        __m256i const wide = _mm256_set1_epi32(static_cast<int>(value));
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), wide);
+        }
+#elif defined(POINTERCORE_PIXELOPS_SSE2)
+        __m128i const wide = _mm_set1_epi32(static_cast<int>(value));
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), wide);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            dst[i] = value;
+        }
+    }
+
+    // dst = src + dst * (1 - srcAlpha), two channels at a time. Channel order
+    // doesn't matter as long as alpha is the top byte, which holds for both
+    // BGRA and RGBA in little-endian memory.
+    static inline uint32_t BlendPixel(uint32_t d, uint32_t value, uint32_t inverseAlpha) noexcept
+    {
+        uint32_t rb = (d & 0x00ff00ffu) * inverseAlpha + 0x00800080u;
+        uint32_t ag = ((d >> 8) & 0x00ff00ffu) * inverseAlpha + 0x00800080u;
+        rb = ((rb + ((rb >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+        ag = (ag + ((ag >> 8) & 0x00ff00ffu)) & 0xff00ff00u;
+        return value + (rb | ag);
+    }
+
+    void BlendSpan(uint32_t* dst, size_t count, uint32_t value) noexcept
+    {
+        uint32_t const inverseAlpha = 255 - (value >> 24);
+        if (inverseAlpha == 0)
+        {
+            FillSpan(dst, count, value);
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] = BlendPixel(dst[i], value, inverseAlpha);
+        }
+    }
+
+    void BlendPixels(uint32_t* dst, uint32_t const* src, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if defined(POINTERCORE_PIXELOPS_BLEND_SSE2)
+        // Four pixels at a time as 16-bit channels, with the same rounding as
+        // BlendPixel(). Sprites are mostly empty or solid, so those skip the math.
+        __m128i const zero = _mm_setzero_si128();
+        __m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+        __m128i const half = _mm_set1_epi16(0x80);
+        __m128i const full = _mm_set1_epi16(0xff);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xffff)
+            {
+                continue;
+            }
+
+            int const opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask));
+            if (opaque == 0xffff)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+                continue;
+            }
+
+            __m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+            __m128i result[2];
+            for (int half16 = 0; half16 < 2; ++half16)
+            {
+                __m128i const s16 = half16 ? _mm_unpackhi_epi8(s, zero) : _mm_unpacklo_epi8(s, zero);
+                __m128i const d16 = half16 ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+
+                // Broadcast each pixel's alpha (lane 3) to its four lanes
+                __m128i alpha = _mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3));
+                alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+
+                __m128i x = _mm_add_epi16(_mm_mullo_epi16(d16, _mm_sub_epi16(full, alpha)), half);
+                x = _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+                result[half16] = _mm_add_epi16(x, s16);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(result[0], result[1]));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            uint32_t const value = src[i];
+            uint32_t const inverseAlpha = 255 - (value >> 24);
+            if (inverseAlpha == 0)
+            {
+                dst[i] = value;
+            }
+            else if (value != 0)
+            {
+                dst[i] = BlendPixel(dst[i], value, inverseAlpha);
+            }
+        }
+    }
+
+    char const* FillPathName() noexcept
+    {
+#if defined(POINTERCORE_PIXELOPS_AVX2)
+        return "avx2";
+#elif defined(POINTERCORE_PIXELOPS_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Span primitives for 32bpp premultiplied pixels, used by the CPU rasterizer.
+//
+// Vector paths are selected at compile time: AVX2 when the compiler targets it
+// (/arch:AVX2, -mavx2), SSE2 on x86/x64, and a scalar loop everywhere else.
+namespace PointerCore::PixelOps
+{
+    // Writes value to count consecutive pixels
+    void FillSpan(uint32_t* dst, size_t count, uint32_t value) noexcept;
+
+    // Source-over blends a premultiplied value onto count consecutive pixels
+    void BlendSpan(uint32_t* dst, size_t count, uint32_t value) noexcept;
+
+    // Source-over blends count premultiplied pixels onto as many, pixel by
+    // pixel. Same results as BlendSpan() with each source pixel.
+    void BlendPixels(uint32_t* dst, uint32_t const* src, size_t count) noexcept;
+
+    // Name of the compiled-in fill path, for logging and benchmarks
+    char const* FillPathName() noexcept;
+}
@@ -0,0 +1,297 @@
+#include "PointerHeatmap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define POINTERCORE_HEATMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace PointerCore
+{
+    namespace
+    {
+        // dst[i] += weight * kernel[i]
+        void AddScaled(float* dst, float const* kernel, size_t count, float weight) noexcept
+        {
+            size_t i = 0;
+
+#if defined(POINTERCORE_HEATMAP_SSE2)
+            __m128 const wide = _mm_set1_ps(weight);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 const sum = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(kernel + i), wide));
+                _mm_storeu_ps(dst + i, sum);
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                dst[i] += weight * kernel[i];
+            }
+        }
+
+        // Scales count values (a multiple of 16) and returns the largest result
+        float ScaleAndMax(float* values, size_t count, float factor) noexcept
+        {
+#if defined(POINTERCORE_HEATMAP_SSE2)
+            __m128 const wide = _mm_set1_ps(factor);
+            __m128 max0 = _mm_setzero_ps();
+            __m128 max1 = _mm_setzero_ps();
+            __m128 max2 = _mm_setzero_ps();
+            __m128 max3 = _mm_setzero_ps();
+            for (size_t i = 0; i < count; i += 16)
+            {
+                __m128 const v0 = _mm_mul_ps(_mm_loadu_ps(values + i), wide);
+                __m128 const v1 = _mm_mul_ps(_mm_loadu_ps(values + i + 4), wide);
+                __m128 const v2 = _mm_mul_ps(_mm_loadu_ps(values + i + 8), wide);
+                __m128 const v3 = _mm_mul_ps(_mm_loadu_ps(values + i + 12), wide);
+                _mm_storeu_ps(values + i, v0);
+                _mm_storeu_ps(values + i + 4, v1);
+                _mm_storeu_ps(values + i + 8, v2);
+                _mm_storeu_ps(values + i + 12, v3);
+                max0 = _mm_max_ps(max0, v0);
+                max1 = _mm_max_ps(max1, v1);
+                max2 = _mm_max_ps(max2, v2);
+                max3 = _mm_max_ps(max3, v3);
+            }
+
+            __m128 max = _mm_max_ps(_mm_max_ps(max0, max1), _mm_max_ps(max2, max3));
+            max = _mm_max_ps(max, _mm_shuffle_ps(max, max, _MM_SHUFFLE(1, 0, 3, 2)));
+            max = _mm_max_ps(max, _mm_shuffle_ps(max, max, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtss_f32(max);
+#else
+            float max = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] *= factor;
+                max = std::max(max, values[i]);
+            }
+
+            return max;
+#endif
+        }
+    }
+
+    void HeatmapSnapshot::WritePgm(std::ostream& out) const
+    {
+        out << "P5\n" << Width << ' ' << Height << "\n255\n";
+
+        float const scale = (MaxValue > 0.0f) ? 255.0f / MaxValue : 0.0f;
+        std::vector<char> row(Width);
+        for (uint32_t y = 0; y < Height; ++y)
+        {
+            float const* values = Values.data() + size_t{ y } * Width;
+            for (uint32_t x = 0; x < Width; ++x)
+            {
+                row[x] = static_cast<char>(static_cast<uint8_t>(std::min(values[x] * scale + 0.5f, 255.0f)));
+            }
+
+            out.write(row.data(), static_cast<std::streamsize>(row.size()));
+        }
+    }
+
+    PointerHeatmap::PointerHeatmap()
+        : PointerHeatmap(Options())
+    {
+    }
+
+    PointerHeatmap::PointerHeatmap(Options const& options)
+        : m_options(options)
+    {
+        // Peak-normalized Gaussian, one row of m_kernelStride per kernel row
+        m_kernelRadius = std::max(0, static_cast<int32_t>(std::ceil(options.KernelRadius)));
+        m_kernelStride = static_cast<uint32_t>(2 * m_kernelRadius + 1);
+        m_kernel.resize(size_t{ m_kernelStride } * m_kernelStride);
+
+        float const sigma = std::max(options.KernelRadius * 0.5f, 0.5f);
+        float const falloff = -0.5f / (sigma * sigma);
+        for (int32_t dy = -m_kernelRadius; dy <= m_kernelRadius; ++dy)
+        {
+            for (int32_t dx = -m_kernelRadius; dx <= m_kernelRadius; ++dx)
+            {
+                size_t const index = size_t(dy + m_kernelRadius) * m_kernelStride + size_t(dx + m_kernelRadius);
+                m_kernel[index] = std::exp(falloff * static_cast<float>(dx * dx + dy * dy));
+            }
+        }
+    }
+
+    void PointerHeatmap::Resize(float width, float height)
+    {
+        uint32_t const cellsX = static_cast<uint32_t>(std::ceil(std::max(width, 0.0f) / m_options.CellSize));
+        uint32_t const cellsY = static_cast<uint32_t>(std::ceil(std::max(height, 0.0f) / m_options.CellSize));
+        if ((cellsX == m_width) && (cellsY == m_height))
+        {
+            return;
+        }
+
+        m_width = cellsX;
+        m_height = cellsY;
+        m_tilesX = (cellsX + TileSize - 1) / TileSize;
+        m_tilesY = (cellsY + TileSize - 1) / TileSize;
+
+        size_t const tileCount = size_t{ m_tilesX } * m_tilesY;
+        m_cells.assign(tileCount * TileCells, 0.0f);
+        m_tileActive.assign(tileCount, 0);
+        m_tileDecayTimes.assign(tileCount, 0.0);
+        m_decayTime = 0.0;
+        m_decayCursor = 0;
+
+        // Activate() must not allocate
+        m_activeTiles.clear();
+        m_activeTiles.reserve(tileCount);
+    }
+
+    void PointerHeatmap::AddSample(HeatmapSample const& sample) noexcept
+    {
+        float const cellX = std::floor(sample.X / m_options.CellSize);
+        float const cellY = std::floor(sample.Y / m_options.CellSize);
+        if (!(cellX >= 0.0f) || !(cellY >= 0.0f) || (cellX >= static_cast<float>(m_width)) || (cellY >= static_cast<float>(m_height)))
+        {
+            return;
+        }
+
+        int32_t const cx = static_cast<int32_t>(cellX);
+        int32_t const cy = static_cast<int32_t>(cellY);
+        float const weight = sample.Pressed ? m_options.PressedWeight : m_options.HoverWeight;
+
+        // Clip the kernel to the grid
+        int32_t const left = std::max(cx - m_kernelRadius, 0);
+        int32_t const right = std::min(cx + m_kernelRadius, static_cast<int32_t>(m_width) - 1);
+        int32_t const top = std::max(cy - m_kernelRadius, 0);
+        int32_t const bottom = std::min(cy + m_kernelRadius, static_cast<int32_t>(m_height) - 1);
+
+        for (int32_t y = top; y <= bottom; ++y)
+        {
+            float const* kernelRow = m_kernel.data() + size_t(y - cy + m_kernelRadius) * m_kernelStride;
+            uint32_t const tileY = static_cast<uint32_t>(y) / TileSize;
+            uint32_t const rowInTile = static_cast<uint32_t>(y) % TileSize;
+
+            // Split the row where it crosses into the next tile
+            for (int32_t x = left; x <= right;)
+            {
+                uint32_t const tileX = static_cast<uint32_t>(x) / TileSize;
+                uint32_t const column = static_cast<uint32_t>(x) % TileSize;
+                int32_t const end = std::min(right + 1, static_cast<int32_t>((tileX + 1) * TileSize));
+
+                uint32_t const tile = tileY * m_tilesX + tileX;
+                // Catch the tile up before adding to it
+                if (m_tileActive[tile] && (m_tileDecayTimes[tile] != m_decayTime))
+                {
+                    ScaleAndMax(Tile(tile), TileCells, PendingDecay(tile));
+                    m_tileDecayTimes[tile] = m_decayTime;
+                }
+                Activate(tile);
+                AddScaled(Tile(tile) + rowInTile * TileSize + column, kernelRow + (x - cx + m_kernelRadius), size_t(end - x), weight);
+                x = end;
+            }
+        }
+    }
+
+    void PointerHeatmap::Decay(float seconds) noexcept
+    {
+        if (!(seconds > 0.0f) || (m_options.HalfLife <= 0.0f))
+        {
+            return;
+        }
+
+        m_decayTime += seconds;
+
+        size_t budget = std::min<size_t>(m_options.TilesPerFrame, m_activeTiles.size());
+        while (budget-- > 0)
+        {
+            if (m_decayCursor >= m_activeTiles.size())
+            {
+                m_decayCursor = 0;
+            }
+
+            uint32_t const tile = m_activeTiles[m_decayCursor];
+            float* values = Tile(tile);
+            float const factor = PendingDecay(tile);
+            m_tileDecayTimes[tile] = m_decayTime;
+            if (ScaleAndMax(values, TileCells, factor) >= m_options.Floor)
+            {
+                ++m_decayCursor;
+                continue;
+            }
+
+            // Everything in the tile has faded, stop visiting it. The last
+            // active tile takes its place and is visited next.
+            std::memset(values, 0, TileCells * sizeof(float));
+            m_tileActive[tile] = 0;
+            m_activeTiles[m_decayCursor] = m_activeTiles.back();
+            m_activeTiles.pop_back();
+        }
+    }
+
+    void PointerHeatmap::Clear() noexcept
+    {
+        for (uint32_t const tile : m_activeTiles)
+        {
+            std::memset(Tile(tile), 0, TileCells * sizeof(float));
+            m_tileActive[tile] = 0;
+        }
+
+        m_activeTiles.clear();
+        m_decayCursor = 0;
+    }
+
+    void PointerHeatmap::Snapshot(HeatmapSnapshot& out) const
+    {
+        out.Width = m_width;
+        out.Height = m_height;
+        out.CellSize = m_options.CellSize;
+        out.MaxValue = 0.0f;
+        out.Values.assign(size_t{ m_width } * m_height, 0.0f);
+
+        // Inactive tiles are all zero
+        for (uint32_t const tile : m_activeTiles)
+        {
+            uint32_t const x0 = (tile % m_tilesX) * TileSize;
+            uint32_t const y0 = (tile / m_tilesX) * TileSize;
+            uint32_t const columns = std::min(TileSize, m_width - x0);
+            uint32_t const rows = std::min(TileSize, m_height - y0);
+            float const* values = Tile(tile);
+            float const factor = PendingDecay(tile);
+            for (uint32_t row = 0; row < rows; ++row)
+            {
+                float const* src = values + row * TileSize;
+                float* dst = out.Values.data() + size_t{ y0 + row } * m_width + x0;
+                for (uint32_t column = 0; column < columns; ++column)
+                {
+                    dst[column] = src[column] * factor;
+                    out.MaxValue = std::max(out.MaxValue, dst[column]);
+                }
+            }
+        }
+    }
+
+    float PointerHeatmap::Value(uint32_t x, uint32_t y) const noexcept
+    {
+        if ((x >= m_width) || (y >= m_height))
+        {
+            return 0.0f;
+        }
+
+        uint32_t const tile = (y / TileSize) * m_tilesX + (x / TileSize);
+        return Tile(tile)[(y % TileSize) * TileSize + (x % TileSize)] * PendingDecay(tile);
+    }
+
+    float PointerHeatmap::PendingDecay(uint32_t tile) const noexcept
+    {
+        double const behind = m_decayTime - m_tileDecayTimes[tile];
+        return (behind > 0.0) ? static_cast<float>(std::exp2(-behind / m_options.HalfLife)) : 1.0f;
+    }
+
+    void PointerHeatmap::Activate(uint32_t tile) noexcept
+    {
+        if (m_tileActive[tile] == 0)
+        {
+            m_tileActive[tile] = 1;
+            m_tileDecayTimes[tile] = m_decayTime;
+            m_activeTiles.push_back(tile);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace PointerCore
+{
+    struct HeatmapSample
+    {
+        float X;
+        float Y;
+        bool Pressed;
+    };
+
+    // Dense row-major copy of a heatmap, for export
+    struct HeatmapSnapshot
+    {
+        uint32_t Width{ 0 };
+        uint32_t Height{ 0 };
+
+        // DIPs per cell
+        float CellSize{ 0.0f };
+        float MaxValue{ 0.0f };
+        std::vector<float> Values;
+
+        // Binary 8-bit PGM, scaled so MaxValue is white
+        void WritePgm(std::ostream& out) const;
+    };
+
+    // Pointer density over a panel, fading exponentially over time.
+    //
+    // The grid is stored in square tiles of TileSize cells, each contiguous in
+    // memory. A sample adds a Gaussian kernel around its cell and marks the
+    // tiles it touched active. Decay() only visits active tiles, scaling them
+    // with SSE2 on x86/x64 (a scalar loop everywhere else), and retires a tile
+    // (zeroing it) once everything in it has faded below Options::Floor.
+    //
+    // Each tile remembers how much of the decay it has had. A frame visits at
+    // most Options::TilesPerFrame of the active tiles, round robin, and each
+    // visit catches the tile up in one multiply, so the exact decay is kept
+    // while the cost of a frame stays bounded however much of the panel
+    // pointers have covered. Splats and snapshots catch tiles up as they go.
+    class PointerHeatmap
+    {
+    public:
+        static constexpr uint32_t TileSize = 32;
+
+        struct Options
+        {
+            // Edge length of a cell, in DIPs
+            float CellSize = 4.0f;
+
+            // Kernel radius in cells; the Gaussian's sigma is half of it
+            float KernelRadius = 3.0f;
+
+            // Seconds for a value to halve
+            float HalfLife = 30.0f;
+
+            // Peak added by a sample while pressed and while hovering
+            float PressedWeight = 1.0f;
+            float HoverWeight = 0.25f;
+
+            // Tiles whose values all fall below this are cleared and skipped
+            float Floor = 1.0f / 1024.0f;
+
+            // Most active tiles Decay() scales per call
+            uint32_t TilesPerFrame = 256;
+        };
+
+        PointerHeatmap();
+        explicit PointerHeatmap(Options const& options);
+
+        // Sizes the grid to cover a panel of the given size in DIPs. Clears
+        // the heatmap if the grid dimensions change.
+        void Resize(float width, float height);
+
+        // Samples outside the panel are ignored
+        void AddSample(HeatmapSample const& sample) noexcept;
+        void Decay(float seconds) noexcept;
+        void Clear() noexcept;
+
+        void Snapshot(HeatmapSnapshot& out) const;
+
+        // Grid size in cells
+        uint32_t Width() const noexcept { return m_width; }
+        uint32_t Height() const noexcept { return m_height; }
+        float CellSize() const noexcept { return m_options.CellSize; }
+
+        // Value of a cell, for tests and tools
+        float Value(uint32_t x, uint32_t y) const noexcept;
+
+        size_t TileCount() const noexcept { return m_tileActive.size(); }
+        size_t ActiveTileCount() const noexcept { return m_activeTiles.size(); }
+
+    private:
+        static constexpr uint32_t TileCells = TileSize * TileSize;
+
+        float* Tile(uint32_t tile) noexcept { return m_cells.data() + size_t{ tile } * TileCells; }
+        float const* Tile(uint32_t tile) const noexcept { return m_cells.data() + size_t{ tile } * TileCells; }
+        void Activate(uint32_t tile) noexcept;
+
+        // Factor that brings the tile up to date with the decay so far
+        float PendingDecay(uint32_t tile) const noexcept;
+
+        Options m_options;
+        int32_t m_kernelRadius{ 0 };
+        uint32_t m_kernelStride{ 0 };
+        std::vector<float> m_kernel;
+
+        uint32_t m_width{ 0 };
+        uint32_t m_height{ 0 };
+        uint32_t m_tilesX{ 0 };
+        uint32_t m_tilesY{ 0 };
+        std::vector<float> m_cells;
+        std::vector<uint8_t> m_tileActive;
+        std::vector<uint32_t> m_activeTiles;
+        size_t m_decayCursor{ 0 };
+
+        // Seconds of decay applied overall and to each tile
+        double m_decayTime{ 0.0 };
+        std::vector<double> m_tileDecayTimes;
+    };
+}
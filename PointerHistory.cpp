@@ -0,0 +1,446 @@
+#include "PointerHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Varint.h"
+
+namespace PointerCore
+{
+    namespace
+    {
+        // Most significant bit first
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& out) noexcept : m_out{ out } {}
+
+            // Up to 56 bits at a time
+            void Write(uint64_t value, unsigned bits)
+            {
+                m_bits = (m_bits << bits) | (value & ((uint64_t{ 1 } << bits) - 1));
+                m_count += bits;
+                while (m_count >= 8)
+                {
+                    m_count -= 8;
+                    m_out.push_back(static_cast<uint8_t>(m_bits >> m_count));
+                }
+            }
+
+            void Flush()
+            {
+                if (m_count > 0)
+                {
+                    Write(0, 8 - m_count);
+                }
+            }
+
+        private:
+            std::vector<uint8_t>& m_out;
+            uint64_t m_bits{ 0 };
+            unsigned m_count{ 0 };
+        };
+
+        class BitReader
+        {
+        public:
+            BitReader(uint8_t const* begin, uint8_t const* end) noexcept : m_cursor{ begin }, m_end{ end } {}
+
+            // Up to 56 bits at a time. Reads zeros past the end.
+            uint64_t Read(unsigned bits) noexcept
+            {
+                while (m_count < bits)
+                {
+                    m_bits = (m_bits << 8) | ((m_cursor != m_end) ? *m_cursor++ : 0);
+                    m_count += 8;
+                }
+
+                m_count -= bits;
+                return (m_bits >> m_count) & ((uint64_t{ 1 } << bits) - 1);
+            }
+
+        private:
+            uint8_t const* m_cursor;
+            uint8_t const* m_end;
+            uint64_t m_bits{ 0 };
+            unsigned m_count{ 0 };
+        };
+
+        // Prefix and payload size of each delta-of-delta bucket
+        struct TimeBucket
+        {
+            uint64_t Prefix;
+            unsigned PrefixBits;
+            unsigned ValueBits;
+        };
+
+        constexpr TimeBucket TimeBuckets[] = {
+            { 0b10, 2, 7 },
+            { 0b110, 3, 9 },
+            { 0b1110, 4, 12 },
+        };
+
+        void WriteTimestampDelta(BitWriter& writer, int64_t deltaOfDelta)
+        {
+            if (deltaOfDelta == 0)
+            {
+                writer.Write(0, 1);
+                return;
+            }
+
+            uint64_t const value = Varint::ZigZagEncode(deltaOfDelta);
+            for (auto const& bucket : TimeBuckets)
+            {
+                if (value < (uint64_t{ 1 } << bucket.ValueBits))
+                {
+                    writer.Write(bucket.Prefix, bucket.PrefixBits);
+                    writer.Write(value, bucket.ValueBits);
+                    return;
+                }
+            }
+
+            writer.Write(0b1111, 4);
+            writer.Write(value >> 32, 32);
+            writer.Write(value, 32);
+        }
+
+        int64_t ReadTimestampDelta(BitReader& reader) noexcept
+        {
+            if (reader.Read(1) == 0)
+            {
+                return 0;
+            }
+
+            // Count the remaining 1s of the prefix
+            unsigned ones = 1;
+            while ((ones < 4) && (reader.Read(1) == 1))
+            {
+                ++ones;
+            }
+
+            uint64_t value;
+            if (ones < 4)
+            {
+                value = reader.Read(TimeBuckets[ones - 1].ValueBits);
+            }
+            else
+            {
+                value = reader.Read(32) << 32;
+                value |= reader.Read(32);
+            }
+
+            return Varint::ZigZagDecode(value);
+        }
+
+        uint8_t PackFlags(PointerEvent const& event) noexcept
+        {
+            return static_cast<uint8_t>(static_cast<uint8_t>(event.Kind) | (static_cast<uint8_t>(event.DeviceKind) << 3) | (event.InContact ? 0x20 : 0));
+        }
+
+        int64_t Quantize(float value, float scale) noexcept
+        {
+            return static_cast<int64_t>(std::llround(static_cast<double>(value) * scale));
+        }
+
+        uint64_t ReadVarint(uint8_t const*& cursor, uint8_t const* end) noexcept
+        {
+            uint64_t value = 0;
+            Varint::Read(cursor, end, value);
+            return value;
+        }
+    }
+
+    PointerHistory::PointerHistory()
+        : PointerHistory(Options())
+    {
+    }
+
+    PointerHistory::PointerHistory(Options const& options)
+        : m_options(options)
+        , m_inversePositionScale(1.0f / static_cast<float>(std::max(options.PositionScale, 1u)))
+        , m_inversePressureScale(1.0f / static_cast<float>(std::max(options.PressureScale, 1u)))
+    {
+        m_options.PositionScale = std::max(m_options.PositionScale, 1u);
+        m_options.PressureScale = std::max(m_options.PressureScale, 1u);
+    }
+
+    void PointerHistory::Append(PointerEvent const& event)
+    {
+        // Input usually comes from one pointer at a time
+        if ((m_lastSeries >= m_series.size()) || (m_series[m_lastSeries].Id != event.Id))
+        {
+            auto const found = m_seriesIndices.find(event.Id);
+            if (found != m_seriesIndices.end())
+            {
+                m_lastSeries = found->second;
+            }
+            else
+            {
+                m_lastSeries = m_series.size();
+                m_seriesIndices.emplace(event.Id, m_lastSeries);
+                m_series.emplace_back();
+                m_series.back().Id = event.Id;
+            }
+        }
+
+        Series& series = m_series[m_lastSeries];
+        series.Open.push_back(event);
+        series.Open.back().ReceivedTime = 0;
+        series.Exited = false;
+        ++m_eventCount;
+        ++m_openEvents;
+
+        if (series.Open.size() == BlockSamples)
+        {
+            Seal(series);
+        }
+
+        if (event.Kind == PointerEventKind::Exited)
+        {
+            // Touch contacts get a new id each time, so a pointer that has
+            // gone may never be seen again: seal what it has and free the
+            // open block rather than keep one per contact
+            if (!series.Open.empty())
+            {
+                Seal(series);
+            }
+            std::vector<PointerEvent>().swap(series.Open);
+            series.Exited = true;
+        }
+
+        // Last, since it may remove series and move the others
+        if ((m_options.MaxBytes != 0) && (m_compressedBytes > m_options.MaxBytes))
+        {
+            Evict();
+        }
+    }
+
+    void PointerHistory::Clear() noexcept
+    {
+        m_series.clear();
+        m_seriesIndices.clear();
+        m_lastSeries = 0;
+        m_oldestBlocks = {};
+        m_openEvents = 0;
+        m_eventCount = 0;
+        m_evictedCount = 0;
+        m_blockCount = 0;
+        m_compressedBytes = 0;
+    }
+
+    void PointerHistory::Query(uint64_t from, uint64_t to, std::vector<PointerEvent>& out) const
+    {
+        size_t const first = out.size();
+        ForEachInRange(from, to, [&out](PointerEvent const& event) { out.push_back(event); });
+
+        // Each pointer's events are mostly in order already
+        std::stable_sort(out.begin() + first, out.end(),
+            [](PointerEvent const& a, PointerEvent const& b) { return a.Timestamp < b.Timestamp; });
+    }
+
+    void PointerHistory::Seal(Series& series)
+    {
+        auto const& events = series.Open;
+
+        Block block{};
+        block.Count = static_cast<uint32_t>(events.size());
+        block.MinTime = UINT64_MAX;
+        block.MaxTime = 0;
+        block.Data.reserve(events.size() * 5);
+
+        // Timestamps
+        {
+            BitWriter writer{ block.Data };
+            uint64_t previous = events.front().Timestamp;
+            int64_t previousDelta = 0;
+            writer.Write(previous >> 32, 32);
+            writer.Write(previous, 32);
+            for (auto const& event : events)
+            {
+                block.MinTime = std::min(block.MinTime, event.Timestamp);
+                block.MaxTime = std::max(block.MaxTime, event.Timestamp);
+                if (&event == &events.front())
+                {
+                    continue;
+                }
+
+                int64_t const delta = static_cast<int64_t>(event.Timestamp - previous);
+                WriteTimestampDelta(writer, delta - previousDelta);
+                previous = event.Timestamp;
+                previousDelta = delta;
+            }
+            writer.Flush();
+        }
+
+        // Positions and pressure
+        float const positionScale = static_cast<float>(m_options.PositionScale);
+        float const pressureScale = static_cast<float>(m_options.PressureScale);
+        block.ColumnOffsets[0] = static_cast<uint32_t>(block.Data.size());
+        int64_t previousX = 0;
+        for (auto const& event : events)
+        {
+            int64_t const x = Quantize(event.X, positionScale);
+            Varint::WriteSigned(block.Data, x - previousX);
+            previousX = x;
+        }
+
+        block.ColumnOffsets[1] = static_cast<uint32_t>(block.Data.size());
+        int64_t previousY = 0;
+        for (auto const& event : events)
+        {
+            int64_t const y = Quantize(event.Y, positionScale);
+            Varint::WriteSigned(block.Data, y - previousY);
+            previousY = y;
+        }
+
+        block.ColumnOffsets[2] = static_cast<uint32_t>(block.Data.size());
+        int64_t previousPressure = 0;
+        for (auto const& event : events)
+        {
+            int64_t const pressure = Quantize(event.Pressure, pressureScale);
+            Varint::WriteSigned(block.Data, pressure - previousPressure);
+            previousPressure = pressure;
+        }
+
+        // Flags, as (flags, run length) pairs
+        block.ColumnOffsets[3] = static_cast<uint32_t>(block.Data.size());
+        for (size_t i = 0; i < events.size();)
+        {
+            uint8_t const flags = PackFlags(events[i]);
+            size_t run = 1;
+            while ((i + run < events.size()) && (PackFlags(events[i + run]) == flags))
+            {
+                ++run;
+            }
+
+            block.Data.push_back(flags);
+            Varint::Write(block.Data, run);
+            i += run;
+        }
+
+        block.Data.shrink_to_fit();
+        if (!series.Blocks.empty() && (block.MinTime < series.Blocks.back().MaxTime))
+        {
+            series.Ordered = false;
+        }
+
+        if (series.Blocks.empty())
+        {
+            m_oldestBlocks.emplace(block.MinTime, series.Id);
+        }
+
+        m_compressedBytes += block.Data.size() + sizeof(Block);
+        ++m_blockCount;
+        m_openEvents -= series.Open.size();
+        series.Blocks.push_back(std::move(block));
+        series.Open.clear();
+    }
+
+    void PointerHistory::Evict()
+    {
+        while ((m_compressedBytes > m_options.MaxBytes) && !m_oldestBlocks.empty())
+        {
+            // The pointer whose oldest block is the oldest overall
+            uint32_t const id = m_oldestBlocks.top().second;
+            m_oldestBlocks.pop();
+            size_t const index = m_seriesIndices.find(id)->second;
+            Series& oldest = m_series[index];
+
+            Block const& block = oldest.Blocks.front();
+            m_compressedBytes -= block.Data.size() + sizeof(Block);
+            m_eventCount -= block.Count;
+            m_evictedCount += block.Count;
+            --m_blockCount;
+            oldest.Blocks.pop_front();
+
+            if (!oldest.Blocks.empty())
+            {
+                m_oldestBlocks.emplace(oldest.Blocks.front().MinTime, id);
+            }
+            else if (oldest.Exited)
+            {
+                RemoveSeries(index);
+            }
+        }
+    }
+
+    void PointerHistory::RemoveSeries(size_t index)
+    {
+        m_seriesIndices.erase(m_series[index].Id);
+        if (index + 1 != m_series.size())
+        {
+            m_series[index] = std::move(m_series.back());
+            m_seriesIndices[m_series[index].Id] = index;
+        }
+
+        m_series.pop_back();
+        m_lastSeries = m_series.size();
+    }
+
+    void PointerHistory::DecodeBlock(Block const& block, uint32_t id, std::vector<PointerEvent>& out) const
+    {
+        ++m_blocksDecoded;
+        out.resize(block.Count);
+
+        uint8_t const* const data = block.Data.data();
+        uint8_t const* const end = data + block.Data.size();
+
+        BitReader times{ data, data + block.ColumnOffsets[0] };
+        uint64_t timestamp = times.Read(32) << 32;
+        timestamp |= times.Read(32);
+        int64_t delta = 0;
+
+        uint8_t const* xs = data + block.ColumnOffsets[0];
+        uint8_t const* ys = data + block.ColumnOffsets[1];
+        uint8_t const* pressures = data + block.ColumnOffsets[2];
+        uint8_t const* flags = data + block.ColumnOffsets[3];
+        int64_t x = 0;
+        int64_t y = 0;
+        int64_t pressure = 0;
+        uint8_t flagsValue = 0;
+        uint64_t flagsRun = 0;
+
+        for (uint32_t i = 0; i < block.Count; ++i)
+        {
+            if (i > 0)
+            {
+                delta += ReadTimestampDelta(times);
+                timestamp += static_cast<uint64_t>(delta);
+            }
+
+            x += Varint::ZigZagDecode(ReadVarint(xs, data + block.ColumnOffsets[1]));
+            y += Varint::ZigZagDecode(ReadVarint(ys, data + block.ColumnOffsets[2]));
+            pressure += Varint::ZigZagDecode(ReadVarint(pressures, data + block.ColumnOffsets[3]));
+            if ((flagsRun == 0) && (flags != end))
+            {
+                flagsValue = *flags++;
+                flagsRun = ReadVarint(flags, end);
+            }
+            --flagsRun;
+
+            PointerEvent& event = out[i];
+            event.Timestamp = timestamp;
+            event.ReceivedTime = 0;
+            event.Id = id;
+            event.X = static_cast<float>(x) * m_inversePositionScale;
+            event.Y = static_cast<float>(y) * m_inversePositionScale;
+            event.Pressure = static_cast<float>(pressure) * m_inversePressureScale;
+            event.Kind = static_cast<PointerEventKind>(flagsValue & 0x07);
+            event.DeviceKind = static_cast<PointerDeviceKind>((flagsValue >> 3) & 0x03);
+            event.InContact = (flagsValue & 0x20) != 0;
+        }
+    }
+
+    size_t PointerHistory::FirstBlock(Series const& series, uint64_t from) const noexcept
+    {
+        if (!series.Ordered)
+        {
+            return 0;
+        }
+
+        // Ordered blocks have ascending end times too
+        auto const found = std::partition_point(series.Blocks.begin(), series.Blocks.end(),
+            [from](Block const& block) { return block.MaxTime < from; });
+        return static_cast<size_t>(found - series.Blocks.begin());
+    }
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Compressed, append-only history of every pointer event, for replaying
+    // and analysing long sessions.
+    //
+    // Events are kept per pointer in blocks of up to BlockSamples. A pointer's
+    // newest block stays uncompressed while it fills up, so appending is a
+    // push_back; a full block, or the last of a pointer that exited, is
+    // compressed column by column:
+    //
+    //   Timestamps  Gorilla-style delta-of-delta bit stream: the first
+    //               timestamp in 64 bits, then per event '0' when the
+    //               interval didn't change, or '10', '110', '1110' and
+    //               '1111' prefixes for zigzag changes of up to 7, 9, 12
+    //               and 64 bits
+    //   X, Y        Zigzag varint deltas of positions quantized to
+    //               1/PositionScale DIPs
+    //   Pressure    Zigzag varint deltas, quantized to 1/PressureScale
+    //   Flags       Run-length encoded (kind, device, in contact) bytes
+    //
+    // Each block keeps the range of its timestamps, so scans by time or by
+    // pointer only decompress the blocks they overlap. Once the compressed
+    // blocks outgrow Options::MaxBytes the oldest are evicted, and a pointer
+    // that exited is forgotten along with its last block.
+    //
+    // Positions and pressures come back quantized; ReceivedTime is not kept.
+    // Not thread-safe.
+    class PointerHistory
+    {
+    public:
+        static constexpr size_t BlockSamples = 512;
+
+        struct Options
+        {
+            // Fixed-point units per DIP, and per unit of pressure
+            uint32_t PositionScale = 64;
+            uint32_t PressureScale = 1024;
+
+            // Bound on the compressed blocks, 0 for none
+            size_t MaxBytes = 256 * 1024 * 1024;
+        };
+
+        PointerHistory();
+        explicit PointerHistory(Options const& options);
+
+        void Append(PointerEvent const& event);
+        void Clear() noexcept;
+
+        // Calls fn(PointerEvent const&) for every event with a timestamp in
+        // [from, to), pointer by pointer and in order of appending for each.
+        // Returns the number of events visited.
+        template <typename Fn>
+        size_t ForEachInRange(uint64_t from, uint64_t to, Fn&& fn) const
+        {
+            size_t visited = 0;
+            std::vector<PointerEvent> scratch;
+            for (auto const& series : m_series)
+            {
+                visited += ScanSeries(series, from, to, scratch, fn);
+            }
+
+            return visited;
+        }
+
+        // Same as ForEachInRange() for one pointer
+        template <typename Fn>
+        size_t ForEachOfPointer(uint32_t id, uint64_t from, uint64_t to, Fn&& fn) const
+        {
+            auto const found = m_seriesIndices.find(id);
+            if (found == m_seriesIndices.end())
+            {
+                return 0;
+            }
+
+            std::vector<PointerEvent> scratch;
+            return ScanSeries(m_series[found->second], from, to, scratch, fn);
+        }
+
+        // Appends the events with a timestamp in [from, to) in timestamp
+        // order (of appending, for equal timestamps of one pointer)
+        void Query(uint64_t from, uint64_t to, std::vector<PointerEvent>& out) const;
+
+        uint64_t EventCount() const noexcept { return m_eventCount; }
+        uint64_t EvictedEventCount() const noexcept { return m_evictedCount; }
+        size_t BlockCount() const noexcept { return m_blockCount; }
+
+        // Pointers with events kept; exited ones go with their last block
+        size_t PointerCount() const noexcept { return m_series.size(); }
+
+        // Bytes of compressed blocks, and of the uncompressed newest blocks
+        size_t CompressedBytes() const noexcept { return m_compressedBytes; }
+        size_t OpenBytes() const noexcept { return m_openEvents * sizeof(PointerEvent); }
+
+        // Blocks decompressed by scans so far, for tests and benchmarks
+        uint64_t BlocksDecoded() const noexcept { return m_blocksDecoded; }
+
+    private:
+        struct Block
+        {
+            uint32_t Count;
+            uint64_t MinTime;
+            uint64_t MaxTime;
+
+            // Start of the X, Y, pressure and flags columns in Data; the
+            // timestamps start at 0
+            uint32_t ColumnOffsets[4];
+            std::vector<uint8_t> Data;
+        };
+
+        struct Series
+        {
+            uint32_t Id;
+            std::deque<Block> Blocks;
+            std::vector<PointerEvent> Open;
+
+            // Every block starts no earlier than the previous one ends, so
+            // the blocks can be binary searched by time
+            bool Ordered{ true };
+
+            // Sealed on exiting and not seen since; dropped once its blocks are evicted
+            bool Exited{ false };
+        };
+
+        // MinTime of a series' oldest block, and the series' pointer ID
+        using OldestBlock = std::pair<uint64_t, uint32_t>;
+
+        void Seal(Series& series);
+        void Evict();
+        void RemoveSeries(size_t index);
+        void DecodeBlock(Block const& block, uint32_t id, std::vector<PointerEvent>& out) const;
+
+        // Index of the first block that may hold events at or after from
+        size_t FirstBlock(Series const& series, uint64_t from) const noexcept;
+
+        template <typename Fn>
+        size_t ScanSeries(Series const& series, uint64_t from, uint64_t to, std::vector<PointerEvent>& scratch, Fn& fn) const
+        {
+            size_t visited = 0;
+            for (size_t i = FirstBlock(series, from); i < series.Blocks.size(); ++i)
+            {
+                Block const& block = series.Blocks[i];
+                if (block.MinTime >= to)
+                {
+                    if (series.Ordered)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                if (block.MaxTime < from)
+                {
+                    continue;
+                }
+
+                DecodeBlock(block, series.Id, scratch);
+                visited += Visit(scratch, from, to, fn);
+            }
+
+            return visited + Visit(series.Open, from, to, fn);
+        }
+
+        template <typename Fn>
+        static size_t Visit(std::vector<PointerEvent> const& events, uint64_t from, uint64_t to, Fn& fn)
+        {
+            size_t visited = 0;
+            for (auto const& event : events)
+            {
+                if ((event.Timestamp >= from) && (event.Timestamp < to))
+                {
+                    fn(event);
+                    ++visited;
+                }
+            }
+
+            return visited;
+        }
+
+        Options m_options;
+        float m_inversePositionScale;
+        float m_inversePressureScale;
+
+        std::vector<Series> m_series;
+        std::unordered_map<uint32_t, size_t> m_seriesIndices;
+        size_t m_lastSeries{ 0 };
+
+        // One entry per series with blocks, so eviction finds the oldest
+        // block overall without visiting every series
+        std::priority_queue<OldestBlock, std::vector<OldestBlock>, std::greater<OldestBlock>> m_oldestBlocks;
+        size_t m_openEvents{ 0 };
+
+        uint64_t m_eventCount{ 0 };
+        uint64_t m_evictedCount{ 0 };
+        size_t m_blockCount{ 0 };
+        size_t m_compressedBytes{ 0 };
+        mutable uint64_t m_blocksDecoded{ 0 };
+    };
+}
@@ -0,0 +1,177 @@
+#include "PointerLifecycle.h"
+
+namespace PointerCore
+{
+    namespace
+    {
+        using State = PointerLifecycle::State;
+        using Anomaly = PointerLifecycle::Anomaly;
+        using Action = PointerLifecycle::Action;
+
+        struct Transition
+        {
+            Action Step;
+            State Next;
+            Anomaly Reason;
+        };
+
+        constexpr size_t KindCount = static_cast<size_t>(PointerEventKind::Released) + 1;
+
+        // Indexed by current state, event kind and whether the event is in
+        // contact. For the *First actions, Next is the state after the
+        // synthesized event.
+        constexpr Transition s_transitions[static_cast<size_t>(State::Count)][KindCount][2] =
+        {
+            // Absent
+            {
+                /* Entered  */ { { Action::Apply, State::Hovering, Anomaly::None }, { Action::Apply, State::Hovering, Anomaly::None } },
+                /* Exited   */ { { Action::Drop, State::Absent, Anomaly::UntrackedExit }, { Action::Drop, State::Absent, Anomaly::UntrackedExit } },
+                /* Moved    */ { { Action::EnterFirst, State::Hovering, Anomaly::MissingEnter }, { Action::EnterFirst, State::Hovering, Anomaly::MissingEnter } },
+                /* Pressed  */ { { Action::EnterFirst, State::Hovering, Anomaly::MissingEnter }, { Action::EnterFirst, State::Hovering, Anomaly::MissingEnter } },
+                /* Released */ { { Action::Drop, State::Absent, Anomaly::UnmatchedRelease }, { Action::Drop, State::Absent, Anomaly::UnmatchedRelease } },
+            },
+            // Hovering
+            {
+                /* Entered  */ { { Action::Drop, State::Hovering, Anomaly::DuplicateEnter }, { Action::Drop, State::Hovering, Anomaly::DuplicateEnter } },
+                /* Exited   */ { { Action::Apply, State::Absent, Anomaly::None }, { Action::Apply, State::Absent, Anomaly::None } },
+                /* Moved    */ { { Action::Apply, State::Hovering, Anomaly::None }, { Action::PressFirst, State::Pressed, Anomaly::MissingPress } },
+                /* Pressed  */ { { Action::Apply, State::Pressed, Anomaly::ContactMismatch }, { Action::Apply, State::Pressed, Anomaly::None } },
+                /* Released */ { { Action::Drop, State::Hovering, Anomaly::UnmatchedRelease }, { Action::Drop, State::Hovering, Anomaly::UnmatchedRelease } },
+            },
+            // Pressed
+            {
+                /* Entered  */ { { Action::Drop, State::Pressed, Anomaly::DuplicateEnter }, { Action::Drop, State::Pressed, Anomaly::DuplicateEnter } },
+                /* Exited   */ { { Action::ReleaseFirst, State::Hovering, Anomaly::MissingRelease }, { Action::ReleaseFirst, State::Hovering, Anomaly::MissingRelease } },
+                /* Moved    */ { { Action::ReleaseFirst, State::Hovering, Anomaly::MissingRelease }, { Action::Apply, State::Pressed, Anomaly::None } },
+                /* Pressed  */ { { Action::Drop, State::Pressed, Anomaly::DuplicatePress }, { Action::Drop, State::Pressed, Anomaly::DuplicatePress } },
+                /* Released */ { { Action::Apply, State::Hovering, Anomaly::None }, { Action::Apply, State::Hovering, Anomaly::ContactMismatch } },
+            },
+        };
+    }
+
+    PointerLifecycle::PointerLifecycle(size_t capacity)
+        : m_capacity{ capacity }
+    {
+        uint32_t bits = 1;
+        while ((size_t{ 1 } << bits) < 2 * capacity)
+        {
+            ++bits;
+        }
+
+        m_entries.assign(size_t{ 1 } << bits, Entry{ 0, State::Absent });
+        m_slotMask = m_entries.size() - 1;
+        m_slotShift = 32 - bits;
+    }
+
+    char const* PointerLifecycle::AnomalyName(Anomaly anomaly) noexcept
+    {
+        switch (anomaly)
+        {
+        case Anomaly::None: return "None";
+        case Anomaly::MissingEnter: return "MissingEnter";
+        case Anomaly::DuplicateEnter: return "DuplicateEnter";
+        case Anomaly::UntrackedExit: return "UntrackedExit";
+        case Anomaly::MissingPress: return "MissingPress";
+        case Anomaly::DuplicatePress: return "DuplicatePress";
+        case Anomaly::UnmatchedRelease: return "UnmatchedRelease";
+        case Anomaly::MissingRelease: return "MissingRelease";
+        case Anomaly::ContactMismatch: return "ContactMismatch";
+        case Anomaly::Overflow: return "Overflow";
+        default: return "Unknown";
+        }
+    }
+
+    void PointerLifecycle::EraseSlot(size_t slot) noexcept
+    {
+        // Shift back later entries of the probe run that would otherwise
+        // become unreachable
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & m_slotMask; m_entries[next].Current != State::Absent; next = (next + 1) & m_slotMask)
+        {
+            size_t const home = static_cast<uint32_t>(m_entries[next].Id * 2654435769u) >> m_slotShift;
+            if (((next - home) & m_slotMask) >= ((next - hole) & m_slotMask))
+            {
+                m_entries[hole] = m_entries[next];
+                hole = next;
+            }
+        }
+
+        m_entries[hole].Current = State::Absent;
+        --m_size;
+    }
+
+    PointerLifecycle::Action PointerLifecycle::Resolve(PointerEvent const& event) noexcept
+    {
+        // Unknown kinds (e.g. from a corrupt trace) are dropped without touching any state
+        if (static_cast<size_t>(event.Kind) >= KindCount)
+        {
+            return Action::Drop;
+        }
+
+        size_t const slot = Probe(event.Id);
+        State const current = m_entries[slot].Current;
+        Transition const& transition = s_transitions[static_cast<size_t>(current)][static_cast<size_t>(event.Kind)][event.InContact ? 1 : 0];
+
+        if ((current == State::Absent) && (transition.Next != State::Absent))
+        {
+            // Entering, directly or through a synthesized enter
+            if (m_size == m_capacity)
+            {
+                ++m_anomalies[static_cast<size_t>(Anomaly::Overflow)];
+                return Action::Drop;
+            }
+
+            m_entries[slot].Id = event.Id;
+            ++m_size;
+        }
+
+        ++m_anomalies[static_cast<size_t>(transition.Reason)];
+        if (transition.Next != State::Absent)
+        {
+            m_entries[slot].Current = transition.Next;
+        }
+        else if (current != State::Absent)
+        {
+            EraseSlot(slot);
+        }
+
+        return transition.Step;
+    }
+
+    void PointerLifecycle::Forget(uint32_t id) noexcept
+    {
+        size_t const slot = Probe(id);
+        if (m_entries[slot].Current != State::Absent)
+        {
+            EraseSlot(slot);
+        }
+    }
+
+    void PointerLifecycle::Clear() noexcept
+    {
+        for (auto& entry : m_entries)
+        {
+            entry.Current = State::Absent;
+        }
+        m_size = 0;
+    }
+
+    uint64_t PointerLifecycle::TotalAnomalies() const noexcept
+    {
+        uint64_t total = 0;
+        for (size_t i = static_cast<size_t>(Anomaly::None) + 1; i < static_cast<size_t>(Anomaly::Count); ++i)
+        {
+            total += m_anomalies[i];
+        }
+
+        return total;
+    }
+
+    void PointerLifecycle::ResetAnomalies() noexcept
+    {
+        for (auto& count : m_anomalies)
+        {
+            count = 0;
+        }
+    }
+}
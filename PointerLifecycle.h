@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Validates the order of pointer events before they're applied.
+    //
+    // Each pointer moves through Absent -> Hovering <-> Pressed -> Absent.
+    // Real devices don't always respect that (enters get lost, presses get
+    // duplicated), so instead of failing on an event that doesn't fit, the
+    // lifecycle looks up a fixed transition table and either applies it,
+    // drops it, or first synthesizes the event that should have come before.
+    // Every correction is counted by kind.
+    //
+    // The events a Process() call hands to its sink always form a valid
+    // sequence, so consumers can assume a moved pointer was entered, a
+    // released one pressed, and so on.
+    class PointerLifecycle
+    {
+    public:
+        enum class State : uint8_t
+        {
+            Absent,
+            Hovering,
+            Pressed,
+            Count
+        };
+
+        enum class Anomaly : uint8_t
+        {
+            None,
+            MissingEnter,       // Moved or pressed before entering; an enter is synthesized
+            DuplicateEnter,     // Entered while already tracked; dropped
+            UntrackedExit,      // Exited without being tracked; dropped
+            MissingPress,       // Moved in contact while hovering; a press is synthesized
+            DuplicatePress,     // Pressed while already pressed; dropped
+            UnmatchedRelease,   // Released without being pressed; dropped
+            MissingRelease,     // Moved out of contact or exited while pressed; a release is synthesized
+            ContactMismatch,    // Press not in contact or release in contact; applied anyway
+            Overflow,           // Entered with no room to track another pointer; dropped
+            Count
+        };
+
+        enum class Action : uint8_t
+        {
+            Apply,
+            Drop,
+            EnterFirst,
+            PressFirst,
+            ReleaseFirst,
+        };
+
+        explicit PointerLifecycle(size_t capacity = PointerTable::DefaultCapacity);
+
+        static char const* AnomalyName(Anomaly anomaly) noexcept;
+
+        // Runs the event through the transition table, calling sink with each
+        // event to apply (synthesized ones first, with the original event's
+        // position and timestamp). Returns the number of events delivered.
+        template <typename Sink>
+        size_t Process(PointerEvent const& event, Sink&& sink)
+        {
+            size_t delivered = 0;
+            for (;;)
+            {
+                PointerEvent synthesized = event;
+                switch (Resolve(event))
+                {
+                case Action::Apply:
+                    sink(event);
+                    return delivered + 1;
+
+                case Action::Drop:
+                    return delivered;
+
+                case Action::EnterFirst:
+                    synthesized.Kind = PointerEventKind::Entered;
+                    synthesized.InContact = false;
+                    break;
+
+                case Action::PressFirst:
+                    synthesized.Kind = PointerEventKind::Pressed;
+                    synthesized.InContact = true;
+                    break;
+
+                case Action::ReleaseFirst:
+                    synthesized.Kind = PointerEventKind::Released;
+                    synthesized.InContact = false;
+                    break;
+                }
+
+                sink(static_cast<PointerEvent const&>(synthesized));
+                ++delivered;
+
+                // A synthesized event always leaves the pointer tracked. If it
+                // isn't, the sink forgot it, and the original event goes too
+                // rather than synthesizing the same enter again.
+                if (PointerState(event.Id) == State::Absent)
+                {
+                    return delivered;
+                }
+            }
+        }
+
+        // Advances the pointer's state for one step of the event and returns
+        // what to do with it. For the *First actions the state has already
+        // moved past the synthesized event, so the same event should be
+        // resolved again afterwards (Process() does this).
+        Action Resolve(PointerEvent const& event) noexcept;
+
+        // Stops tracking a pointer without delivering anything. May be called
+        // from a Process() sink, e.g. when the consumer has no room for an
+        // entered pointer; the rest of that event is then dropped.
+        void Forget(uint32_t id) noexcept;
+        void Clear() noexcept;
+
+        State PointerState(uint32_t id) const noexcept { return m_entries[Probe(id)].Current; }
+        size_t TrackedCount() const noexcept { return m_size; }
+
+        uint64_t AnomalyCount(Anomaly anomaly) const noexcept { return m_anomalies[static_cast<size_t>(anomaly)]; }
+        uint64_t TotalAnomalies() const noexcept;
+        void ResetAnomalies() noexcept;
+
+    private:
+        struct Entry
+        {
+            uint32_t Id;
+            State Current;  // Absent marks an empty slot
+        };
+
+        // The slot holding the pointer, or the empty slot that ends its probe run
+        size_t Probe(uint32_t id) const noexcept
+        {
+            size_t slot = static_cast<uint32_t>(id * 2654435769u) >> m_slotShift;
+            while ((m_entries[slot].Current != State::Absent) && (m_entries[slot].Id != id))
+            {
+                slot = (slot + 1) & m_slotMask;
+            }
+
+            return slot;
+        }
+
+        void EraseSlot(size_t slot) noexcept;
+
+        size_t m_capacity;
+        size_t m_size{ 0 };
+
+        // Tracked pointers by ID, linear probing with at least twice as many
+        // slots as the capacity, like PointerTable's index
+        std::vector<Entry> m_entries;
+        size_t m_slotMask;
+        uint32_t m_slotShift;
+
+        uint64_t m_anomalies[static_cast<size_t>(Anomaly::Count)]{ 0 };
+    };
+}
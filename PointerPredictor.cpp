@@ -0,0 +1,265 @@
+#include "PointerPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PointerCore
+{
+    static inline uint32_t BucketBits(size_t capacity) noexcept
+    {
+        uint32_t bits = 1;
+        while ((size_t{ 1 } << bits) < 2 * capacity)
+        {
+            ++bits;
+        }
+
+        return bits;
+    }
+
+    void PointerPredictor::AxisFilter::Reset(double position) noexcept
+    {
+        Position = position;
+        Velocity = 0.0;
+
+        // Position starts out as good as the measurement, velocity is unknown
+        P00 = 1.0;
+        P01 = 0.0;
+        P11 = 1.0e6;
+    }
+
+    void PointerPredictor::AxisFilter::Update(double measurement, double dt, double processNoise, double measurementNoise) noexcept
+    {
+        // Predict: x = F x, P = F P F' + Q with F = [1 dt; 0 1]
+        Position += Velocity * dt;
+
+        double const dt2 = dt * dt;
+        double const p00 = P00 + 2.0 * dt * P01 + dt2 * P11 + processNoise * dt2 * dt / 3.0;
+        double const p01 = P01 + dt * P11 + processNoise * dt2 / 2.0;
+        double const p11 = P11 + processNoise * dt;
+
+        // Update with the measured position (H = [1 0])
+        double const innovation = measurement - Position;
+        double const s = p00 + measurementNoise;
+        double const k0 = p00 / s;
+        double const k1 = p01 / s;
+
+        Position += k0 * innovation;
+        Velocity += k1 * innovation;
+        P00 = (1.0 - k0) * p00;
+        P01 = (1.0 - k0) * p01;
+        P11 = p11 - k1 * p01;
+    }
+
+    PointerPredictor::PointerPredictor(size_t capacity)
+        : PointerPredictor(Options{}, capacity)
+    {
+    }
+
+    PointerPredictor::PointerPredictor(Options const& options, size_t capacity)
+        : m_options{ options }
+        , m_tracks(capacity)
+        , m_buckets(size_t{ 1 } << BucketBits(capacity))
+        , m_bucketMask{ (size_t{ 1 } << BucketBits(capacity)) - 1 }
+        , m_bucketShift{ 32 - BucketBits(capacity) }
+    {
+    }
+
+    size_t PointerPredictor::FindTrack(uint32_t id) const noexcept
+    {
+        for (size_t bucket = HomeBucket(id);; bucket = (bucket + 1) & m_bucketMask)
+        {
+            uint32_t const entry = m_buckets[bucket];
+            if (entry == 0)
+            {
+                return PointerTable::npos;
+            }
+
+            if (m_tracks[entry - 1].Id == id)
+            {
+                return entry - 1;
+            }
+        }
+    }
+
+    size_t PointerPredictor::BucketOf(size_t track) const noexcept
+    {
+        size_t bucket = HomeBucket(m_tracks[track].Id);
+        while (m_buckets[bucket] != track + 1)
+        {
+            bucket = (bucket + 1) & m_bucketMask;
+        }
+
+        return bucket;
+    }
+
+    void PointerPredictor::AddSample(uint32_t id, PointerSample const& sample) noexcept
+    {
+        // One probe finds the track, or the empty bucket to insert it at
+        size_t bucket = HomeBucket(id);
+        while ((m_buckets[bucket] != 0) && (m_tracks[m_buckets[bucket] - 1].Id != id))
+        {
+            bucket = (bucket + 1) & m_bucketMask;
+        }
+
+        size_t index = m_buckets[bucket];
+        if (index != 0)
+        {
+            --index;
+        }
+        else
+        {
+            if (m_size == m_tracks.size())
+            {
+                return;
+            }
+
+            index = m_size++;
+            m_buckets[bucket] = static_cast<uint32_t>(index + 1);
+            m_tracks[index].Id = id;
+            m_tracks[index].SampleCount = 0;
+        }
+
+        Track& track = m_tracks[index];
+
+        // Restart the estimate on the first sample, after long gaps, and if time goes backwards
+        bool const restart = (track.SampleCount == 0) ||
+            (sample.Timestamp <= track.Last.Timestamp) ||
+            (sample.Timestamp - track.Last.Timestamp > m_options.MaxSampleGapMicroseconds);
+        if (restart)
+        {
+            track.SampleCount = 1;
+            track.Last = sample;
+            track.VelocityX = 0.0f;
+            track.VelocityY = 0.0f;
+            track.FilterX.Reset(sample.X);
+            track.FilterY.Reset(sample.Y);
+            return;
+        }
+
+        double const dt = static_cast<double>(sample.Timestamp - track.Last.Timestamp) * 1.0e-6;
+
+        // Constant velocity: exponentially smoothed finite differences
+        float const alpha = (track.SampleCount == 1) ? 1.0f : m_options.VelocitySmoothing;
+        auto const vx = static_cast<float>((sample.X - track.Last.X) / dt);
+        auto const vy = static_cast<float>((sample.Y - track.Last.Y) / dt);
+        track.VelocityX += alpha * (vx - track.VelocityX);
+        track.VelocityY += alpha * (vy - track.VelocityY);
+
+        // Kalman
+        track.FilterX.Update(sample.X, dt, m_options.ProcessNoise, m_options.MeasurementNoise);
+        track.FilterY.Update(sample.Y, dt, m_options.ProcessNoise, m_options.MeasurementNoise);
+
+        track.Last = sample;
+        ++track.SampleCount;
+    }
+
+    void PointerPredictor::Remove(uint32_t id) noexcept
+    {
+        size_t const index = FindTrack(id);
+        if (index == PointerTable::npos)
+        {
+            return;
+        }
+
+        // Take the track out of the index, shifting back later entries of the
+        // probe run that would otherwise become unreachable
+        size_t hole = BucketOf(index);
+        for (size_t next = (hole + 1) & m_bucketMask; m_buckets[next] != 0; next = (next + 1) & m_bucketMask)
+        {
+            size_t const home = HomeBucket(m_tracks[m_buckets[next] - 1].Id);
+            if (((next - home) & m_bucketMask) >= ((next - hole) & m_bucketMask))
+            {
+                m_buckets[hole] = m_buckets[next];
+                hole = next;
+            }
+        }
+        m_buckets[hole] = 0;
+
+        // Keep the tracks dense by moving the last one into the hole
+        size_t const last = --m_size;
+        if (index != last)
+        {
+            m_buckets[BucketOf(last)] = static_cast<uint32_t>(index + 1);
+            m_tracks[index] = m_tracks[last];
+        }
+    }
+
+    void PointerPredictor::Clear() noexcept
+    {
+        m_size = 0;
+        std::fill(m_buckets.begin(), m_buckets.end(), 0u);
+    }
+
+    bool PointerPredictor::Predict(Track const& track, double horizon, Point& predicted) const noexcept
+    {
+        if ((m_options.Model == PredictionModel::None) || (track.SampleCount < 2))
+        {
+            return false;
+        }
+
+        double dx;
+        double dy;
+        double baseX;
+        double baseY;
+        if (m_options.Model == PredictionModel::Kalman)
+        {
+            baseX = track.FilterX.Position;
+            baseY = track.FilterY.Position;
+            dx = track.FilterX.Velocity * horizon;
+            dy = track.FilterY.Velocity * horizon;
+        }
+        else
+        {
+            baseX = track.Last.X;
+            baseY = track.Last.Y;
+            dx = track.VelocityX * horizon;
+            dy = track.VelocityY * horizon;
+        }
+
+        // Limit how far ahead of the pointer the indicator can run
+        double const distance = std::sqrt(dx * dx + dy * dy);
+        if (distance > m_options.MaxDistance)
+        {
+            double const scale = m_options.MaxDistance / distance;
+            dx *= scale;
+            dy *= scale;
+        }
+
+        predicted = { static_cast<float>(baseX + dx), static_cast<float>(baseY + dy) };
+        return true;
+    }
+
+    bool PointerPredictor::Predict(uint32_t id, Point& predicted) const noexcept
+    {
+        size_t const index = FindTrack(id);
+        double const horizon = static_cast<double>(m_options.HorizonMicroseconds) * 1.0e-6;
+        return (index != PointerTable::npos) && Predict(m_tracks[index], horizon, predicted);
+    }
+
+    size_t PointerPredictor::Apply(PointerTable& display, uint64_t presentTime) noexcept
+    {
+        size_t applied = 0;
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            // Pointers don't report samples while they rest, so one that hasn't
+            // for a whole gap has stopped. A present time before the last
+            // sample (clock skew) predicts no further than the sample itself.
+            Track const& track = m_tracks[i];
+            uint64_t const elapsed = (presentTime > track.Last.Timestamp) ? presentTime - track.Last.Timestamp : 0;
+            if (elapsed > m_options.MaxSampleGapMicroseconds)
+            {
+                continue;
+            }
+
+            Point predicted;
+            size_t const index = display.Find(track.Id);
+            if ((index != PointerTable::npos) && Predict(track, static_cast<double>(elapsed) * 1.0e-6, predicted))
+            {
+                display.SetPosition(index, predicted);
+                ++applied;
+            }
+        }
+
+        return applied;
+    }
+}
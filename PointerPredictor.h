@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    enum class PredictionModel : uint8_t
+    {
+        None,
+
+        // Extrapolate along a smoothed finite-difference velocity
+        ConstantVelocity,
+
+        // Per-axis constant-velocity Kalman filter
+        Kalman,
+    };
+
+    // Extrapolates pointer positions a short time into the future to hide
+    // input-to-photon latency.
+    //
+    // Predictions are for display only: Apply() writes them into a copy of the
+    // pointer table that is drawn, never into the real pointer state. A pointer
+    // is extrapolated to each frame's present time for as long as its samples
+    // keep coming, and falls back to the real position once none has arrived
+    // for MaxSampleGapMicroseconds, instead of overshooting indefinitely.
+    class PointerPredictor
+    {
+    public:
+        struct Options
+        {
+            PredictionModel Model = PredictionModel::ConstantVelocity;
+
+            // How far ahead of the latest sample Predict() looks; Apply() is
+            // given the present time instead
+            uint32_t HorizonMicroseconds = 16000;
+
+            // Upper bound on the predicted displacement, in DIPs
+            float MaxDistance = 64.0f;
+
+            // ConstantVelocity: weight of the newest velocity estimate, in (0, 1]
+            float VelocitySmoothing = 0.5f;
+
+            // Kalman: process noise (acceleration spectral density, DIPs^2/s^3)
+            // and measurement noise (DIPs^2)
+            float ProcessNoise = 2.0e6f;
+            float MeasurementNoise = 0.25f;
+
+            // Samples further apart than this restart the motion estimate, and
+            // a pointer without a sample for this long has stopped
+            uint32_t MaxSampleGapMicroseconds = 100000;
+        };
+
+        explicit PointerPredictor(size_t capacity = PointerTable::DefaultCapacity);
+        PointerPredictor(Options const& options, size_t capacity = PointerTable::DefaultCapacity);
+
+        Options const& GetOptions() const noexcept { return m_options; }
+        void SetOptions(Options const& options) noexcept { m_options = options; }
+
+        // Feeds a new sample of the pointer's real position
+        void AddSample(uint32_t id, PointerSample const& sample) noexcept;
+
+        // Forgets the pointer's motion history
+        void Remove(uint32_t id) noexcept;
+        void Clear() noexcept;
+
+        // Predicted position of the pointer, or false if it can't be predicted
+        // (unknown, not enough samples, or prediction disabled)
+        bool Predict(uint32_t id, Point& predicted) const noexcept;
+
+        // Replaces the position of every pointer that is still moving with its
+        // prediction for presentTime, in microseconds on the samples' clock.
+        // Returns the number of positions replaced; if non-zero another frame
+        // is needed to settle on the real positions once the pointers stop.
+        size_t Apply(PointerTable& display, uint64_t presentTime) noexcept;
+
+    private:
+        struct AxisFilter
+        {
+            // Estimated position and velocity (DIPs, DIPs/s) and their covariance
+            double Position;
+            double Velocity;
+            double P00;
+            double P01;
+            double P11;
+
+            void Reset(double position) noexcept;
+            void Update(double measurement, double dt, double processNoise, double measurementNoise) noexcept;
+        };
+
+        struct Track
+        {
+            uint32_t Id;
+            uint32_t SampleCount;
+            PointerSample Last;
+
+            // ConstantVelocity state (DIPs/s)
+            float VelocityX;
+            float VelocityY;
+
+            // Kalman state
+            AxisFilter FilterX;
+            AxisFilter FilterY;
+        };
+
+        size_t FindTrack(uint32_t id) const noexcept;
+        size_t HomeBucket(uint32_t id) const noexcept { return static_cast<uint32_t>(id * 2654435769u) >> m_bucketShift; }
+        size_t BucketOf(size_t track) const noexcept;
+        bool Predict(Track const& track, double horizon, Point& predicted) const noexcept;
+
+        Options m_options;
+        size_t m_size{ 0 };
+        std::vector<Track> m_tracks;
+
+        // ID index: track + 1 per bucket, zero when empty, linear probing with
+        // at least twice as many buckets as tracks, like PointerTable's index
+        std::vector<uint32_t> m_buckets;
+        size_t m_bucketMask;
+        uint32_t m_bucketShift;
+    };
+}
@@ -1,17 +1,59 @@
 #include "pch.h"
 #include "PointerRenderer.h"
+#include "PointerScene.h"
+#include "GestureEventArgs.h"
+#include "RegionHoverEventArgs.h"
 #include "PointerRenderer.g.cpp"
 
 namespace winrt::PointerDemo::implementation
 {
     using namespace Windows::Foundation;
     using namespace Windows::UI::Core;
+    using namespace Windows::UI::Input;
     using namespace Windows::UI::Xaml;
     using namespace Windows::UI::Xaml::Controls;
     using namespace Windows::UI::Xaml::Interop;
 
     static std::once_flag s_dependencyPropInitFlag;
 
+    static inline PointerCore::RenderScheduler::TimePoint SchedulerNow() noexcept
+    {
+        return std::chrono::duration_cast<PointerCore::RenderScheduler::TimePoint>(std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    // PointerPoint timestamps count microseconds of the performance counter,
+    // which steady_clock reads too
+    static inline uint64_t InputTimestampNow() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static inline PointerCore::ResizePolicy::Size PixelSize(double width, double height) noexcept
+    {
+        return { std::max(1u, static_cast<UINT>(width)), std::max(1u, static_cast<UINT>(height)) };
+    }
+
+    static inline PointerCore::PointerEvent MakePointerEvent(PointerCore::PointerEventKind kind, PointerPoint const& point)
+    {
+        auto const position = point.Position();
+
+        PointerCore::PointerEvent event{};
+        event.Timestamp = point.Timestamp();
+        event.Id = point.PointerId();
+        event.X = position.X;
+        event.Y = position.Y;
+        event.Pressure = point.Properties().Pressure();
+        event.Kind = kind;
+        event.DeviceKind = static_cast<PointerCore::PointerDeviceKind>(point.PointerDevice().PointerDeviceType());
+        event.InContact = point.IsInContact();
+        return event;
+    }
+
+    static inline PointerCore::PointerSample ToSample(PointerCore::PointerEvent const& event) noexcept
+    {
+        return { event.X, event.Y, event.Timestamp, event.Pressure };
+    }
+
     static inline IAsyncAction SetSwapChainOnPanelAsync(com_ptr<IDXGISwapChain> swapChain, SwapChainPanel panel)
     {
         // Make sure we're on the XAML thread
@@ -27,32 +69,62 @@ namespace winrt::PointerDemo::implementation
         : m_width{ ActualWidth() }
         , m_height{ ActualHeight() }
         , m_readySignal{ ::CreateEventW(nullptr, true, false, nullptr) }
+        , m_wakeSignal{ ::CreateEventW(nullptr, false, false, nullptr) }
     {
         InitializeDependencyProperties();
+        s_timeline.NameThread("XAML");
 
-        // Initialize render thread
-        m_renderThread = std::thread(
-            [this]() 
-            { 
-                init_apartment();
-
-                CreateRenderingResources();
-                RegisterForInputEvents();
-                Run();
-
-                uninit_apartment();
-            });
+        if (s_useSharedRenderService)
+        {
+            // The service's workers draw this panel and input gets its own
+            // thread, so there's nothing to start but the swap chain
+            m_renderService = RenderService::Get();
+            CreateRenderingResources();
+            RegisterForInputEvents();
+            SetEvent(m_readySignal.get());
+
+            m_panelId = m_renderService->Register(this, RenderPriority());
+            m_renderService->RequestFrame(m_panelId);
+        }
+        else
+        {
+            // Initialize render thread
+            m_renderThread = std::thread(
+                [this]() 
+                { 
+                    init_apartment();
+
+                    CreateRenderingResources();
+                    RegisterForInputEvents();
+                    Run();
+
+                    uninit_apartment();
+                });
+        }
 
         m_sizeChangedSubscription = SizeChanged(auto_revoke, [this](auto const&, auto const&) { OnSizeChanged(); });
     }
 
     PointerRenderer::~PointerRenderer()
     {
+        if (m_renderService)
+        {
+            m_renderService->Unregister(m_panelId);
+        }
+
         if (m_renderThread.joinable())
         {
             m_running = false;
+            WakeRenderThread();
             m_renderThread.join();
         }
+
+        if (m_inputThread.joinable())
+        {
+            auto inputDispatcher = m_inputSource.Dispatcher();
+            inputDispatcher.RunAsync(CoreDispatcherPriority::High, [inputDispatcher]() { inputDispatcher.StopProcessEvents(); });
+            m_inputThread.join();
+        }
     }
 
     void PointerRenderer::InitializeDependencyProperties()
@@ -64,6 +136,84 @@ namespace winrt::PointerDemo::implementation
                     xaml_typename<bool>(),
                     xaml_typename<PointerDemo::PointerRenderer>(),
                     PropertyMetadata(box_value(false), { &OnCaptureInputOnPressChanged }));
+
+                s_useInputThreadProperty = DependencyProperty::Register(
+                    L"UseInputThread",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnUseInputThreadChanged }));
+
+                s_recordTraceProperty = DependencyProperty::Register(
+                    L"RecordTrace",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnRecordTraceChanged }));
+
+                s_renderOnDemandProperty = DependencyProperty::Register(
+                    L"RenderOnDemand",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnRenderOnDemandChanged }));
+
+                s_maxFrameRateProperty = DependencyProperty::Register(
+                    L"MaxFrameRate",
+                    xaml_typename<double>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(0.0), { &OnMaxFrameRateChanged }));
+
+                s_predictionHorizonProperty = DependencyProperty::Register(
+                    L"PredictionHorizon",
+                    xaml_typename<double>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(0.0), { &OnPredictionHorizonChanged }));
+
+                s_measureLatencyProperty = DependencyProperty::Register(
+                    L"MeasureLatency",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnMeasureLatencyChanged }));
+
+                s_batchIndicatorsProperty = DependencyProperty::Register(
+                    L"BatchIndicators",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnBatchIndicatorsChanged }));
+
+                s_cursorSpritesProperty = DependencyProperty::Register(
+                    L"CursorSprites",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnCursorSpritesChanged }));
+
+                s_recordStrokesProperty = DependencyProperty::Register(
+                    L"RecordStrokes",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnRecordStrokesChanged }));
+
+                s_recordHeatmapProperty = DependencyProperty::Register(
+                    L"RecordHeatmap",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnRecordHeatmapChanged }));
+
+                s_recordHistoryProperty = DependencyProperty::Register(
+                    L"RecordHistory",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnRecordHistoryChanged }));
+
+                s_adaptiveQualityProperty = DependencyProperty::Register(
+                    L"AdaptiveQuality",
+                    xaml_typename<bool>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(false), { &OnAdaptiveQualityChanged }));
+
+                s_renderPriorityProperty = DependencyProperty::Register(
+                    L"RenderPriority",
+                    xaml_typename<int32_t>(),
+                    xaml_typename<PointerDemo::PointerRenderer>(),
+                    PropertyMetadata(box_value(0), { &OnRenderPriorityChanged }));
             });
     }
 
@@ -72,54 +222,327 @@ namespace winrt::PointerDemo::implementation
         target.as<implementation::PointerRenderer>()->SetCaptureInputOnPress(unbox_value<bool>(args.NewValue()));
     }
 
+    void PointerRenderer::OnUseInputThreadChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // Only read when the render thread registers for input, later changes don't take effect
+        target.as<implementation::PointerRenderer>()->m_useInputThread = unbox_value<bool>(args.NewValue());
+    }
+
+    void PointerRenderer::OnRecordTraceChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        target.as<implementation::PointerRenderer>()->SetRecordTrace(unbox_value<bool>(args.NewValue()));
+    }
+
+    void PointerRenderer::OnRenderOnDemandChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_renderOnDemand = unbox_value<bool>(args.NewValue());
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnMaxFrameRateChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_maxFrameRate = std::max(0.0, unbox_value<double>(args.NewValue()));
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnPredictionHorizonChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_predictionHorizon = std::max(0.0, unbox_value<double>(args.NewValue()));
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnMeasureLatencyChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        target.as<implementation::PointerRenderer>()->SetMeasureLatency(unbox_value<bool>(args.NewValue()));
+    }
+
+    void PointerRenderer::OnBatchIndicatorsChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        target.as<implementation::PointerRenderer>()->m_batchIndicators = unbox_value<bool>(args.NewValue());
+    }
+
+    void PointerRenderer::OnCursorSpritesChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_cursorSprites = unbox_value<bool>(args.NewValue());
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnRecordStrokesChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // Strokes in progress are finished by their release as usual
+        target.as<implementation::PointerRenderer>()->m_recordStrokes = unbox_value<bool>(args.NewValue());
+    }
+
+    void PointerRenderer::OnRecordHeatmapChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // The render thread clears the heatmap on its next frame
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_recordHeatmap = unbox_value<bool>(args.NewValue());
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnRecordHistoryChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // Turning it off keeps what was recorded so far for SaveHistory()
+        target.as<implementation::PointerRenderer>()->m_recordHistory = unbox_value<bool>(args.NewValue());
+    }
+
+    void PointerRenderer::OnAdaptiveQualityChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // The render thread starts or stops governing on its next frame
+        auto renderer = target.as<implementation::PointerRenderer>();
+        renderer->m_adaptiveQuality = unbox_value<bool>(args.NewValue());
+        renderer->WakeRenderThread();
+    }
+
+    void PointerRenderer::OnRenderPriorityChanged(DependencyObject const& target, DependencyPropertyChangedEventArgs const& args)
+    {
+        // Only matters to the render service, a panel with its own thread has nothing to compete with
+        auto renderer = target.as<implementation::PointerRenderer>();
+        if (renderer->m_renderService)
+        {
+            renderer->m_renderService->SetPriority(renderer->m_panelId, unbox_value<int32_t>(args.NewValue()));
+        }
+    }
+
     void PointerRenderer::Run() noexcept
     {
         // Signal that the render thread has begun
         SetEvent(m_readySignal.get());
+        s_timeline.NameThread("Render");
 
         // Run
         while (m_running)
         {
-            // Pump input
-            m_inputSource.Dispatcher().ProcessEvents(CoreProcessEventsOption::ProcessAllIfPresent);
+            // Pump input, unless the input thread is doing that for us
+            if (!m_inputThreadActive)
+            {
+                PointerCore::TimelineSpan span{ s_timeline, "ProcessEvents" };
+                m_inputSource.Dispatcher().ProcessEvents(CoreProcessEventsOption::ProcessAllIfPresent);
+            }
+
+            // Sleep until there's a frame to render
+            auto const decision = NextFrameDecision();
+            if (decision.Action != PointerCore::RenderScheduler::FrameAction::Render)
+            {
+                WaitForWork(decision);
+                continue;
+            }
+
+            RenderFrame(INFINITE);
+        }
+    }
+
+    PointerCore::RenderScheduler::Decision PointerRenderer::RenderSharedFrame() noexcept
+    {
+        auto decision = NextFrameDecision();
+        if (decision.Action != PointerCore::RenderScheduler::FrameAction::Render)
+        {
+            return decision;
+        }
+
+        // Don't hold up the other panels waiting for this swap chain
+        if (!RenderFrame(0))
+        {
+            return { PointerCore::RenderScheduler::FrameAction::WaitUntil, SchedulerNow() + std::chrono::milliseconds(1) };
+        }
+
+        return NextFrameDecision();
+    }
+
+    PointerCore::RenderScheduler::Decision PointerRenderer::NextFrameDecision() noexcept
+    {
+        // Pick up frame requests and settings from the other threads
+        if (m_frameRequested.exchange(false))
+        {
+            m_renderScheduler.RequestFrame();
+        }
+        m_renderScheduler.SetOptions({ m_renderOnDemand, m_maxFrameRate });
+
+        auto const now = SchedulerNow();
+        auto decision = m_renderScheduler.Next(now);
+
+        // A resize that hasn't settled needs a frame once it has, even if
+        // nothing else does
+        if ((decision.Action != PointerCore::RenderScheduler::FrameAction::Render) && !m_resizePolicy.IsSettled())
+        {
+            auto const settleTime = m_resizePolicy.SettleDeadline();
+            if (settleTime <= now)
+            {
+                m_renderScheduler.RequestFrame();
+                decision = m_renderScheduler.Next(now);
+            }
+            else if ((decision.Action == PointerCore::RenderScheduler::FrameAction::Idle) || (settleTime < decision.WakeTime))
+            {
+                decision = { PointerCore::RenderScheduler::FrameAction::WaitUntil, settleTime };
+            }
+        }
+
+        return decision;
+    }
+
+    bool PointerRenderer::RenderFrame(DWORD frameReadyTimeout) noexcept
+    {
+        // If we've got a frame ready signal, wait for it to be
+        // set before beginning the render work
+        {
+            PointerCore::TimelineSpan span{ s_timeline, "WaitFrameReady" };
+            if (m_frameReadySignal && (::WaitForSingleObject(m_frameReadySignal.get(), frameReadyTimeout) != WAIT_OBJECT_0))
+            {
+                return false;
+            }
+        }
+
+        PointerCore::TimelineSpan frameSpan{ s_timeline, "Frame" };
 
-            // If we've got a frame ready signal, wait for it to be
-            // set before beginning the render work
-            if (m_frameReadySignal)
+        auto const frameStart = SchedulerNow();
+        m_renderScheduler.OnFrameStarted();
+
+        // Input times left over from before measuring started would skew the stats
+        bool const measure = m_instrumentation.IsEnabled();
+        if (measure && !m_measuredLastFrame)
+        {
+            for (size_t i = 0; i < m_currentPointers.Size(); ++i)
             {
-                ::WaitForSingleObject(m_frameReadySignal.get(), INFINITE);
+                m_currentPointers.SetPendingInputTime(i, 0);
             }
+            m_lastFrameStartTime = 0;
+        }
+        m_measuredLastFrame = measure;
+
+        uint64_t const frameStartTime = measure ? PointerCore::FrameInstrumentation::Now() : 0;
+        m_instrumentation.RecordInterval(PointerCore::FrameInstrumentation::Metric::FrameInterval, m_lastFrameStartTime, frameStartTime);
+        m_lastFrameStartTime = frameStartTime;
+
+        // Pick up the input thread's latest snapshot
+        if (m_inputThreadActive)
+        {
+            AcquireSnapshot();
+        }
+
+        // Resize the swap chain if the panel's size changed
+        ApplyPendingResize();
+
+        // Fold the moves received since the last frame into the pointer state
+        {
+            PointerCore::TimelineSpan span{ s_timeline, "FlushMoves" };
+            m_moveCoalescer.Flush(m_currentPointers);
+        }
+        UpdateRegionHover();
+        UpdateGestures();
+        UpdateHeatmap();
 
-            // Grab latest frame
-            com_ptr<IDXGISurface> currentSurface;
+        // Grab latest frame
+        com_ptr<IDXGISurface> currentSurface;
+        {
+            PointerCore::TimelineSpan span{ s_timeline, "GetBuffer" };
             check_hresult(m_swapChain->GetBuffer(0, IID_PPV_ARGS(currentSurface.put())));
+        }
+
+        // Render whatever changed since this buffer was last drawn
+        auto const costStart = SchedulerNow();
+        uint64_t const renderStartTime = measure ? PointerCore::FrameInstrumentation::Now() : 0;
+        PointerCore::Rect inkChanged;
+        if (m_inkTessellator.Update((m_snapshotStrokes != nullptr) ? *m_snapshotStrokes : m_strokes, inkChanged))
+        {
+            m_damageTracker.AddDamage(inkChanged);
+        }
+
+        UpdateCursorSprites();
+        auto const& displayPointers = UpdateDisplayPointers();
+        auto const& repaintRegion = m_damageTracker.Update(displayPointers);
+        Render(currentSurface.get(), displayPointers, repaintRegion);
+
+        // Present
+        uint64_t const presentStartTime = measure ? PointerCore::FrameInstrumentation::Now() : 0;
+        Present();
+        m_renderScheduler.OnFrameRendered(frameStart);
+        UpdateGovernor(SchedulerNow() - costStart);
+
+        if (measure)
+        {
+            uint64_t const presentEndTime = PointerCore::FrameInstrumentation::Now();
+            m_instrumentation.RecordInterval(PointerCore::FrameInstrumentation::Metric::Render, renderStartTime, presentStartTime);
+            m_instrumentation.RecordInterval(PointerCore::FrameInstrumentation::Metric::Present, presentStartTime, presentEndTime);
+            RecordInputLatency(presentEndTime);
+        }
+
+        return true;
+    }
+
+    void PointerRenderer::WaitForWork(PointerCore::RenderScheduler::Decision const& decision)
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "WaitForWork" };
+
+        using PointerCore::RenderScheduler;
+
+        if ((decision.Action == RenderScheduler::FrameAction::Idle) && !m_inputThreadActive)
+        {
+            // Input arrives through our own dispatcher, so block in it until
+            // something shows up (WakeRenderThread() posts to it as well)
+            m_inputSource.Dispatcher().ProcessEvents(CoreProcessEventsOption::ProcessOneAndAllPending);
+            return;
+        }
+
+        DWORD timeout = INFINITE;
+        if (decision.Action == RenderScheduler::FrameAction::WaitUntil)
+        {
+            auto const remaining = std::chrono::ceil<std::chrono::milliseconds>(decision.WakeTime - SchedulerNow());
+            timeout = static_cast<DWORD>(std::max<int64_t>(remaining.count(), 0));
+        }
+
+        ::WaitForSingleObject(m_wakeSignal.get(), timeout);
+    }
+
+    void PointerRenderer::WakeRenderThread()
+    {
+        m_frameRequested = true;
+        if (m_renderService)
+        {
+            m_renderService->RequestFrame(m_panelId);
+            return;
+        }
 
-            // Render pointers
-            Render(currentSurface.get());
+        SetEvent(m_wakeSignal.get());
 
-            // Present
-            check_hresult(m_swapChain->Present(0, 0));
+        // When the render thread pumps its own input it may be blocked in
+        // ProcessEvents instead, so post something for it to process. Before the
+        // render thread is ready it isn't waiting on anything yet.
+        if (::WaitForSingleObject(m_readySignal.get(), 0) == WAIT_OBJECT_0 && !m_inputThreadActive)
+        {
+            m_inputSource.Dispatcher().RunAsync(CoreDispatcherPriority::Normal, []() {});
         }
     }
 
     void PointerRenderer::CreateRenderingResources()
     {
-        // Create D3D device
-        UINT d3dFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        // Create D3D device, or use the render service's
+        if (m_renderService)
+        {
+            m_d3dDevice = m_renderService->D3DDevice();
+        }
+        else
+        {
+            UINT d3dFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 #ifdef _DEBUG
-        d3dFlags |= D3D11_CREATE_DEVICE_DEBUG;
+            d3dFlags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
-        check_hresult(D3D11CreateDevice(
-            nullptr,
-            D3D_DRIVER_TYPE_HARDWARE,
-            nullptr,
-            d3dFlags,
-            nullptr,
-            0,
-            D3D11_SDK_VERSION,
-            m_d3dDevice.put(),
-            nullptr,
-            nullptr));
+            check_hresult(D3D11CreateDevice(
+                nullptr,
+                D3D_DRIVER_TYPE_HARDWARE,
+                nullptr,
+                d3dFlags,
+                nullptr,
+                0,
+                D3D11_SDK_VERSION,
+                m_d3dDevice.put(),
+                nullptr,
+                nullptr));
+        }
 
         // Create DXGI swap chain
         UINT dxgiFlags = 0;
@@ -130,9 +553,10 @@ namespace winrt::PointerDemo::implementation
         check_hresult(CreateDXGIFactory2(dxgiFlags, IID_PPV_ARGS(factory.put())));
 
         DXGI_SWAP_CHAIN_DESC1 swapChainDesc{};
-        swapChainDesc.BufferCount = 2;
-        swapChainDesc.Width = std::max(1u, static_cast<UINT>(m_width));
-        swapChainDesc.Height = std::max(1u, static_cast<UINT>(m_height));
+        swapChainDesc.BufferCount = m_bufferCount;
+        auto const initialSize = PixelSize(m_width, m_height);
+        swapChainDesc.Width = initialSize.Width;
+        swapChainDesc.Height = initialSize.Height;
         swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
         swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
         swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
@@ -142,6 +566,12 @@ namespace winrt::PointerDemo::implementation
         swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
         check_hresult(factory->CreateSwapChainForComposition(m_d3dDevice.get(), &swapChainDesc, nullptr, m_swapChain.put()));
         m_frameReadySignal = handle{ m_swapChain.as<IDXGISwapChain2>()->GetFrameLatencyWaitableObject() };
+        m_damageTracker.Resize(static_cast<int32_t>(swapChainDesc.Width), static_cast<int32_t>(swapChainDesc.Height));
+        m_resizePolicy.Reset(initialSize);
+        {
+            std::lock_guard lock{ m_regionLock };
+            m_regions.Resize(static_cast<float>(m_width), static_cast<float>(m_height));
+        }
 
         // Set the swap chain for the XAML panel
         //
@@ -156,17 +586,52 @@ namespace winrt::PointerDemo::implementation
         WaitForSingleObject(swapChainSyncEvent.get(), INFINITE);
 
         // Create D2D context
-        com_ptr<ID2D1Factory1> d2dFactory;
-        check_hresult(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, d2dFactory.put()));
-        check_hresult(d2dFactory->CreateDevice(m_d3dDevice.as<IDXGIDevice>().get(), m_d2dDevice.put()));
+        if (m_renderService)
+        {
+            m_d2dDevice = m_renderService->D2DDevice();
+        }
+        else
+        {
+            com_ptr<ID2D1Factory1> d2dFactory;
+            check_hresult(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, d2dFactory.put()));
+            check_hresult(d2dFactory->CreateDevice(m_d3dDevice.as<IDXGIDevice>().get(), m_d2dDevice.put()));
+        }
         check_hresult(m_d2dDevice->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, m_d2dDeviceContext.put()));
 
-        // Create D2D resources
-        check_hresult(m_d2dDeviceContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Blue), m_hoverBrush.put()));
-        check_hresult(m_d2dDeviceContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Red), m_pressedBrush.put()));        
+        // Create the backend the scene is drawn through
+        m_renderBackend = std::make_unique<D2DRenderBackend>(m_d2dDeviceContext, s_timeline);
     }
 
     void PointerRenderer::RegisterForInputEvents()
+    {
+        // The render service's workers don't pump input, so shared panels always get an input thread
+        if (!m_useInputThread && !m_renderService)
+        {
+            CreateInputSource();
+            return;
+        }
+
+        // Host the input source on its own thread so input handling is never
+        // held up by rendering. The render thread sees the results through m_snapshots.
+        m_inputThreadActive = true;
+
+        handle inputReadySignal{ ::CreateEventW(nullptr, false, false, nullptr) };
+        m_inputThread = std::thread(
+            [this, &inputReadySignal]()
+            {
+                init_apartment();
+                s_timeline.NameThread("Input");
+
+                CreateInputSource();
+                SetEvent(inputReadySignal.get());
+                m_inputSource.Dispatcher().ProcessEvents(CoreProcessEventsOption::ProcessUntilQuit);
+
+                uninit_apartment();
+            });
+        WaitForSingleObject(inputReadySignal.get(), INFINITE);
+    }
+
+    void PointerRenderer::CreateInputSource()
     {
         m_inputSource = CreateCoreIndependentInputSource(CoreInputDeviceTypes::Mouse | CoreInputDeviceTypes::Pen | CoreInputDeviceTypes::Touch);
         m_pointerEnteredSubscription = m_inputSource.PointerEntered(auto_revoke, [this](auto const&, auto const& args) { OnPointerEntered(args); });
@@ -176,8 +641,35 @@ namespace winrt::PointerDemo::implementation
         m_pointerReleasedSubscription = m_inputSource.PointerReleased(auto_revoke, [this](auto const&, auto const& args) { OnPointerReleased(args); });
     }
 
-    void PointerRenderer::Render(IDXGISurface* renderTarget)
+    PointerCore::PointerTable const& PointerRenderer::UpdateDisplayPointers()
+    {
+        double const horizonMilliseconds = m_predictionHorizon;
+        if ((horizonMilliseconds <= 0.0) || (m_frameSettings.Effects == PointerCore::FrameGovernor::EffectsLevel::Minimal))
+        {
+            return m_currentPointers;
+        }
+
+        auto const horizon = static_cast<uint32_t>(horizonMilliseconds * 1000.0);
+        auto options = m_predictor.GetOptions();
+        options.HorizonMicroseconds = horizon;
+        m_predictor.SetOptions(options);
+
+        // Draw positions predicted for when this frame reaches the screen, the
+        // pointer state keeps the real ones. Once pointers stop moving, one
+        // more frame is needed to settle back onto them.
+        m_displayPointers = m_currentPointers;
+        if (m_predictor.Apply(m_displayPointers, InputTimestampNow() + horizon) > 0)
+        {
+            m_renderScheduler.RequestFrame();
+        }
+
+        return m_displayPointers;
+    }
+
+    void PointerRenderer::Render(IDXGISurface* renderTarget, PointerCore::PointerTable const& pointers, PointerCore::DamageRegion const& region)
     {
+        PointerCore::TimelineSpan span{ s_timeline, "Render" };
+
         // Setup the DXGI back buffer as a D2D1 bitmap render target
         auto& bitmap = m_swapChainSurfaceBitmaps[renderTarget];
         if (bitmap == nullptr)
@@ -189,130 +681,187 @@ namespace winrt::PointerDemo::implementation
         }
         m_d2dDeviceContext->SetTarget(bitmap.get());
 
-        // Draw the scene
+        // Draw the scene. Below full effects, indicators are always batched.
+        if (m_drawingCursorSprites)
+        {
+            PointerCore::PointerScene::DrawCursors(*m_renderBackend, pointers, region, m_cursorAtlas, m_cursorSpriteInstances, &m_inkTessellator);
+        }
+        else if (m_batchIndicators || (m_frameSettings.Effects != PointerCore::FrameGovernor::EffectsLevel::Full))
+        {
+            PointerCore::PointerScene::DrawBatched(*m_renderBackend, pointers, region, m_indicatorBatch, &m_inkTessellator);
+        }
+        else
         {
-            m_d2dDeviceContext->BeginDraw();
+            PointerCore::PointerScene::Draw(*m_renderBackend, pointers, region, &m_inkTessellator);
+        }
+    }
 
-            // Clear the background
-            m_d2dDeviceContext->Clear(D2D1::ColorF(D2D1::ColorF::Black));
+    void PointerRenderer::UpdateCursorSprites()
+    {
+        bool const cursorSprites = m_cursorSprites;
+        bool changed = (cursorSprites != m_drawingCursorSprites);
+        m_drawingCursorSprites = cursorSprites;
 
-            // Draw an indicator for each position
-            for (auto const& [id, pointerData] : m_currentPointers)
-            {
-                auto pointerRect = D2D1::RectF(
-                    pointerData.m_currentPosition.X - 20,   // left
-                    pointerData.m_currentPosition.Y - 20,   // top
-                    pointerData.m_currentPosition.X + 20,   // right
-                    pointerData.m_currentPosition.Y + 20);  // bottom
-
-                m_d2dDeviceContext->FillRectangle(
-                    pointerRect,
-                    pointerData.m_pressed ? m_pressedBrush.get() : m_hoverBrush.get());
-            }
+        // Only rasterizes the first time, or if the scale ever changes
+        if (cursorSprites && m_cursorAtlas.Build(1.0f))
+        {
+            changed = true;
+        }
 
-            check_hresult(m_d2dDeviceContext->EndDraw());
+        // Pointers that didn't move would keep their old look
+        if (changed)
+        {
+            m_damageTracker.InvalidateAll();
         }
     }
 
-    fire_and_forget PointerRenderer::OnSizeChanged()
+    void PointerRenderer::Present()
     {
-        // Grab the new width & height
-        auto newWidth = ActualWidth();
-        auto newHeight = ActualHeight();
-
-        // Ensure the render thread has started up
-        co_await resume_on_signal(m_readySignal.get());
+        PointerCore::TimelineSpan span{ s_timeline, "Present" };
 
-        // Switch from the XAML thread to the render thread
-        co_await resume_foreground(m_inputSource.Dispatcher());
-
-        // Resize the swap chain (if needed)
-        if (newWidth != m_width || newHeight != m_height)
+        auto const& frameDamage = m_damageTracker.FrameDamage();
+        if (frameDamage.Full)
         {
-            // Release any lingering references to the swap chain buffers
-            m_d2dDeviceContext->SetTarget(nullptr);
-            m_swapChainSurfaceBitmaps.clear();
+            check_hresult(m_swapChain->Present(m_frameSettings.PresentInterval, 0));
+            return;
+        }
 
-            check_hresult(m_swapChain->ResizeBuffers(
-                2,
-                std::max(1u, static_cast<UINT>(newWidth)),
-                std::max(1u, static_cast<UINT>(newHeight)),
-                DXGI_FORMAT_UNKNOWN,
-                DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT));
+        // Tell the compositor which parts of the surface changed
+        m_dirtyRects.clear();
+        for (auto const& rect : frameDamage.Rects)
+        {
+            m_dirtyRects.push_back({ rect.Left, rect.Top, rect.Right, rect.Bottom });
+        }
 
-            m_width = newWidth;
-            m_height = newHeight;
+        // An empty list means the whole surface, so for a frame without changes
+        // report a single pixel instead (its contents are unchanged as well)
+        if (m_dirtyRects.empty())
+        {
+            m_dirtyRects.push_back({ 0, 0, 1, 1 });
         }
+
+        DXGI_PRESENT_PARAMETERS presentParameters{};
+        presentParameters.DirtyRectsCount = static_cast<UINT>(m_dirtyRects.size());
+        presentParameters.pDirtyRects = m_dirtyRects.data();
+        check_hresult(m_swapChain->Present1(m_frameSettings.PresentInterval, 0, &presentParameters));
     }
 
-    void PointerRenderer::OnPointerEntered(PointerEventArgs const& args)
+    void PointerRenderer::OnSizeChanged()
     {
-        auto currentPoint = args.CurrentPoint();
+        PointerCore::TimelineSpan span{ s_timeline, "OnSizeChanged" };
 
-        PointerData newPointer{};
-        newPointer.m_type = currentPoint.PointerDevice().PointerDeviceType();
-        newPointer.m_pressed = currentPoint.IsInContact();
-        newPointer.m_currentPosition = currentPoint.Position();
-
-        // Insert the new pointer into our list
-        auto const [_, inserted] = m_currentPointers.insert({ currentPoint.PointerId(), newPointer });
-        if (!inserted)
+        // Hand the new size to the render thread, which applies the latest one
+        // at the start of its next frame
         {
-            throw hresult_illegal_state_change(L"A pointer with that ID already exists in the map");
+            std::lock_guard lock{ m_pendingSizeLock };
+            m_pendingWidth = ActualWidth();
+            m_pendingHeight = ActualHeight();
+            m_resizePending = true;
         }
 
-        args.Handled(true);
+        WakeRenderThread();
     }
 
-    void PointerRenderer::OnPointerExited(PointerEventArgs const& args)
+    void PointerRenderer::ApplyPendingResize()
     {
-        auto currentPoint = args.CurrentPoint();
+        PointerCore::TimelineSpan span{ s_timeline, "ApplyPendingResize" };
 
-        auto itr = m_currentPointers.find(currentPoint.PointerId());
-        if (itr != m_currentPointers.end())
+        auto const now = SchedulerNow();
         {
-            m_currentPointers.erase(currentPoint.PointerId());
-        }
-        else
+            std::lock_guard lock{ m_pendingSizeLock };
+            if (m_resizePending)
+            {
+                m_resizePolicy.Request(PixelSize(m_pendingWidth, m_pendingHeight), now);
+                m_resizePending = false;
+
+                if (m_pendingWidth != m_width || m_pendingHeight != m_height)
+                {
+                    m_width = m_pendingWidth;
+                    m_height = m_pendingHeight;
+
+                    std::lock_guard regionLock{ m_regionLock };
+                    m_regions.Resize(static_cast<float>(m_width), static_cast<float>(m_height));
+                }
+            }
+        }
+
+        // Most frames of a resize only change which part of the buffers is shown
+        auto const resize = m_resizePolicy.Update(now);
+        if (resize.Action == PointerCore::ResizePolicy::ResizeAction::None)
         {
-            OutputDebugStringW(L"Untracked pointer exit\n");
+            return;
+        }
+
+        if (resize.Action == PointerCore::ResizePolicy::ResizeAction::Reallocate)
+        {
+            // Release any lingering references to the swap chain buffers
+            m_d2dDeviceContext->SetTarget(nullptr);
+            m_swapChainSurfaceBitmaps.clear();
+
+            check_hresult(m_swapChain->ResizeBuffers(
+                m_bufferCount,
+                resize.Buffers.Width,
+                resize.Buffers.Height,
+                DXGI_FORMAT_UNKNOWN,
+                DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT));
         }
 
+        // Only the top-left part of the buffers reaches the panel; whatever
+        // of the panel it doesn't cover is letterboxed until the next reallocation
+        check_hresult(m_swapChain.as<IDXGISwapChain2>()->SetSourceSize(resize.Visible.Width, resize.Visible.Height));
+
+        // The newly visible part has to be drawn in full
+        m_damageTracker.Resize(static_cast<int32_t>(resize.Visible.Width), static_cast<int32_t>(resize.Visible.Height));
+    }
+
+    void PointerRenderer::OnPointerEntered(PointerEventArgs const& args)
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "OnPointerEntered" };
+
+        DispatchPointerEvent(MakePointerEvent(PointerCore::PointerEventKind::Entered, args.CurrentPoint()));
+
         args.Handled(true);
     }
 
-    void PointerRenderer::OnPointerMoved(PointerEventArgs const& args)
+    void PointerRenderer::OnPointerExited(PointerEventArgs const& args)
     {
+        PointerCore::TimelineSpan span{ s_timeline, "OnPointerExited" };
+
         auto currentPoint = args.CurrentPoint();
 
-        auto itr = m_currentPointers.find(currentPoint.PointerId());
-        if (itr == m_currentPointers.end())
+        DispatchPointerEvent(MakePointerEvent(PointerCore::PointerEventKind::Exited, currentPoint));
+
+        auto pressedItr = std::find(m_pressedPointerIds.begin(), m_pressedPointerIds.end(), currentPoint.PointerId());
+        if (pressedItr != m_pressedPointerIds.end())
         {
-            throw hresult_illegal_state_change(L"An untracked pointer was moved");
+            m_pressedPointerIds.erase(pressedItr);
         }
 
-        itr->second.m_currentPosition = currentPoint.Position();
+        args.Handled(true);
+    }
+
+    void PointerRenderer::OnPointerMoved(PointerEventArgs const& args)
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "OnPointerMoved" };
+
+        DispatchPointerEvent(MakePointerEvent(PointerCore::PointerEventKind::Moved, args.CurrentPoint()));
 
         args.Handled(true);
     }
 
     void PointerRenderer::OnPointerPressed(PointerEventArgs const& args)
     {
+        PointerCore::TimelineSpan span{ s_timeline, "OnPointerPressed" };
+
         auto currentPoint = args.CurrentPoint();
 
-        if (!currentPoint.IsInContact())
-        {
-            throw hresult_illegal_state_change(L"A pressed pointer is reporting as not pressed");
-        }
+        DispatchPointerEvent(MakePointerEvent(PointerCore::PointerEventKind::Pressed, currentPoint));
 
-        auto itr = m_currentPointers.find(currentPoint.PointerId());
-        if (itr == m_currentPointers.end())
+        if (std::find(m_pressedPointerIds.begin(), m_pressedPointerIds.end(), currentPoint.PointerId()) == m_pressedPointerIds.end())
         {
-            throw hresult_illegal_state_change(L"An untracked pointer was pressed");
+            m_pressedPointerIds.push_back(currentPoint.PointerId());
         }
 
-        itr->second.m_pressed = true;
-
         // Handle system capture if enabled
         if (m_captureOnPress && !m_inputSource.HasCapture())
         {
@@ -324,24 +873,20 @@ namespace winrt::PointerDemo::implementation
 
     void PointerRenderer::OnPointerReleased(PointerEventArgs const& args)
     {
+        PointerCore::TimelineSpan span{ s_timeline, "OnPointerReleased" };
+
         auto currentPoint = args.CurrentPoint();
 
-        if (currentPoint.IsInContact())
-        {
-            throw hresult_illegal_state_change(L"A released pointer is reporting as pressed");
-        }
+        DispatchPointerEvent(MakePointerEvent(PointerCore::PointerEventKind::Released, currentPoint));
 
-        auto itr = m_currentPointers.find(currentPoint.PointerId());
-        if (itr == m_currentPointers.end())
+        auto pressedItr = std::find(m_pressedPointerIds.begin(), m_pressedPointerIds.end(), currentPoint.PointerId());
+        if (pressedItr != m_pressedPointerIds.end())
         {
-            throw hresult_illegal_state_change(L"An untracked pointer was released");
+            m_pressedPointerIds.erase(pressedItr);
         }
 
-        itr->second.m_pressed = false;
-
         // If all pointers have been released, release the system capture
-        bool allReleased = std::any_of(m_currentPointers.begin(), m_currentPointers.end(), [&](auto const& pointerData) { return !pointerData.second.m_pressed; });
-        if (m_inputSource.HasCapture() && allReleased)
+        if (m_inputSource.HasCapture() && m_pressedPointerIds.empty())
         {
             m_inputSource.ReleasePointerCapture();
         }
@@ -349,6 +894,271 @@ namespace winrt::PointerDemo::implementation
         args.Handled(true);
     }
 
+    void PointerRenderer::DispatchPointerEvent(PointerCore::PointerEvent event)
+    {
+        if (m_instrumentation.IsEnabled())
+        {
+            event.ReceivedTime = PointerCore::FrameInstrumentation::Now();
+        }
+
+        if (m_traceWriter.IsOpen())
+        {
+            m_traceWriter.Write(event);
+        }
+
+        if (!m_inputThreadActive)
+        {
+            // We're on the render thread, apply directly
+            ApplyPointerEvent(event);
+        }
+        else
+        {
+            PublishPointerEvent(event);
+        }
+
+        // Any input may change the scene. The render thread only needs waking
+        // when it isn't the one handling input, and only after the new
+        // snapshot is out, or it could render the previous one and go back to sleep.
+        if (!m_frameRequested.exchange(true) && m_inputThreadActive)
+        {
+            if (m_renderService)
+            {
+                m_renderService->RequestFrame(m_panelId);
+            }
+            else
+            {
+                SetEvent(m_wakeSignal.get());
+            }
+        }
+    }
+
+    void PointerRenderer::PublishPointerEvent(PointerCore::PointerEvent const& event)
+    {
+        m_pointerLifecycle.Process(event, [this](PointerCore::PointerEvent const& validEvent)
+        {
+            RecognizeGesture(validEvent);
+            QueueHeatmapSample(validEvent);
+            AppendHistory(validEvent);
+            m_snapshots.Apply(validEvent, m_recordStrokes);
+        });
+        m_snapshots.Publish();
+        ReportPointerAnomalies();
+    }
+
+    void PointerRenderer::AcquireSnapshot()
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "AcquireSnapshot" };
+
+        if (!m_snapshots.HasUpdate())
+        {
+            return;
+        }
+
+        auto const& snapshot = m_snapshots.Acquire();
+        auto const& pointers = snapshot.Pointers;
+
+        // The predictor gets one sample per snapshot rather than every event
+        for (size_t i = 0; i < m_currentPointers.Size(); ++i)
+        {
+            if (pointers.Find(m_currentPointers.Id(i)) == PointerCore::PointerTable::npos)
+            {
+                m_predictor.Remove(m_currentPointers.Id(i));
+            }
+        }
+
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            size_t const previous = m_currentPointers.Find(pointers.Id(i));
+            if (previous == PointerCore::PointerTable::npos)
+            {
+                m_predictor.Remove(pointers.Id(i));
+            }
+
+            if ((previous == PointerCore::PointerTable::npos) || (m_currentPointers.Timestamp(previous) != pointers.Timestamp(i)))
+            {
+                auto const position = pointers.Position(i);
+                m_predictor.AddSample(pointers.Id(i), { position.X, position.Y, pointers.Timestamp(i), pointers.Pressure(i) });
+            }
+        }
+
+        // Render-side state (pending input times, region hover) works on a copy
+        m_currentPointers = pointers;
+        m_snapshotStrokes = &snapshot.Strokes;
+    }
+
+    void PointerRenderer::ReportPointerAnomalies()
+    {
+        auto const anomalyCount = m_pointerLifecycle.TotalAnomalies();
+        if (anomalyCount != m_reportedAnomalyCount)
+        {
+            OutputDebugStringW(L"Out of order pointer events were corrected or dropped\n");
+            m_reportedAnomalyCount = anomalyCount;
+        }
+    }
+
+    void PointerRenderer::ApplyPointerEvent(PointerCore::PointerEvent const& event)
+    {
+        // Out of order events are fixed up (or dropped) by the lifecycle, so
+        // everything below sees a valid sequence per pointer
+        m_pointerLifecycle.Process(event, [this](PointerCore::PointerEvent const& validEvent)
+        {
+            RecognizeGesture(validEvent);
+            QueueHeatmapSample(validEvent);
+            AppendHistory(validEvent);
+            ApplyValidPointerEvent(validEvent);
+        });
+        ReportPointerAnomalies();
+    }
+
+    void PointerRenderer::ApplyValidPointerEvent(PointerCore::PointerEvent const& event)
+    {
+        using PointerCore::PointerEventKind;
+        using PointerCore::PointerTable;
+
+        switch (event.Kind)
+        {
+        case PointerEventKind::Entered:
+        {
+            // Insert the new pointer into our table
+            m_predictor.Remove(event.Id);
+            auto index = m_currentPointers.Insert(event.Id, event.DeviceKind, event.InContact, { event.X, event.Y });
+            if (index == PointerTable::npos)
+            {
+                OutputDebugStringW(L"Pointer table is full, ignoring new pointer\n");
+                m_pointerLifecycle.Forget(event.Id);
+                break;
+            }
+
+            m_currentPointers.SetPressure(index, event.Pressure);
+            m_currentPointers.SetTimestamp(index, event.Timestamp);
+            MarkPendingInput(index, event);
+            break;
+        }
+
+        case PointerEventKind::Exited:
+        {
+            m_moveCoalescer.Remove(event.Id);
+            m_predictor.Remove(event.Id);
+            m_strokes.End(event.Id);
+            if (!m_currentPointers.Erase(event.Id))
+            {
+                OutputDebugStringW(L"Untracked pointer exit\n");
+            }
+            break;
+        }
+
+        case PointerEventKind::Moved:
+        {
+            auto index = m_currentPointers.Find(event.Id);
+            if (index == PointerTable::npos)
+            {
+                break;
+            }
+
+            // Defer the state update to the next frame. If the coalescer is out of
+            // slots, fall back to updating the table directly.
+            if (!m_moveCoalescer.AddMove(event.Id, ToSample(event)))
+            {
+                m_currentPointers.SetPosition(index, { event.X, event.Y });
+                m_currentPointers.SetPressure(index, event.Pressure);
+            }
+
+            m_predictor.AddSample(event.Id, ToSample(event));
+            m_strokes.Append(event.Id, ToSample(event));
+            MarkPendingInput(index, event);
+            break;
+        }
+
+        case PointerEventKind::Pressed:
+        {
+            auto index = m_currentPointers.Find(event.Id);
+            if (index == PointerTable::npos)
+            {
+                break;
+            }
+
+            // The press is newer than any move still waiting for the next frame
+            m_moveCoalescer.DiscardPending(event.Id);
+            m_currentPointers.SetPressed(index, true);
+            m_currentPointers.SetPosition(index, { event.X, event.Y });
+            m_currentPointers.SetPressure(index, event.Pressure);
+            m_currentPointers.SetTimestamp(index, event.Timestamp);
+            if (m_recordStrokes)
+            {
+                m_strokes.Begin(event.Id, ToSample(event));
+            }
+            MarkPendingInput(index, event);
+            break;
+        }
+
+        case PointerEventKind::Released:
+        {
+            auto index = m_currentPointers.Find(event.Id);
+            if (index == PointerTable::npos)
+            {
+                break;
+            }
+
+            m_moveCoalescer.DiscardPending(event.Id);
+            m_currentPointers.SetPressed(index, false);
+            m_currentPointers.SetPosition(index, { event.X, event.Y });
+            m_currentPointers.SetPressure(index, event.Pressure);
+            m_currentPointers.SetTimestamp(index, event.Timestamp);
+            m_strokes.Append(event.Id, ToSample(event));
+            m_strokes.End(event.Id);
+            MarkPendingInput(index, event);
+            break;
+        }
+        }
+    }
+
+    void PointerRenderer::RecognizeGesture(PointerCore::PointerEvent const& event)
+    {
+        std::lock_guard lock{ m_gestureLock };
+        m_gestures.Process(event);
+    }
+
+    void PointerRenderer::QueueHeatmapSample(PointerCore::PointerEvent const& event)
+    {
+        if (!m_recordHeatmap || (event.Kind == PointerCore::PointerEventKind::Exited))
+        {
+            return;
+        }
+
+        // If the render thread falls behind, the ring drops samples rather than grow without bound
+        m_heatmapSamples.TryPush({ event.X, event.Y, event.InContact });
+    }
+
+    void PointerRenderer::AppendHistory(PointerCore::PointerEvent const& event)
+    {
+        if (!m_recordHistory)
+        {
+            return;
+        }
+
+        std::lock_guard lock{ m_historyLock };
+        m_history.Append(event);
+    }
+
+    void PointerRenderer::MarkPendingInput(size_t index, PointerCore::PointerEvent const& event) noexcept
+    {
+        // Only the oldest input not yet presented is kept, so coalesced moves
+        // are measured from the first of them
+        if ((event.ReceivedTime != 0) && (m_currentPointers.PendingInputTime(index) == 0))
+        {
+            m_currentPointers.SetPendingInputTime(index, event.ReceivedTime);
+        }
+    }
+
+    void PointerRenderer::RecordInputLatency(uint64_t presentTime) noexcept
+    {
+        for (size_t i = 0; i < m_currentPointers.Size(); ++i)
+        {
+            m_instrumentation.RecordInterval(PointerCore::FrameInstrumentation::Metric::InputToPresent, m_currentPointers.PendingInputTime(i), presentTime);
+            m_currentPointers.SetPendingInputTime(i, 0);
+        }
+    }
+
     fire_and_forget PointerRenderer::SetCaptureInputOnPress(bool capture)
     {
         // Wait for the render thread to finish spinning up
@@ -368,4 +1178,396 @@ namespace winrt::PointerDemo::implementation
             m_inputSource.ReleasePointerCapture();
         }
     }
+
+    fire_and_forget PointerRenderer::SetRecordTrace(bool record)
+    {
+        // Traces go to the app's local folder, one file per recording
+        std::filesystem::path tracePath;
+        if (record)
+        {
+            tracePath = std::filesystem::path{ Windows::Storage::ApplicationData::Current().LocalFolder().Path().c_str() };
+            tracePath /= L"pointer-" + std::to_wstring(clock::now().time_since_epoch().count()) + L".ptrace";
+        }
+
+        // Wait for the render thread to finish spinning up
+        co_await resume_on_signal(m_readySignal.get());
+
+        // The trace writer is only touched by the input handlers, so switch to their thread
+        if (!m_inputSource.Dispatcher().HasThreadAccess())
+        {
+            co_await resume_foreground(m_inputSource.Dispatcher());
+        }
+
+        m_traceWriter.Close();
+        if (record && !m_traceWriter.Open(tracePath))
+        {
+            OutputDebugStringW(L"Failed to create the pointer trace file\n");
+        }
+    }
+
+    fire_and_forget PointerRenderer::SetMeasureLatency(bool measure)
+    {
+        if (measure)
+        {
+            m_instrumentation.Reset();
+            m_instrumentation.SetEnabled(true);
+            co_return;
+        }
+
+        if (!m_instrumentation.IsEnabled())
+        {
+            co_return;
+        }
+        m_instrumentation.SetEnabled(false);
+        m_instrumentation.SetQueueCounters("heatmapSamples",
+            { m_heatmapSamples.OverflowCount(), m_heatmapSamples.HighWaterMark(), m_heatmapSamples.Capacity() });
+
+        // Stats go to the app's local folder, one file per measurement
+        std::filesystem::path statsPath{ Windows::Storage::ApplicationData::Current().LocalFolder().Path().c_str() };
+        statsPath /= L"latency-" + std::to_wstring(clock::now().time_since_epoch().count()) + L".json";
+
+        // Keep the file I/O off the XAML thread
+        co_await resume_background();
+
+        std::ofstream statsFile{ statsPath };
+        m_instrumentation.WriteJson(statsFile);
+        if (!statsFile)
+        {
+            OutputDebugStringW(L"Failed to write the latency stats file\n");
+        }
+    }
+
+    fire_and_forget PointerRenderer::WriteHeatmap(PointerCore::HeatmapSnapshot snapshot)
+    {
+        // Heatmaps go to the app's local folder, one file per snapshot
+        std::filesystem::path heatmapPath{ Windows::Storage::ApplicationData::Current().LocalFolder().Path().c_str() };
+        heatmapPath /= L"heatmap-" + std::to_wstring(clock::now().time_since_epoch().count()) + L".pgm";
+
+        // Keep the file I/O off the render thread
+        co_await resume_background();
+
+        std::ofstream heatmapFile{ heatmapPath, std::ios::binary };
+        snapshot.WritePgm(heatmapFile);
+        if (!heatmapFile)
+        {
+            OutputDebugStringW(L"Failed to write the heatmap file\n");
+        }
+    }
+
+    uint32_t PointerRenderer::AddHitRegion(Rect const& bounds)
+    {
+        std::lock_guard lock{ m_regionLock };
+        return m_regions.Insert({ bounds.X, bounds.Y, bounds.X + bounds.Width, bounds.Y + bounds.Height });
+    }
+
+    bool PointerRenderer::MoveHitRegion(uint32_t region, Rect const& bounds)
+    {
+        std::lock_guard lock{ m_regionLock };
+        return m_regions.Move(region, { bounds.X, bounds.Y, bounds.X + bounds.Width, bounds.Y + bounds.Height });
+    }
+
+    bool PointerRenderer::RemoveHitRegion(uint32_t region)
+    {
+        std::lock_guard lock{ m_regionLock };
+        return m_regions.Remove(region);
+    }
+
+    void PointerRenderer::ClearHitRegions()
+    {
+        std::lock_guard lock{ m_regionLock };
+        m_regions.Clear();
+    }
+
+    event_token PointerRenderer::RegionHoverChanged(TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::RegionHoverEventArgs> const& handler)
+    {
+        return m_regionHoverChanged.add(handler);
+    }
+
+    void PointerRenderer::RegionHoverChanged(event_token const& token) noexcept
+    {
+        m_regionHoverChanged.remove(token);
+    }
+
+    void PointerRenderer::UpdateRegionHover()
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "UpdateRegionHover" };
+
+        {
+            std::lock_guard lock{ m_regionLock };
+
+            // Nothing to hit and nobody to notify of leaving
+            if (m_regions.Empty() && m_regionHover.Empty())
+            {
+                return;
+            }
+
+            m_regions.HitTest(m_currentPointers, m_regionHits);
+        }
+
+        m_regionHover.Update(m_currentPointers, m_regionHits, m_regionEvents);
+        if (!m_regionEvents.empty())
+        {
+            RaiseRegionHoverChanged(std::move(m_regionEvents));
+            m_regionEvents.clear();
+        }
+    }
+
+    fire_and_forget PointerRenderer::RaiseRegionHoverChanged(std::vector<PointerCore::RegionEvent> events)
+    {
+        auto weakThis = get_weak();
+        co_await resume_foreground(Dispatcher());
+
+        if (auto strongThis = weakThis.get())
+        {
+            for (auto const& event : events)
+            {
+                m_regionHoverChanged(*this, make<RegionHoverEventArgs>(event.PointerId, event.Region, event.Entered));
+            }
+        }
+    }
+
+    void PointerRenderer::UpdateGovernor(PointerCore::RenderScheduler::Duration frameCost)
+    {
+        bool const adaptive = m_adaptiveQuality;
+        if (adaptive != m_governing)
+        {
+            // Either way, start over from the best settings
+            m_governing = adaptive;
+            m_governor.Reset();
+            ApplyFrameSettings(adaptive ? m_governor.CurrentSettings() : DefaultFrameSettings);
+            return;
+        }
+
+        if (!adaptive)
+        {
+            return;
+        }
+
+        // Aim for the frame rate cap, or 60 Hz without one
+        double const maxFrameRate = m_maxFrameRate;
+        auto const targetFrameTime = std::chrono::duration_cast<PointerCore::RenderScheduler::Duration>(
+            std::chrono::duration<double>(1.0 / ((maxFrameRate > 0.0) ? maxFrameRate : 60.0)));
+        if (m_governor.GetOptions().TargetFrameTime != targetFrameTime)
+        {
+            auto options = m_governor.GetOptions();
+            options.TargetFrameTime = targetFrameTime;
+            m_governor.SetOptions(options);
+        }
+
+        if (m_governor.OnFrame(frameCost))
+        {
+            ApplyFrameSettings(m_governor.CurrentSettings());
+        }
+    }
+
+    void PointerRenderer::ApplyFrameSettings(PointerCore::FrameGovernor::Settings const& settings)
+    {
+        // One buffer more than the frames that may be queued, so there's
+        // always one to draw into
+        UINT const bufferCount = settings.MaxFrameLatency + 1;
+        if (bufferCount != m_bufferCount)
+        {
+            m_d2dDeviceContext->SetTarget(nullptr);
+            m_swapChainSurfaceBitmaps.clear();
+
+            auto const buffers = m_resizePolicy.BufferSize();
+            auto const visible = m_resizePolicy.VisibleSize();
+            check_hresult(m_swapChain->ResizeBuffers(
+                bufferCount,
+                buffers.Width,
+                buffers.Height,
+                DXGI_FORMAT_UNKNOWN,
+                DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT));
+            check_hresult(m_swapChain.as<IDXGISwapChain2>()->SetSourceSize(visible.Width, visible.Height));
+
+            m_bufferCount = bufferCount;
+            m_damageTracker.SetBufferCount(bufferCount);
+        }
+
+        check_hresult(m_swapChain.as<IDXGISwapChain2>()->SetMaximumFrameLatency(settings.MaxFrameLatency));
+        m_frameSettings = settings;
+    }
+
+    void PointerRenderer::SaveTimeline()
+    {
+        WriteTimeline();
+    }
+
+    fire_and_forget PointerRenderer::WriteTimeline()
+    {
+        // Timelines go to the app's local folder, one file per save
+        std::filesystem::path timelinePath{ Windows::Storage::ApplicationData::Current().LocalFolder().Path().c_str() };
+        timelinePath /= L"timeline-" + std::to_wstring(clock::now().time_since_epoch().count()) + L".json";
+
+        // Keep the file I/O off the calling thread. Recording carries on meanwhile.
+        co_await resume_background();
+
+        std::ofstream timelineFile{ timelinePath };
+        s_timeline.WriteChromeTrace(timelineFile);
+        if (!timelineFile)
+        {
+            OutputDebugStringW(L"Failed to write the timeline file\n");
+        }
+    }
+
+    void PointerRenderer::SaveHistory(uint64_t startTime, uint64_t endTime)
+    {
+        WriteHistory(startTime, endTime);
+    }
+
+    fire_and_forget PointerRenderer::WriteHistory(uint64_t startTime, uint64_t endTime)
+    {
+        // Histories go to the app's local folder as traces, one file per save
+        std::filesystem::path historyPath{ Windows::Storage::ApplicationData::Current().LocalFolder().Path().c_str() };
+        historyPath /= L"history-" + std::to_wstring(clock::now().time_since_epoch().count()) + L".ptrace";
+
+        // Keep the decoding and file I/O off the XAML thread
+        co_await resume_background();
+
+        PointerCore::PointerTraceWriter historyWriter;
+        if (!historyWriter.Open(historyPath))
+        {
+            OutputDebugStringW(L"Failed to create the history trace file\n");
+            co_return;
+        }
+
+        // A range can cover hours of blocks, so copy it out a slice at a
+        // time: the input handlers only ever wait for one slice's decoding
+        std::vector<PointerCore::PointerEvent> events;
+        for (uint64_t sliceStart = startTime; sliceStart < endTime;)
+        {
+            uint64_t const sliceEnd = (endTime - sliceStart > HistorySliceMicroseconds) ? sliceStart + HistorySliceMicroseconds : endTime;
+            events.clear();
+            {
+                std::lock_guard lock{ m_historyLock };
+                m_history.Query(sliceStart, sliceEnd, events);
+            }
+
+            for (auto const& event : events)
+            {
+                historyWriter.Write(event);
+            }
+            sliceStart = sliceEnd;
+        }
+        historyWriter.Close();
+    }
+
+    void PointerRenderer::SaveHeatmap()
+    {
+        m_heatmapSaveRequested = true;
+        WakeRenderThread();
+    }
+
+    void PointerRenderer::UpdateHeatmap()
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "UpdateHeatmap" };
+
+        auto const now = SchedulerNow();
+        auto const elapsed = std::chrono::duration<float>(now - m_lastHeatmapDecay).count();
+        m_lastHeatmapDecay = now;
+
+        if (!m_recordHeatmap)
+        {
+            // Samples queued before recording was turned off are dropped
+            m_heatmapSamples.ConsumeAll([](PointerCore::HeatmapSample const&) {});
+            m_heatmap.Clear();
+            return;
+        }
+
+        // Decay first, so this frame's samples start at full weight
+        m_heatmap.Resize(static_cast<float>(m_width), static_cast<float>(m_height));
+        m_heatmap.Decay(elapsed);
+        m_heatmapSamples.ConsumeAll([this](PointerCore::HeatmapSample const& sample)
+        {
+            m_heatmap.AddSample(sample);
+        });
+
+        auto const overflows = m_heatmapSamples.OverflowCount();
+        if (overflows != m_reportedHeatmapOverflows)
+        {
+            OutputDebugStringW(L"Heatmap sample queue overflowed, samples were dropped\n");
+            m_reportedHeatmapOverflows = overflows;
+        }
+
+        if (m_heatmapSaveRequested.exchange(false))
+        {
+            PointerCore::HeatmapSnapshot snapshot;
+            m_heatmap.Snapshot(snapshot);
+            WriteHeatmap(std::move(snapshot));
+        }
+    }
+
+    event_token PointerRenderer::GestureRecognized(TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::GestureEventArgs> const& handler)
+    {
+        return m_gestureRecognized.add(handler);
+    }
+
+    void PointerRenderer::GestureRecognized(event_token const& token) noexcept
+    {
+        m_gestureRecognized.remove(token);
+    }
+
+    void PointerRenderer::UpdateGestures()
+    {
+        PointerCore::TimelineSpan span{ s_timeline, "UpdateGestures" };
+
+        {
+            std::lock_guard lock{ m_gestureLock };
+            m_gestures.Flush(m_gestureFrame);
+        }
+
+        if ((m_gestureFrame.Active || !m_gestureFrame.Taps.empty()) && m_gestureRecognized)
+        {
+            RaiseGestureRecognized(m_gestureFrame);
+        }
+    }
+
+    fire_and_forget PointerRenderer::RaiseGestureRecognized(PointerCore::GestureFrame frame)
+    {
+        auto weakThis = get_weak();
+        co_await resume_foreground(Dispatcher());
+
+        auto strongThis = weakThis.get();
+        if (!strongThis)
+        {
+            co_return;
+        }
+
+        for (auto const& tap : frame.Taps)
+        {
+            m_gestureRecognized(*this, make<GestureEventArgs>(GestureKind::Tap, tap.ContactCount,
+                Point{ tap.Position.X, tap.Position.Y }, Point{ 0.0f, 0.0f }, 1.0f, 0.0f));
+        }
+
+        if (!frame.Active)
+        {
+            co_return;
+        }
+
+        auto raise = [&](GestureKind kind, PointerCore::GestureFrame const& delta)
+        {
+            m_gestureRecognized(*this, make<GestureEventArgs>(kind, frame.ContactCount,
+                Point{ delta.Origin.X, delta.Origin.Y }, Point{ delta.Translation.X, delta.Translation.Y },
+                delta.Scale, delta.Rotation * (180.0f / 3.14159265f)));
+        };
+
+        bool const moved = (frame.Translation.X != 0.0f) || (frame.Translation.Y != 0.0f) || (frame.Scale != 1.0f) || (frame.Rotation != 0.0f);
+        if (frame.Started)
+        {
+            raise(GestureKind::ManipulationStarted, frame);
+        }
+        else if (moved && !frame.Ended)
+        {
+            raise(GestureKind::ManipulationDelta, frame);
+        }
+
+        if (frame.Ended)
+        {
+            // The delta of the frame the manipulation ended in goes with the
+            // completion, unless it was already reported as the start
+            PointerCore::GestureFrame completed{};
+            completed.Origin = frame.Origin;
+            raise(GestureKind::ManipulationCompleted, frame.Started ? completed : frame);
+        }
+    }
 }
\ No newline at end of file
@@ -2,6 +2,30 @@
 
 #include "PointerRenderer.g.h"
 
+#include "D2DRenderBackend.h"
+#include "DamageTracker.h"
+#include "FrameGovernor.h"
+#include "FrameInstrumentation.h"
+#include "FrameTimeline.h"
+#include "GestureRecognizer.h"
+#include "IndicatorBatch.h"
+#include "MoveCoalescer.h"
+#include "PointerHeatmap.h"
+#include "PointerHistory.h"
+#include "PointerLifecycle.h"
+#include "PointerPredictor.h"
+#include "PointerScene.h"
+#include "PointerTable.h"
+#include "PointerTrace.h"
+#include "RegionIndex.h"
+#include "RenderScheduler.h"
+#include "RenderService.h"
+#include "ResizePolicy.h"
+#include "SceneSnapshot.h"
+#include "SpscRing.h"
+#include "StrokeStore.h"
+#include "StrokeTessellator.h"
+
 namespace winrt::PointerDemo::implementation
 {
     struct PointerRenderer : PointerRendererT<PointerRenderer>
@@ -13,37 +37,219 @@ namespace winrt::PointerDemo::implementation
         inline bool CaptureInputOnPress() const { return unbox_value<bool>(GetValue(CaptureInputOnPressProperty())); }
         inline void CaptureInputOnPress(bool newValue) { SetValue(CaptureInputOnPressProperty(), box_value(newValue)); }
 
+        static inline Windows::UI::Xaml::DependencyProperty UseInputThreadProperty() { return s_useInputThreadProperty; }
+        inline bool UseInputThread() const { return unbox_value<bool>(GetValue(UseInputThreadProperty())); }
+        inline void UseInputThread(bool newValue) { SetValue(UseInputThreadProperty(), box_value(newValue)); }
+
+        static inline Windows::UI::Xaml::DependencyProperty RecordTraceProperty() { return s_recordTraceProperty; }
+        inline bool RecordTrace() const { return unbox_value<bool>(GetValue(RecordTraceProperty())); }
+        inline void RecordTrace(bool newValue) { SetValue(RecordTraceProperty(), box_value(newValue)); }
+
+        static inline Windows::UI::Xaml::DependencyProperty RenderOnDemandProperty() { return s_renderOnDemandProperty; }
+        inline bool RenderOnDemand() const { return unbox_value<bool>(GetValue(RenderOnDemandProperty())); }
+        inline void RenderOnDemand(bool newValue) { SetValue(RenderOnDemandProperty(), box_value(newValue)); }
+
+        static inline Windows::UI::Xaml::DependencyProperty MaxFrameRateProperty() { return s_maxFrameRateProperty; }
+        inline double MaxFrameRate() const { return unbox_value<double>(GetValue(MaxFrameRateProperty())); }
+        inline void MaxFrameRate(double newValue) { SetValue(MaxFrameRateProperty(), box_value(newValue)); }
+
+        // How far past the present to predict pointer positions for display, in milliseconds (0 to disable)
+        static inline Windows::UI::Xaml::DependencyProperty PredictionHorizonProperty() { return s_predictionHorizonProperty; }
+        inline double PredictionHorizon() const { return unbox_value<double>(GetValue(PredictionHorizonProperty())); }
+        inline void PredictionHorizon(double newValue) { SetValue(PredictionHorizonProperty(), box_value(newValue)); }
+
+        // Collects latency histograms while set, and writes them to a JSON file when cleared
+        static inline Windows::UI::Xaml::DependencyProperty MeasureLatencyProperty() { return s_measureLatencyProperty; }
+        inline bool MeasureLatency() const { return unbox_value<bool>(GetValue(MeasureLatencyProperty())); }
+        inline void MeasureLatency(bool newValue) { SetValue(MeasureLatencyProperty(), box_value(newValue)); }
+
+        // Draws all indicators through one instance batch instead of a fill per pointer
+        static inline Windows::UI::Xaml::DependencyProperty BatchIndicatorsProperty() { return s_batchIndicatorsProperty; }
+        inline bool BatchIndicators() const { return unbox_value<bool>(GetValue(BatchIndicatorsProperty())); }
+        inline void BatchIndicators(bool newValue) { SetValue(BatchIndicatorsProperty(), box_value(newValue)); }
+
+        // Draws indicators as anti-aliased sprites per device kind and state instead of squares
+        static inline Windows::UI::Xaml::DependencyProperty CursorSpritesProperty() { return s_cursorSpritesProperty; }
+        inline bool CursorSprites() const { return unbox_value<bool>(GetValue(CursorSpritesProperty())); }
+        inline void CursorSprites(bool newValue) { SetValue(CursorSpritesProperty(), box_value(newValue)); }
+
+        // Records the path of every pressed pointer as an ink stroke
+        static inline Windows::UI::Xaml::DependencyProperty RecordStrokesProperty() { return s_recordStrokesProperty; }
+        inline bool RecordStrokes() const { return unbox_value<bool>(GetValue(RecordStrokesProperty())); }
+        inline void RecordStrokes(bool newValue) { SetValue(RecordStrokesProperty(), box_value(newValue)); }
+
+        // Builds a fading heatmap of where pointers hover and press.
+        // SaveHeatmap() writes a snapshot to the app's local folder as a PGM image.
+        static inline Windows::UI::Xaml::DependencyProperty RecordHeatmapProperty() { return s_recordHeatmapProperty; }
+        inline bool RecordHeatmap() const { return unbox_value<bool>(GetValue(RecordHeatmapProperty())); }
+        inline void RecordHeatmap(bool newValue) { SetValue(RecordHeatmapProperty(), box_value(newValue)); }
+        void SaveHeatmap();
+
+        // Keeps a compressed history of every pointer event for the whole
+        // session. SaveHistory() writes the events with timestamps in
+        // [startTime, endTime) (microseconds, as in PointerPoint) to the app's
+        // local folder as a pointer trace.
+        static inline Windows::UI::Xaml::DependencyProperty RecordHistoryProperty() { return s_recordHistoryProperty; }
+        inline bool RecordHistory() const { return unbox_value<bool>(GetValue(RecordHistoryProperty())); }
+        inline void RecordHistory(bool newValue) { SetValue(RecordHistoryProperty(), box_value(newValue)); }
+        void SaveHistory(uint64_t startTime, uint64_t endTime);
+
+        // Lowers effects, then raises frame latency and present interval when
+        // frames take longer than the frame rate allows (MaxFrameRate, or 60 Hz
+        // uncapped), and restores them once frames are cheap again
+        static inline Windows::UI::Xaml::DependencyProperty AdaptiveQualityProperty() { return s_adaptiveQualityProperty; }
+        inline bool AdaptiveQuality() const { return unbox_value<bool>(GetValue(AdaptiveQualityProperty())); }
+        inline void AdaptiveQuality(bool newValue) { SetValue(AdaptiveQualityProperty(), box_value(newValue)); }
+
+        // Render through the shared RenderService (one device and worker for
+        // all panels) instead of a thread per panel. Read when a panel is
+        // constructed, so set it before creating any.
+        static bool UseSharedRenderService() noexcept { return s_useSharedRenderService; }
+        static void UseSharedRenderService(bool value) noexcept { s_useSharedRenderService = value; }
+
+        // Records how long each phase of every panel's frames and input
+        // handlers takes, on every thread. SaveTimeline() writes the most recent
+        // spans to the app's local folder as a Chrome trace (chrome://tracing, Perfetto).
+        static bool RecordTimeline() noexcept { return s_timeline.IsEnabled(); }
+        static void RecordTimeline(bool value) noexcept { s_timeline.SetEnabled(value); }
+        static void SaveTimeline();
+        static PointerCore::FrameTimeline& Timeline() noexcept { return s_timeline; }
+
+        // Panels with a higher priority are rendered first when sharing the render service
+        static inline Windows::UI::Xaml::DependencyProperty RenderPriorityProperty() { return s_renderPriorityProperty; }
+        inline int32_t RenderPriority() const { return unbox_value<int32_t>(GetValue(RenderPriorityProperty())); }
+        inline void RenderPriority(int32_t newValue) { SetValue(RenderPriorityProperty(), box_value(newValue)); }
+
+        // Draws one frame for the render service, if one is due, and says when the next one is
+        PointerCore::RenderScheduler::Decision RenderSharedFrame() noexcept;
+
+        // Hit regions, in DIPs relative to the panel. RegionHoverChanged is raised
+        // on the XAML thread when a pointer moves onto or off one of them.
+        uint32_t AddHitRegion(Windows::Foundation::Rect const& bounds);
+        bool MoveHitRegion(uint32_t region, Windows::Foundation::Rect const& bounds);
+        bool RemoveHitRegion(uint32_t region);
+        void ClearHitRegions();
+        event_token RegionHoverChanged(Windows::Foundation::TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::RegionHoverEventArgs> const& handler);
+        void RegionHoverChanged(event_token const& token) noexcept;
+
+        // Pan/pinch/rotate and taps, recognized off the XAML thread and raised
+        // on it once per frame
+        event_token GestureRecognized(Windows::Foundation::TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::GestureEventArgs> const& handler);
+        void GestureRecognized(event_token const& token) noexcept;
+
     private:
         // DependencyProperty handling
         static void InitializeDependencyProperties();
         static void OnCaptureInputOnPressChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnUseInputThreadChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRecordTraceChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRenderOnDemandChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnMaxFrameRateChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnPredictionHorizonChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnMeasureLatencyChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnBatchIndicatorsChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnCursorSpritesChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRecordStrokesChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRecordHeatmapChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRecordHistoryChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnAdaptiveQualityChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
+        static void OnRenderPriorityChanged(Windows::UI::Xaml::DependencyObject const& target, Windows::UI::Xaml::DependencyPropertyChangedEventArgs const& args);
 
         // Rendering
         void CreateRenderingResources();
         void RegisterForInputEvents();
+        void CreateInputSource();
         void Run() noexcept;
-        void Render(IDXGISurface* renderTarget);
+        PointerCore::RenderScheduler::Decision NextFrameDecision() noexcept;
+        bool RenderFrame(DWORD frameReadyTimeout) noexcept;
+        void WaitForWork(PointerCore::RenderScheduler::Decision const& decision);
+        void WakeRenderThread();
+        PointerCore::PointerTable const& UpdateDisplayPointers();
+        void Render(IDXGISurface* renderTarget, PointerCore::PointerTable const& pointers, PointerCore::DamageRegion const& region);
+        void Present();
+        void ApplyPendingResize();
+        void RecordInputLatency(uint64_t presentTime) noexcept;
+        void UpdateRegionHover();
+        void UpdateGestures();
+        void UpdateHeatmap();
+        void UpdateCursorSprites();
+        void UpdateGovernor(PointerCore::RenderScheduler::Duration frameCost);
+        void ApplyFrameSettings(PointerCore::FrameGovernor::Settings const& settings);
 
         // Event handlers
-        fire_and_forget OnSizeChanged();
+        void OnSizeChanged();
         void OnPointerEntered(Windows::UI::Core::PointerEventArgs const& args);
         void OnPointerExited(Windows::UI::Core::PointerEventArgs const& args);
         void OnPointerMoved(Windows::UI::Core::PointerEventArgs const& args);
         void OnPointerPressed(Windows::UI::Core::PointerEventArgs const& args);
         void OnPointerReleased(Windows::UI::Core::PointerEventArgs const& args);
 
+        // Input processing
+        void DispatchPointerEvent(PointerCore::PointerEvent event);
+        void PublishPointerEvent(PointerCore::PointerEvent const& event);
+        void AcquireSnapshot();
+        void ApplyPointerEvent(PointerCore::PointerEvent const& event);
+        void ApplyValidPointerEvent(PointerCore::PointerEvent const& event);
+        void RecognizeGesture(PointerCore::PointerEvent const& event);
+        void QueueHeatmapSample(PointerCore::PointerEvent const& event);
+        void AppendHistory(PointerCore::PointerEvent const& event);
+        void ReportPointerAnomalies();
+        void MarkPendingInput(size_t index, PointerCore::PointerEvent const& event) noexcept;
+
         // Internal helpers
         fire_and_forget SetCaptureInputOnPress(bool capture);
+        fire_and_forget SetRecordTrace(bool record);
+        fire_and_forget SetMeasureLatency(bool measure);
+        fire_and_forget RaiseRegionHoverChanged(std::vector<PointerCore::RegionEvent> events);
+        fire_and_forget RaiseGestureRecognized(PointerCore::GestureFrame frame);
+        fire_and_forget WriteHeatmap(PointerCore::HeatmapSnapshot snapshot);
+        fire_and_forget WriteHistory(uint64_t startTime, uint64_t endTime);
+        static fire_and_forget WriteTimeline();
 
     private:
         // XAML
         inline static Windows::UI::Xaml::DependencyProperty s_captureInputOnPressProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_useInputThreadProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_recordTraceProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_renderOnDemandProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_maxFrameRateProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_predictionHorizonProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_measureLatencyProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_batchIndicatorsProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_cursorSpritesProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_recordStrokesProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_recordHeatmapProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_recordHistoryProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_adaptiveQualityProperty{ nullptr };
+        inline static Windows::UI::Xaml::DependencyProperty s_renderPriorityProperty{ nullptr };
+        inline static std::atomic_bool s_useSharedRenderService{ false };
+        inline static PointerCore::FrameTimeline s_timeline;
 
-        // Render thread
+        // Render thread, or the shared service rendering this panel instead
+        std::shared_ptr<RenderService> m_renderService;
+        RenderService::PanelId m_panelId{ PointerCore::PanelScheduler::NoPanel };
         std::thread m_renderThread;
         std::atomic_bool m_running{ true };
         handle m_readySignal;
 
+        // Frame scheduling. Other threads request frames through m_frameRequested
+        // and m_wakeSignal, the scheduler itself is only used on the render thread.
+        PointerCore::RenderScheduler m_renderScheduler{};
+        handle m_wakeSignal;
+        std::atomic_bool m_frameRequested{ true };
+        std::atomic_bool m_renderOnDemand{ false };
+        std::atomic<double> m_maxFrameRate{ 0.0 };
+
+        // Frame settings, picked by the governor when AdaptiveQuality is set
+        // (render thread only). Without it, frames have full effects and
+        // don't wait for vsync, with the swap chain's default latency of one.
+        static constexpr PointerCore::FrameGovernor::Settings DefaultFrameSettings{ 1, 0, PointerCore::FrameGovernor::EffectsLevel::Full };
+        std::atomic_bool m_adaptiveQuality{ false };
+        bool m_governing{ false };
+        PointerCore::FrameGovernor m_governor{};
+        PointerCore::FrameGovernor::Settings m_frameSettings{ DefaultFrameSettings };
+        UINT m_bufferCount{ 2 };
+
         // Rendering
         handle m_frameReadySignal;
         com_ptr<IDXGISwapChain1> m_swapChain;
@@ -53,13 +259,36 @@ namespace winrt::PointerDemo::implementation
         com_ptr<ID2D1DeviceContext> m_d2dDeviceContext;
         std::map<IDXGISurface*, com_ptr<ID2D1Bitmap1>> m_swapChainSurfaceBitmaps;
 
-        com_ptr<ID2D1SolidColorBrush> m_hoverBrush;
-        com_ptr<ID2D1SolidColorBrush> m_pressedBrush;
+        std::unique_ptr<PointerCore::RenderBackend> m_renderBackend;
+
+        // Instance buffer for BatchIndicators, rebuilt every frame
+        std::atomic_bool m_batchIndicators{ false };
+        PointerCore::IndicatorBatch m_indicatorBatch;
+
+        // CursorSprites, and whether the last frame drew them. The swap chain
+        // is one pixel per DIP, so the atlas is built for a scale of 1.
+        std::atomic_bool m_cursorSprites{ false };
+        bool m_drawingCursorSprites{ false };
+        PointerCore::CursorAtlas m_cursorAtlas{ PointerCore::PointerScene::CursorStyle(PointerCore::PixelFormat::Rgba8) };
+        std::vector<PointerCore::SpriteInstance> m_cursorSpriteInstances;
+
+        // What changed from frame to frame, so only that gets redrawn and presented
+        PointerCore::DamageTracker m_damageTracker{};
+        std::vector<RECT> m_dirtyRects;
 
         double m_width;
         double m_height;
         Windows::UI::Xaml::Controls::SwapChainPanel::SizeChanged_revoker m_sizeChangedSubscription;
 
+        // Latest size reported by the XAML thread, applied by the render thread
+        std::mutex m_pendingSizeLock;
+        double m_pendingWidth{ 0 };
+        double m_pendingHeight{ 0 };
+        bool m_resizePending{ false };
+
+        // Decides when the swap chain buffers follow the panel size (render thread only)
+        PointerCore::ResizePolicy m_resizePolicy;
+
         // Input
         bool m_captureOnPress{ false };
         Windows::UI::Core::CoreIndependentInputSource m_inputSource{ nullptr };
@@ -69,14 +298,87 @@ namespace winrt::PointerDemo::implementation
         Windows::UI::Core::CoreIndependentInputSource::PointerPressed_revoker m_pointerPressedSubscription;
         Windows::UI::Core::CoreIndependentInputSource::PointerReleased_revoker m_pointerReleasedSubscription;
 
-        struct PointerData
-        {
-            Windows::Devices::Input::PointerDeviceType m_type;
-            bool m_pressed{ false };
-            Windows::Foundation::Point m_currentPosition;
-        };
+        // IDs of pressed pointers, tracked on the input source's thread for capture handling
+        std::vector<uint32_t> m_pressedPointerIds;
+
+        // Input thread (when UseInputThread is set)
+        std::atomic_bool m_useInputThread{ false };
+        bool m_inputThreadActive{ false };
+        std::thread m_inputThread;
+        // With the input thread, events are applied there and the render thread
+        // draws the latest published snapshot of the pointers and strokes
+        PointerCore::SceneSnapshotChannel m_snapshots;
+        PointerCore::StrokeStore const* m_snapshotStrokes{ nullptr };
+
+        // Trace of the events seen by the input handlers (when RecordTrace is set)
+        PointerCore::PointerTraceWriter m_traceWriter;
+
+        // Per-pointer event order checking, ahead of m_currentPointers (or
+        // m_snapshots), on whichever thread handles input
+        PointerCore::PointerLifecycle m_pointerLifecycle{};
+        uint64_t m_reportedAnomalyCount{ 0 };
+
+        // Live pointer state (ID, device type, pressed and current position per pointer)
+        PointerCore::PointerTable m_currentPointers{};
+
+        // Moves received between frames, folded into m_currentPointers once per frame
+        PointerCore::MoveCoalescer m_moveCoalescer{};
+
+        // Display-only prediction. m_displayPointers is the copy of
+        // m_currentPointers that gets drawn when prediction is enabled.
+        std::atomic<double> m_predictionHorizon{ 0.0 };
+        PointerCore::PointerPredictor m_predictor{};
+        PointerCore::PointerTable m_displayPointers{};
+
+        // Ink strokes (when RecordStrokes is set), fed with every sample rather
+        // than the coalesced positions, and their pressure-width triangle strips
+        std::atomic_bool m_recordStrokes{ false };
+        PointerCore::StrokeStore m_strokes{};
+        PointerCore::StrokeTessellator m_inkTessellator{};
+
+        // Heatmap (when RecordHeatmap is set). Samples are pushed into the ring
+        // by whichever thread handles input (only ever one, fixed before input
+        // starts); the render thread drains, splats and decays them once per
+        // frame, and takes snapshots when asked to through m_heatmapSaveRequested.
+        // The ring's counters go into the latency stats, and new overflows are
+        // logged by the render thread.
+        static constexpr size_t MaxQueuedHeatmapSamples = 64 * 1024;
+        std::atomic_bool m_recordHeatmap{ false };
+        std::atomic_bool m_heatmapSaveRequested{ false };
+        PointerCore::SpscRing<PointerCore::HeatmapSample> m_heatmapSamples{ MaxQueuedHeatmapSamples };
+        uint64_t m_reportedHeatmapOverflows{ 0 };
+        PointerCore::PointerHeatmap m_heatmap{};
+        PointerCore::RenderScheduler::TimePoint m_lastHeatmapDecay{};
+
+        // Session history (when RecordHistory is set), appended to by whichever
+        // thread handles input and copied out by SaveHistory() on a background
+        // thread, one slice of HistorySliceMicroseconds per lock
+        static constexpr uint64_t HistorySliceMicroseconds = 1000000;
+        std::atomic_bool m_recordHistory{ false };
+        std::mutex m_historyLock;
+        PointerCore::PointerHistory m_history{};
+
+        // Hit regions. The index is edited from the XAML thread and queried by
+        // the render thread once per frame, after moves have been coalesced.
+        std::mutex m_regionLock;
+        PointerCore::RegionIndex m_regions{};
+        PointerCore::RegionHoverTracker m_regionHover{};
+        std::vector<PointerCore::RegionId> m_regionHits;
+        std::vector<PointerCore::RegionEvent> m_regionEvents;
+        event<Windows::Foundation::TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::RegionHoverEventArgs>> m_regionHoverChanged;
+
+        // Gestures. The recognizer is fed by whichever thread handles input
+        // and flushed by the render thread once per frame.
+        std::mutex m_gestureLock;
+        PointerCore::GestureRecognizer m_gestures{};
+        PointerCore::GestureFrame m_gestureFrame{};
+        event<Windows::Foundation::TypedEventHandler<PointerDemo::PointerRenderer, PointerDemo::GestureEventArgs>> m_gestureRecognized;
 
-        std::unordered_map<uint32_t, PointerData> m_currentPointers{};
+        // Latency statistics (when MeasureLatency is set). Input times are
+        // carried per pointer in m_currentPointers until they're presented.
+        PointerCore::FrameInstrumentation m_instrumentation;
+        bool m_measuredLastFrame{ false };
+        uint64_t m_lastFrameStartTime{ 0 };
     };
 }
 
@@ -0,0 +1,168 @@
+#include "PointerScene.h"
+
+namespace PointerCore::PointerScene
+{
+    static inline bool Intersects(Rect const& a, Rect const& b) noexcept
+    {
+        return (a.Right > b.Left) && (a.Left < b.Right) && (a.Bottom > b.Top) && (a.Top < b.Bottom);
+    }
+
+    // Draws the strokes whose meshes reach into bounds (all of them if null)
+    static void DrawInk(RenderBackend& backend, StrokeTessellator const* ink, Rect const* bounds)
+    {
+        if (ink == nullptr)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < ink->MeshCount(); ++i)
+        {
+            if ((bounds == nullptr) || Intersects(ink->MeshBounds(i), *bounds))
+            {
+                backend.FillKeyedTriangleStrip(ink->MeshStrokeId(i), ink->MeshVertices(i), ink->MeshVertexCount(i), ink->MeshStableVertexCount(i), InkColor);
+            }
+        }
+    }
+
+    void Draw(RenderBackend& backend, PointerTable const& pointers, StrokeTessellator const* ink)
+    {
+        backend.BeginDraw();
+
+        // Clear the background
+        backend.Clear(BackgroundColor);
+        DrawInk(backend, ink, nullptr);
+
+        // Draw an indicator for each position
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            backend.FillRectangle(IndicatorRect(xs[i], ys[i]), pointers.IsPressed(i) ? PressedColor : HoverColor);
+        }
+
+        backend.EndDraw();
+    }
+
+    void Draw(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, StrokeTessellator const* ink)
+    {
+        if (region.Full)
+        {
+            Draw(backend, pointers, ink);
+            return;
+        }
+
+        backend.BeginDraw();
+
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        for (auto const& clip : region.Rects)
+        {
+            backend.PushClip(clip);
+            backend.Clear(BackgroundColor);
+
+            // Only content that reaches into this rectangle can change it
+            Rect const bounds = clip.ToRect();
+            DrawInk(backend, ink, &bounds);
+            for (size_t i = 0; i < pointers.Size(); ++i)
+            {
+                Rect const indicator = IndicatorRect(xs[i], ys[i]);
+                if (Intersects(indicator, bounds))
+                {
+                    backend.FillRectangle(indicator, pointers.IsPressed(i) ? PressedColor : HoverColor);
+                }
+            }
+
+            backend.PopClip();
+        }
+
+        backend.EndDraw();
+    }
+
+    void DrawBatched(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, IndicatorBatch& batch, StrokeTessellator const* ink)
+    {
+        backend.BeginDraw();
+
+        if (region.Full)
+        {
+            backend.Clear(BackgroundColor);
+            DrawInk(backend, ink, nullptr);
+
+            batch.Build(pointers, Style);
+            backend.FillRectangles(batch.Rects(), batch.Colors(), batch.Size());
+        }
+        else if (!region.Rects.empty())
+        {
+            // One build culled to the union of the damage, drawn under each
+            // rectangle's clip, which drops the indicators outside it
+            PixelRect damaged = region.Rects.front();
+            for (auto const& clip : region.Rects)
+            {
+                damaged = Union(damaged, clip);
+            }
+            batch.Build(pointers, Style, damaged.ToRect());
+
+            for (auto const& clip : region.Rects)
+            {
+                backend.PushClip(clip);
+                backend.Clear(BackgroundColor);
+
+                Rect const bounds = clip.ToRect();
+                DrawInk(backend, ink, &bounds);
+                backend.FillRectangles(batch.Rects(), batch.Colors(), batch.Size());
+
+                backend.PopClip();
+            }
+        }
+
+        backend.EndDraw();
+    }
+
+    // Places the sprites of the pointers whose sprites reach into bounds (all of them if null)
+    static void PlaceCursors(PointerTable const& pointers, CursorAtlas const& atlas, Rect const* bounds, std::vector<SpriteInstance>& sprites)
+    {
+        sprites.clear();
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            SpriteInstance const sprite = atlas.Place(pointers.Type(i), pointers.IsPressed(i), { xs[i], ys[i] });
+            if ((bounds == nullptr) || Intersects(sprite.Destination, *bounds))
+            {
+                sprites.push_back(sprite);
+            }
+        }
+    }
+
+    void DrawCursors(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, CursorAtlas const& atlas, std::vector<SpriteInstance>& sprites, StrokeTessellator const* ink)
+    {
+        backend.BeginDraw();
+
+        SpriteSheet const sheet = atlas.Sheet();
+        if (region.Full)
+        {
+            backend.Clear(BackgroundColor);
+            DrawInk(backend, ink, nullptr);
+
+            PlaceCursors(pointers, atlas, nullptr, sprites);
+            backend.DrawSprites(sheet, sprites.data(), sprites.size());
+        }
+        else
+        {
+            for (auto const& clip : region.Rects)
+            {
+                backend.PushClip(clip);
+                backend.Clear(BackgroundColor);
+
+                Rect const bounds = clip.ToRect();
+                DrawInk(backend, ink, &bounds);
+
+                PlaceCursors(pointers, atlas, &bounds, sprites);
+                backend.DrawSprites(sheet, sprites.data(), sprites.size());
+
+                backend.PopClip();
+            }
+        }
+
+        backend.EndDraw();
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include "CursorAtlas.h"
+#include "DamageTracker.h"
+#include "IndicatorBatch.h"
+#include "PointerTable.h"
+#include "RenderBackend.h"
+#include "StrokeTessellator.h"
+
+namespace PointerCore
+{
+    // Look of the pointer visualization, shared by every render backend
+    namespace PointerScene
+    {
+        constexpr float IndicatorHalfSize = 20.0f;
+        constexpr Color BackgroundColor = Colors::Black;
+        constexpr Color HoverColor = Colors::Blue;
+        constexpr Color PressedColor = Colors::Red;
+        constexpr Color InkColor = Colors::White;
+        constexpr IndicatorStyle Style{ IndicatorHalfSize, HoverColor, PressedColor };
+
+        inline Rect IndicatorRect(float x, float y) noexcept
+        {
+            return { x - IndicatorHalfSize, y - IndicatorHalfSize, x + IndicatorHalfSize, y + IndicatorHalfSize };
+        }
+
+        // Cursor sprites that fit in the indicator rectangles, in the target's pixel layout
+        inline CursorAtlas::Options CursorStyle(PixelFormat format) noexcept
+        {
+            return { IndicatorHalfSize, HoverColor, PressedColor, format };
+        }
+
+        // Clears the target and draws the ink, if any, then an indicator for
+        // every pointer in the table
+        void Draw(RenderBackend& backend, PointerTable const& pointers, StrokeTessellator const* ink = nullptr);
+
+        // Same as Draw(), but only repaints the given region of the target
+        void Draw(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, StrokeTessellator const* ink = nullptr);
+
+        // Same as Draw(), but builds the indicators into batch and submits them
+        // with one FillRectangles() call per repainted rectangle
+        void DrawBatched(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, IndicatorBatch& batch, StrokeTessellator const* ink = nullptr);
+
+        // Same as DrawBatched(), but draws every pointer as the sprite for its
+        // device kind and state from a built atlas, placed into sprites
+        void DrawCursors(RenderBackend& backend, PointerTable const& pointers, DamageRegion const& region, CursorAtlas const& atlas, std::vector<SpriteInstance>& sprites, StrokeTessellator const* ink = nullptr);
+    }
+}
@@ -0,0 +1,448 @@
+#include "PointerStateCodec.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Varint.h"
+
+namespace PointerCore
+{
+    using PointerStateCodec::Entry;
+
+    namespace
+    {
+        constexpr uint8_t KeyframeFlag = 0x01;
+        constexpr uint8_t VersionShift = 4;
+
+        constexpr uint8_t DeviceMask = 0x03;
+        constexpr uint8_t PressedFlag = 0x04;
+        constexpr uint8_t XFlag = 0x08;
+        constexpr uint8_t YFlag = 0x10;
+        constexpr uint8_t PressureFlag = 0x20;
+        constexpr uint8_t NewFlag = 0x40;
+        constexpr uint8_t UnknownTagBits = 0x80;
+
+        constexpr Entry ZeroEntry{ 0, 0, 0, 0, PointerDeviceKind::Touch, false };
+
+        // Keeps deltas between any two values well inside int64 and lround defined
+        int32_t ToFixed(float value, float scale) noexcept
+        {
+            constexpr float Limit = 1073741824.0f;
+            float const scaled = value * scale;
+            if (!(scaled > -Limit))
+            {
+                return static_cast<int32_t>(-Limit);
+            }
+
+            return static_cast<int32_t>(std::lround(std::min(scaled, Limit)));
+        }
+
+        bool ReadId(uint8_t const*& cursor, uint8_t const* end, bool first, uint32_t& id) noexcept
+        {
+            // IDs are strictly ascending, so every delta after the first is at least one
+            uint64_t delta;
+            if (!Varint::Read(cursor, end, delta) || (!first && (delta == 0)))
+            {
+                return false;
+            }
+
+            uint64_t const next = first ? delta : id + delta;
+            if (next > UINT32_MAX)
+            {
+                return false;
+            }
+
+            id = static_cast<uint32_t>(next);
+            return true;
+        }
+
+        bool ReadField(uint8_t const*& cursor, uint8_t const* end, int32_t base, int32_t& value) noexcept
+        {
+            int64_t delta;
+            if (!Varint::ReadSigned(cursor, end, delta) ||
+                (delta < INT32_MIN - int64_t{ base }) || (delta > INT32_MAX - int64_t{ base }))
+            {
+                return false;
+            }
+
+            value = static_cast<int32_t>(base + delta);
+            return true;
+        }
+    }
+
+    PointerStateCodec::FrameHistory::FrameHistory(uint32_t length)
+        : m_frames(std::max<uint32_t>(length, 1))
+    {
+    }
+
+    std::vector<Entry> const* PointerStateCodec::FrameHistory::Find(uint64_t sequence) const noexcept
+    {
+        Frame const& frame = m_frames[sequence % m_frames.size()];
+        return (frame.Valid && (frame.Sequence == sequence)) ? &frame.Entries : nullptr;
+    }
+
+    std::vector<Entry>& PointerStateCodec::FrameHistory::Store(uint64_t sequence)
+    {
+        Frame& frame = m_frames[sequence % m_frames.size()];
+        frame.Sequence = sequence;
+        frame.Valid = true;
+        frame.Entries.clear();
+        return frame.Entries;
+    }
+
+    PointerStateEncoder::PointerStateEncoder()
+        : PointerStateEncoder(Options())
+    {
+    }
+
+    PointerStateEncoder::PointerStateEncoder(Options const& options)
+        : m_options(options)
+        , m_history(options.HistoryLength)
+    {
+    }
+
+    void PointerStateEncoder::Acknowledge(uint64_t sequence) noexcept
+    {
+        if ((sequence < m_frameCount) && (!m_hasAcknowledged || (sequence > m_acknowledged)))
+        {
+            m_acknowledged = sequence;
+            m_hasAcknowledged = true;
+        }
+    }
+
+    uint64_t PointerStateEncoder::Encode(PointerTable const& pointers, std::vector<uint8_t>& out)
+    {
+        uint64_t const sequence = m_frameCount++;
+
+        // The slot about to be stored must not be the base's
+        std::vector<Entry> const* base = nullptr;
+        if (m_hasAcknowledged && (sequence - m_acknowledged < m_history.Length()))
+        {
+            base = m_history.Find(m_acknowledged);
+        }
+
+        bool const keyframe = (base == nullptr) || m_keyframeRequested ||
+            (sequence - m_lastKeyframe >= m_options.KeyframeInterval);
+        if (keyframe)
+        {
+            base = nullptr;
+            m_keyframeRequested = false;
+            m_lastKeyframe = sequence;
+            ++m_keyframeCount;
+        }
+
+        // Table order only changes on insert and erase, so the sort by ID is
+        // kept for as long as the ID column stays the same
+        size_t const count = pointers.Size();
+        uint32_t const* ids = pointers.Ids();
+        if ((count != m_orderIds.size()) || !std::equal(ids, ids + count, m_orderIds.begin()))
+        {
+            m_orderIds.assign(ids, ids + count);
+            m_order.resize(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                m_order[i] = static_cast<uint32_t>(i);
+            }
+
+            std::sort(m_order.begin(), m_order.end(), [ids](uint32_t a, uint32_t b) { return ids[a] < ids[b]; });
+        }
+
+        std::vector<Entry>& current = m_history.Store(sequence);
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        float const* pressures = pointers.Pressures();
+        PointerDeviceKind const* types = pointers.Types();
+        for (uint32_t const i : m_order)
+        {
+            current.push_back({
+                ids[i],
+                ToFixed(xs[i], PointerStateCodec::PositionScale),
+                ToFixed(ys[i], PointerStateCodec::PositionScale),
+                ToFixed(pressures[i], PointerStateCodec::PressureScale),
+                types[i],
+                pointers.IsPressed(i) });
+        }
+
+        // Count the changes first; the upsert and removal counts lead the frame
+        size_t upserts = 0;
+        size_t removals = 0;
+        size_t const baseCount = base ? base->size() : 0;
+        for (size_t i = 0, b = 0; (i < current.size()) || (b < baseCount);)
+        {
+            if ((b == baseCount) || ((i < current.size()) && (current[i].Id < (*base)[b].Id)))
+            {
+                ++upserts;
+                ++i;
+            }
+            else if ((i == current.size()) || ((*base)[b].Id < current[i].Id))
+            {
+                ++removals;
+                ++b;
+            }
+            else
+            {
+                Entry const& now = current[i++];
+                Entry const& then = (*base)[b++];
+                if ((now.X != then.X) || (now.Y != then.Y) || (now.Pressure != then.Pressure) ||
+                    (now.DeviceKind != then.DeviceKind) || (now.Pressed != then.Pressed))
+                {
+                    ++upserts;
+                }
+            }
+        }
+
+        out.push_back(static_cast<uint8_t>((PointerStateCodec::Version << VersionShift) | (keyframe ? KeyframeFlag : 0)));
+        Varint::Write(out, sequence);
+        if (!keyframe)
+        {
+            Varint::Write(out, sequence - m_acknowledged);
+        }
+
+        Varint::Write(out, upserts);
+        if (!keyframe)
+        {
+            Varint::Write(out, removals);
+        }
+
+        uint32_t previousId = 0;
+        for (size_t i = 0, b = 0; i < current.size(); ++i)
+        {
+            Entry const& now = current[i];
+            while ((b < baseCount) && ((*base)[b].Id < now.Id))
+            {
+                ++b;
+            }
+
+            bool const isNew = (b == baseCount) || ((*base)[b].Id != now.Id);
+            Entry const& then = isNew ? ZeroEntry : (*base)[b];
+
+            uint8_t tag = static_cast<uint8_t>(static_cast<uint8_t>(now.DeviceKind) & DeviceMask);
+            tag |= now.Pressed ? PressedFlag : 0;
+            tag |= (now.X != then.X) ? XFlag : 0;
+            tag |= (now.Y != then.Y) ? YFlag : 0;
+            tag |= (now.Pressure != then.Pressure) ? PressureFlag : 0;
+            tag |= isNew ? NewFlag : 0;
+            if (!isNew && ((tag & (XFlag | YFlag | PressureFlag)) == 0) &&
+                (now.DeviceKind == then.DeviceKind) && (now.Pressed == then.Pressed))
+            {
+                continue;
+            }
+
+            out.push_back(tag);
+            Varint::Write(out, now.Id - previousId);
+            previousId = now.Id;
+            if (tag & XFlag)
+            {
+                Varint::WriteSigned(out, int64_t{ now.X } - then.X);
+            }
+
+            if (tag & YFlag)
+            {
+                Varint::WriteSigned(out, int64_t{ now.Y } - then.Y);
+            }
+
+            if (tag & PressureFlag)
+            {
+                Varint::WriteSigned(out, int64_t{ now.Pressure } - then.Pressure);
+            }
+        }
+
+        previousId = 0;
+        for (size_t i = 0, b = 0; b < baseCount; ++b)
+        {
+            uint32_t const id = (*base)[b].Id;
+            while ((i < current.size()) && (current[i].Id < id))
+            {
+                ++i;
+            }
+
+            if ((i == current.size()) || (current[i].Id != id))
+            {
+                Varint::Write(out, id - previousId);
+                previousId = id;
+            }
+        }
+
+        return sequence;
+    }
+
+    PointerStateDecoder::PointerStateDecoder()
+        : PointerStateDecoder(Options())
+    {
+    }
+
+    PointerStateDecoder::PointerStateDecoder(Options const& options)
+        : m_history(options.HistoryLength)
+    {
+    }
+
+    PointerStateDecoder::Result PointerStateDecoder::Decode(uint8_t const* data, size_t size, PointerTable& pointers)
+    {
+        uint8_t const* cursor = data;
+        uint8_t const* const end = data + size;
+        if ((size == 0) || ((*cursor >> VersionShift) != PointerStateCodec::Version) || ((*cursor & 0x0e) != 0))
+        {
+            return Result::Malformed;
+        }
+
+        bool const keyframe = (*cursor++ & KeyframeFlag) != 0;
+
+        uint64_t sequence;
+        uint64_t distance = 0;
+        uint64_t upserts;
+        uint64_t removals = 0;
+        if (!Varint::Read(cursor, end, sequence) ||
+            (!keyframe && (!Varint::Read(cursor, end, distance) || (distance == 0) || (distance > sequence))) ||
+            !Varint::Read(cursor, end, upserts) ||
+            (!keyframe && !Varint::Read(cursor, end, removals)))
+        {
+            return Result::Malformed;
+        }
+
+        if (m_hasDecoded && (sequence <= m_lastSequence))
+        {
+            return Result::Stale;
+        }
+
+        std::vector<Entry> const* base = nullptr;
+        if (!keyframe)
+        {
+            base = m_history.Find(sequence - distance);
+            if (base == nullptr)
+            {
+                return Result::MissingBase;
+            }
+        }
+
+        // Every upsert and removal takes at least a byte, which bounds the counts
+        size_t const baseCount = base ? base->size() : 0;
+        if ((upserts > size) || (removals > size) || (removals > baseCount))
+        {
+            return Result::Malformed;
+        }
+
+        // Merge the upserts into the base as they are read, then drop the removals
+        m_scratch.clear();
+        m_upserted.clear();
+        uint32_t id = 0;
+        size_t b = 0;
+        for (uint64_t u = 0; u < upserts; ++u)
+        {
+            if (cursor == end)
+            {
+                return Result::Malformed;
+            }
+
+            uint8_t const tag = *cursor++;
+            if ((tag & UnknownTagBits) || ((tag & DeviceMask) > static_cast<uint8_t>(PointerDeviceKind::Mouse)) ||
+                !ReadId(cursor, end, u == 0, id))
+            {
+                return Result::Malformed;
+            }
+
+            for (; (b < baseCount) && ((*base)[b].Id < id); ++b)
+            {
+                m_scratch.push_back((*base)[b]);
+                m_upserted.push_back(false);
+            }
+
+            bool const isNew = (tag & NewFlag) != 0;
+            bool const inBase = (b < baseCount) && ((*base)[b].Id == id);
+            if (isNew == inBase)
+            {
+                return Result::Malformed;
+            }
+
+            Entry const& then = isNew ? ZeroEntry : (*base)[b++];
+            Entry entry{ id, then.X, then.Y, then.Pressure, static_cast<PointerDeviceKind>(tag & DeviceMask), (tag & PressedFlag) != 0 };
+            if (((tag & XFlag) && !ReadField(cursor, end, then.X, entry.X)) ||
+                ((tag & YFlag) && !ReadField(cursor, end, then.Y, entry.Y)) ||
+                ((tag & PressureFlag) && !ReadField(cursor, end, then.Pressure, entry.Pressure)))
+            {
+                return Result::Malformed;
+            }
+
+            m_scratch.push_back(entry);
+            m_upserted.push_back(true);
+        }
+
+        for (; b < baseCount; ++b)
+        {
+            m_scratch.push_back((*base)[b]);
+            m_upserted.push_back(false);
+        }
+
+        // Removed IDs must be base pointers that weren't also upserted
+        size_t kept = 0;
+        size_t s = 0;
+        for (uint64_t r = 0; r < removals; ++r)
+        {
+            if (!ReadId(cursor, end, r == 0, id))
+            {
+                return Result::Malformed;
+            }
+
+            for (; (s < m_scratch.size()) && (m_scratch[s].Id < id); ++s)
+            {
+                m_scratch[kept++] = m_scratch[s];
+            }
+
+            if ((s == m_scratch.size()) || (m_scratch[s].Id != id) || m_upserted[s])
+            {
+                return Result::Malformed;
+            }
+
+            ++s;
+        }
+
+        for (; s < m_scratch.size(); ++s)
+        {
+            m_scratch[kept++] = m_scratch[s];
+        }
+
+        m_scratch.resize(kept);
+        if (cursor != end)
+        {
+            return Result::Malformed;
+        }
+
+        if (m_scratch.size() > pointers.Capacity())
+        {
+            return Result::Overflow;
+        }
+
+        m_history.Store(sequence).swap(m_scratch);
+        m_lastSequence = sequence;
+        m_hasDecoded = true;
+
+        float const inversePositionScale = 1.0f / PointerStateCodec::PositionScale;
+        float const inversePressureScale = 1.0f / PointerStateCodec::PressureScale;
+        std::vector<Entry> const& entries = *m_history.Find(sequence);
+
+        // Usually the table still holds the previous frame's pointers in the
+        // same order, and can be updated in place instead of rebuilt, which
+        // clears its whole ID index and probes it again on every Insert
+        bool sameLayout = pointers.Size() == entries.size();
+        for (size_t i = 0; sameLayout && (i < entries.size()); ++i)
+        {
+            sameLayout = (pointers.Id(i) == entries[i].Id) && (pointers.Type(i) == entries[i].DeviceKind);
+        }
+
+        if (!sameLayout)
+        {
+            pointers.Clear();
+        }
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            Entry const& entry = entries[i];
+            Point const position{ static_cast<float>(entry.X) * inversePositionScale, static_cast<float>(entry.Y) * inversePositionScale };
+            size_t const index = sameLayout ? i : pointers.Insert(entry.Id, entry.DeviceKind, entry.Pressed, position);
+            pointers.SetPosition(index, position);
+            pointers.SetPressed(index, entry.Pressed);
+            pointers.SetPressure(index, static_cast<float>(entry.Pressure) * inversePressureScale);
+        }
+
+        return Result::Decoded;
+    }
+}
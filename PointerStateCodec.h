@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+
+namespace PointerCore
+{
+    // Delta-encoded pointer table frames, for mirroring one panel's pointers
+    // to observer views
+    //
+    // Each frame describes a whole PointerTable. A keyframe lists every
+    // pointer; any other frame only lists what changed since a base frame the
+    // receiver has acknowledged, so a frame where nothing moved is a few
+    // bytes. Pointers are sorted by ID on both sides.
+    //
+    //   Frame
+    //     uint8    Header: bit 0 keyframe, bits 4-7 format version
+    //     varint   Sequence number
+    //     varint   Sequence minus the base frame's sequence (omitted for keyframes)
+    //     varint   Number of upserted pointers
+    //     varint   Number of removed pointers (omitted for keyframes)
+    //     Upserts, in ascending ID order
+    //       uint8    Tag: bits 0-1 device kind, bit 2 pressed, bit 3 X follows,
+    //                bit 4 Y follows, bit 5 pressure follows, bit 6 new pointer
+    //       varint   ID minus the previous upsert's ID (the first is absolute)
+    //       varint   Zigzag X delta from the base, in fixed-point units
+    //       varint   Zigzag Y delta from the base, in fixed-point units
+    //       varint   Zigzag pressure delta from the base, in 1/PressureScale units
+    //     Removals, in ascending ID order
+    //       varint   ID minus the previous removal's ID (the first is absolute)
+    //
+    // New pointers are coded against a zero position and pressure, and a
+    // coordinate that didn't change is left out. Positions are quantized to
+    // 1/PositionScale DIPs; timestamps and pending input times aren't sent.
+    namespace PointerStateCodec
+    {
+        constexpr uint8_t Version = 1;
+        constexpr uint32_t PositionScale = 64;
+        constexpr uint32_t PressureScale = 1024;
+
+        struct Options
+        {
+            // A keyframe is sent at least this often, so a receiver that
+            // lost its state recovers even without asking for one
+            uint32_t KeyframeInterval = 120;
+
+            // Frames kept by either side to serve as a base. An acknowledgement
+            // older than this is ignored and the next frame is a keyframe.
+            uint32_t HistoryLength = 32;
+        };
+
+        // A pointer in fixed-point units
+        struct Entry
+        {
+            uint32_t Id;
+            int32_t X;
+            int32_t Y;
+            int32_t Pressure;
+            PointerDeviceKind DeviceKind;
+            bool Pressed;
+        };
+
+        // The states of the last few frames, indexed by sequence number
+        class FrameHistory
+        {
+        public:
+            explicit FrameHistory(uint32_t length);
+
+            // The entries of the given frame, or null if it has been overwritten
+            std::vector<Entry> const* Find(uint64_t sequence) const noexcept;
+
+            // Clears and returns the slot for the given frame
+            std::vector<Entry>& Store(uint64_t sequence);
+
+            uint32_t Length() const noexcept { return static_cast<uint32_t>(m_frames.size()); }
+
+        private:
+            struct Frame
+            {
+                uint64_t Sequence{ 0 };
+                bool Valid{ false };
+                std::vector<Entry> Entries;
+            };
+
+            std::vector<Frame> m_frames;
+        };
+    }
+
+    // Presenter side. Encodes a PointerTable per frame against the latest
+    // acknowledged frame.
+    //
+    // When broadcasting to several observers, acknowledge the oldest
+    // sequence any of them has decoded, so every observer has the base.
+    class PointerStateEncoder
+    {
+    public:
+        using Options = PointerStateCodec::Options;
+
+        PointerStateEncoder();
+        explicit PointerStateEncoder(Options const& options);
+
+        // Appends the encoded frame to out and returns its sequence number
+        uint64_t Encode(PointerTable const& pointers, std::vector<uint8_t>& out);
+
+        // Records that the receiver(s) decoded the given frame, making it the
+        // base for the following ones. Older acknowledgements are ignored.
+        void Acknowledge(uint64_t sequence) noexcept;
+
+        // Makes the next frame a keyframe, e.g. when an observer joins
+        void RequestKeyframe() noexcept { m_keyframeRequested = true; }
+
+        uint64_t FrameCount() const noexcept { return m_frameCount; }
+        uint64_t KeyframeCount() const noexcept { return m_keyframeCount; }
+
+    private:
+        Options m_options;
+        PointerStateCodec::FrameHistory m_history;
+
+        // Table indices sorted by ID, for the table's ID column as of m_orderIds
+        std::vector<uint32_t> m_order;
+        std::vector<uint32_t> m_orderIds;
+
+        uint64_t m_frameCount{ 0 };
+        uint64_t m_keyframeCount{ 0 };
+        uint64_t m_lastKeyframe{ 0 };
+        uint64_t m_acknowledged{ 0 };
+        bool m_hasAcknowledged{ false };
+        bool m_keyframeRequested{ false };
+    };
+
+    // Observer side. Rebuilds the presenter's PointerTable from encoded frames.
+    class PointerStateDecoder
+    {
+    public:
+        using Options = PointerStateCodec::Options;
+
+        enum class Result
+        {
+            Decoded,
+
+            // The frame is cut short or inconsistent with its base
+            Malformed,
+
+            // The base frame was never received or has been overwritten;
+            // wait for (or request) a keyframe
+            MissingBase,
+
+            // More pointers than the output table can hold
+            Overflow,
+
+            // Not newer than the last decoded frame; dropped
+            Stale,
+        };
+
+        PointerStateDecoder();
+        explicit PointerStateDecoder(Options const& options);
+
+        // Decodes a frame into pointers, which is only modified on success.
+        // Pressures are restored; timestamps are zero.
+        Result Decode(uint8_t const* data, size_t size, PointerTable& pointers);
+
+        // Sequence number of the newest decoded frame, to acknowledge to the encoder
+        uint64_t LastSequence() const noexcept { return m_lastSequence; }
+        bool HasDecoded() const noexcept { return m_hasDecoded; }
+
+    private:
+        PointerStateCodec::FrameHistory m_history;
+        std::vector<PointerStateCodec::Entry> m_scratch;
+        std::vector<bool> m_upserted;
+
+        uint64_t m_lastSequence{ 0 };
+        bool m_hasDecoded{ false };
+    };
+}
@@ -0,0 +1,162 @@
+#include "PointerTable.h"
+
+#include <algorithm>
+
+namespace PointerCore
+{
+    static inline int PopCount(uint64_t value) noexcept
+    {
+        int count = 0;
+        while (value != 0)
+        {
+            value &= value - 1;
+            ++count;
+        }
+
+        return count;
+    }
+
+    static inline uint32_t SlotBits(size_t capacity) noexcept
+    {
+        uint32_t bits = 1;
+        while ((size_t{ 1 } << bits) < 2 * capacity)
+        {
+            ++bits;
+        }
+
+        return bits;
+    }
+
+    PointerTable::PointerTable(size_t capacity)
+        : m_slots(size_t{ 1 } << SlotBits(capacity))
+        , m_slotMask{ (size_t{ 1 } << SlotBits(capacity)) - 1 }
+        , m_slotShift{ 32 - SlotBits(capacity) }
+        , m_ids(capacity)
+        , m_x(capacity)
+        , m_y(capacity)
+        , m_pressures(capacity)
+        , m_types(capacity)
+        , m_pressedBits((capacity + 63) / 64)
+        , m_pendingInputTimes(capacity)
+        , m_timestamps(capacity)
+    {
+    }
+
+    size_t PointerTable::SlotOf(size_t index) const noexcept
+    {
+        size_t slot = HomeSlot(m_ids[index]);
+        while (m_slots[slot] != index + 1)
+        {
+            slot = (slot + 1) & m_slotMask;
+        }
+
+        return slot;
+    }
+
+    size_t PointerTable::Insert(uint32_t id, PointerDeviceKind type, bool pressed, Point position) noexcept
+    {
+        if (Full())
+        {
+            return npos;
+        }
+
+        size_t slot = HomeSlot(id);
+        for (; m_slots[slot] != 0; slot = (slot + 1) & m_slotMask)
+        {
+            if (m_ids[m_slots[slot] - 1] == id)
+            {
+                return npos;
+            }
+        }
+
+        size_t const index = m_size++;
+        m_slots[slot] = static_cast<uint32_t>(index + 1);
+        m_ids[index] = id;
+        m_types[index] = type;
+        SetPosition(index, position);
+        SetPressed(index, pressed);
+        m_pressures[index] = 0.0f;
+        m_pendingInputTimes[index] = 0;
+        m_timestamps[index] = 0;
+
+        return index;
+    }
+
+    bool PointerTable::Erase(uint32_t id) noexcept
+    {
+        size_t const index = Find(id);
+        if (index == npos)
+        {
+            return false;
+        }
+
+        EraseAt(index);
+        return true;
+    }
+
+    void PointerTable::EraseAt(size_t index) noexcept
+    {
+        // Take the entry out of the index, shifting back later entries of the
+        // probe run that would otherwise become unreachable
+        size_t hole = SlotOf(index);
+        for (size_t next = (hole + 1) & m_slotMask; m_slots[next] != 0; next = (next + 1) & m_slotMask)
+        {
+            size_t const home = HomeSlot(m_ids[m_slots[next] - 1]);
+            if (((next - home) & m_slotMask) >= ((next - hole) & m_slotMask))
+            {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+        }
+        m_slots[hole] = 0;
+
+        // Keep the table dense by moving the last entry into the hole
+        size_t const last = --m_size;
+        if (index != last)
+        {
+            m_slots[SlotOf(last)] = static_cast<uint32_t>(index + 1);
+            m_ids[index] = m_ids[last];
+            m_types[index] = m_types[last];
+            m_x[index] = m_x[last];
+            m_y[index] = m_y[last];
+            m_pressures[index] = m_pressures[last];
+            m_pendingInputTimes[index] = m_pendingInputTimes[last];
+            m_timestamps[index] = m_timestamps[last];
+            SetPressed(index, IsPressed(last));
+        }
+
+        SetPressed(last, false);
+    }
+
+    void PointerTable::Clear() noexcept
+    {
+        m_size = 0;
+        std::fill(m_pressedBits.begin(), m_pressedBits.end(), uint64_t{ 0 });
+        std::fill(m_slots.begin(), m_slots.end(), 0u);
+    }
+
+    bool PointerTable::AnyPressed() const noexcept
+    {
+        // Bits past Size() are always kept clear, so whole words can be tested
+        for (uint64_t word : m_pressedBits)
+        {
+            if (word != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    size_t PointerTable::PressedCount() const noexcept
+    {
+        size_t count = 0;
+        for (uint64_t word : m_pressedBits)
+        {
+            count += PopCount(word);
+        }
+
+        return count;
+    }
+}
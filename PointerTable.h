@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Fixed-capacity table of live pointers.
+    //
+    // Storage is structure-of-arrays and kept dense: entries [0, Size()) are
+    // always valid, and removal swaps the last entry into the hole, so
+    // Render()'s walk over the table is a sequential read. Lookups go through
+    // a small open-addressed index from ID to entry, at most half full, so a
+    // move costs about one probe however many pointers are down (a linear scan
+    // of the ID column mispredicts its way to losing against a hash map from
+    // two pointers on).
+    //
+    // Indices are only stable until the next Insert/Erase.
+    class PointerTable
+    {
+    public:
+        static constexpr size_t DefaultCapacity = 256;
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        explicit PointerTable(size_t capacity = DefaultCapacity);
+
+        size_t Size() const noexcept { return m_size; }
+        size_t Capacity() const noexcept { return m_ids.size(); }
+        bool Empty() const noexcept { return m_size == 0; }
+        bool Full() const noexcept { return m_size == m_ids.size(); }
+
+        // Returns the index of the pointer with the given ID, or npos
+        size_t Find(uint32_t id) const noexcept
+        {
+            for (size_t slot = HomeSlot(id);; slot = (slot + 1) & m_slotMask)
+            {
+                uint32_t const entry = m_slots[slot];
+                if (entry == 0)
+                {
+                    return npos;
+                }
+
+                if (m_ids[entry - 1] == id)
+                {
+                    return entry - 1;
+                }
+            }
+        }
+
+        // Returns the index of the new entry, or npos if the ID is already
+        // present or the table is full
+        size_t Insert(uint32_t id, PointerDeviceKind type, bool pressed, Point position) noexcept;
+
+        // Returns false if the ID wasn't present
+        bool Erase(uint32_t id) noexcept;
+        void EraseAt(size_t index) noexcept;
+        void Clear() noexcept;
+
+        // Per-entry access
+        uint32_t Id(size_t index) const noexcept { return m_ids[index]; }
+        PointerDeviceKind Type(size_t index) const noexcept { return m_types[index]; }
+        Point Position(size_t index) const noexcept { return { m_x[index], m_y[index] }; }
+        bool IsPressed(size_t index) const noexcept { return (m_pressedBits[index / 64] >> (index % 64)) & 1; }
+        float Pressure(size_t index) const noexcept { return m_pressures[index]; }
+        void SetPressure(size_t index, float pressure) noexcept { m_pressures[index] = pressure; }
+
+        // Receive time of the oldest input applied to the entry since it was
+        // last presented, or zero. Only maintained while latency is measured.
+        uint64_t PendingInputTime(size_t index) const noexcept { return m_pendingInputTimes[index]; }
+        void SetPendingInputTime(size_t index, uint64_t time) noexcept { m_pendingInputTimes[index] = time; }
+
+        // Timestamp of the sample the entry's position came from, in microseconds
+        uint64_t Timestamp(size_t index) const noexcept { return m_timestamps[index]; }
+        void SetTimestamp(size_t index, uint64_t timestamp) noexcept { m_timestamps[index] = timestamp; }
+
+        void SetPosition(size_t index, Point position) noexcept
+        {
+            m_x[index] = position.X;
+            m_y[index] = position.Y;
+        }
+
+        void SetPressed(size_t index, bool pressed) noexcept
+        {
+            uint64_t const mask = uint64_t{ 1 } << (index % 64);
+            if (pressed)
+            {
+                m_pressedBits[index / 64] |= mask;
+            }
+            else
+            {
+                m_pressedBits[index / 64] &= ~mask;
+            }
+        }
+
+        bool AnyPressed() const noexcept;
+        size_t PressedCount() const noexcept;
+
+        // Column access for dense iteration over [0, Size())
+        uint32_t const* Ids() const noexcept { return m_ids.data(); }
+        float const* X() const noexcept { return m_x.data(); }
+        float const* Y() const noexcept { return m_y.data(); }
+        float const* Pressures() const noexcept { return m_pressures.data(); }
+        PointerDeviceKind const* Types() const noexcept { return m_types.data(); }
+        uint64_t const* PressedBits() const noexcept { return m_pressedBits.data(); }
+        uint64_t const* PendingInputTimes() const noexcept { return m_pendingInputTimes.data(); }
+        uint64_t const* Timestamps() const noexcept { return m_timestamps.data(); }
+
+    private:
+        size_t HomeSlot(uint32_t id) const noexcept { return static_cast<uint32_t>(id * 2654435769u) >> m_slotShift; }
+        size_t SlotOf(size_t index) const noexcept;
+
+        size_t m_size{ 0 };
+
+        // ID index: entry index + 1 per slot, zero when empty, linear probing.
+        // There are at least twice as many slots as the capacity.
+        std::vector<uint32_t> m_slots;
+        size_t m_slotMask;
+        uint32_t m_slotShift;
+
+        std::vector<uint32_t> m_ids;
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_pressures;
+        std::vector<PointerDeviceKind> m_types;
+        std::vector<uint64_t> m_pressedBits;
+        std::vector<uint64_t> m_pendingInputTimes;
+        std::vector<uint64_t> m_timestamps;
+    };
+}
@@ -0,0 +1,284 @@
+#include "PointerTrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "Varint.h"
+
+namespace PointerCore
+{
+    namespace
+    {
+        constexpr uint8_t KindMask = 0x07;
+        constexpr uint8_t DeviceShift = 3;
+        constexpr uint8_t DeviceMask = 0x03;
+        constexpr uint8_t InContactFlag = 0x20;
+        constexpr uint8_t SameIdFlag = 0x40;
+        constexpr uint8_t PressureFlag = 0x80;
+
+        template <typename T>
+        void WriteLittleEndian(std::vector<uint8_t>& out, T value)
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+            }
+        }
+
+        template <typename T>
+        T ReadLittleEndian(uint8_t const* data) noexcept
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value |= static_cast<uint64_t>(data[i]) << (8 * i);
+            }
+
+            return static_cast<T>(value);
+        }
+
+        // Readers reject positions outside int32, and lround is undefined
+        // for non-finite values, so positions are clamped (NaN records 0)
+        int64_t Quantize(float value) noexcept
+        {
+            constexpr float Limit = 2147483520.0f;  // Largest float below 2^31
+            if (std::isnan(value))
+            {
+                return 0;
+            }
+
+            return static_cast<int64_t>(std::lround(std::clamp(value * PointerTrace::DefaultPositionScale, -Limit, Limit)));
+        }
+
+        constexpr int64_t DefaultPressure = PointerTrace::PressureScale / 2;
+
+        int64_t QuantizePressure(float pressure) noexcept
+        {
+            if (std::isnan(pressure))
+            {
+                return DefaultPressure;
+            }
+
+            return static_cast<int64_t>(std::lround(std::clamp(pressure, 0.0f, 1.0f) * PointerTrace::PressureScale));
+        }
+
+        // Whether last + delta lands in [low, high], for a last value already
+        // in that range, without overflowing on the way
+        bool AddsWithin(int64_t last, int64_t delta, int64_t low, int64_t high) noexcept
+        {
+            return (delta >= low - last) && (delta <= high - last);
+        }
+    }
+
+    PointerTraceWriter::~PointerTraceWriter()
+    {
+        Close();
+    }
+
+    bool PointerTraceWriter::Open(std::filesystem::path const& path)
+    {
+        Close();
+
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            return false;
+        }
+
+        Reset();
+        m_toFile = true;
+        return true;
+    }
+
+    void PointerTraceWriter::OpenInMemory()
+    {
+        Close();
+        Reset();
+    }
+
+    void PointerTraceWriter::Close()
+    {
+        if (!m_isOpen)
+        {
+            return;
+        }
+
+        if (m_eventCount == 0)
+        {
+            WriteHeader(0);
+        }
+
+        if (m_toFile)
+        {
+            Flush();
+            m_file.close();
+        }
+
+        m_isOpen = false;
+        m_toFile = false;
+    }
+
+    void PointerTraceWriter::Reset()
+    {
+        m_buffer.clear();
+        m_isOpen = true;
+        m_eventCount = 0;
+        m_lastTimestamp = 0;
+        m_lastId = 0;
+        m_lastX = 0;
+        m_lastY = 0;
+        m_lastPressure = DefaultPressure;
+    }
+
+    void PointerTraceWriter::WriteHeader(uint64_t startTimestamp)
+    {
+        m_buffer.insert(m_buffer.end(), std::begin(PointerTrace::Magic), std::end(PointerTrace::Magic));
+        WriteLittleEndian(m_buffer, PointerTrace::Version);
+        WriteLittleEndian(m_buffer, PointerTrace::HeaderSize);
+        WriteLittleEndian(m_buffer, PointerTrace::DefaultPositionScale);
+        WriteLittleEndian(m_buffer, startTimestamp);
+    }
+
+    void PointerTraceWriter::Flush()
+    {
+        m_file.write(reinterpret_cast<char const*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+    void PointerTraceWriter::Write(PointerEvent const& event)
+    {
+        if (!m_isOpen)
+        {
+            return;
+        }
+
+        if (m_eventCount == 0)
+        {
+            // The header carries the first timestamp so every record only stores a delta
+            WriteHeader(event.Timestamp);
+            m_lastTimestamp = event.Timestamp;
+        }
+
+        bool const sameId = (m_eventCount != 0) && (event.Id == m_lastId);
+        int64_t const pressure = QuantizePressure(event.Pressure);
+
+        uint8_t tag = static_cast<uint8_t>(event.Kind) & KindMask;
+        tag |= static_cast<uint8_t>((static_cast<uint8_t>(event.DeviceKind) & DeviceMask) << DeviceShift);
+        tag |= event.InContact ? InContactFlag : 0;
+        tag |= sameId ? SameIdFlag : 0;
+        tag |= (pressure != m_lastPressure) ? PressureFlag : 0;
+        m_buffer.push_back(tag);
+
+        Varint::WriteSigned(m_buffer, static_cast<int64_t>(event.Timestamp - m_lastTimestamp));
+        if (!sameId)
+        {
+            Varint::Write(m_buffer, event.Id);
+        }
+
+        int64_t const x = Quantize(event.X);
+        int64_t const y = Quantize(event.Y);
+        Varint::WriteSigned(m_buffer, x - m_lastX);
+        Varint::WriteSigned(m_buffer, y - m_lastY);
+        if (pressure != m_lastPressure)
+        {
+            Varint::WriteSigned(m_buffer, pressure - m_lastPressure);
+        }
+
+        m_lastTimestamp = event.Timestamp;
+        m_lastId = event.Id;
+        m_lastX = x;
+        m_lastY = y;
+        m_lastPressure = pressure;
+        ++m_eventCount;
+
+        if (m_toFile && (m_buffer.size() >= FlushThreshold))
+        {
+            Flush();
+        }
+    }
+
+    PointerTraceReader::PointerTraceReader(uint8_t const* data, size_t size) noexcept
+        : m_begin{ data }
+        , m_end{ data + size }
+    {
+        if ((data == nullptr) || (size < PointerTrace::HeaderSize) || (std::memcmp(data, PointerTrace::Magic, sizeof(PointerTrace::Magic)) != 0))
+        {
+            return;
+        }
+
+        m_version = ReadLittleEndian<uint16_t>(data + 4);
+        auto const headerSize = ReadLittleEndian<uint16_t>(data + 6);
+        auto const positionScale = ReadLittleEndian<uint32_t>(data + 8);
+        m_startTimestamp = ReadLittleEndian<uint64_t>(data + 12);
+
+        if ((m_version > PointerTrace::Version) || (headerSize < PointerTrace::HeaderSize) || (headerSize > size) || (positionScale == 0))
+        {
+            return;
+        }
+
+        m_inverseScale = 1.0f / static_cast<float>(positionScale);
+        m_records = m_begin + headerSize;
+        m_valid = true;
+        Rewind();
+    }
+
+    void PointerTraceReader::Rewind() noexcept
+    {
+        m_cursor = m_records;
+        m_corrupt = false;
+        m_lastTimestamp = m_startTimestamp;
+        m_lastId = 0;
+        m_lastX = 0;
+        m_lastY = 0;
+        m_lastPressure = DefaultPressure;
+    }
+
+    bool PointerTraceReader::Next(PointerEvent& event) noexcept
+    {
+        if (!m_valid || m_corrupt || (m_cursor == m_end))
+        {
+            return false;
+        }
+
+        uint8_t const* cursor = m_cursor;
+        uint8_t const tag = *cursor++;
+
+        int64_t timestampDelta;
+        uint64_t id = m_lastId;
+        int64_t dx;
+        int64_t dy;
+        int64_t pressureDelta = 0;
+        if (((tag & KindMask) > static_cast<uint8_t>(PointerEventKind::Released)) ||
+            (((tag >> DeviceShift) & DeviceMask) > static_cast<uint8_t>(PointerDeviceKind::Mouse)) ||
+            !Varint::ReadSigned(cursor, m_end, timestampDelta) ||
+            (((tag & SameIdFlag) == 0) && (!Varint::Read(cursor, m_end, id) || (id > UINT32_MAX))) ||
+            !Varint::ReadSigned(cursor, m_end, dx) || !AddsWithin(m_lastX, dx, INT32_MIN, INT32_MAX) ||
+            !Varint::ReadSigned(cursor, m_end, dy) || !AddsWithin(m_lastY, dy, INT32_MIN, INT32_MAX) ||
+            ((m_version >= 2) && ((tag & PressureFlag) != 0) &&
+                (!Varint::ReadSigned(cursor, m_end, pressureDelta) || !AddsWithin(m_lastPressure, pressureDelta, 0, PointerTrace::PressureScale))))
+        {
+            m_corrupt = true;
+            return false;
+        }
+
+        m_cursor = cursor;
+        m_lastTimestamp += static_cast<uint64_t>(timestampDelta);
+        m_lastId = static_cast<uint32_t>(id);
+        m_lastX += dx;
+        m_lastY += dy;
+        m_lastPressure += pressureDelta;
+
+        event.Timestamp = m_lastTimestamp;
+        event.ReceivedTime = 0;
+        event.Id = m_lastId;
+        event.X = static_cast<float>(m_lastX) * m_inverseScale;
+        event.Y = static_cast<float>(m_lastY) * m_inverseScale;
+        event.Pressure = static_cast<float>(m_lastPressure) / PointerTrace::PressureScale;
+        event.Kind = static_cast<PointerEventKind>(tag & KindMask);
+        event.DeviceKind = static_cast<PointerDeviceKind>((tag >> DeviceShift) & DeviceMask);
+        event.InContact = (tag & InContactFlag) != 0;
+        return true;
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Binary pointer trace format
+    //
+    // A trace is a fixed header followed by a stream of variable-length event
+    // records. All multi-byte header fields are little-endian.
+    //
+    //   Header
+    //     char[4]  Magic ("PTRC")
+    //     uint16   Version
+    //     uint16   Header size in bytes (readers skip anything they don't know)
+    //     uint32   Position scale (fixed-point units per DIP)
+    //     uint64   Timestamp of the first event, in microseconds
+    //
+    //   Event record
+    //     uint8    Tag: bits 0-2 kind, bits 3-4 device kind, bit 5 in contact,
+    //              bit 6 set when the pointer ID is the same as the previous record's,
+    //              bit 7 set when the pressure differs from the previous record's (version 2)
+    //     varint   Zigzag timestamp delta from the previous record
+    //     varint   Pointer ID (omitted when bit 6 of the tag is set)
+    //     varint   Zigzag X delta from the previous record, in fixed-point units
+    //     varint   Zigzag Y delta from the previous record, in fixed-point units
+    //     varint   Zigzag pressure delta from the previous record, in 1/PressureScale
+    //              units (only when bit 7 of the tag is set)
+    //
+    // Positions are quantized to 1/PositionScale DIPs and clamped to the int32
+    // range (NaN is written as 0), pressure to 1/PressureScale and clamped to
+    // [0, 1]. Pressure starts out at 0.5, what devices without pressure report,
+    // so their records never carry it. Version 1 traces have no pressure and
+    // read back as 0.5. Records that leave these ranges are corrupt.
+    namespace PointerTrace
+    {
+        constexpr char Magic[4] = { 'P', 'T', 'R', 'C' };
+        constexpr uint16_t Version = 2;
+        constexpr uint16_t HeaderSize = 20;
+        constexpr uint32_t DefaultPositionScale = 64;
+        constexpr uint32_t PressureScale = 4096;
+    }
+
+    // Encodes pointer events into the trace format, either into memory or
+    // streamed to a file
+    class PointerTraceWriter
+    {
+    public:
+        PointerTraceWriter() = default;
+        ~PointerTraceWriter();
+
+        PointerTraceWriter(PointerTraceWriter const&) = delete;
+        PointerTraceWriter& operator=(PointerTraceWriter const&) = delete;
+
+        // Starts a new trace streamed to the given file. Returns false if the
+        // file can't be created.
+        bool Open(std::filesystem::path const& path);
+
+        // Starts a new trace kept in memory, see Buffer()
+        void OpenInMemory();
+
+        // Flushes and closes the trace
+        void Close();
+
+        bool IsOpen() const noexcept { return m_isOpen; }
+        void Write(PointerEvent const& event);
+
+        // Encoded bytes not yet flushed to the file; the whole trace when in memory
+        std::vector<uint8_t> const& Buffer() const noexcept { return m_buffer; }
+        uint64_t EventCount() const noexcept { return m_eventCount; }
+
+    private:
+        static constexpr size_t FlushThreshold = 64 * 1024;
+
+        void Reset();
+        void WriteHeader(uint64_t startTimestamp);
+        void Flush();
+
+        std::ofstream m_file;
+        std::vector<uint8_t> m_buffer;
+        bool m_isOpen{ false };
+        bool m_toFile{ false };
+
+        uint64_t m_eventCount{ 0 };
+        uint64_t m_lastTimestamp{ 0 };
+        uint32_t m_lastId{ 0 };
+        int64_t m_lastX{ 0 };
+        int64_t m_lastY{ 0 };
+        int64_t m_lastPressure{ 0 };
+    };
+
+    // Decodes a trace from memory (e.g. a MappedFile). The data must outlive the reader.
+    class PointerTraceReader
+    {
+    public:
+        PointerTraceReader(uint8_t const* data, size_t size) noexcept;
+
+        // False if the header is missing, has the wrong magic, or a newer major version
+        bool IsValid() const noexcept { return m_valid; }
+
+        // True if decoding stopped on a truncated or malformed record
+        bool IsCorrupt() const noexcept { return m_corrupt; }
+
+        uint16_t Version() const noexcept { return m_version; }
+        uint64_t StartTimestamp() const noexcept { return m_startTimestamp; }
+
+        // Decodes the next event. Returns false at the end of the trace or on corruption.
+        bool Next(PointerEvent& event) noexcept;
+
+        // Restarts decoding from the first event
+        void Rewind() noexcept;
+
+    private:
+        uint8_t const* m_begin;
+        uint8_t const* m_end;
+        uint8_t const* m_records{ nullptr };
+        uint8_t const* m_cursor{ nullptr };
+
+        bool m_valid{ false };
+        bool m_corrupt{ false };
+        uint16_t m_version{ 0 };
+        float m_inverseScale{ 1.0f };
+        uint64_t m_startTimestamp{ 0 };
+
+        uint64_t m_lastTimestamp{ 0 };
+        uint32_t m_lastId{ 0 };
+        int64_t m_lastX{ 0 };
+        int64_t m_lastY{ 0 };
+        int64_t m_lastPressure{ 0 };
+    };
+
+    enum class ReplayPacing
+    {
+        // Deliver events back to back
+        AsFastAsPossible,
+
+        // Deliver events spaced out by their recorded timestamps (scaled by speed)
+        RealTime,
+    };
+
+    // Feeds every event of the trace into sink(PointerEvent const&) and returns
+    // the number of events delivered. Replays from the reader's current position.
+    template <typename Sink>
+    size_t ReplayPointerTrace(PointerTraceReader& reader, Sink&& sink, ReplayPacing pacing = ReplayPacing::AsFastAsPossible, double speed = 1.0)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        size_t delivered = 0;
+        PointerEvent event;
+        Clock::time_point replayStart{};
+        uint64_t traceStart = 0;
+
+        while (reader.Next(event))
+        {
+            if (pacing == ReplayPacing::RealTime)
+            {
+                if (delivered == 0)
+                {
+                    replayStart = Clock::now();
+                    traceStart = event.Timestamp;
+                }
+                else if (event.Timestamp > traceStart)
+                {
+                    auto const offset = std::chrono::duration<double, std::micro>((event.Timestamp - traceStart) / speed);
+                    std::this_thread::sleep_until(replayStart + std::chrono::duration_cast<Clock::duration>(offset));
+                }
+            }
+
+            sink(static_cast<PointerEvent const&>(event));
+            ++delivered;
+        }
+
+        return delivered;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+// Platform-neutral pointer types shared by the portable pointer core. Nothing
+// in here (or in anything that only includes this header) may depend on
+// Windows or C++/WinRT headers, so the core can be built and profiled off-Windows.
+namespace PointerCore
+{
+    // Values mirror Windows::Devices::Input::PointerDeviceType so the two can
+    // be converted with a static_cast
+    enum class PointerDeviceKind : uint8_t
+    {
+        Touch = 0,
+        Pen = 1,
+        Mouse = 2,
+    };
+
+    struct Point
+    {
+        float X;
+        float Y;
+    };
+
+    enum class PointerEventKind : uint8_t
+    {
+        Entered,
+        Exited,
+        Moved,
+        Pressed,
+        Released,
+    };
+
+    // Compact, trivially copyable snapshot of one input event, as captured by
+    // the PointerRenderer input handlers
+    struct PointerEvent
+    {
+        uint64_t Timestamp;
+
+        // FrameInstrumentation::Now() when the handler saw the event, or zero
+        // when latency instrumentation is off. Not stored in traces.
+        uint64_t ReceivedTime;
+
+        uint32_t Id;
+        float X;
+        float Y;
+
+        // Normalized to [0, 1]; devices without pressure report 0.5 while in contact
+        float Pressure;
+
+        PointerEventKind Kind;
+        PointerDeviceKind DeviceKind;
+        bool InContact;
+    };
+
+    // A single positional sample, timestamped in microseconds (the same units
+    // as PointerPoint::Timestamp)
+    struct PointerSample
+    {
+        float X;
+        float Y;
+        uint64_t Timestamp;
+        float Pressure;
+    };
+}
@@ -0,0 +1,3 @@
+#include "pch.h"
+#include "RegionHoverEventArgs.h"
+#include "RegionHoverEventArgs.g.cpp"
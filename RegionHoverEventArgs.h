@@ -0,0 +1,25 @@
+#pragma once
+
+#include "RegionHoverEventArgs.g.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    struct RegionHoverEventArgs : RegionHoverEventArgsT<RegionHoverEventArgs>
+    {
+        RegionHoverEventArgs(uint32_t pointerId, uint32_t region, bool entered) noexcept
+            : m_pointerId{ pointerId }
+            , m_region{ region }
+            , m_entered{ entered }
+        {
+        }
+
+        uint32_t PointerId() const noexcept { return m_pointerId; }
+        uint32_t Region() const noexcept { return m_region; }
+        bool Entered() const noexcept { return m_entered; }
+
+    private:
+        uint32_t m_pointerId;
+        uint32_t m_region;
+        bool m_entered;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include "RegionIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PointerCore
+{
+    static constexpr uint32_t SlotBits = 24;
+    static constexpr uint32_t SlotMask = (uint32_t{ 1 } << SlotBits) - 1;
+
+    RegionIndex::RegionIndex()
+        : RegionIndex(Options{})
+    {
+    }
+
+    RegionIndex::RegionIndex(Options const& options)
+        : m_options{ options }
+        , m_cells(1)
+    {
+    }
+
+    void RegionIndex::Resize(float width, float height)
+    {
+        m_width = std::max(width, 0.0f);
+        m_height = std::max(height, 0.0f);
+        m_columns = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(m_width / m_options.CellSize)));
+        m_rows = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(m_height / m_options.CellSize)));
+
+        m_cells.clear();
+        m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+        for (uint32_t slot = 0; slot < m_used.size(); ++slot)
+        {
+            if (m_used[slot])
+            {
+                AddToCells(slot);
+            }
+        }
+    }
+
+    RegionIndex::CellRange RegionIndex::CellsFor(Rect const& bounds) const noexcept
+    {
+        // Clamp in floating point first, so far away regions can't overflow
+        auto column = [this](float x)
+        {
+            return static_cast<uint32_t>(std::clamp(std::floor(x / m_options.CellSize), 0.0f, static_cast<float>(m_columns - 1)));
+        };
+        auto row = [this](float y)
+        {
+            return static_cast<uint32_t>(std::clamp(std::floor(y / m_options.CellSize), 0.0f, static_cast<float>(m_rows - 1)));
+        };
+
+        return { column(bounds.Left), row(bounds.Top), column(bounds.Right), row(bounds.Bottom) };
+    }
+
+    void RegionIndex::AddToCells(uint32_t slot)
+    {
+        CellEntry const entry{ m_left[slot], m_top[slot], m_right[slot], m_bottom[slot], m_order[slot], slot };
+        CellRange const range = CellsFor({ entry.Left, entry.Top, entry.Right, entry.Bottom });
+        for (uint32_t row = range.Top; row <= range.Bottom; ++row)
+        {
+            for (uint32_t column = range.Left; column <= range.Right; ++column)
+            {
+                m_cells[static_cast<size_t>(row) * m_columns + column].push_back(entry);
+            }
+        }
+    }
+
+    void RegionIndex::RemoveFromCells(uint32_t slot)
+    {
+        CellRange const range = CellsFor({ m_left[slot], m_top[slot], m_right[slot], m_bottom[slot] });
+        for (uint32_t row = range.Top; row <= range.Bottom; ++row)
+        {
+            for (uint32_t column = range.Left; column <= range.Right; ++column)
+            {
+                // Cell order doesn't matter, so swap-remove
+                auto& cell = m_cells[static_cast<size_t>(row) * m_columns + column];
+                auto const itr = std::find_if(cell.begin(), cell.end(), [slot](CellEntry const& entry) { return entry.Slot == slot; });
+                if (itr != cell.end())
+                {
+                    *itr = cell.back();
+                    cell.pop_back();
+                }
+            }
+        }
+    }
+
+    uint32_t RegionIndex::SlotOf(RegionId region) const noexcept
+    {
+        uint32_t const slot = region & SlotMask;
+        if ((region == NoRegion) || (slot >= m_used.size()) || !m_used[slot] || (m_generation[slot] != (region >> SlotBits)))
+        {
+            return UINT32_MAX;
+        }
+
+        return slot;
+    }
+
+    RegionId RegionIndex::Insert(Rect const& bounds)
+    {
+        uint32_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else if (m_used.size() < MaxRegions - 1)
+        {
+            // The last slot is never used, so no handle can equal NoRegion
+            slot = static_cast<uint32_t>(m_used.size());
+            m_left.push_back(0);
+            m_top.push_back(0);
+            m_right.push_back(0);
+            m_bottom.push_back(0);
+            m_order.push_back(0);
+            m_generation.push_back(0);
+            m_used.push_back(false);
+        }
+        else
+        {
+            return NoRegion;
+        }
+
+        m_left[slot] = bounds.Left;
+        m_top[slot] = bounds.Top;
+        m_right[slot] = bounds.Right;
+        m_bottom[slot] = bounds.Bottom;
+        m_order[slot] = m_nextOrder++;
+        m_used[slot] = true;
+        ++m_size;
+
+        AddToCells(slot);
+        return (static_cast<RegionId>(m_generation[slot]) << SlotBits) | slot;
+    }
+
+    bool RegionIndex::Move(RegionId region, Rect const& bounds)
+    {
+        uint32_t const slot = SlotOf(region);
+        if (slot == UINT32_MAX)
+        {
+            return false;
+        }
+
+        RemoveFromCells(slot);
+        m_left[slot] = bounds.Left;
+        m_top[slot] = bounds.Top;
+        m_right[slot] = bounds.Right;
+        m_bottom[slot] = bounds.Bottom;
+        AddToCells(slot);
+        return true;
+    }
+
+    bool RegionIndex::Remove(RegionId region)
+    {
+        uint32_t const slot = SlotOf(region);
+        if (slot == UINT32_MAX)
+        {
+            return false;
+        }
+
+        RemoveFromCells(slot);
+        m_used[slot] = false;
+        ++m_generation[slot];
+        m_freeSlots.push_back(slot);
+        --m_size;
+        return true;
+    }
+
+    void RegionIndex::Clear() noexcept
+    {
+        // Keep the slots (and bump their generations) so old handles stay invalid
+        m_freeSlots.clear();
+        for (uint32_t slot = static_cast<uint32_t>(m_used.size()); slot-- > 0;)
+        {
+            if (m_used[slot])
+            {
+                m_used[slot] = false;
+                ++m_generation[slot];
+            }
+            m_freeSlots.push_back(slot);
+        }
+
+        for (auto& cell : m_cells)
+        {
+            cell.clear();
+        }
+        m_size = 0;
+    }
+
+    bool RegionIndex::Contains(RegionId region) const noexcept
+    {
+        return SlotOf(region) != UINT32_MAX;
+    }
+
+    Rect RegionIndex::Bounds(RegionId region) const noexcept
+    {
+        uint32_t const slot = SlotOf(region);
+        if (slot == UINT32_MAX)
+        {
+            return {};
+        }
+
+        return { m_left[slot], m_top[slot], m_right[slot], m_bottom[slot] };
+    }
+
+    RegionId RegionIndex::HitTest(Point point) const noexcept
+    {
+        CellRange const cell = CellsFor({ point.X, point.Y, point.X, point.Y });
+        auto const& entries = m_cells[static_cast<size_t>(cell.Top) * m_columns + cell.Left];
+
+        CellEntry const* best = nullptr;
+        for (auto const& entry : entries)
+        {
+            if ((point.X >= entry.Left) && (point.X < entry.Right) && (point.Y >= entry.Top) && (point.Y < entry.Bottom) &&
+                ((best == nullptr) || (entry.Order > best->Order)))
+            {
+                best = &entry;
+            }
+        }
+
+        return (best == nullptr) ? NoRegion : ((static_cast<RegionId>(m_generation[best->Slot]) << SlotBits) | best->Slot);
+    }
+
+    void RegionIndex::HitTest(PointerTable const& pointers, std::vector<RegionId>& out) const
+    {
+        out.resize(pointers.Size());
+        if (m_size == 0)
+        {
+            std::fill(out.begin(), out.end(), NoRegion);
+            return;
+        }
+
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            out[i] = HitTest({ xs[i], ys[i] });
+        }
+    }
+
+    void RegionHoverTracker::Update(PointerTable const& pointers, std::vector<RegionId> const& hits, std::vector<RegionEvent>& events)
+    {
+        m_current.clear();
+        for (size_t i = 0; (i < pointers.Size()) && (i < hits.size()); ++i)
+        {
+            if (hits[i] != NoRegion)
+            {
+                m_current.push_back({ pointers.Id(i), hits[i] });
+            }
+        }
+
+        std::sort(m_current.begin(), m_current.end(), [](Hover const& a, Hover const& b) { return a.PointerId < b.PointerId; });
+
+        // Merge join on pointer ID
+        auto previous = m_previous.begin();
+        auto current = m_current.begin();
+        while ((previous != m_previous.end()) || (current != m_current.end()))
+        {
+            if ((current == m_current.end()) || ((previous != m_previous.end()) && (previous->PointerId < current->PointerId)))
+            {
+                events.push_back({ previous->PointerId, previous->Region, false });
+                ++previous;
+            }
+            else if ((previous == m_previous.end()) || (current->PointerId < previous->PointerId))
+            {
+                events.push_back({ current->PointerId, current->Region, true });
+                ++current;
+            }
+            else
+            {
+                if (previous->Region != current->Region)
+                {
+                    events.push_back({ previous->PointerId, previous->Region, false });
+                    events.push_back({ current->PointerId, current->Region, true });
+                }
+
+                ++previous;
+                ++current;
+            }
+        }
+
+        std::swap(m_previous, m_current);
+    }
+}
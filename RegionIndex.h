@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "RenderBackend.h"
+
+namespace PointerCore
+{
+    // Handle of a region in a RegionIndex. The low 24 bits are a slot, the
+    // high 8 a generation, so a stale handle doesn't match a reused slot.
+    using RegionId = uint32_t;
+    constexpr RegionId NoRegion = UINT32_MAX;
+
+    // Uniform-grid spatial index over application-defined rectangles, for
+    // finding the region under each pointer.
+    //
+    // The grid covers [0, width) x [0, height) in cells of Options::CellSize;
+    // regions reaching past it are clamped into the edge cells. Each cell
+    // lists the regions overlapping it, so a hit test only looks at the
+    // regions in one cell. Where regions overlap, the most recently inserted
+    // one is on top (moving a region keeps its place).
+    class RegionIndex
+    {
+    public:
+        static constexpr size_t MaxRegions = size_t{ 1 } << 24;
+
+        struct Options
+        {
+            // Edge length of a grid cell, in DIPs. Roughly the size of a
+            // typical region is a good choice.
+            float CellSize = 64.0f;
+        };
+
+        RegionIndex();
+        explicit RegionIndex(Options const& options);
+
+        // Rebuilds the grid for a new surface size. Regions are kept.
+        void Resize(float width, float height);
+
+        // Returns NoRegion if MaxRegions regions already exist
+        RegionId Insert(Rect const& bounds);
+        bool Move(RegionId region, Rect const& bounds);
+        bool Remove(RegionId region);
+        void Clear() noexcept;
+
+        size_t Size() const noexcept { return m_size; }
+        bool Empty() const noexcept { return m_size == 0; }
+        bool Contains(RegionId region) const noexcept;
+        Rect Bounds(RegionId region) const noexcept;
+
+        // Topmost region containing the point (left/top inclusive,
+        // right/bottom exclusive), or NoRegion
+        RegionId HitTest(Point point) const noexcept;
+
+        // Hit tests every pointer in the table at once; out[i] is the region
+        // under the pointer at table index i
+        void HitTest(PointerTable const& pointers, std::vector<RegionId>& out) const;
+
+    private:
+        struct CellRange
+        {
+            uint32_t Left;
+            uint32_t Top;
+            uint32_t Right;
+            uint32_t Bottom;
+        };
+
+        // Cells keep a copy of each region's bounds, so a hit test reads one
+        // contiguous array instead of chasing slots
+        struct CellEntry
+        {
+            float Left;
+            float Top;
+            float Right;
+            float Bottom;
+            uint64_t Order;
+            uint32_t Slot;
+        };
+
+        CellRange CellsFor(Rect const& bounds) const noexcept;
+        void AddToCells(uint32_t slot);
+        void RemoveFromCells(uint32_t slot);
+        uint32_t SlotOf(RegionId region) const noexcept;
+
+        Options m_options;
+        float m_width{ 0 };
+        float m_height{ 0 };
+        uint32_t m_columns{ 1 };
+        uint32_t m_rows{ 1 };
+
+        // Region slots: bounds as columns, plus the insertion order that
+        // decides which of two overlapping regions is on top
+        std::vector<float> m_left;
+        std::vector<float> m_top;
+        std::vector<float> m_right;
+        std::vector<float> m_bottom;
+        std::vector<uint64_t> m_order;
+        std::vector<uint8_t> m_generation;
+        std::vector<bool> m_used;
+        std::vector<uint32_t> m_freeSlots;
+        size_t m_size{ 0 };
+        uint64_t m_nextOrder{ 0 };
+
+        // Regions overlapping each cell, row-major
+        std::vector<std::vector<CellEntry>> m_cells;
+    };
+
+    // A pointer moving onto or off a region
+    struct RegionEvent
+    {
+        uint32_t PointerId;
+        RegionId Region;
+        bool Entered;
+    };
+
+    // Turns successive hit test results into enter and leave notifications
+    class RegionHoverTracker
+    {
+    public:
+        // Diffs hits (as produced by RegionIndex::HitTest for the same table)
+        // against the previous update and appends the changes to events. A
+        // pointer's leave comes before its enter; pointers that are no longer
+        // in the table leave their region.
+        void Update(PointerTable const& pointers, std::vector<RegionId> const& hits, std::vector<RegionEvent>& events);
+
+        // Forgets every pointer without raising leaves
+        void Clear() noexcept { m_previous.clear(); }
+
+        bool Empty() const noexcept { return m_previous.empty(); }
+
+    private:
+        struct Hover
+        {
+            uint32_t PointerId;
+            RegionId Region;
+        };
+
+        // Pointers over a region, sorted by pointer ID
+        std::vector<Hover> m_previous;
+        std::vector<Hover> m_current;
+    };
+}
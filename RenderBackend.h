@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Straight (non-premultiplied) RGBA color, components in [0, 1]
+    struct Color
+    {
+        float R;
+        float G;
+        float B;
+        float A;
+    };
+
+    namespace Colors
+    {
+        constexpr Color Black{ 0.0f, 0.0f, 0.0f, 1.0f };
+        constexpr Color Blue{ 0.0f, 0.0f, 1.0f, 1.0f };
+        constexpr Color Red{ 1.0f, 0.0f, 0.0f, 1.0f };
+        constexpr Color White{ 1.0f, 1.0f, 1.0f, 1.0f };
+    }
+
+    // Axis-aligned rectangle in DIPs, right and bottom exclusive
+    struct Rect
+    {
+        float Left;
+        float Top;
+        float Right;
+        float Bottom;
+    };
+
+    // Axis-aligned rectangle on the pixel grid, right and bottom exclusive
+    struct PixelRect
+    {
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+
+        bool IsEmpty() const noexcept { return (Left >= Right) || (Top >= Bottom); }
+        int64_t Area() const noexcept { return IsEmpty() ? 0 : static_cast<int64_t>(Right - Left) * (Bottom - Top); }
+        Rect ToRect() const noexcept { return { static_cast<float>(Left), static_cast<float>(Top), static_cast<float>(Right), static_cast<float>(Bottom) }; }
+    };
+
+    inline PixelRect Union(PixelRect const& a, PixelRect const& b) noexcept
+    {
+        return { std::min(a.Left, b.Left), std::min(a.Top, b.Top), std::max(a.Right, b.Right), std::max(a.Bottom, b.Bottom) };
+    }
+
+    inline PixelRect Intersection(PixelRect const& a, PixelRect const& b) noexcept
+    {
+        return { std::max(a.Left, b.Left), std::max(a.Top, b.Top), std::min(a.Right, b.Right), std::min(a.Bottom, b.Bottom) };
+    }
+
+    // Byte order of a 32bpp pixel in memory
+    enum class PixelFormat : uint8_t
+    {
+        Bgra8,
+        Rgba8,
+    };
+
+    // Premultiplied 32bpp image that sprites are cut from, drawn at Scale
+    // pixels per DIP. Version is unique to these pixels, so backends can keep
+    // an uploaded copy until it changes.
+    struct SpriteSheet
+    {
+        uint32_t const* Pixels;
+        uint32_t Width;
+        uint32_t Height;
+        PixelFormat Format;
+        float Scale;
+        uint64_t Version;
+    };
+
+    // Source is in sheet pixels; Destination is in DIPs and Source's size divided by the sheet's Scale
+    struct SpriteInstance
+    {
+        Rect Destination;
+        PixelRect Source;
+    };
+
+    // The drawing operations the pointer scene needs, implemented once per
+    // rendering technology (Direct2D, CPU rasterizer, ...). Calls other than
+    // BeginDraw() are only valid between BeginDraw() and EndDraw().
+    class RenderBackend
+    {
+    public:
+        virtual ~RenderBackend() = default;
+
+        virtual void BeginDraw() = 0;
+        virtual void Clear(Color const& color) = 0;
+        virtual void FillRectangle(Rect const& rect, Color const& color) = 0;
+
+        // Fills rects[i] with colors[i] for each i, in order. Backends that can
+        // submit the whole batch at once override this.
+        virtual void FillRectangles(Rect const* rects, Color const* colors, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                FillRectangle(rects[i], colors[i]);
+            }
+        }
+
+        // Fills the triangles (v[i], v[i + 1], v[i + 2]) of a strip with one color
+        virtual void FillTriangleStrip(Point const* vertices, size_t count, Color const& color) = 0;
+
+        // Fills a strip like FillTriangleStrip() for a shape that is drawn
+        // again in later frames under the same key, such as an ink stroke.
+        // The first stableCount vertices are the same every time the key is
+        // drawn; the rest may change or grow. Backends that keep shapes on
+        // the device between frames override this.
+        virtual void FillKeyedTriangleStrip([[maybe_unused]] uint64_t key, Point const* vertices, size_t count, [[maybe_unused]] size_t stableCount, Color const& color)
+        {
+            FillTriangleStrip(vertices, count, color);
+        }
+
+        // Blends the sprites onto the target in order, one sheet pixel per
+        // target pixel. Backends drawing in pixels snap each destination's
+        // top-left corner to the pixel grid.
+        virtual void DrawSprites(SpriteSheet const& sheet, SpriteInstance const* sprites, size_t count) = 0;
+
+        virtual void EndDraw() = 0;
+
+        // Restricts drawing (including Clear) to the intersection of the
+        // pushed rectangles until the matching PopClip()
+        virtual void PushClip(PixelRect const& rect) = 0;
+        virtual void PopClip() = 0;
+    };
+}
@@ -0,0 +1,54 @@
+#include "RenderScheduler.h"
+
+#include <cmath>
+
+namespace PointerCore
+{
+    RenderScheduler::Duration RenderScheduler::MinFrameInterval() const noexcept
+    {
+        // Not above zero (including NaN) or too high to matter means no cap
+        if (!(m_options.MaxFrameRate > 0.0) || std::isinf(m_options.MaxFrameRate))
+        {
+            return Duration::zero();
+        }
+
+        // Tiny rates would overflow the conversion. Half the range is still
+        // centuries, and leaves room to add it to a frame start.
+        constexpr Duration longest = Duration::max() / 2;
+        std::chrono::duration<double> const interval{ 1.0 / m_options.MaxFrameRate };
+        if (!(interval < std::chrono::duration<double>(longest)))
+        {
+            return longest;
+        }
+
+        return std::chrono::duration_cast<Duration>(interval);
+    }
+
+    RenderScheduler::Decision RenderScheduler::Next(TimePoint now) const noexcept
+    {
+        // In continuous mode there's always something to render
+        if (m_options.RenderOnDemand && !m_frameRequested)
+        {
+            return { FrameAction::Idle, now };
+        }
+
+        // Respect the frame rate cap
+        if (m_hasRendered)
+        {
+            TimePoint const earliest = m_lastFrameStart + MinFrameInterval();
+            if (now < earliest)
+            {
+                return { FrameAction::WaitUntil, earliest };
+            }
+        }
+
+        return { FrameAction::Render, now };
+    }
+
+    void RenderScheduler::OnFrameRendered(TimePoint frameStart) noexcept
+    {
+        m_hasRendered = true;
+        m_lastFrameStart = frameStart;
+        ++m_framesRendered;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace PointerCore
+{
+    // Decides when the render loop should produce a frame.
+    //
+    // The scheduler never reads a clock itself: every call takes the current
+    // time, so the policy can be driven by a real clock in the renderer and by
+    // a VirtualClock in simulations. It is not thread-safe; other threads should
+    // forward their requests through the render thread.
+    class RenderScheduler
+    {
+    public:
+        using Duration = std::chrono::nanoseconds;
+
+        // Time since an arbitrary, fixed epoch
+        using TimePoint = std::chrono::nanoseconds;
+
+        struct Options
+        {
+            // Only render after RequestFrame(), instead of continuously
+            bool RenderOnDemand = false;
+
+            // Frames per second, 0 for no cap
+            double MaxFrameRate = 0.0;
+        };
+
+        enum class FrameAction
+        {
+            // Render a frame now
+            Render,
+
+            // Nothing to do before WakeTime (or new work arrives)
+            WaitUntil,
+
+            // Nothing to do until new work arrives
+            Idle,
+        };
+
+        struct Decision
+        {
+            FrameAction Action;
+            TimePoint WakeTime;
+        };
+
+        RenderScheduler() = default;
+        explicit RenderScheduler(Options const& options) : m_options{ options } {}
+
+        Options const& GetOptions() const noexcept { return m_options; }
+        void SetOptions(Options const& options) noexcept { m_options = options; }
+
+        // Something changed (input, resize, ...) that needs a new frame
+        void RequestFrame() noexcept { m_frameRequested = true; }
+        bool FrameRequested() const noexcept { return m_frameRequested; }
+
+        Decision Next(TimePoint now) const noexcept;
+
+        // Call once the frame started at frameStart has been presented
+        void OnFrameRendered(TimePoint frameStart) noexcept;
+
+        // Marks the requests seen so far as being handled by the frame about to render
+        void OnFrameStarted() noexcept { m_frameRequested = false; }
+
+        uint64_t FramesRendered() const noexcept { return m_framesRendered; }
+
+        // Minimum time between frame starts under the current cap (zero when uncapped)
+        Duration MinFrameInterval() const noexcept;
+
+    private:
+        Options m_options{};
+        bool m_frameRequested{ true };
+        bool m_hasRendered{ false };
+        TimePoint m_lastFrameStart{};
+        uint64_t m_framesRendered{ 0 };
+    };
+
+    // Manually advanced clock for driving the scheduler in simulations
+    class VirtualClock
+    {
+    public:
+        RenderScheduler::TimePoint Now() const noexcept { return m_now; }
+        void Advance(RenderScheduler::Duration duration) noexcept { m_now += duration; }
+        void AdvanceTo(RenderScheduler::TimePoint time) noexcept
+        {
+            if (time > m_now)
+            {
+                m_now = time;
+            }
+        }
+
+    private:
+        RenderScheduler::TimePoint m_now{};
+    };
+}
@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "RenderService.h"
+#include "PointerRenderer.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    using PointerCore::RenderScheduler;
+
+    static std::mutex s_serviceLock;
+    static std::weak_ptr<RenderService> s_service;
+
+    static inline RenderScheduler::TimePoint SchedulerNow() noexcept
+    {
+        return std::chrono::duration_cast<RenderScheduler::TimePoint>(std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    std::shared_ptr<RenderService> RenderService::Get()
+    {
+        std::lock_guard lock{ s_serviceLock };
+        auto service = s_service.lock();
+        if (!service)
+        {
+            service = std::make_shared<RenderService>();
+            s_service = service;
+        }
+
+        return service;
+    }
+
+    RenderService::RenderService(size_t workerCount)
+    {
+        // Create the shared D3D device. Several panels present and resize
+        // through it, possibly from different workers, so turn on its locking.
+        UINT d3dFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+#ifdef _DEBUG
+        d3dFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+        com_ptr<ID3D11DeviceContext> d3dContext;
+        check_hresult(D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_HARDWARE,
+            nullptr,
+            d3dFlags,
+            nullptr,
+            0,
+            D3D11_SDK_VERSION,
+            m_d3dDevice.put(),
+            nullptr,
+            d3dContext.put()));
+        d3dContext.as<ID3D11Multithread>()->SetMultithreadProtected(TRUE);
+
+        // Panels each create their own device context from the shared D2D
+        // device, on whichever worker renders them
+        com_ptr<ID2D1Factory1> d2dFactory;
+        check_hresult(D2D1CreateFactory(D2D1_FACTORY_TYPE_MULTI_THREADED, d2dFactory.put()));
+        check_hresult(d2dFactory->CreateDevice(m_d3dDevice.as<IDXGIDevice>().get(), m_d2dDevice.put()));
+
+        for (size_t i = 0; i < std::max<size_t>(workerCount, 1); ++i)
+        {
+            m_workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    RenderService::~RenderService()
+    {
+        {
+            std::lock_guard lock{ m_lock };
+            m_running = false;
+        }
+        m_workAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    RenderService::PanelId RenderService::Register(PointerRenderer* panel, int32_t priority)
+    {
+        std::lock_guard lock{ m_lock };
+        auto const id = m_scheduler.Register(priority);
+        if (id >= m_panels.size())
+        {
+            m_panels.resize(id + 1);
+        }
+        m_panels[id] = panel;
+        return id;
+    }
+
+    void RenderService::Unregister(PanelId panel)
+    {
+        std::unique_lock lock{ m_lock };
+        m_frameFinished.wait(lock, [&]() { return !m_scheduler.IsRendering(panel); });
+        if (m_scheduler.Unregister(panel))
+        {
+            m_panels[panel] = nullptr;
+        }
+    }
+
+    void RenderService::SetPriority(PanelId panel, int32_t priority)
+    {
+        std::lock_guard lock{ m_lock };
+        m_scheduler.SetPriority(panel, priority);
+    }
+
+    void RenderService::RequestFrame(PanelId panel)
+    {
+        {
+            std::lock_guard lock{ m_lock };
+            m_scheduler.RequestFrame(panel, SchedulerNow());
+        }
+        m_workAvailable.notify_one();
+    }
+
+    void RenderService::WorkerLoop()
+    {
+        // Panels raise events and touch other WinRT objects while rendering
+        init_apartment();
+        PointerRenderer::Timeline().NameThread("Render worker");
+
+        {
+            std::unique_lock lock{ m_lock };
+            while (m_running)
+            {
+                auto const decision = m_scheduler.Next(SchedulerNow());
+                if (decision.Action == RenderScheduler::FrameAction::Idle)
+                {
+                    m_workAvailable.wait(lock);
+                    continue;
+                }
+
+                if (decision.Action == RenderScheduler::FrameAction::WaitUntil)
+                {
+                    m_workAvailable.wait_until(lock, std::chrono::steady_clock::time_point{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(decision.WakeTime) });
+                    continue;
+                }
+
+                auto const panel = decision.Panel;
+                auto* renderer = m_panels[panel];
+                m_scheduler.OnFrameStarted(panel);
+
+                lock.unlock();
+                auto const next = renderer->RenderSharedFrame();
+                lock.lock();
+
+                // Queue the panel's next frame, as far as it knows now
+                m_scheduler.OnFrameFinished(panel);
+                if (next.Action == RenderScheduler::FrameAction::Render)
+                {
+                    m_scheduler.RequestFrame(panel, SchedulerNow());
+                }
+                else if (next.Action == RenderScheduler::FrameAction::WaitUntil)
+                {
+                    m_scheduler.RequestFrame(panel, next.WakeTime);
+                }
+                m_frameFinished.notify_all();
+            }
+        }
+
+        uninit_apartment();
+    }
+}
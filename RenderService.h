@@ -0,0 +1,54 @@
+#pragma once
+
+#include "PanelScheduler.h"
+
+namespace winrt::PointerDemo::implementation
+{
+    struct PointerRenderer;
+
+    // Renders any number of PointerRenderer panels from a small pool of
+    // worker threads (one by default) on one shared D3D11/D2D device, instead
+    // of a thread and device per panel. Panels are picked in PanelScheduler
+    // order; each panel's own RenderScheduler still decides when it's due.
+    class RenderService
+    {
+    public:
+        using PanelId = PointerCore::PanelScheduler::PanelId;
+
+        // The process-wide service, created on first use and shut down once
+        // the last panel lets go of it
+        static std::shared_ptr<RenderService> Get();
+
+        explicit RenderService(size_t workerCount = 1);
+        ~RenderService();
+
+        RenderService(RenderService const&) = delete;
+        RenderService& operator=(RenderService const&) = delete;
+
+        com_ptr<ID3D11Device> const& D3DDevice() const noexcept { return m_d3dDevice; }
+        com_ptr<ID2D1Device> const& D2DDevice() const noexcept { return m_d2dDevice; }
+
+        PanelId Register(PointerRenderer* panel, int32_t priority);
+
+        // Waits for the panel's frame in progress, if any, so it must not be
+        // called from a worker
+        void Unregister(PanelId panel);
+
+        void SetPriority(PanelId panel, int32_t priority);
+        void RequestFrame(PanelId panel);
+
+    private:
+        void WorkerLoop();
+
+        com_ptr<ID3D11Device> m_d3dDevice;
+        com_ptr<ID2D1Device> m_d2dDevice;
+
+        std::mutex m_lock;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_frameFinished;
+        PointerCore::PanelScheduler m_scheduler;
+        std::vector<PointerRenderer*> m_panels;
+        bool m_running{ true };
+        std::vector<std::thread> m_workers;
+    };
+}
@@ -0,0 +1,80 @@
+#include "ResizePolicy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PointerCore
+{
+    void ResizePolicy::Reset(Size size) noexcept
+    {
+        m_target = size;
+        m_buffers = size;
+        m_visible = size;
+        m_requested = false;
+    }
+
+    void ResizePolicy::Request(Size size, TimePoint now) noexcept
+    {
+        if (size != m_target)
+        {
+            m_lastRequestTime = now;
+        }
+
+        m_target = size;
+        m_requested = true;
+    }
+
+    ResizePolicy::Decision ResizePolicy::Update(TimePoint now) noexcept
+    {
+        ResizeAction action = ResizeAction::None;
+        if (m_requested)
+        {
+            m_requested = false;
+
+            uint32_t const slack = m_options.GrowSlack;
+            bool const outgrown = (m_target.Width > m_buffers.Width + slack) || (m_target.Height > m_buffers.Height + slack);
+            if (outgrown)
+            {
+                // Both edges get headroom if either one needs it
+                m_buffers = { Grow(m_target.Width, m_buffers.Width), Grow(m_target.Height, m_buffers.Height) };
+                action = ResizeAction::Reallocate;
+            }
+        }
+
+        // Fit the buffers once the size stops changing, so a drag doesn't
+        // leave them larger (or a letterbox wider) than it needs to be
+        if ((action != ResizeAction::Reallocate) && (m_buffers != m_target) && (now >= SettleDeadline()))
+        {
+            m_buffers = m_target;
+            action = ResizeAction::Reallocate;
+        }
+
+        Size const visible{ std::min(m_target.Width, m_buffers.Width), std::min(m_target.Height, m_buffers.Height) };
+        if (action == ResizeAction::Reallocate)
+        {
+            ++m_reallocations;
+        }
+        else if (visible != m_visible)
+        {
+            action = ResizeAction::Resize;
+        }
+
+        m_visible = visible;
+        return { action, m_buffers, m_visible };
+    }
+
+    uint32_t ResizePolicy::Grow(uint32_t size, uint32_t current) const noexcept
+    {
+        if (size <= current)
+        {
+            return current;
+        }
+
+        double const padded = std::ceil(size * (1.0 + std::max(m_options.Headroom, 0.0f)));
+        uint32_t const alignment = std::max(m_options.Alignment, 1u);
+        double const aligned = std::ceil(padded / alignment) * alignment;
+
+        // Headroom never takes a buffer past the limit, but the size itself may
+        return std::max(size, static_cast<uint32_t>(std::min(aligned, static_cast<double>(m_options.MaxDimension))));
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+
+#include "RenderScheduler.h"
+
+namespace PointerCore
+{
+    // Decides when a panel's swap chain buffers get reallocated while its size
+    // keeps changing, e.g. during a window drag.
+    //
+    // Sizes requested between two frames collapse into the latest one, and
+    // Update() applies it once per frame. As long as the new size fits in the
+    // current buffers (or outgrows them by no more than Options::GrowSlack)
+    // the buffers are kept and only their visible part changes; the rest of
+    // the panel stays letterboxed until it is reallocated. Outgrowing them by
+    // more reallocates right away, with headroom so a drag that keeps growing
+    // doesn't reallocate every frame. Once the size has stopped changing for
+    // Options::SettleTime the buffers are reallocated to fit it exactly.
+    //
+    // Like RenderScheduler it never reads a clock and isn't thread-safe.
+    class ResizePolicy
+    {
+    public:
+        using Duration = RenderScheduler::Duration;
+        using TimePoint = RenderScheduler::TimePoint;
+
+        // In pixels
+        struct Size
+        {
+            uint32_t Width;
+            uint32_t Height;
+
+            bool operator==(Size const& other) const noexcept { return (Width == other.Width) && (Height == other.Height); }
+            bool operator!=(Size const& other) const noexcept { return !(*this == other); }
+        };
+
+        struct Options
+        {
+            // Pixels the size may exceed the buffers by, in either direction,
+            // before they are reallocated ahead of the size settling
+            uint32_t GrowSlack = 32;
+
+            // Extra space allocated when growing, as a fraction of the new size
+            float Headroom = 0.25f;
+
+            // Grown buffers are rounded up to a multiple of this
+            uint32_t Alignment = 64;
+
+            // Largest buffer edge that headroom may grow to
+            uint32_t MaxDimension = 16384;
+
+            // Time without a new size after which the buffers are fitted to it
+            Duration SettleTime = std::chrono::milliseconds(200);
+        };
+
+        enum class ResizeAction
+        {
+            // Nothing changed
+            None,
+
+            // Keep the buffers, show a different part of them
+            Resize,
+
+            // Reallocate the buffers
+            Reallocate,
+        };
+
+        struct Decision
+        {
+            ResizeAction Action;
+
+            // Size to (re)allocate the buffers at
+            Size Buffers;
+
+            // Top-left part of the buffers that is shown, never larger than Buffers
+            Size Visible;
+        };
+
+        ResizePolicy() = default;
+        explicit ResizePolicy(Options const& options) : m_options{ options } {}
+
+        Options const& GetOptions() const noexcept { return m_options; }
+        void SetOptions(Options const& options) noexcept { m_options = options; }
+
+        // The buffers were just created at exactly this size
+        void Reset(Size size) noexcept;
+
+        // The panel's size changed. Of several requests before the next
+        // Update(), the latest wins.
+        void Request(Size size, TimePoint now) noexcept;
+
+        // Once per frame, before rendering
+        Decision Update(TimePoint now) noexcept;
+
+        // The buffers fit the latest size exactly. Until they do, Update()
+        // has to run again by SettleDeadline() even without new requests.
+        bool IsSettled() const noexcept { return !m_requested && (m_buffers == m_target); }
+        TimePoint SettleDeadline() const noexcept { return m_lastRequestTime + m_options.SettleTime; }
+
+        Size TargetSize() const noexcept { return m_target; }
+        Size BufferSize() const noexcept { return m_buffers; }
+        Size VisibleSize() const noexcept { return m_visible; }
+        uint64_t Reallocations() const noexcept { return m_reallocations; }
+
+    private:
+        // Buffer edge for a size that outgrew the current one
+        uint32_t Grow(uint32_t size, uint32_t current) const noexcept;
+
+        Options m_options{};
+        Size m_target{ 1, 1 };
+        Size m_buffers{ 1, 1 };
+        Size m_visible{ 1, 1 };
+        bool m_requested{ false };
+        TimePoint m_lastRequestTime{};
+        uint64_t m_reallocations{ 0 };
+    };
+}
@@ -0,0 +1,144 @@
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+
+namespace PointerCore
+{
+    SceneSnapshotChannel::SceneSnapshotChannel(size_t maxLogLength)
+        : m_maxLogLength{ std::max<size_t>(maxLogLength, 1) }
+    {
+    }
+
+    void SceneSnapshotChannel::Apply(PointerEvent const& event, bool recordStroke)
+    {
+        m_log.push_back({ event, recordStroke });
+    }
+
+    void SceneSnapshotChannel::Publish()
+    {
+        uint64_t const end = m_logStart + m_log.size();
+        size_t const back = m_buffer.BackIndex();
+        SceneSnapshot& scene = m_buffer.Back();
+
+        if (m_slotPositions[back] < m_logStart)
+        {
+            // The events this slot is missing are gone, start from the latest
+            // snapshot instead. That one is always at m_publishedPosition.
+            scene = m_buffer.Published(m_buffer.LatestIndex());
+            m_slotPositions[back] = m_publishedPosition;
+            ++m_fullCopyCount;
+        }
+
+        // Catch up to the previous snapshot, then apply the new events as pending input
+        Replay(scene, m_slotPositions[back], m_publishedPosition, false);
+        for (size_t i = 0; i < scene.Pointers.Size(); ++i)
+        {
+            scene.Pointers.SetPendingInputTime(i, 0);
+        }
+        Replay(scene, m_publishedPosition, end, true);
+
+        scene.Sequence = m_publishCount++;
+        m_slotPositions[back] = end;
+        m_publishedPosition = end;
+        m_buffer.Publish();
+
+        TrimLog();
+    }
+
+    void SceneSnapshotChannel::Replay(SceneSnapshot& scene, uint64_t first, uint64_t last, bool markInput) const
+    {
+        for (uint64_t position = first; position < last; ++position)
+        {
+            auto const& entry = m_log[static_cast<size_t>(position - m_logStart)];
+            ApplyEvent(scene, entry.Event, entry.RecordStroke, markInput);
+        }
+    }
+
+    void SceneSnapshotChannel::TrimLog()
+    {
+        // Keep what every slot needs, except slots held for so long they're
+        // past the limit; those get a full copy when they come back. The
+        // others keep catching up by replay, or a consumer that stalls would
+        // make every publish a full copy.
+        uint64_t oldest = m_publishedPosition;
+        for (uint64_t const position : m_slotPositions)
+        {
+            if (m_publishedPosition - position <= m_maxLogLength)
+            {
+                oldest = std::min(oldest, position);
+            }
+        }
+
+        while (m_logStart < oldest)
+        {
+            m_log.pop_front();
+            ++m_logStart;
+        }
+    }
+
+    void SceneSnapshotChannel::ApplyEvent(SceneSnapshot& scene, PointerEvent const& event, bool recordStroke, bool markInput)
+    {
+        auto& pointers = scene.Pointers;
+        PointerSample const sample{ event.X, event.Y, event.Timestamp, event.Pressure };
+
+        size_t index = PointerTable::npos;
+        switch (event.Kind)
+        {
+        case PointerEventKind::Entered:
+            index = pointers.Insert(event.Id, event.DeviceKind, event.InContact, { event.X, event.Y });
+            break;
+
+        case PointerEventKind::Exited:
+            scene.Strokes.End(event.Id);
+            pointers.Erase(event.Id);
+            return;
+
+        case PointerEventKind::Moved:
+            index = pointers.Find(event.Id);
+            if (index != PointerTable::npos)
+            {
+                pointers.SetPosition(index, { event.X, event.Y });
+                scene.Strokes.Append(event.Id, sample);
+            }
+            break;
+
+        case PointerEventKind::Pressed:
+            index = pointers.Find(event.Id);
+            if (index != PointerTable::npos)
+            {
+                pointers.SetPressed(index, true);
+                pointers.SetPosition(index, { event.X, event.Y });
+                if (recordStroke)
+                {
+                    scene.Strokes.Begin(event.Id, sample);
+                }
+            }
+            break;
+
+        case PointerEventKind::Released:
+            index = pointers.Find(event.Id);
+            if (index != PointerTable::npos)
+            {
+                pointers.SetPressed(index, false);
+                pointers.SetPosition(index, { event.X, event.Y });
+                scene.Strokes.Append(event.Id, sample);
+                scene.Strokes.End(event.Id);
+            }
+            break;
+        }
+
+        if (index == PointerTable::npos)
+        {
+            return;
+        }
+
+        pointers.SetPressure(index, event.Pressure);
+        pointers.SetTimestamp(index, event.Timestamp);
+
+        // Only the oldest input since the previous snapshot is kept
+        if (markInput && (event.ReceivedTime != 0) && (pointers.PendingInputTime(index) == 0))
+        {
+            pointers.SetPendingInputTime(index, event.ReceivedTime);
+        }
+    }
+}
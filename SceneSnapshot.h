@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "PointerTable.h"
+#include "PointerTypes.h"
+#include "StrokeStore.h"
+#include "TripleBuffer.h"
+
+namespace PointerCore
+{
+    // Pointer and stroke state as of some point in the input stream. Once
+    // published it is never modified while the consumer can see it.
+    struct SceneSnapshot
+    {
+        // Number of snapshots published before this one
+        uint64_t Sequence{ 0 };
+
+        // Pending input times only cover the events since the previous snapshot
+        PointerTable Pointers;
+        StrokeStore Strokes;
+    };
+
+    // Publishes SceneSnapshots from an input thread to a render thread
+    // without locks, through a TripleBuffer.
+    //
+    // Copying the whole scene for every publish would cost as much as the
+    // stroke history, so each of the three slots is brought up to date by
+    // replaying the events applied since that slot was last published. The
+    // producer keeps a log of those events, trimmed as slots catch up. If the
+    // consumer holds on to a slot for so long that the log would grow past
+    // its limit, the log is cut and that slot gets a full copy instead when
+    // it comes back.
+    class SceneSnapshotChannel
+    {
+    public:
+        static constexpr size_t DefaultMaxLogLength = 4096;
+
+        explicit SceneSnapshotChannel(size_t maxLogLength = DefaultMaxLogLength);
+
+        SceneSnapshotChannel(SceneSnapshotChannel const&) = delete;
+        SceneSnapshotChannel& operator=(SceneSnapshotChannel const&) = delete;
+
+        // Producer. Queues an event for the next snapshot. Events are expected
+        // in a valid order per pointer (see PointerLifecycle); pressed pointers
+        // only record a stroke when recordStroke is set.
+        void Apply(PointerEvent const& event, bool recordStroke);
+
+        // Producer. Makes everything applied so far visible to the consumer
+        void Publish();
+
+        uint64_t PublishCount() const noexcept { return m_publishCount; }
+        uint64_t FullCopyCount() const noexcept { return m_fullCopyCount; }
+        size_t LogLength() const noexcept { return m_log.size(); }
+
+        // Consumer. True if a snapshot was published since the last Acquire()
+        bool HasUpdate() const noexcept { return m_buffer.HasUpdate(); }
+
+        // Consumer. The latest published snapshot (or an empty one), valid until the next Acquire()
+        SceneSnapshot const& Acquire() noexcept { return m_buffer.Acquire(); }
+
+        // How an event changes a scene. Only events applied with markInput
+        // set count as pending input for latency measurement.
+        static void ApplyEvent(SceneSnapshot& scene, PointerEvent const& event, bool recordStroke, bool markInput);
+
+    private:
+        struct LogEntry
+        {
+            PointerEvent Event;
+            bool RecordStroke;
+        };
+
+        void Replay(SceneSnapshot& scene, uint64_t first, uint64_t last, bool markInput) const;
+        void TrimLog();
+
+        size_t m_maxLogLength;
+        TripleBuffer<SceneSnapshot> m_buffer;
+
+        // Producer-owned. Log positions count every event ever applied; m_log
+        // holds the ones from m_logStart on.
+        std::deque<LogEntry> m_log;
+        uint64_t m_logStart{ 0 };
+        uint64_t m_slotPositions[TripleBuffer<SceneSnapshot>::SlotCount]{ 0 };
+        uint64_t m_publishedPosition{ 0 };
+        uint64_t m_publishCount{ 0 };
+        uint64_t m_fullCopyCount{ 0 };
+    };
+}
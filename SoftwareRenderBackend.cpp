@@ -0,0 +1,303 @@
+#include "SoftwareRenderBackend.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "PixelOps.h"
+
+namespace PointerCore
+{
+    static inline uint32_t ToByte(float value) noexcept
+    {
+        return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    // First pixel whose center is at or past the given edge. Clamped in float
+    // first, since converting a huge or infinite edge is undefined; a NaN edge
+    // lands on the lower limit.
+    static inline int32_t EdgeToPixel(float edge) noexcept
+    {
+        constexpr float Limit = 1 << 30;
+        float const clamped = (edge > -Limit) ? std::min(edge, Limit) : -Limit;
+        return static_cast<int32_t>(std::ceil(clamped - 0.5f));
+    }
+
+    SoftwareRenderBackend::SoftwareRenderBackend(uint32_t width, uint32_t height, PixelFormat format)
+        : m_width{ width }
+        , m_height{ height }
+        , m_format{ format }
+        , m_pixels(static_cast<size_t>(width) * height)
+    {
+    }
+
+    void SoftwareRenderBackend::Resize(uint32_t width, uint32_t height)
+    {
+        m_width = width;
+        m_height = height;
+        m_pixels.resize(static_cast<size_t>(width) * height);
+    }
+
+    uint32_t SoftwareRenderBackend::PackColor(Color const& color) const noexcept
+    {
+        float const alpha = std::clamp(color.A, 0.0f, 1.0f);
+        uint32_t const r = ToByte(color.R * alpha);
+        uint32_t const g = ToByte(color.G * alpha);
+        uint32_t const b = ToByte(color.B * alpha);
+        uint32_t const a = ToByte(alpha);
+
+        return (m_format == PixelFormat::Bgra8)
+            ? (b | (g << 8) | (r << 16) | (a << 24))
+            : (r | (g << 8) | (b << 16) | (a << 24));
+    }
+
+    PixelRect SoftwareRenderBackend::CoveredPixels(Rect const& rect) noexcept
+    {
+        if (std::isnan(rect.Left) || std::isnan(rect.Top) || std::isnan(rect.Right) || std::isnan(rect.Bottom))
+        {
+            return {};
+        }
+
+        return { EdgeToPixel(rect.Left), EdgeToPixel(rect.Top), EdgeToPixel(rect.Right), EdgeToPixel(rect.Bottom) };
+    }
+
+    PixelRect SoftwareRenderBackend::SpritePixels(SpriteInstance const& sprite) noexcept
+    {
+        PixelRect const corner = CoveredPixels(sprite.Destination);
+        int64_t const width = static_cast<int64_t>(sprite.Source.Right) - sprite.Source.Left;
+        int64_t const height = static_cast<int64_t>(sprite.Source.Bottom) - sprite.Source.Top;
+        return {
+            corner.Left,
+            corner.Top,
+            static_cast<int32_t>(std::clamp<int64_t>(corner.Left + width, INT32_MIN, INT32_MAX)),
+            static_cast<int32_t>(std::clamp<int64_t>(corner.Top + height, INT32_MIN, INT32_MAX)) };
+    }
+
+    PixelRect SoftwareRenderBackend::CurrentClip() const noexcept
+    {
+        PixelRect const surface{ 0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height) };
+        return m_clipStack.empty() ? surface : Intersection(m_clipStack.back(), surface);
+    }
+
+    PixelRect SoftwareRenderBackend::SurfaceClip(PixelRect const& clip) const noexcept
+    {
+        return Intersection(clip, { 0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height) });
+    }
+
+    void SoftwareRenderBackend::FillPixels(PixelRect const& area, PixelRect const& clip, uint32_t value) noexcept
+    {
+        PixelRect const clipped = Intersection(area, clip);
+        if (clipped.IsEmpty())
+        {
+            return;
+        }
+
+        bool const opaque = (value >> 24) == 0xff;
+        auto const spanLength = static_cast<size_t>(clipped.Right - clipped.Left);
+
+        // A full-width opaque fill is one contiguous span
+        if (opaque && (spanLength == m_width))
+        {
+            PixelOps::FillSpan(m_pixels.data() + static_cast<size_t>(clipped.Top) * m_width, spanLength * static_cast<size_t>(clipped.Bottom - clipped.Top), value);
+            return;
+        }
+
+        uint32_t* row = m_pixels.data() + static_cast<size_t>(clipped.Top) * m_width + static_cast<size_t>(clipped.Left);
+        for (int32_t y = clipped.Top; y < clipped.Bottom; ++y, row += m_width)
+        {
+            if (opaque)
+            {
+                PixelOps::FillSpan(row, spanLength, value);
+            }
+            else
+            {
+                PixelOps::BlendSpan(row, spanLength, value);
+            }
+        }
+    }
+
+    void SoftwareRenderBackend::BeginDraw()
+    {
+    }
+
+    void SoftwareRenderBackend::Clear(Color const& color)
+    {
+        Clear(PackColor(color), CurrentClip());
+    }
+
+    void SoftwareRenderBackend::Clear(uint32_t value, PixelRect const& requested) noexcept
+    {
+        // Like Direct2D, Clear() replaces the pixels rather than blending
+        PixelRect const clip = SurfaceClip(requested);
+        if (clip.IsEmpty())
+        {
+            return;
+        }
+
+        if (static_cast<uint32_t>(clip.Right - clip.Left) == m_width)
+        {
+            PixelOps::FillSpan(m_pixels.data() + static_cast<size_t>(clip.Top) * m_width, static_cast<size_t>(clip.Bottom - clip.Top) * m_width, value);
+            return;
+        }
+
+        uint32_t* row = m_pixels.data() + static_cast<size_t>(clip.Top) * m_width + static_cast<size_t>(clip.Left);
+        for (int32_t y = clip.Top; y < clip.Bottom; ++y, row += m_width)
+        {
+            PixelOps::FillSpan(row, static_cast<size_t>(clip.Right - clip.Left), value);
+        }
+    }
+
+    void SoftwareRenderBackend::FillRectangle(Rect const& rect, Color const& color)
+    {
+        FillPixels(CoveredPixels(rect), CurrentClip(), PackColor(color));
+    }
+
+    void SoftwareRenderBackend::FillRectangle(Rect const& rect, uint32_t value, PixelRect const& clip) noexcept
+    {
+        FillPixels(CoveredPixels(rect), SurfaceClip(clip), value);
+    }
+
+    void SoftwareRenderBackend::FillTriangleStrip(Point const* vertices, size_t count, Color const& color)
+    {
+        FillTriangleStrip(vertices, count, PackColor(color), CurrentClip());
+    }
+
+    void SoftwareRenderBackend::FillTriangleStrip(Point const* vertices, size_t count, uint32_t value, PixelRect const& requested) noexcept
+    {
+        PixelRect const clip = SurfaceClip(requested);
+        if (clip.IsEmpty())
+        {
+            return;
+        }
+
+        for (size_t i = 0; i + 2 < count; ++i)
+        {
+            FillTriangle(vertices[i], vertices[i + 1], vertices[i + 2], clip, value);
+        }
+    }
+
+    void SoftwareRenderBackend::DrawSprites(SpriteSheet const& sheet, SpriteInstance const* sprites, size_t count)
+    {
+        PixelRect const clip = CurrentClip();
+        for (size_t i = 0; i < count; ++i)
+        {
+            DrawSprite(sheet, sprites[i], clip);
+        }
+    }
+
+    void SoftwareRenderBackend::DrawSprite(SpriteSheet const& sheet, SpriteInstance const& sprite, PixelRect const& clip) noexcept
+    {
+        // Only the part of the source that's inside the sheet
+        PixelRect const source = Intersection(sprite.Source, { 0, 0, static_cast<int32_t>(sheet.Width), static_cast<int32_t>(sheet.Height) });
+        PixelRect const area = SpritePixels(sprite);
+        int64_t const offsetX = static_cast<int64_t>(area.Left) - sprite.Source.Left;
+        int64_t const offsetY = static_cast<int64_t>(area.Top) - sprite.Source.Top;
+        PixelRect const clipped = Intersection(Intersection(area, SurfaceClip(clip)), {
+            static_cast<int32_t>(std::clamp<int64_t>(source.Left + offsetX, INT32_MIN, INT32_MAX)),
+            static_cast<int32_t>(std::clamp<int64_t>(source.Top + offsetY, INT32_MIN, INT32_MAX)),
+            static_cast<int32_t>(std::clamp<int64_t>(source.Right + offsetX, INT32_MIN, INT32_MAX)),
+            static_cast<int32_t>(std::clamp<int64_t>(source.Bottom + offsetY, INT32_MIN, INT32_MAX)) });
+        if (clipped.IsEmpty())
+        {
+            return;
+        }
+
+        auto const spanLength = static_cast<size_t>(clipped.Right - clipped.Left);
+        uint32_t* row = m_pixels.data() + static_cast<size_t>(clipped.Top) * m_width + static_cast<size_t>(clipped.Left);
+        uint32_t const* sourceRow = sheet.Pixels + static_cast<size_t>(clipped.Top - offsetY) * sheet.Width + static_cast<size_t>(clipped.Left - offsetX);
+        for (int32_t y = clipped.Top; y < clipped.Bottom; ++y, row += m_width, sourceRow += sheet.Width)
+        {
+            PixelOps::BlendPixels(row, sourceRow, spanLength);
+        }
+    }
+
+    void SoftwareRenderBackend::FillTriangle(Point a, Point b, Point c, PixelRect const& clip, uint32_t value) noexcept
+    {
+        // Wind the triangle so every edge has the inside on its left
+        float const area = (b.X - a.X) * (c.Y - a.Y) - (b.Y - a.Y) * (c.X - a.X);
+
+        // Degenerate, or a NaN coordinate, which would otherwise leave its
+        // edges out of the row tests below. An infinite one turns the edge
+        // offsets into NaNs the same way.
+        if (!(std::fabs(area) > 0.0f) || std::isinf(a.X) || std::isinf(a.Y) || std::isinf(b.X) || std::isinf(b.Y) || std::isinf(c.X) || std::isinf(c.Y))
+        {
+            return;
+        }
+        if (area < 0.0f)
+        {
+            std::swap(b, c);
+        }
+
+        float const top = std::min({ a.Y, b.Y, c.Y });
+        float const bottom = std::max({ a.Y, b.Y, c.Y });
+        int64_t const firstRow = std::max<int64_t>(EdgeToPixel(top), clip.Top);
+        int64_t const lastRow = std::min<int64_t>(EdgeToPixel(bottom), clip.Bottom);
+
+        Point const edges[3][2] = { { a, b }, { b, c }, { c, a } };
+        bool const opaque = (value >> 24) == 0xff;
+        for (int64_t y = firstRow; y < lastRow; ++y)
+        {
+            // Intersect the row's pixel centers with each edge's half plane
+            float const centerY = static_cast<float>(y) + 0.5f;
+            float left = -INFINITY;
+            float right = INFINITY;
+            bool empty = false;
+            for (auto const& edge : edges)
+            {
+                float const dx = edge[1].X - edge[0].X;
+                float const dy = edge[1].Y - edge[0].Y;
+                float const offset = dx * (centerY - edge[0].Y);
+                if (dy > 0.0f)
+                {
+                    right = std::min(right, edge[0].X + offset / dy);
+                }
+                else if (dy < 0.0f)
+                {
+                    left = std::max(left, edge[0].X + offset / dy);
+                }
+                else if (offset < 0.0f)
+                {
+                    empty = true;
+                }
+            }
+
+            // Clamping to the clip first also keeps the conversions in range
+            left = std::max(left, static_cast<float>(clip.Left));
+            right = std::min(right, static_cast<float>(clip.Right));
+            if (empty || !(left <= right))
+            {
+                continue;
+            }
+
+            int64_t const first = EdgeToPixel(left);
+            int64_t const last = std::min<int64_t>(static_cast<int64_t>(std::floor(right - 0.5f)) + 1, clip.Right);
+            if (first >= last)
+            {
+                continue;
+            }
+
+            uint32_t* span = m_pixels.data() + static_cast<size_t>(y) * m_width + static_cast<size_t>(first);
+            if (opaque)
+            {
+                PixelOps::FillSpan(span, static_cast<size_t>(last - first), value);
+            }
+            else
+            {
+                PixelOps::BlendSpan(span, static_cast<size_t>(last - first), value);
+            }
+        }
+    }
+
+    void SoftwareRenderBackend::EndDraw()
+    {
+    }
+
+    void SoftwareRenderBackend::PushClip(PixelRect const& rect)
+    {
+        m_clipStack.push_back(m_clipStack.empty() ? rect : Intersection(rect, m_clipStack.back()));
+    }
+
+    void SoftwareRenderBackend::PopClip()
+    {
+        m_clipStack.pop_back();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderBackend.h"
+
+namespace PointerCore
+{
+    // CPU rasterizer drawing into an in-memory, premultiplied 32bpp buffer.
+    //
+    // Rectangles are aliased: a pixel is covered when its center lies inside
+    // the rectangle (top/left inclusive, right/bottom exclusive), so output is
+    // deterministic and can be compared against golden images. Triangles are
+    // aliased the same way: centers on the left, right and top edges are
+    // covered, but the row of centers level with the lowest vertex is not,
+    // like a rectangle's bottom edge. Sprites are copied 1:1 from sheets in
+    // the buffer's pixel format (their Scale is ignored), with the top-left
+    // corner at the first pixel whose center is inside the destination.
+    class SoftwareRenderBackend : public RenderBackend
+    {
+    public:
+        SoftwareRenderBackend(uint32_t width, uint32_t height, PixelFormat format = PixelFormat::Bgra8);
+
+        // Reallocates the buffer; contents are undefined until the next Clear()
+        void Resize(uint32_t width, uint32_t height);
+
+        uint32_t Width() const noexcept { return m_width; }
+        uint32_t Height() const noexcept { return m_height; }
+        PixelFormat Format() const noexcept { return m_format; }
+
+        // Rows are tightly packed, so the stride is Width() pixels
+        uint32_t const* Pixels() const noexcept { return m_pixels.data(); }
+        uint32_t* Pixels() noexcept { return m_pixels.data(); }
+        uint32_t PixelAt(uint32_t x, uint32_t y) const noexcept { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+
+        // Converts a color to this buffer's premultiplied pixel layout
+        uint32_t PackColor(Color const& color) const noexcept;
+
+        // Pixels whose centers lie inside the rectangle, the ones FillRectangle() covers
+        static PixelRect CoveredPixels(Rect const& rect) noexcept;
+
+        // Pixels a sprite is drawn to
+        static PixelRect SpritePixels(SpriteInstance const& sprite) noexcept;
+
+        // Drawing with a packed value and an explicit clip instead of the clip
+        // stack, for callers that split the target between threads. Calls made
+        // at the same time must use clips that don't overlap.
+        void Clear(uint32_t value, PixelRect const& clip) noexcept;
+        void FillRectangle(Rect const& rect, uint32_t value, PixelRect const& clip) noexcept;
+        void FillTriangleStrip(Point const* vertices, size_t count, uint32_t value, PixelRect const& clip) noexcept;
+        void DrawSprite(SpriteSheet const& sheet, SpriteInstance const& sprite, PixelRect const& clip) noexcept;
+
+        // RenderBackend
+        void BeginDraw() override;
+        void Clear(Color const& color) override;
+        void FillRectangle(Rect const& rect, Color const& color) override;
+        void FillTriangleStrip(Point const* vertices, size_t count, Color const& color) override;
+        void DrawSprites(SpriteSheet const& sheet, SpriteInstance const* sprites, size_t count) override;
+        void EndDraw() override;
+        void PushClip(PixelRect const& rect) override;
+        void PopClip() override;
+
+    private:
+        PixelRect CurrentClip() const noexcept;
+        PixelRect SurfaceClip(PixelRect const& clip) const noexcept;
+        void FillPixels(PixelRect const& area, PixelRect const& clip, uint32_t value) noexcept;
+        void FillTriangle(Point a, Point b, Point c, PixelRect const& clip, uint32_t value) noexcept;
+
+        uint32_t m_width;
+        uint32_t m_height;
+        PixelFormat m_format;
+        std::vector<uint32_t> m_pixels;
+        std::vector<PixelRect> m_clipStack;
+    };
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace PointerCore
+{
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // Structure was padded due to alignment specifier
+#endif
+
+    // Bounded, lock-free, single-producer/single-consumer ring buffer.
+    //
+    // Exactly one thread may call the producer functions (TryPush) and exactly
+    // one thread may call the consumer functions (TryPop/ConsumeAll). The
+    // counters may be read from any thread. Pushing into a full ring fails
+    // rather than blocking and is counted in OverflowCount().
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements must be trivially copyable");
+
+    public:
+        // Capacity is rounded up to a power of two
+        explicit SpscRing(size_t minCapacity)
+            : m_mask{ RoundUpToPowerOfTwo(minCapacity) - 1 }
+            , m_slots{ std::make_unique<T[]>(m_mask + 1) }
+        {
+        }
+
+        SpscRing(SpscRing const&) = delete;
+        SpscRing& operator=(SpscRing const&) = delete;
+
+        size_t Capacity() const noexcept { return m_mask + 1; }
+
+        // Producer
+        bool TryPush(T const& value) noexcept
+        {
+            size_t const tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead > m_mask)
+            {
+                // Looks full, refresh our view of the consumer before giving up
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask)
+                {
+                    m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            m_slots[tail & m_mask] = value;
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            size_t const occupancy = tail + 1 - m_cachedHead;
+            if (occupancy > m_highWaterMark.load(std::memory_order_relaxed))
+            {
+                m_highWaterMark.store(occupancy, std::memory_order_relaxed);
+            }
+
+            return true;
+        }
+
+        // Consumer
+        bool TryPop(T& value) noexcept
+        {
+            size_t const head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail)
+                {
+                    return false;
+                }
+            }
+
+            value = m_slots[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer. Invokes fn for every element that was visible when the call
+        // started and releases the consumed slots back to the producer in one
+        // go. Returns the number of elements consumed.
+        template <typename Fn>
+        size_t ConsumeAll(Fn&& fn)
+        {
+            size_t const head = m_head.load(std::memory_order_relaxed);
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+            for (size_t i = head; i != m_cachedTail; ++i)
+            {
+                fn(static_cast<T const&>(m_slots[i & m_mask]));
+            }
+
+            m_head.store(m_cachedTail, std::memory_order_release);
+            return m_cachedTail - head;
+        }
+
+        // Approximate when called concurrently with either side
+        size_t SizeApprox() const noexcept
+        {
+            size_t const head = m_head.load(std::memory_order_acquire);
+            size_t const tail = m_tail.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        // Number of pushes rejected because the ring was full
+        uint64_t OverflowCount() const noexcept { return m_overflowCount.load(std::memory_order_relaxed); }
+
+        // Largest occupancy observed by the producer. Never under-reports, but
+        // may over-report slightly since the producer's view of the consumer
+        // can be stale.
+        size_t HighWaterMark() const noexcept { return m_highWaterMark.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t CacheLineSize = 64;
+
+        static size_t RoundUpToPowerOfTwo(size_t value) noexcept
+        {
+            size_t result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+
+            return result;
+        }
+
+        size_t const m_mask;
+        std::unique_ptr<T[]> const m_slots;
+
+        // Consumer-owned
+        alignas(CacheLineSize) std::atomic<size_t> m_head{ 0 };
+        size_t m_cachedTail{ 0 };
+
+        // Producer-owned
+        alignas(CacheLineSize) std::atomic<size_t> m_tail{ 0 };
+        size_t m_cachedHead{ 0 };
+        std::atomic<uint64_t> m_overflowCount{ 0 };
+        std::atomic<size_t> m_highWaterMark{ 0 };
+    };
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
@@ -0,0 +1,329 @@
+#include "StrokeStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PointerCore
+{
+    static inline float DistanceSquared(PointerSample const& a, PointerSample const& b) noexcept
+    {
+        float const dx = b.X - a.X;
+        float const dy = b.Y - a.Y;
+        return dx * dx + dy * dy;
+    }
+
+    // Wraps an angle into [-pi, pi]
+    static inline float WrapAngle(float angle) noexcept
+    {
+        constexpr float Pi = 3.14159265358979f;
+        if (angle > Pi)
+        {
+            angle -= 2.0f * Pi;
+        }
+        else if (angle < -Pi)
+        {
+            angle += 2.0f * Pi;
+        }
+
+        return angle;
+    }
+
+    StrokeStore::StrokeStore()
+        : StrokeStore(Options{})
+    {
+    }
+
+    StrokeStore::StrokeStore(Options const& options)
+        : m_options{ options }
+    {
+        m_active.reserve(m_options.MaxActiveStrokes);
+    }
+
+    size_t StrokeStore::FindActive(uint32_t pointerId) const noexcept
+    {
+        for (size_t i = 0; i < m_active.size(); ++i)
+        {
+            if (m_active[i].PointerId == pointerId)
+            {
+                return i;
+            }
+        }
+
+        return npos;
+    }
+
+    size_t StrokeStore::FindStroke(uint64_t id) const noexcept
+    {
+        auto const itr = std::lower_bound(m_strokes.begin(), m_strokes.end(), id, [](Stroke const& stroke, uint64_t value) { return stroke.Id < value; });
+        return ((itr != m_strokes.end()) && (itr->Id == id)) ? static_cast<size_t>(itr - m_strokes.begin()) : npos;
+    }
+
+    bool StrokeStore::Begin(uint32_t pointerId, PointerSample const& sample)
+    {
+        End(pointerId);
+        if (m_active.size() >= m_options.MaxActiveStrokes)
+        {
+            return false;
+        }
+
+        uint64_t const id = m_nextStrokeId++;
+        m_strokes.push_back({ id, pointerId, NoChunk, NoChunk, 0, m_active.size() });
+
+        ActiveStroke active{};
+        active.PointerId = pointerId;
+        active.StrokeId = id;
+        active.Anchor = sample;
+        active.HasLatest = false;
+        m_active.push_back(active);
+
+        // The first sample is always kept
+        ++m_totalSamples;
+        StorePoint(id, sample);
+        return true;
+    }
+
+    bool StrokeStore::Append(uint32_t pointerId, PointerSample const& sample)
+    {
+        size_t const slot = FindActive(pointerId);
+        if (slot == npos)
+        {
+            return false;
+        }
+
+        ++m_totalSamples;
+        ActiveStroke& active = m_active[slot];
+
+        // Distance filter against the newest sample we're holding on to
+        PointerSample const& previous = active.HasLatest ? active.Latest : active.Anchor;
+        if (DistanceSquared(previous, sample) < m_options.MinDistance * m_options.MinDistance)
+        {
+            return true;
+        }
+
+        if (!active.HasLatest)
+        {
+            StartSegment(active, sample);
+            return true;
+        }
+
+        // A line from the anchor through the new sample passes within tolerance
+        // of a sample at distance d if its direction is within asin(tolerance / d)
+        // of that sample's. While the new sample's direction is inside the range
+        // all earlier samples allow (and the path isn't doubling back), the line
+        // replaces them; otherwise the path bent at the previous sample.
+        float const dx = sample.X - active.Anchor.X;
+        float const dy = sample.Y - active.Anchor.Y;
+        float const distance = std::sqrt(dx * dx + dy * dy);
+        float const direction = WrapAngle(std::atan2(dy, dx) - active.Reference);
+
+        float const slope = (distance > 0.0f) ? (sample.Pressure - active.Anchor.Pressure) / distance : 0.0f;
+        bool const bent = (direction < active.Low) || (direction > active.High) || (distance < active.MaxDistance - m_options.Tolerance) ||
+            (slope < active.PressureLow) || (slope > active.PressureHigh);
+        if (!bent)
+        {
+            float const spread = (distance > m_options.Tolerance) ? std::asin(m_options.Tolerance / distance) : 1.57079633f;
+            active.Low = std::max(active.Low, direction - spread);
+            active.High = std::min(active.High, direction + spread);
+            active.MaxDistance = std::max(active.MaxDistance, distance);
+            NarrowPressure(active, sample, distance);
+            active.Latest = sample;
+            return true;
+        }
+
+        PointerSample const corner = active.Latest;
+        uint64_t const strokeId = active.StrokeId;
+        active.Anchor = corner;
+        StartSegment(active, sample);
+
+        // May evict other strokes, so active isn't used past this point
+        StorePoint(strokeId, corner);
+        return true;
+    }
+
+    void StrokeStore::StartSegment(ActiveStroke& active, PointerSample const& sample) noexcept
+    {
+        float const dx = sample.X - active.Anchor.X;
+        float const dy = sample.Y - active.Anchor.Y;
+        float const distance = std::sqrt(dx * dx + dy * dy);
+        float const spread = (distance > m_options.Tolerance) ? std::asin(m_options.Tolerance / distance) : 1.57079633f;
+
+        active.Latest = sample;
+        active.HasLatest = true;
+        active.Reference = std::atan2(dy, dx);
+        active.Low = -spread;
+        active.High = spread;
+        active.MaxDistance = distance;
+        active.PressureLow = -INFINITY;
+        active.PressureHigh = INFINITY;
+        NarrowPressure(active, sample, distance);
+    }
+
+    void StrokeStore::NarrowPressure(ActiveStroke& active, PointerSample const& sample, float distance) const noexcept
+    {
+        // Ramps that pass within tolerance of the sample's pressure
+        if (distance > 0.0f)
+        {
+            float const rise = sample.Pressure - active.Anchor.Pressure;
+            active.PressureLow = std::max(active.PressureLow, (rise - m_options.PressureTolerance) / distance);
+            active.PressureHigh = std::min(active.PressureHigh, (rise + m_options.PressureTolerance) / distance);
+        }
+    }
+
+    void StrokeStore::End(uint32_t pointerId)
+    {
+        size_t const slot = FindActive(pointerId);
+        if (slot == npos)
+        {
+            return;
+        }
+
+        // The last sample always ends the stroke
+        ActiveStroke const& active = m_active[slot];
+        uint64_t const strokeId = active.StrokeId;
+        if (active.HasLatest)
+        {
+            StorePoint(strokeId, active.Latest);
+        }
+
+        m_strokes[FindStroke(strokeId)].Active = npos;
+
+        // Keep m_active dense, and point the moved stroke at its new slot
+        size_t const last = m_active.size() - 1;
+        if (slot != last)
+        {
+            m_active[slot] = m_active[last];
+            m_strokes[FindStroke(m_active[slot].StrokeId)].Active = slot;
+        }
+        m_active.pop_back();
+    }
+
+    void StrokeStore::Clear() noexcept
+    {
+        m_strokes.clear();
+        m_active.clear();
+        m_chunks.clear();
+        m_freeChunks = NoChunk;
+        m_freeChunkCount = 0;
+    }
+
+    size_t StrokeStore::StrokePointCount(size_t index) const noexcept
+    {
+        Stroke const& stroke = m_strokes[index];
+        bool const hasLatest = (stroke.Active != npos) && m_active[stroke.Active].HasLatest;
+        return stroke.PointCount + (hasLatest ? 1 : 0);
+    }
+
+    bool StrokeStore::LatestPoint(size_t index, PointerSample& sample) const noexcept
+    {
+        Stroke const& stroke = m_strokes[index];
+        if ((stroke.Active == npos) || !m_active[stroke.Active].HasLatest)
+        {
+            return false;
+        }
+
+        sample = m_active[stroke.Active].Latest;
+        return true;
+    }
+
+    void StrokeStore::CopyPoints(size_t index, std::vector<PointerSample>& out) const
+    {
+        out.clear();
+        out.reserve(StrokePointCount(index));
+        ForEachPoint(index, [&out](PointerSample const& point) { out.push_back(point); });
+    }
+
+    size_t StrokeStore::MemoryBytes() const noexcept
+    {
+        return m_chunks.capacity() * sizeof(Chunk) + m_strokes.capacity() * sizeof(Stroke) + m_active.capacity() * sizeof(ActiveStroke);
+    }
+
+    void StrokeStore::StorePoint(uint64_t strokeId, PointerSample const& sample)
+    {
+        size_t index = FindStroke(strokeId);
+        uint32_t chunk = m_strokes[index].LastChunk;
+        if ((chunk == NoChunk) || (m_chunks[chunk].Count == ChunkCapacity))
+        {
+            uint32_t const newChunk = AllocateChunk();
+            if (newChunk == NoChunk)
+            {
+                ++m_droppedPoints;
+                return;
+            }
+
+            // Eviction may have moved the stroke
+            index = FindStroke(strokeId);
+            Stroke& stroke = m_strokes[index];
+            if (chunk == NoChunk)
+            {
+                stroke.FirstChunk = newChunk;
+            }
+            else
+            {
+                m_chunks[chunk].Next = newChunk;
+                m_chunks[newChunk].Previous = chunk;
+            }
+            stroke.LastChunk = newChunk;
+            chunk = newChunk;
+        }
+
+        Chunk& points = m_chunks[chunk];
+        points.Points[points.Count++] = sample;
+        ++m_strokes[index].PointCount;
+        ++m_storedPoints;
+    }
+
+    uint32_t StrokeStore::AllocateChunk()
+    {
+        while (m_freeChunks == NoChunk)
+        {
+            if (m_chunks.size() < m_options.MaxChunks)
+            {
+                m_chunks.emplace_back();
+                m_chunks.back().Next = NoChunk;
+                m_chunks.back().Previous = NoChunk;
+                m_chunks.back().Count = 0;
+                return static_cast<uint32_t>(m_chunks.size() - 1);
+            }
+
+            if (!EvictOldestFinished())
+            {
+                return NoChunk;
+            }
+        }
+
+        uint32_t const chunk = m_freeChunks;
+        m_freeChunks = m_chunks[chunk].Next;
+        --m_freeChunkCount;
+
+        m_chunks[chunk].Next = NoChunk;
+        m_chunks[chunk].Previous = NoChunk;
+        m_chunks[chunk].Count = 0;
+        return chunk;
+    }
+
+    bool StrokeStore::EvictOldestFinished()
+    {
+        auto const itr = std::find_if(m_strokes.begin(), m_strokes.end(), [](Stroke const& stroke) { return stroke.Active == npos; });
+        if (itr == m_strokes.end())
+        {
+            return false;
+        }
+
+        ReleaseChunks(itr->FirstChunk);
+        m_strokes.erase(itr);
+        ++m_evictedStrokes;
+        return true;
+    }
+
+    void StrokeStore::ReleaseChunks(uint32_t first)
+    {
+        while (first != NoChunk)
+        {
+            uint32_t const next = m_chunks[first].Next;
+            m_chunks[first].Next = m_freeChunks;
+            m_freeChunks = first;
+            ++m_freeChunkCount;
+            first = next;
+        }
+    }
+}
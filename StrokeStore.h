@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointerTable.h"
+#include "PointerTypes.h"
+
+namespace PointerCore
+{
+    // Ink strokes recorded from pressed pointers, from press to release.
+    //
+    // Points live in fixed-size chunks taken from a pool with a free list, so
+    // appending never reallocates a stroke and a stroke's memory goes back to the
+    // pool in one piece. The pool is capped at Options::MaxChunks; once it is
+    // exhausted the oldest finished strokes are evicted to make room.
+    //
+    // Paths are simplified while they are recorded: samples closer than
+    // MinDistance to the previous one are dropped, and a point is only stored
+    // when a single line from the last stored point can no longer pass within
+    // Tolerance of every sample since (sleeve fitting, O(1) per sample by
+    // narrowing the range of allowed directions). Pressure is fitted the same
+    // way, against a linear ramp along the line, so a straight stroke still
+    // keeps the points where the pen pressed harder or lighter. The most recent
+    // sample of an active stroke is always visible to readers, even before it's
+    // stored.
+    class StrokeStore
+    {
+    public:
+        static constexpr size_t ChunkCapacity = 16;
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        struct Options
+        {
+            // Samples closer than this to the previous kept sample are dropped, in DIPs
+            float MinDistance = 0.75f;
+
+            // Largest distance a dropped sample may have from the stored path, in DIPs
+            float Tolerance = 0.35f;
+
+            // Largest difference between a dropped sample's pressure and the
+            // pressure interpolated along the stored path. At the default
+            // stroke widths 0.05 is 0.35 DIPs of width.
+            float PressureTolerance = 0.05f;
+
+            // Upper bound on the point storage, in chunks of ChunkCapacity points
+            size_t MaxChunks = 65536;
+
+            // Most strokes that can be recorded at the same time
+            size_t MaxActiveStrokes = PointerTable::DefaultCapacity;
+        };
+
+        StrokeStore();
+        explicit StrokeStore(Options const& options);
+
+        // Starts a stroke for the pointer, ending any stroke it already had.
+        // Returns false if no more strokes can be active at once.
+        bool Begin(uint32_t pointerId, PointerSample const& sample);
+
+        // Returns false if the pointer has no active stroke
+        bool Append(uint32_t pointerId, PointerSample const& sample);
+
+        // Finishes the pointer's active stroke, if any
+        void End(uint32_t pointerId);
+
+        bool IsActive(uint32_t pointerId) const noexcept { return FindActive(pointerId) != npos; }
+        void Clear() noexcept;
+
+        // Strokes, oldest first. Indices are only stable until the next Begin()
+        // or Append() (which may evict).
+        size_t StrokeCount() const noexcept { return m_strokes.size(); }
+        uint64_t StrokeId(size_t index) const noexcept { return m_strokes[index].Id; }
+        uint32_t StrokePointerId(size_t index) const noexcept { return m_strokes[index].PointerId; }
+        bool IsStrokeActive(size_t index) const noexcept { return m_strokes[index].Active != npos; }
+        size_t StrokePointCount(size_t index) const noexcept;
+
+        // Points that have been stored for good, i.e. all but the newest
+        // sample of an active stroke. Stored points never change.
+        size_t StoredPointCount(size_t index) const noexcept { return m_strokes[index].PointCount; }
+
+        // The newest sample of an active stroke, which may still be replaced.
+        // Returns false for finished strokes.
+        bool LatestPoint(size_t index, PointerSample& sample) const noexcept;
+
+        // Calls fn(PointerSample const&) for every point of the stroke, in order
+        template <typename Fn>
+        void ForEachPoint(size_t index, Fn&& fn) const
+        {
+            ForEachStoredPoint(index, 0, fn);
+
+            PointerSample latest;
+            if (LatestPoint(index, latest))
+            {
+                fn(static_cast<PointerSample const&>(latest));
+            }
+        }
+
+        // Calls fn(PointerSample const&) for the stored points from first on,
+        // skipping whole chunks from whichever end of the stroke is closer
+        template <typename Fn>
+        void ForEachStoredPoint(size_t index, size_t first, Fn&& fn) const
+        {
+            Stroke const& stroke = m_strokes[index];
+            if (first >= stroke.PointCount)
+            {
+                return;
+            }
+
+            // Every chunk but the last is full
+            size_t const target = first / ChunkCapacity;
+            size_t const last = (stroke.PointCount - 1) / ChunkCapacity;
+            uint32_t chunk;
+            if (last - target < target)
+            {
+                chunk = stroke.LastChunk;
+                for (size_t n = last; n > target; --n)
+                {
+                    chunk = m_chunks[chunk].Previous;
+                }
+            }
+            else
+            {
+                chunk = stroke.FirstChunk;
+                for (size_t n = 0; n < target; ++n)
+                {
+                    chunk = m_chunks[chunk].Next;
+                }
+            }
+
+            for (first -= target * ChunkCapacity; chunk != NoChunk; chunk = m_chunks[chunk].Next, first = 0)
+            {
+                Chunk const& points = m_chunks[chunk];
+                for (size_t i = first; i < points.Count; ++i)
+                {
+                    fn(points.Points[i]);
+                }
+            }
+        }
+
+        // Replaces the contents of out with the stroke's points
+        void CopyPoints(size_t index, std::vector<PointerSample>& out) const;
+
+        // Memory use and lifetime counters
+        size_t ChunkCount() const noexcept { return m_chunks.size(); }
+        size_t FreeChunkCount() const noexcept { return m_freeChunkCount; }
+        size_t MemoryBytes() const noexcept;
+        uint64_t TotalSamples() const noexcept { return m_totalSamples; }
+        uint64_t StoredPoints() const noexcept { return m_storedPoints; }
+        uint64_t EvictedStrokes() const noexcept { return m_evictedStrokes; }
+        uint64_t DroppedPoints() const noexcept { return m_droppedPoints; }
+
+    private:
+        static constexpr uint32_t NoChunk = UINT32_MAX;
+
+        struct Chunk
+        {
+            uint32_t Next;
+            uint32_t Previous;
+            uint32_t Count;
+            PointerSample Points[ChunkCapacity];
+        };
+
+        struct Stroke
+        {
+            uint64_t Id;
+            uint32_t PointerId;
+            uint32_t FirstChunk;
+            uint32_t LastChunk;
+            uint32_t PointCount;
+
+            // Index into m_active, or npos once the stroke is finished
+            size_t Active;
+        };
+
+        // Simplification state of a stroke that is still being drawn. Latest
+        // is the newest sample since Anchor, the last stored point. Every
+        // sample in between is within tolerance of a line from Anchor in any
+        // direction in [Low, High], in radians relative to Reference, and its
+        // pressure is within tolerance of a ramp from Anchor's rising by any
+        // slope in [PressureLow, PressureHigh] per DIP.
+        struct ActiveStroke
+        {
+            uint32_t PointerId;
+            uint64_t StrokeId;
+            PointerSample Anchor;
+            PointerSample Latest;
+            bool HasLatest;
+            float Reference;
+            float Low;
+            float High;
+            float MaxDistance;
+            float PressureLow;
+            float PressureHigh;
+        };
+
+        size_t FindActive(uint32_t pointerId) const noexcept;
+        size_t FindStroke(uint64_t id) const noexcept;
+        void StartSegment(ActiveStroke& active, PointerSample const& sample) noexcept;
+        void NarrowPressure(ActiveStroke& active, PointerSample const& sample, float distance) const noexcept;
+        void StorePoint(uint64_t strokeId, PointerSample const& sample);
+        uint32_t AllocateChunk();
+        bool EvictOldestFinished();
+        void ReleaseChunks(uint32_t first);
+
+        Options m_options;
+
+        // Sorted by Id
+        std::vector<Stroke> m_strokes;
+        std::vector<ActiveStroke> m_active;
+        uint64_t m_nextStrokeId{ 0 };
+
+        std::vector<Chunk> m_chunks;
+        uint32_t m_freeChunks{ NoChunk };
+        size_t m_freeChunkCount{ 0 };
+
+        uint64_t m_totalSamples{ 0 };
+        uint64_t m_storedPoints{ 0 };
+        uint64_t m_evictedStrokes{ 0 };
+        uint64_t m_droppedPoints{ 0 };
+    };
+}
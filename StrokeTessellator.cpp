@@ -0,0 +1,274 @@
+#include "StrokeTessellator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define POINTERCORE_TESSELLATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace PointerCore
+{
+    static constexpr Rect EmptyRect{ INFINITY, INFINITY, -INFINITY, -INFINITY };
+
+    static inline void Include(Rect& bounds, Rect const& other) noexcept
+    {
+        bounds.Left = std::min(bounds.Left, other.Left);
+        bounds.Top = std::min(bounds.Top, other.Top);
+        bounds.Right = std::max(bounds.Right, other.Right);
+        bounds.Bottom = std::max(bounds.Bottom, other.Bottom);
+    }
+
+    static inline Rect VertexBounds(Point const* vertices, size_t count) noexcept
+    {
+        Rect bounds = EmptyRect;
+        for (size_t i = 0; i < count; ++i)
+        {
+            bounds.Left = std::min(bounds.Left, vertices[i].X);
+            bounds.Top = std::min(bounds.Top, vertices[i].Y);
+            bounds.Right = std::max(bounds.Right, vertices[i].X);
+            bounds.Bottom = std::max(bounds.Bottom, vertices[i].Y);
+        }
+
+        return bounds;
+    }
+
+    static inline bool SameSample(PointerSample const& a, PointerSample const& b) noexcept
+    {
+        return (a.X == b.X) && (a.Y == b.Y) && (a.Pressure == b.Pressure);
+    }
+
+    // Writes the vertex pair of every point in [begin, count) to out, two per
+    // point. Each point's normal comes from the direction between its
+    // neighbors (just the one neighbor at either end of the run).
+    static void ComputePairs(float const* xs, float const* ys, float const* halfWidths, size_t count, size_t begin, Point* out) noexcept
+    {
+        auto scalarPair = [&](size_t i)
+        {
+            size_t const previous = (i > 0) ? i - 1 : 0;
+            size_t const next = (i + 1 < count) ? i + 1 : count - 1;
+            float const tx = xs[next] - xs[previous];
+            float const ty = ys[next] - ys[previous];
+            float const length = std::sqrt(tx * tx + ty * ty);
+            float const scale = (length > 0.0f) ? halfWidths[i] / length : 0.0f;
+            float const nx = -ty * scale;
+            float const ny = tx * scale;
+
+            Point* pair = out + 2 * (i - begin);
+            pair[0] = { xs[i] + nx, ys[i] + ny };
+            pair[1] = { xs[i] - nx, ys[i] - ny };
+        };
+
+        size_t i = begin;
+
+        // The first point has no previous neighbor
+        if ((i == 0) && (i < count))
+        {
+            scalarPair(i++);
+        }
+
+#if defined(POINTERCORE_TESSELLATOR_SSE2)
+        // Interior points, four at a time, while all their next neighbors exist
+        __m128 const zero = _mm_setzero_ps();
+        for (; i + 5 <= count; i += 4)
+        {
+            __m128 const x = _mm_loadu_ps(xs + i);
+            __m128 const y = _mm_loadu_ps(ys + i);
+            __m128 const tx = _mm_sub_ps(_mm_loadu_ps(xs + i + 1), _mm_loadu_ps(xs + i - 1));
+            __m128 const ty = _mm_sub_ps(_mm_loadu_ps(ys + i + 1), _mm_loadu_ps(ys + i - 1));
+
+            // Zero-length tangents get a zero normal, like the scalar path
+            __m128 const lengthSquared = _mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty));
+            __m128 const valid = _mm_cmpgt_ps(lengthSquared, zero);
+            __m128 const scale = _mm_and_ps(valid, _mm_div_ps(_mm_loadu_ps(halfWidths + i), _mm_sqrt_ps(_mm_max_ps(lengthSquared, _mm_set1_ps(1e-30f)))));
+            __m128 const nx = _mm_mul_ps(_mm_sub_ps(zero, ty), scale);
+            __m128 const ny = _mm_mul_ps(tx, scale);
+
+            // Columns (left x, left y, right x, right y) transpose into one
+            // vertex pair per row
+            __m128 leftX = _mm_add_ps(x, nx);
+            __m128 leftY = _mm_add_ps(y, ny);
+            __m128 rightX = _mm_sub_ps(x, nx);
+            __m128 rightY = _mm_sub_ps(y, ny);
+            _MM_TRANSPOSE4_PS(leftX, leftY, rightX, rightY);
+
+            float* pairs = &out[2 * (i - begin)].X;
+            _mm_storeu_ps(pairs, leftX);
+            _mm_storeu_ps(pairs + 4, leftY);
+            _mm_storeu_ps(pairs + 8, rightX);
+            _mm_storeu_ps(pairs + 12, rightY);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            scalarPair(i);
+        }
+    }
+
+    StrokeTessellator::StrokeTessellator()
+        : StrokeTessellator(Options{})
+    {
+    }
+
+    StrokeTessellator::StrokeTessellator(Options const& options)
+        : m_options{ options }
+    {
+    }
+
+    float StrokeTessellator::HalfWidth(float pressure) const noexcept
+    {
+        return 0.5f * (m_options.MinWidth + (m_options.MaxWidth - m_options.MinWidth) * std::clamp(pressure, 0.0f, 1.0f));
+    }
+
+    bool StrokeTessellator::Update(StrokeStore const& strokes, Rect& changed)
+    {
+        changed = EmptyRect;
+        bool anyChanged = false;
+
+        // Both sides are sorted by stroke ID. Meshes whose stroke is gone
+        // (evicted or cleared) are dropped, new strokes get a mesh.
+        auto& meshes = m_nextMeshes;
+        meshes.clear();
+
+        size_t mesh = 0;
+        for (size_t stroke = 0; stroke < strokes.StrokeCount(); ++stroke)
+        {
+            uint64_t const id = strokes.StrokeId(stroke);
+            for (; (mesh < m_meshes.size()) && (m_meshes[mesh].StrokeId < id); ++mesh)
+            {
+                Include(changed, m_meshes[mesh].Bounds);
+                anyChanged = true;
+            }
+
+            if ((mesh < m_meshes.size()) && (m_meshes[mesh].StrokeId == id))
+            {
+                meshes.push_back(std::move(m_meshes[mesh++]));
+            }
+            else
+            {
+                Mesh added{};
+                added.StrokeId = id;
+                added.Bounds = EmptyRect;
+                meshes.push_back(std::move(added));
+            }
+
+            if (!meshes.back().Finished)
+            {
+                anyChanged |= Extend(meshes.back(), strokes, stroke, changed);
+            }
+        }
+
+        for (; mesh < m_meshes.size(); ++mesh)
+        {
+            Include(changed, m_meshes[mesh].Bounds);
+            anyChanged = true;
+        }
+
+        std::swap(m_meshes, meshes);
+        return anyChanged;
+    }
+
+    size_t StrokeTessellator::MeshStableVertexCount(size_t index) const noexcept
+    {
+        auto const& mesh = m_meshes[index];
+        if (mesh.Finished)
+        {
+            return mesh.Vertices.size();
+        }
+
+        // Extend() redoes the last stored point's pair and everything after it
+        return (mesh.StoredPoints > 0) ? 2 * (mesh.StoredPoints - 1) : 0;
+    }
+
+    bool StrokeTessellator::Extend(Mesh& mesh, StrokeStore const& strokes, size_t index, Rect& changed)
+    {
+        size_t const stored = strokes.StoredPointCount(index);
+        PointerSample latest{};
+        bool const hasLatest = strokes.LatestPoint(index, latest);
+
+        if ((stored == mesh.StoredPoints) && (hasLatest == mesh.HasLatest) && (!hasLatest || SameSample(latest, mesh.Latest)))
+        {
+            mesh.Finished = !strokes.IsStrokeActive(index);
+            return false;
+        }
+
+        // Stage the points to tessellate: up to two already tessellated stored
+        // points for context, then the new stored points and the latest sample
+        m_x.clear();
+        m_y.clear();
+        m_halfWidth.clear();
+        auto stage = [this](PointerSample const& point)
+        {
+            m_x.push_back(point.X);
+            m_y.push_back(point.Y);
+            m_halfWidth.push_back(HalfWidth(point.Pressure));
+        };
+
+        size_t const context = std::min<size_t>(mesh.StoredPoints, 2);
+        for (size_t i = 2 - context; i < 2; ++i)
+        {
+            m_x.push_back(mesh.TailX[i]);
+            m_y.push_back(mesh.TailY[i]);
+            m_halfWidth.push_back(mesh.TailHalfWidth[i]);
+        }
+
+        strokes.ForEachStoredPoint(index, mesh.StoredPoints, stage);
+        size_t const stagedStored = m_x.size();
+        if (hasLatest)
+        {
+            stage(latest);
+        }
+
+        // The last tessellated stored point gets a new neighbor, so its pair is
+        // redone along with everything after it. The triangles between it and
+        // the pair before change too, hence the extra pair in the damage.
+        size_t const firstStaged = (context > 0) ? context - 1 : 0;
+        size_t const firstPoint = mesh.StoredPoints - context + firstStaged;
+        size_t const damageStart = 2 * ((firstPoint > 0) ? firstPoint - 1 : 0);
+
+        auto& vertices = mesh.Vertices;
+        if (damageStart < vertices.size())
+        {
+            Include(changed, VertexBounds(vertices.data() + damageStart, vertices.size() - damageStart));
+        }
+
+        size_t const pointCount = mesh.StoredPoints - context + m_x.size();
+        vertices.resize(2 * pointCount);
+        ComputePairs(m_x.data(), m_y.data(), m_halfWidth.data(), m_x.size(), firstStaged, vertices.data() + 2 * firstPoint);
+        m_pairsComputed += m_x.size() - firstStaged;
+
+        Rect const added = VertexBounds(vertices.data() + damageStart, vertices.size() - damageStart);
+        Include(changed, added);
+        Include(mesh.Bounds, added);
+
+        // Remember the last two stored points as context for the next update
+        for (size_t i = 0; i < 2; ++i)
+        {
+            size_t const offset = 2 - i;
+            if (stagedStored >= offset)
+            {
+                size_t const staged = stagedStored - offset;
+                mesh.TailX[i] = m_x[staged];
+                mesh.TailY[i] = m_y[staged];
+                mesh.TailHalfWidth[i] = m_halfWidth[staged];
+            }
+        }
+
+        mesh.StoredPoints = stored;
+        mesh.HasLatest = hasLatest;
+        mesh.Latest = latest;
+        mesh.Finished = false;
+        return true;
+    }
+
+    char const* StrokeTessellator::TessellationPathName() noexcept
+    {
+#if defined(POINTERCORE_TESSELLATOR_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+}
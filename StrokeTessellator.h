@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderBackend.h"
+#include "StrokeStore.h"
+
+namespace PointerCore
+{
+    // Turns the strokes of a StrokeStore into variable-width triangle strips.
+    //
+    // Every stroke point contributes a pair of vertices, offset to either side
+    // along the path's normal by a half width that follows the pen pressure.
+    // Update() is incremental: only the pairs of points added since the last
+    // call are computed, plus the last two pairs before them, since their
+    // normals change once they have a new neighbor (and the newest point of an
+    // active stroke is provisional). Finished strokes cost nothing per frame.
+    //
+    // Pair computation is SSE2 on x86/x64 and a scalar loop everywhere else.
+    class StrokeTessellator
+    {
+    public:
+        struct Options
+        {
+            // Stroke widths at zero and full pressure, in DIPs
+            float MinWidth = 1.0f;
+            float MaxWidth = 8.0f;
+        };
+
+        StrokeTessellator();
+        explicit StrokeTessellator(Options const& options);
+
+        Options const& GetOptions() const noexcept { return m_options; }
+
+        // Brings the meshes in line with the store. Returns false if nothing
+        // changed, otherwise changed holds the bounds of every vertex that was
+        // added, moved or removed.
+        bool Update(StrokeStore const& strokes, Rect& changed);
+
+        void Clear() noexcept { m_meshes.clear(); }
+
+        // Meshes, in stroke order (later ones draw on top)
+        size_t MeshCount() const noexcept { return m_meshes.size(); }
+        uint64_t MeshStrokeId(size_t index) const noexcept { return m_meshes[index].StrokeId; }
+        Point const* MeshVertices(size_t index) const noexcept { return m_meshes[index].Vertices.data(); }
+        size_t MeshVertexCount(size_t index) const noexcept { return m_meshes[index].Vertices.size(); }
+        Rect const& MeshBounds(size_t index) const noexcept { return m_meshes[index].Bounds; }
+
+        // Leading vertices that no later Update() moves: all of them once the
+        // stroke has finished, otherwise those before the last stored point's
+        // pair. Backends can keep these on the device between frames.
+        size_t MeshStableVertexCount(size_t index) const noexcept;
+
+        float HalfWidth(float pressure) const noexcept;
+
+        // Lifetime count of vertex pairs computed, to keep an eye on the incremental work
+        uint64_t PairsComputed() const noexcept { return m_pairsComputed; }
+
+        // Name of the compiled-in tessellation path, for logging and benchmarks
+        static char const* TessellationPathName() noexcept;
+
+    private:
+        struct Mesh
+        {
+            uint64_t StrokeId;
+            std::vector<Point> Vertices;
+
+            // How much of the stroke the vertices cover
+            size_t StoredPoints;
+            bool HasLatest;
+            PointerSample Latest;
+
+            // The last two stored points (position and half width), the
+            // neighbors new points are tessellated against
+            float TailX[2];
+            float TailY[2];
+            float TailHalfWidth[2];
+
+            // Covers every vertex the mesh ever had
+            Rect Bounds;
+            bool Finished;
+        };
+
+        bool Extend(Mesh& mesh, StrokeStore const& strokes, size_t index, Rect& changed);
+
+        Options m_options;
+
+        // Sorted by stroke ID, like the store. m_nextMeshes is where Update()
+        // merges them with the store's strokes.
+        std::vector<Mesh> m_meshes;
+        std::vector<Mesh> m_nextMeshes;
+
+        // Structure-of-arrays staging for the points being tessellated
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_halfWidth;
+
+        uint64_t m_pairsComputed{ 0 };
+    };
+}
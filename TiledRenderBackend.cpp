@@ -0,0 +1,308 @@
+#include "TiledRenderBackend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace PointerCore
+{
+    namespace
+    {
+        uint64_t Mix(uint64_t hash, uint64_t value) noexcept
+        {
+            hash = (hash ^ value) * 0x9e3779b97f4a7c15ull;
+            return hash ^ (hash >> 32);
+        }
+
+        uint64_t Bits(float value) noexcept
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        uint64_t HashRect(uint64_t hash, PixelRect const& rect) noexcept
+        {
+            hash = Mix(hash, (static_cast<uint64_t>(static_cast<uint32_t>(rect.Left)) << 32) | static_cast<uint32_t>(rect.Top));
+            return Mix(hash, (static_cast<uint64_t>(static_cast<uint32_t>(rect.Right)) << 32) | static_cast<uint32_t>(rect.Bottom));
+        }
+
+        // Pixels a piece of strip may cover. A NaN coordinate makes every
+        // triangle using its vertex degenerate, so those vertices are left
+        // out rather than dropping the piece's other triangles.
+        PixelRect StripBounds(Point const* vertices, size_t count) noexcept
+        {
+            float left = INFINITY;
+            float top = INFINITY;
+            float right = -INFINITY;
+            float bottom = -INFINITY;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (std::isnan(vertices[i].X) || std::isnan(vertices[i].Y))
+                {
+                    continue;
+                }
+
+                left = std::min(left, vertices[i].X);
+                top = std::min(top, vertices[i].Y);
+                right = std::max(right, vertices[i].X);
+                bottom = std::max(bottom, vertices[i].Y);
+            }
+
+            if (left > right)
+            {
+                return {};
+            }
+
+            constexpr float Limit = 1 << 30;
+            return {
+                static_cast<int32_t>(std::floor(std::clamp(left, -Limit, Limit))),
+                static_cast<int32_t>(std::floor(std::clamp(top, -Limit, Limit))),
+                static_cast<int32_t>(std::floor(std::clamp(right, -Limit, Limit))) + 1,
+                static_cast<int32_t>(std::floor(std::clamp(bottom, -Limit, Limit))) + 1 };
+        }
+
+        bool Contains(PixelRect const& outer, PixelRect const& inner) noexcept
+        {
+            return (outer.Left <= inner.Left) && (outer.Top <= inner.Top) && (outer.Right >= inner.Right) && (outer.Bottom >= inner.Bottom);
+        }
+    }
+
+    TiledRenderBackend::TiledRenderBackend(SoftwareRenderBackend& target, WorkStealingPool& pool)
+        : TiledRenderBackend(target, pool, Options())
+    {
+    }
+
+    TiledRenderBackend::TiledRenderBackend(SoftwareRenderBackend& target, WorkStealingPool& pool, Options const& options)
+        : m_target{ target }
+        , m_pool{ pool }
+        , m_options{ options }
+    {
+        m_options.TileSize = std::max(m_options.TileSize, 8u);
+        m_options.TrianglesPerPiece = std::max(m_options.TrianglesPerPiece, 1u);
+        ResizeGrid();
+    }
+
+    void TiledRenderBackend::Invalidate() noexcept
+    {
+        for (auto& tile : m_tiles)
+        {
+            tile.HasSignature = false;
+        }
+    }
+
+    void TiledRenderBackend::ResizeGrid()
+    {
+        m_gridWidth = m_target.Width();
+        m_gridHeight = m_target.Height();
+        m_columns = (m_gridWidth + m_options.TileSize - 1) / m_options.TileSize;
+        uint32_t const rows = (m_gridHeight + m_options.TileSize - 1) / m_options.TileSize;
+
+        int32_t const size = static_cast<int32_t>(m_options.TileSize);
+        m_tiles.resize(static_cast<size_t>(m_columns) * rows);
+        for (uint32_t row = 0; row < rows; ++row)
+        {
+            for (uint32_t column = 0; column < m_columns; ++column)
+            {
+                Tile& tile = m_tiles[static_cast<size_t>(row) * m_columns + column];
+                int32_t const left = static_cast<int32_t>(column) * size;
+                int32_t const top = static_cast<int32_t>(row) * size;
+                tile.Bounds = {
+                    left,
+                    top,
+                    std::min(left + size, static_cast<int32_t>(m_gridWidth)),
+                    std::min(top + size, static_cast<int32_t>(m_gridHeight)) };
+                tile.Commands.clear();
+                tile.HasSignature = false;
+            }
+        }
+
+        m_touchedTiles.clear();
+    }
+
+    PixelRect TiledRenderBackend::CurrentClip() const noexcept
+    {
+        PixelRect const surface{ 0, 0, static_cast<int32_t>(m_gridWidth), static_cast<int32_t>(m_gridHeight) };
+        return m_clipStack.empty() ? surface : Intersection(m_clipStack.back(), surface);
+    }
+
+    void TiledRenderBackend::BeginDraw()
+    {
+        if ((m_target.Width() != m_gridWidth) || (m_target.Height() != m_gridHeight))
+        {
+            ResizeGrid();
+        }
+
+        for (uint32_t index : m_touchedTiles)
+        {
+            m_tiles[index].Commands.clear();
+        }
+        m_touchedTiles.clear();
+        m_commands.clear();
+        m_vertices.clear();
+        m_sheets.clear();
+        m_clipStack.clear();
+    }
+
+    void TiledRenderBackend::Clear(Color const& color)
+    {
+        PixelRect const clip = CurrentClip();
+        Record({ CommandKind::Clear, m_target.PackColor(color), clip, {}, 0, 0, 0, {}, 0 }, clip);
+    }
+
+    void TiledRenderBackend::FillRectangle(Rect const& rect, Color const& color)
+    {
+        PixelRect const clip = CurrentClip();
+        Command command{ CommandKind::Rectangle, m_target.PackColor(color), clip, rect, 0, 0, 0, {}, 0 };
+        command.Hash = Mix(Mix(Mix(Mix(0, Bits(rect.Left)), Bits(rect.Top)), Bits(rect.Right)), Bits(rect.Bottom));
+        Record(command, Intersection(SoftwareRenderBackend::CoveredPixels(rect), clip));
+    }
+
+    void TiledRenderBackend::FillTriangleStrip(Point const* vertices, size_t count, Color const& color)
+    {
+        if (count < 3)
+        {
+            return;
+        }
+
+        PixelRect const clip = CurrentClip();
+        uint32_t const value = m_target.PackColor(color);
+        size_t const first = m_vertices.size();
+        m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+
+        // Pieces share their last two vertices with the next one
+        size_t const triangles = m_options.TrianglesPerPiece;
+        for (size_t start = 0; start + 2 < count; start += triangles)
+        {
+            size_t const length = std::min(triangles, count - 2 - start) + 2;
+            Point const* piece = m_vertices.data() + first + start;
+
+            Command command{ CommandKind::Strip, value, clip, {}, first + start, length, 0, {}, 0 };
+            for (size_t i = 0; i < length; ++i)
+            {
+                command.Hash = Mix(command.Hash, (Bits(piece[i].X) << 32) | Bits(piece[i].Y));
+            }
+
+            Record(command, Intersection(StripBounds(piece, length), clip));
+        }
+    }
+
+    void TiledRenderBackend::DrawSprites(SpriteSheet const& sheet, SpriteInstance const* sprites, size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        PixelRect const clip = CurrentClip();
+        size_t const sheetIndex = m_sheets.size();
+        m_sheets.push_back(sheet);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Rect const& destination = sprites[i].Destination;
+            Command command{ CommandKind::Sprite, 0, clip, destination, 0, 0, sheetIndex, sprites[i].Source, sheet.Version };
+            command.Hash = HashRect(Mix(command.Hash, (Bits(destination.Left) << 32) | Bits(destination.Top)), sprites[i].Source);
+            Record(command, Intersection(SoftwareRenderBackend::SpritePixels(sprites[i]), clip));
+        }
+    }
+
+    void TiledRenderBackend::Record(Command command, PixelRect const& bounds)
+    {
+        if (bounds.IsEmpty())
+        {
+            return;
+        }
+
+        command.Hash = HashRect(Mix(Mix(command.Hash, static_cast<uint64_t>(command.Kind)), command.Value), command.Clip);
+        auto const index = static_cast<uint32_t>(m_commands.size());
+        m_commands.push_back(command);
+
+        int32_t const size = static_cast<int32_t>(m_options.TileSize);
+        for (int32_t row = bounds.Top / size; row * size < bounds.Bottom; ++row)
+        {
+            for (int32_t column = bounds.Left / size; column * size < bounds.Right; ++column)
+            {
+                uint32_t const tileIndex = static_cast<uint32_t>(row) * m_columns + static_cast<uint32_t>(column);
+                Tile& tile = m_tiles[tileIndex];
+                if (tile.Commands.empty())
+                {
+                    m_touchedTiles.push_back(tileIndex);
+                }
+                tile.Commands.push_back(index);
+            }
+        }
+    }
+
+    void TiledRenderBackend::EndDraw()
+    {
+        m_dirtyTiles.clear();
+        for (uint32_t index : m_touchedTiles)
+        {
+            Tile& tile = m_tiles[index];
+
+            Command const& first = m_commands[tile.Commands.front()];
+            bool const repaintsAll = (first.Kind == CommandKind::Clear) && Contains(first.Clip, tile.Bounds);
+
+            uint64_t signature = 0;
+            for (uint32_t command : tile.Commands)
+            {
+                signature = Mix(signature, m_commands[command].Hash);
+            }
+
+            if (repaintsAll && tile.HasSignature && (tile.Signature == signature))
+            {
+                continue;
+            }
+
+            tile.Signature = signature;
+            tile.HasSignature = repaintsAll;
+            m_dirtyTiles.push_back(index);
+        }
+
+        // Touched tiles in binning order are mostly row by row, keep
+        // neighbours together for the pool's contiguous split
+        std::sort(m_dirtyTiles.begin(), m_dirtyTiles.end());
+        m_pool.Run(m_dirtyTiles.size(), [this](size_t item, size_t)
+        {
+            RasterizeTile(m_tiles[m_dirtyTiles[item]]);
+        });
+
+        m_tilesRasterized = m_dirtyTiles.size();
+        m_tilesSkipped = m_touchedTiles.size() - m_dirtyTiles.size();
+    }
+
+    void TiledRenderBackend::RasterizeTile(Tile const& tile) noexcept
+    {
+        for (uint32_t index : tile.Commands)
+        {
+            Command const& command = m_commands[index];
+            PixelRect const clip = Intersection(command.Clip, tile.Bounds);
+            switch (command.Kind)
+            {
+            case CommandKind::Clear:
+                m_target.Clear(command.Value, clip);
+                break;
+            case CommandKind::Rectangle:
+                m_target.FillRectangle(command.Area, command.Value, clip);
+                break;
+            case CommandKind::Strip:
+                m_target.FillTriangleStrip(m_vertices.data() + command.FirstVertex, command.VertexCount, command.Value, clip);
+                break;
+            case CommandKind::Sprite:
+                m_target.DrawSprite(m_sheets[command.Sheet], { command.Area, command.Source }, clip);
+                break;
+            }
+        }
+    }
+
+    void TiledRenderBackend::PushClip(PixelRect const& rect)
+    {
+        m_clipStack.push_back(m_clipStack.empty() ? rect : Intersection(rect, m_clipStack.back()));
+    }
+
+    void TiledRenderBackend::PopClip()
+    {
+        m_clipStack.pop_back();
+    }
+}
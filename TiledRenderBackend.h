@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderBackend.h"
+#include "SoftwareRenderBackend.h"
+#include "WorkStealingPool.h"
+
+namespace PointerCore
+{
+    // CPU rendering split into tiles and spread over a WorkStealingPool.
+    //
+    // Drawing calls are recorded rather than executed. Each one is binned to
+    // the tiles its bounds touch (triangle strips in pieces of a few
+    // triangles, so a long ink stroke only lands in the tiles it crosses),
+    // and EndDraw() rasterizes the touched tiles into the target in
+    // parallel, every tile replaying its own commands in order clipped to
+    // itself. Tiles are sized so one stays in L1 while it's drawn.
+    //
+    // A tile whose commands start by clearing all of it doesn't depend on
+    // what it held before, so when its commands hash the same as last frame
+    // its pixels are already right and it's skipped. Tiles no command
+    // touches keep their pixels as well, as they would with
+    // SoftwareRenderBackend.
+    //
+    // Output is pixel-identical to drawing straight into the target.
+    class TiledRenderBackend : public RenderBackend
+    {
+    public:
+        struct Options
+        {
+            // Tile width and height in pixels; 64x64 at 32bpp is 16 KiB
+            uint32_t TileSize = 64;
+
+            // Triangles per binned piece of a strip
+            uint32_t TrianglesPerPiece = 16;
+        };
+
+        TiledRenderBackend(SoftwareRenderBackend& target, WorkStealingPool& pool);
+        TiledRenderBackend(SoftwareRenderBackend& target, WorkStealingPool& pool, Options const& options);
+
+        // Repaints every touched tile on the next frame, for when the target
+        // was drawn to some other way. Resizing the target is noticed by
+        // BeginDraw().
+        void Invalidate() noexcept;
+
+        size_t TileCount() const noexcept { return m_tiles.size(); }
+
+        // Tiles drawn, and skipped as unchanged, by the last EndDraw()
+        size_t TilesRasterized() const noexcept { return m_tilesRasterized; }
+        size_t TilesSkipped() const noexcept { return m_tilesSkipped; }
+
+        // RenderBackend
+        void BeginDraw() override;
+        void Clear(Color const& color) override;
+        void FillRectangle(Rect const& rect, Color const& color) override;
+        void FillTriangleStrip(Point const* vertices, size_t count, Color const& color) override;
+        void DrawSprites(SpriteSheet const& sheet, SpriteInstance const* sprites, size_t count) override;
+        void EndDraw() override;
+        void PushClip(PixelRect const& rect) override;
+        void PopClip() override;
+
+    private:
+        enum class CommandKind : uint8_t
+        {
+            Clear,
+            Rectangle,
+            Strip,
+            Sprite,
+        };
+
+        struct Command
+        {
+            CommandKind Kind;
+            uint32_t Value;
+            PixelRect Clip;
+            Rect Area;
+
+            // Strips, in m_vertices
+            size_t FirstVertex;
+            size_t VertexCount;
+
+            // Sprites, Area being the destination. The sheet's pixels have to
+            // stay valid until EndDraw().
+            size_t Sheet;
+            PixelRect Source;
+
+            uint64_t Hash;
+        };
+
+        struct Tile
+        {
+            PixelRect Bounds;
+            std::vector<uint32_t> Commands;
+
+            // Hash of the commands that produced the pixels, when those
+            // commands started by clearing the whole tile
+            uint64_t Signature;
+            bool HasSignature;
+        };
+
+        PixelRect CurrentClip() const noexcept;
+        void ResizeGrid();
+        void Record(Command command, PixelRect const& bounds);
+        void RasterizeTile(Tile const& tile) noexcept;
+
+        SoftwareRenderBackend& m_target;
+        WorkStealingPool& m_pool;
+        Options m_options;
+
+        uint32_t m_gridWidth{ 0 };
+        uint32_t m_gridHeight{ 0 };
+        uint32_t m_columns{ 0 };
+        std::vector<Tile> m_tiles;
+
+        std::vector<Command> m_commands;
+        std::vector<Point> m_vertices;
+        std::vector<SpriteSheet> m_sheets;
+        std::vector<PixelRect> m_clipStack;
+
+        // Tiles with commands this frame, and the ones of those to draw
+        std::vector<uint32_t> m_touchedTiles;
+        std::vector<uint32_t> m_dirtyTiles;
+
+        size_t m_tilesRasterized{ 0 };
+        size_t m_tilesSkipped{ 0 };
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace PointerCore
+{
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // Structure was padded due to alignment specifier
+#endif
+
+    // Lock-free triple buffer for handing the latest version of a value from
+    // one producer thread to one consumer thread.
+    //
+    // The producer fills the back slot and publishes it; the consumer reads
+    // the front slot and swaps in the newest published one whenever it wants.
+    // Neither side ever waits for the other, and versions the consumer didn't
+    // get to in time are simply skipped. Slots are reused, never reallocated.
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        static constexpr size_t SlotCount = 3;
+
+        TripleBuffer() = default;
+        TripleBuffer(TripleBuffer const&) = delete;
+        TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+        // Producer. The slot to fill for the next publish. It holds whatever
+        // was published into it last (or a default value), not the latest version.
+        T& Back() noexcept { return m_slots[m_back].Value; }
+        size_t BackIndex() const noexcept { return m_back; }
+
+        // Producer. Read access to a slot it has published before; the consumer
+        // only ever reads slots, so this is safe while they're shared.
+        T const& Published(size_t index) const noexcept { return m_slots[index].Value; }
+
+        // Producer. Index of the most recently published slot, or SlotCount before the first publish.
+        size_t LatestIndex() const noexcept { return m_latest; }
+
+        // Producer. Hands the back slot to the consumer and takes over another.
+        void Publish() noexcept
+        {
+            m_latest = m_back;
+            uint8_t const previous = m_middle.exchange(static_cast<uint8_t>(m_back | FreshBit), std::memory_order_acq_rel);
+            m_back = previous & IndexMask;
+        }
+
+        // Consumer. True if something was published since the last Acquire().
+        bool HasUpdate() const noexcept { return (m_middle.load(std::memory_order_relaxed) & FreshBit) != 0; }
+
+        // Consumer. Swaps in the newest published slot, if there is one, and
+        // returns the front slot. The reference stays valid until the next Acquire().
+        T const& Acquire() noexcept
+        {
+            if (HasUpdate())
+            {
+                uint8_t const previous = m_middle.exchange(static_cast<uint8_t>(m_front), std::memory_order_acq_rel);
+                m_front = previous & IndexMask;
+            }
+
+            return m_slots[m_front].Value;
+        }
+
+        // Consumer. The front slot, as returned by the last Acquire().
+        T const& Front() const noexcept { return m_slots[m_front].Value; }
+
+    private:
+        static constexpr size_t CacheLineSize = 64;
+        static constexpr uint8_t IndexMask = 0x3;
+        static constexpr uint8_t FreshBit = 0x4;
+
+        struct alignas(CacheLineSize) Slot
+        {
+            T Value = T();
+        };
+
+        Slot m_slots[SlotCount];
+
+        // Index of the slot between the two sides, plus FreshBit when it
+        // holds a publish the consumer hasn't picked up yet
+        alignas(CacheLineSize) std::atomic<uint8_t> m_middle{ 1 };
+
+        // Consumer-owned
+        alignas(CacheLineSize) size_t m_front{ 0 };
+
+        // Producer-owned
+        alignas(CacheLineSize) size_t m_back{ 2 };
+        size_t m_latest{ SlotCount };
+    };
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LEB128-style variable-length integers with zigzag mapping for signed values,
+// shared by the binary formats in the pointer core
+namespace PointerCore::Varint
+{
+    // Longest encoding of a 64-bit value
+    constexpr size_t MaxEncodedSize = 10;
+
+    inline uint64_t ZigZagEncode(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t ZigZagDecode(uint64_t value) noexcept
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline void Write(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline void WriteSigned(std::vector<uint8_t>& out, int64_t value)
+    {
+        Write(out, ZigZagEncode(value));
+    }
+
+    // Reads a value from [cursor, end), advancing cursor. Returns false if the
+    // input ends early or the encoding is longer than MaxEncodedSize.
+    inline bool Read(uint8_t const*& cursor, uint8_t const* end, uint64_t& value) noexcept
+    {
+        uint64_t result = 0;
+        for (unsigned shift = 0; shift < 7 * MaxEncodedSize; shift += 7)
+        {
+            if (cursor == end)
+            {
+                return false;
+            }
+
+            uint8_t const byte = *cursor++;
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                value = result;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    inline bool ReadSigned(uint8_t const*& cursor, uint8_t const* end, int64_t& value) noexcept
+    {
+        uint64_t encoded;
+        if (!Read(cursor, end, encoded))
+        {
+            return false;
+        }
+
+        value = ZigZagDecode(encoded);
+        return true;
+    }
+}
@@ -0,0 +1,155 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace PointerCore
+{
+    WorkStealingPool::WorkStealingPool()
+        : WorkStealingPool(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+    {
+    }
+
+    WorkStealingPool::WorkStealingPool(size_t workerCount)
+    {
+        m_queues.reserve(workerCount + 1);
+        for (size_t i = 0; i <= workerCount; ++i)
+        {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+
+        m_workers.reserve(workerCount);
+        for (size_t i = 1; i <= workerCount; ++i)
+        {
+            m_workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock{ m_lock };
+            m_running = false;
+        }
+        m_workAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void WorkStealingPool::Run(size_t count, Body body, void* context)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Nothing to share, skip the queues
+        if (m_workers.empty() || (count == 1))
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                body(context, i, 0);
+            }
+            return;
+        }
+
+        m_body = body;
+        m_context = context;
+        m_pending.store(count, std::memory_order_relaxed);
+
+        size_t const threads = m_queues.size();
+        for (size_t thread = 0; thread < threads; ++thread)
+        {
+            Queue& queue = *m_queues[thread];
+            std::lock_guard lock{ queue.Lock };
+            for (size_t i = count * thread / threads; i < count * (thread + 1) / threads; ++i)
+            {
+                queue.Items.push_back(i);
+            }
+        }
+
+        {
+            std::lock_guard lock{ m_lock };
+            ++m_generation;
+        }
+        m_workAvailable.notify_all();
+
+        Drain(0);
+
+        // Wait for the items other threads are still running
+        std::unique_lock lock{ m_lock };
+        m_loopFinished.wait(lock, [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    void WorkStealingPool::WorkerLoop(size_t thread)
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock lock{ m_lock };
+                m_workAvailable.wait(lock, [this, seen] { return !m_running || (m_generation != seen); });
+                if (!m_running)
+                {
+                    return;
+                }
+
+                seen = m_generation;
+            }
+
+            Drain(thread);
+        }
+    }
+
+    void WorkStealingPool::Drain(size_t thread)
+    {
+        size_t item;
+        while (Pop(thread, item) || Steal(thread, item))
+        {
+            m_body(m_context, item, thread);
+
+            // The last item wakes Run()
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard lock{ m_lock };
+                m_loopFinished.notify_all();
+            }
+        }
+    }
+
+    bool WorkStealingPool::Pop(size_t thread, size_t& item)
+    {
+        Queue& queue = *m_queues[thread];
+        std::lock_guard lock{ queue.Lock };
+        if (queue.Items.empty())
+        {
+            return false;
+        }
+
+        item = queue.Items.back();
+        queue.Items.pop_back();
+        return true;
+    }
+
+    bool WorkStealingPool::Steal(size_t thread, size_t& item)
+    {
+        // Victims in order after this thread, so thieves spread out
+        size_t const threads = m_queues.size();
+        for (size_t offset = 1; offset < threads; ++offset)
+        {
+            Queue& queue = *m_queues[(thread + offset) % threads];
+            std::lock_guard lock{ queue.Lock };
+            if (!queue.Items.empty())
+            {
+                item = queue.Items.front();
+                queue.Items.pop_front();
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace PointerCore
+{
+    // Fixed set of threads that run the iterations of a parallel loop.
+    //
+    // Run() splits [0, count) into one contiguous range per thread, so
+    // neighbouring items (tiles next to each other) tend to stay on one
+    // thread. A thread works through its own range from the back and, once
+    // it runs out, steals from the front of the others', which evens out
+    // items of very different cost without a shared queue every item
+    // contends on. The thread calling Run() takes part and has range 0.
+    //
+    // Run() is not reentrant: one loop runs at a time.
+    class WorkStealingPool
+    {
+    public:
+        // Signature of a loop body: fn(context, item, thread), thread being
+        // in [0, ThreadCount())
+        using Body = void (*)(void* context, size_t item, size_t thread);
+
+        // workerCount threads besides the caller, hardware threads - 1 by default
+        WorkStealingPool();
+        explicit WorkStealingPool(size_t workerCount);
+        ~WorkStealingPool();
+
+        WorkStealingPool(WorkStealingPool const&) = delete;
+        WorkStealingPool& operator=(WorkStealingPool const&) = delete;
+
+        // Workers plus the calling thread
+        size_t ThreadCount() const noexcept { return m_queues.size(); }
+
+        // Calls fn(item, thread) for every item in [0, count) and returns once
+        // all of them have finished. fn must not throw.
+        template <typename Fn>
+        void Run(size_t count, Fn&& fn)
+        {
+            auto body = [](void* context, size_t item, size_t thread) { (*static_cast<std::remove_reference_t<Fn>*>(context))(item, thread); };
+            Run(count, body, const_cast<void*>(static_cast<void const*>(&fn)));
+        }
+
+        void Run(size_t count, Body body, void* context);
+
+        // Items that were run by a thread other than the one they were given
+        // to, over the pool's lifetime
+        uint64_t Steals() const noexcept { return m_steals.load(std::memory_order_relaxed); }
+
+    private:
+        // One per thread, on its own cache line so owners don't share lines
+        struct alignas(64) Queue
+        {
+            std::mutex Lock;
+            std::deque<size_t> Items;
+        };
+
+        void WorkerLoop(size_t thread);
+
+        // Runs items until every queue is empty
+        void Drain(size_t thread);
+        bool Pop(size_t thread, size_t& item);
+        bool Steal(size_t thread, size_t& item);
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        // The loop in progress
+        Body m_body{ nullptr };
+        void* m_context{ nullptr };
+        std::atomic<size_t> m_pending{ 0 };
+        std::atomic<uint64_t> m_steals{ 0 };
+
+        std::mutex m_lock;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_loopFinished;
+        uint64_t m_generation{ 0 };
+        bool m_running{ true };
+    };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Shared helpers for the portable core's benchmarks. Every benchmark is its
+// own executable; --quick shrinks the workload so CTest can smoke-run them.
+namespace PointerCoreBench
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Arguments
+    {
+        bool Quick = false;
+    };
+
+    inline Arguments ParseArguments(int argc, char** argv) noexcept
+    {
+        Arguments arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--quick") == 0)
+            {
+                arguments.Quick = true;
+            }
+        }
+
+        return arguments;
+    }
+
+    // Keeps the compiler from optimizing away a result
+    template <typename T>
+    inline void DoNotOptimize(T const& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile char sink;
+        sink = *reinterpret_cast<char const volatile*>(&value);
+#endif
+    }
+
+    inline double SecondsSince(Clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Best of a few runs of fn(), in seconds
+    template <typename Fn>
+    double BestOf(int runs, Fn&& fn)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto const start = Clock::now();
+            fn();
+            best = std::min(best, SecondsSince(start));
+        }
+
+        return best;
+    }
+
+    // Simple deterministic generator, so runs are comparable
+    class Random
+    {
+    public:
+        explicit Random(uint64_t seed = 0x9e3779b97f4a7c15ull) noexcept
+            : m_state{ seed }
+        {
+        }
+
+        uint64_t Next() noexcept
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 7;
+            m_state ^= m_state << 17;
+            return m_state;
+        }
+
+        // Uniform in [0, 1)
+        float NextFloat() noexcept { return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f); }
+        float NextFloat(float low, float high) noexcept { return low + (high - low) * NextFloat(); }
+        uint32_t NextBelow(uint32_t bound) noexcept { return static_cast<uint32_t>(Next() % bound); }
+
+    private:
+        uint64_t m_state;
+    };
+}
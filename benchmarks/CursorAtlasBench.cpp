@@ -0,0 +1,83 @@
+// Cost of building the cursor sheet at common display scales, which only
+// happens when the DPI changes, and of a full 1080p frame drawing every
+// pointer as an anti-aliased sprite against the plain indicator squares,
+// with pointers of every device kind and state.
+
+#include "BenchHarness.h"
+#include "CursorAtlas.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const runs = arguments.Quick ? 1 : 20;
+
+    std::printf("%-24s %10s %12s\n", "build", "sheet", "time");
+    for (float scale : { 1.0f, 1.25f, 1.5f, 2.0f, 3.0f })
+    {
+        CursorAtlas atlas;
+        double best = HUGE_VAL;
+        for (int run = 0; run < runs; ++run)
+        {
+            // Alternate scales so every Build() rasterizes
+            atlas.Build(scale * 2.0f);
+            auto const start = Clock::now();
+            atlas.Build(scale);
+            best = std::min(best, SecondsSince(start));
+        }
+
+        SpriteSheet const sheet = atlas.Sheet();
+        char name[32];
+        std::snprintf(name, sizeof(name), "%.2fx", scale);
+        std::printf("%-24s %4ux%-5u %9.3f ms\n", name, sheet.Width, sheet.Height, best * 1e3);
+    }
+
+    // Rebuilding at an unchanged scale, as every frame does
+    {
+        CursorAtlas atlas;
+        atlas.Build(1.0f);
+        size_t const calls = arguments.Quick ? 100000 : 10000000;
+        auto const start = Clock::now();
+        for (size_t i = 0; i < calls; ++i)
+        {
+            DoNotOptimize(atlas.Build(1.0f));
+        }
+        std::printf("%-24s %10s %9.2f ns\n", "unchanged scale", "", SecondsSince(start) * 1e9 / static_cast<double>(calls));
+    }
+
+    std::printf("\n1080p frame %14s %12s %12s %14s\n", "pointers", "squares", "sprites", "per sprite");
+    SoftwareRenderBackend backend(1920, 1080);
+    CursorAtlas atlas(PointerScene::CursorStyle(PixelFormat::Bgra8));
+    atlas.Build(1.0f);
+    IndicatorBatch batch;
+    std::vector<SpriteInstance> sprites;
+    DamageRegion const full{ {}, true };
+    Random random;
+    for (size_t count : { 16, 256 })
+    {
+        PointerTable pointers(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            pointers.Insert(static_cast<uint32_t>(i), static_cast<PointerDeviceKind>(i % 3), (i % 2) != 0,
+                { random.NextFloat(0.0f, 1920.0f), random.NextFloat(0.0f, 1080.0f) });
+        }
+
+        // Once each first, so a single quick run isn't timing a cold frame
+        PointerScene::DrawBatched(backend, pointers, full, batch);
+        PointerScene::DrawCursors(backend, pointers, full, atlas, sprites);
+        double const squares = BestOf(runs, [&] { PointerScene::DrawBatched(backend, pointers, full, batch); });
+        double const cursors = BestOf(runs, [&] { PointerScene::DrawCursors(backend, pointers, full, atlas, sprites); });
+        std::printf("%26zu %9.3f ms %9.3f ms %11.2f us\n", count, squares * 1e3, cursors * 1e3, (cursors - squares) / static_cast<double>(count) * 1e6);
+    }
+    DoNotOptimize(backend.PixelAt(0, 0));
+
+    return 0;
+}
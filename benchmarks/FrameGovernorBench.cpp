@@ -0,0 +1,94 @@
+// Ten simulated minutes at 60 Hz for each of a few synthetic cost curves:
+// how many frames miss their budget with the governor and with full effects
+// throughout, how often the governor changes settings, and how much of the
+// time it keeps full effects. A frame's cost scales with its effects level
+// and drops a little when the CPU and GPU overlap. Then the cost of OnFrame.
+
+#include "BenchHarness.h"
+#include "FrameGovernor.h"
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    using Duration = FrameGovernor::Duration;
+
+    Duration Cost(FrameGovernor::Settings const& settings, double fullCostMs)
+    {
+        double const effects[] = { 0.5, 0.7, 1.0 };
+        double const overlap = (settings.MaxFrameLatency > 1) ? 0.85 : 1.0;
+        double const ms = fullCostMs * effects[static_cast<uint32_t>(settings.Effects)] * overlap;
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const frames = arguments.Quick ? 60 * 60 : 60 * 60 * 10;
+
+    struct Curve
+    {
+        char const* Name;
+        std::function<double(int, Random&)> FullCostMs;
+    };
+    Curve const curves[] = {
+        { "light", [](int, Random& random) { return 9.0 + random.NextFloat(); } },
+        { "hitches", [](int frame, Random& random) { return ((frame % 97) == 0) ? 45.0 : 9.0 + random.NextFloat(); } },
+        { "heavy", [](int, Random& random) { return 30.0 + 4.0 * random.NextFloat(); } },
+        { "slow ramp", [frames](int frame, Random& random) { return 6.0 + 40.0 * frame / frames + random.NextFloat(); } },
+        { "bursts", [](int frame, Random& random) { return (((frame / 600) % 3) == 2) ? 28.0 + 4.0 * random.NextFloat() : 9.0 + random.NextFloat(); } },
+        { "near the line", [](int, Random& random) { return 16.0 + 2.0 * random.NextFloat(); } } };
+
+    std::printf("%d frames\n%-14s %12s %12s %9s %10s %12s\n", frames, "curve", "over (gov)", "over (full)", "changes", "full fx", "lowest rung");
+    for (auto const& curve : curves)
+    {
+        FrameGovernor governor;
+        Random random;
+        int over = 0;
+        int fixedOver = 0;
+        int full = 0;
+        size_t lowest = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            double const fullCost = curve.FullCostMs(frame, random);
+            Duration const cost = Cost(governor.CurrentSettings(), fullCost);
+            over += (cost > governor.Budget(governor.Rung())) ? 1 : 0;
+            fixedOver += (Cost(governor.RungSettings(0), fullCost) > governor.Budget(0)) ? 1 : 0;
+            full += (governor.CurrentSettings().Effects == FrameGovernor::EffectsLevel::Full) ? 1 : 0;
+            governor.OnFrame(cost);
+            lowest = std::max(lowest, governor.Rung());
+        }
+
+        std::printf("%-14s %11.2f%% %11.2f%% %9llu %9.1f%% %12zu\n", curve.Name, 100.0 * over / frames, 100.0 * fixedOver / frames,
+            static_cast<unsigned long long>(governor.Changes()), 100.0 * full / frames, lowest);
+    }
+
+    // Per-frame overhead, with costs that keep it stepping up and down
+    {
+        FrameGovernor governor;
+        std::vector<Duration> costs;
+        Random random;
+        for (int i = 0; i < 4096; ++i)
+        {
+            costs.push_back(std::chrono::microseconds(5000 + random.NextBelow(20000)));
+        }
+
+        size_t const calls = arguments.Quick ? 100000 : 10000000;
+        double const seconds = BestOf(arguments.Quick ? 1 : 5, [&]
+        {
+            for (size_t i = 0; i < calls; ++i)
+            {
+                DoNotOptimize(governor.OnFrame(costs[i & 4095]));
+            }
+        });
+        std::printf("\nOnFrame: %.2f ns\n", seconds * 1e9 / static_cast<double>(calls));
+    }
+
+    return 0;
+}
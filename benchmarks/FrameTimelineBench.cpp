@@ -0,0 +1,124 @@
+// Overhead of tracing: nanoseconds per span with the timeline disabled and
+// enabled, for a scoped TimelineSpan (which reads the clock twice when
+// enabled) and for Record() with times already taken, from one thread and
+// from up to four threads at once. Then the cost of collecting and
+// exporting full rings as a Chrome trace.
+
+#include "BenchHarness.h"
+#include "FrameTimeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // Seconds per span, averaged over threadCount threads each recording
+    // spans spans at the same time
+    template <typename Fn>
+    double PerSpan(size_t threadCount, size_t spans, Fn const& record)
+    {
+        std::vector<double> seconds(threadCount);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                auto const start = Clock::now();
+                for (size_t i = 0; i < spans; ++i)
+                {
+                    record(i);
+                }
+                seconds[t] = SecondsSince(start);
+            });
+        }
+
+        double total = 0.0;
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            threads[t].join();
+            total += seconds[t];
+        }
+        return total / static_cast<double>(threadCount * spans);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const spans = arguments.Quick ? 100000 : 10000000;
+    int const runs = arguments.Quick ? 1 : 5;
+
+    // Threads sharing a core see each other's time slices in their own
+    unsigned const contended = std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+    std::printf("%u hardware threads\n%8s %10s %16s %16s %16s\n", std::thread::hardware_concurrency(), "threads", "timeline", "TimelineSpan", "Record", "two clock reads");
+    for (size_t threads : { size_t{ 1 }, size_t{ contended } })
+    {
+        for (bool enabled : { false, true })
+        {
+            FrameTimeline timeline;
+            timeline.SetEnabled(enabled);
+
+            double span = HUGE_VAL;
+            double record = HUGE_VAL;
+            double clock = HUGE_VAL;
+            for (int run = 0; run < runs; ++run)
+            {
+                span = std::min(span, PerSpan(threads, spans, [&](size_t) { TimelineSpan scoped{ timeline, "Span" }; }));
+                record = std::min(record, PerSpan(threads, spans, [&](size_t i) { timeline.Record("Record", i, i + 1); }));
+                clock = std::min(clock, PerSpan(threads, spans, [](size_t)
+                {
+                    DoNotOptimize(FrameTimeline::Now());
+                    DoNotOptimize(FrameTimeline::Now());
+                }));
+            }
+
+            std::printf("%8zu %10s %13.2f ns %13.2f ns %13.2f ns\n", threads, enabled ? "enabled" : "disabled", span * 1e9, record * 1e9, clock * 1e9);
+        }
+    }
+
+    // Four full rings of the default capacity
+    {
+        FrameTimeline timeline;
+        timeline.SetEnabled(true);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (size_t i = 0; i < FrameTimeline::DefaultRingCapacity; ++i)
+                {
+                    timeline.Record("Phase", i * 1000, i * 1000 + 500);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<TimelineEvent> events;
+        double const collect = BestOf(runs, [&]
+        {
+            events.clear();
+            timeline.Collect(events);
+            DoNotOptimize(events.data());
+        });
+
+        size_t bytes = 0;
+        double const write = BestOf(runs, [&]
+        {
+            std::ostringstream out;
+            timeline.WriteChromeTrace(out);
+            bytes = out.str().size();
+        });
+        std::printf("\n%zu spans: collect %.2f ms, Chrome trace %.2f ms (%zu KB)\n", events.size(), collect * 1e3, write * 1e3, bytes / 1024);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Cost per pointer event of the gesture recognizer as the number of
+// contacts grows, against a recognizer that refits the transform from every
+// contact's anchor and position on each move, as one that recomputes
+// centroids and spreads from scratch would. Contacts pan and pinch, with a
+// frame flushed every 16 events and a contact lifting and landing again
+// every 64.
+
+#include "BenchHarness.h"
+#include "GestureRecognizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr size_t EventsPerFrame = 16;
+    constexpr size_t EventsPerLift = 64;
+
+    // Refits the similarity from all contacts on every event
+    class ScratchRecognizer
+    {
+    public:
+        explicit ScratchRecognizer(size_t capacity) : m_anchors(capacity), m_positions(capacity), m_down(capacity, false) {}
+
+        void Process(PointerEvent const& event)
+        {
+            if (event.Kind == PointerEventKind::Pressed)
+            {
+                Rebase();
+                m_down[event.Id] = true;
+                m_anchors[event.Id] = m_positions[event.Id] = { event.X, event.Y };
+            }
+            else if (event.Kind == PointerEventKind::Released)
+            {
+                Rebase();
+                m_down[event.Id] = false;
+            }
+            else
+            {
+                m_positions[event.Id] = { event.X, event.Y };
+            }
+
+            m_fit = Fit();
+        }
+
+        float Flush()
+        {
+            Rebase();
+            return m_fit;
+        }
+
+    private:
+        float Fit() const
+        {
+            double count = 0.0;
+            double px = 0.0, py = 0.0, qx = 0.0, qy = 0.0;
+            for (size_t i = 0; i < m_down.size(); ++i)
+            {
+                if (m_down[i])
+                {
+                    count += 1.0;
+                    px += m_anchors[i].X;
+                    py += m_anchors[i].Y;
+                    qx += m_positions[i].X;
+                    qy += m_positions[i].Y;
+                }
+            }
+            if (count == 0.0)
+            {
+                return 1.0f;
+            }
+            px /= count;
+            py /= count;
+            qx /= count;
+            qy /= count;
+
+            double dot = 0.0, cross = 0.0, spread = 0.0;
+            for (size_t i = 0; i < m_down.size(); ++i)
+            {
+                if (m_down[i])
+                {
+                    double const ax = m_anchors[i].X - px;
+                    double const ay = m_anchors[i].Y - py;
+                    double const bx = m_positions[i].X - qx;
+                    double const by = m_positions[i].Y - qy;
+                    dot += ax * bx + ay * by;
+                    cross += ax * by - ay * bx;
+                    spread += ax * ax + ay * ay;
+                }
+            }
+            return (spread > 0.0) ? static_cast<float>(std::sqrt(dot * dot + cross * cross) / spread) : 1.0f;
+        }
+
+        void Rebase()
+        {
+            m_anchors = m_positions;
+        }
+
+        std::vector<Point> m_anchors;
+        std::vector<Point> m_positions;
+        std::vector<bool> m_down;
+        float m_fit{ 1.0f };
+    };
+
+    // Contacts spread on a circle that breathes and drifts, one event per call
+    std::vector<PointerEvent> Script(size_t contacts, size_t events)
+    {
+        Random random;
+        std::vector<PointerEvent> script;
+        for (uint32_t i = 0; i < contacts; ++i)
+        {
+            float const angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(contacts);
+            script.push_back({ 0, 0, i, 960.0f + 200.0f * std::cos(angle), 540.0f + 200.0f * std::sin(angle), 0.5f, PointerEventKind::Pressed, PointerDeviceKind::Touch, true });
+        }
+
+        for (size_t e = 0; e < events; ++e)
+        {
+            auto const id = static_cast<uint32_t>(random.NextBelow(static_cast<uint32_t>(contacts)));
+            float const t = static_cast<float>(e) / static_cast<float>(events);
+            float const angle = 6.2831853f * static_cast<float>(id) / static_cast<float>(contacts);
+            float const radius = 200.0f + 100.0f * std::sin(t * 20.0f) + random.NextFloat(-1.0f, 1.0f);
+            float const x = 960.0f + 300.0f * t + radius * std::cos(angle);
+            float const y = 540.0f + radius * std::sin(angle);
+            PointerEventKind kind = PointerEventKind::Moved;
+            if ((e % EventsPerLift) == EventsPerLift - 2)
+            {
+                kind = PointerEventKind::Released;
+            }
+            else if ((e % EventsPerLift) == EventsPerLift - 1)
+            {
+                kind = PointerEventKind::Pressed;
+            }
+            bool const inContact = kind != PointerEventKind::Released;
+            script.push_back({ e, 0, (kind == PointerEventKind::Moved) ? id : static_cast<uint32_t>(contacts - 1), x, y, 0.5f, kind, PointerDeviceKind::Touch, inContact });
+        }
+        return script;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const events = arguments.Quick ? 20000 : 1000000;
+
+    std::printf("%10s %16s %16s\n", "contacts", "incremental", "from scratch");
+    for (size_t contacts : { 2, 10, 100, 1000 })
+    {
+        auto const script = Script(contacts, events);
+
+        GestureFrame frame;
+        double const incremental = BestOf(arguments.Quick ? 1 : 5, [&]
+        {
+            GestureRecognizer recognizer;
+            for (size_t i = 0; i < script.size(); ++i)
+            {
+                recognizer.Process(script[i]);
+                if ((i % EventsPerFrame) == 0)
+                {
+                    recognizer.Flush(frame);
+                    DoNotOptimize(frame.Scale);
+                }
+            }
+        });
+
+        // The baseline gets fewer events at high counts, or it takes minutes
+        size_t const scratchEvents = std::min(script.size(), contacts + events * 10 / contacts);
+        double const scratch = BestOf(arguments.Quick ? 1 : 3, [&]
+        {
+            ScratchRecognizer recognizer(contacts);
+            for (size_t i = 0; i < scratchEvents; ++i)
+            {
+                recognizer.Process(script[i]);
+                if ((i % EventsPerFrame) == 0)
+                {
+                    DoNotOptimize(recognizer.Flush());
+                }
+            }
+        });
+
+        std::printf("%10zu %13.1f ns %13.1f ns\n", contacts, incremental * 1e9 / static_cast<double>(script.size()),
+            scratch * 1e9 / static_cast<double>(scratchEvents));
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Per-frame indicator cost from 10 to 100k pointers: building the instance
+// buffer (the compiled-in IndicatorBatch path against the scalar loop it
+// replaces, for the whole table and for one damage rectangle), submitting
+// the indicators to a backend one FillRectangle() call per pointer against one
+// FillRectangles() call, and a batched partial redraw of eight damage
+// rectangles. The backend only counts what it's given, so the draw columns
+// are the per-draw overhead alone.
+
+#include "BenchHarness.h"
+#include "IndicatorBatch.h"
+#include "PointerScene.h"
+
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // Accepts drawing calls and does nothing but tally them
+    class CountingBackend : public RenderBackend
+    {
+    public:
+        size_t Calls{ 0 };
+        double Checksum{ 0.0 };
+
+        void BeginDraw() override {}
+        void Clear(Color const&) override { ++Calls; }
+        void FillRectangle(Rect const& rect, Color const& color) override
+        {
+            ++Calls;
+            Checksum += rect.Left + color.R;
+        }
+        void FillRectangles(Rect const* rects, Color const* colors, size_t count) override
+        {
+            ++Calls;
+            Checksum += (count > 0) ? rects[count - 1].Left + colors[count - 1].R : 0.0f;
+        }
+        void FillTriangleStrip(Point const*, size_t, Color const&) override { ++Calls; }
+        void DrawSprites(SpriteSheet const&, SpriteInstance const*, size_t) override { ++Calls; }
+        void EndDraw() override {}
+        void PushClip(PixelRect const&) override {}
+        void PopClip() override {}
+    };
+
+    // The per-pointer loop batching replaced, writing into the same columns
+    size_t BuildScalar(PointerTable const& pointers, IndicatorStyle const& style, std::vector<Rect>& rects, std::vector<Color>& colors)
+    {
+        float const* xs = pointers.X();
+        float const* ys = pointers.Y();
+        float const half = style.HalfSize;
+        for (size_t i = 0; i < pointers.Size(); ++i)
+        {
+            rects[i] = { xs[i] - half, ys[i] - half, xs[i] + half, ys[i] + half };
+            colors[i] = pointers.IsPressed(i) ? style.PressedColor : style.HoverColor;
+        }
+
+        return pointers.Size();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const runs = arguments.Quick ? 1 : 20;
+    size_t const maxCount = arguments.Quick ? 10000 : 100000;
+
+    std::printf("build path: %s\n", IndicatorBatch::BuildPathName());
+    std::printf("%9s %14s %14s %14s %16s %16s %16s\n", "pointers", "scalar build", "batch build", "clipped build", "per-pointer draw", "batched draw", "partial draw");
+
+    Random random;
+    for (size_t count = 10; count <= maxCount; count *= 10)
+    {
+        PointerTable table(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            table.Insert(static_cast<uint32_t>(i + 1), PointerDeviceKind::Touch, random.NextBelow(4) == 0,
+                { random.NextFloat(0.0f, 3840.0f), random.NextFloat(0.0f, 2160.0f) });
+        }
+
+        // Enough repetitions that small counts are measurable
+        size_t const repeat = std::max<size_t>(1, 1000000 / count);
+        double const frames = static_cast<double>(repeat);
+
+        std::vector<Rect> rects(count);
+        std::vector<Color> colors(count);
+        double const scalarSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                DoNotOptimize(BuildScalar(table, PointerScene::Style, rects, colors));
+                DoNotOptimize(rects[count - 1]);
+            }
+        });
+
+        IndicatorBatch batch;
+        double const batchSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                batch.Build(table, PointerScene::Style);
+                DoNotOptimize(batch.Rects()[batch.Size() - 1]);
+            }
+        });
+
+        // A 256x256 damage rectangle in the middle of a 4K target
+        Rect const clip{ 1792.0f, 952.0f, 2048.0f, 1208.0f };
+        double const clippedSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                batch.Build(table, PointerScene::Style, clip);
+                DoNotOptimize(batch.Size());
+            }
+        });
+
+        CountingBackend backend;
+        DamageRegion const full{ {}, true };
+        double const drawSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                PointerScene::Draw(backend, table);
+            }
+        });
+        double const batchedDrawSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                PointerScene::DrawBatched(backend, table, full, batch);
+            }
+        });
+
+        // DamageTracker's limit of eight 256x256 rectangles, spread over the target
+        DamageRegion partial;
+        for (int32_t i = 0; i < 8; ++i)
+        {
+            int32_t const left = 128 + (i % 4) * 960;
+            int32_t const top = 256 + (i / 4) * 1280;
+            partial.Rects.push_back({ left, top, left + 256, top + 256 });
+        }
+        double const partialDrawSeconds = BestOf(runs, [&]
+        {
+            for (size_t r = 0; r < repeat; ++r)
+            {
+                PointerScene::DrawBatched(backend, table, partial, batch);
+            }
+        });
+        DoNotOptimize(backend.Checksum);
+
+        std::printf("%9zu %11.2f us %11.2f us %11.2f us %13.2f us %13.2f us %13.2f us\n", count,
+            scalarSeconds * 1e6 / frames, batchSeconds * 1e6 / frames, clippedSeconds * 1e6 / frames,
+            drawSeconds * 1e6 / frames, batchedDrawSeconds * 1e6 / frames, partialDrawSeconds * 1e6 / frames);
+    }
+
+    return 0;
+}
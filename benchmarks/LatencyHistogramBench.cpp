@@ -0,0 +1,111 @@
+// Cost of recording into FrameInstrumentation: disabled (what every frame
+// pays while MeasureLatency is off), enabled from one thread, and enabled
+// from several threads at once, as the input and render threads do. Also
+// times a percentile query and the JSON export.
+
+#include "BenchHarness.h"
+#include "FrameInstrumentation.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // Latency-like values: mostly a few milliseconds, with a long tail
+    std::vector<uint64_t> MakeValues(size_t count)
+    {
+        Random random;
+        std::vector<uint64_t> values(count);
+        for (auto& value : values)
+        {
+            uint64_t const base = 2000000 + random.NextBelow(6000000);
+            value = (random.NextBelow(100) == 0) ? base * (1 + random.NextBelow(20)) : base;
+        }
+
+        return values;
+    }
+
+    double RecordNanoseconds(FrameInstrumentation& instrumentation, std::vector<uint64_t> const& values, int runs)
+    {
+        double const seconds = BestOf(runs, [&]
+        {
+            for (uint64_t value : values)
+            {
+                instrumentation.Record(FrameInstrumentation::Metric::InputToPresent, value);
+            }
+        });
+
+        return seconds * 1e9 / static_cast<double>(values.size());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const count = arguments.Quick ? 100000 : 10000000;
+    int const runs = arguments.Quick ? 1 : 5;
+    auto const values = MakeValues(count);
+
+    FrameInstrumentation instrumentation;
+    std::printf("record, disabled:      %6.2f ns/value\n", RecordNanoseconds(instrumentation, values, runs));
+
+    instrumentation.SetEnabled(true);
+    std::printf("record, enabled:       %6.2f ns/value\n", RecordNanoseconds(instrumentation, values, runs));
+
+    std::printf("timestamp (Now):       %6.2f ns\n", BestOf(runs, [&]
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count / 10; ++i)
+        {
+            sum += FrameInstrumentation::Now();
+        }
+        DoNotOptimize(sum);
+    }) * 1e9 / static_cast<double>(count / 10));
+
+    // Every thread records into the same histogram
+    unsigned const threads = std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+    double const contendedSeconds = BestOf(runs, [&]
+    {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&]
+            {
+                for (uint64_t value : values)
+                {
+                    instrumentation.Record(FrameInstrumentation::Metric::Render, value);
+                }
+            });
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    });
+    std::printf("record, %u threads:     %6.2f ns/value per thread\n", threads, contendedSeconds * 1e9 / static_cast<double>(count));
+
+    auto const& histogram = instrumentation.Histogram(FrameInstrumentation::Metric::InputToPresent);
+    std::printf("p50/p99/p99.9 query:   %6.2f us (p50 %.2f ms, p99 %.2f ms, p99.9 %.2f ms)\n",
+        BestOf(runs, [&]
+        {
+            DoNotOptimize(histogram.ValueAtPercentile(50.0) + histogram.ValueAtPercentile(99.0) + histogram.ValueAtPercentile(99.9));
+        }) * 1e6,
+        static_cast<double>(histogram.ValueAtPercentile(50.0)) * 1e-6,
+        static_cast<double>(histogram.ValueAtPercentile(99.0)) * 1e-6,
+        static_cast<double>(histogram.ValueAtPercentile(99.9)) * 1e-6);
+
+    size_t jsonSize = 0;
+    double const jsonSeconds = BestOf(runs, [&]
+    {
+        std::ostringstream out;
+        instrumentation.WriteJson(out);
+        jsonSize = out.str().size();
+    });
+    std::printf("JSON export:           %6.2f us, %zu bytes\n", jsonSeconds * 1e6, jsonSize);
+    return 0;
+}
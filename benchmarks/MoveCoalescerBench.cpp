@@ -0,0 +1,123 @@
+// Synthetic 1 kHz pen traces through MoveCoalescer, against applying every
+// move to the pointer table as it arrives. Frames are presented at 60 Hz, so
+// each pointer sends about 17 moves per frame.
+
+#include "BenchHarness.h"
+#include "MoveCoalescer.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr uint64_t SampleInterval = 1000;      // 1 kHz, in microseconds
+    constexpr uint64_t FrameInterval = 16667;      // 60 Hz
+
+    struct Move
+    {
+        uint32_t Id;
+        PointerSample Sample;
+    };
+
+    // Every pointer circles at its own speed, samples interleaved in time order
+    std::vector<Move> MakeTrace(size_t pointers, uint64_t duration)
+    {
+        std::vector<Move> moves;
+        moves.reserve(pointers * (duration / SampleInterval));
+        for (uint64_t time = 0; time < duration; time += SampleInterval)
+        {
+            for (size_t i = 0; i < pointers; ++i)
+            {
+                float const angle = static_cast<float>(time) * 1e-6f * (1.0f + 0.1f * static_cast<float>(i));
+                float const x = 960.0f + 300.0f * std::cos(angle) + static_cast<float>(i);
+                float const y = 540.0f + 300.0f * std::sin(angle);
+                moves.push_back({ static_cast<uint32_t>(i + 1), { x, y, time, 0.5f + 0.5f * std::sin(angle * 3.0f) } });
+            }
+        }
+        return moves;
+    }
+
+    PointerTable MakeTable(size_t pointers)
+    {
+        PointerTable table;
+        for (size_t i = 0; i < pointers; ++i)
+        {
+            table.Insert(static_cast<uint32_t>(i + 1), PointerDeviceKind::Pen, true, { 0.0f, 0.0f });
+        }
+        return table;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    uint64_t const duration = arguments.Quick ? 2000000 : 60000000;
+
+    std::printf("%8s %10s | %12s %12s | %14s %14s\n", "pointers", "moves", "coalesced ns", "direct ns", "updates/frame", "moves/frame");
+    for (size_t pointers : { 1, 10, 64, 256 })
+    {
+        auto const moves = MakeTrace(pointers, duration);
+
+        // Coalesced: every move is queued, the table is written once per frame
+        MoveCoalescer coalescer;
+        PointerTable coalescedTable = MakeTable(pointers);
+        uint64_t frames = 0;
+        uint64_t updates = 0;
+        double const coalescedSeconds = BestOf(3, [&]
+        {
+            frames = 0;
+            updates = 0;
+            uint64_t nextFrame = FrameInterval;
+            for (auto const& move : moves)
+            {
+                if (move.Sample.Timestamp >= nextFrame)
+                {
+                    updates += coalescer.Flush(coalescedTable);
+                    ++frames;
+                    nextFrame += FrameInterval;
+                }
+                coalescer.AddMove(move.Id, move.Sample);
+            }
+            updates += coalescer.Flush(coalescedTable);
+            ++frames;
+        });
+
+        // Direct: every move writes the table
+        PointerTable directTable = MakeTable(pointers);
+        double const directSeconds = BestOf(3, [&]
+        {
+            for (auto const& move : moves)
+            {
+                size_t const index = directTable.Find(move.Id);
+                directTable.SetPosition(index, { move.Sample.X, move.Sample.Y });
+                directTable.SetPressure(index, move.Sample.Pressure);
+                directTable.SetTimestamp(index, move.Sample.Timestamp);
+            }
+        });
+        DoNotOptimize(directTable);
+
+        // Both end in the same state
+        for (size_t i = 0; i < pointers; ++i)
+        {
+            if (coalescedTable.Position(i).X != directTable.Position(i).X)
+            {
+                std::printf("mismatch for pointer %zu\n", i);
+                return 1;
+            }
+        }
+
+        double const count = static_cast<double>(moves.size());
+        std::printf("%8zu %10zu | %12.2f %12.2f | %14.1f %14.1f\n",
+            pointers,
+            moves.size(),
+            coalescedSeconds * 1e9 / count,
+            directSeconds * 1e9 / count,
+            static_cast<double>(updates) / static_cast<double>(frames),
+            count / static_cast<double>(frames));
+    }
+
+    return 0;
+}
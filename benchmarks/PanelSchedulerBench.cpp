@@ -0,0 +1,297 @@
+// Simulated dashboards sharing a render service: a dozen panels of mixed
+// priority, capped at 60 Hz or rendering on demand after input bursts, with
+// randomized frame costs, on one or two workers in virtual time. Reports how
+// long each priority waits between a frame falling due and it starting, and
+// the frame rates panels get, with and without aging. Then the cost of a
+// scheduling decision as the panel count grows.
+
+#include "BenchHarness.h"
+#include "PanelScheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+using namespace std::chrono_literals;
+
+namespace
+{
+    using TimePoint = PanelScheduler::TimePoint;
+    using Duration = PanelScheduler::Duration;
+    using FrameAction = PanelScheduler::FrameAction;
+
+    constexpr TimePoint Never = TimePoint::max();
+
+    struct PanelSetup
+    {
+        int32_t Priority;
+        bool OnDemand;
+        Duration MinCost;
+        Duration MaxCost;
+    };
+
+    struct SimPanel
+    {
+        PanelSetup Setup;
+        RenderScheduler Scheduler;
+        PanelScheduler::PanelId Id;
+        TimePoint Due{ Never };
+        TimePoint NextInput{ Never };
+        TimePoint BurstEnd{};
+        std::vector<double> Waits;
+    };
+
+    struct Worker
+    {
+        TimePoint FreeAt{};
+        size_t Panel{ SIZE_MAX };
+        TimePoint FrameStart{};
+    };
+
+    struct Result
+    {
+        std::vector<double> Waits[2];
+        double Frames[2]{};
+        size_t Panels[2]{};
+    };
+
+    double Percentile(std::vector<double>& values, double p)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+    }
+
+    // Runs the panels for the given virtual time, the way RenderService's
+    // workers drive the schedulers. Results are grouped into the panels with
+    // the highest priority and the rest.
+    Result Simulate(std::vector<PanelSetup> const& setups, size_t workerCount, uint32_t agingFrames, Duration duration)
+    {
+        Random random;
+        PanelScheduler scheduler({ agingFrames });
+        std::vector<SimPanel> panels;
+        for (auto const& setup : setups)
+        {
+            RenderScheduler::Options options;
+            options.RenderOnDemand = setup.OnDemand;
+            options.MaxFrameRate = 60.0;
+            panels.push_back({ setup, RenderScheduler(options), scheduler.Register(setup.Priority), Never, Never, TimePoint{}, {} });
+        }
+
+        auto const request = [&](SimPanel& panel, TimePoint at)
+        {
+            scheduler.RequestFrame(panel.Id, at);
+            panel.Due = std::min(panel.Due, at);
+        };
+
+        auto const scheduleInput = [&](SimPanel& panel, TimePoint now)
+        {
+            // Bursts of 1 kHz-ish input lasting up to a second, a second or two apart
+            if (now < panel.BurstEnd)
+            {
+                panel.NextInput = now + Duration(random.NextBelow(2000000) + 500000);
+            }
+            else
+            {
+                panel.NextInput = now + Duration(1000000000 + random.NextBelow(1000000000));
+                panel.BurstEnd = panel.NextInput + Duration(random.NextBelow(1000000000));
+            }
+        };
+
+        for (auto& panel : panels)
+        {
+            if (panel.Setup.OnDemand)
+            {
+                panel.Scheduler.OnFrameStarted();
+                scheduleInput(panel, TimePoint{});
+            }
+            else
+            {
+                request(panel, TimePoint{});
+            }
+        }
+
+        std::vector<Worker> workers(workerCount);
+        TimePoint now{};
+        TimePoint const end = TimePoint{} + duration;
+        while (now < end)
+        {
+            // Input arriving now makes its panel request a frame
+            for (auto& panel : panels)
+            {
+                if (panel.NextInput <= now)
+                {
+                    panel.Scheduler.RequestFrame();
+                    request(panel, panel.NextInput);
+                    scheduleInput(panel, panel.NextInput);
+                }
+            }
+
+            // Finish frames, and queue each panel's next frame as far as it knows
+            for (auto& worker : workers)
+            {
+                if ((worker.Panel != SIZE_MAX) && (worker.FreeAt <= now))
+                {
+                    auto& panel = panels[worker.Panel];
+                    scheduler.OnFrameFinished(panel.Id);
+                    panel.Scheduler.OnFrameRendered(worker.FrameStart);
+                    auto const next = panel.Scheduler.Next(worker.FreeAt);
+                    if (next.Action != FrameAction::Idle)
+                    {
+                        request(panel, (next.Action == FrameAction::Render) ? worker.FreeAt : next.WakeTime);
+                    }
+                    worker.Panel = SIZE_MAX;
+                }
+            }
+
+            // Idle workers take the next panel
+            TimePoint wake = end;
+            for (auto& worker : workers)
+            {
+                while (worker.Panel == SIZE_MAX)
+                {
+                    auto const decision = scheduler.Next(now);
+                    if (decision.Action == FrameAction::WaitUntil)
+                    {
+                        wake = std::min(wake, decision.WakeTime);
+                    }
+                    if (decision.Action != FrameAction::Render)
+                    {
+                        break;
+                    }
+
+                    size_t const index = static_cast<size_t>(std::find_if(panels.begin(), panels.end(), [&](SimPanel const& panel) { return panel.Id == decision.Panel; }) - panels.begin());
+                    auto& panel = panels[index];
+                    scheduler.OnFrameStarted(panel.Id);
+
+                    // Input asked for a frame the panel's own cap doesn't allow
+                    // yet; it hands back its wake time without rendering
+                    auto const own = panel.Scheduler.Next(now);
+                    if (own.Action != FrameAction::Render)
+                    {
+                        scheduler.OnFrameFinished(panel.Id);
+                        panel.Due = Never;
+                        if (own.Action == FrameAction::WaitUntil)
+                        {
+                            request(panel, own.WakeTime);
+                        }
+                        continue;
+                    }
+
+                    panel.Waits.push_back(std::chrono::duration<double, std::milli>(now - panel.Due).count());
+                    panel.Due = Never;
+                    panel.Scheduler.OnFrameStarted();
+
+                    Duration const spread = panel.Setup.MaxCost - panel.Setup.MinCost;
+                    worker.Panel = index;
+                    worker.FrameStart = now;
+                    worker.FreeAt = now + panel.Setup.MinCost + Duration(random.Next() % static_cast<uint64_t>(spread.count() + 1));
+                }
+
+                if (worker.Panel != SIZE_MAX)
+                {
+                    wake = std::min(wake, worker.FreeAt);
+                }
+            }
+
+            for (auto const& panel : panels)
+            {
+                wake = std::min(wake, panel.NextInput);
+            }
+            now = std::max(wake, now);
+        }
+
+        int32_t highest = INT32_MIN;
+        for (auto const& panel : panels)
+        {
+            highest = std::max(highest, panel.Setup.Priority);
+        }
+
+        Result result;
+        for (auto& panel : panels)
+        {
+            size_t const group = (panel.Setup.Priority == highest) ? 1 : 0;
+            result.Waits[group].insert(result.Waits[group].end(), panel.Waits.begin(), panel.Waits.end());
+            result.Frames[group] += static_cast<double>(panel.Scheduler.FramesRendered());
+            ++result.Panels[group];
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    Duration const duration = arguments.Quick ? Duration(2s) : Duration(60s);
+    double const seconds = std::chrono::duration<double>(duration).count();
+
+    auto const report = [&](char const* name, std::vector<PanelSetup> const& setups)
+    {
+        std::printf("%s, %.0f s of virtual time\n", name, seconds);
+        std::printf("%8s %6s %30s %30s %16s\n", "workers", "aging", "high priority wait p50/p99/max", "low priority wait p50/p99/max", "fps high/low");
+        for (size_t workers : { 1, 2 })
+        {
+            for (uint32_t aging : { 0u, 8u })
+            {
+                auto result = Simulate(setups, workers, aging, duration);
+                std::printf("%8zu %6u %8.2f %8.2f %8.2f ms %8.2f %8.2f %8.2f ms %7.1f / %5.1f\n", workers, aging,
+                    Percentile(result.Waits[1], 0.5), Percentile(result.Waits[1], 0.99), Percentile(result.Waits[1], 1.0),
+                    Percentile(result.Waits[0], 0.5), Percentile(result.Waits[0], 0.99), Percentile(result.Waits[0], 1.0),
+                    result.Frames[1] / seconds / static_cast<double>(result.Panels[1]), result.Frames[0] / seconds / static_cast<double>(result.Panels[0]));
+            }
+        }
+    };
+
+    // Four interactive panels at priority 10 that render on input, and eight
+    // priority 0 panels animating at 60 Hz
+    std::vector<PanelSetup> dashboard;
+    for (int i = 0; i < 4; ++i)
+    {
+        dashboard.push_back({ 10, true, 1ms, 3ms });
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        dashboard.push_back({ 0, false, 1ms, 2500us });
+    }
+    report("12 panels: 4 on demand at priority 10, 8 at 60 Hz at priority 0", dashboard);
+
+    // Twelve animating panels one priority level apart, more than one
+    // worker can keep up with, so the levels have to be told apart
+    std::vector<PanelSetup> contested;
+    for (int i = 0; i < 12; ++i)
+    {
+        contested.push_back({ (i < 6) ? 1 : 0, false, 1ms, 2200us });
+    }
+    report("\n12 panels at 60 Hz: 6 at priority 1, 6 at priority 0", contested);
+
+    // Cost of one frame's bookkeeping (decide, start, finish, request again)
+    // with every panel due
+    std::printf("\n%8s %16s\n", "panels", "per decision");
+    for (size_t count : { 1, 12, 100, 1000 })
+    {
+        PanelScheduler scheduler;
+        for (size_t i = 0; i < count; ++i)
+        {
+            scheduler.RequestFrame(scheduler.Register(static_cast<int32_t>(i % 4)));
+        }
+
+        size_t const iterations = arguments.Quick ? 1000 : 200000 / std::max<size_t>(count / 12, 1);
+        double const elapsed = BestOf(arguments.Quick ? 1 : 5, [&]
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                auto const decision = scheduler.Next(TimePoint{});
+                scheduler.OnFrameStarted(decision.Panel);
+                scheduler.OnFrameFinished(decision.Panel);
+                scheduler.RequestFrame(decision.Panel);
+            }
+        });
+        std::printf("%8zu %13.1f ns\n", count, elapsed * 1e9 / static_cast<double>(iterations));
+    }
+
+    return 0;
+}
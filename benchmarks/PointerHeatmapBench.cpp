@@ -0,0 +1,148 @@
+// A 4K kiosk panel with a 1 kHz pen: cost per 60 Hz frame of splatting that
+// frame's samples and decaying the heatmap, when the pen stays in one corner
+// and once it has covered the whole panel, with the default per-frame tile
+// budget and with none. Compared against scaling every cell of a plain grid
+// every frame. Then the cost of an export snapshot.
+
+#include "BenchHarness.h"
+#include "PointerHeatmap.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr float PanelWidth = 3840.0f;
+    constexpr float PanelHeight = 2160.0f;
+    constexpr size_t SamplesPerFrame = 17;
+    constexpr float FrameSeconds = 1.0f / 60.0f;
+
+    // A pen wandering over a rectangle of the panel
+    std::vector<HeatmapSample> Wander(float width, float height, size_t count)
+    {
+        Random random;
+        std::vector<HeatmapSample> samples;
+        float x = width * 0.5f;
+        float y = height * 0.5f;
+        float angle = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            angle += random.NextFloat(-0.2f, 0.2f);
+            x = std::fmod(x + 6.0f * std::cos(angle) + width, width);
+            y = std::fmod(y + 6.0f * std::sin(angle) + height, height);
+            samples.push_back({ x, y, (i / 500) % 2 == 0 });
+        }
+        return samples;
+    }
+
+    // Seconds per frame of splats and decay, after the warmup samples
+    double TimeFrames(PointerHeatmap& heatmap, std::vector<HeatmapSample> const& warmup, std::vector<HeatmapSample> const& measured)
+    {
+        for (size_t i = 0; i < warmup.size(); ++i)
+        {
+            heatmap.AddSample(warmup[i]);
+            if ((i % SamplesPerFrame) == SamplesPerFrame - 1)
+            {
+                heatmap.Decay(FrameSeconds);
+            }
+        }
+
+        size_t const frames = measured.size() / SamplesPerFrame;
+        auto const start = Clock::now();
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            for (size_t i = 0; i < SamplesPerFrame; ++i)
+            {
+                heatmap.AddSample(measured[frame * SamplesPerFrame + i]);
+            }
+            heatmap.Decay(FrameSeconds);
+        }
+        return SecondsSince(start) / static_cast<double>(frames);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const measuredFrames = arguments.Quick ? 60 : 3000;
+
+    PointerHeatmap::Options defaults;
+    PointerHeatmap::Options unbounded;
+    unbounded.TilesPerFrame = UINT32_MAX;
+
+    std::printf("4K panel, %zu samples per frame\n%-22s %14s %14s %14s\n", SamplesPerFrame, "pen", "active tiles", "budget 256", "no budget");
+    struct Case
+    {
+        char const* Name;
+        float Width;
+        float Height;
+        size_t Warmup;
+    };
+    Case const cases[] = {
+        { "in one corner", 400.0f, 300.0f, 60000 },
+        { "over the whole panel", PanelWidth, PanelHeight, arguments.Quick ? size_t{ 200000 } : size_t{ 2000000 } } };
+
+    uint32_t tileCount = 0;
+    for (auto const& c : cases)
+    {
+        auto const warmup = Wander(c.Width, c.Height, c.Warmup);
+        auto const measured = Wander(c.Width, c.Height, measuredFrames * SamplesPerFrame);
+
+        double seconds[2];
+        size_t active = 0;
+        PointerHeatmap::Options const* options[] = { &defaults, &unbounded };
+        for (size_t i = 0; i < 2; ++i)
+        {
+            PointerHeatmap heatmap(*options[i]);
+            heatmap.Resize(PanelWidth, PanelHeight);
+            seconds[i] = TimeFrames(heatmap, warmup, measured);
+            active = heatmap.ActiveTileCount();
+            tileCount = static_cast<uint32_t>(heatmap.TileCount());
+        }
+
+        std::printf("%-22s %8zu/%-5u %11.2f us %11.2f us\n", c.Name, active, tileCount, seconds[0] * 1e6, seconds[1] * 1e6);
+    }
+
+    // Every cell of the 960x540 grid scaled every frame
+    {
+        PointerHeatmap heatmap;
+        heatmap.Resize(PanelWidth, PanelHeight);
+        std::vector<float> grid(size_t{ heatmap.Width() } * heatmap.Height(), 1.0f);
+        float const factor = std::exp2(-FrameSeconds / defaults.HalfLife);
+        double const seconds = BestOf(arguments.Quick ? 1 : 5, [&]
+        {
+            for (size_t frame = 0; frame < 10; ++frame)
+            {
+                for (float& value : grid)
+                {
+                    value *= factor;
+                }
+                DoNotOptimize(grid[frame]);
+            }
+        }) / 10.0;
+        std::printf("%-22s %14s %11.2f us\n", "whole-grid decay", "", seconds * 1e6);
+    }
+
+    // Exporting the covered panel
+    {
+        PointerHeatmap heatmap;
+        heatmap.Resize(PanelWidth, PanelHeight);
+        for (auto const& sample : Wander(PanelWidth, PanelHeight, 200000))
+        {
+            heatmap.AddSample(sample);
+        }
+
+        HeatmapSnapshot snapshot;
+        double const seconds = BestOf(arguments.Quick ? 1 : 10, [&]
+        {
+            heatmap.Snapshot(snapshot);
+            DoNotOptimize(snapshot.MaxValue);
+        });
+        std::printf("snapshot of %u x %u cells: %.2f ms\n", snapshot.Width, snapshot.Height, seconds * 1e3);
+    }
+
+    return 0;
+}
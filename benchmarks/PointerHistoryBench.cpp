@@ -0,0 +1,143 @@
+// A kiosk session of two 1 kHz pens drawing and a steady stream of touch
+// taps: bytes per event against a raw PointerEvent, appends per second, and
+// events per second scanned by a whole-session query, by one-second time
+// ranges and by a single pointer.
+
+#include "BenchHarness.h"
+#include "PointerHistory.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // Events in append order: each millisecond both pens move, and every
+    // half second a new touch contact taps for about 80 ms
+    std::vector<PointerEvent> Session(uint64_t milliseconds)
+    {
+        Random random;
+        std::vector<PointerEvent> events;
+        events.reserve(milliseconds * 2 + milliseconds / 500 * 12);
+        float angles[2] = { 0.0f, 1.0f };
+        float positions[2][2] = { { 800.0f, 600.0f }, { 2400.0f, 1200.0f } };
+        uint32_t touchId = 100;
+        for (uint64_t ms = 0; ms < milliseconds; ++ms)
+        {
+            for (uint32_t pen = 0; pen < 2; ++pen)
+            {
+                angles[pen] += random.NextFloat(-0.05f, 0.05f);
+                positions[pen][0] = std::fmod(positions[pen][0] + 0.8f * std::cos(angles[pen]) + 3840.0f, 3840.0f);
+                positions[pen][1] = std::fmod(positions[pen][1] + 0.8f * std::sin(angles[pen]) + 2160.0f, 2160.0f);
+
+                PointerEvent event{};
+                event.Timestamp = ms * 1000 + random.NextBelow(60);
+                event.Id = pen + 1;
+                event.X = positions[pen][0];
+                event.Y = positions[pen][1];
+                event.InContact = (ms / 3000) % 4 != 3;
+                event.Pressure = event.InContact ? 0.4f + 0.2f * std::sin(static_cast<float>(ms) * 0.003f) : 0.0f;
+                event.Kind = PointerEventKind::Moved;
+                event.DeviceKind = PointerDeviceKind::Pen;
+                events.push_back(event);
+            }
+
+            if ((ms % 500) == 0)
+            {
+                float const x = random.NextFloat(0.0f, 3840.0f);
+                float const y = random.NextFloat(0.0f, 2160.0f);
+                PointerEventKind const kinds[] = { PointerEventKind::Entered, PointerEventKind::Pressed };
+                for (size_t i = 0; i < 12; ++i)
+                {
+                    PointerEvent event{};
+                    event.Timestamp = ms * 1000 + i * 8000;
+                    event.Id = touchId;
+                    event.X = x + static_cast<float>(i);
+                    event.Y = y;
+                    event.Pressure = 0.5f;
+                    event.Kind = (i < 2) ? kinds[i] : (i == 10) ? PointerEventKind::Released : (i == 11) ? PointerEventKind::Exited : PointerEventKind::Moved;
+                    event.DeviceKind = PointerDeviceKind::Touch;
+                    event.InContact = i < 11;
+                    events.push_back(event);
+                }
+                ++touchId;
+            }
+        }
+        return events;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+
+    // Ten minutes, or an hour; eight hours is eight times the hour
+    uint64_t const milliseconds = arguments.Quick ? 10 * 60 * 1000 : 60 * 60 * 1000;
+    auto const events = Session(milliseconds);
+
+    PointerHistory::Options options;
+    options.MaxBytes = 0;
+    PointerHistory history(options);
+    auto const start = Clock::now();
+    for (auto const& event : events)
+    {
+        history.Append(event);
+    }
+    double const append = SecondsSince(start);
+
+    size_t const stored = history.CompressedBytes() + history.OpenBytes();
+    std::printf("%.0f minutes, %zu events from %zu pointers in %zu blocks\n", static_cast<double>(milliseconds) / 60000.0, events.size(),
+        history.PointerCount(), history.BlockCount());
+    std::printf("%-24s %10.2f MB raw, %.2f MB stored, %.2f bytes per event (%.1fx)\n", "size", events.size() * sizeof(PointerEvent) / 1048576.0,
+        stored / 1048576.0, static_cast<double>(stored) / static_cast<double>(events.size()),
+        static_cast<double>(events.size() * sizeof(PointerEvent)) / static_cast<double>(stored));
+    std::printf("%-24s %10.2f M events/s, %.1f ns each\n", "append", events.size() / append / 1e6, append * 1e9 / static_cast<double>(events.size()));
+
+    int const runs = arguments.Quick ? 1 : 3;
+    std::printf("%-24s %14s %14s\n", "scan", "M events/s", "blocks decoded");
+
+    // Everything, through the callback without sorting
+    {
+        size_t visited = 0;
+        uint64_t const before = history.BlocksDecoded();
+        double const seconds = BestOf(runs, [&]
+        {
+            visited = history.ForEachInRange(0, UINT64_MAX, [](PointerEvent const& event) { DoNotOptimize(event.X); });
+        });
+        std::printf("%-24s %14.1f %14llu\n", "whole session", visited / seconds / 1e6, static_cast<unsigned long long>((history.BlocksDecoded() - before) / runs));
+    }
+
+    // A hundred one-second windows across the session, sorted
+    {
+        std::vector<PointerEvent> out;
+        size_t visited = 0;
+        uint64_t const before = history.BlocksDecoded();
+        double const seconds = BestOf(runs, [&]
+        {
+            visited = 0;
+            for (uint64_t i = 0; i < 100; ++i)
+            {
+                uint64_t const from = milliseconds * 1000 / 100 * i;
+                out.clear();
+                history.Query(from, from + 1000000, out);
+                visited += out.size();
+            }
+        });
+        std::printf("%-24s %14.1f %14llu\n", "100 one-second queries", visited / seconds / 1e6, static_cast<unsigned long long>((history.BlocksDecoded() - before) / runs));
+    }
+
+    // One pen over the whole session
+    {
+        size_t visited = 0;
+        uint64_t const before = history.BlocksDecoded();
+        double const seconds = BestOf(runs, [&]
+        {
+            visited = history.ForEachOfPointer(2, 0, UINT64_MAX, [](PointerEvent const& event) { DoNotOptimize(event.X); });
+        });
+        std::printf("%-24s %14.1f %14llu\n", "one pen", visited / seconds / 1e6, static_cast<unsigned long long>((history.BlocksDecoded() - before) / runs));
+    }
+
+    return 0;
+}
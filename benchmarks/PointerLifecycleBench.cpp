@@ -0,0 +1,167 @@
+// Cost of validating pointer event order with the table-driven lifecycle,
+// against the exceptions the event handlers used to throw for events out of
+// order, for 1 to 256 pointers and streams with 0 to 10% of events lost or
+// duplicated.
+
+#include "BenchHarness.h"
+#include "PointerLifecycle.h"
+
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // A valid stream of enters, moves, presses, releases and exits spread
+    // over the pointers, then damaged: each event is dropped or sent twice
+    // with the given probability (half each)
+    std::vector<PointerEvent> MakeStream(size_t pointers, size_t count, float damage, Random& random)
+    {
+        std::vector<uint8_t> states(pointers, 0);  // 0 absent, 1 hovering, 2 pressed
+        std::vector<PointerEvent> events;
+        events.reserve(count + count / 8);
+        for (uint64_t time = 0; events.size() < count; ++time)
+        {
+            uint32_t const id = random.NextBelow(static_cast<uint32_t>(pointers));
+            uint32_t const roll = random.NextBelow(100);
+            PointerEventKind kind = PointerEventKind::Moved;
+            switch (states[id])
+            {
+            case 0:
+                kind = PointerEventKind::Entered;
+                states[id] = 1;
+                break;
+            case 1:
+                kind = (roll < 2) ? PointerEventKind::Exited : (roll < 10) ? PointerEventKind::Pressed : PointerEventKind::Moved;
+                states[id] = (roll < 2) ? 0 : (roll < 10) ? 2 : 1;
+                break;
+            default:
+                kind = (roll < 8) ? PointerEventKind::Released : PointerEventKind::Moved;
+                states[id] = (roll < 8) ? 1 : 2;
+                break;
+            }
+
+            bool const inContact = (states[id] == 2);
+            PointerEvent const event{ time, 0, id, 1.0f, 2.0f, inContact ? 0.5f : 0.0f, kind, PointerDeviceKind::Touch, inContact };
+            if (random.NextFloat() < damage)
+            {
+                if (random.NextBelow(2) == 0)
+                {
+                    continue;
+                }
+                events.push_back(event);
+            }
+            events.push_back(event);
+        }
+
+        return events;
+    }
+
+    // What the event handlers did before the lifecycle: look the pointer up
+    // and throw for anything out of order, caught here so the stream goes on
+    struct ThrowingValidator
+    {
+        std::unordered_map<uint32_t, bool> Pressed;
+        uint64_t Errors{ 0 };
+
+        void Apply(PointerEvent const& event)
+        {
+            auto const found = Pressed.find(event.Id);
+            switch (event.Kind)
+            {
+            case PointerEventKind::Entered:
+                if (found != Pressed.end())
+                {
+                    throw std::logic_error("pointer already entered");
+                }
+                Pressed.emplace(event.Id, false);
+                break;
+            case PointerEventKind::Exited:
+                if (found == Pressed.end())
+                {
+                    throw std::logic_error("untracked pointer exited");
+                }
+                Pressed.erase(found);
+                break;
+            case PointerEventKind::Moved:
+                if (found == Pressed.end())
+                {
+                    throw std::logic_error("untracked pointer moved");
+                }
+                break;
+            case PointerEventKind::Pressed:
+            case PointerEventKind::Released:
+                if ((found == Pressed.end()) || (found->second == (event.Kind == PointerEventKind::Pressed)))
+                {
+                    throw std::logic_error("pointer pressed or released out of order");
+                }
+                found->second = (event.Kind == PointerEventKind::Pressed);
+                break;
+            }
+        }
+
+        void Process(PointerEvent const& event)
+        {
+            try
+            {
+                Apply(event);
+                DoNotOptimize(event);
+            }
+            catch (std::logic_error const&)
+            {
+                ++Errors;
+            }
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const count = arguments.Quick ? 20000 : 2000000;
+    int const runs = arguments.Quick ? 1 : 5;
+
+    std::printf("%9s %7s %14s %14s %12s %12s\n", "pointers", "damage", "lifecycle", "exceptions", "anomalies", "throws");
+    for (size_t pointers : { 1, 10, 256 })
+    {
+        for (float damage : { 0.0f, 0.001f, 0.01f, 0.1f })
+        {
+            Random random;
+            auto const events = MakeStream(pointers, count, damage, random);
+            double const perEvent = 1e9 / static_cast<double>(events.size());
+
+            uint64_t anomalies = 0;
+            double const lifecycleSeconds = BestOf(runs, [&]
+            {
+                PointerLifecycle lifecycle(256);
+                uint64_t delivered = 0;
+                for (auto const& event : events)
+                {
+                    delivered += lifecycle.Process(event, [&](PointerEvent const& valid) { DoNotOptimize(valid); });
+                }
+                anomalies = lifecycle.TotalAnomalies();
+                DoNotOptimize(delivered);
+            });
+
+            uint64_t errors = 0;
+            double const throwingSeconds = BestOf(runs, [&]
+            {
+                ThrowingValidator validator;
+                for (auto const& event : events)
+                {
+                    validator.Process(event);
+                }
+                errors = validator.Errors;
+            });
+
+            std::printf("%9zu %6.1f%% %11.2f ns %11.2f ns %12llu %12llu\n", pointers, damage * 100.0f,
+                lifecycleSeconds * perEvent, throwingSeconds * perEvent,
+                static_cast<unsigned long long>(anomalies), static_cast<unsigned long long>(errors));
+        }
+    }
+
+    return 0;
+}
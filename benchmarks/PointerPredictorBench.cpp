@@ -0,0 +1,296 @@
+// Replays pointer paths through PointerPredictor and scores each model and
+// horizon against where the pointer really was that far ahead: the mean and
+// 95th percentile distance from it, and overshoot, how far the prediction
+// ran ahead of it along the direction of motion. Also times AddSample plus
+// Predict per sample.
+//
+// The paths are synthetic (a line, a circle, handwriting-like scribbles and
+// stop-and-go strokes) unless a recorded pointer trace is given:
+//
+//   PointerPredictorBench [--quick] [trace.ptrc]
+
+#include "BenchHarness.h"
+#include "MappedFile.h"
+#include "PointerPredictor.h"
+#include "PointerTrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // One pointer's samples, in time order
+    struct Path
+    {
+        std::string Name;
+        std::vector<PointerSample> Samples;
+    };
+
+    template <typename Fn>
+    Path MakePath(char const* name, uint64_t duration, uint64_t interval, Random& random, Fn&& position)
+    {
+        Path path{ name, {} };
+        for (uint64_t time = 0; time < duration; time += interval)
+        {
+            Point const p = position(static_cast<double>(time) * 1e-6);
+            path.Samples.push_back({ p.X + random.NextFloat(-0.25f, 0.25f), p.Y + random.NextFloat(-0.25f, 0.25f), time + 1, 0.5f });
+        }
+
+        return path;
+    }
+
+    std::vector<Path> SyntheticPaths(uint64_t duration)
+    {
+        constexpr double Pi = 3.14159265358979323846;
+        Random random;
+        std::vector<Path> paths;
+
+        // 240 Hz pen
+        paths.push_back(MakePath("line", duration, 4167, random, [](double t)
+        {
+            // Back and forth, turning around every second
+            double const u = 1.0 - std::fabs(std::fmod(t, 2.0) - 1.0);
+            return Point{ static_cast<float>(100.0 + 800.0 * u), static_cast<float>(100.0 + 300.0 * u) };
+        }));
+        paths.push_back(MakePath("circle", duration, 4167, random, [=](double t)
+        {
+            return Point{ static_cast<float>(500.0 + 200.0 * std::cos(2.0 * Pi * t)), static_cast<float>(500.0 + 200.0 * std::sin(2.0 * Pi * t)) };
+        }));
+        paths.push_back(MakePath("scribble", duration, 4167, random, [=](double t)
+        {
+            double const x = 100.0 + 150.0 * t + 25.0 * std::sin(2.0 * Pi * 3.1 * t) + 8.0 * std::sin(2.0 * Pi * 7.3 * t);
+            double const y = 400.0 + 40.0 * std::sin(2.0 * Pi * 4.7 * t) + 10.0 * std::cos(2.0 * Pi * 9.1 * t);
+            return Point{ static_cast<float>(x), static_cast<float>(y) };
+        }));
+
+        // 120 Hz touch: flick for 250 ms, ease to a stop, rest for 250 ms
+        paths.push_back(MakePath("stop-and-go", duration, 8333, random, [=](double t)
+        {
+            double const cycle = std::floor(t / 0.5);
+            double const u = std::min((t - cycle * 0.5) / 0.25, 1.0);
+            double const eased = 1.0 - (1.0 - u) * (1.0 - u);
+            double const x = 200.0 + 300.0 * std::fmod(cycle, 2.0) + 300.0 * eased * ((std::fmod(cycle, 2.0) == 0.0) ? 1.0 : -1.0);
+            return Point{ static_cast<float>(x), 300.0f };
+        }));
+
+        return paths;
+    }
+
+    // Every pointer in the trace with enough samples to score
+    std::vector<Path> TracePaths(char const* fileName)
+    {
+        std::vector<Path> paths;
+        MappedFile file;
+        if (!file.Open(fileName))
+        {
+            std::printf("couldn't map %s\n", fileName);
+            return paths;
+        }
+
+        PointerTraceReader reader(file.Data(), file.Size());
+        if (!reader.IsValid())
+        {
+            std::printf("%s isn't a pointer trace\n", fileName);
+            return paths;
+        }
+
+        std::unordered_map<uint32_t, size_t> byId;
+        ReplayPointerTrace(reader, [&](PointerEvent const& event)
+        {
+            if ((event.Kind != PointerEventKind::Moved) && (event.Kind != PointerEventKind::Pressed) && (event.Kind != PointerEventKind::Released))
+            {
+                return;
+            }
+
+            auto const found = byId.emplace(event.Id, paths.size());
+            if (found.second)
+            {
+                paths.push_back({ "pointer " + std::to_string(event.Id), {} });
+            }
+            paths[found.first->second].Samples.push_back({ event.X, event.Y, event.Timestamp, event.Pressure });
+        });
+
+        paths.erase(std::remove_if(paths.begin(), paths.end(), [](Path const& path) { return path.Samples.size() < 16; }), paths.end());
+        return paths;
+    }
+
+    // Where the pointer was at the given time, interpolated between samples.
+    // False past the end of the path.
+    bool PositionAt(std::vector<PointerSample> const& samples, size_t& cursor, uint64_t time, Point& position)
+    {
+        while ((cursor + 1 < samples.size()) && (samples[cursor + 1].Timestamp < time))
+        {
+            ++cursor;
+        }
+
+        if (cursor + 1 >= samples.size())
+        {
+            return false;
+        }
+
+        auto const& a = samples[cursor];
+        auto const& b = samples[cursor + 1];
+        float const u = (b.Timestamp > a.Timestamp) ? static_cast<float>(time - a.Timestamp) / static_cast<float>(b.Timestamp - a.Timestamp) : 1.0f;
+        position = { a.X + (b.X - a.X) * u, a.Y + (b.Y - a.Y) * u };
+        return true;
+    }
+
+    struct Score
+    {
+        double MeanError;
+        double P95Error;
+        double MeanOvershoot;
+        double MaxOvershoot;
+    };
+
+    Score Evaluate(Path const& path, PointerPredictor::Options const& options)
+    {
+        PointerPredictor predictor(options, 1);
+        std::vector<double> errors;
+        double overshootSum = 0.0;
+        double maxOvershoot = 0.0;
+        size_t cursor = 0;
+
+        auto const& samples = path.Samples;
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            predictor.AddSample(1, samples[i]);
+
+            Point actual;
+            if (!PositionAt(samples, cursor, samples[i].Timestamp + options.HorizonMicroseconds, actual))
+            {
+                break;
+            }
+
+            // Without a prediction the display shows the latest sample
+            Point predicted{ samples[i].X, samples[i].Y };
+            predictor.Predict(1, predicted);
+
+            double const ex = predicted.X - actual.X;
+            double const ey = predicted.Y - actual.Y;
+            errors.push_back(std::sqrt(ex * ex + ey * ey));
+
+            // Overshoot: how far past the true position along the way the pointer was heading
+            double const mx = actual.X - samples[i].X;
+            double const my = actual.Y - samples[i].Y;
+            double const travel = std::sqrt(mx * mx + my * my);
+            double const ahead = (travel > 1e-3) ? (ex * mx + ey * my) / travel : std::sqrt(ex * ex + ey * ey);
+            double const overshoot = std::max(ahead, 0.0);
+            overshootSum += overshoot;
+            maxOvershoot = std::max(maxOvershoot, overshoot);
+        }
+
+        Score score{};
+        if (!errors.empty())
+        {
+            double sum = 0.0;
+            for (double error : errors)
+            {
+                sum += error;
+            }
+            score.MeanError = sum / static_cast<double>(errors.size());
+            score.MeanOvershoot = overshootSum / static_cast<double>(errors.size());
+            score.MaxOvershoot = maxOvershoot;
+            std::sort(errors.begin(), errors.end());
+            score.P95Error = errors[static_cast<size_t>(0.95 * static_cast<double>(errors.size() - 1))];
+        }
+
+        return score;
+    }
+
+    char const* ModelName(PredictionModel model)
+    {
+        switch (model)
+        {
+        case PredictionModel::ConstantVelocity: return "velocity";
+        case PredictionModel::Kalman: return "kalman";
+        default: return "none";
+        }
+    }
+
+    // Nanoseconds per AddSample + Predict, with the given number of pointers tracked
+    double TimeModel(std::vector<Path> const& paths, PredictionModel model, size_t pointers, int runs)
+    {
+        PointerPredictor::Options options;
+        options.Model = model;
+        PointerPredictor predictor(options);
+
+        size_t samples = 0;
+        double const seconds = BestOf(runs, [&]
+        {
+            predictor.Clear();
+            double checksum = 0.0;
+            samples = 0;
+            for (auto const& path : paths)
+            {
+                for (auto const& sample : path.Samples)
+                {
+                    for (uint32_t id = 1; id <= pointers; ++id)
+                    {
+                        predictor.AddSample(id, sample);
+                        Point predicted{};
+                        predictor.Predict(id, predicted);
+                        checksum += predicted.X;
+                    }
+                    samples += pointers;
+                }
+            }
+            DoNotOptimize(checksum);
+        });
+
+        return seconds * 1e9 / static_cast<double>(samples);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    char const* traceFile = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] != '-')
+        {
+            traceFile = argv[i];
+        }
+    }
+
+    auto const paths = (traceFile != nullptr) ? TracePaths(traceFile) : SyntheticPaths(arguments.Quick ? 2000000 : 30000000);
+    if (paths.empty())
+    {
+        std::printf("no paths to replay\n");
+        return 1;
+    }
+
+    std::printf("%-12s %-9s %7s %10s %10s %10s %10s\n", "path", "model", "horizon", "mean err", "p95 err", "mean over", "max over");
+    for (auto const& path : paths)
+    {
+        for (uint32_t horizon : { 8000u, 16000u, 32000u })
+        {
+            for (auto model : { PredictionModel::None, PredictionModel::ConstantVelocity, PredictionModel::Kalman })
+            {
+                PointerPredictor::Options options;
+                options.Model = model;
+                options.HorizonMicroseconds = horizon;
+                auto const score = Evaluate(path, options);
+                std::printf("%-12s %-9s %5u ms %10.2f %10.2f %10.2f %10.2f\n", path.Name.c_str(), ModelName(model), horizon / 1000,
+                    score.MeanError, score.P95Error, score.MeanOvershoot, score.MaxOvershoot);
+            }
+        }
+    }
+
+    int const runs = arguments.Quick ? 1 : 5;
+    for (size_t pointers : { 1u, 10u, 64u })
+    {
+        std::printf("cost with %3zu pointers: velocity %.1f ns/sample, kalman %.1f ns/sample\n", pointers,
+            TimeModel(paths, PredictionModel::ConstantVelocity, pointers, runs),
+            TimeModel(paths, PredictionModel::Kalman, pointers, runs));
+    }
+
+    return 0;
+}
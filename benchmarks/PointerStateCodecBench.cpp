@@ -0,0 +1,97 @@
+// Mirroring a panel's pointers to an observer at 60 Hz: frame size and
+// encode and decode cost for a few pointers and for a crowded multi-touch
+// table, with some or all of them moving each frame. Frames go through an
+// in-process queue, the observer acknowledging each one as it decodes it.
+// Compared against sending every pointer's full state each frame.
+
+#include "BenchHarness.h"
+#include "PointerStateCodec.h"
+
+#include <deque>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // ID, X, Y and pressure as 32-bit values, device kind and pressed as bytes
+    constexpr size_t RawPointerSize = 4 * 4 + 2;
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const frames = arguments.Quick ? 200 : 20000;
+
+    std::printf("%8s %8s %14s %14s %14s %14s\n", "pointers", "moving", "bytes/frame", "raw bytes", "encode", "decode");
+    for (size_t count : { 16, 256 })
+    {
+        for (uint32_t movingPercent : { 25u, 100u })
+        {
+            Random random;
+            PointerTable table(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                table.Insert(static_cast<uint32_t>(i * 3 + 1), PointerDeviceKind::Touch, true, { random.NextFloat(0.0f, 1920.0f), random.NextFloat(0.0f, 1080.0f) });
+                table.SetPressure(i, 0.5f);
+            }
+
+            // Prepare the frames first so only the codec is timed
+            std::vector<std::vector<Point>> positions(static_cast<size_t>(frames));
+            for (auto& frame : positions)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Point position = table.Position(i);
+                    if (random.NextBelow(100) < movingPercent)
+                    {
+                        position = { position.X + random.NextFloat(-4.0f, 4.0f), position.Y + random.NextFloat(-4.0f, 4.0f) };
+                        table.SetPosition(i, position);
+                    }
+                    frame.push_back(position);
+                }
+            }
+
+            size_t bytes = 0;
+            double encodeSeconds = 0.0;
+            double decodeSeconds = 0.0;
+            double const total = BestOf(arguments.Quick ? 1 : 3, [&]
+            {
+                PointerStateEncoder encoder;
+                PointerStateDecoder decoder;
+                PointerTable decoded(count);
+                std::deque<std::vector<uint8_t>> queue;
+                bytes = 0;
+                encodeSeconds = 0.0;
+                decodeSeconds = 0.0;
+                for (auto const& frame : positions)
+                {
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        table.SetPosition(i, frame[i]);
+                    }
+
+                    queue.emplace_back();
+                    auto const encodeStart = Clock::now();
+                    encoder.Encode(table, queue.back());
+                    encodeSeconds += SecondsSince(encodeStart);
+                    bytes += queue.back().size();
+
+                    auto const decodeStart = Clock::now();
+                    decoder.Decode(queue.front().data(), queue.front().size(), decoded);
+                    decodeSeconds += SecondsSince(decodeStart);
+                    queue.pop_front();
+                    encoder.Acknowledge(decoder.LastSequence());
+                }
+                DoNotOptimize(decoded.Size());
+            });
+            DoNotOptimize(total);
+
+            std::printf("%8zu %7u%% %14.1f %14zu %11.2f us %11.2f us\n", count, movingPercent, static_cast<double>(bytes) / frames,
+                count * RawPointerSize, encodeSeconds * 1e6 / frames, decodeSeconds * 1e6 / frames);
+        }
+    }
+
+    return 0;
+}
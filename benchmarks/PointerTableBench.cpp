@@ -0,0 +1,145 @@
+// PointerTable against the std::unordered_map<uint32_t, PointerData> that
+// PointerRenderer used before, for 1 to 256 simultaneous pointers: the move
+// path (find the pointer, update its position) and the render path (walk
+// every pointer once).
+
+#include "BenchHarness.h"
+#include "PointerTable.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // What the map held per pointer
+    struct PointerData
+    {
+        PointerDeviceKind m_type;
+        bool m_pressed{ false };
+        Point m_currentPosition;
+    };
+
+    struct Result
+    {
+        double MoveNanoseconds;
+        double WalkNanoseconds;
+    };
+
+    // Pointer IDs as Windows hands them out: small and increasing, with gaps
+    std::vector<uint32_t> MakeIds(size_t count)
+    {
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < count; ++i)
+        {
+            ids.push_back(static_cast<uint32_t>(2 + i * 3));
+        }
+        return ids;
+    }
+
+    // Moves arrive in no particular pointer order
+    std::vector<uint32_t> MakeMoves(std::vector<uint32_t> const& ids, size_t count, Random& random)
+    {
+        std::vector<uint32_t> moves(count);
+        for (auto& move : moves)
+        {
+            move = ids[random.NextBelow(static_cast<uint32_t>(ids.size()))];
+        }
+        return moves;
+    }
+
+    Result MeasureTable(std::vector<uint32_t> const& ids, std::vector<uint32_t> const& moves, int walks)
+    {
+        PointerTable table;
+        for (uint32_t id : ids)
+        {
+            table.Insert(id, PointerDeviceKind::Touch, (id % 2) != 0, { 0.0f, 0.0f });
+        }
+
+        float position = 0.0f;
+        double const moveSeconds = BestOf(5, [&]
+        {
+            for (uint32_t id : moves)
+            {
+                size_t const index = table.Find(id);
+                table.SetPosition(index, { position, position });
+                position += 1.0f;
+            }
+        });
+
+        double const walkSeconds = BestOf(5, [&]
+        {
+            for (int walk = 0; walk < walks; ++walk)
+            {
+                float sum = 0.0f;
+                float const* xs = table.X();
+                float const* ys = table.Y();
+                for (size_t i = 0; i < table.Size(); ++i)
+                {
+                    sum += xs[i] + ys[i] + (table.IsPressed(i) ? 1.0f : 0.0f);
+                }
+                DoNotOptimize(sum);
+            }
+        });
+
+        DoNotOptimize(table);
+        return { moveSeconds * 1e9 / static_cast<double>(moves.size()), walkSeconds * 1e9 / walks };
+    }
+
+    Result MeasureMap(std::vector<uint32_t> const& ids, std::vector<uint32_t> const& moves, int walks)
+    {
+        std::unordered_map<uint32_t, PointerData> map;
+        for (uint32_t id : ids)
+        {
+            map[id] = { PointerDeviceKind::Touch, (id % 2) != 0, { 0.0f, 0.0f } };
+        }
+
+        float position = 0.0f;
+        double const moveSeconds = BestOf(5, [&]
+        {
+            for (uint32_t id : moves)
+            {
+                map.at(id).m_currentPosition = { position, position };
+                position += 1.0f;
+            }
+        });
+
+        double const walkSeconds = BestOf(5, [&]
+        {
+            for (int walk = 0; walk < walks; ++walk)
+            {
+                float sum = 0.0f;
+                for (auto const& [id, data] : map)
+                {
+                    sum += data.m_currentPosition.X + data.m_currentPosition.Y + (data.m_pressed ? 1.0f : 0.0f);
+                }
+                DoNotOptimize(sum);
+            }
+        });
+
+        DoNotOptimize(map);
+        return { moveSeconds * 1e9 / static_cast<double>(moves.size()), walkSeconds * 1e9 / walks };
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const moveCount = arguments.Quick ? 10000 : 1000000;
+    int const walks = arguments.Quick ? 100 : 10000;
+
+    std::printf("%8s | %14s %14s | %14s %14s\n", "pointers", "table move ns", "map move ns", "table walk ns", "map walk ns");
+    Random random;
+    for (size_t count : { 1, 2, 4, 8, 16, 32, 64, 128, 256 })
+    {
+        auto const ids = MakeIds(count);
+        auto const moves = MakeMoves(ids, moveCount, random);
+        Result const table = MeasureTable(ids, moves, walks);
+        Result const map = MeasureMap(ids, moves, walks);
+        std::printf("%8zu | %14.2f %14.2f | %14.1f %14.1f\n", count, table.MoveNanoseconds, map.MoveNanoseconds, table.WalkNanoseconds, map.WalkNanoseconds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+// Replays a synthetic multi-minute trace from a memory-mapped file through
+// the same path PointerRenderer's input takes: PointerLifecycle, then
+// MoveCoalescer and PointerTable, flushed at 60 Hz of trace time. Reports
+// encoding size, decode-only and full-pipeline throughput, and how closely
+// real-time pacing follows the recorded timestamps.
+
+#include "BenchHarness.h"
+#include "MappedFile.h"
+#include "MoveCoalescer.h"
+#include "PointerLifecycle.h"
+#include "PointerTrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr uint64_t SampleInterval = 1000;      // 1 kHz pen, in microseconds
+    constexpr uint64_t FrameInterval = 16667;      // 60 Hz
+
+    // A pen drawing strokes (press, ~1 s of moves, release) while two touch
+    // points come and go, at 1 kHz. The writer must be open; returns the event count.
+    uint64_t WriteTrace(PointerTraceWriter& writer, uint64_t duration)
+    {
+        Random random;
+        auto const write = [&](uint64_t time, uint32_t id, PointerDeviceKind device, PointerEventKind kind, float x, float y, bool inContact)
+        {
+            writer.Write({ time, 0, id, x, y, inContact ? 0.5f : 0.0f, kind, device, inContact });
+        };
+
+        write(0, 1, PointerDeviceKind::Pen, PointerEventKind::Entered, 100.0f, 100.0f, false);
+        for (uint64_t time = SampleInterval; time < duration; time += SampleInterval)
+        {
+            float const angle = static_cast<float>(time) * 1e-6f;
+            float const x = 960.0f + 400.0f * std::cos(angle * 1.3f) + random.NextFloat(-0.5f, 0.5f);
+            float const y = 540.0f + 300.0f * std::sin(angle * 2.1f) + random.NextFloat(-0.5f, 0.5f);
+            uint64_t const phase = time % 1200000;
+            if (phase == 0)
+            {
+                write(time, 1, PointerDeviceKind::Pen, PointerEventKind::Pressed, x, y, true);
+            }
+            else if (phase == 1000000)
+            {
+                write(time, 1, PointerDeviceKind::Pen, PointerEventKind::Released, x, y, false);
+            }
+            else
+            {
+                write(time, 1, PointerDeviceKind::Pen, PointerEventKind::Moved, x, y, phase < 1000000);
+            }
+
+            // Touch points every few seconds, reported at 120 Hz
+            uint64_t const touchPhase = time % 5000000;
+            if ((touchPhase < 2000000) && ((time % 8000) == 0))
+            {
+                for (uint32_t id = 2; id <= 3; ++id)
+                {
+                    float const tx = 300.0f * static_cast<float>(id) + static_cast<float>(touchPhase) * 1e-4f;
+                    auto const kind = (touchPhase == 0) ? PointerEventKind::Entered : (touchPhase >= 1992000) ? PointerEventKind::Exited : PointerEventKind::Moved;
+                    write(time, id, PointerDeviceKind::Touch, kind, tx, 200.0f, kind != PointerEventKind::Exited);
+                }
+            }
+        }
+
+        uint64_t const count = writer.EventCount();
+        writer.Close();
+        return count;
+    }
+
+    // What PointerRenderer::ApplyValidPointerEvent does to the table, minus drawing
+    struct Pipeline
+    {
+        PointerLifecycle Lifecycle;
+        MoveCoalescer Coalescer;
+        PointerTable Table;
+        uint64_t NextFrame{ 0 };
+        uint64_t Frames{ 0 };
+
+        void Apply(PointerEvent const& event)
+        {
+            if (event.Timestamp >= NextFrame)
+            {
+                Coalescer.Flush(Table);
+                ++Frames;
+                NextFrame = event.Timestamp + FrameInterval;
+            }
+
+            Lifecycle.Process(event, [this](PointerEvent const& valid)
+            {
+                size_t const index = Table.Find(valid.Id);
+                switch (valid.Kind)
+                {
+                case PointerEventKind::Entered:
+                    Table.Insert(valid.Id, valid.DeviceKind, valid.InContact, { valid.X, valid.Y });
+                    break;
+                case PointerEventKind::Exited:
+                    Coalescer.Remove(valid.Id);
+                    Table.Erase(valid.Id);
+                    break;
+                case PointerEventKind::Moved:
+                    Coalescer.AddMove(valid.Id, { valid.X, valid.Y, valid.Timestamp, valid.Pressure });
+                    break;
+                default:
+                    if (index != PointerTable::npos)
+                    {
+                        Coalescer.DiscardPending(valid.Id);
+                        Table.SetPressed(index, valid.Kind == PointerEventKind::Pressed);
+                        Table.SetPosition(index, { valid.X, valid.Y });
+                    }
+                    break;
+                }
+            });
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    uint64_t const duration = arguments.Quick ? 10000000 : 300000000;
+    uint64_t const realTimeDuration = arguments.Quick ? 200000 : 5000000;
+
+    auto const path = std::filesystem::temp_directory_path() / "PointerTraceReplayBench.ptrc";
+    PointerTraceWriter writer;
+    auto const writeStart = Clock::now();
+    uint64_t const eventCount = writer.Open(path) ? WriteTrace(writer, duration) : 0;
+    double const writeSeconds = SecondsSince(writeStart);
+    if (eventCount == 0)
+    {
+        std::printf("couldn't write %s\n", path.string().c_str());
+        return 1;
+    }
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::printf("couldn't map %s\n", path.string().c_str());
+        return 1;
+    }
+
+    double const events = static_cast<double>(eventCount);
+    std::printf("trace: %.0f s, %llu events, %zu bytes (%.2f bytes/event), written at %.1f M events/s\n",
+        static_cast<double>(duration) * 1e-6, static_cast<unsigned long long>(eventCount), file.Size(),
+        static_cast<double>(file.Size()) / events, events / writeSeconds * 1e-6);
+
+    // Decode only
+    size_t delivered = 0;
+    double const decodeSeconds = BestOf(3, [&]
+    {
+        PointerTraceReader reader(file.Data(), file.Size());
+        uint64_t checksum = 0;
+        delivered = ReplayPointerTrace(reader, [&](PointerEvent const& event) { checksum += event.Timestamp + event.Id; });
+        DoNotOptimize(checksum);
+    });
+    std::printf("decode:   %6.2f ns/event, %7.1f M events/s, %7.1f MB/s\n",
+        decodeSeconds * 1e9 / events, events / decodeSeconds * 1e-6, static_cast<double>(file.Size()) / decodeSeconds * 1e-6);
+
+    // Decode, lifecycle, coalescer and table
+    uint64_t frames = 0;
+    double const pipelineSeconds = BestOf(3, [&]
+    {
+        PointerTraceReader reader(file.Data(), file.Size());
+        Pipeline pipeline;
+        ReplayPointerTrace(reader, [&](PointerEvent const& event) { pipeline.Apply(event); });
+        frames = pipeline.Frames;
+        DoNotOptimize(pipeline.Table);
+    });
+    std::printf("pipeline: %6.2f ns/event, %7.1f M events/s, %.0fx real time (%llu frames)\n",
+        pipelineSeconds * 1e9 / events, events / pipelineSeconds * 1e-6,
+        static_cast<double>(duration) * 1e-6 / pipelineSeconds, static_cast<unsigned long long>(frames));
+
+    // Real-time pacing over a shorter trace: how late is each event against
+    // its recorded offset
+    {
+        writer.OpenInMemory();
+        WriteTrace(writer, realTimeDuration);
+        PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+        std::vector<double> lateness;
+        Clock::time_point replayStart{};
+        uint64_t traceStart = 0;
+        Pipeline pipeline;
+        ReplayPointerTrace(reader, [&](PointerEvent const& event)
+        {
+            auto const now = Clock::now();
+            if (lateness.empty())
+            {
+                replayStart = now;
+                traceStart = event.Timestamp;
+            }
+            double const due = static_cast<double>(event.Timestamp - traceStart);
+            lateness.push_back(std::chrono::duration<double, std::micro>(now - replayStart).count() - due);
+            pipeline.Apply(event);
+        }, ReplayPacing::RealTime);
+
+        std::sort(lateness.begin(), lateness.end());
+        auto const percentile = [&](double p) { return lateness[static_cast<size_t>(p * static_cast<double>(lateness.size() - 1))]; };
+        std::printf("realtime: %zu events over %.1f s, lateness p50 %.0f us, p99 %.0f us, max %.0f us\n",
+            lateness.size(), static_cast<double>(realTimeDuration) * 1e-6, percentile(0.5), percentile(0.99), lateness.back());
+    }
+
+    file.Close();
+    std::filesystem::remove(path);
+    return delivered == eventCount ? 0 : 1;
+}
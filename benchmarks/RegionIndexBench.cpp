@@ -0,0 +1,200 @@
+// Hit tests 256 pointers per frame against 100k regions on a 4K surface: a
+// dense layout of small tiles and one of overlapping hotspots of mixed size.
+// Reports the batched grid query against a linear scan of every region, the
+// hover tracker's per-frame diff, and insert, move and remove costs.
+
+#include "BenchHarness.h"
+#include "RegionIndex.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr float Width = 3840.0f;
+    constexpr float Height = 2160.0f;
+    constexpr size_t PointerCount = 256;
+
+    struct Layout
+    {
+        char const* Name;
+        std::vector<Rect> Regions;
+    };
+
+    // A grid of tiles with small gaps, like a dense tile view
+    Layout Tiles(size_t count)
+    {
+        Layout layout{ "tiles", {} };
+        float const size = std::sqrt(Width * Height / static_cast<float>(count));
+        for (float y = 0.0f; (y < Height) && (layout.Regions.size() < count); y += size)
+        {
+            for (float x = 0.0f; (x < Width) && (layout.Regions.size() < count); x += size)
+            {
+                layout.Regions.push_back({ x + 1.0f, y + 1.0f, x + size - 1.0f, y + size - 1.0f });
+            }
+        }
+        return layout;
+    }
+
+    // Randomly placed hotspots from 4 to 200 DIPs, overlapping each other
+    Layout Hotspots(size_t count, Random& random)
+    {
+        Layout layout{ "hotspots", {} };
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const size = (random.NextBelow(20) == 0) ? random.NextFloat(50.0f, 200.0f) : random.NextFloat(4.0f, 24.0f);
+            float const x = random.NextFloat(0.0f, Width - size);
+            float const y = random.NextFloat(0.0f, Height - size);
+            layout.Regions.push_back({ x, y, x + size, y + size });
+        }
+        return layout;
+    }
+
+    // Every region, topmost (last) first
+    RegionId LinearHitTest(std::vector<Rect> const& regions, std::vector<RegionId> const& ids, Point point)
+    {
+        for (size_t i = regions.size(); i-- > 0;)
+        {
+            Rect const& r = regions[i];
+            if ((point.X >= r.Left) && (point.X < r.Right) && (point.Y >= r.Top) && (point.Y < r.Bottom))
+            {
+                return ids[i];
+            }
+        }
+        return NoRegion;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const regionCount = arguments.Quick ? 10000 : 100000;
+    int const frames = arguments.Quick ? 20 : 600;
+    int const runs = arguments.Quick ? 1 : 5;
+
+    Random random;
+    Layout const layouts[] = { Tiles(regionCount), Hotspots(regionCount, random) };
+    std::printf("%zu pointers on a %.0fx%.0f surface\n", PointerCount, Width, Height);
+
+    for (auto const& layout : layouts)
+    {
+        size_t const count = layout.Regions.size();
+        std::printf("%s: %zu regions\n", layout.Name, count);
+
+        // Pointers wander around the surface from frame to frame
+        std::vector<std::vector<Point>> positions(static_cast<size_t>(frames), std::vector<Point>(PointerCount));
+        for (size_t p = 0; p < PointerCount; ++p)
+        {
+            Point point{ random.NextFloat(0.0f, Width), random.NextFloat(0.0f, Height) };
+            for (auto& frame : positions)
+            {
+                point.X = std::min(std::max(point.X + random.NextFloat(-8.0f, 8.0f), 0.0f), Width - 1.0f);
+                point.Y = std::min(std::max(point.Y + random.NextFloat(-8.0f, 8.0f), 0.0f), Height - 1.0f);
+                frame[p] = point;
+            }
+        }
+
+        for (float cellSize : { 16.0f, 64.0f, 256.0f })
+        {
+            RegionIndex index({ cellSize });
+            index.Resize(Width, Height);
+            std::vector<RegionId> ids(count);
+            double const insertSeconds = BestOf(1, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ids[i] = index.Insert(layout.Regions[i]);
+                }
+            });
+
+            PointerTable pointers(PointerCount);
+            for (uint32_t id = 1; id <= PointerCount; ++id)
+            {
+                pointers.Insert(id, PointerDeviceKind::Touch, false, positions[0][id - 1]);
+            }
+
+            std::vector<RegionId> hits;
+            std::vector<RegionEvent> events;
+            RegionHoverTracker tracker;
+            size_t eventCount = 0;
+            double hitSeconds = 0.0;
+            double trackSeconds = 0.0;
+            for (int run = 0; run < runs; ++run)
+            {
+                double runHit = 0.0;
+                double runTrack = 0.0;
+                eventCount = 0;
+                tracker.Clear();
+                for (auto const& frame : positions)
+                {
+                    for (size_t p = 0; p < PointerCount; ++p)
+                    {
+                        pointers.SetPosition(p, frame[p]);
+                    }
+
+                    auto start = Clock::now();
+                    index.HitTest(pointers, hits);
+                    runHit += SecondsSince(start);
+
+                    events.clear();
+                    start = Clock::now();
+                    tracker.Update(pointers, hits, events);
+                    runTrack += SecondsSince(start);
+                    eventCount += events.size();
+                }
+                hitSeconds = (run == 0) ? runHit : std::min(hitSeconds, runHit);
+                trackSeconds = (run == 0) ? runTrack : std::min(trackSeconds, runTrack);
+            }
+
+            // Moving every region a little, then removing them all
+            double const moveSeconds = BestOf(1, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Rect r = layout.Regions[i];
+                    r.Left += 3.0f;
+                    r.Right += 3.0f;
+                    index.Move(ids[i], r);
+                }
+            });
+            double const removeSeconds = BestOf(1, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    index.Remove(ids[i]);
+                }
+            });
+
+            double const perFrame = 1e6 / static_cast<double>(frames);
+            std::printf("  cell %3.0f: hit test %7.2f us/frame, hover diff %5.2f us/frame (%.1f events/frame), insert %5.0f ns, move %5.0f ns, remove %5.0f ns\n",
+                cellSize, hitSeconds * perFrame, trackSeconds * perFrame, static_cast<double>(eventCount) / frames,
+                insertSeconds * 1e9 / static_cast<double>(count), moveSeconds * 1e9 / static_cast<double>(count), removeSeconds * 1e9 / static_cast<double>(count));
+        }
+
+        // The linear scan a per-move handler would do, for every pointer
+        std::vector<RegionId> ids(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ids[i] = static_cast<RegionId>(i);
+        }
+        int const linearFrames = std::min(frames, 20);
+        double const linearSeconds = BestOf(runs, [&]
+        {
+            RegionId checksum = 0;
+            for (int f = 0; f < linearFrames; ++f)
+            {
+                for (auto const& point : positions[static_cast<size_t>(f)])
+                {
+                    checksum += LinearHitTest(layout.Regions, ids, point);
+                }
+            }
+            DoNotOptimize(checksum);
+        });
+        std::printf("  linear scan: %.0f us/frame\n", linearSeconds * 1e6 / linearFrames);
+    }
+
+    return 0;
+}
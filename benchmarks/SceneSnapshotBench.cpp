@@ -0,0 +1,179 @@
+// Cost of publishing scene snapshots at 60 Hz from a 1 kHz pen: the
+// channel's replay of new events into each slot, against copying the whole
+// scene into the back slot every publish, as the ink on screen grows. Also
+// measures a consumer that stops acquiring, and a real producer and consumer
+// on two threads.
+
+#include "BenchHarness.h"
+#include "SceneSnapshot.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr uint64_t EventsPerPublish = 16;
+
+    // Curvy pen strokes of 1000 samples each, one per call to Next()
+    struct Pen
+    {
+        Random Generator;
+        uint64_t Time{ 0 };
+
+        PointerEvent Next()
+        {
+            uint64_t const phase = Time % 1000;
+            PointerEventKind const kind = (Time == 0) ? PointerEventKind::Entered :
+                (phase == 1) ? PointerEventKind::Pressed : (phase == 0) ? PointerEventKind::Released : PointerEventKind::Moved;
+            bool const inContact = (kind == PointerEventKind::Pressed) || ((kind == PointerEventKind::Moved) && (phase != 0));
+            float const angle = static_cast<float>(Time) * 0.01f;
+            float const x = 960.0f + 400.0f * std::cos(angle * 1.3f) + Generator.NextFloat(-0.5f, 0.5f);
+            float const y = 540.0f + 300.0f * std::sin(angle * 2.1f) + Generator.NextFloat(-0.5f, 0.5f);
+            ++Time;
+            return { Time * 1000, Time, 1, x, y, inContact ? 0.5f : 0.0f, kind, PointerDeviceKind::Pen, inContact };
+        }
+    };
+
+    size_t StoredPoints(StrokeStore const& strokes)
+    {
+        size_t points = 0;
+        for (size_t i = 0; i < strokes.StrokeCount(); ++i)
+        {
+            points += strokes.StrokePointCount(i);
+        }
+        return points;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    uint64_t const warmups[] = { 1000, 100000, 1000000 };
+    uint64_t const measured = arguments.Quick ? 60 : 600;
+
+    std::printf("cost per publish of %llu events\n%12s %14s %14s %14s\n", static_cast<unsigned long long>(EventsPerPublish), "ink points", "replay", "stalled", "full copy");
+    for (uint64_t warmup : warmups)
+    {
+        if (arguments.Quick && (warmup > 100000))
+        {
+            continue;
+        }
+
+        // Draw the history, then time publishes with a consumer acquiring
+        // every frame, with one that holds its slot, and with whole copies
+        Pen pen;
+        SceneSnapshotChannel channel;
+        SceneSnapshotChannel stalled;
+        SceneSnapshot scene;
+        for (uint64_t i = 0; i < warmup; ++i)
+        {
+            PointerEvent const event = pen.Next();
+            channel.Apply(event, true);
+            stalled.Apply(event, true);
+            SceneSnapshotChannel::ApplyEvent(scene, event, true, false);
+            if ((i % EventsPerPublish) == 0)
+            {
+                channel.Publish();
+                channel.Acquire();
+                stalled.Publish();
+                stalled.Acquire();
+            }
+        }
+
+        std::vector<PointerEvent> events;
+        for (uint64_t i = 0; i < measured * EventsPerPublish; ++i)
+        {
+            events.push_back(pen.Next());
+        }
+
+        auto const time = [&](SceneSnapshotChannel& target, bool acquire)
+        {
+            auto const start = Clock::now();
+            for (uint64_t frame = 0; frame < measured; ++frame)
+            {
+                for (uint64_t i = 0; i < EventsPerPublish; ++i)
+                {
+                    target.Apply(events[frame * EventsPerPublish + i], true);
+                }
+                target.Publish();
+                if (acquire)
+                {
+                    DoNotOptimize(target.Acquire().Sequence);
+                }
+            }
+            return SecondsSince(start) / static_cast<double>(measured);
+        };
+        double const replaySeconds = time(channel, true);
+        double const stalledSeconds = time(stalled, false);
+
+        SceneSnapshot back;
+        auto const copyStart = Clock::now();
+        for (uint64_t frame = 0; frame < measured; ++frame)
+        {
+            for (uint64_t i = 0; i < EventsPerPublish; ++i)
+            {
+                SceneSnapshotChannel::ApplyEvent(scene, events[frame * EventsPerPublish + i], true, true);
+            }
+            back = scene;
+            DoNotOptimize(back.Sequence);
+        }
+        double const copySeconds = SecondsSince(copyStart) / static_cast<double>(measured);
+
+        std::printf("%12zu %11.2f us %11.2f us %11.2f us   (stalled: %llu full copies, log %zu events)\n", StoredPoints(scene.Strokes),
+            replaySeconds * 1e6, stalledSeconds * 1e6, copySeconds * 1e6, static_cast<unsigned long long>(stalled.FullCopyCount()), stalled.LogLength());
+    }
+
+    // Two threads: the input side publishing as fast as it can, the render
+    // side acquiring as fast as it can
+    {
+        uint64_t const publishes = arguments.Quick ? 10000 : 1000000;
+        SceneSnapshotChannel channel;
+        Pen pen;
+        std::vector<PointerEvent> events;
+        for (uint64_t i = 0; i < 64 * EventsPerPublish; ++i)
+        {
+            events.push_back(pen.Next());
+        }
+
+        std::atomic<bool> done{ false };
+        uint64_t acquired = 0;
+        std::thread consumer([&]
+        {
+            while (!done.load(std::memory_order_acquire))
+            {
+                if (channel.HasUpdate())
+                {
+                    DoNotOptimize(channel.Acquire().Pointers.Size());
+                    ++acquired;
+                }
+            }
+        });
+
+        // Moves only, so the scene stays the same size
+        auto const start = Clock::now();
+        for (uint64_t publish = 0; publish < publishes; ++publish)
+        {
+            for (uint64_t i = 0; i < EventsPerPublish; ++i)
+            {
+                PointerEvent event = events[(publish % 64) * EventsPerPublish + i];
+                event.Kind = (publish == 0 && i == 0) ? PointerEventKind::Entered : PointerEventKind::Moved;
+                event.InContact = false;
+                channel.Apply(event, false);
+            }
+            channel.Publish();
+        }
+        double const seconds = SecondsSince(start);
+        done.store(true, std::memory_order_release);
+        consumer.join();
+
+        std::printf("two threads: %.2f us per publish of %llu events, %llu of %llu snapshots acquired\n", seconds * 1e6 / static_cast<double>(publishes),
+            static_cast<unsigned long long>(EventsPerPublish), static_cast<unsigned long long>(acquired), static_cast<unsigned long long>(publishes));
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Fill rate of the CPU rasterizer at 1080p and 4K: clears, opaque and
+// translucent rectangles, triangle strips, and whole pointer scenes. Reports
+// megapixels and gigabytes written per second for the compiled-in span path.
+
+#include "BenchHarness.h"
+#include "PixelOps.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    void Report(char const* name, double seconds, double pixels)
+    {
+        std::printf("  %-28s %9.3f ms %9.0f Mpix/s %7.2f GB/s\n", name, seconds * 1e3, pixels / seconds * 1e-6, pixels * 4.0 / seconds * 1e-9);
+    }
+
+    // Area of many rects; they stay inside the target
+    std::vector<Rect> MakeRects(uint32_t width, uint32_t height, size_t count, float size, Random& random)
+    {
+        std::vector<Rect> rects;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const x = random.NextFloat(0.0f, static_cast<float>(width) - size);
+            float const y = random.NextFloat(0.0f, static_cast<float>(height) - size);
+            rects.push_back({ x, y, x + size, y + size });
+        }
+        return rects;
+    }
+
+    // Zigzag strip 40 DIPs wide across the whole target, like a long ink stroke
+    std::vector<Point> MakeStrip(uint32_t width, uint32_t height)
+    {
+        std::vector<Point> strip;
+        for (uint32_t x = 0; x <= width; x += 4)
+        {
+            float const y = static_cast<float>(height) * (0.5f + 0.4f * std::sin(static_cast<float>(x) * 0.01f));
+            strip.push_back({ static_cast<float>(x), y - 20.0f });
+            strip.push_back({ static_cast<float>(x), y + 20.0f });
+        }
+        return strip;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const runs = arguments.Quick ? 1 : 20;
+
+    std::printf("span path: %s\n", PixelOps::FillPathName());
+    struct Size
+    {
+        char const* Name;
+        uint32_t Width;
+        uint32_t Height;
+    };
+    for (auto const& size : { Size{ "1080p", 1920, 1080 }, Size{ "4K", 3840, 2160 } })
+    {
+        if (arguments.Quick && (size.Width > 1920))
+        {
+            continue;
+        }
+
+        std::printf("%s\n", size.Name);
+        SoftwareRenderBackend backend(size.Width, size.Height);
+        double const surface = static_cast<double>(size.Width) * size.Height;
+        Random random;
+        backend.BeginDraw();
+
+        Report("clear", BestOf(runs, [&] { backend.Clear(Colors::Black); }), surface);
+
+        auto const rects = MakeRects(size.Width, size.Height, 1000, 40.0f, random);
+        double const rectPixels = 1000.0 * 40.0 * 40.0;
+        Report("1000 opaque 40x40 rects", BestOf(runs, [&]
+        {
+            for (auto const& rect : rects)
+            {
+                backend.FillRectangle(rect, Colors::Red);
+            }
+        }), rectPixels);
+        Report("1000 translucent 40x40 rects", BestOf(runs, [&]
+        {
+            for (auto const& rect : rects)
+            {
+                backend.FillRectangle(rect, { 0.0f, 0.0f, 1.0f, 0.5f });
+            }
+        }), rectPixels);
+
+        auto const strip = MakeStrip(size.Width, size.Height);
+        double const stripPixels = static_cast<double>(size.Width) * 40.0;
+        Report("opaque strip", BestOf(runs, [&] { backend.FillTriangleStrip(strip.data(), strip.size(), Colors::White); }), stripPixels);
+        Report("translucent strip", BestOf(runs, [&] { backend.FillTriangleStrip(strip.data(), strip.size(), { 1.0f, 1.0f, 1.0f, 0.3f }); }), stripPixels);
+        backend.EndDraw();
+
+        // A full frame: clear plus an indicator per pointer
+        for (size_t count : { 10, 256 })
+        {
+            PointerTable pointers(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                pointers.Insert(static_cast<uint32_t>(i), PointerDeviceKind::Touch, (i % 2) != 0,
+                    { random.NextFloat(0.0f, static_cast<float>(size.Width)), random.NextFloat(0.0f, static_cast<float>(size.Height)) });
+            }
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "scene, %zu pointers", count);
+            double const indicator = 4.0 * PointerScene::IndicatorHalfSize * PointerScene::IndicatorHalfSize;
+            Report(name, BestOf(runs, [&] { PointerScene::Draw(backend, pointers); }), surface + static_cast<double>(count) * indicator);
+        }
+        DoNotOptimize(backend.PixelAt(0, 0));
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+// SpscRing throughput against the mutex-guarded vector it replaced for the
+// heatmap samples: one producer thread, one consumer thread draining in
+// batches, and the uncontended single-thread cost per element.
+
+#include "BenchHarness.h"
+#include "PointerHeatmap.h"
+#include "SpscRing.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // What PointerRenderer queued before: producers push under the lock, the
+    // consumer swaps the whole vector out once per drain
+    class LockedQueue
+    {
+    public:
+        explicit LockedQueue(size_t capacity) : m_capacity{ capacity } {}
+
+        bool TryPush(HeatmapSample const& sample)
+        {
+            std::lock_guard lock{ m_lock };
+            if (m_samples.size() >= m_capacity)
+            {
+                return false;
+            }
+
+            m_samples.push_back(sample);
+            return true;
+        }
+
+        template <typename Fn>
+        size_t ConsumeAll(Fn&& fn)
+        {
+            {
+                std::lock_guard lock{ m_lock };
+                m_samples.swap(m_batch);
+                m_samples.clear();
+            }
+
+            for (auto const& sample : m_batch)
+            {
+                fn(sample);
+            }
+            return m_batch.size();
+        }
+
+    private:
+        size_t const m_capacity;
+        std::mutex m_lock;
+        std::vector<HeatmapSample> m_samples;
+        std::vector<HeatmapSample> m_batch;
+    };
+
+    // Producer retries on a full queue, so both sides move every element
+    template <typename Queue>
+    double MeasureThreaded(Queue& queue, uint64_t count)
+    {
+        return BestOf(3, [&]
+        {
+            std::thread producer([&]
+            {
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    HeatmapSample const sample{ static_cast<float>(i), 0.0f, true };
+                    while (!queue.TryPush(sample))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            uint64_t received = 0;
+            float sum = 0.0f;
+            while (received < count)
+            {
+                size_t const consumed = queue.ConsumeAll([&](HeatmapSample const& sample) { sum += sample.X; });
+                received += consumed;
+                if (consumed == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            producer.join();
+            DoNotOptimize(sum);
+        });
+    }
+
+    // Push a frame's worth, drain, repeat
+    template <typename Queue>
+    double MeasureSingleThread(Queue& queue, uint64_t count, size_t batch)
+    {
+        return BestOf(5, [&]
+        {
+            float sum = 0.0f;
+            for (uint64_t i = 0; i < count; i += batch)
+            {
+                for (size_t j = 0; j < batch; ++j)
+                {
+                    queue.TryPush({ static_cast<float>(j), 0.0f, false });
+                }
+                queue.ConsumeAll([&](HeatmapSample const& sample) { sum += sample.X; });
+            }
+            DoNotOptimize(sum);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    uint64_t const count = arguments.Quick ? 100000 : 20000000;
+    size_t const capacity = 64 * 1024;
+
+    std::printf("%-24s | %14s %14s\n", "", "ring ns/item", "locked ns/item");
+    {
+        SpscRing<HeatmapSample> ring(capacity);
+        LockedQueue locked(capacity);
+        double const ringSeconds = MeasureThreaded(ring, count);
+        double const lockedSeconds = MeasureThreaded(locked, count);
+        std::printf("%-24s | %14.2f %14.2f\n", "two threads", ringSeconds * 1e9 / static_cast<double>(count), lockedSeconds * 1e9 / static_cast<double>(count));
+        std::printf("%-24s | %14zu %14s\n", "ring high water mark", ring.HighWaterMark(), "-");
+    }
+
+    for (size_t batch : { 16, 256, 4096 })
+    {
+        SpscRing<HeatmapSample> ring(capacity);
+        LockedQueue locked(capacity);
+        double const ringSeconds = MeasureSingleThread(ring, count, batch);
+        double const lockedSeconds = MeasureSingleThread(locked, count, batch);
+        char label[32];
+        std::snprintf(label, sizeof(label), "one thread, batch %zu", batch);
+        std::printf("%-24s | %14.2f %14.2f\n", label, ringSeconds * 1e9 / static_cast<double>(count), lockedSeconds * 1e9 / static_cast<double>(count));
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Records synthetic handwriting into StrokeStore: 1 kHz pen strokes of a few
+// hundred samples each, curving with some jitter. Reports append throughput
+// with and without simplification, how many samples simplification keeps and
+// how far the stored path strays from the samples, memory per 10k strokes, and
+// the cost of recording once the pool is full and every new stroke evicts.
+
+#include "BenchHarness.h"
+#include "StrokeStore.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    struct Stroke
+    {
+        std::vector<PointerSample> Samples;
+    };
+
+    // Short taps, words and long underlines, at 1 kHz
+    std::vector<Stroke> MakeStrokes(size_t count)
+    {
+        Random random;
+        std::vector<Stroke> strokes(count);
+        uint64_t time = 0;
+        for (auto& stroke : strokes)
+        {
+            size_t const length = (random.NextBelow(10) == 0) ? 2 + random.NextBelow(8) : 50 + random.NextBelow(500);
+            float x = random.NextFloat(0.0f, 1920.0f);
+            float y = random.NextFloat(0.0f, 1080.0f);
+            float heading = random.NextFloat(-3.14159f, 3.14159f);
+            float const speed = random.NextFloat(0.1f, 1.5f);
+            float const turn = random.NextFloat(-0.02f, 0.02f);
+            for (size_t i = 0; i < length; ++i)
+            {
+                heading += turn + random.NextFloat(-0.05f, 0.05f);
+                x += speed * std::cos(heading) + random.NextFloat(-0.1f, 0.1f);
+                y += speed * std::sin(heading) + random.NextFloat(-0.1f, 0.1f);
+                stroke.Samples.push_back({ x, y, time, 0.5f + 0.4f * std::sin(static_cast<float>(i) * 0.02f) });
+                time += 1000;
+            }
+            time += 200000;
+        }
+
+        return strokes;
+    }
+
+    void Record(StrokeStore& store, std::vector<Stroke> const& strokes)
+    {
+        for (auto const& stroke : strokes)
+        {
+            store.Begin(1, stroke.Samples[0]);
+            for (size_t i = 1; i < stroke.Samples.size(); ++i)
+            {
+                store.Append(1, stroke.Samples[i]);
+            }
+            store.End(1);
+        }
+    }
+
+    // Largest distance from a sample to the segment of the stored path it fell between
+    double MaxDeviation(StrokeStore const& store, std::vector<Stroke> const& strokes)
+    {
+        double worst = 0.0;
+        std::vector<PointerSample> points;
+        for (size_t index = 0; index < store.StrokeCount(); ++index)
+        {
+            store.CopyPoints(index, points);
+            auto const& samples = strokes[store.StrokeId(index)].Samples;
+            size_t segment = 0;
+            for (auto const& sample : samples)
+            {
+                while ((segment + 1 < points.size()) && (points[segment + 1].Timestamp <= sample.Timestamp) && (segment + 2 < points.size()))
+                {
+                    ++segment;
+                }
+
+                if (points.size() < 2)
+                {
+                    break;
+                }
+
+                auto const& a = points[segment];
+                auto const& b = points[segment + 1];
+                double const dx = b.X - a.X;
+                double const dy = b.Y - a.Y;
+                double const length2 = dx * dx + dy * dy;
+                double t = (length2 > 0.0) ? ((sample.X - a.X) * dx + (sample.Y - a.Y) * dy) / length2 : 0.0;
+                t = std::fmin(std::fmax(t, 0.0), 1.0);
+                double const ex = a.X + t * dx - sample.X;
+                double const ey = a.Y + t * dy - sample.Y;
+                worst = std::fmax(worst, std::sqrt(ex * ex + ey * ey));
+            }
+        }
+
+        return worst;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const strokeCount = arguments.Quick ? 1000 : 10000;
+    int const runs = arguments.Quick ? 1 : 5;
+
+    auto const strokes = MakeStrokes(strokeCount);
+    size_t samples = 0;
+    for (auto const& stroke : strokes)
+    {
+        samples += stroke.Samples.size();
+    }
+    std::printf("%zu strokes, %zu samples\n", strokeCount, samples);
+
+    // Everything fits, so nothing is evicted
+    StrokeStore::Options roomy;
+    roomy.MaxChunks = 1 << 20;
+
+    StrokeStore::Options unsimplified = roomy;
+    unsimplified.MinDistance = 0.0f;
+    unsimplified.Tolerance = 0.0f;
+    unsimplified.PressureTolerance = 0.0f;
+
+    for (auto const& [name, options] : { std::pair{ "simplified", roomy }, std::pair{ "unsimplified", unsimplified } })
+    {
+        size_t memory = 0;
+        uint64_t stored = 0;
+        double deviation = 0.0;
+        double const seconds = BestOf(runs, [&]
+        {
+            StrokeStore store(options);
+            Record(store, strokes);
+            memory = store.MemoryBytes();
+            stored = store.StoredPoints();
+        });
+
+        {
+            StrokeStore store(options);
+            Record(store, strokes);
+            deviation = MaxDeviation(store, strokes);
+        }
+
+        std::printf("%-12s %6.1f ns/sample, %5.1f M samples/s, kept %.1f%% (%llu points), max deviation %.2f DIPs, %.2f MB per 10k strokes (%.1f bytes per kept point)\n",
+            name, seconds * 1e9 / static_cast<double>(samples), static_cast<double>(samples) / seconds * 1e-6,
+            100.0 * static_cast<double>(stored) / static_cast<double>(samples), static_cast<unsigned long long>(stored), deviation,
+            static_cast<double>(memory) * 1e-6 * 10000.0 / static_cast<double>(strokeCount),
+            static_cast<double>(memory) / static_cast<double>(stored));
+    }
+
+    // Steady state of a long session: the pool holds a tenth of the strokes,
+    // so recording the rest keeps evicting the oldest
+    {
+        StrokeStore::Options bounded;
+        bounded.MaxChunks = std::max<size_t>(16, strokeCount / 10);
+        uint64_t evicted = 0;
+        size_t kept = 0;
+        double const seconds = BestOf(runs, [&]
+        {
+            StrokeStore store(bounded);
+            Record(store, strokes);
+            evicted = store.EvictedStrokes();
+            kept = store.StrokeCount();
+        });
+        std::printf("bounded      %6.1f ns/sample with %zu chunks: %llu strokes evicted, %zu kept\n",
+            seconds * 1e9 / static_cast<double>(samples), bounded.MaxChunks, static_cast<unsigned long long>(evicted), kept);
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Tessellates a 1 kHz pen stroke as it is drawn, one Update() per 60 Hz
+// frame, until it has 100k points. Reports the per-frame cost as the stroke
+// grows against re-tessellating the whole stroke from scratch each frame, and
+// the throughput of tessellating finished strokes in one go.
+
+#include "BenchHarness.h"
+#include "StrokeTessellator.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    constexpr uint64_t SampleInterval = 1000;   // 1 kHz
+    constexpr uint64_t FrameInterval = 16667;   // 60 Hz
+
+    // A wandering path with pressure changes; every sample is stored, so the
+    // stroke really has one point per sample
+    PointerSample PenSample(size_t i)
+    {
+        float const t = static_cast<float>(i) * 1e-3f;
+        return { 960.0f + 700.0f * std::sin(t * 0.37f) + 3.0f * std::sin(t * 41.0f),
+            540.0f + 400.0f * std::sin(t * 0.53f) + 3.0f * std::cos(t * 37.0f),
+            i * SampleInterval, 0.5f + 0.45f * std::sin(t * 3.0f) };
+    }
+
+    StrokeStore::Options KeepEverySample()
+    {
+        StrokeStore::Options options;
+        options.MinDistance = 0.0f;
+        options.Tolerance = 0.0f;
+        options.MaxChunks = 1 << 20;
+        return options;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    size_t const points = arguments.Quick ? 10000 : 100000;
+
+    std::printf("tessellation path: %s\n", StrokeTessellator::TessellationPathName());
+
+    StrokeStore store(KeepEverySample());
+    StrokeTessellator incremental;
+    StrokeTessellator scratch;
+    Rect changed;
+
+    store.Begin(1, PenSample(0));
+    uint64_t nextFrame = FrameInterval;
+    size_t frames = 0;
+    double incrementalSeconds = 0.0;
+    double windowSeconds = 0.0;
+    size_t windowFrames = 0;
+    size_t nextReport = 1000;
+    bool reportedLast = false;
+
+    std::printf("%10s %22s %22s\n", "points", "incremental us/frame", "from scratch us/frame");
+    for (size_t i = 1; i < points; ++i)
+    {
+        PointerSample const sample = PenSample(i);
+        store.Append(1, sample);
+        if (sample.Timestamp < nextFrame)
+        {
+            continue;
+        }
+
+        nextFrame += FrameInterval;
+        auto const start = Clock::now();
+        incremental.Update(store, changed);
+        double const seconds = SecondsSince(start);
+        incrementalSeconds += seconds;
+        windowSeconds += seconds;
+        ++windowFrames;
+        ++frames;
+
+        // The last report is on the last frame before the stroke ends
+        bool const lastFrame = (i + FrameInterval / SampleInterval >= points) && !reportedLast;
+        if ((i >= nextReport) || lastFrame)
+        {
+            // What a tessellator without the incremental path would pay this frame
+            double const fromScratch = BestOf(3, [&]
+            {
+                scratch.Clear();
+                scratch.Update(store, changed);
+            });
+            std::printf("%10zu %22.2f %22.2f\n", store.StoredPointCount(0), windowSeconds * 1e6 / static_cast<double>(windowFrames), fromScratch * 1e6);
+            windowSeconds = 0.0;
+            windowFrames = 0;
+            nextReport *= 10;
+            reportedLast |= lastFrame;
+        }
+    }
+    store.End(1);
+    incremental.Update(store, changed);
+
+    std::printf("%zu frames, %.2f us/frame on average, %.1f ns per point, %llu pairs computed for %zu points\n",
+        frames, incrementalSeconds * 1e6 / static_cast<double>(frames), incrementalSeconds * 1e9 / static_cast<double>(points),
+        static_cast<unsigned long long>(incremental.PairsComputed()), incremental.MeshVertexCount(0) / 2);
+
+    // Whole finished strokes at once
+    double const wholeSeconds = BestOf(arguments.Quick ? 1 : 5, [&]
+    {
+        scratch.Clear();
+        scratch.Update(store, changed);
+    });
+    std::printf("whole stroke: %.2f ms, %.1f M points/s\n", wholeSeconds * 1e3, static_cast<double>(points) / wholeSeconds * 1e-6);
+    return 0;
+}
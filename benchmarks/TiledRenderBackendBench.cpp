@@ -0,0 +1,125 @@
+// Milliseconds per frame of the tiled CPU backend against drawing straight
+// into the target, at 1080p, 4K and 8K, with 1 to N threads: once repainting
+// every tile (a background that changes every frame under 64 indicators),
+// and once with 10 pointers moving over an unchanged background, where most
+// tiles are skipped. Thread counts past the hardware's share its cores and
+// show the pool's overhead rather than any scaling.
+
+#include "BenchHarness.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+#include "TiledRenderBackend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+using namespace PointerCoreBench;
+
+namespace
+{
+    // Pointers circling the target, at their positions for the frame
+    void PlacePointers(PointerTable& pointers, size_t count, uint32_t width, uint32_t height, size_t frame)
+    {
+        pointers.Clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const angle = static_cast<float>(i) * 0.7f + static_cast<float>(frame) * 0.02f;
+            float const radius = 0.4f * static_cast<float>(std::min(width, height)) * static_cast<float>(i + 1) / static_cast<float>(count);
+            pointers.Insert(static_cast<uint32_t>(i), PointerDeviceKind::Touch, (i % 2) != 0,
+                { static_cast<float>(width) * 0.5f + radius * std::cos(angle), static_cast<float>(height) * 0.5f + radius * std::sin(angle) });
+        }
+    }
+
+    // Seconds per frame, the best of runs runs of frames frames
+    template <typename Draw>
+    double PerFrame(int runs, size_t frames, Draw const& draw)
+    {
+        double best = HUGE_VAL;
+        size_t frame = 0;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto const start = Clock::now();
+            for (size_t i = 0; i < frames; ++i)
+            {
+                draw(frame++);
+            }
+            best = std::min(best, SecondsSince(start) / static_cast<double>(frames));
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto const arguments = ParseArguments(argc, argv);
+    int const runs = arguments.Quick ? 1 : 5;
+    size_t const frames = arguments.Quick ? 3 : 20;
+
+    unsigned const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < std::max(hardware, 2u); threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(std::max(hardware, 2u));
+
+    std::printf("%u hardware threads\n", hardware);
+    struct Size
+    {
+        char const* Name;
+        uint32_t Width;
+        uint32_t Height;
+    };
+    for (auto const& size : { Size{ "1080p", 1920, 1080 }, Size{ "4K", 3840, 2160 }, Size{ "8K", 7680, 4320 } })
+    {
+        if (arguments.Quick && (size.Width > 1920))
+        {
+            continue;
+        }
+
+        std::printf("%s\n  %-10s %14s %14s %10s\n", size.Name, "threads", "every tile", "10 pointers", "tiles");
+        SoftwareRenderBackend target(size.Width, size.Height);
+        PointerTable pointers(64);
+
+        // Every tile changes: the background's shade moves every frame
+        auto const repaint = [&](RenderBackend& backend, size_t frame)
+        {
+            PlacePointers(pointers, 64, size.Width, size.Height, frame);
+            backend.BeginDraw();
+            backend.Clear({ 0.0f, 0.0f, static_cast<float>(frame % 64) / 256.0f, 1.0f });
+            for (size_t i = 0; i < pointers.Size(); ++i)
+            {
+                Point const position = pointers.Position(i);
+                backend.FillRectangle(PointerScene::IndicatorRect(position.X, position.Y), pointers.IsPressed(i) ? PointerScene::PressedColor : PointerScene::HoverColor);
+            }
+            backend.EndDraw();
+        };
+        auto const moving = [&](RenderBackend& backend, size_t frame)
+        {
+            PlacePointers(pointers, 10, size.Width, size.Height, frame);
+            PointerScene::Draw(backend, pointers);
+        };
+
+        double const immediateRepaint = PerFrame(runs, frames, [&](size_t frame) { repaint(target, frame); });
+        double const immediateMoving = PerFrame(runs, frames, [&](size_t frame) { moving(target, frame); });
+        std::printf("  %-10s %11.2f ms %11.2f ms\n", "immediate", immediateRepaint * 1e3, immediateMoving * 1e3);
+
+        for (size_t threads : threadCounts)
+        {
+            WorkStealingPool pool(threads - 1);
+            TiledRenderBackend tiled(target, pool);
+            tiled.Invalidate();
+
+            double const everyTile = PerFrame(runs, frames, [&](size_t frame) { repaint(tiled, frame); });
+            moving(tiled, 0);
+            double const pointersOnly = PerFrame(runs, frames, [&](size_t frame) { moving(tiled, frame + 1); });
+            std::printf("  %-10zu %11.2f ms %11.2f ms %5zu/%zu\n", threads, everyTile * 1e3, pointersOnly * 1e3, tiled.TilesRasterized(), tiled.TileCount());
+        }
+        DoNotOptimize(target.PixelAt(0, 0));
+    }
+
+    return 0;
+}
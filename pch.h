@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 // STL
+#include <condition_variable>
+#include <fstream>
 #include <mutex>
 
 // Windows
@@ -14,6 +16,7 @@
 #include <winrt/Windows.Devices.Input.h>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Storage.h>
 #include <winrt/Windows.ApplicationModel.Activation.h>
 #include <winrt/Windows.UI.Core.h>
 #include <winrt/Windows.UI.Input.h>
@@ -29,4 +32,5 @@
 #include <dxgi1_6.h>
 #include <d3d11_4.h>
 #include <d2d1_1.h>
+#include <d2d1_3.h>
 #include <windows.ui.xaml.media.dxinterop.h>
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "CursorAtlas.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace PointerCore;
+
+namespace
+{
+    constexpr float Pi = 3.14159265f;
+    constexpr PointerDeviceKind Devices[] = { PointerDeviceKind::Touch, PointerDeviceKind::Pen, PointerDeviceKind::Mouse };
+
+    uint32_t SheetPixel(SpriteSheet const& sheet, CursorAtlas::Sprite const& sprite, uint32_t x, uint32_t y)
+    {
+        return sheet.Pixels[(static_cast<size_t>(sprite.Source.Top) + y) * sheet.Width + static_cast<size_t>(sprite.Source.Left) + x];
+    }
+
+    // Sum of a sprite's alpha, in square DIPs
+    float CoveredArea(CursorAtlas const& atlas, PointerDeviceKind device, bool pressed)
+    {
+        SpriteSheet const sheet = atlas.Sheet();
+        auto const& sprite = atlas.SpriteFor(device, pressed);
+        float total = 0.0f;
+        for (int32_t y = 0; y < sprite.Source.Bottom - sprite.Source.Top; ++y)
+        {
+            for (int32_t x = 0; x < sprite.Source.Right - sprite.Source.Left; ++x)
+            {
+                total += static_cast<float>(SheetPixel(sheet, sprite, static_cast<uint32_t>(x), static_cast<uint32_t>(y)) >> 24) / 255.0f;
+            }
+        }
+        return total / (atlas.Scale() * atlas.Scale());
+    }
+}
+
+TEST_CASE(RebuildsOnlyWhenTheScaleChanges)
+{
+    CursorAtlas atlas;
+    CHECK(!atlas.IsBuilt());
+    CHECK(atlas.Build(1.0f));
+    CHECK(atlas.IsBuilt());
+    uint64_t const version = atlas.Sheet().Version;
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        CHECK(!atlas.Build(1.0f));
+    }
+    CHECK(atlas.BuildCount() == 1);
+    CHECK(atlas.Sheet().Version == version);
+
+    // Another scale is a new sheet; other atlases never reuse a version
+    CHECK(atlas.Build(1.5f));
+    CHECK(atlas.Sheet().Version != version);
+    CHECK(atlas.Sheet().Scale == 1.5f);
+    CHECK(atlas.BuildCount() == 2);
+    CursorAtlas other;
+    other.Build(1.5f);
+    CHECK(other.Sheet().Version != atlas.Sheet().Version);
+
+    // Scales out of range are clamped, bad ones mean 1
+    CHECK(atlas.Build(100.0f));
+    CHECK(atlas.Scale() == 8.0f);
+    CHECK(!atlas.Build(9.0f));
+    CHECK(atlas.Build(std::nanf("")));
+    CHECK(atlas.Scale() == 1.0f);
+    CHECK(!atlas.Build(INFINITY));
+
+    // Six cells side by side, a pixel apart
+    SpriteSheet const sheet = atlas.Sheet();
+    CHECK(sheet.Height == 40);
+    CHECK(sheet.Width == 6 * 41 - 1);
+}
+
+TEST_CASE(ShapesHaveTheRightArea)
+{
+    // The pen nib is a diamond of half-diagonal 9 DIPs, the hovering mouse
+    // a ring of radius 14 and width 2.5 around a dot of radius 1.8
+    float const nib = 2.0f * 9.0f * 9.0f;
+    float const ring = 2.0f * Pi * 14.0f * 2.5f + Pi * 1.8f * 1.8f;
+    for (float scale : { 1.0f, 1.25f, 1.5f, 2.0f, 3.0f })
+    {
+        CursorAtlas atlas;
+        atlas.Build(scale);
+        CHECK_NEAR(CoveredArea(atlas, PointerDeviceKind::Pen, true), nib, nib * 0.02f);
+        CHECK_NEAR(CoveredArea(atlas, PointerDeviceKind::Mouse, false), ring, ring * 0.02f);
+    }
+}
+
+TEST_CASE(SpritesAreSymmetricPremultipliedAndFitTheirCells)
+{
+    for (float scale : { 1.0f, 1.5f, 2.0f })
+    {
+        CursorAtlas::Options options;
+        options.HoverColor = { 0.2f, 0.6f, 1.0f, 0.8f };
+        CursorAtlas atlas(options);
+        atlas.Build(scale);
+        SpriteSheet const sheet = atlas.Sheet();
+
+        bool premultiplied = true;
+        bool symmetric = true;
+        bool clearEdges = true;
+        for (auto device : Devices)
+        {
+            for (bool pressed : { false, true })
+            {
+                auto const& sprite = atlas.SpriteFor(device, pressed);
+                auto const size = static_cast<uint32_t>(sprite.Source.Right - sprite.Source.Left);
+                CHECK(sprite.Bounds.Right - sprite.Bounds.Left == static_cast<float>(size) / scale);
+                for (uint32_t y = 0; y < size; ++y)
+                {
+                    for (uint32_t x = 0; x < size; ++x)
+                    {
+                        uint32_t const pixel = SheetPixel(sheet, sprite, x, y);
+                        uint32_t const alpha = pixel >> 24;
+                        for (uint32_t shift = 0; shift < 24; shift += 8)
+                        {
+                            premultiplied = premultiplied && (((pixel >> shift) & 0xff) <= alpha);
+                        }
+
+                        // Mirrored either way, to within rounding
+                        uint32_t const mirrored = SheetPixel(sheet, sprite, size - 1 - x, size - 1 - y) >> 24;
+                        symmetric = symmetric && (std::abs(static_cast<int>(alpha) - static_cast<int>(mirrored)) <= 1);
+                        if ((x == 0) || (y == 0) || (x == size - 1) || (y == size - 1))
+                        {
+                            clearEdges = clearEdges && (alpha == 0);
+                        }
+                    }
+                }
+            }
+        }
+        CHECK(premultiplied);
+        CHECK(symmetric);
+        CHECK(clearEdges);
+    }
+}
+
+TEST_CASE(ColorsFollowStateAndFormat)
+{
+    CursorAtlas::Options options;
+    options.HoverColor = Colors::Blue;
+    options.PressedColor = Colors::Red;
+    CursorAtlas bgra(options);
+    bgra.Build(1.0f);
+    options.Format = PixelFormat::Rgba8;
+    CursorAtlas rgba(options);
+    rgba.Build(1.0f);
+
+    // The middle of the pressed nib is solid red, of the mouse's hover dot solid blue
+    auto const& nib = bgra.SpriteFor(PointerDeviceKind::Pen, true);
+    auto const& dot = bgra.SpriteFor(PointerDeviceKind::Mouse, false);
+    CHECK(SheetPixel(bgra.Sheet(), nib, 20, 20) == 0xffff0000u);
+    CHECK(SheetPixel(rgba.Sheet(), nib, 20, 20) == 0xff0000ffu);
+    CHECK(SheetPixel(bgra.Sheet(), dot, 20, 20) == 0xff0000ffu);
+    CHECK(SheetPixel(rgba.Sheet(), dot, 20, 20) == 0xffff0000u);
+
+    // Kinds past the known ones look like a mouse
+    CHECK(&bgra.SpriteFor(static_cast<PointerDeviceKind>(7), false) == &bgra.SpriteFor(PointerDeviceKind::Mouse, false));
+}
+
+TEST_CASE(PlacedSpritesStayInTheIndicatorRect)
+{
+    // Damage tracking repaints indicator rects, so nothing a sprite draws
+    // may fall outside one, wherever the pointer is between pixels
+    CursorAtlas atlas;
+    atlas.Build(1.0f);
+    SpriteSheet const sheet = atlas.Sheet();
+    SoftwareRenderBackend backend(120, 120);
+    bool inside = true;
+    bool onGrid = true;
+    for (float offset : { 0.0f, 0.25f, 0.5f, 0.75f, 0.999f })
+    {
+        for (auto device : Devices)
+        {
+            for (bool pressed : { false, true })
+            {
+                Point const position{ 60.0f + offset, 60.0f - offset };
+                SpriteInstance const sprite = atlas.Place(device, pressed, position);
+                onGrid = onGrid && (sprite.Destination.Left == std::floor(sprite.Destination.Left)) && (sprite.Destination.Top == std::floor(sprite.Destination.Top));
+
+                backend.BeginDraw();
+                backend.Clear({ 0.0f, 0.0f, 0.0f, 0.0f });
+                backend.DrawSprites(sheet, &sprite, 1);
+                backend.EndDraw();
+
+                PixelRect const allowed = SoftwareRenderBackend::CoveredPixels(PointerScene::IndicatorRect(position.X, position.Y));
+                for (int32_t y = 0; y < 120; ++y)
+                {
+                    for (int32_t x = 0; x < 120; ++x)
+                    {
+                        bool const drawn = backend.PixelAt(static_cast<uint32_t>(x), static_cast<uint32_t>(y)) != 0;
+                        bool const allowedHere = (x >= allowed.Left) && (x < allowed.Right) && (y >= allowed.Top) && (y < allowed.Bottom);
+                        inside = inside && (!drawn || allowedHere);
+                    }
+                }
+            }
+        }
+    }
+    CHECK(inside);
+    CHECK(onGrid);
+}
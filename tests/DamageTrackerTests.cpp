@@ -0,0 +1,290 @@
+#include "CursorAtlas.h"
+#include "DamageTracker.h"
+#include "IndicatorBatch.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+#include "StrokeStore.h"
+#include "StrokeTessellator.h"
+#include "TestHarness.h"
+
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    constexpr int32_t Width = 320;
+    constexpr int32_t Height = 200;
+
+    // What a buffer holds before it was ever drawn, or after the swap chain
+    // reallocated it: anything that isn't repainted shows up as a mismatch
+    constexpr uint32_t Garbage = 0xffff00ffu;
+
+    enum class Path
+    {
+        Plain,
+        Batched,
+        Cursors,
+    };
+
+    bool Contains(DamageRegion const& region, int32_t x, int32_t y)
+    {
+        if (region.Full)
+        {
+            return true;
+        }
+
+        for (auto const& rect : region.Rects)
+        {
+            if ((x >= rect.Left) && (x < rect.Right) && (y >= rect.Top) && (y < rect.Bottom))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Random pointer traffic: moves (small, large, off the edges), presses,
+    // pointers arriving and leaving (which reorders the table), and ink for
+    // pressed pens
+    class Simulation
+    {
+    public:
+        explicit Simulation(uint32_t seed) : m_random{ seed } {}
+
+        PointerTable const& Pointers() const noexcept { return m_pointers; }
+        StrokeTessellator const& Ink() const noexcept { return m_ink; }
+
+        // Advances one frame; returns the bounds of ink that changed, if any
+        bool Step(Rect& inkChanged)
+        {
+            size_t const events = m_random() % 6;
+            for (size_t event = 0; event < events; ++event)
+            {
+                uint32_t const id = 1 + m_random() % 12;
+                size_t const index = m_pointers.Find(id);
+                uint32_t const action = m_random() % 10;
+                if (index == PointerTable::npos)
+                {
+                    if (action < 4)
+                    {
+                        auto const device = static_cast<PointerDeviceKind>(m_random() % 3);
+                        m_pointers.Insert(id, device, false, RandomPosition());
+                    }
+                }
+                else if (action == 0)
+                {
+                    m_strokes.End(id);
+                    m_pointers.EraseAt(index);
+                }
+                else if (action == 1)
+                {
+                    bool const pressed = !m_pointers.IsPressed(index);
+                    m_pointers.SetPressed(index, pressed);
+                    auto const position = m_pointers.Position(index);
+                    if (pressed && (m_pointers.Type(index) == PointerDeviceKind::Pen))
+                    {
+                        m_strokes.Begin(id, { position.X, position.Y, m_time, 0.7f });
+                    }
+                    else if (!pressed)
+                    {
+                        m_strokes.End(id);
+                    }
+                }
+                else
+                {
+                    // Mostly small moves, sometimes subpixel, sometimes jumps
+                    auto position = m_pointers.Position(index);
+                    if (action == 2)
+                    {
+                        position = RandomPosition();
+                    }
+                    else
+                    {
+                        float const step = (action == 3) ? 0.3f : 12.0f;
+                        position.X += step * (static_cast<float>(m_random() % 2001) / 1000.0f - 1.0f);
+                        position.Y += step * (static_cast<float>(m_random() % 2001) / 1000.0f - 1.0f);
+                    }
+                    m_pointers.SetPosition(index, position);
+                    if (m_pointers.IsPressed(index) && (m_pointers.Type(index) == PointerDeviceKind::Pen))
+                    {
+                        m_strokes.Append(id, { position.X, position.Y, m_time, 0.2f + 0.8f * static_cast<float>(m_random() % 100) / 100.0f });
+                    }
+                }
+            }
+
+            m_time += 16667;
+            return m_ink.Update(m_strokes, inkChanged);
+        }
+
+    private:
+        Point RandomPosition()
+        {
+            // A margin beyond the surface, so indicators straddle the edges
+            return { static_cast<float>(m_random() % (Width + 60)) - 30.0f + 0.25f * static_cast<float>(m_random() % 4),
+                static_cast<float>(m_random() % (Height + 60)) - 30.0f + 0.25f * static_cast<float>(m_random() % 4) };
+        }
+
+        std::mt19937 m_random;
+        PointerTable m_pointers;
+        StrokeStore m_strokes;
+        StrokeTessellator m_ink;
+        uint64_t m_time{ 0 };
+    };
+
+    // Renders a simulated session into a flip-model chain of buffers through
+    // the tracker's repaint region and compares every frame against a full
+    // redraw. Also checks that every pixel that changed between consecutive
+    // frames is inside the damage reported to the compositor.
+    void CheckSession(Path path, uint32_t seed, size_t frames, std::vector<size_t> const& bufferCounts)
+    {
+        Simulation simulation{ seed };
+        DamageTracker tracker;
+        tracker.Resize(Width, Height);
+        IndicatorBatch batch;
+        CursorAtlas atlas{ PointerScene::CursorStyle(PixelFormat::Bgra8) };
+        atlas.Build(1.0f);
+        std::vector<SpriteInstance> sprites;
+
+        DamageRegion const full{ {}, true };
+        auto const draw = [&](SoftwareRenderBackend& backend, DamageRegion const& region)
+        {
+            switch (path)
+            {
+            case Path::Plain:
+                PointerScene::Draw(backend, simulation.Pointers(), region, &simulation.Ink());
+                break;
+            case Path::Batched:
+                PointerScene::DrawBatched(backend, simulation.Pointers(), region, batch, &simulation.Ink());
+                break;
+            case Path::Cursors:
+                PointerScene::DrawCursors(backend, simulation.Pointers(), region, atlas, sprites, &simulation.Ink());
+                break;
+            }
+        };
+
+        SoftwareRenderBackend reference(Width, Height);
+        SoftwareRenderBackend previousReference(Width, Height);
+        std::vector<SoftwareRenderBackend> buffers;
+        size_t frame = 0;
+        size_t mismatchedFrames = 0;
+        size_t underReportedFrames = 0;
+        size_t partialFrames = 0;
+        for (size_t bufferCount : bufferCounts)
+        {
+            // A new buffer count reallocates the chain
+            tracker.SetBufferCount(bufferCount);
+            buffers.assign(bufferCount, SoftwareRenderBackend(Width, Height));
+            for (auto& buffer : buffers)
+            {
+                buffer.Clear(Garbage, { 0, 0, Width, Height });
+            }
+
+            for (size_t i = 0; i < frames; ++i, ++frame)
+            {
+                Rect inkChanged;
+                if (simulation.Step(inkChanged))
+                {
+                    tracker.AddDamage(inkChanged);
+                }
+
+                auto const& repaint = tracker.Update(simulation.Pointers());
+                partialFrames += repaint.Full ? 0 : 1;
+                auto& buffer = buffers[frame % bufferCount];
+                draw(buffer, repaint);
+
+                std::swap(reference, previousReference);
+                draw(reference, full);
+
+                bool same = true;
+                bool reported = true;
+                for (uint32_t y = 0; y < static_cast<uint32_t>(Height); ++y)
+                {
+                    for (uint32_t x = 0; x < static_cast<uint32_t>(Width); ++x)
+                    {
+                        same = same && (buffer.PixelAt(x, y) == reference.PixelAt(x, y));
+                        if ((i > 0) && (reference.PixelAt(x, y) != previousReference.PixelAt(x, y)))
+                        {
+                            reported = reported && Contains(tracker.FrameDamage(), static_cast<int32_t>(x), static_cast<int32_t>(y));
+                        }
+                    }
+                }
+
+                mismatchedFrames += same ? 0 : 1;
+                underReportedFrames += reported ? 0 : 1;
+            }
+        }
+
+        CHECK(mismatchedFrames == 0);
+        CHECK(underReportedFrames == 0);
+
+        // Otherwise the check proves little
+        CHECK(partialFrames > frame / 2);
+    }
+}
+
+TEST_CASE(PartialRedrawMatchesFullRedraw)
+{
+    CheckSession(Path::Plain, 1, 300, { 2, 3, 1 });
+}
+
+TEST_CASE(BatchedPartialRedrawMatchesFullRedraw)
+{
+    CheckSession(Path::Batched, 2, 300, { 3, 1, 2 });
+}
+
+TEST_CASE(CursorPartialRedrawMatchesFullRedraw)
+{
+    CheckSession(Path::Cursors, 3, 300, { 1, 2, 3 });
+}
+
+TEST_CASE(FirstFrameAndInvalidationsAreFull)
+{
+    DamageTracker tracker;
+    tracker.Resize(Width, Height);
+    PointerTable pointers;
+
+    // With two buffers a full frame is repainted twice, once into each
+    CHECK(tracker.Update(pointers).Full);
+    CHECK(tracker.Update(pointers).Full);
+    CHECK(tracker.FrameDamage().IsEmpty());
+    CHECK(tracker.Update(pointers).IsEmpty());
+
+    tracker.InvalidateAll();
+    CHECK(tracker.Update(pointers).Full);
+    CHECK(tracker.Update(pointers).Full);
+    CHECK(tracker.Update(pointers).IsEmpty());
+
+    tracker.Resize(Width / 2, Height);
+    CHECK(tracker.Update(pointers).Full);
+}
+
+TEST_CASE(MoveDamagesBothPositionsAndRepaintsOlderBuffers)
+{
+    DamageTracker::Options options;
+    options.BufferCount = 2;
+    options.MergeDistance = 0;
+    DamageTracker tracker{ options };
+    tracker.Resize(Width, Height);
+
+    PointerTable pointers;
+    pointers.Insert(1, PointerDeviceKind::Touch, false, { 50.0f, 50.0f });
+    tracker.Update(pointers);
+    tracker.Update(pointers);
+    CHECK(tracker.Update(pointers).IsEmpty());
+
+    pointers.SetPosition(0, { 150.0f, 120.0f });
+    auto const& moved = tracker.Update(pointers);
+    CHECK(!moved.Full);
+    CHECK(Contains(moved, 50, 50));
+    CHECK(Contains(moved, 150, 120));
+    CHECK(!Contains(moved, 100, 85));
+
+    // The other buffer still has the old frame: it needs this move too
+    pointers.SetPosition(0, { 151.0f, 120.0f });
+    auto const& next = tracker.Update(pointers);
+    CHECK(Contains(next, 50, 50));
+    CHECK(Contains(next, 171, 120));
+    CHECK(!Contains(tracker.FrameDamage(), 50, 50));
+}
@@ -0,0 +1,240 @@
+#include "FrameGovernor.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <random>
+
+using namespace PointerCore;
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Effects = FrameGovernor::EffectsLevel;
+    using Settings = FrameGovernor::Settings;
+    using Duration = FrameGovernor::Duration;
+
+    // What a frame costs under the given settings: less with fewer effects,
+    // a little less with CPU and GPU overlapping
+    Duration Cost(Settings const& settings, double fullCostMs)
+    {
+        double const effects[] = { 0.5, 0.7, 1.0 };
+        double const overlap = (settings.MaxFrameLatency > 1) ? 0.85 : 1.0;
+        double const ms = fullCostMs * effects[static_cast<uint32_t>(settings.Effects)] * overlap;
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+
+    // Runs frames whose full-quality cost follows the curve, returning how
+    // many went over their budget
+    template <typename Curve>
+    int Run(FrameGovernor& governor, int frames, Curve const& fullCostMs, int firstFrame = 0)
+    {
+        int over = 0;
+        for (int frame = firstFrame; frame < firstFrame + frames; ++frame)
+        {
+            Duration const cost = Cost(governor.CurrentSettings(), fullCostMs(frame));
+            over += (cost > governor.Budget(governor.Rung())) ? 1 : 0;
+            governor.OnFrame(cost);
+        }
+        return over;
+    }
+}
+
+TEST_CASE(LadderGoesEffectsThenLatencyThenInterval)
+{
+    FrameGovernor governor;
+    REQUIRE(governor.RungCount() == 5);
+    CHECK((governor.RungSettings(0) == Settings{ 1, 1, Effects::Full }));
+    CHECK((governor.RungSettings(1) == Settings{ 1, 1, Effects::Reduced }));
+    CHECK((governor.RungSettings(2) == Settings{ 1, 1, Effects::Minimal }));
+    CHECK((governor.RungSettings(3) == Settings{ 2, 1, Effects::Minimal }));
+    CHECK((governor.RungSettings(4) == Settings{ 2, 2, Effects::Minimal }));
+    CHECK(governor.Budget(3) == 16667us);
+    CHECK(governor.Budget(4) == 33334us);
+
+    // Ranges that are empty, or the wrong way round
+    FrameGovernor::Options options;
+    options.MinFrameLatency = 3;
+    options.MaxFrameLatency = 1;
+    options.MaxPresentInterval = 0;
+    options.MinPresentInterval = 1;
+    governor.SetOptions(options);
+    REQUIRE(governor.RungCount() == 3);
+    CHECK((governor.RungSettings(2) == Settings{ 3, 1, Effects::Minimal }));
+}
+
+TEST_CASE(CheapFramesChangeNothing)
+{
+    FrameGovernor governor;
+    CHECK(Run(governor, 10000, [](int) { return 10.0; }) == 0);
+    CHECK(governor.Rung() == 0);
+    CHECK(governor.Changes() == 0);
+}
+
+TEST_CASE(HitchesNeedToAddUp)
+{
+    // Four slow frames in any 30 are tolerated, a fifth steps down
+    FrameGovernor governor;
+    auto const hitches = [](int every) { return [every](int frame) { return (frame % every == 0) ? 40.0 : 8.0; }; };
+    Run(governor, 3000, hitches(8));
+    CHECK(governor.Rung() == 0);
+
+    Run(governor, 30, hitches(6));
+    CHECK(governor.Rung() == 1);
+    CHECK(governor.Changes() == 1);
+
+    // The frames right after a change don't count
+    FrameGovernor::Options options;
+    options.SettleFrames = 10;
+    options.SlowFrames = 1;
+    governor.SetOptions(options);
+    governor.Reset();
+    governor.OnFrame(40ms);
+    CHECK(governor.Rung() == 1);
+    for (int i = 0; i < 10; ++i)
+    {
+        governor.OnFrame(40ms);
+    }
+    CHECK(governor.Rung() == 1);
+    governor.OnFrame(40ms);
+    CHECK(governor.Rung() == 2);
+}
+
+TEST_CASE(StepsDownToTheBottomAndBackUp)
+{
+    FrameGovernor governor;
+    Run(governor, 1000, [](int) { return 60.0; });
+    CHECK(governor.Rung() == 4);
+    CHECK(governor.Changes() == 4);
+
+    // Fast frames for the rung above, but one that isn't restarts the count
+    FrameGovernor::Options const& options = governor.GetOptions();
+    for (uint32_t i = 0; i + 1 < options.ImproveFrames; ++i)
+    {
+        CHECK(!governor.OnFrame(5ms));
+    }
+    CHECK(!governor.OnFrame(12ms));
+    for (uint32_t i = 0; i + 1 < options.ImproveFrames; ++i)
+    {
+        governor.OnFrame(5ms);
+    }
+    CHECK(governor.Rung() == 4);
+    CHECK(governor.OnFrame(5ms));
+    CHECK(governor.Rung() == 3);
+
+    // All the way up once the load is gone
+    Run(governor, 2000, [](int) { return 5.0; });
+    CHECK(governor.Rung() == 0);
+
+    governor.SetOptions(governor.GetOptions());
+    CHECK(governor.Rung() == 0);
+    Run(governor, 100, [](int) { return 60.0; });
+    size_t const rung = governor.Rung();
+    CHECK(rung > 0);
+
+    // Options that keep the current settings keep the rung
+    FrameGovernor::Options wider = governor.GetOptions();
+    wider.MaxPresentInterval = 4;
+    governor.SetOptions(wider);
+    CHECK(governor.Rung() == rung);
+    governor.Reset();
+    CHECK(governor.Rung() == 0);
+}
+
+TEST_CASE(SmoothCostsDontOscillate)
+{
+    // Full effects at 19 ms are too slow, reduced at 13.3 ms isn't fast
+    // enough to try full again: one step down and it stays there
+    FrameGovernor governor;
+    Run(governor, 60 * 60, [](int) { return 19.0; });
+    CHECK(governor.Rung() == 1);
+    CHECK(governor.Changes() == 1);
+}
+
+TEST_CASE(BoundaryCostBacksOff)
+{
+    // Full effects cost 20 ms and reduced 8 ms: reduced is fast enough to
+    // try full again, full is too slow to keep. Each failed try doubles the
+    // wait, so the governor flips ever more rarely.
+    FrameGovernor governor;
+    int over = 0;
+    auto const frames = [&](int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Duration const cost = (governor.Rung() == 0) ? Duration{ 20ms } : Duration{ 8ms };
+            over += (cost > governor.Budget(governor.Rung())) ? 1 : 0;
+            governor.OnFrame(cost);
+        }
+    };
+    frames(60 * 60);
+    uint64_t const firstMinute = governor.Changes();
+    CHECK(firstMinute >= 6);
+    CHECK(firstMinute <= 12);
+    frames(60 * 60 * 10);
+    uint64_t const nextTenMinutes = governor.Changes() - firstMinute;
+
+    // The wait is capped at 1440 frames, so about one try every 24 seconds
+    CHECK(nextTenMinutes <= 2 * (60 * 60 * 10 / 1440 + 1));
+    CHECK(over < 60 * 60 * 11 / 100);
+    CHECK(governor.Rung() <= 1);
+
+    // Probation expires: a rung that held for long enough is tried at the
+    // normal pace again
+    FrameGovernor::Options options;
+    options.ProbationFrames = 50;
+    governor.SetOptions(options);
+    governor.Reset();
+    Run(governor, 100, [](int) { return 30.0; });
+    CHECK(governor.Rung() == 2);
+    Run(governor, 91, [](int) { return 5.0; });
+    CHECK(governor.Rung() == 1);
+    Run(governor, 60, [](int) { return 5.0; });
+    CHECK(governor.Rung() == 1);
+    Run(governor, 30, [](int) { return 30.0; });
+    CHECK(governor.Rung() == 2);
+    Run(governor, 90, [](int) { return 5.0; });
+    CHECK(governor.Rung() == 1);
+}
+
+TEST_CASE(SyntheticCostCurves)
+{
+    // A device that gets gradually busier and then recovers, with noise and
+    // the odd hitch. The governor should keep nearly every frame in budget
+    // without changing settings much more often than the load does.
+    std::mt19937 random(7);
+    std::normal_distribution<double> noise(0.0, 0.6);
+    std::vector<double> curve;
+    for (int frame = 0; frame < 60 * 120; ++frame)
+    {
+        double const phase = static_cast<double>(frame) / (60.0 * 120.0);
+        double const load = 8.0 + 36.0 * std::sin(phase * 3.14159265);
+        curve.push_back(std::max(1.0, load + noise(random) + ((frame % 500 == 0) ? 30.0 : 0.0)));
+    }
+
+    FrameGovernor governor;
+    size_t lowest = 0;
+    int over = 0;
+    for (int frame = 0; frame < static_cast<int>(curve.size()); ++frame)
+    {
+        Duration const cost = Cost(governor.CurrentSettings(), curve[static_cast<size_t>(frame)]);
+        over += (cost > governor.Budget(governor.Rung())) ? 1 : 0;
+        governor.OnFrame(cost);
+        lowest = std::max(lowest, governor.Rung());
+    }
+
+    // Full cost peaks at 44 ms, which only the bottom rung's 33 ms budget
+    // and cheaper frames can take
+    CHECK(lowest == 4);
+    CHECK(governor.Rung() == 0);
+    CHECK(over < static_cast<int>(curve.size()) / 50);
+    CHECK(governor.Changes() < 40);
+
+    // Without the governor
+    FrameGovernor fixed;
+    int fixedOver = 0;
+    for (double fullCost : curve)
+    {
+        fixedOver += (Cost(fixed.RungSettings(0), fullCost) > fixed.Budget(0)) ? 1 : 0;
+    }
+    CHECK(fixedOver > 10 * over);
+}
@@ -0,0 +1,222 @@
+#include "FrameTimeline.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace PointerCore;
+
+namespace
+{
+    char const* const Names[] = { "Alpha", "Beta", "Gamma", "Delta", "Epsilon" };
+
+    // Spans whose fields all follow from their sequence number, so a span
+    // mixing two writes is easy to spot
+    void RecordNumbered(FrameTimeline& timeline, uint64_t thread, uint64_t sequence)
+    {
+        uint64_t const start = thread * 1000000000 + sequence * 10 + 1;
+        timeline.Record(Names[sequence % 5], start, start + sequence % 7);
+    }
+
+    bool IsNumbered(TimelineEvent const& event)
+    {
+        uint64_t const sequence = (event.Start % 1000000000 - 1) / 10;
+        return (event.Name == Names[sequence % 5]) && (event.End == event.Start + sequence % 7);
+    }
+}
+
+TEST_CASE(RecordsOnlyWhileEnabled)
+{
+    FrameTimeline timeline(100);
+    CHECK(timeline.RingCapacity() == 128);
+    CHECK(!timeline.IsEnabled());
+
+    timeline.Record("Off", 1, 2);
+    {
+        TimelineSpan span{ timeline, "Off" };
+    }
+    CHECK(timeline.ThreadCount() == 0);
+
+    timeline.SetEnabled(true);
+    timeline.Record("Frame", 100, 250);
+    {
+        TimelineSpan span{ timeline, "Scoped" };
+        span.End();
+        span.End();
+    }
+
+    // A span started while disabled stays unrecorded
+    timeline.SetEnabled(false);
+    TimelineSpan late{ timeline, "Late" };
+    timeline.SetEnabled(true);
+    late.End();
+
+    std::vector<TimelineEvent> events;
+    timeline.Collect(events);
+    REQUIRE(events.size() == 2);
+    CHECK(std::string(events[0].Name) == "Frame");
+    CHECK(events[0].Start == 100);
+    CHECK(events[0].End == 250);
+    CHECK(events[0].ThreadId == 1);
+    CHECK(std::string(events[1].Name) == "Scoped");
+    CHECK(events[1].Start <= events[1].End);
+    CHECK(events[1].End <= FrameTimeline::Now());
+    CHECK(timeline.ThreadCount() == 1);
+}
+
+TEST_CASE(RingsKeepTheNewestSpans)
+{
+    FrameTimeline timeline(16);
+    timeline.SetEnabled(true);
+    for (uint64_t i = 0; i < 40; ++i)
+    {
+        RecordNumbered(timeline, 0, i);
+    }
+
+    // The oldest span's slot is the next one written, so once a ring has
+    // wrapped Collect() can't trust it
+    std::vector<TimelineEvent> events;
+    timeline.Collect(events);
+    REQUIRE(events.size() == 15);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        CHECK(events[i].Start == (25 + i) * 10 + 1);
+        CHECK(IsNumbered(events[i]));
+    }
+
+    // Clear forgets them, later spans are kept
+    timeline.Clear();
+    events.clear();
+    timeline.Collect(events);
+    CHECK(events.empty());
+    RecordNumbered(timeline, 0, 40);
+    timeline.Collect(events);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].Start == 401);
+}
+
+TEST_CASE(ThreadsGetTheirOwnTracks)
+{
+    FrameTimeline timeline;
+    timeline.SetEnabled(true);
+
+    // Named before and after the first span
+    timeline.NameThread("Main");
+    timeline.Record("MainSpan", 10, 20);
+    std::thread worker([&]
+    {
+        timeline.Record("WorkerSpan", 15, 30);
+        timeline.NameThread("Worker \"1\"");
+    });
+    worker.join();
+    std::thread silent([&] { timeline.NameThread("Silent"); });
+    silent.join();
+    CHECK(timeline.ThreadCount() == 2);
+
+    std::vector<TimelineEvent> events;
+    timeline.Collect(events);
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].ThreadId != events[1].ThreadId);
+
+    // A second timeline on the same thread is separate
+    FrameTimeline other;
+    other.SetEnabled(true);
+    other.Record("Other", 1, 2);
+    timeline.Record("MainAgain", 40, 41);
+    events.clear();
+    other.Collect(events);
+    CHECK(events.size() == 1);
+    events.clear();
+    timeline.Collect(events);
+    CHECK(events.size() == 3);
+}
+
+TEST_CASE(WritesChromeTrace)
+{
+    FrameTimeline timeline;
+    timeline.SetEnabled(true);
+    timeline.NameThread("Render");
+    timeline.Record("Present", 5000, 5000);
+    timeline.Record("Ren\\der\n\"x\"", 1000, 3500);
+    timeline.Record("Backwards", 9000, 8000);
+
+    std::ostringstream out;
+    timeline.WriteChromeTrace(out);
+    std::string const trace = out.str();
+    CHECK(trace.find("\"displayTimeUnit\": \"ns\"") != std::string::npos);
+    CHECK(trace.find("{ \"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": 1, \"args\": { \"name\": \"Render\" } }") != std::string::npos);
+
+    // Times in microseconds from the earliest span, names escaped
+    CHECK(trace.find("{ \"ph\": \"X\", \"name\": \"Present\", \"pid\": 1, \"tid\": 1, \"ts\": 4.000, \"dur\": 0.000 }") != std::string::npos);
+    CHECK(trace.find("\"name\": \"Ren\\\\der\\\"x\\\"\", \"pid\": 1, \"tid\": 1, \"ts\": 0.000, \"dur\": 2.500 }") != std::string::npos);
+    CHECK(trace.find("\"name\": \"Backwards\", \"pid\": 1, \"tid\": 1, \"ts\": 8.000, \"dur\": 0.000 }") != std::string::npos);
+    CHECK(std::count(trace.begin(), trace.end(), '{') == std::count(trace.begin(), trace.end(), '}'));
+    std::string const ending = " }\n  ]\n}\n";
+    CHECK(trace.compare(trace.size() - ending.size(), ending.size(), ending) == 0);
+
+    // Nothing recorded is still a valid trace
+    FrameTimeline empty;
+    std::ostringstream emptyOut;
+    empty.WriteChromeTrace(emptyOut);
+    CHECK(emptyOut.str() == "{\n  \"displayTimeUnit\": \"ns\",\n  \"traceEvents\": [\n  ]\n}\n");
+}
+
+TEST_CASE(CollectWhileThreadsRecord)
+{
+    // Four threads wrapping small rings as fast as they can while another
+    // collects over and over. Nothing collected may be a mix of two spans,
+    // and each thread's spans come out in order.
+    FrameTimeline timeline(64);
+    timeline.SetEnabled(true);
+    std::atomic<int> running{ 4 };
+    std::vector<std::thread> writers;
+    for (uint64_t t = 1; t <= 4; ++t)
+    {
+        writers.emplace_back([&timeline, &running, t]
+        {
+            for (uint64_t i = 0; i < 200000; ++i)
+            {
+                RecordNumbered(timeline, t, i);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    bool consistent = true;
+    size_t collected = 0;
+    std::vector<TimelineEvent> events;
+    auto const check = [&]
+    {
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            consistent = consistent && IsNumbered(events[i]);
+            if ((i > 0) && (events[i].ThreadId == events[i - 1].ThreadId))
+            {
+                consistent = consistent && (events[i].Start > events[i - 1].Start);
+            }
+        }
+        collected += events.size();
+    };
+
+    while (running.load(std::memory_order_acquire) > 0)
+    {
+        events.clear();
+        timeline.Collect(events);
+        check();
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    // Each thread's last spans are all there once it stops
+    events.clear();
+    timeline.Collect(events);
+    check();
+    CHECK(events.size() == 4 * 63);
+    CHECK(consistent);
+    CHECK(collected > 0);
+    CHECK(timeline.ThreadCount() == 4);
+}
@@ -0,0 +1,297 @@
+#include "GestureRecognizer.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace PointerCore;
+
+namespace
+{
+    PointerEvent Event(PointerEventKind kind, uint32_t id, float x, float y, uint64_t timestamp = 0)
+    {
+        bool const inContact = (kind == PointerEventKind::Pressed) || (kind == PointerEventKind::Moved);
+        return { timestamp, 0, id, x, y, inContact ? 0.5f : 0.0f, kind, PointerDeviceKind::Touch, inContact };
+    }
+
+    // Where the frame's transform takes a point
+    Point Apply(GestureFrame const& frame, Point p)
+    {
+        float const c = std::cos(frame.Rotation);
+        float const s = std::sin(frame.Rotation);
+        float const x = p.X - frame.Origin.X;
+        float const y = p.Y - frame.Origin.Y;
+        return {
+            frame.Origin.X + frame.Translation.X + frame.Scale * (c * x - s * y),
+            frame.Origin.Y + frame.Translation.Y + frame.Scale * (s * x + c * y) };
+    }
+}
+
+TEST_CASE(OneFingerPan)
+{
+    GestureRecognizer recognizer;
+    GestureFrame frame;
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 100.0f, 100.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 105.0f, 100.0f));
+    recognizer.Flush(frame);
+    CHECK(!frame.Active);
+    CHECK(frame.ContactCount == 1);
+
+    // Past the slop: the first frame covers everything since the press
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 115.0f, 100.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 120.0f, 104.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Active && frame.Started && !frame.Ended);
+    CHECK(recognizer.IsManipulating());
+    CHECK_NEAR(frame.Origin.X, 100.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.X, 20.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.Y, 4.0f, 1e-4f);
+    CHECK_NEAR(frame.Scale, 1.0f, 1e-6f);
+    CHECK_NEAR(frame.Rotation, 0.0f, 1e-6f);
+
+    // Nothing moved
+    recognizer.Flush(frame);
+    CHECK(frame.Active && !frame.Started);
+    CHECK_NEAR(frame.Origin.X, 120.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.X, 0.0f, 1e-4f);
+
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 110.0f, 104.0f));
+    recognizer.Process(Event(PointerEventKind::Released, 1, 108.0f, 104.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Active && frame.Ended);
+    CHECK(frame.ContactCount == 0);
+    CHECK_NEAR(frame.Translation.X, -12.0f, 1e-4f);
+    CHECK(frame.Taps.empty());
+
+    recognizer.Flush(frame);
+    CHECK(!frame.Active);
+}
+
+TEST_CASE(PinchAndRotate)
+{
+    // Two contacts spread to twice the distance and turn a quarter
+    GestureRecognizer recognizer;
+    GestureFrame frame;
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 90.0f, 100.0f));
+    recognizer.Process(Event(PointerEventKind::Pressed, 2, 110.0f, 100.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 100.0f, 80.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 2, 100.0f, 120.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Started);
+    CHECK_NEAR(frame.Origin.X, 90.0f, 1e-4f);
+    CHECK_NEAR(frame.Scale, 2.0f, 1e-5f);
+    CHECK_NEAR(frame.Rotation, 1.5707963f, 1e-5f);
+    Point const moved = Apply(frame, { 110.0f, 100.0f });
+    CHECK_NEAR(moved.X, 100.0f, 1e-3f);
+    CHECK_NEAR(moved.Y, 120.0f, 1e-3f);
+
+    // Contacts closer than MinSpread only pan
+    GestureRecognizer close;
+    close.Process(Event(PointerEventKind::Pressed, 1, 100.0f, 100.0f));
+    close.Process(Event(PointerEventKind::Pressed, 2, 104.0f, 100.0f));
+    close.Process(Event(PointerEventKind::Moved, 1, 120.0f, 90.0f));
+    close.Process(Event(PointerEventKind::Moved, 2, 130.0f, 110.0f));
+    close.Flush(frame);
+    CHECK(frame.Started);
+    CHECK_NEAR(frame.Scale, 1.0f, 1e-6f);
+    CHECK_NEAR(frame.Rotation, 0.0f, 1e-6f);
+    CHECK_NEAR(frame.Translation.X, 23.0f, 1e-4f);
+}
+
+TEST_CASE(Taps)
+{
+    GestureRecognizer recognizer;
+    GestureFrame frame;
+
+    // Two fingers that wobble within the slop
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 100.0f, 100.0f, 1000));
+    recognizer.Process(Event(PointerEventKind::Pressed, 2, 200.0f, 100.0f, 20000));
+    recognizer.Process(Event(PointerEventKind::Moved, 2, 205.0f, 104.0f, 30000));
+    recognizer.Process(Event(PointerEventKind::Released, 1, 101.0f, 100.0f, 90000));
+    recognizer.Process(Event(PointerEventKind::Released, 2, 205.0f, 104.0f, 100000));
+
+    // Then one more in the same frame
+    recognizer.Process(Event(PointerEventKind::Pressed, 3, 50.0f, 60.0f, 200000));
+    recognizer.Process(Event(PointerEventKind::Exited, 3, 50.0f, 60.0f, 250000));
+    recognizer.Flush(frame);
+    CHECK(!frame.Active);
+    REQUIRE(frame.Taps.size() == 2);
+    CHECK(frame.Taps[0].ContactCount == 2);
+    CHECK_NEAR(frame.Taps[0].Position.X, 150.0f, 1e-4f);
+    CHECK(frame.Taps[0].Timestamp == 100000);
+    CHECK(frame.Taps[1].ContactCount == 1);
+    CHECK_NEAR(frame.Taps[1].Position.Y, 60.0f, 1e-4f);
+
+    recognizer.Flush(frame);
+    CHECK(frame.Taps.empty());
+
+    // Held too long, or moved too far
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 100.0f, 100.0f, 1000000));
+    recognizer.Process(Event(PointerEventKind::Released, 1, 100.0f, 100.0f, 1400000));
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 100.0f, 100.0f, 2000000));
+    recognizer.Process(Event(PointerEventKind::Released, 1, 100.0f, 111.0f, 2010000));
+    recognizer.Flush(frame);
+    CHECK(frame.Taps.empty());
+    CHECK(frame.Started && frame.Ended);
+    CHECK_NEAR(frame.Translation.Y, 11.0f, 1e-4f);
+
+    // Events for pointers that aren't down are ignored
+    recognizer.Process(Event(PointerEventKind::Moved, 7, 0.0f, 0.0f));
+    recognizer.Process(Event(PointerEventKind::Released, 7, 0.0f, 0.0f));
+    CHECK(recognizer.ContactCount() == 0);
+}
+
+TEST_CASE(NewSessionInTheFrameAManipulationEnds)
+{
+    // A pan ends, and another finger lands and wobbles in the same frame. The
+    // frame reports the pan, and the new finger's manipulation reports only
+    // its own motion when it starts, not the pan over again.
+    GestureRecognizer recognizer;
+    GestureFrame frame;
+    recognizer.Process(Event(PointerEventKind::Pressed, 1, 0.0f, 0.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 50.0f, 0.0f));
+    recognizer.Flush(frame);
+    recognizer.Process(Event(PointerEventKind::Moved, 1, 100.0f, 0.0f));
+    recognizer.Process(Event(PointerEventKind::Released, 1, 100.0f, 0.0f));
+    recognizer.Process(Event(PointerEventKind::Pressed, 2, 500.0f, 500.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 2, 500.0f, 502.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Ended && !frame.Started);
+    CHECK(frame.ContactCount == 1);
+    CHECK_NEAR(frame.Origin.X, 50.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.X, 50.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.Y, 0.0f, 1e-4f);
+
+    recognizer.Process(Event(PointerEventKind::Moved, 2, 500.0f, 530.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Started && !frame.Ended);
+    CHECK_NEAR(frame.Origin.X, 500.0f, 1e-4f);
+    CHECK_NEAR(frame.Origin.Y, 500.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.X, 0.0f, 1e-4f);
+    CHECK_NEAR(frame.Translation.Y, 30.0f, 1e-4f);
+
+    // And when both happen in one frame, the frame carries both motions
+    recognizer.Process(Event(PointerEventKind::Released, 2, 500.0f, 540.0f));
+    recognizer.Process(Event(PointerEventKind::Pressed, 3, 0.0f, 0.0f));
+    recognizer.Process(Event(PointerEventKind::Moved, 3, 20.0f, 0.0f));
+    recognizer.Flush(frame);
+    CHECK(frame.Started && frame.Ended);
+    Point const moved = Apply(frame, { 123.0f, 45.0f });
+    CHECK_NEAR(moved.X, 143.0f, 1e-3f);
+    CHECK_NEAR(moved.Y, 55.0f, 1e-3f);
+
+    recognizer.Clear();
+    CHECK(recognizer.ContactCount() == 0);
+    recognizer.Flush(frame);
+    CHECK(!frame.Active);
+}
+
+TEST_CASE(RecoversSimilarityMotionAsContactsComeAndGo)
+{
+    // Contacts riding on a rigid sheet that pans, turns and scales, with
+    // fingers landing and lifting between its steps. Applying each frame to where
+    // a contact was at the start of the frame must land on where it is now.
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float angle = 0.0f;
+    float scale = 1.0f;
+    auto const place = [&](Point sheet) -> Point
+    {
+        float const c = std::cos(angle);
+        float const s = std::sin(angle);
+        return { 960.0f + offsetX + scale * (c * sheet.X - s * sheet.Y), 540.0f + offsetY + scale * (s * sheet.X + c * sheet.Y) };
+    };
+
+    struct Finger
+    {
+        bool Down;
+        Point Sheet;
+        Point FrameStart;
+    };
+    Finger fingers[16]{};
+
+    // Fingers that land close together would only be fitted a translation
+    GestureRecognizer::Options options;
+    options.MinSpread = 0.0f;
+    GestureRecognizer recognizer(options);
+    GestureFrame frame;
+    double worst = 0.0;
+    int frames = 0;
+    int manipulating = 0;
+    for (int f = 0; f < 2000; ++f)
+    {
+        for (auto& finger : fingers)
+        {
+            finger.FrameStart = place(finger.Sheet);
+        }
+        bool stayed[16];
+        for (size_t i = 0; i < 16; ++i)
+        {
+            stayed[i] = fingers[i].Down;
+        }
+
+        for (int step = 0; step < 8; ++step)
+        {
+            offsetX += unit(random) * 4.0f - 2.0f;
+            offsetY += unit(random) * 4.0f - 2.0f;
+            angle += unit(random) * 0.02f - 0.01f;
+            scale = std::clamp(scale * (0.99f + unit(random) * 0.02f), 0.5f, 2.0f);
+
+            // Every finger on the sheet moves with it, then some land or lift.
+            // A finger lifting where it lands is a tap, and skipped.
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                if (fingers[i].Down)
+                {
+                    Point const p = place(fingers[i].Sheet);
+                    recognizer.Process(Event(PointerEventKind::Moved, i, p.X, p.Y));
+                }
+            }
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                auto& finger = fingers[i];
+                if (!finger.Down && (unit(random) < 0.01f))
+                {
+                    finger.Down = true;
+                    finger.Sheet = { unit(random) * 400.0f - 200.0f, unit(random) * 400.0f - 200.0f };
+                    Point const p = place(finger.Sheet);
+                    recognizer.Process(Event(PointerEventKind::Pressed, i, p.X, p.Y));
+                    stayed[i] = false;
+                }
+                else if (finger.Down && (unit(random) < 0.005f))
+                {
+                    finger.Down = false;
+                    Point const p = place(finger.Sheet);
+                    recognizer.Process(Event(PointerEventKind::Released, i, p.X, p.Y));
+                    stayed[i] = false;
+                }
+            }
+        }
+
+        recognizer.Flush(frame);
+        if (!frame.Active || frame.Started || frame.Ended)
+        {
+            continue;
+        }
+
+        ++manipulating;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            if (stayed[i])
+            {
+                Point const mapped = Apply(frame, fingers[i].FrameStart);
+                Point const actual = place(fingers[i].Sheet);
+                worst = std::max(worst, static_cast<double>(std::hypot(mapped.X - actual.X, mapped.Y - actual.Y)));
+                ++frames;
+            }
+        }
+    }
+
+    CHECK(manipulating > 1000);
+    CHECK(frames > 5000);
+    CHECK(worst < 0.01);
+}
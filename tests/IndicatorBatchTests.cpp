@@ -0,0 +1,144 @@
+#include "IndicatorBatch.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+#include "TestHarness.h"
+
+#include <cstring>
+#include <random>
+
+using namespace PointerCore;
+
+namespace
+{
+    constexpr IndicatorStyle TestStyle{ 5.0f, { 0.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 0.5f, 0.0f, 1.0f } };
+
+    bool SameColor(Color const& a, Color const& b)
+    {
+        return std::memcmp(&a, &b, sizeof(Color)) == 0;
+    }
+
+    bool SameRect(Rect const& a, Rect const& b)
+    {
+        return std::memcmp(&a, &b, sizeof(Rect)) == 0;
+    }
+
+    // Table of count pointers scattered over a 400x300 area, some of them pressed
+    void Fill(PointerTable& table, size_t count, std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> x(-20.0f, 420.0f);
+        std::uniform_real_distribution<float> y(-20.0f, 320.0f);
+        table.Clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            table.Insert(static_cast<uint32_t>(i + 1), PointerDeviceKind::Touch, (random() % 3) == 0, { x(random), y(random) });
+        }
+    }
+
+    // What the batch must hold: table order, skipping what doesn't reach into bounds
+    void CheckAgainstTable(IndicatorBatch const& batch, PointerTable const& table, Rect const* bounds)
+    {
+        size_t next = 0;
+        for (size_t i = 0; i < table.Size(); ++i)
+        {
+            Point const p = table.Position(i);
+            Rect const rect{ p.X - TestStyle.HalfSize, p.Y - TestStyle.HalfSize, p.X + TestStyle.HalfSize, p.Y + TestStyle.HalfSize };
+            if ((bounds != nullptr) &&
+                !((rect.Right > bounds->Left) && (rect.Left < bounds->Right) && (rect.Bottom > bounds->Top) && (rect.Top < bounds->Bottom)))
+            {
+                continue;
+            }
+
+            REQUIRE(next < batch.Size());
+            CHECK(SameRect(batch.Rects()[next], rect));
+            CHECK(SameColor(batch.Colors()[next], table.IsPressed(i) ? TestStyle.PressedColor : TestStyle.HoverColor));
+            ++next;
+        }
+
+        CHECK(next == batch.Size());
+    }
+}
+
+TEST_CASE(BuildMatchesTheTable)
+{
+    std::mt19937 random(3);
+    PointerTable table(300);
+    IndicatorBatch batch;
+
+    // Every remainder of the four-wide path, and pressed bits across words
+    for (size_t count : { 0u, 1u, 3u, 4u, 5u, 63u, 64u, 65u, 130u, 300u })
+    {
+        Fill(table, count, random);
+        batch.Build(table, TestStyle);
+        CHECK(batch.Size() == count);
+        CHECK(batch.Empty() == (count == 0));
+        CheckAgainstTable(batch, table, nullptr);
+    }
+}
+
+TEST_CASE(BuildSkipsIndicatorsOutsideBounds)
+{
+    std::mt19937 random(5);
+    PointerTable table(300);
+    IndicatorBatch batch;
+    Rect const bounds[] = { { 100.0f, 50.0f, 180.0f, 120.0f }, { 0.0f, 0.0f, 400.0f, 300.0f }, { 1000.0f, 1000.0f, 1010.0f, 1010.0f } };
+    for (size_t count : { 7u, 64u, 257u })
+    {
+        Fill(table, count, random);
+        for (auto const& clip : bounds)
+        {
+            batch.Build(table, TestStyle, clip);
+            CheckAgainstTable(batch, table, &clip);
+        }
+    }
+
+    // Touching edges don't count, since rectangles are right and bottom exclusive
+    table.Clear();
+    table.Insert(1, PointerDeviceKind::Mouse, false, { 10.0f, 10.0f });
+    batch.Build(table, TestStyle, { 15.0f, 0.0f, 30.0f, 30.0f });
+    CHECK(batch.Empty());
+    batch.Build(table, TestStyle, { 14.5f, 0.0f, 30.0f, 30.0f });
+    CHECK(batch.Size() == 1);
+}
+
+TEST_CASE(RebuildReplacesTheContents)
+{
+    std::mt19937 random(9);
+    PointerTable table(100);
+    IndicatorBatch batch;
+    Fill(table, 100, random);
+    batch.Build(table, TestStyle);
+    CHECK(batch.Size() == 100);
+
+    Fill(table, 6, random);
+    batch.Build(table, TestStyle);
+    CheckAgainstTable(batch, table, nullptr);
+
+    batch.Clear();
+    CHECK(batch.Empty());
+}
+
+TEST_CASE(BatchedSceneMatchesPerPointerDraws)
+{
+    std::mt19937 random(13);
+    PointerTable table(200);
+    Fill(table, 200, random);
+
+    SoftwareRenderBackend expected(400, 300);
+    SoftwareRenderBackend actual(400, 300);
+    IndicatorBatch batch;
+
+    PointerScene::Draw(expected, table);
+    PointerScene::DrawBatched(actual, table, DamageRegion{ {}, true }, batch);
+    CHECK(std::memcmp(expected.Pixels(), actual.Pixels(), 400 * 300 * sizeof(uint32_t)) == 0);
+
+    DamageRegion region{ { { 10, 10, 90, 70 }, { 200, 150, 390, 290 } }, false };
+    PointerScene::Draw(expected, table, region);
+    PointerScene::DrawBatched(actual, table, region, batch);
+    CHECK(std::memcmp(expected.Pixels(), actual.Pixels(), 400 * 300 * sizeof(uint32_t)) == 0);
+}
+
+TEST_CASE(BuildPathIsNamed)
+{
+    char const* name = IndicatorBatch::BuildPathName();
+    CHECK((std::strcmp(name, "sse2") == 0) || (std::strcmp(name, "scalar") == 0));
+}
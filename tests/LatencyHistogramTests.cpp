@@ -0,0 +1,248 @@
+#include "FrameInstrumentation.h"
+#include "LatencyHistogram.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+
+TEST_CASE(BucketsTileTheWholeRange)
+{
+    CHECK(LatencyHistogram::BucketLowerBound(0) == 0);
+    CHECK(LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketCount - 1) == UINT64_MAX);
+    for (size_t bucket = 0; bucket + 1 < LatencyHistogram::BucketCount; ++bucket)
+    {
+        uint64_t const lower = LatencyHistogram::BucketLowerBound(bucket);
+        uint64_t const upper = LatencyHistogram::BucketUpperBound(bucket);
+        REQUIRE(lower <= upper);
+        REQUIRE(LatencyHistogram::BucketLowerBound(bucket + 1) == upper + 1);
+        REQUIRE(LatencyHistogram::BucketIndex(lower) == bucket);
+        REQUIRE(LatencyHistogram::BucketIndex(upper) == bucket);
+    }
+}
+
+TEST_CASE(BucketWidthIsUnderTwoPercent)
+{
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t const value = random() >> (random() % 64);
+        size_t const bucket = LatencyHistogram::BucketIndex(value);
+        uint64_t const lower = LatencyHistogram::BucketLowerBound(bucket);
+        uint64_t const upper = LatencyHistogram::BucketUpperBound(bucket);
+        REQUIRE((value >= lower) && (value <= upper));
+        if (value >= LatencyHistogram::SubBucketCount)
+        {
+            REQUIRE(static_cast<double>(upper - lower) / static_cast<double>(lower) < 0.02);
+        }
+        else
+        {
+            REQUIRE(lower == upper);
+        }
+    }
+}
+
+TEST_CASE(SummaryStatistics)
+{
+    LatencyHistogram histogram;
+    CHECK(histogram.Count() == 0);
+    CHECK(histogram.Min() == 0);
+    CHECK(histogram.Max() == 0);
+    CHECK(histogram.Mean() == 0.0);
+    CHECK(histogram.ValueAtPercentile(50.0) == 0);
+
+    for (uint64_t value : { 10u, 20u, 30u, 40u })
+    {
+        histogram.Record(value);
+    }
+
+    CHECK(histogram.Count() == 4);
+    CHECK(histogram.Min() == 10);
+    CHECK(histogram.Max() == 40);
+    CHECK_NEAR(histogram.Mean(), 25.0, 1e-9);
+
+    // Small values are exact
+    CHECK(histogram.ValueAtPercentile(0.0) == 10);
+    CHECK(histogram.ValueAtPercentile(50.0) == 20);
+    CHECK(histogram.ValueAtPercentile(75.0) == 30);
+    CHECK(histogram.ValueAtPercentile(100.0) == 40);
+    CHECK(histogram.ValueAtPercentile(250.0) == 40);
+
+    histogram.Reset();
+    CHECK(histogram.Count() == 0);
+    CHECK(histogram.Min() == 0);
+    CHECK(histogram.Max() == 0);
+    CHECK(histogram.ValueAtPercentile(99.0) == 0);
+}
+
+TEST_CASE(PercentilesMatchSortedValues)
+{
+    std::mt19937_64 random(11);
+    std::lognormal_distribution<double> latency(15.0, 0.6);
+    std::vector<uint64_t> values(200000);
+    LatencyHistogram histogram;
+    for (auto& value : values)
+    {
+        value = static_cast<uint64_t>(latency(random));
+        histogram.Record(value);
+    }
+
+    std::sort(values.begin(), values.end());
+    for (double percentile : { 1.0, 50.0, 90.0, 99.0, 99.9, 99.99 })
+    {
+        auto const rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size()))) - 1;
+        uint64_t const exact = values[rank];
+        uint64_t const reported = histogram.ValueAtPercentile(percentile);
+
+        // The bucket's upper edge: never below the exact value, and within the bucket width above it
+        CHECK(reported >= exact);
+        CHECK(static_cast<double>(reported - exact) <= 0.02 * static_cast<double>(exact));
+    }
+
+    CHECK(histogram.Max() == values.back());
+    CHECK(histogram.Min() == values.front());
+}
+
+TEST_CASE(ConcurrentRecordsAreAllCounted)
+{
+    constexpr unsigned Threads = 4;
+    constexpr uint64_t PerThread = 50000;
+
+    LatencyHistogram histogram;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < Threads; ++t)
+    {
+        workers.emplace_back([&histogram, t]
+        {
+            for (uint64_t i = 1; i <= PerThread; ++i)
+            {
+                histogram.Record(i * Threads + t);
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    CHECK(histogram.Count() == Threads * PerThread);
+    CHECK(histogram.Min() == Threads);
+    CHECK(histogram.Max() == PerThread * Threads + Threads - 1);
+
+    uint64_t total = 0;
+    for (size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket)
+    {
+        total += histogram.BucketValueCount(bucket);
+    }
+    CHECK(total == Threads * PerThread);
+
+    // Sum of (i * Threads + t) over every thread and i
+    double const sum = Threads * (Threads * PerThread * (PerThread + 1) / 2.0) + PerThread * (Threads * (Threads - 1) / 2.0);
+    CHECK_NEAR(histogram.Mean(), sum / (Threads * PerThread), 1e-6);
+}
+
+TEST_CASE(InstrumentationOnlyRecordsWhileEnabled)
+{
+    FrameInstrumentation instrumentation;
+    CHECK(!instrumentation.IsEnabled());
+    instrumentation.Record(FrameInstrumentation::Metric::Render, 100);
+    CHECK(instrumentation.Histogram(FrameInstrumentation::Metric::Render).Count() == 0);
+
+    instrumentation.SetEnabled(true);
+    instrumentation.Record(FrameInstrumentation::Metric::Render, 100);
+    CHECK(instrumentation.Histogram(FrameInstrumentation::Metric::Render).Count() == 1);
+
+    // Intervals need both timestamps, in order
+    instrumentation.RecordInterval(FrameInstrumentation::Metric::Present, 0, 500);
+    instrumentation.RecordInterval(FrameInstrumentation::Metric::Present, 600, 500);
+    CHECK(instrumentation.Histogram(FrameInstrumentation::Metric::Present).Count() == 0);
+    instrumentation.RecordInterval(FrameInstrumentation::Metric::Present, 100, 500);
+    CHECK(instrumentation.Histogram(FrameInstrumentation::Metric::Present).Max() == 400);
+
+    CHECK(FrameInstrumentation::Now() != 0);
+    CHECK(FrameInstrumentation::Now() <= FrameInstrumentation::Now());
+
+    instrumentation.Reset();
+    CHECK(instrumentation.Histogram(FrameInstrumentation::Metric::Render).Count() == 0);
+    CHECK(instrumentation.IsEnabled());
+}
+
+TEST_CASE(JsonHasEveryMetricAndItsBuckets)
+{
+    FrameInstrumentation instrumentation;
+    instrumentation.SetEnabled(true);
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        instrumentation.Record(FrameInstrumentation::Metric::InputToPresent, i * 1000);
+    }
+
+    std::ostringstream out;
+    instrumentation.WriteJson(out);
+    std::string const json = out.str();
+
+    for (size_t i = 0; i < static_cast<size_t>(FrameInstrumentation::Metric::Count); ++i)
+    {
+        std::string const key = std::string("\"") + FrameInstrumentation::MetricName(static_cast<FrameInstrumentation::Metric>(i)) + "\": {";
+        CHECK(json.find(key) != std::string::npos);
+    }
+
+    CHECK(json.find("\"count\": 1000") != std::string::npos);
+    CHECK(json.find("\"max\": 1000000") != std::string::npos);
+    CHECK(json.find("\"p99.9\": ") != std::string::npos);
+    CHECK(json.find("\"buckets\": []") != std::string::npos);
+
+    // Balanced brackets and braces, and the bucket counts add up
+    CHECK(std::count(json.begin(), json.end(), '{') == std::count(json.begin(), json.end(), '}'));
+    CHECK(std::count(json.begin(), json.end(), '[') == std::count(json.begin(), json.end(), ']'));
+
+    uint64_t total = 0;
+    size_t const buckets = json.find("\"buckets\": [[");
+    REQUIRE(buckets != std::string::npos);
+    std::istringstream in(json.substr(buckets + 12, json.find("]]", buckets) - buckets - 11));
+    char open;
+    uint64_t lower;
+    uint64_t upper;
+    uint64_t count;
+    char comma;
+    char close;
+    while ((in >> open >> lower >> comma >> upper >> comma >> count >> close) && (open == '['))
+    {
+        CHECK(lower <= upper);
+        total += count;
+        in >> comma;
+    }
+    CHECK(total == 1000);
+}
+
+TEST_CASE(JsonReportsQueueCounters)
+{
+    FrameInstrumentation instrumentation;
+    std::ostringstream empty;
+    instrumentation.WriteJson(empty);
+    CHECK(empty.str().find("\"queues\": {}") != std::string::npos);
+
+    // Setting a queue again replaces its counters rather than adding to them
+    instrumentation.SetQueueCounters("samples", { 3, 100, 1024 });
+    instrumentation.SetQueueCounters("events", { 0, 7, 64 });
+    instrumentation.SetQueueCounters("samples", { 12, 1024, 1024 });
+    CHECK(instrumentation.QueueCountersFor("samples").Overflows == 12);
+    CHECK(instrumentation.QueueCountersFor("missing").Capacity == 0);
+
+    std::ostringstream out;
+    instrumentation.WriteJson(out);
+    std::string const json = out.str();
+    CHECK(json.find("\"samples\": { \"overflows\": 12, \"highWaterMark\": 1024, \"capacity\": 1024 }") != std::string::npos);
+    CHECK(json.find("\"events\": { \"overflows\": 0, \"highWaterMark\": 7, \"capacity\": 64 }") != std::string::npos);
+    CHECK(json.find("\"overflows\": 3") == std::string::npos);
+    CHECK(std::count(json.begin(), json.end(), '{') == std::count(json.begin(), json.end(), '}'));
+
+    instrumentation.Reset();
+    CHECK(instrumentation.QueueCountersFor("samples").HighWaterMark == 0);
+}
@@ -0,0 +1,171 @@
+#include "MoveCoalescer.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    PointerSample Sample(float x, uint64_t timestamp, float pressure = 0.5f)
+    {
+        return { x, x * 2.0f, timestamp, pressure };
+    }
+}
+
+TEST_CASE(FlushWritesOnlyTheLatestMove)
+{
+    PointerTable table;
+    table.Insert(1, PointerDeviceKind::Pen, true, { 0.0f, 0.0f });
+    table.Insert(2, PointerDeviceKind::Touch, true, { 5.0f, 5.0f });
+
+    MoveCoalescer coalescer;
+    for (uint64_t i = 1; i <= 10; ++i)
+    {
+        CHECK(coalescer.AddMove(1, Sample(static_cast<float>(i), i, 0.1f * static_cast<float>(i))));
+    }
+
+    CHECK(coalescer.Flush(table) == 1);
+    size_t const pen = table.Find(1);
+    CHECK(table.Position(pen).X == 10.0f);
+    CHECK(table.Position(pen).Y == 20.0f);
+    CHECK_NEAR(table.Pressure(pen), 1.0, 1e-6);
+    CHECK(table.Timestamp(pen) == 10);
+    CHECK(coalescer.LastFrameSampleCount(1) == 10);
+
+    // Untouched pointers keep their state
+    size_t const touch = table.Find(2);
+    CHECK(table.Position(touch).X == 5.0f);
+    CHECK(coalescer.LastFrameSampleCount(2) == 0);
+
+    // Nothing pending, nothing written
+    table.SetPosition(pen, { -1.0f, -1.0f });
+    CHECK(coalescer.Flush(table) == 0);
+    CHECK(table.Position(pen).X == -1.0f);
+    CHECK(coalescer.LastFrameSampleCount(1) == 0);
+    CHECK(coalescer.TotalMoves() == 10);
+    CHECK(coalescer.TotalUpdates() == 1);
+}
+
+TEST_CASE(HistoryIsBoundedAndOrdered)
+{
+    MoveCoalescer coalescer(4, 8);
+    for (uint64_t i = 0; i < 20; ++i)
+    {
+        coalescer.AddMove(7, Sample(static_cast<float>(i), i));
+    }
+
+    PointerSample history[16];
+    size_t const count = coalescer.CopyHistory(7, history, 16);
+    REQUIRE(count == 8);
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(history[i].Timestamp == 12 + i);
+    }
+
+    // A shorter copy gets the most recent samples
+    CHECK(coalescer.CopyHistory(7, history, 3) == 3);
+    CHECK(history[0].Timestamp == 17);
+    CHECK(history[2].Timestamp == 19);
+    CHECK(coalescer.CopyHistory(8, history, 3) == 0);
+}
+
+TEST_CASE(SlotsAreReusedAfterRemove)
+{
+    MoveCoalescer coalescer(2, 4);
+    CHECK(coalescer.AddMove(1, Sample(1.0f, 1)));
+    CHECK(coalescer.AddMove(2, Sample(2.0f, 2)));
+    CHECK(!coalescer.AddMove(3, Sample(3.0f, 3)));
+
+    coalescer.Remove(1);
+    CHECK(coalescer.TrackedCount() == 1);
+    CHECK(coalescer.AddMove(3, Sample(3.0f, 3)));
+
+    // The moved slot kept its history
+    PointerSample history[4];
+    REQUIRE(coalescer.CopyHistory(2, history, 4) == 1);
+    CHECK(history[0].X == 2.0f);
+    REQUIRE(coalescer.CopyHistory(3, history, 4) == 1);
+    CHECK(history[0].X == 3.0f);
+}
+
+TEST_CASE(ReleaseIsNotOverwrittenByAnEarlierMove)
+{
+    // What PointerRenderer does for a move followed by a release within one frame
+    PointerTable table;
+    size_t const index = table.Insert(1, PointerDeviceKind::Pen, true, { 0.0f, 0.0f });
+
+    MoveCoalescer coalescer;
+    coalescer.AddMove(1, Sample(10.0f, 10, 0.8f));
+
+    coalescer.DiscardPending(1);
+    table.SetPressed(index, false);
+    table.SetPosition(index, { 12.0f, 24.0f });
+    table.SetPressure(index, 0.0f);
+    table.SetTimestamp(index, 11);
+
+    CHECK(coalescer.Flush(table) == 0);
+    CHECK(table.Position(index).X == 12.0f);
+    CHECK(table.Pressure(index) == 0.0f);
+    CHECK(table.Timestamp(index) == 11);
+
+    // The discarded move is still in the history, and later moves flush again
+    PointerSample history[4];
+    CHECK(coalescer.CopyHistory(1, history, 4) == 1);
+    coalescer.AddMove(1, Sample(13.0f, 12, 0.0f));
+    CHECK(coalescer.Flush(table) == 1);
+    CHECK(table.Position(index).X == 13.0f);
+}
+
+TEST_CASE(MatchesMapUnderRandomOperations)
+{
+    // IDs drawn from a range wider than the capacity, so probe runs keep
+    // growing and being shifted back by removals
+    std::mt19937 random{ 4321 };
+    MoveCoalescer coalescer(64, 4);
+    std::unordered_map<uint32_t, std::vector<float>> reference;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        uint32_t const id = random() % 100;
+        switch (random() % 3)
+        {
+        case 0:
+        {
+            auto const x = static_cast<float>(step);
+            bool const expected = (reference.count(id) != 0) || (reference.size() < 64);
+            CHECK(coalescer.AddMove(id, Sample(x, static_cast<uint64_t>(step))) == expected);
+            if (expected)
+            {
+                reference[id].push_back(x);
+            }
+            break;
+        }
+
+        case 1:
+            coalescer.Remove(id);
+            reference.erase(id);
+            break;
+
+        default:
+        {
+            // The latest samples, up to the history length
+            PointerSample history[4];
+            size_t const count = coalescer.CopyHistory(id, history, 4);
+            auto const found = reference.find(id);
+            size_t const expected = (found == reference.end()) ? 0 : std::min<size_t>(found->second.size(), 4);
+            REQUIRE(count == expected);
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK(history[i].X == found->second[found->second.size() - count + i]);
+            }
+            break;
+        }
+        }
+
+        CHECK(coalescer.TrackedCount() == reference.size());
+    }
+}
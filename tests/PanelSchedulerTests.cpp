@@ -0,0 +1,186 @@
+#include "PanelScheduler.h"
+#include "TestHarness.h"
+
+using namespace PointerCore;
+using namespace std::chrono_literals;
+
+namespace
+{
+    using FrameAction = PanelScheduler::FrameAction;
+    using TimePoint = PanelScheduler::TimePoint;
+
+    // Starts and finishes the next frame, returning the panel it was for
+    PanelScheduler::PanelId RenderNext(PanelScheduler& scheduler, TimePoint now = TimePoint{})
+    {
+        auto const decision = scheduler.Next(now);
+        if (decision.Action != FrameAction::Render)
+        {
+            return PanelScheduler::NoPanel;
+        }
+
+        scheduler.OnFrameStarted(decision.Panel);
+        scheduler.OnFrameFinished(decision.Panel);
+        return decision.Panel;
+    }
+}
+
+TEST_CASE(HighestPriorityFirstThenFirstCome)
+{
+    PanelScheduler scheduler({ 0 });
+    auto const low = scheduler.Register(0);
+    auto const high = scheduler.Register(5);
+    auto const lowToo = scheduler.Register(0);
+    CHECK(scheduler.PanelCount() == 3);
+    CHECK(scheduler.Next(TimePoint{}).Action == FrameAction::Idle);
+
+    scheduler.RequestFrame(lowToo);
+    scheduler.RequestFrame(low);
+    scheduler.RequestFrame(high);
+    CHECK(RenderNext(scheduler) == high);
+    CHECK(RenderNext(scheduler) == lowToo);
+    CHECK(RenderNext(scheduler) == low);
+    CHECK(RenderNext(scheduler) == PanelScheduler::NoPanel);
+    CHECK(scheduler.FramesStarted() == 3);
+
+    // Priorities can change while a request waits
+    scheduler.RequestFrame(high);
+    scheduler.RequestFrame(low);
+    scheduler.SetPriority(low, 9);
+    CHECK(RenderNext(scheduler) == low);
+    CHECK(RenderNext(scheduler) == high);
+}
+
+TEST_CASE(FutureRequestsWaitAndTheEarliestWins)
+{
+    PanelScheduler scheduler;
+    auto const a = scheduler.Register(0);
+    auto const b = scheduler.Register(0);
+
+    scheduler.RequestFrame(a, TimePoint{ 20ms });
+    scheduler.RequestFrame(b, TimePoint{ 30ms });
+    auto decision = scheduler.Next(TimePoint{ 10ms });
+    CHECK(decision.Action == FrameAction::WaitUntil);
+    CHECK(decision.WakeTime == TimePoint{ 20ms });
+
+    // A second request before the frame starts only moves it earlier
+    scheduler.RequestFrame(a, TimePoint{ 25ms });
+    scheduler.RequestFrame(b, TimePoint{ 15ms });
+    CHECK(scheduler.Next(TimePoint{ 10ms }).WakeTime == TimePoint{ 15ms });
+
+    // Whoever fell due first goes first, whatever order they asked in
+    CHECK(RenderNext(scheduler, TimePoint{ 40ms }) == b);
+    CHECK(RenderNext(scheduler, TimePoint{ 40ms }) == a);
+    CHECK(scheduler.Next(TimePoint{ 40ms }).Action == FrameAction::Idle);
+}
+
+TEST_CASE(RenderingPanelIsNeverHandedOutTwice)
+{
+    PanelScheduler scheduler;
+    auto const a = scheduler.Register(5);
+    auto const b = scheduler.Register(0);
+    scheduler.RequestFrame(a);
+    scheduler.RequestFrame(b);
+
+    auto decision = scheduler.Next(TimePoint{});
+    REQUIRE(decision.Panel == a);
+    scheduler.OnFrameStarted(a);
+    CHECK(scheduler.IsRendering(a));
+
+    // A request while rendering is for the next frame, held until this one finishes
+    scheduler.RequestFrame(a);
+    decision = scheduler.Next(TimePoint{});
+    CHECK(decision.Panel == b);
+    scheduler.OnFrameStarted(b);
+    CHECK(scheduler.Next(TimePoint{}).Action == FrameAction::Idle);
+
+    scheduler.OnFrameFinished(a);
+    CHECK(!scheduler.IsRendering(a));
+    CHECK(scheduler.Next(TimePoint{}).Panel == a);
+    scheduler.OnFrameFinished(b);
+}
+
+TEST_CASE(AgingLetsLowPrioritiesThrough)
+{
+    // A busy priority 3 panel asks again after every frame. With aging every
+    // 4 frames, the priority 0 panel ties it after 12 frames and wins as the
+    // one that fell due first.
+    PanelScheduler scheduler({ 4 });
+    auto const busy = scheduler.Register(3);
+    auto const idle = scheduler.Register(0);
+    scheduler.RequestFrame(idle);
+    scheduler.Next(TimePoint{});
+
+    int frames = 0;
+    for (;;)
+    {
+        scheduler.RequestFrame(busy);
+        if (RenderNext(scheduler) == idle)
+        {
+            break;
+        }
+        ++frames;
+        REQUIRE(frames < 100);
+    }
+    CHECK(frames == 12);
+
+    // Without aging it waits forever
+    scheduler.SetOptions({ 0 });
+    scheduler.RequestFrame(idle);
+    for (int i = 0; i < 100; ++i)
+    {
+        scheduler.RequestFrame(busy);
+        CHECK(RenderNext(scheduler) == busy);
+    }
+}
+
+TEST_CASE(AgingStartsWhenTheRequestFallsDue)
+{
+    // A capped panel asks for its next frame ahead of time. The frames that
+    // run before it's due didn't pass it over, so it mustn't come due with a
+    // head start on a higher priority.
+    PanelScheduler scheduler({ 2 });
+    auto const capped = scheduler.Register(0);
+    auto const busy = scheduler.Register(5);
+    auto const high = scheduler.Register(1);
+
+    scheduler.RequestFrame(capped, TimePoint{ 16ms });
+    for (int i = 0; i < 10; ++i)
+    {
+        scheduler.RequestFrame(busy);
+        CHECK(RenderNext(scheduler, TimePoint{ 1ms }) == busy);
+    }
+
+    scheduler.RequestFrame(high, TimePoint{ 16ms });
+    CHECK(RenderNext(scheduler, TimePoint{ 16ms }) == high);
+    CHECK(RenderNext(scheduler, TimePoint{ 16ms }) == capped);
+}
+
+TEST_CASE(UnregisteredPanelsAreIgnoredAndTheirIdsReused)
+{
+    PanelScheduler scheduler;
+    auto const a = scheduler.Register(0);
+    auto const b = scheduler.Register(0);
+    scheduler.RequestFrame(a);
+    CHECK(scheduler.Unregister(a));
+    CHECK(!scheduler.Unregister(a));
+    CHECK(!scheduler.IsRegistered(a));
+    CHECK(scheduler.PanelCount() == 1);
+
+    // Its pending request went with it
+    CHECK(scheduler.Next(TimePoint{}).Action == FrameAction::Idle);
+    scheduler.RequestFrame(a);
+    scheduler.SetPriority(a, 3);
+    scheduler.OnFrameStarted(a);
+    CHECK(scheduler.Next(TimePoint{}).Action == FrameAction::Idle);
+    CHECK(scheduler.FramesStarted() == 0);
+
+    auto const c = scheduler.Register(1);
+    CHECK(c == a);
+    CHECK(!scheduler.IsRendering(c));
+    CHECK(scheduler.Next(TimePoint{}).Action == FrameAction::Idle);
+    scheduler.RequestFrame(b);
+    scheduler.RequestFrame(c);
+    CHECK(RenderNext(scheduler) == c);
+    CHECK(RenderNext(scheduler) == b);
+    CHECK(!scheduler.IsRegistered(PanelScheduler::NoPanel));
+}
@@ -0,0 +1,273 @@
+#include "PointerHeatmap.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+using namespace PointerCore;
+
+namespace
+{
+    // Every cell in one array, every cell decayed every frame
+    struct DenseHeatmap
+    {
+        PointerHeatmap::Options Options;
+        uint32_t Width;
+        uint32_t Height;
+        std::vector<double> Values;
+
+        DenseHeatmap(PointerHeatmap::Options const& options, uint32_t width, uint32_t height)
+            : Options(options), Width(width), Height(height), Values(size_t{ width } * height, 0.0)
+        {
+        }
+
+        void AddSample(HeatmapSample const& sample)
+        {
+            int32_t const cx = static_cast<int32_t>(std::floor(sample.X / Options.CellSize));
+            int32_t const cy = static_cast<int32_t>(std::floor(sample.Y / Options.CellSize));
+            if ((cx < 0) || (cy < 0) || (cx >= static_cast<int32_t>(Width)) || (cy >= static_cast<int32_t>(Height)))
+            {
+                return;
+            }
+
+            int32_t const radius = static_cast<int32_t>(std::ceil(Options.KernelRadius));
+            double const sigma = std::max(Options.KernelRadius * 0.5, 0.5);
+            double const weight = sample.Pressed ? Options.PressedWeight : Options.HoverWeight;
+            for (int32_t y = std::max(cy - radius, 0); y <= std::min(cy + radius, static_cast<int32_t>(Height) - 1); ++y)
+            {
+                for (int32_t x = std::max(cx - radius, 0); x <= std::min(cx + radius, static_cast<int32_t>(Width) - 1); ++x)
+                {
+                    double const distance = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+                    Values[size_t(y) * Width + size_t(x)] += weight * std::exp(-0.5 * distance / (sigma * sigma));
+                }
+            }
+        }
+
+        void Decay(double seconds)
+        {
+            double const factor = std::exp2(-seconds / Options.HalfLife);
+            for (double& value : Values)
+            {
+                value *= factor;
+            }
+        }
+    };
+
+    // Largest difference beyond what retiring faded tiles explains
+    double Compare(PointerHeatmap const& heatmap, DenseHeatmap const& dense)
+    {
+        double worst = 0.0;
+        for (uint32_t y = 0; y < dense.Height; ++y)
+        {
+            for (uint32_t x = 0; x < dense.Width; ++x)
+            {
+                double const expected = dense.Values[size_t{ y } * dense.Width + x];
+                double const error = std::abs(heatmap.Value(x, y) - expected) - expected * 1e-4;
+                worst = std::max(worst, error);
+            }
+        }
+        return worst;
+    }
+}
+
+TEST_CASE(SplatsAKernel)
+{
+    PointerHeatmap heatmap;
+    heatmap.Resize(400.0f, 300.0f);
+    CHECK(heatmap.Width() == 100);
+    CHECK(heatmap.Height() == 75);
+    CHECK(heatmap.TileCount() == 4 * 3);
+    CHECK(heatmap.ActiveTileCount() == 0);
+
+    // Cell (50, 40), in the middle of tile (1, 1)
+    heatmap.AddSample({ 201.0f, 163.0f, true });
+    CHECK_NEAR(heatmap.Value(50, 40), 1.0f, 1e-6f);
+    CHECK_NEAR(heatmap.Value(51, 40), heatmap.Value(49, 40), 1e-6f);
+    CHECK_NEAR(heatmap.Value(50, 43), heatmap.Value(47, 40), 1e-6f);
+    CHECK_NEAR(heatmap.Value(51, 41), std::exp(-2.0f / 4.5f), 1e-6f);
+    CHECK(heatmap.Value(54, 40) == 0.0f);
+    CHECK(heatmap.ActiveTileCount() == 1);
+
+    heatmap.AddSample({ 201.0f, 163.0f, false });
+    CHECK_NEAR(heatmap.Value(50, 40), 1.25f, 1e-6f);
+
+    // Samples off the panel, or not numbers, change nothing
+    heatmap.AddSample({ -1.0f, 10.0f, true });
+    heatmap.AddSample({ 10.0f, 300.0f, true });
+    heatmap.AddSample({ NAN, 10.0f, true });
+    heatmap.AddSample({ 1e30f, 10.0f, true });
+    CHECK(heatmap.ActiveTileCount() == 1);
+    CHECK(heatmap.Value(100, 0) == 0.0f);
+}
+
+TEST_CASE(KernelsCrossTilesAndClipAtEdges)
+{
+    PointerHeatmap::Options options;
+    options.HalfLife = 1.0f;
+    PointerHeatmap heatmap(options);
+    heatmap.Resize(400.0f, 300.0f);
+    DenseHeatmap dense(options, heatmap.Width(), heatmap.Height());
+
+    // A tile corner, and every edge and corner of the grid
+    HeatmapSample const samples[] = {
+        { 128.0f, 128.0f, true }, { 127.0f, 127.0f, true }, { 0.0f, 0.0f, true }, { 399.0f, 299.0f, false },
+        { 399.0f, 0.0f, true }, { 0.0f, 299.0f, true }, { 200.0f, 0.0f, false }, { 399.9f, 150.0f, true } };
+    for (auto const& sample : samples)
+    {
+        heatmap.AddSample(sample);
+        dense.AddSample(sample);
+    }
+
+    CHECK(heatmap.ActiveTileCount() == 8);
+    CHECK(Compare(heatmap, dense) < 1e-6);
+}
+
+TEST_CASE(DecayMatchesDenseReference)
+{
+    // Random bursts of samples and frames of decay, with one tile scaled per
+    // frame so nearly every tile catches up lazily, and with every tile
+    // scaled every frame
+    for (uint32_t tilesPerFrame : { 1u, 1000u })
+    {
+        PointerHeatmap::Options options;
+        options.HalfLife = 0.5f;
+        options.TilesPerFrame = tilesPerFrame;
+        PointerHeatmap heatmap(options);
+        heatmap.Resize(640.0f, 480.0f);
+        DenseHeatmap dense(options, heatmap.Width(), heatmap.Height());
+
+        std::mt19937 random(6);
+        std::uniform_real_distribution<float> x(0.0f, 640.0f);
+        std::uniform_real_distribution<float> y(0.0f, 480.0f);
+        double worst = 0.0;
+        size_t mostActive = 0;
+        for (int frame = 0; frame < 600; ++frame)
+        {
+            int const samples = (frame % 100 < 50) ? static_cast<int>(random() % 20) : 0;
+            for (int i = 0; i < samples; ++i)
+            {
+                HeatmapSample const sample{ x(random), y(random), (random() % 2) != 0 };
+                heatmap.AddSample(sample);
+                dense.AddSample(sample);
+            }
+
+            float const seconds = (frame % 7 == 0) ? 0.05f : 1.0f / 60.0f;
+            heatmap.Decay(seconds);
+            dense.Decay(seconds);
+            mostActive = std::max(mostActive, heatmap.ActiveTileCount());
+            if (frame % 10 == 0)
+            {
+                worst = std::max(worst, Compare(heatmap, dense));
+            }
+        }
+
+        CHECK(mostActive == heatmap.TileCount());
+        CHECK(worst < options.Floor);
+
+        // A snapshot sees the same values
+        HeatmapSnapshot snapshot;
+        heatmap.Snapshot(snapshot);
+        REQUIRE(snapshot.Values.size() == dense.Values.size());
+        double snapshotWorst = 0.0;
+        float max = 0.0f;
+        for (size_t i = 0; i < snapshot.Values.size(); ++i)
+        {
+            snapshotWorst = std::max(snapshotWorst, std::abs(snapshot.Values[i] - dense.Values[i]) - dense.Values[i] * 1e-4);
+            max = std::max(max, snapshot.Values[i]);
+        }
+        CHECK(snapshotWorst < options.Floor);
+        CHECK(snapshot.MaxValue == max);
+
+        // Left alone, everything fades and the tiles retire
+        for (int frame = 0; frame < 6000 && heatmap.ActiveTileCount() > 0; ++frame)
+        {
+            heatmap.Decay(1.0f / 60.0f);
+        }
+        CHECK(heatmap.ActiveTileCount() == 0);
+        heatmap.Snapshot(snapshot);
+        CHECK(snapshot.MaxValue == 0.0f);
+    }
+}
+
+TEST_CASE(HalfLife)
+{
+    PointerHeatmap::Options options;
+    options.HalfLife = 2.0f;
+    options.TilesPerFrame = 1;
+    PointerHeatmap heatmap(options);
+    heatmap.Resize(256.0f, 256.0f);
+    heatmap.AddSample({ 10.0f, 10.0f, true });
+    heatmap.AddSample({ 250.0f, 250.0f, true });
+    for (int i = 0; i < 120; ++i)
+    {
+        heatmap.Decay(1.0f / 60.0f);
+    }
+    CHECK_NEAR(heatmap.Value(2, 2), 0.5f, 1e-5f);
+    CHECK_NEAR(heatmap.Value(62, 62), 0.5f, 1e-5f);
+
+    // A sample on a tile that's behind lands on its caught-up values
+    heatmap.AddSample({ 250.0f, 250.0f, true });
+    CHECK_NEAR(heatmap.Value(62, 62), 1.5f, 1e-5f);
+
+    // Nothing for zero, negative or non-numeric time
+    heatmap.Decay(0.0f);
+    heatmap.Decay(-1.0f);
+    heatmap.Decay(NAN);
+    CHECK_NEAR(heatmap.Value(62, 62), 1.5f, 1e-5f);
+}
+
+TEST_CASE(ResizeAndClear)
+{
+    PointerHeatmap heatmap;
+    heatmap.Resize(400.0f, 300.0f);
+    heatmap.AddSample({ 100.0f, 100.0f, true });
+
+    // Same grid, nothing lost
+    heatmap.Resize(398.0f, 297.0f);
+    CHECK(heatmap.Value(25, 25) == 1.0f);
+
+    heatmap.Resize(800.0f, 300.0f);
+    CHECK(heatmap.Width() == 200);
+    CHECK(heatmap.ActiveTileCount() == 0);
+    CHECK(heatmap.Value(25, 25) == 0.0f);
+
+    heatmap.AddSample({ 100.0f, 100.0f, true });
+    heatmap.AddSample({ 700.0f, 100.0f, true });
+    CHECK(heatmap.ActiveTileCount() == 2);
+    heatmap.Clear();
+    CHECK(heatmap.ActiveTileCount() == 0);
+    CHECK(heatmap.Value(25, 25) == 0.0f);
+    CHECK(heatmap.Value(175, 25) == 0.0f);
+
+    heatmap.Resize(0.0f, 0.0f);
+    CHECK(heatmap.TileCount() == 0);
+    heatmap.AddSample({ 0.0f, 0.0f, true });
+    heatmap.Decay(1.0f);
+    CHECK(heatmap.Value(0, 0) == 0.0f);
+}
+
+TEST_CASE(WritesPgm)
+{
+    PointerHeatmap heatmap;
+    heatmap.Resize(40.0f, 20.0f);
+    heatmap.AddSample({ 20.0f, 10.0f, true });
+    heatmap.AddSample({ 20.0f, 10.0f, true });
+
+    HeatmapSnapshot snapshot;
+    heatmap.Snapshot(snapshot);
+    CHECK(snapshot.Width == 10);
+    CHECK(snapshot.Height == 5);
+    CHECK(snapshot.CellSize == 4.0f);
+    CHECK(snapshot.MaxValue == 2.0f);
+
+    std::ostringstream out;
+    snapshot.WritePgm(out);
+    std::string const pgm = out.str();
+    std::string const header = "P5\n10 5\n255\n";
+    REQUIRE(pgm.size() == header.size() + 50);
+    CHECK(pgm.compare(0, header.size(), header) == 0);
+    CHECK(static_cast<uint8_t>(pgm[header.size() + 2 * 10 + 5]) == 255);
+    CHECK(static_cast<uint8_t>(pgm[header.size()]) == 0);
+}
@@ -0,0 +1,319 @@
+#include "PointerHistory.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace PointerCore;
+
+namespace
+{
+    PointerEvent Event(uint32_t id, uint64_t timestamp, float x, float y, PointerEventKind kind = PointerEventKind::Moved)
+    {
+        PointerEvent event{};
+        event.Timestamp = timestamp;
+        event.ReceivedTime = 12345;
+        event.Id = id;
+        event.X = x;
+        event.Y = y;
+        event.Pressure = 0.5f;
+        event.Kind = kind;
+        event.DeviceKind = PointerDeviceKind::Pen;
+        event.InContact = true;
+        return event;
+    }
+
+    // A 1 kHz pen stroke with jitter in its timestamps, pressure that comes
+    // and goes, and a few contact changes
+    std::vector<PointerEvent> Stroke(uint32_t id, uint64_t start, size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> jitter(-40, 40);
+        std::vector<PointerEvent> events;
+        float x = 500.0f;
+        float y = 400.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            x += std::sin(static_cast<float>(i) * 0.01f) * 3.0f;
+            y += std::cos(static_cast<float>(i) * 0.013f) * 2.0f;
+            auto event = Event(id, start + i * 1000 + static_cast<uint64_t>(jitter(random) + 40), x, y);
+            event.Pressure = 0.5f + 0.4f * std::sin(static_cast<float>(i) * 0.002f);
+            event.InContact = (i / 700) % 2 == 0;
+            event.Kind = ((i % 700) == 0) ? PointerEventKind::Pressed : PointerEventKind::Moved;
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    // Matches what went in, to within the quantization
+    bool Matches(PointerEvent const& stored, PointerEvent const& original)
+    {
+        return (stored.Timestamp == original.Timestamp) && (stored.Id == original.Id) && (stored.ReceivedTime == 0)
+            && (std::fabs(stored.X - original.X) <= 0.5f / 64.0f) && (std::fabs(stored.Y - original.Y) <= 0.5f / 64.0f)
+            && (std::fabs(stored.Pressure - original.Pressure) <= 0.5f / 1024.0f) && (stored.Kind == original.Kind)
+            && (stored.DeviceKind == original.DeviceKind) && (stored.InContact == original.InContact);
+    }
+}
+
+TEST_CASE(EventsRoundTripThroughBlocks)
+{
+    PointerHistory history;
+    auto const events = Stroke(7, 1000000, 5000, 1);
+    for (auto const& event : events)
+    {
+        history.Append(event);
+    }
+    CHECK(history.EventCount() == 5000);
+    CHECK(history.BlockCount() == 5000 / PointerHistory::BlockSamples);
+    CHECK(history.OpenBytes() == (5000 % PointerHistory::BlockSamples) * sizeof(PointerEvent));
+
+    // Sealed blocks and the open one alike
+    std::vector<PointerEvent> out;
+    history.Query(0, UINT64_MAX, out);
+    REQUIRE(out.size() == events.size());
+    bool matching = true;
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        matching = matching && Matches(out[i], events[i]);
+    }
+    CHECK(matching);
+
+    // A smooth stroke compresses to a few bytes an event
+    CHECK(history.CompressedBytes() < history.BlockCount() * PointerHistory::BlockSamples * 6);
+}
+
+TEST_CASE(TimestampsOfEveryBucket)
+{
+    // Changes of interval that need each prefix, both signs, time going
+    // backwards, and jumps that need all 64 bits
+    std::vector<uint64_t> times = { 0, 1000, 2000, 3000, 3063, 3190, 3191, 3446, 5000, 5001, 7048, 7048, 7000,
+        uint64_t{ 1 } << 40, (uint64_t{ 1 } << 40) + 1, 5, UINT64_MAX - 1, UINT64_MAX, 0, 100 };
+    std::mt19937_64 random(3);
+    while (times.size() < PointerHistory::BlockSamples)
+    {
+        times.push_back(times.back() + random() % 5000);
+    }
+
+    PointerHistory history;
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        history.Append(Event(1, times[i], static_cast<float>(i), -static_cast<float>(i)));
+    }
+    REQUIRE(history.BlockCount() == 1);
+
+    // UINT64_MAX itself can't be in a half-open range
+    size_t index = 0;
+    bool matching = true;
+    CHECK(history.ForEachOfPointer(1, 0, UINT64_MAX, [&](PointerEvent const& event)
+    {
+        index += (times[index] == UINT64_MAX) ? 1 : 0;
+        matching = matching && (event.Timestamp == times[index]) && (event.X == static_cast<float>(index)) && (event.Y == -static_cast<float>(index));
+        ++index;
+    }) == times.size() - 1);
+    CHECK(matching);
+    CHECK(index == times.size());
+}
+
+TEST_CASE(ScansDecodeOnlyTheBlocksTheyTouch)
+{
+    PointerHistory history;
+    for (auto const& event : Stroke(1, 0, 20 * PointerHistory::BlockSamples, 2))
+    {
+        history.Append(event);
+    }
+    for (auto const& event : Stroke(2, 0, 20 * PointerHistory::BlockSamples, 3))
+    {
+        history.Append(event);
+    }
+    REQUIRE(history.BlockCount() == 40);
+
+    // One second spans at most three blocks of each pointer
+    std::vector<PointerEvent> out;
+    uint64_t const before = history.BlocksDecoded();
+    history.Query(5000000, 6000000, out);
+    CHECK(history.BlocksDecoded() - before <= 6);
+    CHECK(out.size() >= 1990);
+    CHECK(out.size() <= 2010);
+    bool inOrder = true;
+    for (size_t i = 1; i < out.size(); ++i)
+    {
+        inOrder = inOrder && (out[i - 1].Timestamp <= out[i].Timestamp);
+    }
+    CHECK(inOrder);
+    CHECK(out.front().Timestamp >= 5000000);
+    CHECK(out.back().Timestamp < 6000000);
+
+    // One pointer's events only
+    uint64_t const beforePointer = history.BlocksDecoded();
+    size_t count = 0;
+    bool onePointer = true;
+    history.ForEachOfPointer(2, 5000000, 6000000, [&](PointerEvent const& event)
+    {
+        onePointer = onePointer && (event.Id == 2);
+        ++count;
+    });
+    CHECK(onePointer);
+    CHECK(count >= 995);
+    CHECK(history.BlocksDecoded() - beforePointer <= 3);
+    CHECK(history.ForEachOfPointer(3, 0, UINT64_MAX, [](PointerEvent const&) {}) == 0);
+
+    // Past the end there is nothing to decode
+    uint64_t const beforeEnd = history.BlocksDecoded();
+    CHECK(history.ForEachInRange(100000000, 200000000, [](PointerEvent const&) {}) == 0);
+    CHECK(history.BlocksDecoded() == beforeEnd);
+}
+
+TEST_CASE(OutOfOrderBlocksStillScan)
+{
+    // A pointer whose clock jumps back: its blocks can't be binary searched
+    PointerHistory history;
+    auto first = Stroke(1, 10000000, PointerHistory::BlockSamples, 4);
+    auto second = Stroke(1, 0, PointerHistory::BlockSamples, 5);
+    for (auto const& event : first)
+    {
+        history.Append(event);
+    }
+    for (auto const& event : second)
+    {
+        history.Append(event);
+    }
+
+    std::vector<PointerEvent> out;
+    history.Query(100000, 200000, out);
+    CHECK(out.size() >= 99);
+    CHECK(out.size() <= 101);
+    out.clear();
+    history.Query(10100000, 10200000, out);
+    CHECK(out.size() >= 99);
+    CHECK(out.size() <= 101);
+}
+
+TEST_CASE(ExitedPointersAreSealed)
+{
+    // Thousands of taps, each a new touch contact
+    PointerHistory history;
+    uint64_t now = 0;
+    for (uint32_t id = 1; id <= 3000; ++id)
+    {
+        history.Append(Event(id, now, 10.0f, 10.0f, PointerEventKind::Entered));
+        history.Append(Event(id, now, 10.0f, 10.0f, PointerEventKind::Pressed));
+        for (int i = 1; i <= 8; ++i)
+        {
+            history.Append(Event(id, now + i * 1000, 10.0f + i, 10.0f));
+        }
+        history.Append(Event(id, now + 9000, 18.0f, 10.0f, PointerEventKind::Released));
+        history.Append(Event(id, now + 9000, 18.0f, 10.0f, PointerEventKind::Exited));
+        now += 500000;
+    }
+
+    // Nothing left open, and everything still there
+    CHECK(history.PointerCount() == 3000);
+    CHECK(history.BlockCount() == 3000);
+    CHECK(history.OpenBytes() == 0);
+    CHECK(history.EventCount() == 3000 * 12);
+    std::vector<PointerEvent> out;
+    history.Query(0, UINT64_MAX, out);
+    CHECK(out.size() == 3000 * 12);
+
+    // A pointer that comes back carries on
+    history.Append(Event(5, now, 1.0f, 1.0f, PointerEventKind::Entered));
+    CHECK(history.ForEachOfPointer(5, 0, UINT64_MAX, [](PointerEvent const&) {}) == 13);
+}
+
+TEST_CASE(ShortLivedPointersAreForgotten)
+{
+    // 100k taps, each a new touch contact, alongside a pen that never
+    // leaves: exited pointers go with their last block, so the pointers
+    // kept stay bounded by what fits in MaxBytes
+    PointerHistory::Options options;
+    options.MaxBytes = 64 * 1024;
+    PointerHistory history(options);
+    uint64_t now = 0;
+    size_t mostPointers = 0;
+    uint64_t appended = 0;
+    for (uint32_t id = 1; id <= 100000; ++id)
+    {
+        history.Append(Event(id, now, 10.0f, 10.0f, PointerEventKind::Entered));
+        history.Append(Event(id, now + 100, 10.0f, 10.0f, PointerEventKind::Pressed));
+        history.Append(Event(0, now + 200, static_cast<float>(id % 1000), 5.0f));
+        history.Append(Event(id, now + 300, 12.0f, 10.0f, PointerEventKind::Released));
+        history.Append(Event(id, now + 400, 12.0f, 10.0f, PointerEventKind::Exited));
+        appended += 5;
+        now += 1000;
+        mostPointers = std::max(mostPointers, history.PointerCount());
+    }
+
+    CHECK(history.CompressedBytes() <= options.MaxBytes);
+    CHECK(history.EventCount() + history.EvictedEventCount() == appended);
+    CHECK(mostPointers < 2000);
+    CHECK(history.PointerCount() <= history.BlockCount() + 1);
+
+    // The taps kept are the newest ones, with nothing missing in between,
+    // and the pen is still there
+    uint32_t oldestTap = UINT32_MAX;
+    size_t taps = 0;
+    history.ForEachInRange(0, UINT64_MAX, [&](PointerEvent const& event)
+    {
+        if ((event.Id != 0) && (event.Kind == PointerEventKind::Exited))
+        {
+            oldestTap = std::min(oldestTap, event.Id);
+            ++taps;
+        }
+    });
+    CHECK(taps > 0);
+    CHECK(oldestTap + taps == 100001);
+    CHECK(history.ForEachOfPointer(0, 0, UINT64_MAX, [](PointerEvent const&) {}) > 0);
+
+    // IDs that were forgotten can come back
+    history.Append(Event(1, now, 1.0f, 1.0f, PointerEventKind::Entered));
+    CHECK(history.ForEachOfPointer(1, 0, UINT64_MAX, [](PointerEvent const&) {}) == 1);
+}
+
+TEST_CASE(ExitOnAFullBlockIsForgottenToo)
+{
+    // Contacts whose exit is the sample that fills the open block
+    PointerHistory::Options options;
+    options.MaxBytes = 1;
+    PointerHistory history(options);
+    for (uint32_t id = 1; id <= 100; ++id)
+    {
+        uint64_t const start = id * 1000000ull;
+        for (size_t i = 0; i + 1 < PointerHistory::BlockSamples; ++i)
+        {
+            history.Append(Event(id, start + i * 1000, 10.0f, 10.0f));
+        }
+        history.Append(Event(id, start + PointerHistory::BlockSamples * 1000, 10.0f, 10.0f, PointerEventKind::Exited));
+    }
+
+    CHECK(history.BlockCount() == 0);
+    CHECK(history.EventCount() == 0);
+    CHECK(history.OpenBytes() == 0);
+    CHECK(history.PointerCount() == 0);
+}
+
+TEST_CASE(EvictsTheOldestBlocks)
+{
+    PointerHistory::Options options;
+    options.MaxBytes = 16 * 1024;
+    PointerHistory history(options);
+    for (auto const& event : Stroke(1, 0, 100 * PointerHistory::BlockSamples, 6))
+    {
+        history.Append(event);
+    }
+
+    CHECK(history.CompressedBytes() <= options.MaxBytes);
+    CHECK(history.EvictedEventCount() > 0);
+    CHECK(history.EventCount() + history.EvictedEventCount() == 100 * PointerHistory::BlockSamples);
+
+    // What's left is the newest
+    std::vector<PointerEvent> out;
+    history.Query(0, UINT64_MAX, out);
+    CHECK(out.size() == history.EventCount());
+    CHECK(out.front().Timestamp >= history.EvictedEventCount() * 1000);
+
+    history.Clear();
+    CHECK(history.EventCount() == 0);
+    CHECK(history.PointerCount() == 0);
+    CHECK(history.CompressedBytes() == 0);
+}
@@ -0,0 +1,309 @@
+#include "PointerLifecycle.h"
+#include "TestHarness.h"
+
+#include <random>
+#include <unordered_map>
+
+using namespace PointerCore;
+
+namespace
+{
+    using State = PointerLifecycle::State;
+    using Anomaly = PointerLifecycle::Anomaly;
+
+    PointerEvent Event(uint32_t id, PointerEventKind kind, bool inContact, uint64_t timestamp = 0)
+    {
+        return { timestamp, 0, id, static_cast<float>(timestamp), 1.0f, inContact ? 0.5f : 0.0f, kind, PointerDeviceKind::Touch, inContact };
+    }
+
+    std::vector<PointerEvent> Process(PointerLifecycle& lifecycle, PointerEvent const& event)
+    {
+        std::vector<PointerEvent> delivered;
+        size_t const count = lifecycle.Process(event, [&](PointerEvent const& valid) { delivered.push_back(valid); });
+        CHECK(count == delivered.size());
+        return delivered;
+    }
+
+    // The state a valid event leaves its pointer in, or Count if the event
+    // isn't valid from the given state
+    State ValidNext(State current, PointerEvent const& event)
+    {
+        switch (event.Kind)
+        {
+        case PointerEventKind::Entered:
+            return (current == State::Absent) ? State::Hovering : State::Count;
+        case PointerEventKind::Exited:
+            return (current == State::Hovering) ? State::Absent : State::Count;
+        case PointerEventKind::Moved:
+            if (current == State::Absent)
+            {
+                return State::Count;
+            }
+            return ((current == State::Pressed) == event.InContact) ? current : State::Count;
+        case PointerEventKind::Pressed:
+            return (current == State::Hovering) ? State::Pressed : State::Count;
+        case PointerEventKind::Released:
+            return (current == State::Pressed) ? State::Hovering : State::Count;
+        }
+        return State::Count;
+    }
+}
+
+TEST_CASE(ValidSequencesPassThrough)
+{
+    PointerLifecycle lifecycle;
+    PointerEvent const events[] =
+    {
+        Event(1, PointerEventKind::Entered, false, 1),
+        Event(1, PointerEventKind::Moved, false, 2),
+        Event(1, PointerEventKind::Pressed, true, 3),
+        Event(1, PointerEventKind::Moved, true, 4),
+        Event(1, PointerEventKind::Released, false, 5),
+        Event(1, PointerEventKind::Exited, false, 6),
+    };
+    State const states[] = { State::Hovering, State::Hovering, State::Pressed, State::Pressed, State::Hovering, State::Absent };
+
+    for (size_t i = 0; i < std::size(events); ++i)
+    {
+        auto const delivered = Process(lifecycle, events[i]);
+        REQUIRE(delivered.size() == 1);
+        CHECK(delivered[0].Kind == events[i].Kind);
+        CHECK(delivered[0].Timestamp == events[i].Timestamp);
+        CHECK(lifecycle.PointerState(1) == states[i]);
+    }
+
+    CHECK(lifecycle.TrackedCount() == 0);
+    CHECK(lifecycle.TotalAnomalies() == 0);
+    CHECK(lifecycle.AnomalyCount(Anomaly::None) == 6);
+}
+
+TEST_CASE(MissingEventsAreSynthesized)
+{
+    PointerLifecycle lifecycle;
+
+    // A move in contact from nowhere needs an enter and a press first, both
+    // at the move's position and time
+    auto delivered = Process(lifecycle, Event(3, PointerEventKind::Moved, true, 10));
+    REQUIRE(delivered.size() == 3);
+    CHECK(delivered[0].Kind == PointerEventKind::Entered);
+    CHECK(!delivered[0].InContact);
+    CHECK(delivered[1].Kind == PointerEventKind::Pressed);
+    CHECK(delivered[1].InContact);
+    CHECK(delivered[2].Kind == PointerEventKind::Moved);
+    for (auto const& event : delivered)
+    {
+        CHECK(event.Id == 3);
+        CHECK(event.Timestamp == 10);
+        CHECK(event.X == 10.0f);
+    }
+    CHECK(lifecycle.PointerState(3) == State::Pressed);
+    CHECK(lifecycle.AnomalyCount(Anomaly::MissingEnter) == 1);
+    CHECK(lifecycle.AnomalyCount(Anomaly::MissingPress) == 1);
+
+    // Leaving contact without a release
+    delivered = Process(lifecycle, Event(3, PointerEventKind::Moved, false, 11));
+    REQUIRE(delivered.size() == 2);
+    CHECK(delivered[0].Kind == PointerEventKind::Released);
+    CHECK(!delivered[0].InContact);
+    CHECK(delivered[1].Kind == PointerEventKind::Moved);
+    CHECK(lifecycle.PointerState(3) == State::Hovering);
+
+    // Exiting while pressed releases first
+    Process(lifecycle, Event(3, PointerEventKind::Pressed, true, 12));
+    delivered = Process(lifecycle, Event(3, PointerEventKind::Exited, false, 13));
+    REQUIRE(delivered.size() == 2);
+    CHECK(delivered[0].Kind == PointerEventKind::Released);
+    CHECK(delivered[1].Kind == PointerEventKind::Exited);
+    CHECK(lifecycle.PointerState(3) == State::Absent);
+    CHECK(lifecycle.AnomalyCount(Anomaly::MissingRelease) == 2);
+
+    // A press from nowhere only needs the enter
+    delivered = Process(lifecycle, Event(4, PointerEventKind::Pressed, true, 14));
+    REQUIRE(delivered.size() == 2);
+    CHECK(delivered[0].Kind == PointerEventKind::Entered);
+    CHECK(delivered[1].Kind == PointerEventKind::Pressed);
+    CHECK(lifecycle.AnomalyCount(Anomaly::MissingEnter) == 2);
+    CHECK(lifecycle.TotalAnomalies() == 5);
+}
+
+TEST_CASE(DuplicatesAndStrayEventsAreDropped)
+{
+    PointerLifecycle lifecycle;
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Exited, false)).empty());
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Released, false)).empty());
+    CHECK(lifecycle.TrackedCount() == 0);
+    CHECK(lifecycle.AnomalyCount(Anomaly::UntrackedExit) == 1);
+    CHECK(lifecycle.AnomalyCount(Anomaly::UnmatchedRelease) == 1);
+
+    Process(lifecycle, Event(1, PointerEventKind::Entered, false));
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Entered, false)).empty());
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Released, false)).empty());
+    Process(lifecycle, Event(1, PointerEventKind::Pressed, true));
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Pressed, true)).empty());
+    CHECK(Process(lifecycle, Event(1, PointerEventKind::Entered, true)).empty());
+
+    CHECK(lifecycle.PointerState(1) == State::Pressed);
+    CHECK(lifecycle.AnomalyCount(Anomaly::DuplicateEnter) == 2);
+    CHECK(lifecycle.AnomalyCount(Anomaly::UnmatchedRelease) == 2);
+    CHECK(lifecycle.AnomalyCount(Anomaly::DuplicatePress) == 1);
+    CHECK(lifecycle.TotalAnomalies() == 6);
+
+    // Unknown kinds don't touch state or counters
+    PointerEvent corrupt = Event(1, PointerEventKind::Exited, false);
+    corrupt.Kind = static_cast<PointerEventKind>(200);
+    CHECK(Process(lifecycle, corrupt).empty());
+    CHECK(lifecycle.PointerState(1) == State::Pressed);
+    CHECK(lifecycle.TotalAnomalies() == 6);
+
+    lifecycle.ResetAnomalies();
+    CHECK(lifecycle.TotalAnomalies() == 0);
+    CHECK(lifecycle.AnomalyCount(Anomaly::None) == 0);
+    CHECK(lifecycle.PointerState(1) == State::Pressed);
+}
+
+TEST_CASE(ContactMismatchesAreAppliedAndCounted)
+{
+    PointerLifecycle lifecycle;
+    Process(lifecycle, Event(1, PointerEventKind::Entered, false));
+
+    auto delivered = Process(lifecycle, Event(1, PointerEventKind::Pressed, false));
+    REQUIRE(delivered.size() == 1);
+    CHECK(delivered[0].Kind == PointerEventKind::Pressed);
+    CHECK(lifecycle.PointerState(1) == State::Pressed);
+
+    delivered = Process(lifecycle, Event(1, PointerEventKind::Released, true));
+    REQUIRE(delivered.size() == 1);
+    CHECK(delivered[0].Kind == PointerEventKind::Released);
+    CHECK(lifecycle.PointerState(1) == State::Hovering);
+    CHECK(lifecycle.AnomalyCount(Anomaly::ContactMismatch) == 2);
+}
+
+TEST_CASE(OverflowDropsNewPointers)
+{
+    PointerLifecycle lifecycle(2);
+    Process(lifecycle, Event(1, PointerEventKind::Entered, false));
+    Process(lifecycle, Event(2, PointerEventKind::Entered, false));
+
+    CHECK(Process(lifecycle, Event(3, PointerEventKind::Entered, false)).empty());
+    CHECK(Process(lifecycle, Event(3, PointerEventKind::Moved, true)).empty());
+    CHECK(lifecycle.AnomalyCount(Anomaly::Overflow) == 2);
+    CHECK(lifecycle.AnomalyCount(Anomaly::MissingEnter) == 0);
+    CHECK(lifecycle.PointerState(3) == State::Absent);
+    CHECK(lifecycle.TrackedCount() == 2);
+
+    // Stray events for an untracked pointer are still just dropped
+    CHECK(Process(lifecycle, Event(3, PointerEventKind::Exited, false)).empty());
+    CHECK(lifecycle.AnomalyCount(Anomaly::Overflow) == 2);
+
+    // Room frees up when a pointer leaves
+    Process(lifecycle, Event(1, PointerEventKind::Exited, false));
+    CHECK(Process(lifecycle, Event(3, PointerEventKind::Entered, false)).size() == 1);
+    CHECK(lifecycle.PointerState(3) == State::Hovering);
+    CHECK(lifecycle.PointerState(2) == State::Hovering);
+}
+
+TEST_CASE(ForgetFromTheSinkEndsTheEvent)
+{
+    // A consumer with no room forgets the pointer when it's entered. The
+    // original event must not loop on synthesized enters.
+    PointerLifecycle lifecycle;
+    size_t calls = 0;
+    size_t const delivered = lifecycle.Process(Event(5, PointerEventKind::Moved, true), [&](PointerEvent const& valid)
+    {
+        ++calls;
+        CHECK(valid.Kind == PointerEventKind::Entered);
+        lifecycle.Forget(valid.Id);
+    });
+    CHECK(delivered == 1);
+    CHECK(calls == 1);
+    CHECK(lifecycle.PointerState(5) == State::Absent);
+    CHECK(lifecycle.TrackedCount() == 0);
+
+    // Forgetting outside a sink, and forgetting an unknown pointer
+    Process(lifecycle, Event(6, PointerEventKind::Pressed, true));
+    Process(lifecycle, Event(7, PointerEventKind::Entered, false));
+    lifecycle.Forget(6);
+    lifecycle.Forget(99);
+    CHECK(lifecycle.TrackedCount() == 1);
+    CHECK(lifecycle.PointerState(6) == State::Absent);
+    CHECK(lifecycle.PointerState(7) == State::Hovering);
+
+    lifecycle.Clear();
+    CHECK(lifecycle.TrackedCount() == 0);
+    CHECK(lifecycle.PointerState(7) == State::Absent);
+}
+
+TEST_CASE(RandomSequencesAlwaysComeOutValid)
+{
+    // Random events for a handful of pointers, most of them out of order.
+    // Whatever goes in, what comes out must be a valid sequence per pointer,
+    // every original event must be either delivered last or counted as
+    // dropped, and every synthesized event counted as an anomaly.
+    std::mt19937 random(1234);
+    for (size_t capacity : { 3, 16 })
+    {
+        PointerLifecycle lifecycle(capacity);
+        std::unordered_map<uint32_t, State> model;
+        uint64_t applied = 0;
+        uint64_t synthesized = 0;
+        uint64_t dropped = 0;
+
+        for (uint64_t step = 0; step < 200000; ++step)
+        {
+            auto const id = static_cast<uint32_t>(random() % 6);
+            auto const kind = static_cast<PointerEventKind>(random() % 5);
+            PointerEvent const event = Event(id, kind, (random() % 2) != 0, step);
+
+            auto const delivered = Process(lifecycle, event);
+            for (size_t i = 0; i < delivered.size(); ++i)
+            {
+                auto const& valid = delivered[i];
+                REQUIRE(valid.Id == id);
+                CHECK(valid.Timestamp == step);
+
+                State const current = model.count(id) ? model[id] : State::Absent;
+                State const next = ValidNext(current, valid);
+                REQUIRE(next != State::Count);
+                if (next == State::Absent)
+                {
+                    model.erase(id);
+                }
+                else
+                {
+                    model[id] = next;
+                }
+            }
+
+            // Synthesized events come first; nothing is dropped after them
+            if (delivered.empty())
+            {
+                ++dropped;
+            }
+            else
+            {
+                CHECK(delivered.back().Kind == kind);
+                CHECK(delivered.back().InContact == event.InContact);
+                synthesized += delivered.size() - 1;
+                ++applied;
+            }
+
+            CHECK(model.size() <= capacity);
+            CHECK(lifecycle.TrackedCount() == model.size());
+            CHECK(lifecycle.PointerState(id) == (model.count(id) ? model[id] : State::Absent));
+        }
+
+        uint64_t const missing = lifecycle.AnomalyCount(Anomaly::MissingEnter) + lifecycle.AnomalyCount(Anomaly::MissingPress) + lifecycle.AnomalyCount(Anomaly::MissingRelease);
+        uint64_t const discarded = lifecycle.AnomalyCount(Anomaly::DuplicateEnter) + lifecycle.AnomalyCount(Anomaly::UntrackedExit) +
+            lifecycle.AnomalyCount(Anomaly::DuplicatePress) + lifecycle.AnomalyCount(Anomaly::UnmatchedRelease) + lifecycle.AnomalyCount(Anomaly::Overflow);
+        CHECK(synthesized == missing);
+        CHECK(dropped == discarded);
+        CHECK(applied + dropped == 200000);
+        CHECK(lifecycle.AnomalyCount(Anomaly::None) + lifecycle.AnomalyCount(Anomaly::ContactMismatch) == applied);
+        CHECK(lifecycle.AnomalyCount(Anomaly::MissingEnter) > 0);
+        CHECK(lifecycle.AnomalyCount(Anomaly::DuplicatePress) > 0);
+        if (capacity == 3)
+        {
+            CHECK(lifecycle.AnomalyCount(Anomaly::Overflow) > 0);
+        }
+    }
+}
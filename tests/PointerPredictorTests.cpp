@@ -0,0 +1,226 @@
+#include "PointerPredictor.h"
+#include "TestHarness.h"
+
+#include <random>
+#include <unordered_map>
+
+using namespace PointerCore;
+
+namespace
+{
+    constexpr uint64_t SampleInterval = 4000;   // 250 Hz, in microseconds
+
+    PointerPredictor::Options MakeOptions(PredictionModel model, uint32_t horizon = 16000)
+    {
+        PointerPredictor::Options options;
+        options.Model = model;
+        options.HorizonMicroseconds = horizon;
+        options.MaxDistance = 1000.0f;
+        return options;
+    }
+
+    // Feeds count samples moving at (vx, vy) DIPs per second from (x, y), starting at time start
+    void FeedLine(PointerPredictor& predictor, uint32_t id, float x, float y, float vx, float vy, size_t count, uint64_t start = 1000)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            float const t = static_cast<float>(i * SampleInterval) * 1e-6f;
+            predictor.AddSample(id, { x + vx * t, y + vy * t, start + i * SampleInterval, 0.5f });
+        }
+    }
+}
+
+TEST_CASE(NeedsTwoSamplesAndAModel)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity));
+    Point predicted;
+    CHECK(!predictor.Predict(1, predicted));
+
+    predictor.AddSample(1, { 10.0f, 10.0f, 1000, 0.5f });
+    CHECK(!predictor.Predict(1, predicted));
+
+    predictor.AddSample(1, { 14.0f, 10.0f, 1000 + SampleInterval, 0.5f });
+    CHECK(predictor.Predict(1, predicted));
+
+    predictor.SetOptions(MakeOptions(PredictionModel::None));
+    CHECK(!predictor.Predict(1, predicted));
+}
+
+TEST_CASE(ConstantVelocityExtrapolatesALine)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity, 16000));
+    FeedLine(predictor, 1, 100.0f, 200.0f, 1000.0f, -500.0f, 20);
+
+    // The last sample is at 19 * 4 ms = 76 ms, so 16 ms ahead is 92 ms
+    Point predicted;
+    REQUIRE(predictor.Predict(1, predicted));
+    CHECK_NEAR(predicted.X, 100.0 + 1000.0 * 0.092, 0.05);
+    CHECK_NEAR(predicted.Y, 200.0 - 500.0 * 0.092, 0.05);
+}
+
+TEST_CASE(KalmanConvergesOnALine)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::Kalman, 16000));
+    FeedLine(predictor, 1, 100.0f, 200.0f, 1000.0f, -500.0f, 60);
+
+    Point predicted;
+    REQUIRE(predictor.Predict(1, predicted));
+    double const t = (59 * SampleInterval + 16000) * 1e-6;
+    CHECK_NEAR(predicted.X, 100.0 + 1000.0 * t, 0.5);
+    CHECK_NEAR(predicted.Y, 200.0 - 500.0 * t, 0.5);
+}
+
+TEST_CASE(StationaryPointerIsNotDisplaced)
+{
+    for (auto model : { PredictionModel::ConstantVelocity, PredictionModel::Kalman })
+    {
+        PointerPredictor predictor(MakeOptions(model));
+        FeedLine(predictor, 1, 50.0f, 60.0f, 0.0f, 0.0f, 30);
+
+        Point predicted;
+        REQUIRE(predictor.Predict(1, predicted));
+        CHECK_NEAR(predicted.X, 50.0, 1e-3);
+        CHECK_NEAR(predicted.Y, 60.0, 1e-3);
+    }
+}
+
+TEST_CASE(DisplacementIsCapped)
+{
+    auto options = MakeOptions(PredictionModel::ConstantVelocity, 50000);
+    options.MaxDistance = 10.0f;
+    PointerPredictor predictor(options);
+    FeedLine(predictor, 1, 0.0f, 0.0f, 3000.0f, 4000.0f, 5);
+
+    // 50 ms at 5000 DIPs/s would be 250 DIPs; the cap keeps the direction
+    Point predicted;
+    REQUIRE(predictor.Predict(1, predicted));
+    double const lastX = 3000.0 * 4 * SampleInterval * 1e-6;
+    double const lastY = 4000.0 * 4 * SampleInterval * 1e-6;
+    CHECK_NEAR(predicted.X - lastX, 6.0, 1e-3);
+    CHECK_NEAR(predicted.Y - lastY, 8.0, 1e-3);
+}
+
+TEST_CASE(GapsAndBackwardTimeRestartTheEstimate)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity));
+    FeedLine(predictor, 1, 0.0f, 0.0f, 1000.0f, 0.0f, 5);
+
+    Point predicted;
+    CHECK(predictor.Predict(1, predicted));
+
+    // A long gap: one sample isn't enough to predict again
+    uint64_t const later = 1000 + 4 * SampleInterval + predictor.GetOptions().MaxSampleGapMicroseconds + 1;
+    predictor.AddSample(1, { 500.0f, 0.0f, later, 0.5f });
+    CHECK(!predictor.Predict(1, predicted));
+
+    // Going forward again from there predicts from the new motion only
+    predictor.AddSample(1, { 500.0f, 4.0f, later + SampleInterval, 0.5f });
+    REQUIRE(predictor.Predict(1, predicted));
+    CHECK_NEAR(predicted.X, 500.0, 1e-3);
+    CHECK_NEAR(predicted.Y, 4.0 + 1000.0 * 0.016, 1e-2);
+
+    // Time going backwards
+    predictor.AddSample(1, { 0.0f, 0.0f, 10, 0.5f });
+    CHECK(!predictor.Predict(1, predicted));
+}
+
+TEST_CASE(ApplyPredictsToThePresentUntilPointersStop)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity));
+    PointerTable display;
+    display.Insert(1, PointerDeviceKind::Pen, true, { 0.0f, 0.0f });
+    display.Insert(2, PointerDeviceKind::Touch, true, { 7.0f, 7.0f });
+
+    // The last sample is at x = 16 and t = 17 ms
+    FeedLine(predictor, 1, 0.0f, 0.0f, 1000.0f, 0.0f, 5);
+    uint64_t const last = 1000 + 4 * SampleInterval;
+
+    display.SetPosition(display.Find(1), { 16.0f, 0.0f });
+    CHECK(predictor.Apply(display, last + 16000) == 1);
+    CHECK_NEAR(display.Position(display.Find(1)).X, 32.0, 1e-2);
+    CHECK(display.Position(display.Find(2)).X == 7.0f);
+
+    // Frames between samples keep predicting, from the last sample to the
+    // present rather than one fixed horizon past it
+    display.SetPosition(display.Find(1), { 16.0f, 0.0f });
+    CHECK(predictor.Apply(display, last + 24000) == 1);
+    CHECK_NEAR(display.Position(display.Find(1)).X, 40.0, 1e-2);
+
+    // A present time before the last sample doesn't extrapolate backwards
+    display.SetPosition(display.Find(1), { 16.0f, 0.0f });
+    CHECK(predictor.Apply(display, last - 8000) == 1);
+    CHECK_NEAR(display.Position(display.Find(1)).X, 16.0, 1e-2);
+
+    // No sample for a whole gap: the pointer has stopped, and the display
+    // shows the real position
+    display.SetPosition(display.Find(1), { 16.0f, 0.0f });
+    CHECK(predictor.Apply(display, last + predictor.GetOptions().MaxSampleGapMicroseconds + 1) == 0);
+    CHECK(display.Position(display.Find(1)).X == 16.0f);
+
+    // A tracked pointer missing from the display is skipped
+    predictor.Remove(1);
+    FeedLine(predictor, 3, 0.0f, 0.0f, 1000.0f, 0.0f, 5);
+    CHECK(predictor.Apply(display, last + 16000) == 0);
+}
+
+TEST_CASE(TracksAreRemovedAndBounded)
+{
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity), 2);
+    FeedLine(predictor, 1, 0.0f, 0.0f, 1000.0f, 0.0f, 3);
+    FeedLine(predictor, 2, 0.0f, 0.0f, 1000.0f, 0.0f, 3);
+    FeedLine(predictor, 3, 0.0f, 0.0f, 1000.0f, 0.0f, 3);
+
+    Point predicted;
+    CHECK(predictor.Predict(1, predicted));
+    CHECK(predictor.Predict(2, predicted));
+    CHECK(!predictor.Predict(3, predicted));
+
+    predictor.Remove(1);
+    CHECK(!predictor.Predict(1, predicted));
+    CHECK(predictor.Predict(2, predicted));
+
+    FeedLine(predictor, 3, 0.0f, 0.0f, 1000.0f, 0.0f, 3);
+    CHECK(predictor.Predict(3, predicted));
+
+    predictor.Clear();
+    CHECK(!predictor.Predict(2, predicted));
+    CHECK(!predictor.Predict(3, predicted));
+}
+
+TEST_CASE(MatchesMapUnderRandomOperations)
+{
+    // IDs drawn from a range wider than the capacity, so probe runs keep
+    // growing and being shifted back by removals
+    std::mt19937 random{ 2468 };
+    PointerPredictor predictor(MakeOptions(PredictionModel::ConstantVelocity), 64);
+    std::unordered_map<uint32_t, size_t> sampleCounts;
+
+    for (uint64_t step = 1; step <= 20000; ++step)
+    {
+        uint32_t const id = random() % 100;
+        switch (random() % 3)
+        {
+        case 0:
+            predictor.AddSample(id, { static_cast<float>(step), 0.0f, step * 10, 0.5f });
+            if ((sampleCounts.count(id) != 0) || (sampleCounts.size() < 64))
+            {
+                ++sampleCounts[id];
+            }
+            break;
+
+        case 1:
+            predictor.Remove(id);
+            sampleCounts.erase(id);
+            break;
+
+        default:
+        {
+            // Two samples are needed before there's a prediction
+            Point predicted;
+            auto const found = sampleCounts.find(id);
+            CHECK(predictor.Predict(id, predicted) == ((found != sampleCounts.end()) && (found->second >= 2)));
+            break;
+        }
+        }
+    }
+}
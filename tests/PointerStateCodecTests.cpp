@@ -0,0 +1,480 @@
+#include "PointerStateCodec.h"
+#include "TestHarness.h"
+#include "Varint.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <random>
+
+using namespace PointerCore;
+
+namespace
+{
+    using Result = PointerStateDecoder::Result;
+
+    struct Pointer
+    {
+        uint32_t Id;
+        float X;
+        float Y;
+        float Pressure;
+        PointerDeviceKind DeviceKind;
+        bool Pressed;
+    };
+
+    // The table's pointers sorted by ID
+    std::vector<Pointer> Contents(PointerTable const& table)
+    {
+        std::vector<Pointer> pointers;
+        for (size_t i = 0; i < table.Size(); ++i)
+        {
+            pointers.push_back({ table.Id(i), table.Position(i).X, table.Position(i).Y, table.Pressure(i), table.Type(i), table.IsPressed(i) });
+        }
+        std::sort(pointers.begin(), pointers.end(), [](Pointer const& a, Pointer const& b) { return a.Id < b.Id; });
+        return pointers;
+    }
+
+    bool Same(std::vector<Pointer> const& a, std::vector<Pointer> const& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if ((a[i].Id != b[i].Id) || (a[i].X != b[i].X) || (a[i].Y != b[i].Y) || (a[i].Pressure != b[i].Pressure) ||
+                (a[i].DeviceKind != b[i].DeviceKind) || (a[i].Pressed != b[i].Pressed))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Pointers coming and going, moving, pressing and changing pressure,
+    // with values on the codec's fixed-point grid so round trips are exact
+    class Session
+    {
+    public:
+        explicit Session(uint32_t seed, size_t capacity = 64) : m_random{ seed }, m_table(capacity) {}
+
+        PointerTable const& Table() const noexcept { return m_table; }
+
+        void Step()
+        {
+            if ((m_table.Size() < m_table.Capacity()) && ((m_random() % 8) == 0))
+            {
+                auto const id = static_cast<uint32_t>(((m_random() % 4) == 0) ? m_random() : m_random() % 100);
+                size_t const index = m_table.Insert(id, static_cast<PointerDeviceKind>(m_random() % 3), (m_random() % 2) != 0, { Coordinate(), Coordinate() });
+                if (index != PointerTable::npos)
+                {
+                    m_table.SetPressure(index, Pressure());
+                }
+            }
+
+            if (!m_table.Empty() && ((m_random() % 10) == 0))
+            {
+                m_table.EraseAt(m_random() % m_table.Size());
+            }
+
+            for (size_t i = 0; i < m_table.Size(); ++i)
+            {
+                switch (m_random() % 6)
+                {
+                case 0:
+                    m_table.SetPosition(i, { Coordinate(), Coordinate() });
+                    break;
+                case 1:
+                    m_table.SetPosition(i, { m_table.Position(i).X + 0.25f, m_table.Position(i).Y });
+                    break;
+                case 2:
+                    m_table.SetPressed(i, !m_table.IsPressed(i));
+                    break;
+                case 3:
+                    m_table.SetPressure(i, Pressure());
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+    private:
+        float Coordinate() { return static_cast<float>(static_cast<int32_t>(m_random() % 400000) - 100000) / PointerStateCodec::PositionScale; }
+        float Pressure() { return static_cast<float>(m_random() % (PointerStateCodec::PressureScale + 1)) / PointerStateCodec::PressureScale; }
+
+        std::mt19937 m_random;
+        PointerTable m_table;
+    };
+}
+
+TEST_CASE(VarintRoundTrips)
+{
+    uint64_t const values[] = { 0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, uint64_t{ 1 } << 63, UINT64_MAX };
+    std::vector<uint8_t> buffer;
+    for (uint64_t value : values)
+    {
+        Varint::Write(buffer, value);
+    }
+    CHECK(buffer.size() == 1 + 1 + 1 + 2 + 2 + 2 + 3 + 5 + 10 + 10);
+
+    uint8_t const* cursor = buffer.data();
+    for (uint64_t value : values)
+    {
+        uint64_t read = 0;
+        CHECK(Varint::Read(cursor, buffer.data() + buffer.size(), read));
+        CHECK(read == value);
+    }
+    CHECK(cursor == buffer.data() + buffer.size());
+
+    // Zigzag keeps small magnitudes small either side of zero
+    int64_t const signedValues[] = { 0, -1, 1, -64, 63, -65, INT64_MIN, INT64_MAX };
+    uint64_t const zigzagged[] = { 0, 1, 2, 127, 126, 129, UINT64_MAX, UINT64_MAX - 1 };
+    buffer.clear();
+    for (size_t i = 0; i < std::size(signedValues); ++i)
+    {
+        CHECK(Varint::ZigZagEncode(signedValues[i]) == zigzagged[i]);
+        Varint::WriteSigned(buffer, signedValues[i]);
+    }
+
+    cursor = buffer.data();
+    for (int64_t value : signedValues)
+    {
+        int64_t read = 0;
+        CHECK(Varint::ReadSigned(cursor, buffer.data() + buffer.size(), read));
+        CHECK(read == value);
+    }
+
+    // Truncated, and longer than any 64-bit value
+    uint8_t const truncated[] = { 0x80, 0x80 };
+    cursor = truncated;
+    uint64_t value = 0;
+    CHECK(!Varint::Read(cursor, truncated + 2, value));
+    uint8_t const tooLong[11] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+    cursor = tooLong;
+    CHECK(!Varint::Read(cursor, tooLong + 11, value));
+}
+
+TEST_CASE(EveryFrameRoundTrips)
+{
+    // The observer acknowledges every frame, so each delta is against the previous one
+    Session session(1);
+    PointerStateEncoder encoder;
+    PointerStateDecoder decoder;
+    PointerTable decoded;
+    std::vector<uint8_t> frame;
+    size_t keyframeBytes = 0;
+    size_t deltaBytes = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        session.Step();
+        frame.clear();
+        uint64_t const sequence = encoder.Encode(session.Table(), frame);
+        CHECK(sequence == static_cast<uint64_t>(i));
+        REQUIRE(decoder.Decode(frame.data(), frame.size(), decoded) == Result::Decoded);
+        CHECK(decoder.LastSequence() == sequence);
+        REQUIRE(Same(Contents(session.Table()), Contents(decoded)));
+        encoder.Acknowledge(decoder.LastSequence());
+
+        // Decoded tables come out in ID order
+        for (size_t j = 1; j < decoded.Size(); ++j)
+        {
+            CHECK(decoded.Id(j - 1) < decoded.Id(j));
+        }
+
+        ((frame[0] & 1) ? keyframeBytes : deltaBytes) += frame.size();
+    }
+
+    CHECK(encoder.FrameCount() == 5000);
+    CHECK(encoder.KeyframeCount() == 1 + 4999 / 120);
+    CHECK(deltaBytes / (5000 - encoder.KeyframeCount()) < keyframeBytes / encoder.KeyframeCount());
+}
+
+TEST_CASE(UnchangedFramesAreTiny)
+{
+    PointerTable table;
+    table.Insert(5, PointerDeviceKind::Pen, true, { 100.0f, 200.0f });
+    table.Insert(2, PointerDeviceKind::Touch, false, { 10.5f, -20.25f });
+    table.SetPressure(0, 0.75f);
+
+    PointerStateEncoder encoder;
+    PointerStateDecoder decoder;
+    PointerTable decoded;
+    std::vector<uint8_t> frame;
+    encoder.Encode(table, frame);
+    REQUIRE(decoder.Decode(frame.data(), frame.size(), decoded) == Result::Decoded);
+    encoder.Acknowledge(decoder.LastSequence());
+
+    // Header, sequence, distance and two zero counts
+    frame.clear();
+    encoder.Encode(table, frame);
+    CHECK(frame.size() == 5);
+    REQUIRE(decoder.Decode(frame.data(), frame.size(), decoded) == Result::Decoded);
+    CHECK(Same(Contents(table), Contents(decoded)));
+
+    // One coordinate changing costs a tag, an ID and one small delta
+    table.SetPosition(table.Find(5), { 100.5f, 200.0f });
+    frame.clear();
+    encoder.Encode(table, frame);
+    CHECK(frame.size() == 5 + 3);
+    REQUIRE(decoder.Decode(frame.data(), frame.size(), decoded) == Result::Decoded);
+    CHECK(Same(Contents(table), Contents(decoded)));
+
+    // Positions off the grid are rounded to it
+    table.SetPosition(table.Find(2), { 1.0f / 128.0f + 0.001f, 0.0f });
+    frame.clear();
+    encoder.Encode(table, frame);
+    REQUIRE(decoder.Decode(frame.data(), frame.size(), decoded) == Result::Decoded);
+    CHECK(decoded.Position(decoded.Find(2)).X == 1.0f / 64.0f);
+}
+
+TEST_CASE(KeyframesOnIntervalRequestAndLostBase)
+{
+    Session session(2);
+    PointerStateEncoder::Options options;
+    options.KeyframeInterval = 10;
+    options.HistoryLength = 4;
+    PointerStateEncoder encoder(options);
+    std::vector<uint8_t> frame;
+    auto const isKeyframe = [&]
+    {
+        session.Step();
+        frame.clear();
+        encoder.Encode(session.Table(), frame);
+        return (frame[0] & 1) != 0;
+    };
+
+    // Nothing acknowledged yet: every frame is a keyframe
+    CHECK(isKeyframe());
+    CHECK(isKeyframe());
+    encoder.Acknowledge(1);
+    CHECK(!isKeyframe());
+
+    encoder.RequestKeyframe();
+    CHECK(isKeyframe());
+
+    // The base falls out of the history
+    CHECK(!isKeyframe());
+    CHECK(isKeyframe());
+
+    // Acknowledgements of frames not sent yet, or older than the current base, are ignored
+    encoder.Acknowledge(5);
+    encoder.Acknowledge(6);
+    encoder.Acknowledge(100);
+    encoder.Acknowledge(2);
+    CHECK(!isKeyframe());
+
+    // And one goes out every interval regardless
+    int keyframes = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        encoder.Acknowledge(encoder.FrameCount() - 1);
+        keyframes += isKeyframe() ? 1 : 0;
+    }
+    CHECK(keyframes == 2);
+}
+
+TEST_CASE(ObserversWithLossAndReordering)
+{
+    // Three observers behind a loopback that drops and reorders frames.
+    // The presenter acknowledges the oldest frame all of them have decoded,
+    // and sends a keyframe when one of them is missing its base. Every
+    // decoded table must match the presenter's table at that sequence.
+    struct Observer
+    {
+        PointerStateDecoder Decoder;
+        PointerTable Table;
+        std::deque<std::vector<uint8_t>> Queue;
+        uint64_t Decoded{ 0 };
+    };
+
+    std::mt19937 random(3);
+    Session session(3);
+    PointerStateEncoder encoder;
+    Observer observers[3];
+    std::map<uint64_t, std::vector<Pointer>> sent;
+    uint64_t missingBase = 0;
+    uint64_t stale = 0;
+    bool matched = true;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        session.Step();
+        std::vector<uint8_t> frame;
+        uint64_t const sequence = encoder.Encode(session.Table(), frame);
+        sent[sequence] = Contents(session.Table());
+
+        for (size_t o = 0; o < std::size(observers); ++o)
+        {
+            auto& observer = observers[o];
+            uint32_t const roll = random() % 100;
+            if (roll < 5 * o)
+            {
+                continue;
+            }
+
+            if ((roll % 7) == 0 && !observer.Queue.empty())
+            {
+                observer.Queue.push_front(frame);
+            }
+            else
+            {
+                observer.Queue.push_back(frame);
+            }
+
+            // Deliver some of the queue
+            while (!observer.Queue.empty() && ((random() % 3) != 0))
+            {
+                auto const received = std::move(observer.Queue.front());
+                observer.Queue.pop_front();
+                switch (observer.Decoder.Decode(received.data(), received.size(), observer.Table))
+                {
+                case Result::Decoded:
+                    ++observer.Decoded;
+                    matched = matched && Same(sent[observer.Decoder.LastSequence()], Contents(observer.Table));
+                    break;
+                case Result::MissingBase:
+                    ++missingBase;
+                    encoder.RequestKeyframe();
+                    break;
+                case Result::Stale:
+                    ++stale;
+                    break;
+                default:
+                    matched = false;
+                    break;
+                }
+            }
+        }
+
+        uint64_t oldest = UINT64_MAX;
+        for (auto const& observer : observers)
+        {
+            oldest = observer.Decoder.HasDecoded() ? std::min(oldest, observer.Decoder.LastSequence()) : 0;
+        }
+        encoder.Acknowledge(oldest);
+
+        // Drop what nobody can ask about any more
+        while (!sent.empty() && (sent.begin()->first + 256 < sequence))
+        {
+            sent.erase(sent.begin());
+        }
+    }
+
+    CHECK(matched);
+    CHECK(stale > 0);
+    CHECK(missingBase > 0);
+    for (auto const& observer : observers)
+    {
+        CHECK(observer.Decoded > 10000);
+    }
+}
+
+TEST_CASE(DecoderRejectsBadFrames)
+{
+    PointerTable table;
+    table.Insert(1, PointerDeviceKind::Pen, true, { 1.0f, 2.0f });
+    table.Insert(9, PointerDeviceKind::Mouse, false, { 3.0f, 4.0f });
+
+    PointerStateEncoder encoder;
+    std::vector<uint8_t> keyframe;
+    encoder.Encode(table, keyframe);
+    encoder.Acknowledge(0);
+    table.SetPosition(0, { 5.0f, 2.0f });
+    table.Erase(9);
+    std::vector<uint8_t> delta;
+    encoder.Encode(table, delta);
+
+    // A delta before its base
+    PointerStateDecoder decoder;
+    PointerTable decoded;
+    CHECK(decoder.Decode(delta.data(), delta.size(), decoded) == Result::MissingBase);
+    CHECK(!decoder.HasDecoded());
+
+    // Wrong version, reserved header bits, empty
+    std::vector<uint8_t> bad = keyframe;
+    bad[0] ^= 0x20;
+    CHECK(decoder.Decode(bad.data(), bad.size(), decoded) == Result::Malformed);
+    bad = keyframe;
+    bad[0] |= 0x02;
+    CHECK(decoder.Decode(bad.data(), bad.size(), decoded) == Result::Malformed);
+    CHECK(decoder.Decode(keyframe.data(), 0, decoded) == Result::Malformed);
+
+    // Every truncation, and trailing bytes
+    for (size_t size = 1; size < keyframe.size(); ++size)
+    {
+        CHECK(decoder.Decode(keyframe.data(), size, decoded) == Result::Malformed);
+    }
+    bad = keyframe;
+    bad.push_back(0);
+    CHECK(decoder.Decode(bad.data(), bad.size(), decoded) == Result::Malformed);
+    CHECK(decoded.Empty());
+
+    // Too many pointers for the output table
+    PointerTable small(1);
+    CHECK(decoder.Decode(keyframe.data(), keyframe.size(), small) == Result::Overflow);
+    CHECK(small.Empty());
+
+    REQUIRE(decoder.Decode(keyframe.data(), keyframe.size(), decoded) == Result::Decoded);
+    CHECK(decoder.Decode(keyframe.data(), keyframe.size(), decoded) == Result::Stale);
+    for (size_t size = 1; size < delta.size(); ++size)
+    {
+        CHECK(decoder.Decode(delta.data(), size, decoded) == Result::Malformed);
+    }
+    REQUIRE(decoder.Decode(delta.data(), delta.size(), decoded) == Result::Decoded);
+    CHECK(Same(Contents(table), Contents(decoded)));
+}
+
+TEST_CASE(CorruptFramesNeverBreakTheDecoder)
+{
+    // Random bit flips and cuts in real frames. Whatever the decoder makes of
+    // them, it mustn't crash, and a frame it rejects leaves the table alone.
+    std::mt19937 random(4);
+    Session session(4, 32);
+    PointerStateEncoder encoder;
+    PointerStateDecoder clean;
+    PointerTable cleanTable;
+    size_t decoded = 0;
+    size_t rejected = 0;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        session.Step();
+        std::vector<uint8_t> frame;
+        encoder.Encode(session.Table(), frame);
+        REQUIRE(clean.Decode(frame.data(), frame.size(), cleanTable) == Result::Decoded);
+        encoder.Acknowledge(clean.LastSequence());
+
+        // A second decoder sees the same frames, some of them damaged
+        std::vector<uint8_t> damaged = frame;
+        uint32_t const flips = 1 + random() % 3;
+        for (uint32_t f = 0; f < flips; ++f)
+        {
+            damaged[random() % damaged.size()] ^= static_cast<uint8_t>(1u << (random() % 8));
+        }
+        if ((random() % 4) == 0)
+        {
+            damaged.resize(random() % damaged.size());
+        }
+
+        PointerStateDecoder decoder;
+        PointerTable table(16);
+        PointerStateDecoder::Result const result = decoder.Decode(damaged.data(), damaged.size(), table);
+        if (result == Result::Decoded)
+        {
+            ++decoded;
+            CHECK(table.Size() <= table.Capacity());
+        }
+        else
+        {
+            ++rejected;
+            CHECK(table.Empty());
+        }
+    }
+
+    CHECK(rejected > 0);
+    CHECK(decoded + rejected == 20000);
+}
@@ -0,0 +1,188 @@
+#include "PointerTable.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+using namespace PointerCore;
+
+TEST_CASE(InsertFindAndErase)
+{
+    PointerTable table(8);
+    CHECK(table.Empty());
+    CHECK(table.Capacity() == 8);
+
+    CHECK(table.Insert(10, PointerDeviceKind::Touch, false, { 1.0f, 2.0f }) == 0);
+    CHECK(table.Insert(20, PointerDeviceKind::Pen, true, { 3.0f, 4.0f }) == 1);
+    CHECK(table.Insert(30, PointerDeviceKind::Mouse, false, { 5.0f, 6.0f }) == 2);
+    CHECK(table.Size() == 3);
+
+    // Duplicate IDs are rejected
+    CHECK(table.Insert(20, PointerDeviceKind::Pen, false, { 0.0f, 0.0f }) == PointerTable::npos);
+
+    size_t const pen = table.Find(20);
+    REQUIRE(pen != PointerTable::npos);
+    CHECK(table.Type(pen) == PointerDeviceKind::Pen);
+    CHECK(table.IsPressed(pen));
+    CHECK(table.Position(pen).X == 3.0f);
+    CHECK(table.Position(pen).Y == 4.0f);
+    CHECK(table.Find(99) == PointerTable::npos);
+
+    // Erase swaps the last entry into the hole
+    CHECK(table.Erase(10));
+    CHECK(!table.Erase(10));
+    CHECK(table.Size() == 2);
+    CHECK(table.Id(0) == 30);
+    CHECK(table.Position(0).X == 5.0f);
+    CHECK(table.Type(0) == PointerDeviceKind::Mouse);
+    CHECK(!table.IsPressed(0));
+    CHECK(table.IsPressed(table.Find(20)));
+}
+
+TEST_CASE(FullTableRejectsInserts)
+{
+    PointerTable table(4);
+    for (uint32_t id = 0; id < 4; ++id)
+    {
+        CHECK(table.Insert(id, PointerDeviceKind::Touch, false, {}) == id);
+    }
+
+    CHECK(table.Full());
+    CHECK(table.Insert(4, PointerDeviceKind::Touch, false, {}) == PointerTable::npos);
+
+    CHECK(table.Erase(1));
+    CHECK(table.Insert(4, PointerDeviceKind::Touch, false, {}) != PointerTable::npos);
+}
+
+TEST_CASE(PressedBitsFollowSwapRemove)
+{
+    // More than one word of pressed bits, and erases that move entries across words
+    PointerTable table(130);
+    for (uint32_t i = 0; i < 130; ++i)
+    {
+        CHECK(table.Insert(i * 3, PointerDeviceKind::Pen, (i % 2) != 0, { static_cast<float>(i), 0.0f }) == i);
+    }
+
+    CHECK(table.PressedCount() == 65);
+    for (uint32_t i = 0; i < 130; i += 2)
+    {
+        CHECK(table.Erase(i * 3));
+    }
+
+    CHECK(table.Size() == 65);
+    CHECK(table.PressedCount() == 65);
+    for (size_t i = 0; i < table.Size(); ++i)
+    {
+        CHECK(table.IsPressed(i));
+        CHECK(static_cast<uint32_t>(table.Position(i).X) * 3 == table.Id(i));
+    }
+
+    table.SetPressed(0, false);
+    CHECK(table.PressedCount() == 64);
+
+    table.Clear();
+    CHECK(table.Empty());
+    CHECK(!table.AnyPressed());
+}
+
+TEST_CASE(ColumnsMoveTogether)
+{
+    PointerTable table(4);
+    table.Insert(1, PointerDeviceKind::Pen, true, { 1.0f, 1.0f });
+    table.Insert(2, PointerDeviceKind::Touch, false, { 2.0f, 2.0f });
+    table.SetPressure(0, 0.25f);
+    table.SetTimestamp(0, 100);
+    table.SetPendingInputTime(0, 7);
+    table.SetPressure(1, 0.75f);
+    table.SetTimestamp(1, 200);
+    table.SetPendingInputTime(1, 9);
+
+    table.EraseAt(0);
+    REQUIRE(table.Size() == 1);
+    CHECK(table.Id(0) == 2);
+    CHECK(table.Pressure(0) == 0.75f);
+    CHECK(table.Timestamp(0) == 200);
+    CHECK(table.PendingInputTime(0) == 9);
+    CHECK(table.Ids()[0] == 2);
+    CHECK(table.X()[0] == 2.0f);
+    CHECK(table.Pressures()[0] == 0.75f);
+}
+
+TEST_CASE(MatchesMapUnderRandomOperations)
+{
+    struct Entry
+    {
+        PointerDeviceKind Type;
+        bool Pressed;
+        Point Position;
+    };
+
+    std::mt19937 random{ 1234 };
+    PointerTable table(64);
+    std::unordered_map<uint32_t, Entry> reference;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        uint32_t const id = random() % 100;
+        switch (random() % 4)
+        {
+        case 0:
+        {
+            auto const type = static_cast<PointerDeviceKind>(random() % 3);
+            Point const position{ static_cast<float>(random() % 1000), static_cast<float>(random() % 1000) };
+            bool const inserted = table.Insert(id, type, false, position) != PointerTable::npos;
+            bool const expected = (reference.count(id) == 0) && (reference.size() < 64);
+            CHECK(inserted == expected);
+            if (expected)
+            {
+                reference[id] = { type, false, position };
+            }
+            break;
+        }
+
+        case 1:
+            CHECK(table.Erase(id) == (reference.erase(id) == 1));
+            break;
+
+        case 2:
+        {
+            size_t const index = table.Find(id);
+            CHECK((index != PointerTable::npos) == (reference.count(id) == 1));
+            if (index != PointerTable::npos)
+            {
+                bool const pressed = (random() % 2) != 0;
+                table.SetPressed(index, pressed);
+                reference[id].Pressed = pressed;
+            }
+            break;
+        }
+
+        default:
+        {
+            size_t const index = table.Find(id);
+            if (index != PointerTable::npos)
+            {
+                Point const position{ static_cast<float>(random() % 1000), static_cast<float>(random() % 1000) };
+                table.SetPosition(index, position);
+                reference[id].Position = position;
+            }
+            break;
+        }
+        }
+    }
+
+    REQUIRE(table.Size() == reference.size());
+    size_t pressed = 0;
+    for (size_t i = 0; i < table.Size(); ++i)
+    {
+        auto const itr = reference.find(table.Id(i));
+        REQUIRE(itr != reference.end());
+        CHECK(table.Type(i) == itr->second.Type);
+        CHECK(table.IsPressed(i) == itr->second.Pressed);
+        CHECK(table.Position(i).X == itr->second.Position.X);
+        CHECK(table.Position(i).Y == itr->second.Position.Y);
+        pressed += itr->second.Pressed ? 1 : 0;
+    }
+    CHECK(table.PressedCount() == pressed);
+}
@@ -0,0 +1,368 @@
+#include "MappedFile.h"
+#include "PointerTrace.h"
+#include "TestHarness.h"
+#include "Varint.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    // A move of a touch contact with the same ID as the previous record
+    constexpr uint8_t SameIdTag = 0x40 | static_cast<uint8_t>(PointerEventKind::Moved);
+
+    // Random but valid-looking events, with positions and pen pressure on the
+    // trace's fixed-point grids
+    std::vector<PointerEvent> MakeEvents(size_t count, uint32_t seed)
+    {
+        std::mt19937 random{ seed };
+        std::vector<PointerEvent> events;
+        uint64_t timestamp = 1000000000ull;
+        for (size_t i = 0; i < count; ++i)
+        {
+            timestamp += random() % 5000;
+            PointerEvent event{};
+            event.Timestamp = timestamp;
+            event.Id = 1 + (random() % 4 == 0 ? random() % 1000 : 1);
+            event.X = static_cast<float>(static_cast<int>(random() % 400000) - 100000) / PointerTrace::DefaultPositionScale;
+            event.Y = static_cast<float>(static_cast<int>(random() % 400000) - 100000) / PointerTrace::DefaultPositionScale;
+            event.Kind = static_cast<PointerEventKind>(random() % 5);
+            event.DeviceKind = static_cast<PointerDeviceKind>(random() % 3);
+            event.Pressure = (event.DeviceKind == PointerDeviceKind::Pen) ? static_cast<float>(random() % (PointerTrace::PressureScale + 1)) / PointerTrace::PressureScale : 0.5f;
+            event.InContact = (random() % 2) != 0;
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    bool SameEvent(PointerEvent const& a, PointerEvent const& b)
+    {
+        return (a.Timestamp == b.Timestamp) && (a.Id == b.Id) && (a.X == b.X) && (a.Y == b.Y) && (a.Pressure == b.Pressure) &&
+            (a.Kind == b.Kind) && (a.DeviceKind == b.DeviceKind) && (a.InContact == b.InContact);
+    }
+
+    std::vector<PointerEvent> ReadAll(PointerTraceReader& reader)
+    {
+        std::vector<PointerEvent> events;
+        PointerEvent event;
+        while (reader.Next(event))
+        {
+            events.push_back(event);
+        }
+        return events;
+    }
+}
+
+TEST_CASE(InMemoryRoundTrip)
+{
+    auto const events = MakeEvents(5000, 1);
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+    CHECK(writer.EventCount() == events.size());
+
+    auto const& buffer = writer.Buffer();
+    PointerTraceReader reader(buffer.data(), buffer.size());
+    REQUIRE(reader.IsValid());
+    CHECK(reader.Version() == PointerTrace::Version);
+    CHECK(reader.StartTimestamp() == events.front().Timestamp);
+
+    auto const decoded = ReadAll(reader);
+    CHECK(!reader.IsCorrupt());
+    REQUIRE(decoded.size() == events.size());
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        CHECK(SameEvent(decoded[i], events[i]));
+    }
+
+    // Rewind starts over from the first event
+    reader.Rewind();
+    PointerEvent first;
+    REQUIRE(reader.Next(first));
+    CHECK(SameEvent(first, events.front()));
+}
+
+TEST_CASE(PositionsAreQuantized)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    PointerEvent event{};
+    event.X = 10.3f;
+    event.Y = -7.77f;
+    event.Kind = PointerEventKind::Moved;
+    writer.Write(event);
+
+    PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+    PointerEvent decoded;
+    REQUIRE(reader.Next(decoded));
+    float const step = 1.0f / PointerTrace::DefaultPositionScale;
+    CHECK(std::fabs(decoded.X - event.X) <= step / 2);
+    CHECK(std::fabs(decoded.Y - event.Y) <= step / 2);
+}
+
+TEST_CASE(PressureRoundTrip)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    float const pressures[] = { 0.5f, 0.0f, 1.0f, 0.3f, 0.3f, 0.30001f, 1.5f, -0.25f, std::nanf(""), 0.5f };
+    PointerEvent event{};
+    event.Kind = PointerEventKind::Moved;
+    event.DeviceKind = PointerDeviceKind::Pen;
+    event.InContact = true;
+    for (float pressure : pressures)
+    {
+        event.Pressure = pressure;
+        writer.Write(event);
+        event.Timestamp += 1000;
+    }
+
+    // Quantized to the pressure grid, clamped, NaN read as the default
+    PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+    auto const decoded = ReadAll(reader);
+    REQUIRE(decoded.size() == std::size(pressures));
+    float const expected[] = { 0.5f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 1.0f, 0.0f, 0.5f, 0.5f };
+    float const step = 1.0f / PointerTrace::PressureScale;
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        CHECK_NEAR(decoded[i].Pressure, expected[i], step / 2);
+    }
+    CHECK(decoded[3].Pressure == decoded[5].Pressure);
+
+    // Records only carry a pressure when it changes, so a trace of devices
+    // without pressure is also a valid version 1 trace, which reads back as 0.5
+    auto events = MakeEvents(1000, 5);
+    PointerTraceWriter constant;
+    constant.OpenInMemory();
+    for (auto& sample : events)
+    {
+        sample.Pressure = 0.5f;
+        constant.Write(sample);
+    }
+    std::vector<uint8_t> trace = constant.Buffer();
+    trace[4] = 1;
+    trace[5] = 0;
+    PointerTraceReader version1(trace.data(), trace.size());
+    REQUIRE(version1.IsValid());
+    CHECK(version1.Version() == 1);
+    auto const old = ReadAll(version1);
+    CHECK(!version1.IsCorrupt());
+    REQUIRE(old.size() == events.size());
+    bool same = true;
+    for (size_t i = 0; i < old.size(); ++i)
+    {
+        same = same && SameEvent(old[i], events[i]);
+    }
+    CHECK(same);
+}
+
+TEST_CASE(FileRoundTripThroughMappedFile)
+{
+    auto const events = MakeEvents(200000, 2);
+    auto const path = std::filesystem::temp_directory_path() / "PointerTraceTests.ptrc";
+    {
+        PointerTraceWriter writer;
+        REQUIRE(writer.Open(path));
+        for (auto const& event : events)
+        {
+            writer.Write(event);
+        }
+        writer.Close();
+    }
+
+    MappedFile file;
+    REQUIRE(file.Open(path));
+    PointerTraceReader reader(file.Data(), file.Size());
+    REQUIRE(reader.IsValid());
+
+    size_t index = 0;
+    bool same = true;
+    size_t const delivered = ReplayPointerTrace(reader, [&](PointerEvent const& event)
+    {
+        same = same && (index < events.size()) && SameEvent(event, events[index]);
+        ++index;
+    });
+    CHECK(delivered == events.size());
+    CHECK(same);
+
+    file.Close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(EmptyTraceHasAHeader)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    writer.Close();
+    PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+    CHECK(reader.IsValid());
+    PointerEvent event;
+    CHECK(!reader.Next(event));
+    CHECK(!reader.IsCorrupt());
+}
+
+TEST_CASE(RejectsBadHeaders)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    writer.Write(MakeEvents(1, 3).front());
+    std::vector<uint8_t> trace = writer.Buffer();
+
+    CHECK(!PointerTraceReader(nullptr, 0).IsValid());
+    CHECK(!PointerTraceReader(trace.data(), PointerTrace::HeaderSize - 1).IsValid());
+
+    auto badMagic = trace;
+    badMagic[0] = 'X';
+    CHECK(!PointerTraceReader(badMagic.data(), badMagic.size()).IsValid());
+
+    auto newer = trace;
+    newer[4] = static_cast<uint8_t>(PointerTrace::Version + 1);
+    CHECK(!PointerTraceReader(newer.data(), newer.size()).IsValid());
+
+    auto zeroScale = trace;
+    zeroScale[8] = zeroScale[9] = zeroScale[10] = zeroScale[11] = 0;
+    CHECK(!PointerTraceReader(zeroScale.data(), zeroScale.size()).IsValid());
+
+    // A larger header is skipped
+    auto longer = trace;
+    longer[6] = static_cast<uint8_t>(PointerTrace::HeaderSize + 4);
+    longer.insert(longer.begin() + PointerTrace::HeaderSize, { 1, 2, 3, 4 });
+    PointerTraceReader reader(longer.data(), longer.size());
+    PointerEvent event;
+    CHECK(reader.IsValid());
+    CHECK(reader.Next(event));
+}
+
+TEST_CASE(TruncatedTraceStopsAsCorrupt)
+{
+    auto const events = MakeEvents(100, 4);
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    for (auto const& event : events)
+    {
+        writer.Write(event);
+    }
+    auto const& buffer = writer.Buffer();
+
+    // Every truncation point yields a prefix of the events, never garbage
+    for (size_t size = PointerTrace::HeaderSize; size < buffer.size(); ++size)
+    {
+        PointerTraceReader reader(buffer.data(), size);
+        auto const decoded = ReadAll(reader);
+        REQUIRE(decoded.size() < events.size());
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            CHECK(SameEvent(decoded[i], events[i]));
+        }
+    }
+
+    // An unknown event or device kind is corrupt too
+    for (uint8_t tag : { uint8_t{ 0x07 }, uint8_t{ 0x18 } })
+    {
+        auto invalid = buffer;
+        invalid[PointerTrace::HeaderSize] = tag;
+        PointerTraceReader reader(invalid.data(), invalid.size());
+        PointerEvent event;
+        CHECK(!reader.Next(event));
+        CHECK(reader.IsCorrupt());
+    }
+}
+
+TEST_CASE(OutOfRangePositionsAreCorrupt)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    writer.Write(MakeEvents(1, 5).front());
+    auto const& buffer = writer.Buffer();
+
+    // Two moves to the edge of the int32 range and back are fine, one more
+    // step past it on either axis isn't
+    auto const appendMove = [](std::vector<uint8_t>& trace, int64_t dx, int64_t dy)
+    {
+        trace.push_back(SameIdTag);
+        Varint::WriteSigned(trace, 0);
+        Varint::WriteSigned(trace, dx);
+        Varint::WriteSigned(trace, dy);
+    };
+    for (int64_t const step : { int64_t{ INT32_MAX }, int64_t{ INT32_MIN } })
+    {
+        std::vector<uint8_t> trace = buffer;
+        PointerTraceReader first(trace.data(), trace.size());
+        PointerEvent event;
+        REQUIRE(first.Next(event));
+        auto const x = static_cast<int64_t>(std::lround(event.X * PointerTrace::DefaultPositionScale));
+        auto const y = static_cast<int64_t>(std::lround(event.Y * PointerTrace::DefaultPositionScale));
+        appendMove(trace, step - x, step - y);
+        appendMove(trace, -step, -step);
+        appendMove(trace, step, 0);
+        appendMove(trace, (step > 0) ? 1 : -1, 0);
+
+        PointerTraceReader reader(trace.data(), trace.size());
+        CHECK(ReadAll(reader).size() == 4);
+        CHECK(reader.IsCorrupt());
+    }
+
+    // Likewise a pressure delta that leaves [0, PressureScale]
+    std::vector<uint8_t> trace = buffer;
+    trace.push_back(SameIdTag | 0x80);
+    Varint::WriteSigned(trace, 0);
+    Varint::WriteSigned(trace, 0);
+    Varint::WriteSigned(trace, 0);
+    Varint::WriteSigned(trace, INT64_MIN);
+    PointerTraceReader reader(trace.data(), trace.size());
+    CHECK(ReadAll(reader).size() == 1);
+    CHECK(reader.IsCorrupt());
+}
+
+TEST_CASE(NonFinitePositionsAreClamped)
+{
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    PointerEvent event{};
+    event.Kind = PointerEventKind::Moved;
+    event.X = INFINITY;
+    event.Y = std::nanf("");
+    writer.Write(event);
+    event.X = -1e30f;
+    event.Y = 2.0f;
+    writer.Write(event);
+
+    PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+    auto const decoded = ReadAll(reader);
+    REQUIRE(decoded.size() == 2);
+    CHECK(!reader.IsCorrupt());
+    CHECK(decoded[0].X > 3.0e7f);
+    CHECK(decoded[0].Y == 0.0f);
+    CHECK(decoded[1].X < -3.0e7f);
+    CHECK(decoded[1].Y == 2.0f);
+}
+
+TEST_CASE(RealTimeReplayFollowsTimestamps)
+{
+    // 20 events 5 ms apart, replayed at double speed: about 47.5 ms
+    PointerTraceWriter writer;
+    writer.OpenInMemory();
+    for (uint64_t i = 0; i < 20; ++i)
+    {
+        PointerEvent event{};
+        event.Timestamp = i * 5000;
+        event.Id = 1;
+        event.Kind = PointerEventKind::Moved;
+        writer.Write(event);
+    }
+
+    PointerTraceReader reader(writer.Buffer().data(), writer.Buffer().size());
+    auto const start = std::chrono::steady_clock::now();
+    size_t const delivered = ReplayPointerTrace(reader, [](PointerEvent const&) {}, ReplayPacing::RealTime, 2.0);
+    auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CHECK(delivered == 20);
+    CHECK(elapsed >= 47.0);
+}
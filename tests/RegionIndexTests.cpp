@@ -0,0 +1,202 @@
+#include "RegionIndex.h"
+#include "TestHarness.h"
+
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    // Topmost of the live regions containing the point, by linear scan
+    RegionId ReferenceHitTest(std::vector<std::pair<RegionId, Rect>> const& regions, Point point)
+    {
+        for (auto itr = regions.rbegin(); itr != regions.rend(); ++itr)
+        {
+            Rect const& r = itr->second;
+            if ((point.X >= r.Left) && (point.X < r.Right) && (point.Y >= r.Top) && (point.Y < r.Bottom))
+            {
+                return itr->first;
+            }
+        }
+
+        return NoRegion;
+    }
+}
+
+TEST_CASE(HitTestFindsTheTopmostRegion)
+{
+    RegionIndex index;
+    index.Resize(640.0f, 480.0f);
+    RegionId const bottom = index.Insert({ 0.0f, 0.0f, 200.0f, 200.0f });
+    RegionId const top = index.Insert({ 100.0f, 100.0f, 300.0f, 300.0f });
+    CHECK(index.Size() == 2);
+
+    CHECK(index.HitTest({ 50.0f, 50.0f }) == bottom);
+    CHECK(index.HitTest({ 150.0f, 150.0f }) == top);
+    CHECK(index.HitTest({ 250.0f, 250.0f }) == top);
+    CHECK(index.HitTest({ 400.0f, 400.0f }) == NoRegion);
+
+    // Left and top edges are inside, right and bottom outside
+    CHECK(index.HitTest({ 0.0f, 0.0f }) == bottom);
+    CHECK(index.HitTest({ 300.0f, 150.0f }) == NoRegion);
+    CHECK(index.HitTest({ 150.0f, 300.0f }) == NoRegion);
+
+    // Moving keeps the stacking order
+    CHECK(index.Move(bottom, { 100.0f, 100.0f, 200.0f, 200.0f }));
+    CHECK(index.HitTest({ 150.0f, 150.0f }) == top);
+    CHECK(index.HitTest({ 50.0f, 50.0f }) == NoRegion);
+    CHECK(index.Bounds(bottom).Left == 100.0f);
+}
+
+TEST_CASE(RegionsOutsideTheGridStillHit)
+{
+    RegionIndex index;
+    index.Resize(256.0f, 256.0f);
+    RegionId const outside = index.Insert({ -500.0f, -500.0f, -100.0f, -100.0f });
+    RegionId const huge = index.Insert({ 200.0f, 200.0f, 1e9f, 1e9f });
+
+    CHECK(index.HitTest({ -300.0f, -300.0f }) == outside);
+    CHECK(index.HitTest({ 10000.0f, 300.0f }) == huge);
+    CHECK(index.HitTest({ -50.0f, -50.0f }) == NoRegion);
+
+    // Regions are kept across resizes
+    index.Resize(2000.0f, 100.0f);
+    CHECK(index.HitTest({ -300.0f, -300.0f }) == outside);
+    CHECK(index.HitTest({ 1500.0f, 300.0f }) == huge);
+}
+
+TEST_CASE(StaleHandlesDontMatchReusedSlots)
+{
+    RegionIndex index;
+    RegionId const first = index.Insert({ 0.0f, 0.0f, 10.0f, 10.0f });
+    CHECK(index.Contains(first));
+    CHECK(index.Remove(first));
+    CHECK(!index.Contains(first));
+    CHECK(!index.Remove(first));
+    CHECK(!index.Move(first, { 0.0f, 0.0f, 1.0f, 1.0f }));
+    CHECK(!index.Contains(NoRegion));
+
+    RegionId const second = index.Insert({ 0.0f, 0.0f, 10.0f, 10.0f });
+    CHECK(second != first);
+    CHECK(!index.Contains(first));
+    CHECK(index.HitTest({ 5.0f, 5.0f }) == second);
+
+    index.Clear();
+    CHECK(index.Empty());
+    CHECK(!index.Contains(second));
+    CHECK(index.HitTest({ 5.0f, 5.0f }) == NoRegion);
+    RegionId const third = index.Insert({ 0.0f, 0.0f, 10.0f, 10.0f });
+    CHECK((third != second) && (third != first));
+}
+
+TEST_CASE(RandomEditsMatchALinearScan)
+{
+    std::mt19937 random(31);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 1100.0f);
+    std::uniform_real_distribution<float> extent(1.0f, 150.0f);
+
+    RegionIndex index({ 48.0f });
+    index.Resize(1000.0f, 800.0f);
+    std::vector<std::pair<RegionId, Rect>> regions;
+    auto const makeRect = [&]
+    {
+        float const x = coordinate(random);
+        float const y = coordinate(random);
+        return Rect{ x, y, x + extent(random), y + extent(random) };
+    };
+
+    PointerTable pointers(64);
+    std::vector<RegionId> hits;
+    for (int step = 0; step < 5000; ++step)
+    {
+        uint32_t const action = random() % 10;
+        if ((action < 5) || regions.empty())
+        {
+            Rect const rect = makeRect();
+            regions.push_back({ index.Insert(rect), rect });
+        }
+        else if (action < 7)
+        {
+            size_t const victim = random() % regions.size();
+            CHECK(index.Remove(regions[victim].first));
+            regions.erase(regions.begin() + static_cast<std::ptrdiff_t>(victim));
+        }
+        else
+        {
+            auto& moved = regions[random() % regions.size()];
+            moved.second = makeRect();
+            CHECK(index.Move(moved.first, moved.second));
+        }
+
+        if (step == 2500)
+        {
+            index.Resize(700.0f, 1200.0f);
+        }
+
+        // Stacking order is insertion order, which regions keeps
+        for (int probe = 0; probe < 8; ++probe)
+        {
+            Point const point{ coordinate(random), coordinate(random) };
+            REQUIRE(index.HitTest(point) == ReferenceHitTest(regions, point));
+        }
+
+        if (step % 50 == 0)
+        {
+            pointers.Clear();
+            for (uint32_t id = 1; id <= 64; ++id)
+            {
+                pointers.Insert(id, PointerDeviceKind::Touch, false, { coordinate(random), coordinate(random) });
+            }
+
+            index.HitTest(pointers, hits);
+            REQUIRE(hits.size() == pointers.Size());
+            for (size_t i = 0; i < pointers.Size(); ++i)
+            {
+                REQUIRE(hits[i] == ReferenceHitTest(regions, pointers.Position(i)));
+            }
+        }
+    }
+
+    CHECK(index.Size() == regions.size());
+}
+
+TEST_CASE(HoverTrackerRaisesEnterAndLeave)
+{
+    RegionHoverTracker tracker;
+    PointerTable pointers;
+    std::vector<RegionEvent> events;
+    pointers.Insert(1, PointerDeviceKind::Mouse, false, {});
+    pointers.Insert(2, PointerDeviceKind::Touch, true, {});
+
+    tracker.Update(pointers, { 10, NoRegion }, events);
+    REQUIRE(events.size() == 1);
+    CHECK((events[0].PointerId == 1) && (events[0].Region == 10) && events[0].Entered);
+
+    // Staying put raises nothing
+    events.clear();
+    tracker.Update(pointers, { 10, NoRegion }, events);
+    CHECK(events.empty());
+
+    // Moving between regions leaves before it enters
+    tracker.Update(pointers, { 11, 10 }, events);
+    REQUIRE(events.size() == 3);
+    CHECK((events[0].PointerId == 1) && (events[0].Region == 10) && !events[0].Entered);
+    CHECK((events[1].PointerId == 1) && (events[1].Region == 11) && events[1].Entered);
+    CHECK((events[2].PointerId == 2) && (events[2].Region == 10) && events[2].Entered);
+
+    // A pointer leaving the table leaves its region
+    events.clear();
+    pointers.Erase(1);
+    tracker.Update(pointers, { 10 }, events);
+    REQUIRE(events.size() == 1);
+    CHECK((events[0].PointerId == 1) && (events[0].Region == 11) && !events[0].Entered);
+
+    // Clear forgets without leaves
+    events.clear();
+    tracker.Clear();
+    CHECK(tracker.Empty());
+    tracker.Update(pointers, { 10 }, events);
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].Entered);
+}
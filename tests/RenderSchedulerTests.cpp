@@ -0,0 +1,210 @@
+#include "RenderScheduler.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace PointerCore;
+using namespace std::chrono_literals;
+
+namespace
+{
+    using FrameAction = RenderScheduler::FrameAction;
+
+    // Drives the scheduler the way the render loop does: render when told to,
+    // otherwise sleep until the wake time or the next input, whichever is first.
+    // Returns the number of frames rendered by the end time.
+    template <typename InputFn>
+    uint64_t Simulate(RenderScheduler& scheduler, VirtualClock& clock, RenderScheduler::TimePoint end,
+        RenderScheduler::Duration renderCost, InputFn&& nextInput)
+    {
+        while (clock.Now() < end)
+        {
+            auto const decision = scheduler.Next(clock.Now());
+            if (decision.Action == FrameAction::Render)
+            {
+                auto const frameStart = clock.Now();
+                scheduler.OnFrameStarted();
+                clock.Advance(renderCost);
+                scheduler.OnFrameRendered(frameStart);
+                continue;
+            }
+
+            auto wake = nextInput(clock.Now());
+            if ((decision.Action == FrameAction::WaitUntil) && (decision.WakeTime < wake))
+            {
+                wake = decision.WakeTime;
+            }
+            else
+            {
+                scheduler.RequestFrame();
+            }
+
+            CHECK(wake >= clock.Now());
+            clock.AdvanceTo(wake < end ? wake : end);
+        }
+
+        return scheduler.FramesRendered();
+    }
+}
+
+TEST_CASE(ContinuousRendersEveryTime)
+{
+    RenderScheduler scheduler;
+    VirtualClock clock;
+    for (int i = 0; i < 5; ++i)
+    {
+        auto const decision = scheduler.Next(clock.Now());
+        CHECK(decision.Action == FrameAction::Render);
+        scheduler.OnFrameStarted();
+        scheduler.OnFrameRendered(clock.Now());
+        clock.Advance(1ms);
+    }
+
+    CHECK(scheduler.FramesRendered() == 5);
+    CHECK(scheduler.MinFrameInterval() == RenderScheduler::Duration::zero());
+}
+
+TEST_CASE(OnDemandIdlesUntilRequested)
+{
+    RenderScheduler scheduler({ true, 0.0 });
+    VirtualClock clock;
+
+    // The first frame is always requested, so the panel gets drawn once
+    CHECK(scheduler.FrameRequested());
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Render);
+    scheduler.OnFrameStarted();
+    scheduler.OnFrameRendered(clock.Now());
+
+    clock.Advance(1s);
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Idle);
+
+    scheduler.RequestFrame();
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Render);
+
+    // A request arriving while a frame renders isn't lost
+    scheduler.OnFrameStarted();
+    scheduler.RequestFrame();
+    scheduler.OnFrameRendered(clock.Now());
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Render);
+    scheduler.OnFrameStarted();
+    scheduler.OnFrameRendered(clock.Now());
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Idle);
+}
+
+TEST_CASE(CapSpacesFrameStarts)
+{
+    RenderScheduler scheduler({ false, 50.0 });
+    VirtualClock clock;
+    CHECK(scheduler.MinFrameInterval() == 20ms);
+
+    scheduler.OnFrameStarted();
+    scheduler.OnFrameRendered(clock.Now());
+
+    clock.Advance(5ms);
+    auto decision = scheduler.Next(clock.Now());
+    CHECK(decision.Action == FrameAction::WaitUntil);
+    CHECK(decision.WakeTime == RenderScheduler::TimePoint{ 20ms });
+
+    // The cap counts from the frame's start, so render time doesn't add to it
+    clock.AdvanceTo(decision.WakeTime);
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Render);
+
+    // A late frame renders straight away
+    clock.Advance(100ms);
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Render);
+}
+
+TEST_CASE(OnDemandWithCapWaitsOnlyWhenRequested)
+{
+    RenderScheduler scheduler({ true, 100.0 });
+    VirtualClock clock;
+    scheduler.OnFrameStarted();
+    scheduler.OnFrameRendered(clock.Now());
+
+    clock.Advance(2ms);
+    CHECK(scheduler.Next(clock.Now()).Action == FrameAction::Idle);
+
+    scheduler.RequestFrame();
+    auto const decision = scheduler.Next(clock.Now());
+    CHECK(decision.Action == FrameAction::WaitUntil);
+    CHECK(decision.WakeTime == RenderScheduler::TimePoint{ 10ms });
+}
+
+TEST_CASE(InvalidCapsMeanUncapped)
+{
+    for (double rate : { 0.0, -60.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity() })
+    {
+        RenderScheduler scheduler({ false, rate });
+        CHECK(scheduler.MinFrameInterval() == RenderScheduler::Duration::zero());
+        scheduler.OnFrameStarted();
+        scheduler.OnFrameRendered({});
+        CHECK(scheduler.Next({}).Action == FrameAction::Render);
+    }
+}
+
+TEST_CASE(TinyCapsDontOverflow)
+{
+    // 1 / rate in nanoseconds is past int64 for all of these
+    for (double rate : { 1e-10, 1e-15, std::numeric_limits<double>::denorm_min() })
+    {
+        RenderScheduler scheduler({ false, rate });
+        CHECK(scheduler.MinFrameInterval() == RenderScheduler::Duration::max() / 2);
+        scheduler.OnFrameStarted();
+        scheduler.OnFrameRendered(RenderScheduler::TimePoint{ 1s });
+        auto const decision = scheduler.Next(RenderScheduler::TimePoint{ 2s });
+        CHECK(decision.Action == FrameAction::WaitUntil);
+        CHECK(decision.WakeTime > RenderScheduler::TimePoint{ 2s });
+    }
+
+    // Just inside the limit still converts exactly
+    RenderScheduler scheduler({ false, std::ldexp(1.0, -32) });
+    CHECK(scheduler.MinFrameInterval() == std::chrono::seconds{ int64_t{ 1 } << 32 });
+}
+
+TEST_CASE(SettingsChangeTakesEffectImmediately)
+{
+    RenderScheduler scheduler({ true, 0.0 });
+    scheduler.OnFrameStarted();
+    scheduler.OnFrameRendered({});
+    CHECK(scheduler.Next({}).Action == FrameAction::Idle);
+
+    scheduler.SetOptions({ false, 0.0 });
+    CHECK(scheduler.Next({}).Action == FrameAction::Render);
+
+    scheduler.SetOptions({ false, 10.0 });
+    auto const decision = scheduler.Next(RenderScheduler::TimePoint{ 1ms });
+    CHECK(decision.Action == FrameAction::WaitUntil);
+    CHECK(decision.WakeTime == RenderScheduler::TimePoint{ 100ms });
+}
+
+TEST_CASE(IdleSessionRendersOnlyForInput)
+{
+    // One second of input bursts every 10 seconds over a minute, nothing in between
+    auto const nextInput = [](RenderScheduler::TimePoint now) {
+        auto const period = std::chrono::duration_cast<RenderScheduler::Duration>(10s);
+        auto const intoPeriod = now % period;
+        if (intoPeriod < 1s)
+        {
+            // 120 Hz input during a burst
+            auto const step = std::chrono::duration_cast<RenderScheduler::Duration>(std::chrono::duration<double>(1.0 / 120.0));
+            return now + step;
+        }
+
+        return now - intoPeriod + period;
+    };
+
+    VirtualClock clock;
+    RenderScheduler onDemand({ true, 60.0 });
+    uint64_t const onDemandFrames = Simulate(onDemand, clock, RenderScheduler::TimePoint{ 60s }, 2ms, nextInput);
+
+    // Each burst renders at most at the cap, plus the initial frame
+    CHECK(onDemandFrames <= 6 * 61 + 1);
+    CHECK(onDemandFrames >= 6 * 55);
+
+    VirtualClock continuousClock;
+    RenderScheduler continuous({ false, 60.0 });
+    uint64_t const continuousFrames = Simulate(continuous, continuousClock, RenderScheduler::TimePoint{ 60s }, 2ms, nextInput);
+    CHECK(continuousFrames >= 60 * 59);
+    CHECK(continuousFrames <= 60 * 60 + 1);
+}
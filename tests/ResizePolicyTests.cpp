@@ -0,0 +1,189 @@
+#include "ResizePolicy.h"
+#include "TestHarness.h"
+
+using namespace PointerCore;
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Action = ResizePolicy::ResizeAction;
+    using Size = ResizePolicy::Size;
+    using TimePoint = ResizePolicy::TimePoint;
+
+    constexpr auto Frame = 16667us;
+}
+
+TEST_CASE(LatestRequestWinsOncePerFrame)
+{
+    ResizePolicy policy;
+    policy.Reset({ 800, 600 });
+    CHECK(policy.IsSettled());
+    CHECK(policy.Update(TimePoint{}).Action == Action::None);
+
+    policy.Request({ 700, 500 }, TimePoint{ 1ms });
+    policy.Request({ 790, 590 }, TimePoint{ 2ms });
+    policy.Request({ 780, 580 }, TimePoint{ 3ms });
+    CHECK(!policy.IsSettled());
+    CHECK((policy.TargetSize() == Size{ 780, 580 }));
+
+    // Smaller than the buffers: show less of them
+    auto decision = policy.Update(TimePoint{ 4ms });
+    CHECK(decision.Action == Action::Resize);
+    CHECK((decision.Buffers == Size{ 800, 600 }));
+    CHECK((decision.Visible == Size{ 780, 580 }));
+    CHECK(policy.Update(TimePoint{ 5ms }).Action == Action::None);
+
+    // The same size again changes nothing, and doesn't put off settling
+    policy.Request({ 780, 580 }, TimePoint{ 100ms });
+    CHECK(policy.Update(TimePoint{ 100ms }).Action == Action::None);
+    CHECK(policy.SettleDeadline() == TimePoint{ 203ms });
+
+    decision = policy.Update(TimePoint{ 203ms });
+    CHECK(decision.Action == Action::Reallocate);
+    CHECK((decision.Buffers == Size{ 780, 580 }));
+    CHECK((decision.Visible == Size{ 780, 580 }));
+    CHECK(policy.IsSettled());
+    CHECK(policy.Reallocations() == 1);
+    CHECK(policy.Update(TimePoint{ 1s }).Action == Action::None);
+}
+
+TEST_CASE(GrowingWithinTheSlackLetterboxes)
+{
+    ResizePolicy policy;
+    policy.Reset({ 800, 600 });
+    policy.Request({ 832, 610 }, TimePoint{});
+    auto decision = policy.Update(TimePoint{});
+    CHECK(decision.Action == Action::None);
+    CHECK((decision.Buffers == Size{ 800, 600 }));
+    CHECK((decision.Visible == Size{ 800, 600 }));
+    CHECK(!policy.IsSettled());
+
+    // Narrower but still taller than the buffers
+    policy.Request({ 700, 620 }, TimePoint{ 10ms });
+    decision = policy.Update(TimePoint{ 10ms });
+    CHECK(decision.Action == Action::Resize);
+    CHECK((decision.Visible == Size{ 700, 600 }));
+
+    decision = policy.Update(TimePoint{ 210ms });
+    CHECK(decision.Action == Action::Reallocate);
+    CHECK((decision.Buffers == Size{ 700, 620 }));
+}
+
+TEST_CASE(OutgrowingReallocatesWithHeadroom)
+{
+    ResizePolicy policy;
+    policy.Reset({ 800, 600 });
+    policy.Request({ 900, 600 }, TimePoint{});
+    auto decision = policy.Update(TimePoint{});
+    CHECK(decision.Action == Action::Reallocate);
+
+    // 900 * 1.25 rounded up to 64; the height already fits
+    CHECK((decision.Buffers == Size{ 1152, 600 }));
+    CHECK((decision.Visible == Size{ 900, 600 }));
+
+    // Further growth into the headroom only resizes
+    policy.Request({ 1100, 620 }, TimePoint{ 10ms });
+    decision = policy.Update(TimePoint{ 10ms });
+    CHECK(decision.Action == Action::Resize);
+    CHECK((decision.Visible == Size{ 1100, 600 }));
+    CHECK(policy.Reallocations() == 1);
+
+    // Headroom stops at MaxDimension, the size itself doesn't
+    ResizePolicy::Options options;
+    options.MaxDimension = 1000;
+    policy.SetOptions(options);
+    policy.Reset({ 800, 600 });
+    policy.Request({ 900, 600 }, TimePoint{ 1s });
+    CHECK((policy.Update(TimePoint{ 1s }).Buffers == Size{ 1000, 600 }));
+    policy.Request({ 1200, 600 }, TimePoint{ 1s });
+    CHECK((policy.Update(TimePoint{ 1s }).Buffers == Size{ 1200, 600 }));
+
+    // No headroom or alignment
+    options = {};
+    options.GrowSlack = 0;
+    options.Headroom = 0.0f;
+    options.Alignment = 0;
+    policy.SetOptions(options);
+    policy.Reset({ 800, 600 });
+    policy.Request({ 801, 600 }, TimePoint{ 2s });
+    decision = policy.Update(TimePoint{ 2s });
+    CHECK(decision.Action == Action::Reallocate);
+    CHECK((decision.Buffers == Size{ 801, 600 }));
+}
+
+TEST_CASE(GrowingDragBurst)
+{
+    // A window dragged from 800x600 to 1400x1000 over a second, with three
+    // size events per frame, then left alone
+    ResizePolicy policy;
+    policy.Reset({ 800, 600 });
+    TimePoint now{};
+    int sizeEvents = 0;
+    for (int frame = 1; frame <= 60; ++frame)
+    {
+        for (int i = 1; i <= 3; ++i)
+        {
+            int const step = (frame - 1) * 3 + i;
+            policy.Request({ static_cast<uint32_t>(800 + step * 600 / 180), static_cast<uint32_t>(600 + step * 400 / 180) }, now + Frame * i / 3);
+            ++sizeEvents;
+        }
+        now += Frame;
+
+        auto const decision = policy.Update(now);
+        CHECK(decision.Visible.Width <= decision.Buffers.Width);
+        CHECK(decision.Visible.Height <= decision.Buffers.Height);
+
+        // Never more than the slack of the panel is letterboxed
+        CHECK(policy.TargetSize().Width - decision.Visible.Width <= 32);
+        CHECK(policy.TargetSize().Height - decision.Visible.Height <= 32);
+    }
+    CHECK(sizeEvents == 180);
+    CHECK(policy.Reallocations() <= 4);
+    uint64_t const duringDrag = policy.Reallocations();
+
+    // Nothing until it settles, then the buffers fit
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        now += Frame;
+        auto const decision = policy.Update(now);
+        if (decision.Action == Action::Reallocate)
+        {
+            CHECK(now >= policy.SettleDeadline());
+            CHECK((decision.Buffers == Size{ 1400, 1000 }));
+        }
+    }
+    CHECK(policy.IsSettled());
+    CHECK(policy.Reallocations() == duringDrag + 1);
+}
+
+TEST_CASE(ShrinkingAndWobblingDragBurst)
+{
+    // Shrinking never reallocates until the size settles
+    ResizePolicy policy;
+    policy.Reset({ 1600, 1200 });
+    TimePoint now{};
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        policy.Request({ static_cast<uint32_t>(1590 - frame * 10), static_cast<uint32_t>(1195 - frame * 5) }, now);
+        now += Frame;
+        CHECK(policy.Update(now).Action == Action::Resize);
+    }
+    CHECK(policy.Reallocations() == 0);
+
+    // A drag that wanders back and forth across the original size keeps
+    // putting off the settle, and stays within the buffers and the slack
+    policy.Reset({ 1000, 800 });
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        uint32_t const wobble = static_cast<uint32_t>((frame * 37) % 60);
+        policy.Request({ 970 + wobble, 780 + wobble / 2 }, now);
+        now += Frame;
+        CHECK(policy.Update(now).Action != Action::Reallocate);
+    }
+    CHECK(policy.Reallocations() == 0);
+    CHECK(!policy.IsSettled());
+
+    now += 200ms;
+    CHECK(policy.Update(now).Action == Action::Reallocate);
+    CHECK(policy.IsSettled());
+}
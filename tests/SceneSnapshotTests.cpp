@@ -0,0 +1,280 @@
+#include "SceneSnapshot.h"
+#include "TestHarness.h"
+
+#include <thread>
+
+using namespace PointerCore;
+
+namespace
+{
+    PointerEvent Event(uint32_t id, PointerEventKind kind, float x, uint64_t received = 0)
+    {
+        bool const inContact = (kind == PointerEventKind::Pressed) || (kind == PointerEventKind::Moved);
+        return { static_cast<uint64_t>(x * 10.0f), received, id, x, x * 0.5f, inContact ? 0.5f : 0.0f, kind, PointerDeviceKind::Pen, inContact };
+    }
+
+    bool SameScene(SceneSnapshot const& a, SceneSnapshot const& b)
+    {
+        if ((a.Pointers.Size() != b.Pointers.Size()) || (a.Strokes.StrokeCount() != b.Strokes.StrokeCount()))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.Pointers.Size(); ++i)
+        {
+            size_t const j = b.Pointers.Find(a.Pointers.Id(i));
+            if ((j == PointerTable::npos) || (a.Pointers.Position(i).X != b.Pointers.Position(j).X) ||
+                (a.Pointers.Position(i).Y != b.Pointers.Position(j).Y) || (a.Pointers.IsPressed(i) != b.Pointers.IsPressed(j)) ||
+                (a.Pointers.Timestamp(i) != b.Pointers.Timestamp(j)))
+            {
+                return false;
+            }
+        }
+
+        std::vector<PointerSample> pointsA;
+        std::vector<PointerSample> pointsB;
+        for (size_t i = 0; i < a.Strokes.StrokeCount(); ++i)
+        {
+            a.Strokes.CopyPoints(i, pointsA);
+            b.Strokes.CopyPoints(i, pointsB);
+            if ((a.Strokes.StrokeId(i) != b.Strokes.StrokeId(i)) || (pointsA.size() != pointsB.size()))
+            {
+                return false;
+            }
+
+            for (size_t j = 0; j < pointsA.size(); ++j)
+            {
+                if ((pointsA[j].X != pointsB[j].X) || (pointsA[j].Y != pointsB[j].Y))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Events for one publish: pointer (batch % 4) enters and presses the
+    // first time, then draws, and lifts and leaves every 16th time it's used
+    std::vector<PointerEvent> Batch(uint64_t batch)
+    {
+        auto const id = static_cast<uint32_t>(batch % 4);
+        uint64_t const use = batch / 4;
+        float const x = static_cast<float>(batch);
+        switch (use % 16)
+        {
+        case 0:
+            return { Event(id, PointerEventKind::Entered, x, batch + 1), Event(id, PointerEventKind::Pressed, x, batch + 1) };
+        case 15:
+            return { Event(id, PointerEventKind::Released, x, batch + 1), Event(id, PointerEventKind::Exited, x, batch + 1) };
+        default:
+            return { Event(id, PointerEventKind::Moved, x, batch + 1), Event(id, PointerEventKind::Moved, x + 0.5f, batch + 1) };
+        }
+    }
+}
+
+TEST_CASE(TripleBufferHandsOverTheLatestVersion)
+{
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.HasUpdate());
+    CHECK(buffer.Acquire() == 0);
+    CHECK(buffer.LatestIndex() == TripleBuffer<int>::SlotCount);
+
+    buffer.Back() = 1;
+    buffer.Publish();
+    CHECK(buffer.HasUpdate());
+    CHECK(buffer.Published(buffer.LatestIndex()) == 1);
+
+    // Versions the consumer didn't get to are skipped
+    buffer.Back() = 2;
+    buffer.Publish();
+    buffer.Back() = 3;
+    buffer.Publish();
+    CHECK(buffer.Acquire() == 3);
+    CHECK(!buffer.HasUpdate());
+    CHECK(buffer.Acquire() == 3);
+    CHECK(buffer.Front() == 3);
+
+    // The producer's back slot is never the one the consumer holds
+    for (int i = 4; i < 100; ++i)
+    {
+        CHECK(buffer.BackIndex() != buffer.LatestIndex());
+        buffer.Back() = i;
+        buffer.Publish();
+        if ((i % 3) == 0)
+        {
+            CHECK(buffer.Acquire() == i);
+        }
+        CHECK(buffer.Front() != buffer.Back());
+    }
+}
+
+TEST_CASE(SnapshotsMatchApplyingEveryEvent)
+{
+    SceneSnapshotChannel channel;
+    SceneSnapshot reference;
+    for (uint64_t batch = 0; batch < 500; ++batch)
+    {
+        for (auto const& event : Batch(batch))
+        {
+            channel.Apply(event, true);
+            SceneSnapshotChannel::ApplyEvent(reference, event, true, false);
+        }
+        channel.Publish();
+
+        // Acquire at varying rates, so slots fall behind by different amounts
+        if ((batch % 7) < 3)
+        {
+            REQUIRE(channel.HasUpdate());
+            auto const& snapshot = channel.Acquire();
+            CHECK(snapshot.Sequence == batch);
+            CHECK(SameScene(snapshot, reference));
+            CHECK(!channel.HasUpdate());
+        }
+    }
+
+    CHECK(SameScene(channel.Acquire(), reference));
+    CHECK(channel.PublishCount() == 500);
+    CHECK(channel.FullCopyCount() == 0);
+    CHECK(reference.Strokes.StrokeCount() > 1);
+
+    // The log only holds what the slots still need
+    CHECK(channel.LogLength() <= 3 * 2);
+}
+
+TEST_CASE(PendingInputOnlyCoversTheLatestPublish)
+{
+    SceneSnapshotChannel channel;
+    channel.Apply(Event(1, PointerEventKind::Entered, 1.0f, 100), false);
+    channel.Apply(Event(2, PointerEventKind::Entered, 1.0f, 0), false);
+    channel.Publish();
+    auto const& first = channel.Acquire();
+    CHECK(first.Pointers.PendingInputTime(first.Pointers.Find(1)) == 100);
+    CHECK(first.Pointers.PendingInputTime(first.Pointers.Find(2)) == 0);
+
+    // Only the oldest input since the previous snapshot is kept
+    channel.Apply(Event(2, PointerEventKind::Pressed, 2.0f, 200), false);
+    channel.Apply(Event(2, PointerEventKind::Moved, 3.0f, 300), false);
+    channel.Publish();
+    auto const& second = channel.Acquire();
+    CHECK(second.Pointers.PendingInputTime(second.Pointers.Find(1)) == 0);
+    CHECK(second.Pointers.PendingInputTime(second.Pointers.Find(2)) == 200);
+    CHECK(second.Pointers.Position(second.Pointers.Find(2)).X == 3.0f);
+
+    // Strokes are only recorded when asked for
+    CHECK(second.Strokes.StrokeCount() == 0);
+    channel.Publish();
+    auto const& third = channel.Acquire();
+    CHECK(third.Pointers.PendingInputTime(third.Pointers.Find(2)) == 0);
+    CHECK(third.Sequence == 2);
+}
+
+TEST_CASE(HeldSlotGetsAFullCopyOnceTheLogIsCut)
+{
+    SceneSnapshotChannel channel(8);
+    SceneSnapshot reference;
+    uint64_t batch = 0;
+    auto const publish = [&](uint64_t count)
+    {
+        for (uint64_t end = batch + count; batch < end; ++batch)
+        {
+            for (auto const& event : Batch(batch))
+            {
+                channel.Apply(event, true);
+                SceneSnapshotChannel::ApplyEvent(reference, event, true, false);
+            }
+            channel.Publish();
+            CHECK(channel.LogLength() <= 8 + 2);
+        }
+    };
+
+    // The consumer holds one slot while the producer goes round the other two
+    publish(3);
+    CHECK(channel.Acquire().Sequence == 2);
+    publish(50);
+    CHECK(channel.FullCopyCount() == 0);
+    CHECK(channel.LogLength() <= 8 + 2);
+
+    // The held slot missed more than the log keeps, so it's copied when it's back
+    CHECK(SameScene(channel.Acquire(), reference));
+    publish(2);
+    CHECK(channel.FullCopyCount() == 1);
+    auto const& snapshot = channel.Acquire();
+    CHECK(snapshot.Sequence == batch - 1);
+    CHECK(SameScene(snapshot, reference));
+}
+
+TEST_CASE(StressOneProducerOneConsumer)
+{
+    // The producer publishes as fast as it can while the consumer acquires
+    // as fast as it can. Every snapshot the consumer sees must be exactly the
+    // scene after its sequence number: each pointer where its last batch up
+    // to then left it, and pending input for the last batch's pointer only.
+    constexpr uint64_t Count = 100000;
+    SceneSnapshotChannel channel(64);
+
+    std::thread producer([&]
+    {
+        for (uint64_t batch = 0; batch < Count; ++batch)
+        {
+            for (auto const& event : Batch(batch))
+            {
+                channel.Apply(event, true);
+            }
+            channel.Publish();
+        }
+    });
+
+    uint64_t acquired = 0;
+    uint64_t last = 0;
+    bool ordered = true;
+    bool intact = true;
+    while (last + 1 < Count)
+    {
+        if (!channel.HasUpdate())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        auto const& snapshot = channel.Acquire();
+        uint64_t const sequence = snapshot.Sequence;
+        ordered = ordered && ((acquired == 0) || (sequence > last));
+        last = sequence;
+        ++acquired;
+
+        for (uint32_t id = 0; id < 4; ++id)
+        {
+            size_t const index = snapshot.Pointers.Find(id);
+            if (sequence < id)
+            {
+                intact = intact && (index == PointerTable::npos);
+                continue;
+            }
+
+            // The pointer's last batch so far, and whether it left in it
+            uint64_t const batch = sequence - (sequence - id) % 4;
+            bool const exited = ((batch / 4) % 16) == 15;
+            if (exited)
+            {
+                intact = intact && (index == PointerTable::npos);
+                continue;
+            }
+
+            float const x = static_cast<float>(batch) + ((((batch / 4) % 16) == 0) ? 0.0f : 0.5f);
+            intact = intact && (index != PointerTable::npos) && (snapshot.Pointers.Position(index).X == x) && snapshot.Pointers.IsPressed(index);
+            if (index != PointerTable::npos)
+            {
+                uint64_t const pending = (batch == sequence) ? batch + 1 : 0;
+                intact = intact && (snapshot.Pointers.PendingInputTime(index) == pending);
+            }
+        }
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(acquired > 0);
+    CHECK(channel.PublishCount() == Count);
+    CHECK(channel.Acquire().Sequence == Count - 1);
+}
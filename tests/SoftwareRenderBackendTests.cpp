@@ -0,0 +1,358 @@
+#include "PixelOps.h"
+#include "PointerScene.h"
+#include "SoftwareRenderBackend.h"
+#include "StrokeStore.h"
+#include "StrokeTessellator.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    constexpr uint32_t White = 0xffffffffu;
+
+    // The scalar blend the span functions must match bit for bit
+    uint32_t ReferenceBlend(uint32_t d, uint32_t s)
+    {
+        uint32_t const inverseAlpha = 255 - (s >> 24);
+        uint32_t result = 0;
+        for (uint32_t shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t const product = ((d >> shift) & 0xff) * inverseAlpha + 128;
+            uint32_t const scaled = (product + (product >> 8)) >> 8;
+            result |= (((s >> shift) & 0xff) + scaled) << shift;
+        }
+        return result;
+    }
+
+    // Rows of 'x' (value) and '.' (anything else), for readable expectations
+    std::vector<std::string> Coverage(SoftwareRenderBackend const& backend, uint32_t value)
+    {
+        std::vector<std::string> rows;
+        for (uint32_t y = 0; y < backend.Height(); ++y)
+        {
+            std::string row;
+            for (uint32_t x = 0; x < backend.Width(); ++x)
+            {
+                row += (backend.PixelAt(x, y) == value) ? 'x' : '.';
+            }
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    // Binary PPM, RGB from a BGRA buffer. Golden scenes are opaque, so alpha isn't kept.
+    std::vector<uint8_t> EncodePpm(SoftwareRenderBackend const& backend)
+    {
+        std::string const header = "P6\n" + std::to_string(backend.Width()) + " " + std::to_string(backend.Height()) + "\n255\n";
+        std::vector<uint8_t> file(header.begin(), header.end());
+        for (uint32_t y = 0; y < backend.Height(); ++y)
+        {
+            for (uint32_t x = 0; x < backend.Width(); ++x)
+            {
+                uint32_t const pixel = backend.PixelAt(x, y);
+                file.push_back(static_cast<uint8_t>(pixel >> 16));
+                file.push_back(static_cast<uint8_t>(pixel >> 8));
+                file.push_back(static_cast<uint8_t>(pixel));
+            }
+        }
+        return file;
+    }
+
+    // Compares against tests/data/<name>.ppm. With POINTERCORE_UPDATE_GOLDEN
+    // set the image is rewritten instead; on a mismatch the actual image is
+    // written to the working directory.
+    bool MatchesGolden(SoftwareRenderBackend const& backend, char const* name)
+    {
+        auto const actual = EncodePpm(backend);
+        std::string const goldenPath = std::string(POINTERCORE_TEST_DATA_DIR) + "/" + name + ".ppm";
+        if (std::getenv("POINTERCORE_UPDATE_GOLDEN") != nullptr)
+        {
+            std::ofstream(goldenPath, std::ios::binary).write(reinterpret_cast<char const*>(actual.data()), static_cast<std::streamsize>(actual.size()));
+            return true;
+        }
+
+        std::ifstream golden(goldenPath, std::ios::binary);
+        std::vector<uint8_t> const expected{ std::istreambuf_iterator<char>(golden), std::istreambuf_iterator<char>() };
+        if (expected == actual)
+        {
+            return true;
+        }
+
+        size_t different = 0;
+        for (size_t i = 0; i < std::min(expected.size(), actual.size()); ++i)
+        {
+            different += (expected[i] != actual[i]) ? 1 : 0;
+        }
+        std::string const actualPath = std::string(name) + ".actual.ppm";
+        std::ofstream(actualPath, std::ios::binary).write(reinterpret_cast<char const*>(actual.data()), static_cast<std::streamsize>(actual.size()));
+        std::printf("    %s: %zu bytes differ (sizes %zu/%zu), wrote %s\n", goldenPath.c_str(), different, actual.size(), expected.size(), actualPath.c_str());
+        return false;
+    }
+
+    // A wavy stroke with rising pressure, then a short finished one
+    StrokeTessellator MakeInk(float scale)
+    {
+        StrokeStore store;
+        store.Begin(1, { 20.0f * scale, 60.0f * scale, 0, 0.1f });
+        for (int i = 1; i <= 60; ++i)
+        {
+            float const t = static_cast<float>(i) / 60.0f;
+            store.Append(1, { (20.0f + 150.0f * t) * scale, (60.0f + 35.0f * std::sin(t * 9.0f)) * scale, static_cast<uint64_t>(i) * 1000, 0.1f + 0.9f * t });
+        }
+
+        store.Begin(2, { 30.0f * scale, 110.0f * scale, 0, 1.0f });
+        store.Append(2, { 90.0f * scale, 100.0f * scale, 1000, 0.6f });
+        store.Append(2, { 100.0f * scale, 20.0f * scale, 2000, 0.3f });
+        store.End(2);
+
+        StrokeTessellator tessellator;
+        Rect changed;
+        tessellator.Update(store, changed);
+        return tessellator;
+    }
+}
+
+TEST_CASE(RectanglesCoverPixelCenters)
+{
+    SoftwareRenderBackend backend(8, 4);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    backend.FillRectangle({ 0.5f, 0.5f, 3.5f, 2.4f }, Colors::White);
+    backend.FillRectangle({ 5.6f, -1.0f, 6.6f, 9.0f }, Colors::White);
+    backend.EndDraw();
+
+    // Centers on the left/top edge are inside, on the right edge outside
+    auto const coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "xxx...x.");
+    CHECK(coverage[1] == "xxx...x.");
+    CHECK(coverage[2] == "......x.");
+    CHECK(coverage[3] == "......x.");
+
+    PixelRect const covered = SoftwareRenderBackend::CoveredPixels({ 0.5f, 0.5f, 3.5f, 2.4f });
+    CHECK((covered.Left == 0) && (covered.Top == 0) && (covered.Right == 3) && (covered.Bottom == 2));
+}
+
+TEST_CASE(TriangleEdgeRules)
+{
+    // Vertices on pixel centers: the top, left and hypotenuse centers are
+    // covered, the row level with the lowest vertex isn't
+    SoftwareRenderBackend backend(6, 6);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    Point const upper[] = { { 0.5f, 0.5f }, { 4.5f, 0.5f }, { 0.5f, 4.5f } };
+    backend.FillTriangleStrip(upper, 3, Colors::White);
+    backend.EndDraw();
+
+    auto coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "xxxxx.");
+    CHECK(coverage[1] == "xxxx..");
+    CHECK(coverage[2] == "xxx...");
+    CHECK(coverage[3] == "xx....");
+    CHECK(coverage[4] == "......");
+
+    // A flat bottom edge on a row of centers leaves that row out entirely,
+    // the same whichever way the triangle is wound
+    backend.Clear(Colors::Black);
+    Point const lower[] = { { 0.5f, 0.5f }, { 4.5f, 4.5f }, { 0.5f, 4.5f } };
+    backend.FillTriangleStrip(lower, 3, Colors::White);
+    coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "x.....");
+    CHECK(coverage[1] == "xx....");
+    CHECK(coverage[3] == "xxxx..");
+    CHECK(coverage[4] == "......");
+
+    // Degenerate triangles draw nothing
+    backend.Clear(Colors::Black);
+    Point const flat[] = { { 0.5f, 0.5f }, { 2.5f, 2.5f }, { 4.5f, 4.5f } };
+    backend.FillTriangleStrip(flat, 3, Colors::White);
+    CHECK(Coverage(backend, 0xff000000u)[2] == "xxxxxx");
+}
+
+TEST_CASE(StripsDontLeaveGapsBetweenTriangles)
+{
+    // A quad split along its diagonal, as the tessellator emits it
+    SoftwareRenderBackend backend(16, 16);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    Point const quad[] = { { 1.3f, 2.2f }, { 14.1f, 1.7f }, { 2.6f, 13.9f }, { 13.4f, 14.6f } };
+    backend.FillTriangleStrip(quad, 4, Colors::White);
+    backend.EndDraw();
+
+    // Every row of the quad's interior is one unbroken run
+    auto const coverage = Coverage(backend, White);
+    for (size_t y = 3; y < 13; ++y)
+    {
+        auto const first = coverage[y].find('x');
+        auto const last = coverage[y].rfind('x');
+        REQUIRE(first != std::string::npos);
+        CHECK(coverage[y].substr(first, last - first + 1).find('.') == std::string::npos);
+    }
+}
+
+TEST_CASE(NaNVerticesDrawNothing)
+{
+    // Only the triangle without the NaN vertex is drawn
+    SoftwareRenderBackend backend(16, 16);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    float const nan = std::nanf("");
+    Point const strip[] = { { 0.0f, 0.0f }, { 8.0f, 0.0f }, { 0.0f, 8.0f }, { nan, 8.0f }, { 12.0f, 16.0f } };
+    backend.FillTriangleStrip(strip, 5, Colors::White);
+    Point const column[] = { { 12.0f, 0.0f }, { 16.0f, nan }, { 12.0f, 16.0f } };
+    backend.FillTriangleStrip(column, 3, Colors::White);
+    backend.EndDraw();
+
+    auto const coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "xxxxxxxx........");
+    CHECK(coverage[7] == "x...............");
+    for (size_t y = 8; y < 16; ++y)
+    {
+        CHECK(coverage[y] == "................");
+    }
+}
+
+TEST_CASE(HugeAndInfiniteCoordinatesAreClamped)
+{
+    SoftwareRenderBackend backend(16, 16);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    backend.FillRectangle({ -1e30f, 1.0f, 1e30f, 2.0f }, Colors::White);
+    backend.FillRectangle({ -INFINITY, 3.0f, 4.0f, INFINITY }, Colors::White);
+    backend.FillRectangle({ std::nanf(""), 0.0f, 16.0f, 16.0f }, Colors::White);
+    Point const tall[] = { { 8.0f, 3.0f }, { 12.0f, 3.0f }, { 8.0f, INFINITY } };
+    backend.FillTriangleStrip(tall, 3, Colors::White);
+    Point const huge[] = { { 14.0f, -1e30f }, { 16.0f, -1e30f }, { 14.0f, 1e30f } };
+    backend.FillTriangleStrip(huge, 3, Colors::White);
+    backend.EndDraw();
+
+    // The NaN rectangle and the triangle with an infinite vertex draw
+    // nothing; the huge triangle covers column 14 all the way down
+    auto const coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "..............x.");
+    CHECK(coverage[1] == "xxxxxxxxxxxxxxxx");
+    CHECK(coverage[2] == "..............x.");
+    for (size_t y = 3; y < 16; ++y)
+    {
+        CHECK(coverage[y] == "xxxx..........x.");
+    }
+
+    PixelRect const covered = SoftwareRenderBackend::CoveredPixels({ -INFINITY, -1e30f, 1e30f, INFINITY });
+    CHECK((covered.Left < -(1 << 29)) && (covered.Top < -(1 << 29)) && (covered.Right > (1 << 29)) && (covered.Bottom > (1 << 29)));
+    CHECK(SoftwareRenderBackend::CoveredPixels({ 0.0f, 0.0f, std::nanf(""), 4.0f }).IsEmpty());
+}
+
+TEST_CASE(SpanOpsMatchTheReferenceBlend)
+{
+    // Every length up to a few vector widths, so both the vector body and the tail run
+    std::mt19937 random{ 42 };
+    for (size_t length = 0; length < 40; ++length)
+    {
+        std::vector<uint32_t> destination(length);
+        std::vector<uint32_t> source(length);
+        for (size_t i = 0; i < length; ++i)
+        {
+            destination[i] = random();
+            uint32_t const alpha = (i % 5 == 0) ? 0 : (i % 5 == 1) ? 255 : random() % 256;
+            uint32_t color = 0;
+            for (uint32_t shift = 0; shift < 24; shift += 8)
+            {
+                color |= (alpha == 0 ? 0 : random() % (alpha + 1)) << shift;
+            }
+            source[i] = (alpha << 24) | color;
+        }
+
+        uint32_t const value = source.empty() ? 0x80402010u : source[length / 2] | 0x20000000u;
+        auto blended = destination;
+        PixelOps::BlendSpan(blended.data(), length, value);
+        auto pixels = destination;
+        PixelOps::BlendPixels(pixels.data(), source.data(), length);
+        auto filled = destination;
+        PixelOps::FillSpan(filled.data(), length, value);
+        for (size_t i = 0; i < length; ++i)
+        {
+            CHECK(blended[i] == ReferenceBlend(destination[i], value));
+            CHECK(pixels[i] == ReferenceBlend(destination[i], source[i]));
+            CHECK(filled[i] == value);
+        }
+    }
+}
+
+TEST_CASE(ColorsArePremultipliedInTheBufferLayout)
+{
+    SoftwareRenderBackend bgra(1, 1, PixelFormat::Bgra8);
+    SoftwareRenderBackend rgba(1, 1, PixelFormat::Rgba8);
+    Color const orange{ 1.0f, 0.5f, 0.0f, 1.0f };
+    CHECK(bgra.PackColor(orange) == 0xffff8000u);
+    CHECK(rgba.PackColor(orange) == 0xff0080ffu);
+
+    // Half transparent white is premultiplied to half grey
+    CHECK(bgra.PackColor({ 1.0f, 1.0f, 1.0f, 0.5f }) == 0x80808080u);
+}
+
+TEST_CASE(ClipsIntersect)
+{
+    SoftwareRenderBackend backend(8, 3);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    backend.PushClip({ 1, 0, 6, 3 });
+    backend.PushClip({ 3, 1, 10, 2 });
+    backend.Clear(Colors::White);
+    backend.PopClip();
+    backend.FillRectangle({ -5.0f, 2.0f, 50.0f, 3.0f }, Colors::White);
+    backend.PopClip();
+    backend.EndDraw();
+
+    auto const coverage = Coverage(backend, White);
+    CHECK(coverage[0] == "........");
+    CHECK(coverage[1] == "...xxx..");
+    CHECK(coverage[2] == ".xxxxx..");
+}
+
+TEST_CASE(GoldenIndicators)
+{
+    // Hovering and pressed pointers, one partly off each edge
+    SoftwareRenderBackend backend(192, 128);
+    PointerTable pointers;
+    pointers.Insert(1, PointerDeviceKind::Mouse, false, { 60.5f, 40.25f });
+    pointers.Insert(2, PointerDeviceKind::Touch, true, { 100.0f, 70.0f });
+    pointers.Insert(3, PointerDeviceKind::Pen, true, { 5.0f, 120.0f });
+    pointers.Insert(4, PointerDeviceKind::Touch, false, { 190.7f, 3.3f });
+    PointerScene::Draw(backend, pointers);
+    CHECK(MatchesGolden(backend, "golden-indicators"));
+}
+
+TEST_CASE(GoldenInk)
+{
+    SoftwareRenderBackend backend(192, 128);
+    PointerTable pointers;
+    pointers.Insert(1, PointerDeviceKind::Pen, true, { 170.0f, 60.0f });
+    auto const ink = MakeInk(1.0f);
+    PointerScene::Draw(backend, pointers, &ink);
+    CHECK(MatchesGolden(backend, "golden-ink"));
+}
+
+TEST_CASE(GoldenTranslucentOverlap)
+{
+    // Blending order and premultiplication, over a partial clip
+    SoftwareRenderBackend backend(64, 64);
+    backend.BeginDraw();
+    backend.Clear(Colors::Black);
+    backend.FillRectangle({ 4.0f, 4.0f, 40.0f, 40.0f }, { 1.0f, 0.0f, 0.0f, 0.5f });
+    backend.FillRectangle({ 24.0f, 24.0f, 60.0f, 60.0f }, { 0.0f, 0.0f, 1.0f, 0.5f });
+    backend.PushClip({ 0, 16, 64, 48 });
+    Point const strip[] = { { 2.0f, 60.0f }, { 10.0f, 30.0f }, { 30.0f, 62.0f }, { 60.0f, 2.0f } };
+    backend.FillTriangleStrip(strip, 4, { 0.0f, 1.0f, 0.0f, 0.25f });
+    backend.PopClip();
+    backend.EndDraw();
+    CHECK(MatchesGolden(backend, "golden-translucent"));
+}
@@ -0,0 +1,175 @@
+#include "SpscRing.h"
+#include "TestHarness.h"
+
+#include <thread>
+
+using namespace PointerCore;
+
+namespace
+{
+    // Two threads sharing a core hand over on every yield and barely make
+    // progress, so the full runs are only worth it with a core each
+    template <typename T>
+    T StressCount(T full)
+    {
+        return (std::thread::hardware_concurrency() >= 2) ? full : full / 40;
+    }
+}
+
+TEST_CASE(CapacityRoundsUpToPowerOfTwo)
+{
+    CHECK(SpscRing<int>(1).Capacity() == 1);
+    CHECK(SpscRing<int>(5).Capacity() == 8);
+    CHECK(SpscRing<int>(64).Capacity() == 64);
+}
+
+TEST_CASE(FullRingRejectsAndCountsOverflow)
+{
+    SpscRing<int> ring(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(ring.TryPush(i));
+    }
+
+    CHECK(!ring.TryPush(4));
+    CHECK(!ring.TryPush(5));
+    CHECK(ring.OverflowCount() == 2);
+    CHECK(ring.HighWaterMark() == 4);
+    CHECK(ring.SizeApprox() == 4);
+
+    // Popping frees a slot, in FIFO order
+    int value = -1;
+    CHECK(ring.TryPop(value));
+    CHECK(value == 0);
+    CHECK(ring.TryPush(6));
+
+    int expected[] = { 1, 2, 3, 6 };
+    size_t next = 0;
+    CHECK(ring.ConsumeAll([&](int element) { CHECK(element == expected[next++]); }) == 4);
+    CHECK(!ring.TryPop(value));
+    CHECK(ring.ConsumeAll([](int) {}) == 0);
+}
+
+TEST_CASE(IndicesWrapAround)
+{
+    SpscRing<uint32_t> ring(8);
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for (int round = 0; round < 1000; ++round)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            CHECK(ring.TryPush(pushed++));
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            REQUIRE(ring.TryPop(value));
+            CHECK(value == popped++);
+        }
+    }
+    CHECK(ring.HighWaterMark() <= 8);
+    CHECK(ring.OverflowCount() == 0);
+}
+
+TEST_CASE(StressOneProducerOneConsumer)
+{
+    // The producer retries on overflow, so every value arrives exactly once
+    // and in order; a small ring keeps it full most of the time.
+    struct Item
+    {
+        uint64_t Sequence;
+        uint64_t Check;
+    };
+
+    uint64_t const Count = StressCount<uint64_t>(2000000);
+    SpscRing<Item> ring(64);
+
+    std::thread producer([&]
+    {
+        for (uint64_t i = 0; i < Count; ++i)
+        {
+            Item const item{ i, i * 0x9e3779b97f4a7c15ull };
+            while (!ring.TryPush(item))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t received = 0;
+    uint64_t sum = 0;
+    bool ordered = true;
+    bool intact = true;
+    while (received < Count)
+    {
+        auto const consume = [&](Item const& item)
+        {
+            ordered = ordered && (item.Sequence == received);
+            intact = intact && (item.Check == item.Sequence * 0x9e3779b97f4a7c15ull);
+            sum += item.Sequence;
+            ++received;
+        };
+
+        // Mix both consumer paths
+        Item item{};
+        if ((received % 3) == 0)
+        {
+            if (ring.TryPop(item))
+            {
+                consume(item);
+            }
+        }
+        else if (ring.ConsumeAll(consume) == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(sum == Count * (Count - 1) / 2);
+    CHECK(ring.HighWaterMark() <= ring.Capacity());
+    CHECK(ring.SizeApprox() == 0);
+}
+
+TEST_CASE(StressDropOnOverflow)
+{
+    // How the heatmap uses it: the producer never waits, so pushed plus
+    // overflowed accounts for every attempt, and what arrives is in order.
+    uint32_t const Count = StressCount<uint32_t>(1000000);
+    SpscRing<uint32_t> ring(256);
+
+    uint32_t pushed = 0;
+    std::thread producer([&]
+    {
+        for (uint32_t i = 0; i < Count; ++i)
+        {
+            pushed += ring.TryPush(i) ? 1 : 0;
+        }
+    });
+
+    uint32_t received = 0;
+    int64_t last = -1;
+    bool ordered = true;
+    auto const consume = [&](uint32_t value)
+    {
+        ordered = ordered && (static_cast<int64_t>(value) > last);
+        last = value;
+        ++received;
+    };
+    while (ring.OverflowCount() + received < Count)
+    {
+        if (ring.ConsumeAll(consume) == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ring.ConsumeAll(consume);
+
+    CHECK(ordered);
+    CHECK(received == pushed);
+    CHECK(pushed + ring.OverflowCount() == Count);
+}
@@ -0,0 +1,358 @@
+#include "StrokeStore.h"
+#include "TestHarness.h"
+
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    PointerSample Sample(float x, float y, uint64_t timestamp)
+    {
+        return { x, y, timestamp, 0.5f };
+    }
+
+    // Distance from p to the segment ab
+    double SegmentDistance(PointerSample const& p, PointerSample const& a, PointerSample const& b)
+    {
+        double const dx = b.X - a.X;
+        double const dy = b.Y - a.Y;
+        double const length2 = dx * dx + dy * dy;
+        double t = (length2 > 0.0) ? ((p.X - a.X) * dx + (p.Y - a.Y) * dy) / length2 : 0.0;
+        t = std::fmin(std::fmax(t, 0.0), 1.0);
+        double const ex = a.X + t * dx - p.X;
+        double const ey = a.Y + t * dy - p.Y;
+        return std::sqrt(ex * ex + ey * ey);
+    }
+}
+
+TEST_CASE(StrokeRunsFromPressToRelease)
+{
+    StrokeStore store;
+    CHECK(!store.Append(1, Sample(0.0f, 0.0f, 0)));
+
+    CHECK(store.Begin(1, Sample(10.0f, 10.0f, 0)));
+    CHECK(store.IsActive(1));
+    REQUIRE(store.StrokeCount() == 1);
+    CHECK(store.IsStrokeActive(0));
+    CHECK(store.StrokePointerId(0) == 1);
+    CHECK(store.StrokePointCount(0) == 1);
+
+    // The newest sample shows up before it's stored
+    CHECK(store.Append(1, Sample(20.0f, 10.0f, 1)));
+    PointerSample latest;
+    CHECK(store.LatestPoint(0, latest));
+    CHECK(latest.X == 20.0f);
+    CHECK(store.StoredPointCount(0) == 1);
+    CHECK(store.StrokePointCount(0) == 2);
+
+    store.End(1);
+    CHECK(!store.IsActive(1));
+    CHECK(!store.IsStrokeActive(0));
+    CHECK(!store.LatestPoint(0, latest));
+    CHECK(store.StoredPointCount(0) == 2);
+
+    std::vector<PointerSample> points;
+    store.CopyPoints(0, points);
+    REQUIRE(points.size() == 2);
+    CHECK(points[0].X == 10.0f);
+    CHECK(points[1].X == 20.0f);
+
+    // Ending twice, or a pointer without a stroke, does nothing
+    store.End(1);
+    store.End(2);
+    CHECK(store.StrokeCount() == 1);
+}
+
+TEST_CASE(StraightLinesCollapseAndCornersStay)
+{
+    StrokeStore store;
+    store.Begin(1, Sample(0.0f, 0.0f, 0));
+    uint64_t time = 1;
+    for (int i = 1; i <= 100; ++i)
+    {
+        store.Append(1, Sample(static_cast<float>(i), 0.0f, time++));
+    }
+    for (int i = 1; i <= 100; ++i)
+    {
+        store.Append(1, Sample(100.0f, static_cast<float>(i), time++));
+    }
+    store.End(1);
+
+    std::vector<PointerSample> points;
+    store.CopyPoints(0, points);
+    REQUIRE(points.size() == 3);
+    CHECK(points[0].X == 0.0f);
+    CHECK(points[1].X == 100.0f);
+    CHECK(points[1].Y == 0.0f);
+    CHECK(points[2].Y == 100.0f);
+    CHECK(store.TotalSamples() == 201);
+}
+
+TEST_CASE(PressureChangesKeepPointsOnStraightLines)
+{
+    // Pressure rises to a peak halfway along a straight line and falls again
+    StrokeStore store;
+    store.Begin(1, { 0.0f, 0.0f, 0, 0.2f });
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        float const pressure = 0.2f + 0.6f * (1.0f - std::fabs(static_cast<float>(i) - 50.0f) / 50.0f);
+        store.Append(1, { static_cast<float>(i), 0.0f, i, pressure });
+    }
+    store.End(1);
+
+    std::vector<PointerSample> points;
+    store.CopyPoints(0, points);
+    REQUIRE(points.size() >= 3);
+    bool keptPeak = false;
+    for (auto const& point : points)
+    {
+        keptPeak |= (point.Pressure > 0.75f);
+    }
+    CHECK(keptPeak);
+
+    // A linear ramp needs no points in between
+    StrokeStore ramp;
+    ramp.Begin(1, { 0.0f, 0.0f, 0, 0.0f });
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        ramp.Append(1, { static_cast<float>(i), 0.0f, i, static_cast<float>(i) / 100.0f });
+    }
+    ramp.End(1);
+    CHECK(ramp.StrokePointCount(0) == 2);
+}
+
+TEST_CASE(DistanceFilterDropsJitter)
+{
+    StrokeStore store;
+    store.Begin(1, Sample(50.0f, 50.0f, 0));
+    for (uint64_t i = 1; i < 100; ++i)
+    {
+        store.Append(1, Sample(50.0f + 0.1f * static_cast<float>(i % 3), 50.0f, i));
+    }
+    store.End(1);
+    CHECK(store.StrokePointCount(0) == 1);
+}
+
+TEST_CASE(SimplifiedPathStaysNearEverySample)
+{
+    std::mt19937 random(21);
+    std::uniform_real_distribution<float> turn(-0.3f, 0.3f);
+    std::uniform_real_distribution<float> press(-0.02f, 0.02f);
+    StrokeStore::Options const options;
+    StrokeStore store(options);
+    std::vector<std::vector<PointerSample>> recorded;
+
+    for (int stroke = 0; stroke < 50; ++stroke)
+    {
+        std::vector<PointerSample> samples;
+        float x = 500.0f;
+        float y = 500.0f;
+        float heading = 0.0f;
+        float pressure = 0.5f;
+        for (uint64_t i = 0; i < 400; ++i)
+        {
+            heading += turn(random) * 0.3f;
+            x += std::cos(heading) * 0.8f;
+            y += std::sin(heading) * 0.8f;
+            pressure = std::fmin(std::fmax(pressure + press(random), 0.0f), 1.0f);
+            samples.push_back({ x, y, i, pressure });
+        }
+
+        store.Begin(7, samples[0]);
+        for (size_t i = 1; i < samples.size(); ++i)
+        {
+            store.Append(7, samples[i]);
+        }
+        store.End(7);
+        recorded.push_back(samples);
+    }
+
+    // A dropped sample is either within tolerance of the stored path or was
+    // filtered for being too close to the sample before it
+    double const bound = std::fmax(options.Tolerance, options.MinDistance) + 1e-3;
+    std::vector<PointerSample> points;
+    size_t filteredPressures = 0;
+    REQUIRE(store.StrokeCount() == recorded.size());
+    for (size_t index = 0; index < store.StrokeCount(); ++index)
+    {
+        store.CopyPoints(index, points);
+        auto const& samples = recorded[store.StrokeId(index)];
+        CHECK(points.size() < samples.size() / 4);
+        CHECK(points.front().Timestamp == samples.front().Timestamp);
+        CHECK(points.back().Timestamp == samples.back().Timestamp);
+
+        size_t segment = 0;
+        for (auto const& sample : samples)
+        {
+            while ((segment + 2 < points.size()) && (points[segment + 1].Timestamp < sample.Timestamp))
+            {
+                ++segment;
+            }
+            REQUIRE(SegmentDistance(sample, points[segment], points[segment + 1]) <= bound);
+
+            // Pressure within tolerance of the ramp between the stored points,
+            // unless the sample was dropped by the distance filter
+            auto const& a = points[segment];
+            auto const& b = points[segment + 1];
+            double const along = std::hypot(sample.X - a.X, sample.Y - a.Y);
+            double const length = std::hypot(b.X - a.X, b.Y - a.Y);
+            double const ramp = a.Pressure + (b.Pressure - a.Pressure) * std::fmin(along / std::fmax(length, 1e-6), 1.0);
+            if (std::fabs(sample.Pressure - ramp) > options.PressureTolerance + 1e-3)
+            {
+                ++filteredPressures;
+            }
+        }
+    }
+
+    // Samples are 0.8 DIPs apart, so the distance filter never drops one
+    CHECK(filteredPressures == 0);
+}
+
+TEST_CASE(InterleavedStrokesKeepTheirOwnPoints)
+{
+    StrokeStore store;
+    for (uint32_t id = 1; id <= 3; ++id)
+    {
+        store.Begin(id, Sample(0.0f, 100.0f * static_cast<float>(id), 0));
+    }
+
+    // Ending the first moves another stroke into its slot
+    for (uint64_t t = 1; t <= 50; ++t)
+    {
+        for (uint32_t id = 1; id <= 3; ++id)
+        {
+            if ((id == 1) && (t > 10))
+            {
+                continue;
+            }
+            store.Append(id, Sample(static_cast<float>(t), 100.0f * static_cast<float>(id) + ((t % 20 < 10) ? 0.0f : 5.0f), t));
+        }
+
+        if (t == 10)
+        {
+            store.End(1);
+        }
+    }
+    store.End(2);
+    store.End(3);
+
+    std::vector<PointerSample> points;
+    REQUIRE(store.StrokeCount() == 3);
+    for (size_t index = 0; index < 3; ++index)
+    {
+        store.CopyPoints(index, points);
+        float const y = 100.0f * static_cast<float>(store.StrokePointerId(index));
+        for (auto const& point : points)
+        {
+            CHECK((point.Y == y) || (point.Y == y + 5.0f));
+        }
+        CHECK(points.back().X == ((store.StrokePointerId(index) == 1) ? 10.0f : 50.0f));
+    }
+}
+
+TEST_CASE(ActiveStrokesAreLimited)
+{
+    StrokeStore::Options options;
+    options.MaxActiveStrokes = 2;
+    StrokeStore store(options);
+    CHECK(store.Begin(1, Sample(0.0f, 0.0f, 0)));
+    CHECK(store.Begin(2, Sample(0.0f, 0.0f, 0)));
+    CHECK(!store.Begin(3, Sample(0.0f, 0.0f, 0)));
+
+    // Beginning again ends the pointer's stroke first
+    CHECK(store.Begin(2, Sample(5.0f, 0.0f, 1)));
+    CHECK(store.StrokeCount() == 3);
+    CHECK(!store.IsStrokeActive(1));
+    CHECK(store.IsStrokeActive(2));
+}
+
+TEST_CASE(OldestFinishedStrokesAreEvicted)
+{
+    StrokeStore::Options options;
+    options.MaxChunks = 4;
+    options.MinDistance = 0.0f;
+    options.Tolerance = 0.0f;
+    StrokeStore store(options);
+
+    // A stroke that zigzags stores every sample
+    auto const draw = [&](uint32_t id, size_t samples, bool end)
+    {
+        store.Begin(id, Sample(0.0f, 0.0f, 0));
+        for (size_t i = 1; i < samples; ++i)
+        {
+            store.Append(id, Sample(static_cast<float>(i), (i % 2) ? 1.0f : 0.0f, i));
+        }
+        if (end)
+        {
+            store.End(id);
+        }
+    };
+
+    draw(1, StrokeStore::ChunkCapacity, true);
+    draw(2, StrokeStore::ChunkCapacity, true);
+    draw(3, 2 * StrokeStore::ChunkCapacity, false);
+    CHECK(store.ChunkCount() == 4);
+    CHECK(store.EvictedStrokes() == 0);
+
+    // The active stroke needs another chunk: the oldest finished one goes
+    store.Append(3, Sample(1000.0f, 0.0f, 1000));
+    store.Append(3, Sample(1001.0f, 5.0f, 1001));
+    CHECK(store.EvictedStrokes() == 1);
+    REQUIRE(store.StrokeCount() == 2);
+    CHECK(store.StrokePointerId(0) == 2);
+    CHECK(store.IsStrokeActive(1));
+
+    // With only the active stroke left, points are dropped instead
+    for (size_t i = 0; i < 4 * StrokeStore::ChunkCapacity; ++i)
+    {
+        store.Append(3, Sample(2000.0f + static_cast<float>(i), (i % 2) ? 1.0f : 0.0f, 2000 + i));
+    }
+    CHECK(store.EvictedStrokes() == 2);
+    CHECK(store.DroppedPoints() > 0);
+    CHECK(store.StrokeCount() == 1);
+    CHECK(store.ChunkCount() == 4);
+    CHECK(store.StoredPointCount(0) == 4 * StrokeStore::ChunkCapacity);
+
+    // Chunks of finished strokes are reused rather than grown
+    store.End(3);
+    draw(4, 3, true);
+    CHECK(store.ChunkCount() == 4);
+    CHECK(store.StrokeCount() == 1);
+}
+
+TEST_CASE(StoredPointsCanBeReadFromAnOffset)
+{
+    StrokeStore::Options options;
+    options.MinDistance = 0.0f;
+    options.Tolerance = 0.0f;
+    StrokeStore store(options);
+    size_t const count = 3 * StrokeStore::ChunkCapacity + 5;
+    store.Begin(1, Sample(0.0f, 0.0f, 0));
+    for (size_t i = 1; i < count; ++i)
+    {
+        store.Append(1, Sample(static_cast<float>(i), (i % 2) ? 1.0f : 0.0f, i));
+    }
+    store.End(1);
+    REQUIRE(store.StoredPointCount(0) == count);
+
+    for (size_t first : { size_t{ 0 }, size_t{ 1 }, StrokeStore::ChunkCapacity - 1, StrokeStore::ChunkCapacity, 2 * StrokeStore::ChunkCapacity + 3, count - 1, count })
+    {
+        uint64_t expected = first;
+        store.ForEachStoredPoint(0, first, [&](PointerSample const& point) { CHECK(point.Timestamp == expected++); });
+        CHECK(expected == count);
+    }
+}
+
+TEST_CASE(ClearEmptiesTheStore)
+{
+    StrokeStore store;
+    store.Begin(1, Sample(0.0f, 0.0f, 0));
+    store.Append(1, Sample(10.0f, 0.0f, 1));
+    store.Clear();
+    CHECK(store.StrokeCount() == 0);
+    CHECK(!store.IsActive(1));
+    CHECK(store.ChunkCount() == 0);
+    CHECK(store.Begin(1, Sample(0.0f, 0.0f, 0)));
+}
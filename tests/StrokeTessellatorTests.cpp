@@ -0,0 +1,328 @@
+#include "StrokeTessellator.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    StrokeStore::Options KeepEverySample(size_t maxChunks = 1 << 16)
+    {
+        StrokeStore::Options options;
+        options.MinDistance = 0.0f;
+        options.Tolerance = 0.0f;
+        options.PressureTolerance = 0.0f;
+        options.MaxChunks = maxChunks;
+        return options;
+    }
+
+    bool Contains(Rect const& rect, Point const& point)
+    {
+        return (point.X >= rect.Left) && (point.X <= rect.Right) && (point.Y >= rect.Top) && (point.Y <= rect.Bottom);
+    }
+
+    // The pairs a stroke's points should produce: offsets along the normal of
+    // the direction between each point's neighbors
+    std::vector<Point> ReferencePairs(std::vector<PointerSample> const& points, StrokeTessellator const& tessellator)
+    {
+        std::vector<Point> pairs;
+        size_t const count = points.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto const& previous = points[(i > 0) ? i - 1 : 0];
+            auto const& next = points[(i + 1 < count) ? i + 1 : count - 1];
+            double const tx = next.X - previous.X;
+            double const ty = next.Y - previous.Y;
+            double const length = std::sqrt(tx * tx + ty * ty);
+            double const scale = (length > 0.0) ? tessellator.HalfWidth(points[i].Pressure) / length : 0.0;
+            pairs.push_back({ static_cast<float>(points[i].X - ty * scale), static_cast<float>(points[i].Y + tx * scale) });
+            pairs.push_back({ static_cast<float>(points[i].X + ty * scale), static_cast<float>(points[i].Y - tx * scale) });
+        }
+
+        return pairs;
+    }
+
+    // Random strokes from several pointers, updated at random moments
+    struct Session
+    {
+        std::mt19937 Random{ 17 };
+        StrokeStore Store;
+        StrokeTessellator Tessellator;
+        std::vector<Point> Positions = std::vector<Point>(4, Point{ 200.0f, 200.0f });
+        uint64_t Time{ 0 };
+
+        explicit Session(StrokeStore::Options const& options) : Store{ options } {}
+
+        void Step()
+        {
+            auto const id = static_cast<uint32_t>(Random() % Positions.size());
+            Point& position = Positions[id];
+            position.X += static_cast<float>(Random() % 11) - 5.0f;
+            position.Y += static_cast<float>(Random() % 11) - 5.0f;
+            PointerSample const sample{ position.X, position.Y, ++Time, static_cast<float>(Random() % 101) / 100.0f };
+
+            uint32_t const action = Random() % 100;
+            if (!Store.IsActive(id))
+            {
+                if (action < 20)
+                {
+                    Store.Begin(id, sample);
+                }
+            }
+            else if (action < 3)
+            {
+                Store.End(id);
+            }
+            else
+            {
+                Store.Append(id, sample);
+            }
+        }
+    };
+}
+
+TEST_CASE(HorizontalStrokeFollowsPressure)
+{
+    StrokeStore store(KeepEverySample());
+    StrokeTessellator tessellator({ 2.0f, 10.0f });
+    CHECK(tessellator.HalfWidth(0.0f) == 1.0f);
+    CHECK(tessellator.HalfWidth(1.0f) == 5.0f);
+    CHECK(tessellator.HalfWidth(-1.0f) == 1.0f);
+    CHECK(tessellator.HalfWidth(2.0f) == 5.0f);
+
+    // Pressure alternates, so the straight line keeps every point
+    auto const pressure = [](size_t i) { return (i % 2) ? static_cast<float>(i) / 20.0f : 0.0f; };
+    store.Begin(1, { 0.0f, 50.0f, 0, pressure(0) });
+    for (uint64_t i = 1; i <= 20; ++i)
+    {
+        store.Append(1, { 10.0f * static_cast<float>(i), 50.0f, i, pressure(i) });
+    }
+    store.End(1);
+
+    Rect changed;
+    CHECK(tessellator.Update(store, changed));
+    REQUIRE(tessellator.MeshCount() == 1);
+    REQUIRE(tessellator.MeshVertexCount(0) == 42);
+
+    Point const* vertices = tessellator.MeshVertices(0);
+    for (size_t i = 0; i <= 20; ++i)
+    {
+        float const halfWidth = tessellator.HalfWidth(pressure(i));
+        CHECK_NEAR(vertices[2 * i].X, 10.0 * static_cast<double>(i), 1e-4);
+        CHECK_NEAR(vertices[2 * i].Y, 50.0 + halfWidth, 1e-4);
+        CHECK_NEAR(vertices[2 * i + 1].Y, 50.0 - halfWidth, 1e-4);
+    }
+
+    CHECK(changed.Left <= 0.0f);
+    CHECK(changed.Right >= 200.0f);
+    CHECK(changed.Top <= 50.0f - tessellator.HalfWidth(pressure(19)));
+    CHECK(changed.Bottom >= 50.0f + tessellator.HalfWidth(pressure(19)));
+}
+
+TEST_CASE(IncrementalMeshesMatchReference)
+{
+    Session session(KeepEverySample());
+    Rect changed;
+    std::vector<PointerSample> points;
+    for (int step = 0; step < 20000; ++step)
+    {
+        session.Step();
+        if (session.Random() % 7 != 0)
+        {
+            continue;
+        }
+
+        session.Tessellator.Update(session.Store, changed);
+        REQUIRE(session.Tessellator.MeshCount() == session.Store.StrokeCount());
+        for (size_t i = 0; i < session.Store.StrokeCount(); ++i)
+        {
+            REQUIRE(session.Tessellator.MeshStrokeId(i) == session.Store.StrokeId(i));
+            session.Store.CopyPoints(i, points);
+            auto const expected = ReferencePairs(points, session.Tessellator);
+            REQUIRE(session.Tessellator.MeshVertexCount(i) == expected.size());
+
+            Point const* vertices = session.Tessellator.MeshVertices(i);
+            for (size_t v = 0; v < expected.size(); ++v)
+            {
+                REQUIRE(PointerCoreTests::Near(vertices[v].X, expected[v].X, 1e-3));
+                REQUIRE(PointerCoreTests::Near(vertices[v].Y, expected[v].Y, 1e-3));
+            }
+        }
+    }
+}
+
+TEST_CASE(ChangedBoundsCoverEveryChangedVertex)
+{
+    // A small pool, so eviction removes meshes too
+    Session session(KeepEverySample(24));
+    Rect changed;
+    std::vector<std::vector<Point>> before;
+    std::vector<uint64_t> beforeIds;
+    for (int step = 0; step < 20000; ++step)
+    {
+        session.Step();
+        if (session.Random() % 5 != 0)
+        {
+            continue;
+        }
+
+        auto& tessellator = session.Tessellator;
+        bool const anyChanged = tessellator.Update(session.Store, changed);
+
+        // Match meshes by stroke ID; vertices that differ, appeared or went
+        // away must all be inside the changed bounds
+        bool sawChange = false;
+        size_t old = 0;
+        for (size_t i = 0; i < tessellator.MeshCount(); ++i)
+        {
+            for (; (old < beforeIds.size()) && (beforeIds[old] < tessellator.MeshStrokeId(i)); ++old)
+            {
+                for (auto const& vertex : before[old])
+                {
+                    REQUIRE(Contains(changed, vertex));
+                }
+                sawChange = true;
+            }
+
+            std::vector<Point> empty;
+            bool const existed = (old < beforeIds.size()) && (beforeIds[old] == tessellator.MeshStrokeId(i));
+            auto const& previous = existed ? before[old++] : empty;
+            Point const* vertices = tessellator.MeshVertices(i);
+            size_t const count = tessellator.MeshVertexCount(i);
+            for (size_t v = 0; v < std::max(count, previous.size()); ++v)
+            {
+                bool const same = (v < count) && (v < previous.size()) && (vertices[v].X == previous[v].X) && (vertices[v].Y == previous[v].Y);
+                if (!same)
+                {
+                    sawChange = true;
+                    if (v < count)
+                    {
+                        REQUIRE(Contains(changed, vertices[v]));
+                    }
+                    if (v < previous.size())
+                    {
+                        REQUIRE(Contains(changed, previous[v]));
+                    }
+                }
+            }
+        }
+        for (; old < beforeIds.size(); ++old)
+        {
+            for (auto const& vertex : before[old])
+            {
+                REQUIRE(Contains(changed, vertex));
+            }
+            sawChange = true;
+        }
+        CHECK(!sawChange || anyChanged);
+
+        before.clear();
+        beforeIds.clear();
+        for (size_t i = 0; i < tessellator.MeshCount(); ++i)
+        {
+            before.emplace_back(tessellator.MeshVertices(i), tessellator.MeshVertices(i) + tessellator.MeshVertexCount(i));
+            beforeIds.push_back(tessellator.MeshStrokeId(i));
+        }
+    }
+
+    CHECK(session.Store.EvictedStrokes() > 0);
+}
+
+TEST_CASE(OnlyNewPointsAreTessellated)
+{
+    StrokeStore store(KeepEverySample());
+    StrokeTessellator tessellator;
+    Rect changed;
+
+    store.Begin(1, { 0.0f, 0.0f, 0, 0.5f });
+    for (uint64_t i = 1; i < 10000; ++i)
+    {
+        store.Append(1, { static_cast<float>(i), (i % 2) ? 1.0f : 0.0f, i, 0.5f });
+        if (i % 16 == 0)
+        {
+            tessellator.Update(store, changed);
+        }
+    }
+    store.End(1);
+    tessellator.Update(store, changed);
+
+    // Each update redoes at most the last stored point and the provisional latest one
+    uint64_t const updates = 10000 / 16 + 1;
+    CHECK(tessellator.PairsComputed() <= 10000 + 2 * updates);
+
+    // A finished stroke costs nothing
+    uint64_t const computed = tessellator.PairsComputed();
+    CHECK(!tessellator.Update(store, changed));
+    CHECK(!tessellator.Update(store, changed));
+    CHECK(tessellator.PairsComputed() == computed);
+
+    // Clearing the store removes the mesh and damages where it was
+    Rect const bounds = tessellator.MeshBounds(0);
+    store.Clear();
+    CHECK(tessellator.Update(store, changed));
+    CHECK(tessellator.MeshCount() == 0);
+    CHECK(changed.Left <= bounds.Left);
+    CHECK(changed.Right >= bounds.Right);
+}
+
+TEST_CASE(StableVerticesNeverMove)
+{
+    // What backends caching a mesh per stroke rely on
+    Session session(KeepEverySample(64));
+    Rect changed;
+    std::vector<std::vector<Point>> stable;
+    std::vector<uint64_t> stableIds;
+    bool unmoved = true;
+    size_t finishedWhole = 0;
+    size_t activeStable = 0;
+    for (int step = 0; step < 20000; ++step)
+    {
+        session.Step();
+        if (session.Random() % 5 != 0)
+        {
+            continue;
+        }
+
+        auto& tessellator = session.Tessellator;
+        tessellator.Update(session.Store, changed);
+
+        size_t old = 0;
+        std::vector<std::vector<Point>> next;
+        std::vector<uint64_t> nextIds;
+        for (size_t i = 0; i < tessellator.MeshCount(); ++i)
+        {
+            uint64_t const id = tessellator.MeshStrokeId(i);
+            while ((old < stableIds.size()) && (stableIds[old] < id))
+            {
+                ++old;
+            }
+
+            Point const* vertices = tessellator.MeshVertices(i);
+            size_t const count = tessellator.MeshVertexCount(i);
+            size_t const stableCount = tessellator.MeshStableVertexCount(i);
+            unmoved = unmoved && (stableCount <= count);
+            if ((old < stableIds.size()) && (stableIds[old] == id))
+            {
+                auto const& previous = stable[old];
+                unmoved = unmoved && (stableCount >= previous.size()) && std::equal(previous.begin(), previous.end(), vertices,
+                    [](Point const& a, Point const& b) { return (a.X == b.X) && (a.Y == b.Y); });
+            }
+
+            // Meshes line up with the store's strokes after an update
+            bool const active = session.Store.IsStrokeActive(i);
+            finishedWhole += (!active && (stableCount == count) && (count > 0)) ? 1 : 0;
+            activeStable += (active && (stableCount > 0)) ? 1 : 0;
+            next.emplace_back(vertices, vertices + stableCount);
+            nextIds.push_back(id);
+        }
+        stable = std::move(next);
+        stableIds = std::move(nextIds);
+    }
+
+    CHECK(unmoved);
+    CHECK(finishedWhole > 0);
+    CHECK(activeStable > 0);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Minimal test registry for the portable core. Every test file builds into
+// its own executable with TestMain.cpp, which runs the TEST_CASEs it
+// registers in order. A failed CHECK reports and fails the test but carries
+// on; a failed REQUIRE also returns from it.
+namespace PointerCoreTests
+{
+    struct TestCase
+    {
+        char const* Name;
+        void (*Body)();
+    };
+
+    std::vector<TestCase>& Registry();
+    void ReportFailure(char const* file, int line, char const* expression);
+
+    struct Registrar
+    {
+        Registrar(char const* name, void (*body)())
+        {
+            Registry().push_back({ name, body });
+        }
+    };
+
+    inline bool Near(double a, double b, double tolerance) noexcept
+    {
+        return std::fabs(a - b) <= tolerance;
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static ::PointerCoreTests::Registrar name##Registrar{ #name, &name }; \
+    static void name()
+
+#define CHECK(expression) \
+    ((expression) ? (void)0 : ::PointerCoreTests::ReportFailure(__FILE__, __LINE__, #expression))
+
+#define CHECK_NEAR(a, b, tolerance) \
+    (::PointerCoreTests::Near((a), (b), (tolerance)) ? (void)0 : ::PointerCoreTests::ReportFailure(__FILE__, __LINE__, #a " near " #b))
+
+#define REQUIRE(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            ::PointerCoreTests::ReportFailure(__FILE__, __LINE__, #expression); \
+            return; \
+        } \
+    } while (false)
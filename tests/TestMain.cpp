@@ -0,0 +1,50 @@
+#include "TestHarness.h"
+
+#include <cstring>
+
+namespace PointerCoreTests
+{
+    static size_t s_failures = 0;
+
+    std::vector<TestCase>& Registry()
+    {
+        static std::vector<TestCase> registry;
+        return registry;
+    }
+
+    void ReportFailure(char const* file, int line, char const* expression)
+    {
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+        ++s_failures;
+    }
+}
+
+// Runs every registered test, or only those whose name contains the first argument
+int main(int argc, char** argv)
+{
+    using namespace PointerCoreTests;
+
+    char const* filter = (argc > 1) ? argv[1] : nullptr;
+    size_t run = 0;
+    size_t failed = 0;
+    for (auto const& test : Registry())
+    {
+        if ((filter != nullptr) && (std::strstr(test.Name, filter) == nullptr))
+        {
+            continue;
+        }
+
+        size_t const failuresBefore = s_failures;
+        std::printf("[ RUN  ] %s\n", test.Name);
+        std::fflush(stdout);
+        test.Body();
+
+        bool const passed = (s_failures == failuresBefore);
+        std::printf("[ %s ] %s\n", passed ? " OK " : "FAIL", test.Name);
+        ++run;
+        failed += passed ? 0 : 1;
+    }
+
+    std::printf("%zu of %zu tests passed\n", run - failed, run);
+    return ((failed == 0) && (run > 0)) ? 0 : 1;
+}
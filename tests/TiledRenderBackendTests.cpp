@@ -0,0 +1,255 @@
+#include "SoftwareRenderBackend.h"
+#include "TestHarness.h"
+#include "TiledRenderBackend.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace PointerCore;
+
+namespace
+{
+    // A 16x16 sheet of translucent premultiplied gradients
+    std::vector<uint32_t> SheetPixels()
+    {
+        std::vector<uint32_t> pixels(16 * 16);
+        for (uint32_t y = 0; y < 16; ++y)
+        {
+            for (uint32_t x = 0; x < 16; ++x)
+            {
+                uint32_t const alpha = 64 + x * 8;
+                uint32_t const value = alpha * y / 16;
+                pixels[y * 16 + x] = (alpha << 24) | (value << 16) | ((alpha - value) << 8) | (alpha / 2);
+            }
+        }
+        return pixels;
+    }
+
+    // Draws the same random frame for the same seed: clears, rectangles,
+    // strips and sprites, some translucent, some off the surface, under
+    // nested clips
+    void DrawFrame(RenderBackend& backend, uint32_t seed, uint32_t width, uint32_t height, SpriteSheet const& sheet)
+    {
+        std::mt19937 random(seed);
+        auto const coordinate = [&](uint32_t extent) { return std::uniform_real_distribution<float>(-40.0f, static_cast<float>(extent) + 40.0f)(random); };
+        auto const color = [&]
+        {
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            float const alpha = ((random() % 3) == 0) ? unit(random) : 1.0f;
+            return Color{ unit(random), unit(random), unit(random), alpha };
+        };
+
+        backend.BeginDraw();
+        backend.Clear(Colors::Black);
+        size_t clips = 0;
+        for (int op = 0; op < 60; ++op)
+        {
+            switch (random() % 7)
+            {
+            case 0:
+            {
+                float const x = coordinate(width);
+                float const y = coordinate(height);
+                backend.FillRectangle({ x, y, x + coordinate(width) / 3.0f, y + coordinate(height) / 3.0f }, color());
+                break;
+            }
+            case 1:
+            {
+                std::vector<Point> strip;
+                float x = coordinate(width);
+                float y = coordinate(height);
+                size_t const count = 3 + random() % 60;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    x += std::uniform_real_distribution<float>(-12.0f, 12.0f)(random);
+                    y += std::uniform_real_distribution<float>(-12.0f, 12.0f)(random);
+                    strip.push_back({ x + ((i % 2) ? 6.0f : -6.0f), y });
+                }
+                if ((random() % 10) == 0)
+                {
+                    strip[count / 2].X = std::numeric_limits<float>::quiet_NaN();
+                }
+                backend.FillTriangleStrip(strip.data(), strip.size(), color());
+                break;
+            }
+            case 2:
+            {
+                std::vector<SpriteInstance> sprites;
+                for (int i = 0; i < 4; ++i)
+                {
+                    float const x = std::floor(coordinate(width));
+                    float const y = std::floor(coordinate(height));
+                    sprites.push_back({ { x, y, x + 16.0f, y + 16.0f }, { 0, 0, 16, 16 } });
+                }
+                backend.DrawSprites(sheet, sprites.data(), sprites.size());
+                break;
+            }
+            case 3:
+            {
+                int32_t const left = static_cast<int32_t>(coordinate(width));
+                int32_t const top = static_cast<int32_t>(coordinate(height));
+                backend.PushClip({ left, top, left + static_cast<int32_t>(width / 2), top + static_cast<int32_t>(height / 2) });
+                ++clips;
+                break;
+            }
+            case 4:
+                if (clips > 0)
+                {
+                    backend.PopClip();
+                    --clips;
+                }
+                break;
+            case 5:
+                if ((random() % 4) == 0)
+                {
+                    backend.Clear(color());
+                }
+                break;
+            default:
+            {
+                float const x = coordinate(width);
+                float const y = coordinate(height);
+                backend.FillRectangle({ x, y, x + 20.0f, y + 20.0f }, color());
+                break;
+            }
+            }
+        }
+        while (clips-- > 0)
+        {
+            backend.PopClip();
+        }
+        backend.EndDraw();
+    }
+
+    bool SamePixels(SoftwareRenderBackend const& a, SoftwareRenderBackend const& b)
+    {
+        size_t const count = size_t{ a.Width() } * a.Height();
+        return (a.Width() == b.Width()) && (a.Height() == b.Height()) && std::equal(a.Pixels(), a.Pixels() + count, b.Pixels());
+    }
+}
+
+TEST_CASE(MatchesDrawingStraightIntoTheTarget)
+{
+    auto const pixels = SheetPixels();
+    SpriteSheet const sheet{ pixels.data(), 16, 16, PixelFormat::Bgra8, 1.0f, 1 };
+
+    for (size_t workers : { 0, 1, 3 })
+    {
+        WorkStealingPool pool(workers);
+        bool same = true;
+        for (uint32_t seed = 1; seed <= 40; ++seed)
+        {
+            // Sizes that aren't whole tiles, and tiles that aren't the default
+            uint32_t const width = 100 + seed * 7;
+            uint32_t const height = 80 + seed * 5;
+            SoftwareRenderBackend reference(width, height);
+            SoftwareRenderBackend target(width, height);
+            TiledRenderBackend::Options options;
+            options.TileSize = (seed % 2) ? 64 : 24;
+            options.TrianglesPerPiece = 1 + seed % 5;
+            TiledRenderBackend tiled(target, pool, options);
+
+            DrawFrame(reference, seed, width, height, sheet);
+            DrawFrame(tiled, seed, width, height, sheet);
+            same = same && SamePixels(reference, target);
+        }
+        CHECK(same);
+    }
+}
+
+TEST_CASE(SkipsTilesThatDidntChange)
+{
+    auto const pixels = SheetPixels();
+    SpriteSheet sheet{ pixels.data(), 16, 16, PixelFormat::Bgra8, 1.0f, 1 };
+    WorkStealingPool pool(2);
+    SoftwareRenderBackend reference(300, 200);
+    SoftwareRenderBackend target(300, 200);
+    TiledRenderBackend tiled(target, pool);
+    CHECK(tiled.TileCount() == 5 * 4);
+
+    DrawFrame(tiled, 7, 300, 200, sheet);
+    CHECK(tiled.TilesRasterized() == 20);
+    CHECK(tiled.TilesSkipped() == 0);
+
+    // The same frame again draws nothing
+    DrawFrame(tiled, 7, 300, 200, sheet);
+    CHECK(tiled.TilesRasterized() == 0);
+    CHECK(tiled.TilesSkipped() == 20);
+    DrawFrame(reference, 7, 300, 200, sheet);
+    CHECK(SamePixels(reference, target));
+
+    // A new sheet version redraws the tiles its sprites are in
+    sheet.Version = 2;
+    DrawFrame(tiled, 7, 300, 200, sheet);
+    CHECK(tiled.TilesRasterized() > 0);
+    CHECK(tiled.TilesRasterized() < 20);
+
+    // One rectangle moving over a cleared background only redraws the
+    // tiles it was and is in
+    auto const frame = [&](RenderBackend& backend, float x)
+    {
+        backend.BeginDraw();
+        backend.Clear(Colors::Black);
+        backend.FillRectangle({ x, 10.0f, x + 30.0f, 40.0f }, Colors::Red);
+        backend.EndDraw();
+    };
+    frame(tiled, 10.0f);
+    frame(tiled, 10.0f);
+    CHECK(tiled.TilesRasterized() == 0);
+    frame(tiled, 50.0f);
+    CHECK(tiled.TilesRasterized() == 2);
+    frame(reference, 50.0f);
+    CHECK(SamePixels(reference, target));
+
+    // Drawing into the target some other way needs an Invalidate()
+    target.BeginDraw();
+    target.Clear(Colors::White);
+    target.EndDraw();
+    tiled.Invalidate();
+    frame(tiled, 50.0f);
+    CHECK(tiled.TilesRasterized() == 20);
+    CHECK(SamePixels(reference, target));
+}
+
+TEST_CASE(PartialRepaintsKeepTheRest)
+{
+    // A damage-style frame: clip to a region, clear it and draw. Tiles the
+    // clip only partly covers are never skipped, tiles outside it are kept.
+    WorkStealingPool pool(1);
+    SoftwareRenderBackend reference(256, 256);
+    SoftwareRenderBackend target(256, 256);
+    TiledRenderBackend tiled(target, pool);
+    auto const frame = [](RenderBackend& backend, PixelRect const& clip, Color const& color)
+    {
+        backend.BeginDraw();
+        backend.PushClip(clip);
+        backend.Clear(Colors::Black);
+        backend.FillRectangle({ 0.0f, 0.0f, 256.0f, 256.0f }, color);
+        backend.PopClip();
+        backend.EndDraw();
+    };
+
+    for (auto* backend : { static_cast<RenderBackend*>(&reference), static_cast<RenderBackend*>(&tiled) })
+    {
+        frame(*backend, { 0, 0, 256, 256 }, Colors::Blue);
+        frame(*backend, { 0, 0, 160, 128 }, { 1.0f, 0.0f, 0.0f, 0.5f });
+        frame(*backend, { 0, 0, 160, 128 }, { 1.0f, 0.0f, 0.0f, 0.5f });
+    }
+    CHECK(SamePixels(reference, target));
+
+    // Six tiles under the clip, the four it covers whole skipped the
+    // second time
+    CHECK(tiled.TilesRasterized() == 2);
+    CHECK(tiled.TilesSkipped() == 4);
+
+    // Resizing starts over
+    reference.Resize(100, 300);
+    target.Resize(100, 300);
+    frame(reference, { 0, 0, 100, 300 }, Colors::Blue);
+    frame(tiled, { 0, 0, 100, 300 }, Colors::Blue);
+    CHECK(tiled.TileCount() == 2 * 5);
+    CHECK(tiled.TilesRasterized() == 10);
+    CHECK(SamePixels(reference, target));
+}
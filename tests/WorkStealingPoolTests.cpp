@@ -0,0 +1,96 @@
+#include "TestHarness.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace PointerCore;
+
+TEST_CASE(RunsEveryItemOnce)
+{
+    for (size_t workers : { 0, 1, 3, 7 })
+    {
+        WorkStealingPool pool(workers);
+        CHECK(pool.ThreadCount() == workers + 1);
+
+        // Loops of every size up to a few items a thread, then a large one
+        for (size_t count : { 0, 1, 2, 3, 5, 8, 17, 100, 10000 })
+        {
+            std::vector<std::atomic<int>> runs(count);
+            std::atomic<bool> threadsInRange{ true };
+            pool.Run(count, [&](size_t item, size_t thread)
+            {
+                runs[item].fetch_add(1, std::memory_order_relaxed);
+                if (thread >= pool.ThreadCount())
+                {
+                    threadsInRange = false;
+                }
+            });
+
+            bool once = true;
+            for (auto const& run : runs)
+            {
+                once = once && (run.load() == 1);
+            }
+            CHECK(once);
+            CHECK(threadsInRange);
+        }
+    }
+}
+
+TEST_CASE(CallerRunsSmallLoopsAlone)
+{
+    WorkStealingPool pool(3);
+    auto const caller = std::this_thread::get_id();
+    bool onCaller = true;
+    pool.Run(1, [&](size_t, size_t thread) { onCaller = onCaller && (thread == 0) && (std::this_thread::get_id() == caller); });
+    CHECK(onCaller);
+
+    // No workers at all: everything on the caller, in order
+    WorkStealingPool alone(0);
+    std::vector<size_t> order;
+    alone.Run(5, [&](size_t item, size_t) { order.push_back(item); });
+    CHECK((order == std::vector<size_t>{ 0, 1, 2, 3, 4 }));
+    CHECK(alone.Steals() == 0);
+}
+
+TEST_CASE(IdleThreadsStealFromBusyOnes)
+{
+    // The caller's range is slow and the rest are instant, so the others
+    // finish their own and take from the caller's
+    WorkStealingPool pool(3);
+    std::vector<std::atomic<size_t>> ranBy(64);
+    pool.Run(64, [&](size_t item, size_t thread)
+    {
+        ranBy[item].store(thread, std::memory_order_relaxed);
+        if (item < 16)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+
+    size_t stolen = 0;
+    for (size_t item = 0; item < 16; ++item)
+    {
+        stolen += (ranBy[item].load() != 0) ? 1 : 0;
+    }
+    CHECK(stolen > 0);
+    CHECK(pool.Steals() >= stolen);
+}
+
+TEST_CASE(BackToBackLoops)
+{
+    // Workers still leaving one loop while the next one starts
+    WorkStealingPool pool(3);
+    std::atomic<uint64_t> total{ 0 };
+    uint64_t expected = 0;
+    for (size_t loop = 0; loop < 5000; ++loop)
+    {
+        size_t const count = 1 + loop % 13;
+        pool.Run(count, [&](size_t item, size_t) { total.fetch_add(item + 1, std::memory_order_relaxed); });
+        expected += count * (count + 1) / 2;
+        CHECK(total.load() == expected);
+    }
+}